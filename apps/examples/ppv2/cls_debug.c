@@ -43,6 +43,7 @@
 #include "src/drivers/ppv2/cls/pp2_c2.h"
 #include "src/drivers/ppv2/cls/pp2_flow_rules.h"
 #include "src/drivers/ppv2/cls/pp2_cls_db.h"
+#include "src/drivers/ppv2/cls/pp2_cls_model.h"
 #include "cls_debug.h"
 
 int register_cli_cls_cmds(struct pp2_ppio *ppio)
@@ -175,6 +176,17 @@ int register_cli_cls_cmds(struct pp2_ppio *ppio)
 	cmd_params.do_cmd_cb	= (int (*)(void *, int, char *[]))pp2_cls_print_rxq_counters;
 	mvapp_register_cli_cmd(&cmd_params);
 
+	memset(&cmd_params, 0, sizeof(cmd_params));
+	cmd_params.name		= "cls_model_run";
+	cmd_params.desc		= "run a packet through a software model of the parser and classifier tables";
+	cmd_params.format	= "<port> <hex_pkt> [-l file | -s file]\n"
+				  "\t\t\t\t<hex_pkt>	ethernet frame, e.g. 0x001122...\n"
+				  "\t\t\t\t-l file	run on a model file instead of a HW snapshot\n"
+				  "\t\t\t\t-s file	save the HW snapshot to a model file";
+	cmd_params.cmd_arg	= (void *)inst;
+	cmd_params.do_cmd_cb	= (int (*)(void *, int, char *[]))pp2_cls_cli_model_run;
+	mvapp_register_cli_cmd(&cmd_params);
+
 	return 0;
 }
 
@@ -259,6 +271,22 @@ int register_cli_c3_cmds(struct pp2_ppio *ppio)
 	cmd_params.do_cmd_cb	= (int (*)(void *, int, char *[]))pp2_cls_cli_c3_type_entry_dump;
 	mvapp_register_cli_cmd(&cmd_params);
 
+	memset(&cmd_params, 0, sizeof(cmd_params));
+	cmd_params.name		= "cls_c3_hash_shadow_dump";
+	cmd_params.desc		= "dump C3 multihash model occupancy, load factor and relocation counters";
+	cmd_params.format	= "(no arguments)\n";
+	cmd_params.cmd_arg	= (void *)inst;
+	cmd_params.do_cmd_cb	= (int (*)(void *, int, char *[]))pp2_cls_cli_c3_hash_shadow_dump;
+	mvapp_register_cli_cmd(&cmd_params);
+
+	memset(&cmd_params, 0, sizeof(cmd_params));
+	cmd_params.name		= "cls_c3_hash_bench";
+	cmd_params.desc		= "fill a scratch C3 multihash model until the first failure and report the load factor";
+	cmd_params.format	= "[search_depth] [runs] (default 3 10)\n";
+	cmd_params.cmd_arg	= (void *)inst;
+	cmd_params.do_cmd_cb	= (int (*)(void *, int, char *[]))pp2_cls_cli_c3_hash_bench;
+	mvapp_register_cli_cmd(&cmd_params);
+
 	return 0;
 }
 
@@ -294,6 +322,14 @@ int register_cli_c2_cmds(struct pp2_ppio *ppio)
 	cmd_params.do_cmd_cb	= (int (*)(void *, int, char *[]))pp2_cls_cli_qos_dscp_dump;
 	mvapp_register_cli_cmd(&cmd_params);
 
+	memset(&cmd_params, 0, sizeof(cmd_params));
+	cmd_params.name		= "cls_c2_slot_bench";
+	cmd_params.desc		= "run the C2 slot allocator on a scratch map and report entry moves per insert";
+	cmd_params.format	= "[num_entries] [runs] (default 180 100)\n";
+	cmd_params.cmd_arg	= (void *)inst;
+	cmd_params.do_cmd_cb	= (int (*)(void *, int, char *[]))pp2_cls_cli_c2_slot_bench;
+	mvapp_register_cli_cmd(&cmd_params);
+
 #ifdef CLS_DEBUG
 	memset(&cmd_params, 0, sizeof(cmd_params));
 	cmd_params.name		= "cls_c2_valid_lkp_type_dump";
@@ -342,6 +378,14 @@ int register_cli_mng_cmds(struct pp2_ppio *ppio)
 	cmd_params.cmd_arg	= NULL;
 	cmd_params.do_cmd_cb	= (void *)pp2_cls_db_mng_tbl_list_dump;
 	mvapp_register_cli_cmd(&cmd_params);
+
+	memset(&cmd_params, 0, sizeof(cmd_params));
+	cmd_params.name		= "cls_mng_db_bench";
+	cmd_params.desc		= "bulk load synthetic rules into manager db and report add/lookup/remove rates";
+	cmd_params.format	= "[num_rules] (default 10000)\n";
+	cmd_params.cmd_arg	= NULL;
+	cmd_params.do_cmd_cb	= (void *)pp2_cli_cls_db_mng_bench;
+	mvapp_register_cli_cmd(&cmd_params);
 	return 0;
 }
 
@@ -359,6 +359,10 @@ static int pp2_cls_cli_table_add(void *arg, int argc, char *argv[])
 	char name[CLS_APP_PPIO_NAME_MAX];
 	int traffic_class = -1;
 	int action_type = PP2_CLS_TBL_ACT_DONE;
+	int stats_interval = -1;
+	int aging_timeout = -1;
+	int next_tbl_idx = -1;
+	struct pp2_cls_tbl *next_tbl = NULL;
 	char *ret_ptr;
 	struct pp2_cls_table_node *tbl_node;
 	struct pp2_cls_tbl_params *tbl_params;
@@ -369,10 +373,13 @@ static int pp2_cls_cli_table_add(void *arg, int argc, char *argv[])
 		{"key", required_argument, 0, 'k'},
 		{"tc", required_argument, 0, 'q'},
 		{"drop", no_argument, 0, 'd'},
+		{"stats", required_argument, 0, 's'},
+		{"aging", required_argument, 0, 'a'},
+		{"next_table", required_argument, 0, 'n'},
 		{0, 0, 0, 0}
 	};
 
-	if  (argc < 5 || argc > 16) {
+	if  (argc < 5 || argc > 22) {
 		pr_err("Invalid number of arguments for %s command! number of arguments = %d\n", __func__, argc);
 		return -EINVAL;
 	}
@@ -403,6 +410,28 @@ static int pp2_cls_cli_table_add(void *arg, int argc, char *argv[])
 				return -EINVAL;
 			}
 			break;
+		case 's':
+			stats_interval = strtoul(optarg, &ret_ptr, 0);
+			if ((optarg == ret_ptr) || (stats_interval < 0)) {
+				printf("parsing fail, wrong input for --stats\n");
+				return -EINVAL;
+			}
+			break;
+		case 'a':
+			aging_timeout = strtoul(optarg, &ret_ptr, 0);
+			if ((optarg == ret_ptr) || (aging_timeout <= 0)) {
+				printf("parsing fail, wrong input for --aging\n");
+				return -EINVAL;
+			}
+			break;
+		case 'n':
+			next_tbl_idx = strtoul(optarg, &ret_ptr, 0);
+			if ((optarg == ret_ptr) || (next_tbl_idx < 0) ||
+			    (next_tbl_idx >= list_num_objs(&cls_flow_tbl_head))) {
+				printf("parsing fail, wrong input for --next_table\n");
+				return -EINVAL;
+			}
+			break;
 		case 'k':
 			rc = pp2_cls_convert_string_to_proto_and_field(&proto[idx], &field[idx]);
 			if (rc < 0) {
@@ -428,6 +457,11 @@ static int pp2_cls_cli_table_add(void *arg, int argc, char *argv[])
 		return -EINVAL;
 	}
 
+	if (aging_timeout > 0 && stats_interval < 0) {
+		printf("parsing fail, --aging requires --stats\n");
+		return -EINVAL;
+	}
+
 	if (key_size > CLS_APP_KEY_SIZE_MAX) {
 		pr_err("key size out of range = %d\n", key_size);
 		return -EINVAL;
@@ -441,6 +475,14 @@ static int pp2_cls_cli_table_add(void *arg, int argc, char *argv[])
 
 	pr_debug("num_fields = %d, key_size = %d\n", num_fields, key_size);
 
+	if (next_tbl_idx >= 0) {
+		rc = pp2_cls_table_get(next_tbl_idx, &next_tbl, &cls_flow_tbl_head);
+		if (rc) {
+			printf("table %d not found\n", next_tbl_idx);
+			return -EINVAL;
+		}
+	}
+
 	tbl_node = malloc(sizeof(*tbl_node));
 	if (!tbl_node) {
 		pr_err("%s no mem for new table!\n", __func__);
@@ -456,6 +498,15 @@ static int pp2_cls_cli_table_add(void *arg, int argc, char *argv[])
 	tbl_params = &tbl_node->tbl_params;
 	tbl_params->type = engine_type;
 	tbl_params->max_num_rules = CLS_APP_MAX_NUM_OF_RULES;
+	if (stats_interval >= 0) {
+		tbl_params->stats_mode = PP2_CLS_TBL_STATS_M_FRM;
+		tbl_params->stats_interval_ms = stats_interval;
+	}
+	if (aging_timeout > 0) {
+		tbl_params->aging_mode = PP2_CLS_TBL_AGING_M_IDLE;
+		tbl_params->aging_timeout_ms = aging_timeout;
+	}
+	tbl_params->next_tbl = next_tbl;
 	tbl_params->key.key_size = key_size;
 	tbl_params->key.num_fields = num_fields;
 	for (idx = 0; idx < tbl_params->key.num_fields; idx++) {
@@ -556,6 +607,193 @@ static int pp2_cls_cli_table_remove(void *arg, int argc, char *argv[])
 	return 0;
 }
 
+static int pp2_cls_cli_table_batch(void *arg, int argc, char *argv[])
+{
+	struct pp2_cls_tbl *tbl;
+	struct pp2_cls_tbl_commit_stats stats;
+	int tbl_idx = -1;
+	int cmd = 0;
+	char *ret_ptr;
+	int option = 0;
+	int long_index = 0;
+	int rc;
+	struct option long_options[] = {
+		{"begin", no_argument, 0, 'b'},
+		{"commit", no_argument, 0, 'c'},
+		{"abort", no_argument, 0, 'a'},
+		{"table_index", required_argument, 0, 't'},
+		{0, 0, 0, 0}
+	};
+
+	if (argc != 4) {
+		pr_err("Invalid number of arguments for %s command! number of arguments = %d\n", __func__, argc);
+		return -EINVAL;
+	}
+
+	/* every time starting getopt we should reset optind */
+	optind = 0;
+	/* Get parameters */
+	while ((option = getopt_long_only(argc, argv, "", long_options, &long_index)) != -1) {
+		switch (option) {
+		case 'b':
+		case 'c':
+		case 'a':
+			cmd = option;
+			break;
+		case 't':
+			tbl_idx = strtoul(optarg, &ret_ptr, 0);
+			if ((optarg == ret_ptr) || (tbl_idx < 0) || (tbl_idx >= list_num_objs(&cls_flow_tbl_head))) {
+				printf("parsing fail, wrong input for --table_index\n");
+				return -EINVAL;
+			}
+			break;
+		default:
+			printf("parsing fail, wrong input, line = %d\n", __LINE__);
+			return -EINVAL;
+		}
+	}
+
+	/* check if all the fields are initialized */
+	if (tbl_idx < 0 || !cmd) {
+		printf("parsing fail, invalid --table_index or missing --begin/--commit/--abort\n");
+		return -EINVAL;
+	}
+
+	rc = pp2_cls_table_get(tbl_idx, &tbl, &cls_flow_tbl_head);
+	if (rc) {
+		printf("table %d not found\n", tbl_idx);
+		return -EINVAL;
+	}
+
+	if (cmd == 'b') {
+		rc = pp2_cls_tbl_begin(tbl);
+	} else if (cmd == 'a') {
+		pp2_cls_tbl_abort(tbl);
+	} else {
+		memset(&stats, 0, sizeof(stats));
+		rc = pp2_cls_tbl_commit(tbl, &stats);
+		printf("added %d, modified %d, removed %d, %d HW writes in %d usec",
+		       stats.num_add, stats.num_modify, stats.num_remove, stats.num_hw_writes, (u32)stats.usecs);
+		if (stats.usecs)
+			printf(" (%d rules/sec)", (u32)((u64)(stats.num_add + stats.num_modify + stats.num_remove) *
+							1000000 / stats.usecs));
+		printf("\n");
+	}
+
+	if (!rc)
+		printf("OK\n");
+	else
+		printf("error in batch update\n");
+	return 0;
+}
+
+static void pp2_cls_rule_stats_print(struct pp2_cls_tbl_rule_stats *stats)
+{
+	struct pp2_cls_tbl_rule *rule = stats->rule;
+	int i;
+
+	printf("%20llu %12llu  ", (unsigned long long)stats->pkts, (unsigned long long)stats->idle_ms);
+	for (i = 0; i < rule->num_fields; i++)
+		printf("%s%s", i ? ", " : "", (char *)rule->fields[i].key);
+	printf("\n");
+}
+
+static int pp2_cls_cli_table_stats(void *arg, int argc, char *argv[])
+{
+	struct pp2_cls_tbl *tbl;
+	struct pp2_cls_tbl_rule_stats stats[CLS_APP_MAX_NUM_OF_RULES];
+	int tbl_idx = -1;
+	int top_n = -1;
+	int idle_ms = -1;
+	u32 num, num_aged;
+	char *ret_ptr;
+	int option = 0;
+	int long_index = 0;
+	int rc;
+	u32 i;
+	struct option long_options[] = {
+		{"table_index", required_argument, 0, 't'},
+		{"top", required_argument, 0, 'n'},
+		{"idle", required_argument, 0, 'i'},
+		{0, 0, 0, 0}
+	};
+
+	if (argc != 5) {
+		pr_err("Invalid number of arguments for %s command! number of arguments = %d\n", __func__, argc);
+		return -EINVAL;
+	}
+
+	/* every time starting getopt we should reset optind */
+	optind = 0;
+	/* Get parameters */
+	while ((option = getopt_long_only(argc, argv, "", long_options, &long_index)) != -1) {
+		switch (option) {
+		case 't':
+			tbl_idx = strtoul(optarg, &ret_ptr, 0);
+			if ((optarg == ret_ptr) || (tbl_idx < 0) || (tbl_idx >= list_num_objs(&cls_flow_tbl_head))) {
+				printf("parsing fail, wrong input for --table_index\n");
+				return -EINVAL;
+			}
+			break;
+		case 'n':
+			top_n = strtoul(optarg, &ret_ptr, 0);
+			if ((optarg == ret_ptr) || (top_n <= 0) || (top_n > CLS_APP_MAX_NUM_OF_RULES)) {
+				printf("parsing fail, wrong input for --top\n");
+				return -EINVAL;
+			}
+			break;
+		case 'i':
+			idle_ms = strtoul(optarg, &ret_ptr, 0);
+			if ((optarg == ret_ptr) || (idle_ms < 0)) {
+				printf("parsing fail, wrong input for --idle\n");
+				return -EINVAL;
+			}
+			break;
+		default:
+			printf("parsing fail, wrong input, line = %d\n", __LINE__);
+			return -EINVAL;
+		}
+	}
+
+	/* check if all the fields are initialized */
+	if (tbl_idx < 0 || (top_n < 0 && idle_ms < 0)) {
+		printf("parsing fail, invalid --table_index or missing --top/--idle\n");
+		return -EINVAL;
+	}
+
+	rc = pp2_cls_table_get(tbl_idx, &tbl, &cls_flow_tbl_head);
+	if (rc) {
+		printf("table %d not found\n", tbl_idx);
+		return -EINVAL;
+	}
+
+	rc = pp2_cls_tbl_stats_poll(tbl, &num_aged);
+	if (rc) {
+		printf("error reading table statistics (statistics enabled?)\n");
+		return 0;
+	}
+	if (num_aged)
+		printf("%d rules aged\n", num_aged);
+
+	if (top_n > 0) {
+		num = top_n;
+		rc = pp2_cls_tbl_top_n_get(tbl, stats, &num);
+	} else {
+		num = CLS_APP_MAX_NUM_OF_RULES;
+		rc = pp2_cls_tbl_idle_get(tbl, idle_ms, stats, &num);
+	}
+	if (rc) {
+		printf("error reading table statistics\n");
+		return 0;
+	}
+
+	printf("%20s %12s  %s\n", "packets", "idle [ms]", "key");
+	for (i = 0; i < num; i++)
+		pp2_cls_rule_stats_print(&stats[i]);
+	printf("OK\n");
+	return 0;
+}
+
 static int pp2_cls_cli_qos_table_add(void *arg, int argc, char *argv[])
 {
 	int type = -1;
@@ -801,9 +1039,12 @@ static int pp2_cls_cli_cls_rule_key(void *arg, int argc, char *argv[])
 	int tbl_idx = -1;
 	int traffic_class = -1;
 	int action_type = PP2_CLS_TBL_ACT_DONE;
+	int flow_id = -1;
+	int next_tbl_idx = -1;
 	int rc;
 	u32 num_fields;
 	struct pp2_cls_tbl *tbl;
+	struct pp2_cls_tbl *next_tbl = NULL;
 	struct pp2_cls_tbl_rule *rule;
 	struct pp2_cls_tbl_action *action;
 	u32 key_size[PP2_CLS_TBL_MAX_NUM_FIELDS];
@@ -823,6 +1064,8 @@ static int pp2_cls_cli_cls_rule_key(void *arg, int argc, char *argv[])
 		{"table_index", required_argument, 0, 't'},
 		{"drop", no_argument, 0, 'd'},
 		{"tc", required_argument, 0, 'q'},
+		{"flow_id", required_argument, 0, 'f'},
+		{"next_table", required_argument, 0, 'n'},
 		{0, 0, 0, 0}
 	};
 
@@ -863,6 +1106,21 @@ static int pp2_cls_cli_cls_rule_key(void *arg, int argc, char *argv[])
 				return -EINVAL;
 			}
 			break;
+		case 'f':
+			flow_id = strtoul(optarg, &ret_ptr, 0);
+			if ((optarg == ret_ptr) || (flow_id < 0) || (flow_id > 0xFFFF)) {
+				printf("parsing fail, wrong input for --flow_id\n");
+				return -EINVAL;
+			}
+			break;
+		case 'n':
+			next_tbl_idx = strtoul(optarg, &ret_ptr, 0);
+			if ((optarg == ret_ptr) || (next_tbl_idx < 0)) {
+				printf("parsing fail, wrong input for --next_table\n");
+				return -EINVAL;
+			}
+			action_type = PP2_CLS_TBL_ACT_LU;
+			break;
 		case 's':
 			key_size[idx] = strtoul(optarg, &ret_ptr, 0);
 			if ((argv[2 + (idx * 3)] == ret_ptr) || (key_size[idx] < 0) ||
@@ -926,6 +1184,14 @@ static int pp2_cls_cli_cls_rule_key(void *arg, int argc, char *argv[])
 		return -EINVAL;
 	}
 
+	if (next_tbl_idx >= 0) {
+		rc = pp2_cls_table_get(next_tbl_idx, &next_tbl, &cls_flow_tbl_head);
+		if (rc) {
+			printf("table not found for index %d\n", next_tbl_idx);
+			return -EINVAL;
+		}
+	}
+
 	rule = malloc(sizeof(*rule));
 	if (!rule)
 		goto rule_add_fail;
@@ -949,6 +1215,12 @@ static int pp2_cls_cli_cls_rule_key(void *arg, int argc, char *argv[])
 			goto rule_add_fail2;
 
 		action->type = action_type;
+		action->next_tbl = next_tbl;
+		action->mark_type = PP2_CLS_TBL_MARK_TYPE_NONE;
+		if (flow_id >= 0) {
+			action->mark_type = PP2_CLS_TBL_MARK_TYPE_FLOW_ID;
+			action->u.flow_id = flow_id;
+		}
 		action->cos->tc = traffic_class;
 		action->cos->ppio = garg.ports_desc[0].ppio;
 
@@ -1536,6 +1808,7 @@ static inline int loop_sw_recycle(struct local_arg	*larg,
 
 		u16 len = pp2_ppio_inq_desc_get_pkt_len(&descs[i]) - PP2_MH_SIZE;
 
+		pr_debug("flow_id(%d)\n", pp2_ppio_inq_desc_get_flow_id(&descs[i]));
 #ifdef PKT_ECHO_SUPPORT
 		if (likely(larg->echo)) {
 			char *tmp_buff;
@@ -1815,10 +2088,14 @@ static int register_cli_cls_api_cmds(struct glob_arg *garg)
 	memset(&cmd_params, 0, sizeof(cmd_params));
 	cmd_params.name		= "cls_tbl_init";
 	cmd_params.desc		= "create a classifier table according to key and default action";
-	cmd_params.format	= "--engine_type --tc --drop(optional) --key\n"
+	cmd_params.format	= "--engine_type --tc --drop(optional) --stats(optional) --aging(optional)\n"
+				  "\t\t\t\t--next_table(optional) --key\n"
 				  "\t\t\t\t--engine_type	(string) exact_match, maskable\n"
 				  "\t\t\t\t--tc			(dec) 1..8\n"
 				  "\t\t\t\t--drop		(no argument)optional\n"
+				  "\t\t\t\t--stats		(dec) optional, enable rule statistics, harvest interval in msec\n"
+				  "\t\t\t\t--aging		(dec) optional, remove rules idle for more than msec\n"
+				  "\t\t\t\t--next_table	(dec) optional, maskable only, exact_match table index to chain lookups to\n"
 				  "\t\t\t\t--key		(string) the following keys are defined:\n"
 				  "\t\t\t\t			eth_src - ethernet, source address\n"
 				  "\t\t\t\t			eth_dst - ethernet, destination address\n"
@@ -1855,12 +2132,16 @@ static int register_cli_cls_api_cmds(struct glob_arg *garg)
 	memset(&cmd_params, 0, sizeof(cmd_params));
 	cmd_params.name		= "cls_rule_key";
 	cmd_params.desc		= "add/modify/remove a classifier rule key to existing table";
-	cmd_params.format	= "--add    --table_index --tc --drop(optional) --size --key --mask...\n"
-				  "--modify --table_index --tc --drop(optional) --size --key --mask...\n"
+	cmd_params.format	= "--add    --table_index --tc --drop(optional) --flow_id(optional) --next_table(optional)\n"
+				  "\t --size --key --mask...\n"
+				  "--modify --table_index --tc --drop(optional) --flow_id(optional) --next_table(optional)\n"
+				  "\t --size --key --mask...\n"
 				  "--remove --table_index --tc --drop(optional) --size --key --mask...\n"
 				  "\t\t\t\t--table_index	(dec) index to existing table\n"
 				  "\t\t\t\t--tc			(dec) 1..8\n"
 				  "\t\t\t\t--drop		(optional)(no argument)\n"
+				  "\t\t\t\t--flow_id		(optional)(dec or hex) 0..0xffff, reported in the RX descriptor\n"
+				  "\t\t\t\t--next_table	(optional)(dec) continue the lookup in this chained table\n"
 				  "\t\t\t\t--size		(dec) size in bytes of the key\n"
 				  "\t\t\t\t--key		(dec or hex) key\n"
 				  "\t\t\t\t			   i.e ipv4: 192.168.10.5\n"
@@ -1873,6 +2154,31 @@ static int register_cli_cls_api_cmds(struct glob_arg *garg)
 	cmd_params.do_cmd_cb	= (int (*)(void *, int, char *[]))pp2_cls_cli_cls_rule_key;
 	mvapp_register_cli_cmd(&cmd_params);
 
+	memset(&cmd_params, 0, sizeof(cmd_params));
+	cmd_params.name		= "cls_tbl_batch";
+	cmd_params.desc		= "open/commit/abort a batch update of the rules of a table";
+	cmd_params.format	= "--begin  --table_index\n"
+				  "--commit --table_index\n"
+				  "--abort  --table_index\n"
+				  "\t\t\t\t--table_index	(dec) index to existing table\n"
+				  "\t\t\t\tcls_rule_key commands issued between --begin and --commit\n"
+				  "\t\t\t\tare written to HW together on --commit\n";
+	cmd_params.cmd_arg	= garg;
+	cmd_params.do_cmd_cb	= (int (*)(void *, int, char *[]))pp2_cls_cli_table_batch;
+	mvapp_register_cli_cmd(&cmd_params);
+
+	memset(&cmd_params, 0, sizeof(cmd_params));
+	cmd_params.name		= "cls_tbl_stats";
+	cmd_params.desc		= "harvest the rule hit counters of a table and display busiest or idle rules";
+	cmd_params.format	= "--table_index --top\n"
+				  "--table_index --idle\n"
+				  "\t\t\t\t--table_index	(dec) index to existing table\n"
+				  "\t\t\t\t--top		(dec) number of most hit rules to display\n"
+				  "\t\t\t\t--idle		(dec) display rules not hit for at least msec\n";
+	cmd_params.cmd_arg	= garg;
+	cmd_params.do_cmd_cb	= (int (*)(void *, int, char *[]))pp2_cls_cli_table_stats;
+	mvapp_register_cli_cmd(&cmd_params);
+
 	memset(&cmd_params, 0, sizeof(cmd_params));
 	cmd_params.name		= "cls_tbl_dump";
 	cmd_params.desc		= "display classifier defined tables in cls_demo application";
@@ -0,0 +1,1624 @@
+/******************************************************************************
+ *	Copyright (C) 2016 Marvell International Ltd.
+ *
+ *  If you received this File from Marvell, you may opt to use, redistribute
+ *  and/or modify this File under the following licensing terms.
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *	* Redistributions of source code must retain the above copyright
+ *	  notice, this list of conditions and the following disclaimer.
+ *
+ *	* Redistributions in binary form must reproduce the above copyright
+ *	  notice, this list of conditions and the following disclaimer in the
+ *	  documentation and/or other materials provided with the distribution.
+ *
+ *	* Neither the name of Marvell nor the names of its contributors may be
+ *	  used to endorse or promote products derived from this software
+ *	  without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#define _GNU_SOURCE         /* See feature_test_macros(7) */
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <arpa/inet.h>
+
+#include "mv_std.h"
+#include "lib/lib_misc.h"
+#include "env/mv_sys_dma.h"
+
+#include "mvapp.h"
+#include "mv_pp2.h"
+#include "mv_pp2_hif.h"
+#include "mv_pp2_bpool.h"
+#include "mv_pp2_ppio.h"
+
+#include "l3fwd_lpm.h"
+
+#define Q_SIZE		1024
+#define TXQ_SIZE	(2 * Q_SIZE)
+#define HIFQ_SIZE	(8 * Q_SIZE)
+#define RXQ_SIZE	(2 * Q_SIZE)
+#define MAX_BURST_SIZE	(Q_SIZE >> 1)
+#define DFLT_BURST_SIZE	64
+#define PKT_OFFS	64
+#define PKT_EFEC_OFFS	(PKT_OFFS + PP2_MH_SIZE)
+#define MAX_NUM_CORES	4
+#define DMA_MEM_SIZE	(40 * 1024 * 1024)
+#define PP2_NUM_BPOOLS_RSRV		3
+#define PP2_BPOOLS_RSRV			((1 << PP2_NUM_BPOOLS_RSRV) - 1)
+#define PP2_HIFS_RSRV			0xF
+#define PP2_MAX_NUM_PORTS		4
+#define PP2_MAX_NUM_TCS_PER_PORT	1
+#define PP2_MAX_NUM_QS_PER_TC		MAX_NUM_CORES
+
+#define DEFAULT_MTU			1500
+#define VLAN_HLEN			4
+#define ETH_HLEN			14
+#define ETH_FCS_LEN			4
+
+#define MVPP2_MTU_TO_MRU(mtu) \
+	((mtu) + PP2_MH_SIZE + VLAN_HLEN + \
+	ETH_HLEN + ETH_FCS_LEN)
+
+/* TODO: find more generic way to get the following parameters */
+#define PP2_TOTAL_NUM_BPOOLS	16
+#define PP2_TOTAL_NUM_HIFS	9
+/* "pool-%d:%d", "ppio-%d:%d" and "hif-%d" match strings, for any int value */
+#define MATCH_NAME_SIZE		32
+#define PP2_MAX_NUM_BPOOLS	min(PP2_PPIO_TC_MAX_POOLS*PP2_PPIO_MAX_NUM_TCS, \
+				PP2_TOTAL_NUM_BPOOLS - PP2_NUM_BPOOLS_RSRV)
+
+#define upper_32_bits(n) ((u32)(((n) >> 16) >> 16))
+#define lower_32_bits(n) ((u32)(n))
+
+/** Get rid of path in filename - only for unix-type paths using '/' */
+#define NO_PATH(file_name) (strrchr((file_name), '/') ? \
+			    strrchr((file_name), '/') + 1 : (file_name))
+
+#define BPOOLS_INF		{ {384, 4096}, {2048, 1024} }
+#define BPOOLS_JUMBO_INF	{ {2048, 4096}, {10240, 512} }
+
+/* Routing */
+#define L3FWD_MAX_NHS		256
+#define L3FWD_DROP		0xffff
+#define L3FWD_LPM4_GRPS		4096
+#define L3FWD_LPM6_GRPS		16384
+#define L3FWD_ROUTE_LINE_LEN	256
+
+/* IPv4/IPv6 header fields used by the forwarding path */
+#define IPV4_TTL_OFFS		8
+#define IPV4_DST_OFFS		16
+#define IPV6_HOP_LIMIT_OFFS	7
+#define IPV6_DST_OFFS		24
+
+/* Benchmark mode */
+#define BENCH_DFLT_MAX_ROUTES	65536
+#define BENCH_NUM_PKTS		8192
+#define BENCH_PKT_SIZE		128
+#define BENCH_PKTS_PER_SIZE	(4 * 1024 * 1024)
+#define BENCH_NUM_NHS		16
+#define BENCH_NUM_PORTS		2
+#define BENCH_TTL		64
+#define BENCH_V6_NUM_BLOCKS	64
+
+struct port_desc {
+	char		 name[15];
+	int		 pp_id;
+	int		 ppio_id;
+	struct pp2_ppio	*port;
+	eth_addr_t	 mac;
+};
+
+struct bpool_inf {
+	int	buff_size;
+	int	num_buffs;
+};
+
+/* Next hop: the L2 header to write and the output port */
+struct l3fwd_nh {
+	u8	l2[2 * ETH_ADDR_NUM_OCTETS];	/* destination then source MAC */
+	u16	port;				/* index in the ports list */
+};
+
+struct route_tbl {
+	struct lpm	*lpm4;
+	struct lpm	*lpm6;
+	int		 num_nhs;
+	struct l3fwd_nh	 nhs[L3FWD_MAX_NHS];
+};
+
+struct l3fwd_stats {
+	u64	rx;
+	u64	tx;
+	u64	tx_drop;	/* TX queue full */
+	u64	no_route;
+	u64	ttl_exceeded;
+	u64	non_ip;
+} __attribute__((aligned(64)));
+
+/* Buffers sent on a port, released once their TX is done */
+struct tx_shadow_q {
+	u16				read_ind;
+	u16				write_ind;
+
+	struct buff_release_entry	ents[TXQ_SIZE + MAX_BURST_SIZE];
+};
+
+struct glob_arg {
+	int			 cli;
+	int			 cpus;	/* cpus used for running */
+	u16			 burst;
+	u16			 mtu;
+	u16			 rxq_size;
+	int			 affinity;
+	int			 maintain_stats;
+	int			 num_ports;
+	int			 pp2_num_inst;
+	struct port_desc	 ports_desc[PP2_MAX_NUM_PORTS];
+	char			*routes_file;
+	u32			 tx_drain_us;
+	int			 bench;
+	u32			 bench_max_routes;
+	u32			 mhz;
+
+	pthread_mutex_t		 trd_lock;
+
+	struct pp2_hif		*hif;
+
+	int			 num_pools;
+	struct pp2_bpool	***pools;
+	struct pp2_buff_inf	***buffs_inf;
+	int			 num_buffs[PP2_NUM_PKT_PROC][PP2_TOTAL_NUM_BPOOLS];
+
+	struct route_tbl	 rt;
+};
+
+struct local_arg {
+	struct tx_shadow_q	 shadow_qs[PP2_MAX_NUM_PORTS];
+	struct pp2_ppio_tx_buffer **txbs;	/* per output port */
+
+	struct pp2_hif		*hif;
+	int			 num_ports;
+	struct pp2_ppio		*ports[PP2_MAX_NUM_PORTS];
+	struct route_tbl	*rt;
+	struct l3fwd_stats	*stats;
+
+	u16			 burst;
+	u8			 qid;
+	int			 id;
+
+	struct glob_arg		*garg;
+};
+
+
+static struct glob_arg garg = {};
+static u64 sys_dma_high_addr = 0;
+
+static u16	used_bpools[PP2_NUM_PKT_PROC] = {PP2_BPOOLS_RSRV, PP2_BPOOLS_RSRV};
+static u16	used_hifs = PP2_HIFS_RSRV;
+
+static struct l3fwd_stats l3fwd_stats[MAX_NUM_CORES];
+static struct pp2_ppio_tx_buffer *l3fwd_txbs[MAX_NUM_CORES][PP2_MAX_NUM_PORTS];
+
+
+static inline enum pp2_outq_l4_type pp2_l4_type_inq_to_outq(enum pp2_inq_l4_type l4_inq)
+{
+	if (likely(l4_inq == PP2_INQ_L4_TYPE_TCP || l4_inq == PP2_INQ_L4_TYPE_UDP))
+		return(l4_inq - 1);
+
+	return(PP2_OUTQ_L4_TYPE_OTHER);
+}
+
+static inline int l3_type_is_ipv4(enum pp2_inq_l3_type l3_type)
+{
+	return (l3_type == PP2_INQ_L3_TYPE_IPV4_NO_OPTS || l3_type == PP2_INQ_L3_TYPE_IPV4_OK);
+}
+
+/* Route a burst of packets: look up all IPv4 and all IPv6 destinations in
+ * one batch each, then rewrite the L2 header and decrement the TTL of every
+ * packet that has a route. out[] gets the output port, or L3FWD_DROP.
+ * The IPv4 header checksum is left to the TX checksum offload.
+ */
+static inline void l3fwd_route(struct route_tbl		*rt,
+			       char			**pkts,
+			       enum pp2_inq_l3_type	*l3_types,
+			       u8			*l3_offs,
+			       u16			 num,
+			       u16			*out,
+			       struct l3fwd_stats	*stats)
+{
+	u32		 ip4[MAX_BURST_SIZE], nh4[MAX_BURST_SIZE], nh6[MAX_BURST_SIZE];
+	const u8	*ip6[MAX_BURST_SIZE];
+	u16		 idx4[MAX_BURST_SIZE], idx6[MAX_BURST_SIZE];
+	u16		 i, j, n4 = 0, n6 = 0;
+	struct l3fwd_nh	*nh;
+	u8		*l3;
+
+	for (i = 0; i < num; i++) {
+		l3 = (u8 *)pkts[i] + l3_offs[i];
+		switch (l3_types[i]) {
+		case PP2_INQ_L3_TYPE_IPV4_NO_OPTS:
+		case PP2_INQ_L3_TYPE_IPV4_OK:
+			memcpy(&ip4[n4], l3 + IPV4_DST_OFFS, sizeof(u32));
+			ip4[n4] = ntohl(ip4[n4]);
+			idx4[n4++] = i;
+			break;
+		case PP2_INQ_L3_TYPE_IPV6_NO_EXT:
+		case PP2_INQ_L3_TYPE_IPV6_EXT:
+			ip6[n6] = l3 + IPV6_DST_OFFS;
+			idx6[n6++] = i;
+			break;
+		case PP2_INQ_L3_TYPE_IPV4_TTL_ZERO:
+			out[i] = L3FWD_DROP;
+			stats->ttl_exceeded++;
+			break;
+		default:
+			out[i] = L3FWD_DROP;
+			stats->non_ip++;
+			break;
+		}
+	}
+
+	if (n4)
+		lpm4_lookup_bulk(rt->lpm4, ip4, nh4, n4);
+	if (n6)
+		lpm6_lookup_bulk(rt->lpm6, ip6, nh6, n6);
+
+	for (j = 0; j < n4; j++) {
+		i = idx4[j];
+		l3 = (u8 *)pkts[i] + l3_offs[i];
+		if (unlikely(nh4[j] == LPM_NH_NONE)) {
+			out[i] = L3FWD_DROP;
+			stats->no_route++;
+			continue;
+		}
+		if (unlikely(l3[IPV4_TTL_OFFS] <= 1)) {
+			out[i] = L3FWD_DROP;
+			stats->ttl_exceeded++;
+			continue;
+		}
+		l3[IPV4_TTL_OFFS]--;
+		nh = &rt->nhs[nh4[j]];
+		memcpy(pkts[i], nh->l2, sizeof(nh->l2));
+		out[i] = nh->port;
+	}
+
+	for (j = 0; j < n6; j++) {
+		i = idx6[j];
+		l3 = (u8 *)pkts[i] + l3_offs[i];
+		if (unlikely(nh6[j] == LPM_NH_NONE)) {
+			out[i] = L3FWD_DROP;
+			stats->no_route++;
+			continue;
+		}
+		if (unlikely(l3[IPV6_HOP_LIMIT_OFFS] <= 1)) {
+			out[i] = L3FWD_DROP;
+			stats->ttl_exceeded++;
+			continue;
+		}
+		l3[IPV6_HOP_LIMIT_OFFS]--;
+		nh = &rt->nhs[nh6[j]];
+		memcpy(pkts[i], nh->l2, sizeof(nh->l2));
+		out[i] = nh->port;
+	}
+}
+
+static inline void free_sent_buffers(struct local_arg *larg, u8 tx_port)
+{
+	struct tx_shadow_q	*shadow_q = &larg->shadow_qs[tx_port];
+	u16			 tx_num, cont_in_shadow, req_num;
+
+	pp2_ppio_get_num_outq_done(larg->ports[tx_port], larg->hif, 0, &tx_num);
+	if (!tx_num)
+		return;
+
+	cont_in_shadow = ARRAY_SIZE(shadow_q->ents) - shadow_q->read_ind;
+	if (tx_num <= cont_in_shadow) {
+		req_num = tx_num;
+		pp2_bpool_put_buffs(larg->hif, &shadow_q->ents[shadow_q->read_ind], &req_num);
+		shadow_q->read_ind += tx_num;
+		if (shadow_q->read_ind == ARRAY_SIZE(shadow_q->ents))
+			shadow_q->read_ind = 0;
+	} else {
+		req_num = cont_in_shadow;
+		pp2_bpool_put_buffs(larg->hif, &shadow_q->ents[shadow_q->read_ind], &req_num);
+		req_num = tx_num - cont_in_shadow;
+		pp2_bpool_put_buffs(larg->hif, &shadow_q->ents[0], &req_num);
+		shadow_q->read_ind = tx_num - cont_in_shadow;
+	}
+}
+
+/* Add a run of packets routed to a port to its TX buffer. The buffer keeps what
+ * the TX queue cannot take yet; packets it cannot buffer are dropped, as a router
+ * would, instead of being retried.
+ */
+static inline void l3fwd_tx(struct local_arg *larg, u8 tx_port, struct pp2_ppio_desc *descs,
+			    struct pp2_buff_inf *binfs, struct pp2_bpool **bpools, u16 num)
+{
+	struct tx_shadow_q	*shadow_q = &larg->shadow_qs[tx_port];
+	u16			 i, tx_num = num;
+
+	pp2_ppio_tx_buffer_add(larg->txbs[tx_port], descs, &tx_num);
+	larg->stats->tx += tx_num;
+
+	/* The buffers are released in the order they are added */
+	for (i = 0; i < tx_num; i++) {
+		shadow_q->ents[shadow_q->write_ind].buff = binfs[i];
+		shadow_q->ents[shadow_q->write_ind].bpool = bpools[i];
+		if (++shadow_q->write_ind == ARRAY_SIZE(shadow_q->ents))
+			shadow_q->write_ind = 0;
+	}
+	for (; i < num; i++) {
+		pp2_bpool_put_buff(larg->hif, bpools[i], &binfs[i]);
+		larg->stats->tx_drop++;
+	}
+}
+
+static inline void l3fwd_rx(struct local_arg *larg, u8 rx_port, u8 tc, u8 qid)
+{
+	struct pp2_ppio_desc	 descs[MAX_BURST_SIZE];
+	char			*pkts[MAX_BURST_SIZE];
+	enum pp2_inq_l3_type	 l3_types[MAX_BURST_SIZE];
+	u8			 l3_offs[MAX_BURST_SIZE];
+	u16			 out[MAX_BURST_SIZE];
+	struct pp2_buff_inf	 binfs[MAX_BURST_SIZE];
+	struct pp2_bpool	*bpools[MAX_BURST_SIZE];
+	struct pp2_ppio_desc	*desc;
+	enum pp2_inq_l4_type	 l4_type;
+	u8			 l4_off;
+	u16			 i, j, len, num = larg->burst;
+
+	pp2_ppio_recv(larg->ports[rx_port], tc, qid, descs, &num);
+	if (!num)
+		return;
+	larg->stats->rx += num;
+
+	/* Start fetching all headers before the first one is parsed */
+	for (i = 0; i < num; i++) {
+		pkts[i] = (char *)(((uintptr_t)pp2_ppio_inq_desc_get_cookie(&descs[i])) | sys_dma_high_addr) +
+			  PKT_EFEC_OFFS;
+		__builtin_prefetch(pkts[i]);
+		pp2_ppio_inq_desc_get_l3_info(&descs[i], &l3_types[i], &l3_offs[i]);
+	}
+
+	l3fwd_route(larg->rt, pkts, l3_types, l3_offs, num, out, larg->stats);
+
+	/* Turn the RX descriptors of the routed packets into TX ones, in place */
+	for (i = 0; i < num; i++) {
+		desc = &descs[i];
+		binfs[i].cookie = pp2_ppio_inq_desc_get_cookie(desc);
+		binfs[i].addr = pp2_ppio_inq_desc_get_phys_addr(desc);
+		bpools[i] = pp2_ppio_inq_desc_get_bpool(desc, larg->ports[rx_port]);
+
+		if (unlikely(out[i] == L3FWD_DROP)) {
+			pp2_bpool_put_buff(larg->hif, bpools[i], &binfs[i]);
+			continue;
+		}
+
+		pp2_ppio_inq_desc_get_l4_info(desc, &l4_type, &l4_off);
+		len = pp2_ppio_inq_desc_get_pkt_len(desc);
+		pp2_ppio_outq_desc_reset(desc);
+		pp2_ppio_outq_desc_set_proto_info(desc,
+						  l3_type_is_ipv4(l3_types[i]) ?
+							PP2_OUTQ_L3_TYPE_IPV4 : PP2_OUTQ_L3_TYPE_IPV6,
+						  pp2_l4_type_inq_to_outq(l4_type), l3_offs[i], l4_off,
+						  l3_type_is_ipv4(l3_types[i]), 0);
+		pp2_ppio_outq_desc_set_phys_addr(desc, binfs[i].addr);
+		pp2_ppio_outq_desc_set_pkt_offset(desc, PKT_EFEC_OFFS);
+		pp2_ppio_outq_desc_set_pkt_len(desc, len);
+	}
+
+	/* Packets of a flow come in runs to the same port, buffered in one call */
+	for (i = 0; i < num; i = j) {
+		for (j = i + 1; j < num && out[j] == out[i]; j++)
+			;
+		if (out[i] != L3FWD_DROP)
+			l3fwd_tx(larg, out[i], &descs[i], &binfs[i], &bpools[i], j - i);
+	}
+}
+
+static int main_loop(void *arg, int *running)
+{
+	struct local_arg	*larg = (struct local_arg *)arg;
+	int			 port;
+
+	if (!larg) {
+		pr_err("no obj!\n");
+		return -EINVAL;
+	}
+
+	while (*running) {
+		/* Packets of all the RX ports are gathered in the per port TX
+		 * buffers, which are drained once per polling round.
+		 */
+		for (port = 0; port < larg->num_ports; port++)
+			l3fwd_rx(larg, port, 0, larg->qid);
+		for (port = 0; port < larg->num_ports; port++) {
+			pp2_ppio_tx_buffer_drain(larg->txbs[port], NULL);
+			free_sent_buffers(larg, port);
+		}
+	}
+
+	return 0;
+}
+
+static int route_tbl_init(struct route_tbl *rt, u32 lpm4_grps, u32 lpm6_grps)
+{
+	memset(rt, 0, sizeof(struct route_tbl));
+	rt->lpm4 = lpm4_create(lpm4_grps);
+	rt->lpm6 = lpm6_create(lpm6_grps);
+	if (!rt->lpm4 || !rt->lpm6) {
+		pr_err("LPM tables init failed!\n");
+		return -ENOMEM;
+	}
+	return 0;
+}
+
+static void route_tbl_deinit(struct route_tbl *rt)
+{
+	lpm_free(rt->lpm4);
+	lpm_free(rt->lpm6);
+	rt->lpm4 = NULL;
+	rt->lpm6 = NULL;
+}
+
+/* Get the next hop of a port and destination MAC, adding it when new */
+static int route_nh_get(struct route_tbl *rt, u16 port, const u8 *dmac, const u8 *smac)
+{
+	int i;
+
+	for (i = 0; i < rt->num_nhs; i++)
+		if (rt->nhs[i].port == port && !memcmp(rt->nhs[i].l2, dmac, ETH_ADDR_NUM_OCTETS))
+			return i;
+
+	if (rt->num_nhs == L3FWD_MAX_NHS) {
+		pr_err("too many next hops (max %d)!\n", L3FWD_MAX_NHS);
+		return -ENOSPC;
+	}
+	memcpy(rt->nhs[i].l2, dmac, ETH_ADDR_NUM_OCTETS);
+	memcpy(rt->nhs[i].l2 + ETH_ADDR_NUM_OCTETS, smac, ETH_ADDR_NUM_OCTETS);
+	rt->nhs[i].port = port;
+	return rt->num_nhs++;
+}
+
+/* Load routes from a text file, one route per line:
+ *	<prefix>/<len> <port> <next-hop-mac>
+ * <prefix> is an IPv4 or IPv6 address, <port> an index in the '-i' list.
+ * Empty lines and anything after a '#' are ignored.
+ */
+static int load_routes(struct glob_arg *garg, const char *path)
+{
+	struct route_tbl	*rt = &garg->rt;
+	char			 line[L3FWD_ROUTE_LINE_LEN], pfx[64], mac_str[32];
+	u8			 addr[LPM6_ADDR_LEN];
+	eth_addr_t		 mac;
+	char			*p;
+	int			 port, depth, is_v6, nh, lineno = 0, err = 0;
+	FILE			*f;
+
+	f = fopen(path, "r");
+	if (!f) {
+		pr_err("can't open routes file %s!\n", path);
+		return -ENOENT;
+	}
+
+	while (fgets(line, sizeof(line), f)) {
+		lineno++;
+		p = strchr(line, '#');
+		if (p)
+			*p = '\0';
+		if (sscanf(line, "%63s", pfx) != 1)
+			continue;
+
+		if ((sscanf(line, "%63s %d %31s", pfx, &port, mac_str) != 3) ||
+		    (sscanf(mac_str, "%hhx:%hhx:%hhx:%hhx:%hhx:%hhx",
+			    &mac[0], &mac[1], &mac[2], &mac[3], &mac[4], &mac[5]) != 6)) {
+			pr_err("%s:%d: invalid route format!\n", path, lineno);
+			err = -EINVAL;
+			break;
+		}
+		if (port < 0 || port >= garg->num_ports) {
+			pr_err("%s:%d: invalid port %d (%d ports)!\n", path, lineno, port, garg->num_ports);
+			err = -EINVAL;
+			break;
+		}
+
+		is_v6 = (strchr(pfx, ':') != NULL);
+		depth = is_v6 ? 128 : 32;
+		p = strchr(pfx, '/');
+		if (p) {
+			*p = '\0';
+			depth = atoi(p + 1);
+		}
+		if (inet_pton(is_v6 ? AF_INET6 : AF_INET, pfx, addr) != 1 ||
+		    depth < 0 || depth > (is_v6 ? 128 : 32)) {
+			pr_err("%s:%d: invalid prefix!\n", path, lineno);
+			err = -EINVAL;
+			break;
+		}
+
+		nh = route_nh_get(rt, port, mac, garg->ports_desc[port].mac);
+		if (nh < 0) {
+			err = nh;
+			break;
+		}
+		err = lpm_add(is_v6 ? rt->lpm6 : rt->lpm4, addr, depth, nh);
+		if (err) {
+			pr_err("%s:%d: route add failed!\n", path, lineno);
+			break;
+		}
+	}
+	fclose(f);
+
+	if (!err)
+		pr_info("loaded %u IPv4 and %u IPv6 routes, %d next hops\n",
+			rt->lpm4->num_rules, rt->lpm6->num_rules, rt->num_nhs);
+	return err;
+}
+
+static int find_port_info(struct port_desc *port_desc)
+{
+	char		 name[20];
+	u8		 pp, ppio;
+	int		 err;
+
+	if (!port_desc->name[0]) {
+		pr_err("No port name given!\n");
+		return -1;
+	}
+
+	memset(name, 0, sizeof(name));
+	snprintf(name, sizeof(name), "%s", port_desc->name);
+	if ((err = pp2_netdev_get_port_info(name,
+					    &pp,
+					    &ppio)) != 0) {
+		pr_err("PP2 Port %s not found!\n", port_desc->name);
+		return err;
+	}
+
+	port_desc->ppio_id = ppio;
+	port_desc->pp_id = pp;
+
+	return 0;
+}
+
+static int find_free_bpool(u32 pp_id)
+{
+	int	i;
+
+	for (i=0; i<PP2_TOTAL_NUM_BPOOLS; i++) {
+		if (!((1 << i) & used_bpools[pp_id])) {
+			used_bpools[pp_id] |= (1 << i);
+			break;
+		}
+	}
+	if (i == PP2_TOTAL_NUM_BPOOLS) {
+		pr_err("no free BPool found!\n");
+		return -ENOSPC;
+	}
+	return i;
+}
+
+static int find_free_hif(void)
+{
+	int	i;
+
+	for (i=0; i<PP2_TOTAL_NUM_HIFS; i++) {
+		if (!((1 << i) & used_hifs)) {
+			used_hifs |= (1 << i);
+			break;
+		}
+	}
+	if (i == PP2_TOTAL_NUM_HIFS) {
+		pr_err("no free HIF found!\n");
+		return -ENOSPC;
+	}
+	return i;
+}
+
+static int init_all_modules(void)
+{
+	struct pp2_init_params	 pp2_params;
+	int			 err;
+
+	pr_info("Global initializations ... \n");
+
+	if ((err = mv_sys_dma_mem_init(DMA_MEM_SIZE)) != 0)
+		return err;
+
+	memset(&pp2_params, 0, sizeof(pp2_params));
+	pp2_params.hif_reserved_map = PP2_HIFS_RSRV;
+	pp2_params.bm_pool_reserved_map = PP2_BPOOLS_RSRV;
+	/* Enable 10G port */
+	pp2_params.ppios[0][0].is_enabled = 1;
+	pp2_params.ppios[0][0].first_inq = 0;
+	/* Enable 1G ports according to DTS files */
+	if (garg.pp2_num_inst == 1) {
+		pp2_params.ppios[0][2].is_enabled = 1;
+		pp2_params.ppios[0][2].first_inq = 0;
+	}
+	if (garg.pp2_num_inst == 2) {
+		/* Enable 10G port */
+		pp2_params.ppios[1][0].is_enabled = 1;
+		pp2_params.ppios[1][0].first_inq = 0;
+		/* Enable 1G ports */
+		pp2_params.ppios[1][1].is_enabled = 1;
+		pp2_params.ppios[1][1].first_inq = 0;
+	}
+	if ((err = pp2_init(&pp2_params)) != 0)
+		return err;
+
+	pr_info("done\n");
+	return 0;
+}
+
+static void flush_pool(struct glob_arg *garg, struct pp2_bpool *bpool)
+{
+	u32 i, buf_num, err = 0;
+
+	pp2_bpool_get_num_buffs(bpool, &buf_num);
+	for (i = 0; i < buf_num; i++) {
+		struct pp2_buff_inf buff;
+
+		err = 0;
+		while (pp2_bpool_get_buff(garg->hif, bpool, &buff)) {
+			err++;
+			if (err == 10000) {
+				pr_err("flush_pool: p2_id=%d, pool_id=%d: Got NULL buf (%d of %d)\n",
+					bpool->pp2_id, bpool->id, i, buf_num);
+				break;
+			}
+		}
+	}
+	pp2_bpool_deinit(bpool);
+}
+
+static int build_all_bpools(struct glob_arg *garg)
+{
+	struct pp2_bpool_params	 	bpool_params;
+	int			 	i, j, k, err, pool_id;
+	struct bpool_inf		std_infs[] = BPOOLS_INF;
+	struct bpool_inf		jumbo_infs[] = BPOOLS_JUMBO_INF;
+	struct bpool_inf		*infs;
+	char				name[MATCH_NAME_SIZE];
+	int 				pp2_num_inst = garg->pp2_num_inst;
+
+	if (garg->mtu > DEFAULT_MTU) {
+		infs = jumbo_infs;
+		garg->num_pools = ARRAY_SIZE(jumbo_infs);
+	} else {
+		infs = std_infs;
+		garg->num_pools = ARRAY_SIZE(std_infs);
+	}
+
+	garg->pools = (struct pp2_bpool ***)calloc(pp2_num_inst, sizeof(struct pp2_bpool **));
+	if (!garg->pools) {
+		pr_err("no mem for bpools array!\n");
+		return -ENOMEM;
+	}
+	garg->buffs_inf =
+		(struct pp2_buff_inf ***)calloc(pp2_num_inst, sizeof(struct pp2_buff_inf **));
+	if (!garg->buffs_inf) {
+		pr_err("no mem for bpools-inf array!\n");
+		return -ENOMEM;
+	}
+	/* TODO: temporary W/A until we have map routines of bpools to ppios */
+	if (garg->num_pools > PP2_MAX_NUM_BPOOLS) {
+		pr_err("only %d pools allowed!\n", PP2_MAX_NUM_BPOOLS);
+		return -EINVAL;
+	}
+
+	for (i=0; i<pp2_num_inst; i++) {
+		garg->pools[i] = (struct pp2_bpool **)calloc(garg->num_pools, sizeof(struct pp2_bpool *));
+		if (!garg->pools[i]) {
+			pr_err("no mem for bpools array!\n");
+			return -ENOMEM;
+		}
+		garg->buffs_inf[i] =
+			(struct pp2_buff_inf **)calloc(garg->num_pools, sizeof(struct pp2_buff_inf *));
+		if (!garg->buffs_inf[i]) {
+			pr_err("no mem for bpools-inf array!\n");
+			return -ENOMEM;
+		}
+
+		for (j=0; j<garg->num_pools; j++) {
+			pool_id = find_free_bpool(i);
+			if (pool_id < 0) {
+				pr_err("free bpool not found!\n");
+				return pool_id;
+			}
+			memset(name, 0, sizeof(name));
+			snprintf(name, sizeof(name), "pool-%d:%d", i, pool_id);
+			pr_debug("found bpool:  %s\n", name);
+			memset(&bpool_params, 0, sizeof(bpool_params));
+			bpool_params.match = name;
+			bpool_params.buff_len = infs[j].buff_size;
+			if ((err = pp2_bpool_init(&bpool_params, &garg->pools[i][j])) != 0)
+				return err;
+			if (!garg->pools[i][j]) {
+				pr_err("BPool init failed!\n");
+				return -EIO;
+			}
+
+			garg->buffs_inf[i][j] =
+				(struct pp2_buff_inf *)calloc(infs[j].num_buffs, sizeof(struct pp2_buff_inf));
+			if (!garg->buffs_inf[i][j]) {
+				pr_err("no mem for bpools-inf array!\n");
+				return -ENOMEM;
+			}
+			garg->num_buffs[i][j] = infs[j].num_buffs;
+
+			for (k=0; k<infs[j].num_buffs; k++) {
+				void * buff_virt_addr;
+				buff_virt_addr = mv_sys_dma_mem_alloc(infs[j].buff_size, 4);
+				if (!buff_virt_addr) {
+					pr_err("failed to allocate mem (%d)!\n", k);
+					return -1;
+				}
+				if (k == 0) {
+					sys_dma_high_addr = ((u64)buff_virt_addr) & (~((1ULL<<32) - 1));
+					pr_debug("sys_dma_high_addr (0x%lx)\n", sys_dma_high_addr);
+				}
+				if ((upper_32_bits((u64)buff_virt_addr)) != (sys_dma_high_addr >> 32)) {
+					pr_err("buff_virt_addr(%p)  upper out of range; skipping this buff\n", buff_virt_addr);
+					continue;
+				}
+				garg->buffs_inf[i][j][k].addr =
+					(bpool_dma_addr_t)mv_sys_dma_mem_virt2phys(buff_virt_addr);
+				garg->buffs_inf[i][j][k].cookie =
+					lower_32_bits((u64)buff_virt_addr); /* cookie contains lower_32_bits of the va */
+			}
+
+			for (k=0; k<infs[j].num_buffs; k++) {
+				if ((err = pp2_bpool_put_buff(garg->hif,
+							      garg->pools[i][j],
+							      &garg->buffs_inf[i][j][k])) != 0)
+					return err;
+			}
+		}
+	}
+
+	return 0;
+}
+
+static void free_pool_buffers(struct pp2_buff_inf *buffs, int num)
+{
+	int i;
+
+	for (i = 0; i < num; i++) {
+		void *buff_virt_addr = (char *)(((uintptr_t)(buffs[i].cookie)) | sys_dma_high_addr);
+
+		if (buffs[i].addr)
+			mv_sys_dma_mem_free(buff_virt_addr);
+	}
+}
+
+static void free_all_pools(struct glob_arg *garg)
+{
+	int i, j;
+
+	if (garg->pools) {
+		for (i = 0; i < garg->pp2_num_inst; i++) {
+			if (garg->pools[i]) {
+				for (j = 0; j < garg->num_pools; j++)
+					if (garg->pools[i][j])
+						flush_pool(garg, garg->pools[i][j]);
+				free(garg->pools[i]);
+			}
+		}
+		free(garg->pools);
+	}
+
+	if (garg->buffs_inf) {
+		for (i = 0; i < garg->pp2_num_inst; i++) {
+			if (garg->buffs_inf[i]) {
+				for (j = 0; j < garg->num_pools; j++)
+					if (garg->buffs_inf[i][j]) {
+						free_pool_buffers(garg->buffs_inf[i][j], garg->num_buffs[i][j]);
+						free(garg->buffs_inf[i][j]);
+					}
+				free(garg->buffs_inf[i]);
+			}
+		}
+		free(garg->buffs_inf);
+	}
+}
+
+static int init_local_modules(struct glob_arg *garg)
+{
+	struct pp2_hif_params	 	hif_params;
+	struct pp2_ppio_params	 	port_params;
+	struct pp2_ppio_inq_params	inq_params;
+	struct port_desc		*port_desc;
+	char				name[MATCH_NAME_SIZE];
+	int			 	i, j, err, port_index, hif_id;
+	u16				mtu;
+
+	pr_info("Local initializations ...\n");
+
+	if ((hif_id = find_free_hif()) < 0) {
+		pr_err("free HIF not found!\n");
+		return hif_id;
+	}
+	memset(name, 0, sizeof(name));
+	snprintf(name, sizeof(name), "hif-%d", hif_id);
+	pr_debug("found hif: %s\n", name);
+	memset(&hif_params, 0, sizeof(hif_params));
+	hif_params.match = name;
+	hif_params.out_size = HIFQ_SIZE;
+	if ((err = pp2_hif_init(&hif_params, &garg->hif)) != 0)
+		return err;
+	if (!garg->hif) {
+		pr_err("HIF init failed!\n");
+		return -EIO;
+	}
+
+	if ((err = build_all_bpools(garg)) != 0)
+		return err;
+
+	for (port_index = 0; port_index < garg->num_ports; port_index++) {
+		port_desc = &garg->ports_desc[port_index];
+		if ((err = find_port_info(port_desc)) != 0) {
+			pr_err("Port info not found!\n");
+			return err;
+		}
+
+		memset(name, 0, sizeof(name));
+		snprintf(name, sizeof(name), "ppio-%d:%d", port_desc->pp_id, port_desc->ppio_id);
+		pr_debug("found port: %s\n", name);
+		memset(&port_params, 0, sizeof(port_params));
+		port_params.match = name;
+		port_params.type = PP2_PPIO_T_NIC;
+		port_params.inqs_params.num_tcs = PP2_MAX_NUM_TCS_PER_PORT;
+		for (i=0; i<port_params.inqs_params.num_tcs; i++) {
+			port_params.inqs_params.tcs_params[i].pkt_offset = PKT_OFFS>>2;
+			port_params.inqs_params.tcs_params[i].num_in_qs = PP2_MAX_NUM_QS_PER_TC;
+			inq_params.size = garg->rxq_size;
+			port_params.inqs_params.tcs_params[i].inqs_params = &inq_params;
+			for (j=0; j<garg->num_pools; j++)
+				port_params.inqs_params.tcs_params[i].pools[j] =
+					garg->pools[port_desc->pp_id][j];
+		}
+		port_params.outqs_params.num_outqs = PP2_MAX_NUM_TCS_PER_PORT;
+		for (i=0; i<port_params.outqs_params.num_outqs; i++) {
+			port_params.outqs_params.outqs_params[i].size = TXQ_SIZE;
+			port_params.outqs_params.outqs_params[i].weight = 1;
+		}
+		port_params.maintain_stats = garg->maintain_stats;
+		if ((err = pp2_ppio_init(&port_params, &port_desc->port)) != 0)
+			return err;
+		if (!port_desc->port) {
+			pr_err("PP-IO init failed!\n");
+			return -EIO;
+		}
+
+		pp2_ppio_get_mtu(port_desc->port, &mtu);
+		if (mtu != garg->mtu) {
+			pp2_ppio_set_mtu(port_desc->port, garg->mtu);
+			pp2_ppio_set_mru(port_desc->port, MVPP2_MTU_TO_MRU(garg->mtu));
+			pr_info("Set port ppio-%d:%d MTU to %d\n",
+				port_desc->pp_id, port_desc->ppio_id, garg->mtu);
+		}
+
+		/* Source MAC of the packets routed to this port */
+		if ((err = pp2_ppio_get_mac_addr(port_desc->port, port_desc->mac)) != 0)
+			return err;
+
+		if ((err = pp2_ppio_enable(port_desc->port)) != 0)
+			return err;
+	}
+
+	pr_info("done\n");
+	return 0;
+}
+
+static void free_rx_queues(struct pp2_ppio *port)
+{
+	struct pp2_ppio_desc	descs[MAX_BURST_SIZE];
+	u8			tc = 0, qid = 0;
+	u16			num;
+
+	for (tc = 0; tc < PP2_MAX_NUM_TCS_PER_PORT; tc++) {
+		for (qid = 0; qid < PP2_MAX_NUM_QS_PER_TC; qid++) {
+			num = MAX_BURST_SIZE;
+			while (num)
+				pp2_ppio_recv(port, tc, qid, descs, &num);
+		}
+	}
+}
+
+static void destroy_local_modules(struct glob_arg *garg)
+{
+	int i;
+
+	for (i = 0;  i < garg->num_ports; i++) {
+		if (garg->ports_desc[i].port) {
+			pp2_ppio_disable(garg->ports_desc[i].port);
+			free_rx_queues(garg->ports_desc[i].port);
+		}
+	}
+
+	free_all_pools(garg);
+
+	for (i = 0;  i < garg->num_ports; i++) {
+		if (garg->ports_desc[i].port)
+			pp2_ppio_deinit(garg->ports_desc[i].port);
+	}
+
+	if (garg->hif)
+		pp2_hif_deinit(garg->hif);
+}
+
+static void destroy_all_modules(void)
+{
+	pp2_deinit();
+	mv_sys_dma_mem_destroy();
+}
+
+static int stat_cmd_cb(void *arg, int argc, char *argv[])
+{
+	struct glob_arg		*garg = (struct glob_arg *)arg;
+	struct l3fwd_stats	*stats;
+	struct pp2_ppio_tx_buffer_statistics txb_stats;
+	u64			 sent, doorbells;
+	int			 i, port, reset = 0;
+
+	if (!garg) {
+		pr_err("no garg obj passed!\n");
+		return -EINVAL;
+	}
+	if (argc > 1)
+		reset = 1;
+
+	for (i = 0; i < garg->cpus; i++) {
+		stats = &l3fwd_stats[i];
+		printf("cpu%d: rx=%lu, tx=%lu, tx_drops=%lu, no_route=%lu, ttl_exceeded=%lu, non_ip=%lu",
+		       i, stats->rx, stats->tx, stats->tx_drop, stats->no_route,
+		       stats->ttl_exceeded, stats->non_ip);
+		sent = 0;
+		doorbells = 0;
+		for (port = 0; port < garg->num_ports; port++) {
+			if (!l3fwd_txbs[i][port])
+				continue;
+			pp2_ppio_tx_buffer_get_statistics(l3fwd_txbs[i][port], &txb_stats, reset);
+			sent += txb_stats.sent;
+			doorbells += txb_stats.doorbells;
+		}
+		printf(", doorbells=%lu, pkts/doorbell=%lu\n", doorbells, doorbells ? sent / doorbells : 0);
+		if (reset)
+			memset(stats, 0, sizeof(struct l3fwd_stats));
+	}
+	return 0;
+}
+
+static int route_cmd_cb(void *arg, int argc, char *argv[])
+{
+	struct glob_arg		*garg = (struct glob_arg *)arg;
+	struct route_tbl	*rt;
+	int			 i;
+
+	if (!garg) {
+		pr_err("no garg obj passed!\n");
+		return -EINVAL;
+	}
+	rt = &garg->rt;
+
+	printf("IPv4: %u routes, %u of %u groups, %lu KB\n", rt->lpm4->num_rules,
+	       rt->lpm4->used_grps, rt->lpm4->num_grps, lpm_mem_size(rt->lpm4) / 1024);
+	printf("IPv6: %u routes, %u of %u groups, %lu KB\n", rt->lpm6->num_rules,
+	       rt->lpm6->used_grps, rt->lpm6->num_grps, lpm_mem_size(rt->lpm6) / 1024);
+	for (i = 0; i < rt->num_nhs; i++)
+		printf("nh %3d: port %d, dmac %02x:%02x:%02x:%02x:%02x:%02x\n", i, rt->nhs[i].port,
+		       rt->nhs[i].l2[0], rt->nhs[i].l2[1], rt->nhs[i].l2[2],
+		       rt->nhs[i].l2[3], rt->nhs[i].l2[4], rt->nhs[i].l2[5]);
+	return 0;
+}
+
+static int register_cli_cmds(struct glob_arg *garg)
+{
+	struct cli_cmd_params	 cmd_params;
+
+	memset(&cmd_params, 0, sizeof(cmd_params));
+	cmd_params.name		= "stat";
+	cmd_params.desc		= "Show forwarding statistics";
+	cmd_params.format	= "<reset>";
+	cmd_params.cmd_arg	= garg;
+	cmd_params.do_cmd_cb	= (int (*)(void *, int, char *[]))stat_cmd_cb;
+	mvapp_register_cli_cmd(&cmd_params);
+
+	memset(&cmd_params, 0, sizeof(cmd_params));
+	cmd_params.name		= "route";
+	cmd_params.desc		= "Show route tables and next hops";
+	cmd_params.format	= "";
+	cmd_params.cmd_arg	= garg;
+	cmd_params.do_cmd_cb	= (int (*)(void *, int, char *[]))route_cmd_cb;
+	mvapp_register_cli_cmd(&cmd_params);
+
+	return 0;
+}
+
+static int init_global(void *arg)
+{
+	struct glob_arg *garg = (struct glob_arg *)arg;
+	int		 err;
+
+	if (!garg) {
+		pr_err("no obj!\n");
+		return -EINVAL;
+	}
+
+	if (pthread_mutex_init(&garg->trd_lock, NULL) != 0) {
+		pr_err("init lock failed!\n");
+		return -EIO;
+	}
+
+	if ((err = init_all_modules()) != 0)
+		return err;
+
+	if ((err = init_local_modules(garg)) != 0)
+		return err;
+
+	/* Routes need the ports MAC addresses */
+	if ((err = route_tbl_init(&garg->rt, L3FWD_LPM4_GRPS, L3FWD_LPM6_GRPS)) != 0)
+		return err;
+	if ((err = load_routes(garg, garg->routes_file)) != 0)
+		return err;
+
+	if (garg->cli && ((err = register_cli_cmds(garg)) != 0))
+		return err;
+
+	return 0;
+}
+
+static void deinit_global(void *arg)
+{
+	struct glob_arg *garg = (struct glob_arg *)arg;
+
+	if (!garg)
+		return;
+	destroy_local_modules(garg);
+	destroy_all_modules();
+	route_tbl_deinit(&garg->rt);
+}
+
+static void deinit_local(void *arg)
+{
+	struct local_arg *larg = (struct local_arg *)arg;
+	int i;
+
+	if (!larg)
+		return;
+
+	for (i = 0; larg->txbs && i < larg->num_ports; i++)
+		if (larg->txbs[i]) {
+			pp2_ppio_tx_buffer_deinit(larg->txbs[i]);
+			larg->txbs[i] = NULL;
+		}
+	if (larg->hif)
+		pp2_hif_deinit(larg->hif);
+	free(larg);
+}
+
+static int init_local(void *arg, int id, void **_larg)
+{
+	struct glob_arg		*garg = (struct glob_arg *)arg;
+	struct local_arg	*larg;
+	struct pp2_hif_params	 hif_params;
+	struct pp2_ppio_tx_buffer_params txb_params;
+	char			 name[MATCH_NAME_SIZE];
+	int			 i, err, hif_id;
+
+	if (!garg) {
+		pr_err("no obj!\n");
+		return -EINVAL;
+	}
+
+	larg = (struct local_arg *)malloc(sizeof(struct local_arg));
+	if (!larg) {
+		pr_err("No mem for local arg obj!\n");
+		return -ENOMEM;
+	}
+	memset(larg, 0, sizeof(struct local_arg));
+
+	pthread_mutex_lock(&garg->trd_lock);
+	if ((hif_id = find_free_hif()) < 0) {
+		pr_err("free HIF not found!\n");
+		pthread_mutex_unlock(&garg->trd_lock);
+		free(larg);
+		return hif_id;
+	}
+	memset(name, 0, sizeof(name));
+	snprintf(name, sizeof(name), "hif-%d", hif_id);
+	pr_debug("found hif: %s\n", name);
+	memset(&hif_params, 0, sizeof(hif_params));
+	hif_params.match = name;
+	hif_params.out_size = HIFQ_SIZE;
+	err = pp2_hif_init(&hif_params, &larg->hif);
+	pthread_mutex_unlock(&garg->trd_lock);
+	if (err != 0 || !larg->hif) {
+		pr_err("HIF init failed!\n");
+		free(larg);
+		return err ? err : -EIO;
+	}
+
+	larg->id	= id;
+	larg->burst	= garg->burst;
+	larg->num_ports	= garg->num_ports;
+	for (i = 0; i < larg->num_ports; i++)
+		larg->ports[i] = garg->ports_desc[i].port;
+	larg->rt	= &garg->rt;
+	larg->stats	= &l3fwd_stats[id];
+	larg->garg	= garg;
+	/* Each thread owns one RX queue on every port; RSS spreads the flows */
+	larg->qid	= id;
+
+	/* A burst of packets routed to a port is sent at once */
+	larg->txbs	= l3fwd_txbs[id];
+	memset(&txb_params, 0, sizeof(txb_params));
+	txb_params.hif = larg->hif;
+	txb_params.qid = 0;
+	txb_params.size = larg->burst;
+	txb_params.drain_timeout_us = garg->tx_drain_us;
+	for (i = 0; i < larg->num_ports; i++) {
+		txb_params.ppio = larg->ports[i];
+		err = pp2_ppio_tx_buffer_init(&txb_params, &larg->txbs[i]);
+		if (err) {
+			pr_err("TX buffer init failed!\n");
+			deinit_local(larg);
+			return err;
+		}
+	}
+
+	pr_debug("thread %d (cpu %d) mapped to RX queue %d using %s\n",
+		 larg->id, sched_getcpu(), larg->qid, name);
+
+	*_larg = larg;
+	return 0;
+}
+
+/* Benchmark mode: the routing stage of the data path (batch lookup plus
+ * header rewrite) runs on synthetic packets in memory, with no PPv2 at all,
+ * to show its cost against the route table size.
+ */
+static u32 bench_rand(void)
+{
+	static u32 x = 0x2545f491;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	return x;
+}
+
+/* Fill the bits of a key beyond depth with random values */
+static void bench_rand_host(u8 *key, int key_len, int depth)
+{
+	int i, bits;
+
+	for (i = 0; i < key_len; i++) {
+		bits = depth - i * 8;
+		if (bits <= 0)
+			key[i] = bench_rand();
+		else if (bits < 8)
+			key[i] = (key[i] & (0xff << (8 - bits))) | (bench_rand() & (0xff >> bits));
+	}
+}
+
+static int bench_add_routes(struct route_tbl *rt, int is_v6, u32 num, u8 (*keys)[LPM6_ADDR_LEN], u8 *depths)
+{
+	u8	blocks[BENCH_V6_NUM_BLOCKS][4];
+	u32	i, r;
+	int	j, err;
+
+	/* IPv6 routes are mostly /48s under a few provider /32s of 2000::/3 */
+	for (i = 0; i < BENCH_V6_NUM_BLOCKS; i++) {
+		for (j = 0; j < 4; j++)
+			blocks[i][j] = bench_rand();
+		blocks[i][0] = 0x20 | (blocks[i][0] & 0x1f);
+	}
+
+	for (i = 0; i < num; i++) {
+		r = bench_rand() % 100;
+		for (j = 0; j < LPM6_ADDR_LEN; j++)
+			keys[i][j] = bench_rand();
+		if (!is_v6) {
+			/* Prefix lengths roughly follow those of an Internet table */
+			if (r < 2)
+				depths[i] = 25 + bench_rand() % 8;
+			else if (r < 55)
+				depths[i] = 24;
+			else if (r < 99)
+				depths[i] = 16 + bench_rand() % 8;
+			else
+				depths[i] = 8 + bench_rand() % 8;
+		} else {
+			memcpy(keys[i], blocks[bench_rand() % BENCH_V6_NUM_BLOCKS], 4);
+			if (r < 60)
+				depths[i] = 48;
+			else if (r < 80)
+				depths[i] = 32 + bench_rand() % 16;
+			else if (r < 98)
+				depths[i] = 49 + bench_rand() % 16;
+			else
+				depths[i] = 65 + bench_rand() % 64;
+		}
+		err = lpm_add(is_v6 ? rt->lpm6 : rt->lpm4, keys[i], depths[i], bench_rand() % rt->num_nhs);
+		if (err)
+			return err;
+	}
+
+	/* Default route, so that all packets are forwarded */
+	memset(keys[num], 0, LPM6_ADDR_LEN);
+	return lpm_add(is_v6 ? rt->lpm6 : rt->lpm4, keys[num], 0, 0);
+}
+
+static void bench_build_pkts(char *pkts_mem, char **pkts, enum pp2_inq_l3_type *l3_types, u8 *l3_offs,
+			     int is_v6, u32 num_routes, u8 (*keys)[LPM6_ADDR_LEN], u8 *depths)
+{
+	u8	*pkt, *l3;
+	u32	 i, r;
+
+	memset(pkts_mem, 0, BENCH_NUM_PKTS * BENCH_PKT_SIZE);
+	for (i = 0; i < BENCH_NUM_PKTS; i++) {
+		pkts[i] = pkts_mem + i * BENCH_PKT_SIZE;
+		pkt = (u8 *)pkts[i];
+		l3 = pkt + ETH_HLEN;
+		l3_offs[i] = ETH_HLEN;
+		r = bench_rand() % num_routes;
+		if (!is_v6) {
+			l3_types[i] = PP2_INQ_L3_TYPE_IPV4_NO_OPTS;
+			pkt[12] = 0x08;
+			l3[0] = 0x45;
+			l3[9] = 17;
+			memcpy(l3 + IPV4_DST_OFFS, keys[r], 4);
+			bench_rand_host(l3 + IPV4_DST_OFFS, 4, depths[r]);
+		} else {
+			l3_types[i] = PP2_INQ_L3_TYPE_IPV6_NO_EXT;
+			pkt[12] = 0x86;
+			pkt[13] = 0xdd;
+			l3[0] = 0x60;
+			l3[6] = 17;
+			memcpy(l3 + IPV6_DST_OFFS, keys[r], LPM6_ADDR_LEN);
+			bench_rand_host(l3 + IPV6_DST_OFFS, LPM6_ADDR_LEN, depths[r]);
+		}
+	}
+}
+
+static u32 bench_cpu_mhz(void)
+{
+	FILE	*f;
+	u32	 khz = 0;
+
+	f = fopen("/sys/devices/system/cpu/cpu0/cpufreq/scaling_cur_freq", "r");
+	if (!f)
+		return 0;
+	if (fscanf(f, "%u", &khz) != 1)
+		khz = 0;
+	fclose(f);
+	return khz / 1000;
+}
+
+static int bench_run_size(struct glob_arg *garg, int is_v6, u32 num_routes, char *pkts_mem,
+			  u8 (*keys)[LPM6_ADDR_LEN], u8 *depths)
+{
+	char			*pkts[BENCH_NUM_PKTS];
+	enum pp2_inq_l3_type	 l3_types[BENCH_NUM_PKTS];
+	u8			 l3_offs[BENCH_NUM_PKTS];
+	u16			 out[MAX_BURST_SIZE];
+	struct route_tbl	*rt = &garg->rt;
+	struct lpm		*lpm;
+	struct l3fwd_stats	 stats;
+	struct timespec		 t0, t1;
+	u64			 ns = 0, done = 0;
+	u8			 ttl_offs = is_v6 ? IPV6_HOP_LIMIT_OFFS : IPV4_TTL_OFFS;
+	u8			 dmac[ETH_ADDR_NUM_OCTETS], smac[ETH_ADDR_NUM_OCTETS];
+	u32			 i, j, num;
+	int			 err;
+
+	/* One table at a time is sized for the run, the other is left minimal */
+	err = route_tbl_init(rt, is_v6 ? 0 : num_routes / 16 + 256, is_v6 ? num_routes * 3 + 1024 : 0);
+	if (err)
+		goto out;
+	for (i = 0; i < BENCH_NUM_NHS; i++) {
+		for (j = 0; j < ETH_ADDR_NUM_OCTETS; j++) {
+			dmac[j] = bench_rand();
+			smac[j] = i % BENCH_NUM_PORTS;
+		}
+		route_nh_get(rt, i % BENCH_NUM_PORTS, dmac, smac);
+	}
+	err = bench_add_routes(rt, is_v6, num_routes, keys, depths);
+	if (err) {
+		pr_err("bench: failed to add %u routes!\n", num_routes);
+		goto out;
+	}
+	bench_build_pkts(pkts_mem, pkts, l3_types, l3_offs, is_v6, num_routes, keys, depths);
+
+	memset(&stats, 0, sizeof(stats));
+	while (done < BENCH_PKTS_PER_SIZE) {
+		/* Restore the TTLs out of the timed section, each pass decrements them */
+		for (i = 0; i < BENCH_NUM_PKTS; i++)
+			pkts[i][ETH_HLEN + ttl_offs] = BENCH_TTL;
+
+		clock_gettime(CLOCK_MONOTONIC, &t0);
+		for (i = 0; i < BENCH_NUM_PKTS; i += num) {
+			num = min((u32)garg->burst, BENCH_NUM_PKTS - i);
+			l3fwd_route(rt, &pkts[i], &l3_types[i], &l3_offs[i], num, out, &stats);
+		}
+		clock_gettime(CLOCK_MONOTONIC, &t1);
+		ns += (t1.tv_sec - t0.tv_sec) * 1000000000ULL + t1.tv_nsec - t0.tv_nsec;
+		done += BENCH_NUM_PKTS;
+	}
+
+	lpm = is_v6 ? rt->lpm6 : rt->lpm4;
+	printf("%-4s %8u %8u %10lu %10.1f", is_v6 ? "IPv6" : "IPv4", lpm->num_rules, lpm->used_grps,
+	       lpm_mem_size(lpm) / 1024, (double)ns / done);
+	if (garg->mhz)
+		printf(" %10.1f", (double)ns * garg->mhz / 1000 / done);
+	else
+		printf(" %10s", "-");
+	printf(" %8lu\n", stats.no_route + stats.ttl_exceeded);
+
+out:
+	route_tbl_deinit(rt);
+	return err;
+}
+
+static int run_bench(struct glob_arg *garg)
+{
+	u8	(*keys)[LPM6_ADDR_LEN];
+	u8	*depths;
+	char	*pkts_mem;
+	u32	 num_routes;
+	int	 is_v6, err = 0;
+
+	if (!garg->mhz)
+		garg->mhz = bench_cpu_mhz();
+
+	keys = malloc((garg->bench_max_routes + 1) * sizeof(*keys));
+	depths = malloc(garg->bench_max_routes + 1);
+	pkts_mem = malloc(BENCH_NUM_PKTS * BENCH_PKT_SIZE);
+	if (!keys || !depths || !pkts_mem) {
+		pr_err("no mem for benchmark!\n");
+		err = -ENOMEM;
+		goto out;
+	}
+
+	printf("routing stage of a %d packets working set, burst %d, cpu %u MHz\n",
+	       BENCH_NUM_PKTS, garg->burst, garg->mhz);
+	printf("%-4s %8s %8s %10s %10s %10s %8s\n",
+	       "", "routes", "groups", "mem[KB]", "ns/pkt", "cycles/pkt", "drops");
+	for (is_v6 = 0; is_v6 < 2 && !err; is_v6++) {
+		for (num_routes = 16; !err; num_routes *= 16) {
+			if (num_routes > garg->bench_max_routes)
+				num_routes = garg->bench_max_routes;
+			err = bench_run_size(garg, is_v6, num_routes, pkts_mem, keys, depths);
+			if (num_routes == garg->bench_max_routes)
+				break;
+		}
+	}
+
+out:
+	if (keys)
+		free(keys);
+	if (depths)
+		free(depths);
+	if (pkts_mem)
+		free(pkts_mem);
+	return err;
+}
+
+static void usage(char *progname)
+{
+	printf("\n"
+	       "MUSDK L3 forwarding application.\n"
+	       "\n"
+	       "Usage: %s OPTIONS\n"
+	       "  E.g. %s -i eth0,eth2 -r routes.txt -c 2\n"
+	       "       %s --bench 1048576\n"
+	       "\n"
+	       "Mandatory OPTIONS (forwarding mode):\n"
+	       "\t-i, --interface <Eth-interfaces> (comma-separated, no spaces)\n"
+	       "                  Interface count min 1, max %i\n"
+	       "\t-r <file>                Routes file, one '<prefix>/<len> <port> <next-hop-mac>' per line;\n"
+	       "                         <port> is the interface index in the '-i' list\n"
+	       "\n"
+	       "Optional OPTIONS:\n"
+	       "\t-b <size>                Burst size, num_pkts handled in a batch.(default is %d)\n"
+	       "\t--mtu <mtu>              Set MTU (default is %d)\n"
+	       "\t-c, --cores <number>     Number of CPUs to use\n"
+	       "\t-a, --affinity <number>  Use setaffinity (default is no affinity)\n"
+	       "\t-s                       Maintain statistics\n"
+	       "\t--rxq <size>             Size of rx_queue (default is %d)\n"
+	       "\t--tx-drain <usecs>       Age of the oldest packet at which a partial TX buffer is sent;\n"
+	       "                         0 sends them once per polling round (default is 0)\n"
+	       "\t--cli                    Use CLI\n"
+	       "\t--bench [routes]         Run the routing stage on synthetic packets, with no PPv2, for\n"
+	       "                         route tables of up to [routes] routes (default is %d)\n"
+	       "\t--mhz <MHz>              CPU clock for the benchmark cycles/packet (default from cpufreq)\n"
+	       "\t?, -h, --help            Display help and exit\n\n"
+	       "\n", NO_PATH(progname), NO_PATH(progname), NO_PATH(progname), PP2_MAX_NUM_PORTS,
+	       DFLT_BURST_SIZE, DEFAULT_MTU, RXQ_SIZE, BENCH_DFLT_MAX_ROUTES
+	       );
+}
+
+static int parse_args(struct glob_arg *garg, int argc, char *argv[])
+{
+	int	i = 1;
+
+	garg->cli = 0;
+	garg->cpus = 1;
+	garg->affinity = -1;
+	garg->burst = DFLT_BURST_SIZE;
+	garg->mtu = DEFAULT_MTU;
+	garg->tx_drain_us = 0;
+	garg->rxq_size = RXQ_SIZE;
+	garg->maintain_stats = 0;
+	garg->routes_file = NULL;
+	garg->bench = 0;
+	garg->bench_max_routes = BENCH_DFLT_MAX_ROUTES;
+	garg->mhz = 0;
+
+	while (i < argc) {
+		if ((strcmp(argv[i], "?") == 0) ||
+		    (strcmp(argv[i], "-h") == 0) ||
+		    (strcmp(argv[i], "--help") == 0)) {
+			usage(argv[0]);
+			exit(0);
+		} else if (strcmp(argv[i], "--bench") == 0) {
+			garg->bench = 1;
+			if ((argc > (i+1)) && (argv[i+1][0] != '-')) {
+				garg->bench_max_routes = atoi(argv[i+1]);
+				i += 2;
+			} else {
+				i += 1;
+			}
+		} else if (strcmp(argv[i], "--cli") == 0) {
+			garg->cli = 1;
+			i += 1;
+		} else if (strcmp(argv[i], "-s") == 0) {
+			garg->maintain_stats = 1;
+			i += 1;
+		} else if (argc < (i+2)) {
+			pr_err("Invalid number of arguments!\n");
+			return -EINVAL;
+		} else if (strcmp(argv[i], "-i") == 0) {
+			char *token;
+
+			if (argv[i+1][0] == '-') {
+				pr_err("Invalid interface arguments format!\n");
+				return -EINVAL;
+			}
+
+			/* count the number of tokens separated by ',' */
+			for (token = strtok(argv[i+1], ","), garg->num_ports = 0;
+			     token != NULL && garg->num_ports < PP2_MAX_NUM_PORTS;
+			     token = strtok(NULL, ","), garg->num_ports++)
+				snprintf(garg->ports_desc[garg->num_ports].name,
+					 sizeof(garg->ports_desc[garg->num_ports].name),
+					 "%s", token);
+
+			if (garg->num_ports == 0) {
+				pr_err("Invalid interface arguments format!\n");
+				return -EINVAL;
+			} else if (token) {
+				pr_err("too many ports specified (max %d)\n", PP2_MAX_NUM_PORTS);
+				return -EINVAL;
+			}
+			i += 2;
+		} else if (strcmp(argv[i], "-r") == 0) {
+			garg->routes_file = argv[i+1];
+			i += 2;
+		} else if (strcmp(argv[i], "-b") == 0) {
+			garg->burst = atoi(argv[i+1]);
+			i += 2;
+		} else if (strcmp(argv[i], "--mtu") == 0) {
+			garg->mtu = atoi(argv[i+1]);
+			i += 2;
+		} else if (strcmp(argv[i], "-c") == 0) {
+			garg->cpus = atoi(argv[i+1]);
+			i += 2;
+		} else if (strcmp(argv[i], "-a") == 0) {
+			garg->affinity = atoi(argv[i+1]);
+			i += 2;
+		} else if (strcmp(argv[i], "--rxq") == 0) {
+			garg->rxq_size = atoi(argv[i+1]);
+			i += 2;
+		} else if (strcmp(argv[i], "--tx-drain") == 0) {
+			garg->tx_drain_us = atoi(argv[i+1]);
+			i += 2;
+		} else if (strcmp(argv[i], "--mhz") == 0) {
+			garg->mhz = atoi(argv[i+1]);
+			i += 2;
+		} else {
+			pr_err("argument (%s) not supported!\n", argv[i]);
+			return -EINVAL;
+		}
+	}
+
+	/* Now, check validity of all inputs */
+	if (!garg->burst || garg->burst > MAX_BURST_SIZE) {
+		pr_err("illegal burst size requested (%d vs %d)!\n",
+			garg->burst, MAX_BURST_SIZE);
+		return -EINVAL;
+	}
+	if (garg->bench) {
+		if (!garg->bench_max_routes) {
+			pr_err("illegal benchmark route table size!\n");
+			return -EINVAL;
+		}
+		return 0;
+	}
+	if (!garg->num_ports) {
+		pr_err("No port defined!\n");
+		return -EINVAL;
+	}
+	if (!garg->routes_file) {
+		pr_err("No routes file defined!\n");
+		return -EINVAL;
+	}
+	if (garg->cpus < 1 || garg->cpus > MAX_NUM_CORES) {
+		pr_err("illegal num cores requested (%d vs %d)!\n",
+			garg->cpus, MAX_NUM_CORES);
+		return -EINVAL;
+	}
+	if ((garg->affinity != -1) &&
+	    ((garg->cpus + garg->affinity) > MAX_NUM_CORES)) {
+		pr_err("illegal num cores or affinity requested (%d,%d vs %d)!\n",
+			garg->cpus, garg->affinity, MAX_NUM_CORES);
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+
+int main (int argc, char *argv[])
+{
+	struct mvapp_params	mvapp_params;
+	u64			cores_mask;
+	int			i, err;
+
+	setbuf(stdout, NULL);
+
+	if ((err = parse_args(&garg, argc, argv)) != 0)
+		return err;
+
+	if (garg.bench)
+		return run_bench(&garg);
+
+	pr_info("l3fwd is started\n");
+	garg.pp2_num_inst = pp2_get_num_inst();
+
+	cores_mask = 0;
+	for (i=0; i<garg.cpus; i++, cores_mask<<=1, cores_mask|=1) ;
+	cores_mask <<= (garg.affinity != -1) ? garg.affinity : 0;
+
+	memset(&mvapp_params, 0, sizeof(mvapp_params));
+	mvapp_params.use_cli		= garg.cli;
+	mvapp_params.num_cores		= garg.cpus;
+	mvapp_params.cores_mask		= cores_mask;
+	mvapp_params.global_arg		= (void *)&garg;
+	mvapp_params.init_global_cb	= init_global;
+	mvapp_params.deinit_global_cb	= deinit_global;
+	mvapp_params.init_local_cb	= init_local;
+	mvapp_params.deinit_local_cb	= deinit_local;
+	mvapp_params.main_loop_cb	= main_loop;
+	return mvapp_go(&mvapp_params);
+}
@@ -0,0 +1,193 @@
+/******************************************************************************
+ *	Copyright (C) 2016 Marvell International Ltd.
+ *
+ *  If you received this File from Marvell, you may opt to use, redistribute
+ *  and/or modify this File under the following licensing terms.
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *	* Redistributions of source code must retain the above copyright
+ *	  notice, this list of conditions and the following disclaimer.
+ *
+ *	* Redistributions in binary form must reproduce the above copyright
+ *	  notice, this list of conditions and the following disclaimer in the
+ *	  documentation and/or other materials provided with the distribution.
+ *
+ *	* Neither the name of Marvell nor the names of its contributors may be
+ *	  used to endorse or promote products derived from this software
+ *	  without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include <string.h>
+#include <stdlib.h>
+
+#include "mv_std.h"
+#include "l3fwd_lpm.h"
+
+static inline u32 lpm_ent_build(u8 depth, u32 val)
+{
+	return LPM_ENT_VALID | ((u32)depth << LPM_ENT_DEPTH_SHIFT) | val;
+}
+
+static inline u8 lpm_ent_depth(u32 ent)
+{
+	return (ent & LPM_ENT_DEPTH_MASK) >> LPM_ENT_DEPTH_SHIFT;
+}
+
+static struct lpm *lpm_create(u32 tbl0_bits, u32 key_bits, u32 num_grps)
+{
+	struct lpm *lpm;
+
+	if (num_grps > LPM_ENT_VAL_MASK + 1) {
+		pr_err("too many LPM groups (%u vs %u)!\n", num_grps, LPM_ENT_VAL_MASK + 1);
+		return NULL;
+	}
+
+	lpm = (struct lpm *)malloc(sizeof(struct lpm));
+	if (!lpm) {
+		pr_err("no mem for LPM obj!\n");
+		return NULL;
+	}
+	memset(lpm, 0, sizeof(struct lpm));
+
+	/* All-zero entries are invalid, i.e. a lookup miss */
+	lpm->tbl0 = (u32 *)calloc(1 << tbl0_bits, sizeof(u32));
+	lpm->tbl8 = (u32 *)calloc((size_t)num_grps * LPM_GRP_ENTS, sizeof(u32));
+	if (!lpm->tbl0 || (num_grps && !lpm->tbl8)) {
+		pr_err("no mem for LPM tables!\n");
+		lpm_free(lpm);
+		return NULL;
+	}
+	lpm->tbl0_bits = tbl0_bits;
+	lpm->key_bits = key_bits;
+	lpm->num_grps = num_grps;
+
+	return lpm;
+}
+
+struct lpm *lpm4_create(u32 num_grps)
+{
+	return lpm_create(LPM4_TBL0_BITS, 32, num_grps);
+}
+
+struct lpm *lpm6_create(u32 num_grps)
+{
+	return lpm_create(LPM6_TBL0_BITS, LPM6_ADDR_LEN * 8, num_grps);
+}
+
+void lpm_free(struct lpm *lpm)
+{
+	if (!lpm)
+		return;
+	if (lpm->tbl0)
+		free(lpm->tbl0);
+	if (lpm->tbl8)
+		free(lpm->tbl8);
+	free(lpm);
+}
+
+u64 lpm_mem_size(struct lpm *lpm)
+{
+	return ((u64)(1 << lpm->tbl0_bits) + (u64)lpm->used_grps * LPM_GRP_ENTS) * sizeof(u32);
+}
+
+/* Bits [start, start + len) of a network byte order key, len <= 24 */
+static u32 lpm_key_bits(const u8 *key, u32 start, u32 len)
+{
+	u32 val = 0, i;
+
+	for (i = start / 8; i < (start + len + 7) / 8; i++)
+		val = (val << 8) | key[i];
+	return (val >> ((8 - (start + len) % 8) % 8)) & ((1 << len) - 1);
+}
+
+/* Set a prefix on an entry it covers. An entry that was set by a longer
+ * prefix is kept; a group below the entry gets the prefix on all its entries.
+ */
+static void lpm_ent_set(struct lpm *lpm, u32 *ent, u8 depth, u32 nh)
+{
+	u32 *grp;
+	int i;
+
+	if (*ent & LPM_ENT_EXT) {
+		grp = &lpm->tbl8[(*ent & LPM_ENT_VAL_MASK) * LPM_GRP_ENTS];
+		for (i = 0; i < LPM_GRP_ENTS; i++)
+			lpm_ent_set(lpm, &grp[i], depth, nh);
+		return;
+	}
+	if (!(*ent & LPM_ENT_VALID) || lpm_ent_depth(*ent) <= depth)
+		*ent = lpm_ent_build(depth, nh);
+}
+
+static int lpm_level_add(struct lpm *lpm, u32 *grp, u32 start, u32 len, const u8 *key, u8 depth, u32 nh)
+{
+	u32 idx, end = start + len, num, i;
+	u32 *ent, *new_grp;
+
+	idx = lpm_key_bits(key, start, len);
+	if (depth <= end) {
+		/* The prefix ends in this level and covers a range of its entries */
+		num = 1 << (end - depth);
+		idx &= ~(num - 1);
+		for (i = 0; i < num; i++)
+			lpm_ent_set(lpm, &grp[idx + i], depth, nh);
+		return 0;
+	}
+
+	ent = &grp[idx];
+	if (!(*ent & LPM_ENT_EXT)) {
+		if (lpm->used_grps == lpm->num_grps) {
+			pr_err("no free LPM group (%u in use)!\n", lpm->used_grps);
+			return -ENOSPC;
+		}
+		/* The new group inherits the shorter prefix that covered the entry */
+		new_grp = &lpm->tbl8[lpm->used_grps * LPM_GRP_ENTS];
+		for (i = 0; i < LPM_GRP_ENTS; i++)
+			new_grp[i] = *ent;
+		*ent = LPM_ENT_VALID | LPM_ENT_EXT | lpm->used_grps++;
+	}
+
+	return lpm_level_add(lpm, &lpm->tbl8[(*ent & LPM_ENT_VAL_MASK) * LPM_GRP_ENTS],
+			     end, 8, key, depth, nh);
+}
+
+/* Add a route. The key is in network byte order; the bits beyond depth are
+ * ignored. A route added again with the same prefix replaces the previous one.
+ */
+int lpm_add(struct lpm *lpm, const u8 *key, u8 depth, u32 nh)
+{
+	u8 pfx[LPM6_ADDR_LEN];
+	u32 i;
+	int err;
+
+	if (!lpm || !key || depth > lpm->key_bits || nh > LPM_NH_MAX) {
+		pr_err("invalid LPM route (depth %u, nh %u)!\n", depth, nh);
+		return -EINVAL;
+	}
+
+	memset(pfx, 0, sizeof(pfx));
+	for (i = 0; i < lpm->key_bits / 8; i++) {
+		if (depth >= (i + 1) * 8)
+			pfx[i] = key[i];
+		else if (depth > i * 8)
+			pfx[i] = key[i] & (0xff << (8 - (depth - i * 8)));
+	}
+
+	/* A zero depth route, the default route, covers all of level 0 */
+	err = lpm_level_add(lpm, lpm->tbl0, 0, lpm->tbl0_bits, pfx, depth, nh);
+	if (!err)
+		lpm->num_rules++;
+	return err;
+}
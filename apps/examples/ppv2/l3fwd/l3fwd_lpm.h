@@ -0,0 +1,176 @@
+/******************************************************************************
+ *	Copyright (C) 2016 Marvell International Ltd.
+ *
+ *  If you received this File from Marvell, you may opt to use, redistribute
+ *  and/or modify this File under the following licensing terms.
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *	* Redistributions of source code must retain the above copyright
+ *	  notice, this list of conditions and the following disclaimer.
+ *
+ *	* Redistributions in binary form must reproduce the above copyright
+ *	  notice, this list of conditions and the following disclaimer in the
+ *	  documentation and/or other materials provided with the distribution.
+ *
+ *	* Neither the name of Marvell nor the names of its contributors may be
+ *	  used to endorse or promote products derived from this software
+ *	  without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#ifndef __L3FWD_LPM_H__
+#define __L3FWD_LPM_H__
+
+#include "mv_std.h"
+
+/* Longest prefix match tables of the l3fwd application.
+ *
+ * Both tables are multibit tries with a wide first level and 8-bit strides
+ * below it. IPv4 uses a 24-bit first level (DIR-24-8), so that most lookups
+ * take a single memory access and the rest take exactly two. IPv6 uses a
+ * 16-bit first level followed by up to fourteen 8-bit levels.
+ *
+ * Every entry is a u32 that holds either a next hop (with the depth of the
+ * prefix that set it) or the index of an 8-bit group of the next level.
+ */
+#define LPM_ENT_VALID		BIT(31)
+#define LPM_ENT_EXT		BIT(30)
+#define LPM_ENT_DEPTH_SHIFT	22
+#define LPM_ENT_DEPTH_MASK	(0xff << LPM_ENT_DEPTH_SHIFT)
+#define LPM_ENT_VAL_MASK	((1 << LPM_ENT_DEPTH_SHIFT) - 1)
+
+#define LPM_GRP_ENTS		256
+#define LPM_NH_MAX		LPM_ENT_VAL_MASK	/* max next hop value */
+#define LPM_NH_NONE		0xffffffff		/* lookup miss */
+
+#define LPM4_TBL0_BITS		24
+#define LPM6_TBL0_BITS		16
+#define LPM6_ADDR_LEN		16
+
+struct lpm {
+	u32	*tbl0;		/* first level, 1 << tbl0_bits entries */
+	u32	*tbl8;		/* 8-bit groups of the next levels */
+	u32	 tbl0_bits;
+	u32	 key_bits;	/* 32 for IPv4, 128 for IPv6 */
+	u32	 num_grps;	/* groups allocated in tbl8 */
+	u32	 used_grps;
+	u32	 num_rules;
+};
+
+struct lpm *lpm4_create(u32 num_grps);
+struct lpm *lpm6_create(u32 num_grps);
+void lpm_free(struct lpm *lpm);
+int lpm_add(struct lpm *lpm, const u8 *key, u8 depth, u32 nh);
+u64 lpm_mem_size(struct lpm *lpm);
+
+static inline int lpm4_add(struct lpm *lpm, u32 ip, u8 depth, u32 nh)
+{
+	u8 key[4];
+
+	key[0] = ip >> 24;
+	key[1] = ip >> 16;
+	key[2] = ip >> 8;
+	key[3] = ip;
+	return lpm_add(lpm, key, depth, nh);
+}
+
+static inline u32 lpm_ent_nh(u32 ent)
+{
+	return (ent & LPM_ENT_VALID) ? (ent & LPM_ENT_VAL_MASK) : LPM_NH_NONE;
+}
+
+/* Lookup of an IPv4 address, in host byte order */
+static inline u32 lpm4_lookup(struct lpm *lpm, u32 ip)
+{
+	u32 ent = lpm->tbl0[ip >> 8];
+
+	if (unlikely(ent & LPM_ENT_EXT))
+		ent = lpm->tbl8[(ent & LPM_ENT_VAL_MASK) * LPM_GRP_ENTS + (ip & 0xff)];
+	return lpm_ent_nh(ent);
+}
+
+/* Batch lookup of IPv4 addresses, in host byte order.
+ * All first level entries are prefetched before any of them is used, so that
+ * the cache misses of a burst overlap instead of being paid one by one.
+ */
+static inline void lpm4_lookup_bulk(struct lpm *lpm, const u32 *ips, u32 *nhs, int num)
+{
+	u32 ent;
+	int i;
+
+	for (i = 0; i < num; i++)
+		__builtin_prefetch(&lpm->tbl0[ips[i] >> 8]);
+
+	for (i = 0; i < num; i++) {
+		nhs[i] = lpm->tbl0[ips[i] >> 8];
+		if (unlikely(nhs[i] & LPM_ENT_EXT))
+			__builtin_prefetch(&lpm->tbl8[(nhs[i] & LPM_ENT_VAL_MASK) * LPM_GRP_ENTS + (ips[i] & 0xff)]);
+	}
+
+	for (i = 0; i < num; i++) {
+		ent = nhs[i];
+		if (unlikely(ent & LPM_ENT_EXT))
+			ent = lpm->tbl8[(ent & LPM_ENT_VAL_MASK) * LPM_GRP_ENTS + (ips[i] & 0xff)];
+		nhs[i] = lpm_ent_nh(ent);
+	}
+}
+
+/* Lookup of an IPv6 address, in network byte order */
+static inline u32 lpm6_lookup(struct lpm *lpm, const u8 *ip)
+{
+	u32 ent = lpm->tbl0[(ip[0] << 8) | ip[1]];
+	int i = LPM6_TBL0_BITS / 8;
+
+	while (ent & LPM_ENT_EXT)
+		ent = lpm->tbl8[(ent & LPM_ENT_VAL_MASK) * LPM_GRP_ENTS + ip[i++]];
+	return lpm_ent_nh(ent);
+}
+
+/* Batch lookup of IPv6 addresses, in network byte order.
+ * The burst walks the trie one level at a time, prefetching the entries of
+ * the next level for all addresses before reading any of them.
+ */
+static inline void lpm6_lookup_bulk(struct lpm *lpm, const u8 * const *ips, u32 *nhs, int num)
+{
+	u32 ent;
+	int i, lvl, ext;
+
+	for (i = 0; i < num; i++)
+		__builtin_prefetch(&lpm->tbl0[(ips[i][0] << 8) | ips[i][1]]);
+	for (i = 0, ext = 0; i < num; i++) {
+		nhs[i] = lpm->tbl0[(ips[i][0] << 8) | ips[i][1]];
+		ext |= nhs[i] & LPM_ENT_EXT;
+	}
+
+	for (lvl = LPM6_TBL0_BITS / 8; ext && lvl < LPM6_ADDR_LEN; lvl++) {
+		for (i = 0; i < num; i++)
+			if (nhs[i] & LPM_ENT_EXT)
+				__builtin_prefetch(&lpm->tbl8[(nhs[i] & LPM_ENT_VAL_MASK) * LPM_GRP_ENTS +
+							      ips[i][lvl]]);
+		for (i = 0, ext = 0; i < num; i++) {
+			ent = nhs[i];
+			if (ent & LPM_ENT_EXT) {
+				ent = lpm->tbl8[(ent & LPM_ENT_VAL_MASK) * LPM_GRP_ENTS + ips[i][lvl]];
+				nhs[i] = ent;
+				ext |= ent & LPM_ENT_EXT;
+			}
+		}
+	}
+
+	for (i = 0; i < num; i++)
+		nhs[i] = lpm_ent_nh(nhs[i]);
+}
+
+#endif /* __L3FWD_LPM_H__ */
@@ -196,6 +196,8 @@ struct glob_arg {
 	u16			 burst;
 	u16			 mtu;
 	u16			 rxq_size;
+	u16			 rsrv_chunk;
+	u16			 rsrv_chunk_max;
 	u32			 busy_wait;
 	int			 multi_buffer_release;
 	int			 affinity;
@@ -469,11 +471,12 @@ static inline int loop_hw_recycle(struct local_arg	*larg,
 				  u16			 num)
 {
 	struct pp2_ppio_desc	 descs[MAX_BURST_SIZE];
-	u16			 i, tx_num;
+	u16			 tx_num;
 #ifdef APP_TX_RETRY
 	u16			 desc_idx = 0, cnt = 0;
 #endif
 #ifdef PKT_ECHO_SUPPORT
+	u16			 i;
 	int			 prefetch_shift = larg->prefetch_shift;
 #endif /* PKT_ECHO_SUPPORT */
 
@@ -485,14 +488,10 @@ static inline int loop_hw_recycle(struct local_arg	*larg,
 //if (num) pr_info("got %d pkts on thd %d, tc %d, qid %d\n", num, larg->id, tc, qid);
 	INC_RX_COUNT(larg->id, rx_ppio_id, num);
 
-	for (i=0; i<num; i++) {
-		char		*buff = (char *)(uintptr_t)pp2_ppio_inq_desc_get_cookie(&descs[i]);
-		dma_addr_t	 pa = pp2_ppio_inq_desc_get_phys_addr(&descs[i]);
-		u16 len = pp2_ppio_inq_desc_get_pkt_len(&descs[i]);
-		struct pp2_bpool *bpool = pp2_ppio_inq_desc_get_bpool(&descs[i], larg->ports_desc[rx_ppio_id].port);
-
 #ifdef PKT_ECHO_SUPPORT
-		if (likely(larg->echo)) {
+	if (likely(larg->echo)) {
+		for (i = 0; i < num; i++) {
+			char *buff = (char *)(uintptr_t)pp2_ppio_inq_desc_get_cookie(&descs[i]);
 			char *tmp_buff;
 #ifdef USE_APP_PREFETCH
 			if (num-i > prefetch_shift) {
@@ -512,43 +511,42 @@ static inline int loop_hw_recycle(struct local_arg	*larg,
 			swap_l3(tmp_buff);
 			//printf("packet:\n"); mem_disp(tmp_buff, len);
 		}
-#endif /* PKT_ECHO_SUPPORT */
-
-		pp2_ppio_outq_desc_reset(&descs[i]);
-		pp2_ppio_outq_desc_set_phys_addr(&descs[i], pa);
-		pp2_ppio_outq_desc_set_pkt_offset(&descs[i], PKT_EFEC_OFFS);
-		pp2_ppio_outq_desc_set_pkt_len(&descs[i], len);
-		pp2_ppio_outq_desc_set_cookie(&descs[i], (uintptr_t)(buff));
-		pp2_ppio_outq_desc_set_pool(&descs[i], bpool);
 	}
+#endif /* PKT_ECHO_SUPPORT */
 
 	SET_MAX_BURST(larg->id, rx_ppio_id, num);
+	if (!num)
+		return 0;
+
+	/* The swaps above keep the frame length and checksums, so the RX descriptors
+	 * are converted and sent as is; HW releases the buffers to their pools.
+	 */
+	tx_num = num;
+	pp2_ppio_forward(larg->ports_desc[tx_ppio_id].port, larg->hif, tc, descs, &tx_num,
+			 PKT_EFEC_OFFS, PP2_PPIO_FWD_F_HW_RELEASE);
 #ifdef APP_TX_RETRY
+	desc_idx = tx_num;
+	num -= tx_num;
+	INC_TX_COUNT(larg->id, rx_ppio_id, tx_num);
 	while (num) {
+		if (!cnt)
+			INC_TX_RETRY_COUNT(larg->id, rx_ppio_id, num);
+		cnt++;
+		usleep(TX_RETRY_WAIT);
+
 		tx_num = num;
 		pp2_ppio_send(larg->ports_desc[tx_ppio_id].port, larg->hif, tc, &descs[desc_idx], &tx_num);
-
-		if (num > tx_num) {
-			if (!cnt)
-				INC_TX_RETRY_COUNT(larg->id, rx_ppio_id, num - tx_num);
-			cnt++;
-			usleep(TX_RETRY_WAIT);
-		}
 		desc_idx += tx_num;
 		num -= tx_num;
 		INC_TX_COUNT(larg->id, rx_ppio_id, tx_num);
 	}
 	SET_MAX_RESENT(larg->id, rx_ppio_id, cnt);
 #else
-	if (num) {
-		tx_num = num;
-		pp2_ppio_send(larg->ports_desc[tx_ppio_id].port, larg->hif, tc, descs, &tx_num);
-		if (num > tx_num) {
-			free_buffers(larg, &descs[tx_num], num - tx_num, rx_ppio_id);
-			INC_TX_DROP_COUNT(larg->id, rx_ppio_id, num - tx_num);
-		}
-		INC_TX_COUNT(larg->id, rx_ppio_id, tx_num);
+	if (num > tx_num) {
+		free_buffers(larg, &descs[tx_num], num - tx_num, rx_ppio_id);
+		INC_TX_DROP_COUNT(larg->id, rx_ppio_id, num - tx_num);
 	}
+	INC_TX_COUNT(larg->id, rx_ppio_id, tx_num);
 #endif /* APP_TX_RETRY */
 	return 0;
 }
@@ -1189,6 +1187,8 @@ static int init_local_modules(struct glob_arg *garg)
 		for (i=0; i<port_params.outqs_params.num_outqs; i++) {
 			port_params.outqs_params.outqs_params[i].size = TXQ_SIZE;
 			port_params.outqs_params.outqs_params[i].weight = 1;
+			port_params.outqs_params.outqs_params[i].rsrv_chunk = garg->rsrv_chunk;
+			port_params.outqs_params.outqs_params[i].rsrv_chunk_max = garg->rsrv_chunk_max;
 		}
 		port_params.maintain_stats = garg->maintain_stats;
 		if ((err = pp2_ppio_init(&port_params, &garg->ports_desc[port_index].port)) != 0)
@@ -1373,6 +1373,8 @@ static int queue_stat_cmd_cb(void *arg, int argc, char *argv[])
 			printf("\t\tDequeued packets:      %lu\n", txstats.deq_desc);
 			printf("\t\tEnque desc to DDR:     %lu\n", txstats.enq_dec_to_ddr);
 			printf("\t\tEnque buffers to DDR:  %lu\n", txstats.enq_buf_to_ddr);
+			printf("\t\tDesc reservations:     %lu\n", txstats.rsrv_req);
+			printf("\t\tPartial reservations:  %lu\n", txstats.rsrv_partial);
 		}
 	}
 
@@ -1431,6 +1433,71 @@ static int port_stat_cmd_cb(void *arg, int argc, char *argv[])
 	return 0;
 }
 
+static int mac_stat_cmd_cb(void *arg, int argc, char *argv[])
+{
+	int i, reset = 0, cur_port;
+	int first_port, port_num;
+	struct glob_arg *garg = (struct glob_arg *)arg;
+	struct pp2_ppio_mac_statistics stats;
+	struct pp2_ppio_mac_rates rates;
+
+	/* If no parameters specified, show all ports */
+	first_port = 0;
+	port_num = garg->num_ports;
+
+	if (argc > 1) {
+		first_port = atoi(argv[1]);
+		port_num = 1;
+
+		if (argc > 2) {
+			reset = atoi(argv[2]);
+			if (reset) {
+				reset = 1;
+				printf("Statistics will be reset\n");
+			}
+		}
+
+		if (first_port >= garg->num_ports) {
+			pr_warn("Invalid port number (%d). Should be in range [%d-%d].\n",
+				first_port, 0, garg->num_ports - 1);
+			first_port = 0;
+			port_num = garg->num_ports;
+		}
+	}
+
+	for (i = 0, cur_port = first_port; i < port_num; i++, cur_port++) {
+		printf("\n-------- Port #%d MAC stats --------\n", cur_port);
+		if (pp2_ppio_get_mac_statistics(garg->ports_desc[cur_port].port, &stats, &rates, 0, reset))
+			continue;
+		printf("\t Rx statistics:\n");
+		printf("\t\tGood octets:             %lu\n", stats.rx_good_octets);
+		printf("\t\tBad octets:              %lu\n", stats.rx_bad_octets);
+		printf("\t\tUnicast frames:          %lu\n", stats.rx_unicast);
+		printf("\t\tBroadcast frames:        %lu\n", stats.rx_broadcast);
+		printf("\t\tMulticast frames:        %lu\n", stats.rx_multicast);
+		printf("\t\tPause frames:            %lu\n", stats.rx_fc);
+		printf("\t\tFIFO overrun:            %lu\n", stats.rx_fifo_overrun);
+		printf("\t\tUndersize:               %lu\n", stats.rx_undersize);
+		printf("\t\tFragments:               %lu\n", stats.rx_fragments);
+		printf("\t\tOversize:                %lu\n", stats.rx_oversize);
+		printf("\t\tJabber:                  %lu\n", stats.rx_jabber);
+		printf("\t\tMAC errors:              %lu\n", stats.rx_mac_errors);
+		printf("\t\tCRC errors:              %lu\n", stats.rx_crc_errors);
+		printf("\t Tx statistics:\n");
+		printf("\t\tGood octets:             %lu\n", stats.tx_good_octets);
+		printf("\t\tUnicast frames:          %lu\n", stats.tx_unicast);
+		printf("\t\tBroadcast frames:        %lu\n", stats.tx_broadcast);
+		printf("\t\tMulticast frames:        %lu\n", stats.tx_multicast);
+		printf("\t\tPause frames:            %lu\n", stats.tx_fc);
+		printf("\t\tCRC errors:              %lu\n", stats.tx_crc_errors);
+		printf("\t Rates (since previous call, %u ms):\n", rates.period_ms);
+		printf("\t\tRx frames/s, bits/s:     %lu, %lu\n", rates.rx_frames, rates.rx_bits);
+		printf("\t\tRx errors/s:             %lu\n", rates.rx_errors);
+		printf("\t\tTx frames/s, bits/s:     %lu, %lu\n", rates.tx_frames, rates.tx_bits);
+	}
+
+	return 0;
+}
 
 static int register_cli_cmds(struct glob_arg *garg)
 {
@@ -1467,6 +1534,13 @@ static int register_cli_cmds(struct glob_arg *garg)
 	cmd_params.cmd_arg	= garg;
 	cmd_params.do_cmd_cb	= (int (*)(void *, int, char *[]))port_stat_cmd_cb;
 	mvapp_register_cli_cmd(&cmd_params);
+	memset(&cmd_params, 0, sizeof(cmd_params));
+	cmd_params.name		= "mstat";
+	cmd_params.desc		= "Show MAC statistics and rates";
+	cmd_params.format	= "<port> <reset>";
+	cmd_params.cmd_arg	= garg;
+	cmd_params.do_cmd_cb	= (int (*)(void *, int, char *[]))mac_stat_cmd_cb;
+	mvapp_register_cli_cmd(&cmd_params);
 
 
 	return 0;
@@ -1589,11 +1663,14 @@ static int init_local(void *arg, int id, void **_larg)
 static void deinit_local(void *arg)
 {
 	struct local_arg *larg = (struct local_arg *)arg;
+#ifndef HW_BUFF_RECYLCE
 	int i;
+#endif
 
 	if (!larg)
 		return;
 
+#ifndef HW_BUFF_RECYLCE
 	/* Release shadow queue */
 	for (i = 0; i < MAX_NUM_QS_PER_CORE; i++) {
 		struct tx_shadow_q *shadow_q = &larg->shadow_qs[i];
@@ -1605,6 +1682,7 @@ static void deinit_local(void *arg)
 		shadow_q->read_ind = 0;
 		shadow_q->write_ind = 0;
 	}
+#endif /* !HW_BUFF_RECYLCE */
 
 	if (larg->hif)
 		pp2_hif_deinit(larg->hif);
@@ -1634,6 +1712,8 @@ static void usage(char *progname)
 	       "\t-s                       Maintain statistics\n"
 	       "\t-w <cycles>              Cycles to busy_wait between recv&send, simulating app behavior (default=0)\n"
 	       "\t--rxq <size>             Size of rx_queue (default is %d)\n"
+	       "\t--rsrv-chunk <min>[:<max>] TX descriptors reserved at once; grows up to <max> with the\n"
+	       "                         burst sizes (default is 64, no growth)\n"
 	       "\t--old-tx-desc-release    Use pp2_bpool_put_buff(), instead of NEW pp2_bpool_put_buffs() API\n"
 	       "\t--no-echo                Don't perform 'pkt_echo', N/A w/o define PKT_ECHO_SUPPORT\n"
 	       "\t--cli                    Use CLI\n"
@@ -1659,6 +1739,8 @@ static int parse_args(struct glob_arg *garg, int argc, char *argv[])
 	garg->qs_map_shift = 0;
 	garg->prefetch_shift = PREFETCH_SHIFT;
 	garg->maintain_stats = 0;
+	garg->rsrv_chunk = 0;
+	garg->rsrv_chunk_max = 0;
 
 	while (i < argc) {
 		if ((strcmp(argv[i], "?") == 0) ||
@@ -1740,6 +1822,13 @@ static int parse_args(struct glob_arg *garg, int argc, char *argv[])
 		} else if (strcmp(argv[i], "--rxq") == 0) {
 			garg->rxq_size = atoi(argv[i+1]);
 			i += 2;
+		} else if (strcmp(argv[i], "--rsrv-chunk") == 0) {
+			char *max;
+
+			garg->rsrv_chunk = atoi(argv[i+1]);
+			max = strchr(argv[i+1], ':');
+			garg->rsrv_chunk_max = max ? atoi(max + 1) : 0;
+			i += 2;
 		} else if (strcmp(argv[i], "--old-tx-desc-release") == 0) {
 			garg->multi_buffer_release = 0;
 			i += 1;
@@ -0,0 +1,1653 @@
+/******************************************************************************
+ *	Copyright (C) 2016 Marvell International Ltd.
+ *
+ *  If you received this File from Marvell, you may opt to use, redistribute
+ *  and/or modify this File under the following licensing terms.
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *	* Redistributions of source code must retain the above copyright
+ *	  notice, this list of conditions and the following disclaimer.
+ *
+ *	* Redistributions in binary form must reproduce the above copyright
+ *	  notice, this list of conditions and the following disclaimer in the
+ *	  documentation and/or other materials provided with the distribution.
+ *
+ *	* Neither the name of Marvell nor the names of its contributors may be
+ *	  used to endorse or promote products derived from this software
+ *	  without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#define _GNU_SOURCE         /* See feature_test_macros(7) */
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <sys/time.h>
+#include <arpa/inet.h>
+
+#include "mv_std.h"
+#include "lib/lib_misc.h"
+#include "env/mv_sys_dma.h"
+
+#include "mvapp.h"
+#include "mv_pp2.h"
+#include "mv_pp2_hif.h"
+#include "mv_pp2_bpool.h"
+#include "mv_pp2_ppio.h"
+
+#define Q_SIZE		1024
+#define TXQ_SIZE	(2 * Q_SIZE)
+#define HIFQ_SIZE	(8 * Q_SIZE)
+#define RXQ_SIZE	(2 * Q_SIZE)
+#define MAX_BURST_SIZE	(Q_SIZE >> 1)
+#define DFLT_BURST_SIZE	64
+#define PKT_OFFS	64
+#define PKT_EFEC_OFFS	(PKT_OFFS + PP2_MH_SIZE)
+#define MAX_NUM_CORES	4
+#define DMA_MEM_SIZE	(48 * 1024 * 1024)
+#define PP2_NUM_BPOOLS_RSRV		3
+#define PP2_BPOOLS_RSRV			((1 << PP2_NUM_BPOOLS_RSRV) - 1)
+#define PP2_HIFS_RSRV			0xF
+#define PP2_MAX_NUM_PORTS		4
+#define PP2_MAX_NUM_TCS_PER_PORT	1
+#define PP2_MAX_NUM_QS_PER_TC		MAX_NUM_CORES
+
+#define DEFAULT_MTU			1500
+#define VLAN_HLEN			4
+#define ETH_HLEN			14
+#define ETH_FCS_LEN			4
+
+#define MVPP2_MTU_TO_MRU(mtu) \
+	((mtu) + PP2_MH_SIZE + VLAN_HLEN + \
+	ETH_HLEN + ETH_FCS_LEN)
+
+/* TODO: find more generic way to get the following parameters */
+#define PP2_TOTAL_NUM_BPOOLS	16
+#define PP2_TOTAL_NUM_HIFS	9
+/* "pool-%d:%d", "ppio-%d:%d" and "hif-%d" match strings, for any int value */
+#define MATCH_NAME_SIZE		32
+#define PP2_MAX_NUM_BPOOLS	min(PP2_PPIO_TC_MAX_POOLS*PP2_PPIO_MAX_NUM_TCS, \
+				PP2_TOTAL_NUM_BPOOLS - PP2_NUM_BPOOLS_RSRV)
+
+#define upper_32_bits(n) ((u32)(((n) >> 16) >> 16))
+#define lower_32_bits(n) ((u32)(n))
+
+/** Get rid of path in filename - only for unix-type paths using '/' */
+#define NO_PATH(file_name) (strrchr((file_name), '/') ? \
+			    strrchr((file_name), '/') + 1 : (file_name))
+
+/* The TX rings of all cores are taken from the pools, on top of the RX buffers */
+#define BPOOLS_INF		{ {384, 4096 + MAX_NUM_CORES * PKT_GEN_TX_RING}, {2048, 1024} }
+#define BPOOLS_JUMBO_INF	{ {2048, 4096 + MAX_NUM_CORES * PKT_GEN_TX_RING}, {10240, 512} }
+
+#define CTRL_DFLT_THR		1000	/* m-secs between rate reports */
+
+/* Generated packets: Ethernet, IPv4, UDP, stamp */
+#define PKT_GEN_TX_RING		TXQ_SIZE	/* TX buffers per core */
+#define PKT_GEN_DFLT_SIZE	64		/* frame size, including the FCS */
+#define PKT_GEN_MIN_SIZE	64
+#define PKT_GEN_DFLT_FLOWS	64
+#define PKT_GEN_MAX_FLOWS	4096
+#define PKT_GEN_SRC_PORT	1024		/* + flow */
+#define PKT_GEN_DST_PORT	5000		/* + stream */
+#define PKT_GEN_DFLT_SIP	0x0a000001	/* 10.0.0.1, + flow */
+#define PKT_GEN_DFLT_DIP	0x0a010001	/* 10.1.0.1 */
+#define PKT_GEN_TTL		64
+#define PKT_GEN_MAGIC		0x5047		/* "PG" */
+#define PKT_GEN_L3_OFFS		ETH_HLEN
+#define PKT_GEN_L4_OFFS		(PKT_GEN_L3_OFFS + 20)
+#define PKT_GEN_STAMP_OFFS	(PKT_GEN_L4_OFFS + 8)
+#define PKT_GEN_WIRE_OVERHEAD	20		/* preamble, SFD and inter frame gap */
+#define PKT_GEN_LAT_BUCKETS	32		/* log2 ns latency histogram */
+
+/* Software loopback */
+#define SW_LB_DFLT_PKTS		(16 * 1024 * 1024)
+#define SW_LB_RING		1024
+#define SW_LB_BUF_SIZE		10240
+
+/* Written after the UDP header of every generated packet. A stream is the
+ * packets of one generating core; 'seq' counts per flow of the stream.
+ */
+struct pkt_gen_stamp {
+	u16	magic;
+	u16	stream;
+	u32	seq;
+	u64	tsc;
+} __attribute__((packed));
+
+struct port_desc {
+	char		 name[15];
+	int		 pp_id;
+	int		 ppio_id;
+	struct pp2_ppio	*port;
+	eth_addr_t	 mac;
+};
+
+struct bpool_inf {
+	int	buff_size;
+	int	num_buffs;
+};
+
+struct pkt_gen_stats {
+	u64	tx;
+	u64	tx_full;	/* bursts cut short by the TX queue or the TX ring */
+	u64	rx;
+	u64	rx_other;	/* not a generated packet */
+	u64	lost;		/* sequence gaps, less the late arrivals */
+	u64	reordered;	/* arrived after a later packet of their flow */
+	u64	lat_min;	/* ns */
+	u64	lat_max;
+	u64	lat_sum;
+	u64	lat_cnt;
+	u64	lat_hist[PKT_GEN_LAT_BUCKETS];
+} __attribute__((aligned(64)));
+
+/* A TX buffer, holding a packet template of its core's stream */
+struct tx_ring_ent {
+	char			*pkt;
+	struct pp2_buff_inf	 binf;
+};
+
+/* Expected next sequence of every flow of every stream */
+struct rx_flows {
+	u32	exp_seq[MAX_NUM_CORES][PKT_GEN_MAX_FLOWS];
+};
+
+struct glob_arg {
+	int			 cli;
+	int			 cpus;	/* cpus used for running */
+	u16			 burst;
+	u16			 mtu;
+	u16			 rxq_size;
+	int			 affinity;
+	int			 num_ports;
+	int			 pp2_num_inst;
+	struct port_desc	 ports_desc[PP2_MAX_NUM_PORTS];
+	int			 tx_port;	/* index in the ports list, -1: RX only */
+	int			 rx_port;	/* index in the ports list, -1: TX only */
+
+	/* Traffic */
+	u32			 size;		/* frame size, including the FCS */
+	u32			 flows;		/* per stream, a power of 2 */
+	double			 pps;		/* all cores, 0: as fast as possible */
+	u64			 count;		/* packets per core, 0: no limit */
+	eth_addr_t		 dmac;
+	int			 dmac_set;
+	u32			 sip;
+	u32			 dip;
+
+	/* Software loopback */
+	int			 sw_lb;
+	u64			 sw_lb_pkts;
+	u32			 sw_lb_drop;	/* ppm */
+	u32			 sw_lb_reorder;	/* ppm */
+
+	u64			 tsc_hz;
+	u64			 ns_mult;	/* ns = (ticks * ns_mult) >> 24 */
+	int			 ctrl_thresh;
+	struct timeval		 ctrl_trd_last_time;
+	u64			 lst_tx_cnt;
+	u64			 lst_rx_cnt;
+
+	pthread_mutex_t		 trd_lock;
+
+	struct pp2_hif		*hif;
+
+	int			 num_pools;
+	int			 pool_buff_size[PP2_TOTAL_NUM_BPOOLS];
+	struct pp2_bpool	***pools;
+	struct pp2_buff_inf	***buffs_inf;
+	int			 num_buffs[PP2_NUM_PKT_PROC][PP2_TOTAL_NUM_BPOOLS];
+};
+
+struct local_arg {
+	struct pp2_hif		*hif;
+	struct pp2_ppio		*tx_port;
+	struct pp2_ppio		*rx_port;
+	struct pp2_bpool	*tx_pool;
+
+	/* TX ring: buffers from 'tx_done' to 'tx_next' are in the TX queue */
+	struct tx_ring_ent	*tx_ring;
+	u32			 tx_ring_size;
+	u32			 tx_next;
+	u32			 tx_free;
+	u64			 tx_cnt;	/* packets generated, flow and sequence source */
+	u64			 tx_start;	/* TSC of the first TX */
+	double			 pkts_per_tick;
+
+	struct rx_flows		*rx_flows;
+	struct pkt_gen_stats	*stats;
+
+	u16			 burst;
+	u16			 pkt_len;	/* without the FCS */
+	u8			 qid;
+	int			 id;
+
+	struct glob_arg		*garg;
+};
+
+
+static struct glob_arg garg = {};
+static u64 sys_dma_high_addr = 0;
+
+static u16	used_bpools[PP2_NUM_PKT_PROC] = {PP2_BPOOLS_RSRV, PP2_BPOOLS_RSRV};
+static u16	used_hifs = PP2_HIFS_RSRV;
+
+static struct pkt_gen_stats pkt_gen_stats[MAX_NUM_CORES];
+
+
+/* Free running counter used for pacing and latency: the ARMv8 generic timer,
+ * readable from user space, or the monotonic clock elsewhere.
+ */
+static inline u64 pkt_gen_tsc(void)
+{
+#if defined(__aarch64__)
+	u64 tsc;
+
+	asm volatile("mrs %0, cntvct_el0" : "=r" (tsc));
+	return tsc;
+#else
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (u64)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
+}
+
+static u64 pkt_gen_tsc_hz(void)
+{
+#if defined(__aarch64__)
+	u64 hz;
+
+	asm volatile("mrs %0, cntfrq_el0" : "=r" (hz));
+	return hz;
+#else
+	return 1000000000;
+#endif
+}
+
+static inline u64 pkt_gen_ticks_to_ns(struct glob_arg *garg, u64 ticks)
+{
+	return (ticks * garg->ns_mult) >> 24;
+}
+
+/* Build the packet template of a stream: all fields but the flow dependent
+ * source address and port, and the stamp. The IPv4 and UDP checksums are
+ * generated by the HW on TX.
+ */
+static void pkt_gen_build_template(struct glob_arg *garg, char *pkt, u16 len, const u8 *smac, u16 stream)
+{
+	u8 *p = (u8 *)pkt;
+
+	memset(p, 0, len);
+	memcpy(p, garg->dmac, ETH_ADDR_NUM_OCTETS);
+	memcpy(p + ETH_ADDR_NUM_OCTETS, smac, ETH_ADDR_NUM_OCTETS);
+	*(u16 *)(p + 12) = htons(0x0800);
+
+	p += PKT_GEN_L3_OFFS;
+	p[0] = 0x45;
+	*(u16 *)(p + 2) = htons(len - PKT_GEN_L3_OFFS);
+	*(u16 *)(p + 6) = htons(0x4000);	/* don't fragment */
+	p[8] = PKT_GEN_TTL;
+	p[9] = 17;				/* UDP */
+	*(u32 *)(p + 12) = htonl(garg->sip);
+	*(u32 *)(p + 16) = htonl(garg->dip);
+
+	p = (u8 *)pkt + PKT_GEN_L4_OFFS;
+	*(u16 *)(p + 2) = htons(PKT_GEN_DST_PORT + stream);
+	*(u16 *)(p + 4) = htons(len - PKT_GEN_L4_OFFS);
+
+	((struct pkt_gen_stamp *)(pkt + PKT_GEN_STAMP_OFFS))->magic = htons(PKT_GEN_MAGIC);
+	((struct pkt_gen_stamp *)(pkt + PKT_GEN_STAMP_OFFS))->stream = stream;
+}
+
+/* Set the flow and the stamp of the next packet of a stream. Flows take
+ * turns, so the sequence of a flow is the stream count divided by the number
+ * of flows. The varying source address and port spread the flows by RSS.
+ */
+static inline void pkt_gen_stamp(struct glob_arg *garg, char *pkt, u64 cnt, u64 tsc)
+{
+	struct pkt_gen_stamp	*stamp = (struct pkt_gen_stamp *)(pkt + PKT_GEN_STAMP_OFFS);
+	u32			 flow = cnt & (garg->flows - 1);
+
+	*(u32 *)(pkt + PKT_GEN_L3_OFFS + 12) = htonl(garg->sip + flow);
+	*(u16 *)(pkt + PKT_GEN_L4_OFFS) = htons(PKT_GEN_SRC_PORT + flow);
+	stamp->seq = cnt / garg->flows;
+	stamp->tsc = tsc;
+}
+
+/* Account a received packet: sequence per flow, and latency when the
+ * packet was stamped by this host.
+ */
+static inline void pkt_gen_rx_pkt(struct glob_arg *garg, struct rx_flows *flows, struct pkt_gen_stats *stats,
+				  const char *pkt, u16 len, u64 now)
+{
+	const struct pkt_gen_stamp	*stamp = (const struct pkt_gen_stamp *)(pkt + PKT_GEN_STAMP_OFFS);
+	u32				*exp;
+	u32				 flow, ns;
+	s32				 diff;
+
+	if (unlikely(len < PKT_GEN_STAMP_OFFS + sizeof(struct pkt_gen_stamp) ||
+		     *(const u16 *)(pkt + 12) != htons(0x0800) ||
+		     stamp->magic != htons(PKT_GEN_MAGIC) ||
+		     stamp->stream >= MAX_NUM_CORES)) {
+		stats->rx_other++;
+		return;
+	}
+	flow = ntohs(*(const u16 *)(pkt + PKT_GEN_L4_OFFS)) - PKT_GEN_SRC_PORT;
+	if (unlikely(flow >= garg->flows)) {
+		stats->rx_other++;
+		return;
+	}
+
+	stats->rx++;
+	exp = &flows->exp_seq[stamp->stream][flow];
+	diff = (s32)(stamp->seq - *exp);
+	if (likely(!diff)) {
+		(*exp)++;
+	} else if (diff > 0) {
+		stats->lost += diff;
+		*exp = stamp->seq + 1;
+	} else {
+		/* A late packet, counted as lost when its successor came */
+		stats->reordered++;
+		if (stats->lost)
+			stats->lost--;
+	}
+
+	if (garg->tx_port < 0)
+		return;		/* stamped by another host, the clocks differ */
+	ns = pkt_gen_ticks_to_ns(garg, now - stamp->tsc);
+	if (ns < stats->lat_min || !stats->lat_cnt)
+		stats->lat_min = ns;
+	if (ns > stats->lat_max)
+		stats->lat_max = ns;
+	stats->lat_sum += ns;
+	stats->lat_cnt++;
+	stats->lat_hist[ns ? 31 - __builtin_clz(ns) : 0]++;
+}
+
+/* Number of packets the pacing allows now, up to a burst */
+static inline u16 pkt_gen_tx_allowed(struct local_arg *larg, u64 now)
+{
+	u64 allowed;
+
+	if (larg->pkts_per_tick == 0)
+		allowed = larg->burst;
+	else {
+		allowed = (u64)((now - larg->tx_start) * larg->pkts_per_tick);
+		allowed = (allowed > larg->tx_cnt) ? allowed - larg->tx_cnt : 0;
+		if (allowed > larg->burst)
+			allowed = larg->burst;
+	}
+	if (larg->garg->count && larg->tx_cnt + allowed > larg->garg->count)
+		allowed = larg->garg->count - larg->tx_cnt;
+	return allowed;
+}
+
+static inline void pkt_gen_tx(struct local_arg *larg)
+{
+	struct pp2_ppio_desc	 descs[MAX_BURST_SIZE];
+	struct tx_ring_ent	*ent;
+	u64			 now;
+	u16			 i, num, done, idx;
+
+	pp2_ppio_get_num_outq_done(larg->tx_port, larg->hif, 0, &done);
+	larg->tx_free += done;
+
+	now = pkt_gen_tsc();
+	if (unlikely(!larg->tx_start))
+		larg->tx_start = now;
+	num = pkt_gen_tx_allowed(larg, now);
+	if (!num)
+		return;
+	if (unlikely(num > larg->tx_free)) {
+		larg->stats->tx_full++;
+		num = larg->tx_free;
+		if (!num)
+			return;
+	}
+
+	for (i = 0, idx = larg->tx_next; i < num; i++) {
+		ent = &larg->tx_ring[idx];
+		pkt_gen_stamp(larg->garg, ent->pkt, larg->tx_cnt + i, now);
+		pp2_ppio_outq_desc_reset(&descs[i]);
+		pp2_ppio_outq_desc_set_proto_info(&descs[i], PP2_OUTQ_L3_TYPE_IPV4, PP2_OUTQ_L4_TYPE_UDP,
+						  PKT_GEN_L3_OFFS, PKT_GEN_L4_OFFS, 1, 1);
+		pp2_ppio_outq_desc_set_phys_addr(&descs[i], ent->binf.addr);
+		pp2_ppio_outq_desc_set_pkt_offset(&descs[i], PKT_EFEC_OFFS);
+		pp2_ppio_outq_desc_set_pkt_len(&descs[i], larg->pkt_len);
+		if (++idx == larg->tx_ring_size)
+			idx = 0;
+	}
+
+	done = num;
+	pp2_ppio_send(larg->tx_port, larg->hif, 0, descs, &done);
+	if (unlikely(done < num))
+		larg->stats->tx_full++;
+	/* Unsent buffers are stamped again, with the same sequence, next time */
+	larg->tx_next = (larg->tx_next + done) % larg->tx_ring_size;
+	larg->tx_free -= done;
+	larg->tx_cnt += done;
+	larg->stats->tx += done;
+}
+
+static inline void pkt_gen_rx(struct local_arg *larg)
+{
+	struct pp2_ppio_desc		descs[MAX_BURST_SIZE];
+	struct buff_release_entry	rel[MAX_BURST_SIZE];
+	char				*pkts[MAX_BURST_SIZE];
+	u64				 now;
+	u16				 i, num = larg->burst;
+
+	pp2_ppio_recv(larg->rx_port, 0, larg->qid, descs, &num);
+	if (!num)
+		return;
+	now = pkt_gen_tsc();
+
+	for (i = 0; i < num; i++) {
+		pkts[i] = (char *)(((uintptr_t)pp2_ppio_inq_desc_get_cookie(&descs[i])) | sys_dma_high_addr) +
+			  PKT_EFEC_OFFS;
+		__builtin_prefetch(pkts[i] + PKT_GEN_L4_OFFS);
+	}
+
+	for (i = 0; i < num; i++) {
+		pkt_gen_rx_pkt(larg->garg, larg->rx_flows, larg->stats, pkts[i],
+			       pp2_ppio_inq_desc_get_pkt_len(&descs[i]), now);
+		rel[i].buff.cookie = pp2_ppio_inq_desc_get_cookie(&descs[i]);
+		rel[i].buff.addr = pp2_ppio_inq_desc_get_phys_addr(&descs[i]);
+		rel[i].bpool = pp2_ppio_inq_desc_get_bpool(&descs[i], larg->rx_port);
+	}
+	pp2_bpool_put_buffs(larg->hif, rel, &num);
+}
+
+static int main_loop(void *arg, int *running)
+{
+	struct local_arg	*larg = (struct local_arg *)arg;
+
+	if (!larg) {
+		pr_err("no obj!\n");
+		return -EINVAL;
+	}
+
+	while (*running) {
+		if (larg->tx_port)
+			pkt_gen_tx(larg);
+		if (larg->rx_port)
+			pkt_gen_rx(larg);
+	}
+
+	return 0;
+}
+
+static int find_port_info(struct port_desc *port_desc)
+{
+	char		 name[20];
+	u8		 pp, ppio;
+	int		 err;
+
+	if (!port_desc->name[0]) {
+		pr_err("No port name given!\n");
+		return -1;
+	}
+
+	memset(name, 0, sizeof(name));
+	snprintf(name, sizeof(name), "%s", port_desc->name);
+	if ((err = pp2_netdev_get_port_info(name,
+					    &pp,
+					    &ppio)) != 0) {
+		pr_err("PP2 Port %s not found!\n", port_desc->name);
+		return err;
+	}
+
+	port_desc->ppio_id = ppio;
+	port_desc->pp_id = pp;
+
+	return 0;
+}
+
+static int find_free_bpool(u32 pp_id)
+{
+	int	i;
+
+	for (i=0; i<PP2_TOTAL_NUM_BPOOLS; i++) {
+		if (!((1 << i) & used_bpools[pp_id])) {
+			used_bpools[pp_id] |= (1 << i);
+			break;
+		}
+	}
+	if (i == PP2_TOTAL_NUM_BPOOLS) {
+		pr_err("no free BPool found!\n");
+		return -ENOSPC;
+	}
+	return i;
+}
+
+static int find_free_hif(void)
+{
+	int	i;
+
+	for (i=0; i<PP2_TOTAL_NUM_HIFS; i++) {
+		if (!((1 << i) & used_hifs)) {
+			used_hifs |= (1 << i);
+			break;
+		}
+	}
+	if (i == PP2_TOTAL_NUM_HIFS) {
+		pr_err("no free HIF found!\n");
+		return -ENOSPC;
+	}
+	return i;
+}
+
+static int init_all_modules(void)
+{
+	struct pp2_init_params	 pp2_params;
+	int			 err;
+
+	pr_info("Global initializations ... \n");
+
+	if ((err = mv_sys_dma_mem_init(DMA_MEM_SIZE)) != 0)
+		return err;
+
+	memset(&pp2_params, 0, sizeof(pp2_params));
+	pp2_params.hif_reserved_map = PP2_HIFS_RSRV;
+	pp2_params.bm_pool_reserved_map = PP2_BPOOLS_RSRV;
+	/* Enable 10G port */
+	pp2_params.ppios[0][0].is_enabled = 1;
+	pp2_params.ppios[0][0].first_inq = 0;
+	/* Enable 1G ports according to DTS files */
+	if (garg.pp2_num_inst == 1) {
+		pp2_params.ppios[0][2].is_enabled = 1;
+		pp2_params.ppios[0][2].first_inq = 0;
+	}
+	if (garg.pp2_num_inst == 2) {
+		/* Enable 10G port */
+		pp2_params.ppios[1][0].is_enabled = 1;
+		pp2_params.ppios[1][0].first_inq = 0;
+		/* Enable 1G ports */
+		pp2_params.ppios[1][1].is_enabled = 1;
+		pp2_params.ppios[1][1].first_inq = 0;
+	}
+	if ((err = pp2_init(&pp2_params)) != 0)
+		return err;
+
+	pr_info("done\n");
+	return 0;
+}
+
+static void flush_pool(struct glob_arg *garg, struct pp2_bpool *bpool)
+{
+	u32 i, buf_num, err = 0;
+
+	pp2_bpool_get_num_buffs(bpool, &buf_num);
+	for (i = 0; i < buf_num; i++) {
+		struct pp2_buff_inf buff;
+
+		err = 0;
+		while (pp2_bpool_get_buff(garg->hif, bpool, &buff)) {
+			err++;
+			if (err == 10000) {
+				pr_err("flush_pool: p2_id=%d, pool_id=%d: Got NULL buf (%d of %d)\n",
+					bpool->pp2_id, bpool->id, i, buf_num);
+				break;
+			}
+		}
+	}
+	pp2_bpool_deinit(bpool);
+}
+
+static int build_all_bpools(struct glob_arg *garg)
+{
+	struct pp2_bpool_params	 	bpool_params;
+	int			 	i, j, k, err, pool_id;
+	struct bpool_inf		std_infs[] = BPOOLS_INF;
+	struct bpool_inf		jumbo_infs[] = BPOOLS_JUMBO_INF;
+	struct bpool_inf		*infs;
+	char				name[MATCH_NAME_SIZE];
+	int 				pp2_num_inst = garg->pp2_num_inst;
+
+	if (garg->mtu > DEFAULT_MTU) {
+		infs = jumbo_infs;
+		garg->num_pools = ARRAY_SIZE(jumbo_infs);
+	} else {
+		infs = std_infs;
+		garg->num_pools = ARRAY_SIZE(std_infs);
+	}
+
+	garg->pools = (struct pp2_bpool ***)calloc(pp2_num_inst, sizeof(struct pp2_bpool **));
+	if (!garg->pools) {
+		pr_err("no mem for bpools array!\n");
+		return -ENOMEM;
+	}
+	garg->buffs_inf =
+		(struct pp2_buff_inf ***)calloc(pp2_num_inst, sizeof(struct pp2_buff_inf **));
+	if (!garg->buffs_inf) {
+		pr_err("no mem for bpools-inf array!\n");
+		return -ENOMEM;
+	}
+	/* TODO: temporary W/A until we have map routines of bpools to ppios */
+	if (garg->num_pools > PP2_MAX_NUM_BPOOLS) {
+		pr_err("only %d pools allowed!\n", PP2_MAX_NUM_BPOOLS);
+		return -EINVAL;
+	}
+
+	for (i=0; i<pp2_num_inst; i++) {
+		garg->pools[i] = (struct pp2_bpool **)calloc(garg->num_pools, sizeof(struct pp2_bpool *));
+		if (!garg->pools[i]) {
+			pr_err("no mem for bpools array!\n");
+			return -ENOMEM;
+		}
+		garg->buffs_inf[i] =
+			(struct pp2_buff_inf **)calloc(garg->num_pools, sizeof(struct pp2_buff_inf *));
+		if (!garg->buffs_inf[i]) {
+			pr_err("no mem for bpools-inf array!\n");
+			return -ENOMEM;
+		}
+
+		for (j=0; j<garg->num_pools; j++) {
+			pool_id = find_free_bpool(i);
+			if (pool_id < 0) {
+				pr_err("free bpool not found!\n");
+				return pool_id;
+			}
+			memset(name, 0, sizeof(name));
+			snprintf(name, sizeof(name), "pool-%d:%d", i, pool_id);
+			pr_debug("found bpool:  %s\n", name);
+			memset(&bpool_params, 0, sizeof(bpool_params));
+			bpool_params.match = name;
+			bpool_params.buff_len = infs[j].buff_size;
+			garg->pool_buff_size[j] = infs[j].buff_size;
+			if ((err = pp2_bpool_init(&bpool_params, &garg->pools[i][j])) != 0)
+				return err;
+			if (!garg->pools[i][j]) {
+				pr_err("BPool init failed!\n");
+				return -EIO;
+			}
+
+			garg->buffs_inf[i][j] =
+				(struct pp2_buff_inf *)calloc(infs[j].num_buffs, sizeof(struct pp2_buff_inf));
+			if (!garg->buffs_inf[i][j]) {
+				pr_err("no mem for bpools-inf array!\n");
+				return -ENOMEM;
+			}
+			garg->num_buffs[i][j] = infs[j].num_buffs;
+
+			for (k=0; k<infs[j].num_buffs; k++) {
+				void * buff_virt_addr;
+				buff_virt_addr = mv_sys_dma_mem_alloc(infs[j].buff_size, 4);
+				if (!buff_virt_addr) {
+					pr_err("failed to allocate mem (%d)!\n", k);
+					return -1;
+				}
+				if (k == 0) {
+					sys_dma_high_addr = ((u64)buff_virt_addr) & (~((1ULL<<32) - 1));
+					pr_debug("sys_dma_high_addr (0x%lx)\n", sys_dma_high_addr);
+				}
+				if ((upper_32_bits((u64)buff_virt_addr)) != (sys_dma_high_addr >> 32)) {
+					pr_err("buff_virt_addr(%p)  upper out of range; skipping this buff\n", buff_virt_addr);
+					continue;
+				}
+				garg->buffs_inf[i][j][k].addr =
+					(bpool_dma_addr_t)mv_sys_dma_mem_virt2phys(buff_virt_addr);
+				garg->buffs_inf[i][j][k].cookie =
+					lower_32_bits((u64)buff_virt_addr); /* cookie contains lower_32_bits of the va */
+			}
+
+			for (k=0; k<infs[j].num_buffs; k++) {
+				if ((err = pp2_bpool_put_buff(garg->hif,
+							      garg->pools[i][j],
+							      &garg->buffs_inf[i][j][k])) != 0)
+					return err;
+			}
+		}
+	}
+
+	return 0;
+}
+
+static void free_pool_buffers(struct pp2_buff_inf *buffs, int num)
+{
+	int i;
+
+	for (i = 0; i < num; i++) {
+		void *buff_virt_addr = (char *)(((uintptr_t)(buffs[i].cookie)) | sys_dma_high_addr);
+
+		if (buffs[i].addr)
+			mv_sys_dma_mem_free(buff_virt_addr);
+	}
+}
+
+static void free_all_pools(struct glob_arg *garg)
+{
+	int i, j;
+
+	if (garg->pools) {
+		for (i = 0; i < garg->pp2_num_inst; i++) {
+			if (garg->pools[i]) {
+				for (j = 0; j < garg->num_pools; j++)
+					if (garg->pools[i][j])
+						flush_pool(garg, garg->pools[i][j]);
+				free(garg->pools[i]);
+			}
+		}
+		free(garg->pools);
+	}
+
+	if (garg->buffs_inf) {
+		for (i = 0; i < garg->pp2_num_inst; i++) {
+			if (garg->buffs_inf[i]) {
+				for (j = 0; j < garg->num_pools; j++)
+					if (garg->buffs_inf[i][j]) {
+						free_pool_buffers(garg->buffs_inf[i][j], garg->num_buffs[i][j]);
+						free(garg->buffs_inf[i][j]);
+					}
+				free(garg->buffs_inf[i]);
+			}
+		}
+		free(garg->buffs_inf);
+	}
+}
+
+
+static int init_local_modules(struct glob_arg *garg)
+{
+	struct pp2_hif_params	 	hif_params;
+	struct pp2_ppio_params	 	port_params;
+	struct pp2_ppio_inq_params	inq_params;
+	struct port_desc		*port_desc;
+	char				name[MATCH_NAME_SIZE];
+	int			 	i, j, err, port_index, hif_id;
+	u16				mtu;
+
+	pr_info("Local initializations ...\n");
+
+	if ((hif_id = find_free_hif()) < 0) {
+		pr_err("free HIF not found!\n");
+		return hif_id;
+	}
+	memset(name, 0, sizeof(name));
+	snprintf(name, sizeof(name), "hif-%d", hif_id);
+	pr_debug("found hif: %s\n", name);
+	memset(&hif_params, 0, sizeof(hif_params));
+	hif_params.match = name;
+	hif_params.out_size = HIFQ_SIZE;
+	if ((err = pp2_hif_init(&hif_params, &garg->hif)) != 0)
+		return err;
+	if (!garg->hif) {
+		pr_err("HIF init failed!\n");
+		return -EIO;
+	}
+
+	if ((err = build_all_bpools(garg)) != 0)
+		return err;
+
+	for (port_index = 0; port_index < garg->num_ports; port_index++) {
+		port_desc = &garg->ports_desc[port_index];
+		if ((err = find_port_info(port_desc)) != 0) {
+			pr_err("Port info not found!\n");
+			return err;
+		}
+
+		memset(name, 0, sizeof(name));
+		snprintf(name, sizeof(name), "ppio-%d:%d", port_desc->pp_id, port_desc->ppio_id);
+		pr_debug("found port: %s\n", name);
+		memset(&port_params, 0, sizeof(port_params));
+		port_params.match = name;
+		port_params.type = PP2_PPIO_T_NIC;
+		port_params.inqs_params.num_tcs = PP2_MAX_NUM_TCS_PER_PORT;
+		/* The generated flows differ in source address and port */
+		port_params.inqs_params.hash_type[0] = PP2_PPIO_HASH_T_5_TUPLE;
+		for (i=0; i<port_params.inqs_params.num_tcs; i++) {
+			port_params.inqs_params.tcs_params[i].pkt_offset = PKT_OFFS>>2;
+			port_params.inqs_params.tcs_params[i].num_in_qs = PP2_MAX_NUM_QS_PER_TC;
+			inq_params.size = garg->rxq_size;
+			port_params.inqs_params.tcs_params[i].inqs_params = &inq_params;
+			for (j=0; j<garg->num_pools; j++)
+				port_params.inqs_params.tcs_params[i].pools[j] =
+					garg->pools[port_desc->pp_id][j];
+		}
+		port_params.outqs_params.num_outqs = PP2_MAX_NUM_TCS_PER_PORT;
+		for (i=0; i<port_params.outqs_params.num_outqs; i++) {
+			port_params.outqs_params.outqs_params[i].size = TXQ_SIZE;
+			port_params.outqs_params.outqs_params[i].weight = 1;
+		}
+		if ((err = pp2_ppio_init(&port_params, &port_desc->port)) != 0)
+			return err;
+		if (!port_desc->port) {
+			pr_err("PP-IO init failed!\n");
+			return -EIO;
+		}
+
+		pp2_ppio_get_mtu(port_desc->port, &mtu);
+		if (mtu != garg->mtu) {
+			pp2_ppio_set_mtu(port_desc->port, garg->mtu);
+			pp2_ppio_set_mru(port_desc->port, MVPP2_MTU_TO_MRU(garg->mtu));
+			pr_info("Set port ppio-%d:%d MTU to %d\n",
+				port_desc->pp_id, port_desc->ppio_id, garg->mtu);
+		}
+
+		if ((err = pp2_ppio_get_mac_addr(port_desc->port, port_desc->mac)) != 0)
+			return err;
+
+		if ((err = pp2_ppio_enable(port_desc->port)) != 0)
+			return err;
+	}
+
+	pr_info("done\n");
+	return 0;
+}
+
+static void free_rx_queues(struct pp2_ppio *port)
+{
+	struct pp2_ppio_desc	descs[MAX_BURST_SIZE];
+	u8			tc = 0, qid = 0;
+	u16			num;
+
+	for (tc = 0; tc < PP2_MAX_NUM_TCS_PER_PORT; tc++) {
+		for (qid = 0; qid < PP2_MAX_NUM_QS_PER_TC; qid++) {
+			num = MAX_BURST_SIZE;
+			while (num)
+				pp2_ppio_recv(port, tc, qid, descs, &num);
+		}
+	}
+}
+
+static void destroy_local_modules(struct glob_arg *garg)
+{
+	int i;
+
+	for (i = 0;  i < garg->num_ports; i++) {
+		if (garg->ports_desc[i].port) {
+			pp2_ppio_disable(garg->ports_desc[i].port);
+			free_rx_queues(garg->ports_desc[i].port);
+		}
+	}
+
+	free_all_pools(garg);
+
+	for (i = 0;  i < garg->num_ports; i++) {
+		if (garg->ports_desc[i].port)
+			pp2_ppio_deinit(garg->ports_desc[i].port);
+	}
+
+	if (garg->hif)
+		pp2_hif_deinit(garg->hif);
+}
+
+static void destroy_all_modules(void)
+{
+	pp2_deinit();
+	mv_sys_dma_mem_destroy();
+}
+
+static void pkt_gen_stats_sum(struct pkt_gen_stats *sum, struct pkt_gen_stats *stats, int num)
+{
+	int i, j;
+
+	memset(sum, 0, sizeof(*sum));
+	for (i = 0; i < num; i++) {
+		sum->tx += stats[i].tx;
+		sum->tx_full += stats[i].tx_full;
+		sum->rx += stats[i].rx;
+		sum->rx_other += stats[i].rx_other;
+		sum->lost += stats[i].lost;
+		sum->reordered += stats[i].reordered;
+		if (stats[i].lat_cnt && (stats[i].lat_min < sum->lat_min || !sum->lat_cnt))
+			sum->lat_min = stats[i].lat_min;
+		if (stats[i].lat_max > sum->lat_max)
+			sum->lat_max = stats[i].lat_max;
+		sum->lat_sum += stats[i].lat_sum;
+		sum->lat_cnt += stats[i].lat_cnt;
+		for (j = 0; j < PKT_GEN_LAT_BUCKETS; j++)
+			sum->lat_hist[j] += stats[i].lat_hist[j];
+	}
+}
+
+static void pkt_gen_report(struct pkt_gen_stats *stats, int num)
+{
+	struct pkt_gen_stats	sum;
+	u64			cum = 0;
+	int			i;
+
+	pkt_gen_stats_sum(&sum, stats, num);
+	printf("tx=%lu, tx_full=%lu, rx=%lu, rx_other=%lu, lost=%lu, reordered=%lu\n",
+	       sum.tx, sum.tx_full, sum.rx, sum.rx_other, sum.lost, sum.reordered);
+	if (!sum.lat_cnt)
+		return;
+
+	printf("latency (ns): min=%lu, avg=%lu, max=%lu\n",
+	       sum.lat_min, sum.lat_sum / sum.lat_cnt, sum.lat_max);
+	for (i = 0; i < PKT_GEN_LAT_BUCKETS; i++) {
+		if (!sum.lat_hist[i])
+			continue;
+		cum += sum.lat_hist[i];
+		printf("\t< %10lu: %12lu (%6.2f%%)\n", 2UL << i, sum.lat_hist[i], 100.0 * cum / sum.lat_cnt);
+	}
+}
+
+static int stat_cmd_cb(void *arg, int argc, char *argv[])
+{
+	struct glob_arg		*garg = (struct glob_arg *)arg;
+	struct pkt_gen_stats	*stats;
+	int			 i;
+
+	if (!garg) {
+		pr_err("no garg obj passed!\n");
+		return -EINVAL;
+	}
+
+	for (i = 0; i < garg->cpus; i++) {
+		stats = &pkt_gen_stats[i];
+		printf("cpu%d: tx=%lu, tx_full=%lu, rx=%lu, rx_other=%lu, lost=%lu, reordered=%lu\n",
+		       i, stats->tx, stats->tx_full, stats->rx, stats->rx_other, stats->lost, stats->reordered);
+	}
+	pkt_gen_report(pkt_gen_stats, garg->cpus);
+
+	/* The counters are owned by the data path; a reset is a race we accept */
+	if (argc > 1)
+		memset(pkt_gen_stats, 0, sizeof(pkt_gen_stats));
+	return 0;
+}
+
+static int register_cli_cmds(struct glob_arg *garg)
+{
+	struct cli_cmd_params	 cmd_params;
+
+	memset(&cmd_params, 0, sizeof(cmd_params));
+	cmd_params.name		= "stat";
+	cmd_params.desc		= "Show generator statistics and the latency histogram";
+	cmd_params.format	= "<reset>";
+	cmd_params.cmd_arg	= garg;
+	cmd_params.do_cmd_cb	= (int (*)(void *, int, char *[]))stat_cmd_cb;
+	mvapp_register_cli_cmd(&cmd_params);
+
+	return 0;
+}
+
+static int dump_perf(struct glob_arg *garg)
+{
+	struct timeval	 curr_time;
+	u64		 tmp_time_inter, tx = 0, rx = 0, lost = 0;
+	int		 i;
+
+	gettimeofday(&curr_time, NULL);
+	tmp_time_inter = (curr_time.tv_sec - garg->ctrl_trd_last_time.tv_sec) * 1000;
+	tmp_time_inter += (curr_time.tv_usec - garg->ctrl_trd_last_time.tv_usec)/1000;
+	if (!tmp_time_inter)
+		return 0;
+
+	for (i = 0; i < garg->cpus; i++) {
+		tx += pkt_gen_stats[i].tx;
+		rx += pkt_gen_stats[i].rx;
+		lost += pkt_gen_stats[i].lost;
+	}
+	printf("Perf: Tx %luKpps (%luMbps), Rx %luKpps, lost %lu\n",
+	       (tx - garg->lst_tx_cnt) / tmp_time_inter,
+	       (tx - garg->lst_tx_cnt) * (garg->size + PKT_GEN_WIRE_OVERHEAD) * 8 / tmp_time_inter / 1000,
+	       (rx - garg->lst_rx_cnt) / tmp_time_inter, lost);
+	garg->lst_tx_cnt = tx;
+	garg->lst_rx_cnt = rx;
+	garg->ctrl_trd_last_time = curr_time;
+
+	return 0;
+}
+
+static int ctrl_cb(void *arg)
+{
+	struct glob_arg *garg = (struct glob_arg *)arg;
+	struct timeval	 curr_time;
+	u64		 tmp_time_inter;
+
+	if (!garg) {
+		pr_err("no obj!\n");
+		return -EINVAL;
+	}
+
+	gettimeofday(&curr_time, NULL);
+	tmp_time_inter = (curr_time.tv_sec - garg->ctrl_trd_last_time.tv_sec) * 1000;
+	tmp_time_inter += (curr_time.tv_usec - garg->ctrl_trd_last_time.tv_usec)/1000;
+	if (tmp_time_inter >= garg->ctrl_thresh)
+		return dump_perf(garg);
+	return 0;
+}
+
+static void pkt_gen_init_clock(struct glob_arg *garg)
+{
+	garg->tsc_hz = pkt_gen_tsc_hz();
+	garg->ns_mult = (1000000000ULL << 24) / garg->tsc_hz;
+}
+
+static int init_global(void *arg)
+{
+	struct glob_arg *garg = (struct glob_arg *)arg;
+	int		 err;
+
+	if (!garg) {
+		pr_err("no obj!\n");
+		return -EINVAL;
+	}
+
+	if (pthread_mutex_init(&garg->trd_lock, NULL) != 0) {
+		pr_err("init lock failed!\n");
+		return -EIO;
+	}
+
+	if ((err = init_all_modules()) != 0)
+		return err;
+
+	if ((err = init_local_modules(garg)) != 0)
+		return err;
+
+	/* Packets sent to a port of this host are addressed to it */
+	if (!garg->dmac_set) {
+		if (garg->rx_port >= 0)
+			memcpy(garg->dmac, garg->ports_desc[garg->rx_port].mac, ETH_ADDR_NUM_OCTETS);
+		else
+			memset(garg->dmac, 0xff, ETH_ADDR_NUM_OCTETS);
+	}
+
+	pkt_gen_init_clock(garg);
+	gettimeofday(&garg->ctrl_trd_last_time, NULL);
+
+	if (garg->cli && ((err = register_cli_cmds(garg)) != 0))
+		return err;
+
+	return 0;
+}
+
+static void deinit_global(void *arg)
+{
+	struct glob_arg *garg = (struct glob_arg *)arg;
+
+	if (!garg)
+		return;
+	pkt_gen_report(pkt_gen_stats, garg->cpus);
+	destroy_local_modules(garg);
+	destroy_all_modules();
+}
+
+/* Take the TX ring buffers from the TX port pool and build their templates */
+static int init_tx_ring(struct local_arg *larg)
+{
+	struct glob_arg		*garg = larg->garg;
+	struct port_desc	*port_desc = &garg->ports_desc[garg->tx_port];
+	struct tx_ring_ent	*ent;
+	int			 i;
+
+	for (i = 0; i < garg->num_pools; i++)
+		if (garg->pool_buff_size[i] >= PKT_EFEC_OFFS + larg->pkt_len)
+			break;
+	if (i == garg->num_pools) {
+		pr_err("no pool for %u bytes packets!\n", garg->size);
+		return -EINVAL;
+	}
+	larg->tx_pool = garg->pools[port_desc->pp_id][i];
+
+	larg->tx_ring = (struct tx_ring_ent *)calloc(PKT_GEN_TX_RING, sizeof(struct tx_ring_ent));
+	if (!larg->tx_ring) {
+		pr_err("no mem for TX ring!\n");
+		return -ENOMEM;
+	}
+	for (i = 0; i < PKT_GEN_TX_RING; i++) {
+		ent = &larg->tx_ring[i];
+		if (pp2_bpool_get_buff(larg->hif, larg->tx_pool, &ent->binf)) {
+			pr_err("no buffer for TX ring entry %d!\n", i);
+			return -ENOMEM;
+		}
+		larg->tx_ring_size++;
+		ent->pkt = (char *)(((uintptr_t)ent->binf.cookie) | sys_dma_high_addr) + PKT_EFEC_OFFS;
+		pkt_gen_build_template(garg, ent->pkt, larg->pkt_len, port_desc->mac, larg->id);
+	}
+	larg->tx_free = larg->tx_ring_size;
+
+	/* Each core sends its share of the rate */
+	if (garg->pps)
+		larg->pkts_per_tick = garg->pps / garg->cpus / garg->tsc_hz;
+	return 0;
+}
+
+static void deinit_tx_ring(struct local_arg *larg)
+{
+	u32 i;
+
+	for (i = 0; i < larg->tx_ring_size; i++)
+		pp2_bpool_put_buff(larg->hif, larg->tx_pool, &larg->tx_ring[i].binf);
+	free(larg->tx_ring);
+}
+
+static int init_local(void *arg, int id, void **_larg)
+{
+	struct glob_arg		*garg = (struct glob_arg *)arg;
+	struct local_arg	*larg;
+	struct pp2_hif_params	 hif_params;
+	char			 name[MATCH_NAME_SIZE];
+	int			 err, hif_id;
+
+	if (!garg) {
+		pr_err("no obj!\n");
+		return -EINVAL;
+	}
+
+	larg = (struct local_arg *)malloc(sizeof(struct local_arg));
+	if (!larg) {
+		pr_err("No mem for local arg obj!\n");
+		return -ENOMEM;
+	}
+	memset(larg, 0, sizeof(struct local_arg));
+
+	pthread_mutex_lock(&garg->trd_lock);
+	if ((hif_id = find_free_hif()) < 0) {
+		pr_err("free HIF not found!\n");
+		pthread_mutex_unlock(&garg->trd_lock);
+		free(larg);
+		return hif_id;
+	}
+	memset(name, 0, sizeof(name));
+	snprintf(name, sizeof(name), "hif-%d", hif_id);
+	pr_debug("found hif: %s\n", name);
+	memset(&hif_params, 0, sizeof(hif_params));
+	hif_params.match = name;
+	hif_params.out_size = HIFQ_SIZE;
+	err = pp2_hif_init(&hif_params, &larg->hif);
+	pthread_mutex_unlock(&garg->trd_lock);
+	if (err != 0 || !larg->hif) {
+		pr_err("HIF init failed!\n");
+		free(larg);
+		return err ? err : -EIO;
+	}
+
+	larg->id	= id;
+	larg->burst	= garg->burst;
+	larg->pkt_len	= garg->size - ETH_FCS_LEN;
+	larg->stats	= &pkt_gen_stats[id];
+	larg->garg	= garg;
+	/* Each thread owns one RX queue; RSS spreads the flows */
+	larg->qid	= id;
+
+	if (garg->tx_port >= 0) {
+		larg->tx_port = garg->ports_desc[garg->tx_port].port;
+		if ((err = init_tx_ring(larg)) != 0)
+			goto err;
+	}
+	if (garg->rx_port >= 0) {
+		larg->rx_port = garg->ports_desc[garg->rx_port].port;
+		larg->rx_flows = (struct rx_flows *)calloc(1, sizeof(struct rx_flows));
+		if (!larg->rx_flows) {
+			pr_err("no mem for RX flows!\n");
+			err = -ENOMEM;
+			goto err;
+		}
+	}
+
+	pr_debug("thread %d (cpu %d) mapped to RX queue %d using %s\n",
+		 larg->id, sched_getcpu(), larg->qid, name);
+
+	*_larg = larg;
+	return 0;
+
+err:
+	if (larg->tx_ring)
+		deinit_tx_ring(larg);
+	pp2_hif_deinit(larg->hif);
+	free(larg);
+	return err;
+}
+
+static void deinit_local(void *arg)
+{
+	struct local_arg *larg = (struct local_arg *)arg;
+
+	if (!larg)
+		return;
+
+	if (larg->tx_ring)
+		deinit_tx_ring(larg);
+	free(larg->rx_flows);
+	if (larg->hif)
+		pp2_hif_deinit(larg->hif);
+	free(larg);
+}
+
+static inline u32 sw_lb_rand(u32 *state)
+{
+	*state ^= *state << 13;
+	*state ^= *state >> 17;
+	*state ^= *state << 5;
+	return *state;
+}
+
+/* Software loopback: the generator and the receive side run back to back in
+ * memory, with no PPv2, over an emulated link that drops packets and delays
+ * packets by one burst at the given rates. The receive side must report the
+ * injected loss and reordering.
+ */
+static int run_sw_loopback(struct glob_arg *garg)
+{
+	static const u8		 smac[ETH_ADDR_NUM_OCTETS] = {0x00, 0x50, 0x43, 0x00, 0x00, 0x01};
+	char			*bufs = NULL, *pkts[MAX_BURST_SIZE];
+	char			*held[MAX_BURST_SIZE], *delayed[MAX_BURST_SIZE];
+	struct rx_flows		*flows = NULL;
+	struct pkt_gen_stats	*stats = &pkt_gen_stats[0];
+	u64			 cnt, now, drops = 0, delays = 0, start;
+	u32			 rnd = 0x12345678, drop_thr, delay_thr;
+	u16			 len = garg->size - ETH_FCS_LEN, i, num, num_new, num_delayed, num_held = 0;
+	int			 err = 0;
+
+	pkt_gen_init_clock(garg);
+	if (!garg->dmac_set)
+		memset(garg->dmac, 0xff, ETH_ADDR_NUM_OCTETS);
+	/* The stamps come from this host */
+	garg->tx_port = garg->rx_port = 0;
+
+	bufs = (char *)malloc((u64)SW_LB_RING * SW_LB_BUF_SIZE);
+	flows = (struct rx_flows *)calloc(1, sizeof(struct rx_flows));
+	if (!bufs || !flows) {
+		pr_err("no mem for software loopback!\n");
+		err = -ENOMEM;
+		goto out;
+	}
+	/* Packets at the same offset as in pool buffers, for the same alignment */
+	for (i = 0; i < SW_LB_RING; i++)
+		pkt_gen_build_template(garg, bufs + i * SW_LB_BUF_SIZE + PKT_EFEC_OFFS, len, smac, 0);
+
+	/* Thresholds of a 32-bit random number for the ppm rates */
+	drop_thr = (u32)((u64)garg->sw_lb_drop * 0xffffffffULL / 1000000);
+	delay_thr = (u32)((u64)garg->sw_lb_reorder * 0xffffffffULL / 1000000);
+
+	printf("Software loopback: %lu packets of %u bytes, %u flows, burst %u, drop %u ppm, delay %u ppm\n",
+	       garg->sw_lb_pkts, garg->size, garg->flows, garg->burst, garg->sw_lb_drop, garg->sw_lb_reorder);
+
+	start = pkt_gen_tsc();
+	for (cnt = 0; cnt < garg->sw_lb_pkts; cnt += num) {
+		num = min((u64)garg->burst, garg->sw_lb_pkts - cnt);
+		num_new = num_delayed = 0;
+		now = pkt_gen_tsc();
+		for (i = 0; i < num; i++) {
+			char *pkt = bufs + ((cnt + i) % SW_LB_RING) * SW_LB_BUF_SIZE + PKT_EFEC_OFFS;
+
+			pkt_gen_stamp(garg, pkt, cnt + i, now);
+			stats->tx++;
+			if (drop_thr && sw_lb_rand(&rnd) < drop_thr)
+				drops++;
+			else if (delay_thr && sw_lb_rand(&rnd) < delay_thr)
+				delayed[num_delayed++] = pkt;
+			else
+				pkts[num_new++] = pkt;
+		}
+		delays += num_delayed;
+
+		/* The packets delayed by the previous burst arrive after this one */
+		now = pkt_gen_tsc();
+		for (i = 0; i < num_new; i++)
+			pkt_gen_rx_pkt(garg, flows, stats, pkts[i], len, now);
+		for (i = 0; i < num_held; i++)
+			pkt_gen_rx_pkt(garg, flows, stats, held[i], len, now);
+		memcpy(held, delayed, num_delayed * sizeof(char *));
+		num_held = num_delayed;
+	}
+	now = pkt_gen_tsc();
+	for (i = 0; i < num_held; i++)
+		pkt_gen_rx_pkt(garg, flows, stats, held[i], len, now);
+
+	printf("%.2f Mpps (generate and receive, one core)\n",
+	       cnt / (pkt_gen_ticks_to_ns(garg, now - start) / 1000.0));
+	printf("injected: drops=%lu, delays=%lu\n", drops, delays);
+	pkt_gen_report(stats, 1);
+
+out:
+	free(bufs);
+	free(flows);
+	return err;
+}
+
+static void usage(char *progname)
+{
+	printf("\n"
+	       "MUSDK packet generator application.\n"
+	       "\n"
+	       "Usage: %s OPTIONS\n"
+	       "  E.g. %s -i eth0,eth2 --tx 0 --rx 1 --pps 1000000 -c 2\n"
+	       "       %s --sw-loopback --drop 100 --delay 100\n"
+	       "\n"
+	       "Mandatory OPTIONS (unless --sw-loopback):\n"
+	       "\t-i, --interface <Eth-interfaces> (comma-separated, no spaces)\n"
+	       "                  Interface count min 1, max %i\n"
+	       "\n"
+	       "Optional OPTIONS:\n"
+	       "\t--tx <index>             Interface to send on, index in the '-i' list (default is 0)\n"
+	       "\t--rx <index>             Interface to receive on, index in the '-i' list (default is the last one)\n"
+	       "\t--tx-only                Send only; e.g. toward a remote receiver\n"
+	       "\t--rx-only                Receive only; reports loss and reordering, no latency\n"
+	       "\t--pps <rate>             Packets per second of all cores, k/M/G suffix allowed\n"
+	       "                         (default is as fast as possible)\n"
+	       "\t--bps <rate>             Bits per second on the wire of all cores, k/M/G suffix allowed\n"
+	       "\t--size <bytes>           Frame size, including the FCS (default is %d)\n"
+	       "\t-f <num>                 Flows per core, a power of 2 up to %d (default is %d)\n"
+	       "\t-n <num>                 Packets per core to send (default is no limit)\n"
+	       "\t--dmac <mac>             Destination MAC (default is the RX interface MAC, or broadcast)\n"
+	       "\t--sip <ip>               First source IP, incremented per flow (default is 10.0.0.1)\n"
+	       "\t--dip <ip>               Destination IP (default is 10.1.0.1)\n"
+	       "\t-b <size>                Burst size, num_pkts handled in a batch.(default is %d)\n"
+	       "\t--mtu <mtu>              Set MTU (default is %d)\n"
+	       "\t-c, --cores <number>     Number of CPUs to use\n"
+	       "\t-a, --affinity <number>  Use setaffinity (default is no affinity)\n"
+	       "\t-t <mtime>               Time interval between rate reports, in msec (default is %d)\n"
+	       "\t--rxq <size>             Size of rx_queue (default is %d)\n"
+	       "\t--cli                    Use CLI\n"
+	       "\t--sw-loopback [pkts]     Generate and receive [pkts] packets in memory, with no PPv2\n"
+	       "                         (default is %d)\n"
+	       "\t--drop <ppm>             Software loopback packet drop rate\n"
+	       "\t--delay <ppm>            Software loopback rate of packets delayed by one burst\n"
+	       "\t?, -h, --help            Display help and exit\n\n"
+	       "\n", NO_PATH(progname), NO_PATH(progname), NO_PATH(progname), PP2_MAX_NUM_PORTS,
+	       PKT_GEN_DFLT_SIZE, PKT_GEN_MAX_FLOWS, PKT_GEN_DFLT_FLOWS, DFLT_BURST_SIZE, DEFAULT_MTU,
+	       CTRL_DFLT_THR, RXQ_SIZE, SW_LB_DFLT_PKTS
+	       );
+}
+
+/* A rate, with an optional k, M or G suffix */
+static double parse_rate(const char *str)
+{
+	char	*end;
+	double	 rate = strtod(str, &end);
+
+	switch (*end) {
+	case 'k':
+	case 'K':
+		return rate * 1e3;
+	case 'm':
+	case 'M':
+		return rate * 1e6;
+	case 'g':
+	case 'G':
+		return rate * 1e9;
+	case '\0':
+		return rate;
+	default:
+		return -1;
+	}
+}
+
+static int parse_ip(const char *str, u32 *ip)
+{
+	struct in_addr addr;
+
+	if (inet_pton(AF_INET, str, &addr) != 1)
+		return -EINVAL;
+	*ip = ntohl(addr.s_addr);
+	return 0;
+}
+
+static int parse_args(struct glob_arg *garg, int argc, char *argv[])
+{
+	double	bps = 0;
+	int	i = 1, tx_only = 0, rx_only = 0;
+
+	garg->cli = 0;
+	garg->cpus = 1;
+	garg->affinity = -1;
+	garg->burst = DFLT_BURST_SIZE;
+	garg->mtu = DEFAULT_MTU;
+	garg->rxq_size = RXQ_SIZE;
+	garg->ctrl_thresh = CTRL_DFLT_THR;
+	garg->tx_port = 0;
+	garg->rx_port = -1;
+	garg->size = PKT_GEN_DFLT_SIZE;
+	garg->flows = PKT_GEN_DFLT_FLOWS;
+	garg->pps = 0;
+	garg->count = 0;
+	garg->dmac_set = 0;
+	garg->sip = PKT_GEN_DFLT_SIP;
+	garg->dip = PKT_GEN_DFLT_DIP;
+	garg->sw_lb = 0;
+	garg->sw_lb_pkts = SW_LB_DFLT_PKTS;
+	garg->sw_lb_drop = 0;
+	garg->sw_lb_reorder = 0;
+
+	while (i < argc) {
+		if ((strcmp(argv[i], "?") == 0) ||
+		    (strcmp(argv[i], "-h") == 0) ||
+		    (strcmp(argv[i], "--help") == 0)) {
+			usage(argv[0]);
+			exit(0);
+		} else if (strcmp(argv[i], "--sw-loopback") == 0) {
+			garg->sw_lb = 1;
+			if ((argc > (i+1)) && (argv[i+1][0] != '-')) {
+				garg->sw_lb_pkts = strtoull(argv[i+1], NULL, 0);
+				i += 2;
+			} else {
+				i += 1;
+			}
+		} else if (strcmp(argv[i], "--cli") == 0) {
+			garg->cli = 1;
+			i += 1;
+		} else if (strcmp(argv[i], "--tx-only") == 0) {
+			tx_only = 1;
+			i += 1;
+		} else if (strcmp(argv[i], "--rx-only") == 0) {
+			rx_only = 1;
+			i += 1;
+		} else if (argc < (i+2)) {
+			pr_err("Invalid number of arguments!\n");
+			return -EINVAL;
+		} else if (strcmp(argv[i], "-i") == 0) {
+			char *token;
+
+			if (argv[i+1][0] == '-') {
+				pr_err("Invalid interface arguments format!\n");
+				return -EINVAL;
+			}
+
+			/* count the number of tokens separated by ',' */
+			for (token = strtok(argv[i+1], ","), garg->num_ports = 0;
+			     token != NULL && garg->num_ports < PP2_MAX_NUM_PORTS;
+			     token = strtok(NULL, ","), garg->num_ports++)
+				snprintf(garg->ports_desc[garg->num_ports].name,
+					 sizeof(garg->ports_desc[garg->num_ports].name),
+					 "%s", token);
+
+			if (garg->num_ports == 0) {
+				pr_err("Invalid interface arguments format!\n");
+				return -EINVAL;
+			} else if (token) {
+				pr_err("too many ports specified (max %d)\n", PP2_MAX_NUM_PORTS);
+				return -EINVAL;
+			}
+			i += 2;
+		} else if (strcmp(argv[i], "--tx") == 0) {
+			garg->tx_port = atoi(argv[i+1]);
+			i += 2;
+		} else if (strcmp(argv[i], "--rx") == 0) {
+			garg->rx_port = atoi(argv[i+1]);
+			i += 2;
+		} else if (strcmp(argv[i], "--pps") == 0) {
+			garg->pps = parse_rate(argv[i+1]);
+			if (garg->pps < 0) {
+				pr_err("Invalid rate %s!\n", argv[i+1]);
+				return -EINVAL;
+			}
+			i += 2;
+		} else if (strcmp(argv[i], "--bps") == 0) {
+			bps = parse_rate(argv[i+1]);
+			if (bps < 0) {
+				pr_err("Invalid rate %s!\n", argv[i+1]);
+				return -EINVAL;
+			}
+			i += 2;
+		} else if (strcmp(argv[i], "--size") == 0) {
+			garg->size = atoi(argv[i+1]);
+			i += 2;
+		} else if (strcmp(argv[i], "-f") == 0) {
+			garg->flows = atoi(argv[i+1]);
+			i += 2;
+		} else if (strcmp(argv[i], "-n") == 0) {
+			garg->count = strtoull(argv[i+1], NULL, 0);
+			i += 2;
+		} else if (strcmp(argv[i], "--dmac") == 0) {
+			u32 m[ETH_ADDR_NUM_OCTETS];
+			int k;
+
+			if (sscanf(argv[i+1], "%x:%x:%x:%x:%x:%x",
+				   &m[0], &m[1], &m[2], &m[3], &m[4], &m[5]) != ETH_ADDR_NUM_OCTETS) {
+				pr_err("Invalid MAC %s!\n", argv[i+1]);
+				return -EINVAL;
+			}
+			for (k = 0; k < ETH_ADDR_NUM_OCTETS; k++)
+				garg->dmac[k] = m[k];
+			garg->dmac_set = 1;
+			i += 2;
+		} else if (strcmp(argv[i], "--sip") == 0) {
+			if (parse_ip(argv[i+1], &garg->sip)) {
+				pr_err("Invalid IP %s!\n", argv[i+1]);
+				return -EINVAL;
+			}
+			i += 2;
+		} else if (strcmp(argv[i], "--dip") == 0) {
+			if (parse_ip(argv[i+1], &garg->dip)) {
+				pr_err("Invalid IP %s!\n", argv[i+1]);
+				return -EINVAL;
+			}
+			i += 2;
+		} else if (strcmp(argv[i], "--drop") == 0) {
+			garg->sw_lb_drop = atoi(argv[i+1]);
+			i += 2;
+		} else if (strcmp(argv[i], "--delay") == 0) {
+			garg->sw_lb_reorder = atoi(argv[i+1]);
+			i += 2;
+		} else if (strcmp(argv[i], "-b") == 0) {
+			garg->burst = atoi(argv[i+1]);
+			i += 2;
+		} else if (strcmp(argv[i], "--mtu") == 0) {
+			garg->mtu = atoi(argv[i+1]);
+			i += 2;
+		} else if (strcmp(argv[i], "-c") == 0) {
+			garg->cpus = atoi(argv[i+1]);
+			i += 2;
+		} else if (strcmp(argv[i], "-a") == 0) {
+			garg->affinity = atoi(argv[i+1]);
+			i += 2;
+		} else if (strcmp(argv[i], "-t") == 0) {
+			garg->ctrl_thresh = atoi(argv[i+1]);
+			i += 2;
+		} else if (strcmp(argv[i], "--rxq") == 0) {
+			garg->rxq_size = atoi(argv[i+1]);
+			i += 2;
+		} else {
+			pr_err("argument (%s) not supported!\n", argv[i]);
+			return -EINVAL;
+		}
+	}
+
+	/* Now, check validity of all inputs */
+	if (!garg->burst || garg->burst > MAX_BURST_SIZE) {
+		pr_err("illegal burst size requested (%d vs %d)!\n",
+			garg->burst, MAX_BURST_SIZE);
+		return -EINVAL;
+	}
+	if (garg->size < PKT_GEN_MIN_SIZE || garg->size > garg->mtu + ETH_HLEN + ETH_FCS_LEN) {
+		pr_err("illegal frame size %u (%d to MTU + %d)!\n",
+		       garg->size, PKT_GEN_MIN_SIZE, ETH_HLEN + ETH_FCS_LEN);
+		return -EINVAL;
+	}
+	if (!garg->flows || garg->flows > PKT_GEN_MAX_FLOWS || (garg->flows & (garg->flows - 1))) {
+		pr_err("illegal number of flows %u (a power of 2 up to %d)!\n",
+		       garg->flows, PKT_GEN_MAX_FLOWS);
+		return -EINVAL;
+	}
+	if (bps)
+		garg->pps = bps / ((garg->size + PKT_GEN_WIRE_OVERHEAD) * 8);
+	if (garg->sw_lb) {
+		if (!garg->sw_lb_pkts || garg->sw_lb_drop > 1000000 || garg->sw_lb_reorder > 1000000 ||
+		    PKT_EFEC_OFFS + garg->size > SW_LB_BUF_SIZE) {
+			pr_err("illegal software loopback parameters!\n");
+			return -EINVAL;
+		}
+		return 0;
+	}
+	if (!garg->num_ports) {
+		pr_err("No port defined!\n");
+		return -EINVAL;
+	}
+	if (garg->rx_port == -1)
+		garg->rx_port = garg->num_ports - 1;
+	if (garg->tx_port < 0 || garg->tx_port >= garg->num_ports ||
+	    garg->rx_port < 0 || garg->rx_port >= garg->num_ports) {
+		pr_err("illegal TX/RX interface index (%d,%d vs %d interfaces)!\n",
+		       garg->tx_port, garg->rx_port, garg->num_ports);
+		return -EINVAL;
+	}
+	if (tx_only && rx_only) {
+		pr_err("--tx-only and --rx-only are exclusive!\n");
+		return -EINVAL;
+	}
+	if (tx_only)
+		garg->rx_port = -1;
+	if (rx_only)
+		garg->tx_port = -1;
+	if (garg->cpus < 1 || garg->cpus > MAX_NUM_CORES) {
+		pr_err("illegal num cores requested (%d vs %d)!\n",
+			garg->cpus, MAX_NUM_CORES);
+		return -EINVAL;
+	}
+	if ((garg->affinity != -1) &&
+	    ((garg->cpus + garg->affinity) > MAX_NUM_CORES)) {
+		pr_err("illegal num cores or affinity requested (%d,%d vs %d)!\n",
+			garg->cpus, garg->affinity, MAX_NUM_CORES);
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+
+int main (int argc, char *argv[])
+{
+	struct mvapp_params	mvapp_params;
+	u64			cores_mask;
+	int			i, err;
+
+	setbuf(stdout, NULL);
+
+	if ((err = parse_args(&garg, argc, argv)) != 0)
+		return err;
+
+	if (garg.sw_lb)
+		return run_sw_loopback(&garg);
+
+	pr_info("pkt_gen is started\n");
+	garg.pp2_num_inst = pp2_get_num_inst();
+
+	cores_mask = 0;
+	for (i=0; i<garg.cpus; i++, cores_mask<<=1, cores_mask|=1) ;
+	cores_mask <<= (garg.affinity != -1) ? garg.affinity : 0;
+
+	memset(&mvapp_params, 0, sizeof(mvapp_params));
+	mvapp_params.use_cli		= garg.cli;
+	mvapp_params.num_cores		= garg.cpus;
+	mvapp_params.cores_mask		= cores_mask;
+	mvapp_params.global_arg		= (void *)&garg;
+	mvapp_params.init_global_cb	= init_global;
+	mvapp_params.deinit_global_cb	= deinit_global;
+	mvapp_params.init_local_cb	= init_local;
+	mvapp_params.deinit_local_cb	= deinit_local;
+	mvapp_params.main_loop_cb	= main_loop;
+	if (!mvapp_params.use_cli)
+		mvapp_params.ctrl_cb	= ctrl_cb;
+	return mvapp_go(&mvapp_params);
+}
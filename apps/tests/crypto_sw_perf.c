@@ -0,0 +1,415 @@
+/******************************************************************************
+ *	Copyright (C) 2016 Marvell International Ltd.
+ *
+ *  If you received this File from Marvell, you may opt to use, redistribute
+ *  and/or modify this File under the following licensing terms.
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *	* Redistributions of source code must retain the above copyright
+ *	  notice, this list of conditions and the following disclaimer.
+ *
+ *	* Redistributions in binary form must reproduce the above copyright
+ *	  notice, this list of conditions and the following disclaimer in the
+ *	  documentation and/or other materials provided with the distribution.
+ *
+ *	* Neither the name of Marvell nor the names of its contributors may be
+ *	  used to endorse or promote products derived from this software
+ *	  without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include <getopt.h>
+
+#include "std_internal.h"
+#include "lib/mv_aes.h"
+#include "lib/mv_sha1.h"
+#include "lib/mv_sha2.h"
+#include "lib/mv_sha_mb.h"
+
+
+#define CRYPTO_PERF_DEF_BUF_SIZE	1024
+#define CRYPTO_PERF_DEF_ITERS		20000
+#define CRYPTO_PERF_MAX_BUF_SIZE	(64 * 1024)
+#define CRYPTO_PERF_NUM_KEYS		64
+#define CRYPTO_PERF_HMAC_KEY_SIZE	32
+
+
+struct perf_args {
+	size_t	buf_size;
+	int	iters;
+};
+
+static u8 perf_in[CRYPTO_PERF_MAX_BUF_SIZE];
+static u8 perf_out[CRYPTO_PERF_MAX_BUF_SIZE];
+static u8 perf_mb_in[MV_SHA_MB_MAX_LANES][CRYPTO_PERF_MAX_BUF_SIZE];
+static u8 perf_keys[CRYPTO_PERF_NUM_KEYS][CRYPTO_PERF_HMAC_KEY_SIZE];
+static u8 perf_inner[CRYPTO_PERF_NUM_KEYS][SHA256_DIGEST_LENGTH];
+static u8 perf_outer[CRYPTO_PERF_NUM_KEYS][SHA256_DIGEST_LENGTH];
+
+static void perf_report(const char *name, int key_size, size_t bytes, double secs)
+{
+	if (key_size)
+		printf("%-16s %3d bits: %10.2f MB/s\n", name, key_size, bytes / secs / (1024 * 1024));
+	else
+		printf("%-16s          %10.2f MB/s\n", name, bytes / secs / (1024 * 1024));
+}
+
+static void aes_perf_legacy_ecb(struct perf_args *args, const u8 *key, int key_size)
+{
+	size_t off;
+	u64 start;
+	int i;
+
+	start = mv_time_usecs();
+	for (i = 0; i < args->iters; i++)
+		for (off = 0; off < args->buf_size; off += MV_AES_BLOCK_SIZE)
+			mv_aes_ecb_encrypt(perf_in + off, key, perf_out + off, key_size);
+	perf_report("ecb (legacy)", key_size, args->buf_size * args->iters, (mv_time_usecs() - start) / 1e6);
+}
+
+static void aes_perf_ecb(struct perf_args *args, const u8 *key, int key_size)
+{
+	struct mv_aes_ctx ctx;
+	size_t off;
+	u64 start;
+	int i;
+
+	mv_aes_set_key(&ctx, key, key_size);
+	start = mv_time_usecs();
+	for (i = 0; i < args->iters; i++)
+		for (off = 0; off < args->buf_size; off += MV_AES_BLOCK_SIZE)
+			mv_aes_encrypt(&ctx, perf_in + off, perf_out + off);
+	perf_report("ecb", key_size, args->buf_size * args->iters, (mv_time_usecs() - start) / 1e6);
+}
+
+static void aes_perf_cbc(struct perf_args *args, const u8 *key, int key_size, int enc)
+{
+	struct mv_aes_ctx ctx;
+	u8 iv[MV_AES_BLOCK_SIZE] = {0};
+	u64 start;
+	int i;
+
+	mv_aes_set_key(&ctx, key, key_size);
+	start = mv_time_usecs();
+	for (i = 0; i < args->iters; i++) {
+		if (enc)
+			mv_aes_cbc_encrypt(&ctx, iv, perf_in, perf_out, args->buf_size);
+		else
+			mv_aes_cbc_decrypt(&ctx, iv, perf_in, perf_out, args->buf_size);
+	}
+	perf_report(enc ? "cbc-encrypt" : "cbc-decrypt", key_size,
+		    args->buf_size * args->iters, (mv_time_usecs() - start) / 1e6);
+}
+
+static void aes_perf_ctr(struct perf_args *args, const u8 *key, int key_size)
+{
+	struct mv_aes_ctx ctx;
+	u8 ctr[MV_AES_BLOCK_SIZE] = {0};
+	u64 start;
+	int i;
+
+	mv_aes_set_key(&ctx, key, key_size);
+	start = mv_time_usecs();
+	for (i = 0; i < args->iters; i++)
+		mv_aes_ctr_crypt(&ctx, ctr, perf_in, perf_out, args->buf_size);
+	perf_report("ctr", key_size, args->buf_size * args->iters, (mv_time_usecs() - start) / 1e6);
+}
+
+static void aes_perf_gcm(struct perf_args *args, const u8 *key, int key_size)
+{
+	struct mv_aes_gcm_ctx ctx;
+	u8 iv[12] = {0}, aad[16] = {0}, tag[MV_AES_GCM_TAG_SIZE];
+	u64 start;
+	int i;
+
+	mv_aes_gcm_init(&ctx, key, key_size);
+	start = mv_time_usecs();
+	for (i = 0; i < args->iters; i++)
+		mv_aes_gcm_encrypt(&ctx, iv, sizeof(iv), aad, sizeof(aad), perf_in, perf_out,
+				   args->buf_size, tag, sizeof(tag));
+	perf_report("gcm-encrypt", key_size, args->buf_size * args->iters, (mv_time_usecs() - start) / 1e6);
+}
+
+static void sha_perf_scalar(struct perf_args *args, int sha256)
+{
+	u8 digest[SHA256_DIGEST_LENGTH];
+	SHA256_CTX ctx;
+	u64 start;
+	int i;
+
+	start = mv_time_usecs();
+	for (i = 0; i < args->iters; i++) {
+		if (sha256) {
+			mv_sha256_init(&ctx);
+			mv_sha256_update(&ctx, perf_in, args->buf_size);
+			mv_sha256_final(digest, &ctx);
+		} else {
+			mv_sha1(perf_in, args->buf_size, digest);
+		}
+	}
+	perf_report(sha256 ? "sha256" : "sha1", 0, args->buf_size * args->iters, (mv_time_usecs() - start) / 1e6);
+}
+
+static void sha_perf_mb(struct perf_args *args, int sha256)
+{
+	u8 digest[MV_SHA_MB_MAX_LANES][SHA256_DIGEST_LENGTH];
+	const u8 *data[MV_SHA_MB_MAX_LANES];
+	u8 *out[MV_SHA_MB_MAX_LANES];
+	int i, lanes = mv_sha_mb_lanes();
+	u64 start;
+
+	for (i = 0; i < lanes; i++) {
+		data[i] = perf_mb_in[i];
+		out[i] = digest[i];
+	}
+
+	start = mv_time_usecs();
+	for (i = 0; i < args->iters; i++) {
+		if (sha256)
+			mv_sha256_mb(data, args->buf_size, out, lanes);
+		else
+			mv_sha1_mb(data, args->buf_size, out, lanes);
+	}
+	perf_report(sha256 ? "sha256 (mb)" : "sha1 (mb)", 0,
+		    args->buf_size * args->iters * lanes, (mv_time_usecs() - start) / 1e6);
+}
+
+static void hmac_perf_report(const char *name, int num, double secs)
+{
+	printf("%-16s          %10.2f keys/s\n", name, num / secs);
+}
+
+static void hmac_perf(struct perf_args *args, int sha256)
+{
+	const u8 *keys[CRYPTO_PERF_NUM_KEYS];
+	u8 *inner[CRYPTO_PERF_NUM_KEYS], *outer[CRYPTO_PERF_NUM_KEYS];
+	int key_lens[CRYPTO_PERF_NUM_KEYS];
+	int i, k;
+	u64 start;
+
+	for (k = 0; k < CRYPTO_PERF_NUM_KEYS; k++) {
+		keys[k] = perf_keys[k];
+		key_lens[k] = CRYPTO_PERF_HMAC_KEY_SIZE;
+		inner[k] = perf_inner[k];
+		outer[k] = perf_outer[k];
+	}
+
+	start = mv_time_usecs();
+	for (i = 0; i < args->iters; i++) {
+		for (k = 0; k < CRYPTO_PERF_NUM_KEYS; k++) {
+			if (sha256)
+				mv_sha256_hmac_iv(perf_keys[k], CRYPTO_PERF_HMAC_KEY_SIZE,
+						  perf_inner[k], perf_outer[k]);
+			else
+				mv_sha1_hmac_iv(perf_keys[k], CRYPTO_PERF_HMAC_KEY_SIZE,
+						perf_inner[k], perf_outer[k]);
+		}
+	}
+	hmac_perf_report(sha256 ? "hmac-sha256 iv" : "hmac-sha1 iv",
+			 CRYPTO_PERF_NUM_KEYS * args->iters, (mv_time_usecs() - start) / 1e6);
+
+	start = mv_time_usecs();
+	for (i = 0; i < args->iters; i++) {
+		if (sha256)
+			mv_sha256_mb_hmac_iv(keys, key_lens, inner, outer, CRYPTO_PERF_NUM_KEYS);
+		else
+			mv_sha1_mb_hmac_iv(keys, key_lens, inner, outer, CRYPTO_PERF_NUM_KEYS);
+	}
+	hmac_perf_report(sha256 ? "hmac-sha256 (mb)" : "hmac-sha1 (mb)",
+			 CRYPTO_PERF_NUM_KEYS * args->iters, (mv_time_usecs() - start) / 1e6);
+}
+
+/* Multi-buffer digests must match the scalar implementation */
+static int sha_mb_self_test(void)
+{
+	u8 ref[SHA256_DIGEST_LENGTH], digest[MV_SHA_MB_MAX_LANES][SHA256_DIGEST_LENGTH];
+	const u8 *data[MV_SHA_MB_MAX_LANES];
+	u8 *out[MV_SHA_MB_MAX_LANES];
+	SHA256_CTX ctx;
+	int i;
+
+	for (i = 0; i < MV_SHA_MB_MAX_LANES; i++) {
+		data[i] = perf_mb_in[i];
+		out[i] = digest[i];
+	}
+
+	mv_sha1_mb(data, 1000, out, MV_SHA_MB_MAX_LANES);
+	for (i = 0; i < MV_SHA_MB_MAX_LANES; i++) {
+		mv_sha1(perf_mb_in[i], 1000, ref);
+		if (memcmp(ref, digest[i], MV_SHA1_DIGEST_SIZE)) {
+			pr_err("SHA1 multi-buffer self test failed (lane %d)\n", i);
+			return -EFAULT;
+		}
+	}
+
+	mv_sha256_mb(data, 1000, out, MV_SHA_MB_MAX_LANES);
+	for (i = 0; i < MV_SHA_MB_MAX_LANES; i++) {
+		mv_sha256_init(&ctx);
+		mv_sha256_update(&ctx, perf_mb_in[i], 1000);
+		mv_sha256_final(ref, &ctx);
+		if (memcmp(ref, digest[i], SHA256_DIGEST_LENGTH)) {
+			pr_err("SHA256 multi-buffer self test failed (lane %d)\n", i);
+			return -EFAULT;
+		}
+	}
+
+	return 0;
+}
+
+/* FIPS-197 appendix C vectors; make sure we measure a working cipher */
+static int aes_self_test(void)
+{
+	static const u8 pt[MV_AES_BLOCK_SIZE] = {
+		0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+		0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff
+	};
+	static const u8 ct[3][MV_AES_BLOCK_SIZE] = {
+		{0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30,
+		 0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a},
+		{0xdd, 0xa9, 0x7c, 0xa4, 0x86, 0x4c, 0xdf, 0xe0,
+		 0x6e, 0xaf, 0x70, 0xa0, 0xec, 0x0d, 0x71, 0x91},
+		{0x8e, 0xa2, 0xb7, 0xca, 0x51, 0x67, 0x45, 0xbf,
+		 0xea, 0xfc, 0x49, 0x90, 0x4b, 0x49, 0x60, 0x89}
+	};
+	struct mv_aes_ctx ctx;
+	u8 key[32], buf[MV_AES_BLOCK_SIZE];
+	int i;
+
+	for (i = 0; i < sizeof(key); i++)
+		key[i] = i;
+
+	for (i = 0; i < 3; i++) {
+		mv_aes_set_key(&ctx, key, 128 + 64 * i);
+		mv_aes_encrypt(&ctx, pt, buf);
+		if (memcmp(buf, ct[i], sizeof(buf))) {
+			pr_err("AES-%d encrypt self test failed\n", 128 + 64 * i);
+			return -EFAULT;
+		}
+		mv_aes_decrypt(&ctx, buf, buf);
+		if (memcmp(buf, pt, sizeof(buf))) {
+			pr_err("AES-%d decrypt self test failed\n", 128 + 64 * i);
+			return -EFAULT;
+		}
+	}
+
+	return 0;
+}
+
+static void usage(char *progname)
+{
+	printf("\n"
+	       "Software crypto (AES, SHA1/SHA2-256) throughput benchmark\n"
+	       "\n"
+	       "Usage: %s OPTIONS\n"
+	       "\n"
+	       "Optional OPTIONS:\n"
+	       "\t-s <size>	Buffer size in bytes, multiple of 16 (default: %d)\n"
+	       "\t-n <num>	Number of iterations per test (default: %d)\n"
+	       "\t-h		Print this help\n"
+	       "\n", progname, CRYPTO_PERF_DEF_BUF_SIZE, CRYPTO_PERF_DEF_ITERS);
+}
+
+static int parse_args(struct perf_args *args, int argc, char *argv[])
+{
+	int opt;
+
+	args->buf_size = CRYPTO_PERF_DEF_BUF_SIZE;
+	args->iters = CRYPTO_PERF_DEF_ITERS;
+
+	while ((opt = getopt(argc, argv, "s:n:h")) != -1) {
+		switch (opt) {
+		case 's':
+			args->buf_size = atoi(optarg);
+			break;
+		case 'n':
+			args->iters = atoi(optarg);
+			break;
+		case 'h':
+		default:
+			usage(argv[0]);
+			return -EINVAL;
+		}
+	}
+
+	if (!args->buf_size || (args->buf_size % MV_AES_BLOCK_SIZE) ||
+	    args->buf_size > CRYPTO_PERF_MAX_BUF_SIZE) {
+		pr_err("Invalid buffer size %zu (multiple of %d, up to %d)\n",
+		       args->buf_size, MV_AES_BLOCK_SIZE, CRYPTO_PERF_MAX_BUF_SIZE);
+		return -EINVAL;
+	}
+	if (args->iters <= 0) {
+		pr_err("Invalid number of iterations %d\n", args->iters);
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	struct perf_args args;
+	u8 key[32];
+	int i, key_size, err;
+
+	printf("Marvell Armada US (Build: %s %s)\n", __DATE__, __TIME__);
+
+	err = parse_args(&args, argc, argv);
+	if (err)
+		return err;
+
+	for (i = 0; i < sizeof(key); i++)
+		key[i] = rand();
+	for (i = 0; i < args.buf_size; i++)
+		perf_in[i] = rand();
+	for (i = 0; i < sizeof(perf_mb_in); i++)
+		((u8 *)perf_mb_in)[i] = rand();
+	for (i = 0; i < sizeof(perf_keys); i++)
+		((u8 *)perf_keys)[i] = rand();
+
+	err = aes_self_test();
+	if (!err)
+		err = sha_mb_self_test();
+	if (err) {
+		printf("FAILED!\n");
+		return err;
+	}
+
+#ifdef __ARM_FEATURE_CRYPTO
+	printf("AES implementation: ARMv8 crypto extensions\n");
+#else
+	printf("AES implementation: portable T-tables\n");
+#endif
+	printf("Buffer size %zu bytes, %d iterations\n\n", args.buf_size, args.iters);
+
+	for (key_size = 128; key_size <= 256; key_size += 64) {
+		aes_perf_legacy_ecb(&args, key, key_size);
+		aes_perf_ecb(&args, key, key_size);
+		aes_perf_cbc(&args, key, key_size, 1);
+		aes_perf_cbc(&args, key, key_size, 0);
+		aes_perf_ctr(&args, key, key_size);
+		aes_perf_gcm(&args, key, key_size);
+		printf("\n");
+	}
+
+	printf("SHA multi-buffer lanes: %d\n", mv_sha_mb_lanes());
+	sha_perf_scalar(&args, 0);
+	sha_perf_mb(&args, 0);
+	sha_perf_scalar(&args, 1);
+	sha_perf_mb(&args, 1);
+	hmac_perf(&args, 0);
+	hmac_perf(&args, 1);
+
+	return 0;
+}
@@ -0,0 +1,367 @@
+/******************************************************************************
+ *	Copyright (C) 2016 Marvell International Ltd.
+ *
+ *  If you received this File from Marvell, you may opt to use, redistribute
+ *  and/or modify this File under the following licensing terms.
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *	* Redistributions of source code must retain the above copyright
+ *	  notice, this list of conditions and the following disclaimer.
+ *
+ *	* Redistributions in binary form must reproduce the above copyright
+ *	  notice, this list of conditions and the following disclaimer in the
+ *	  documentation and/or other materials provided with the distribution.
+ *
+ *	* Neither the name of Marvell nor the names of its contributors may be
+ *	  used to endorse or promote products derived from this software
+ *	  without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include <getopt.h>
+
+#include "std_internal.h"
+#include "env/mv_sys_dma.h"
+#include "lib/mv_flow_tbl.h"
+
+
+#define FLOW_PERF_DEF_ENTRIES	(1024 * 1024)
+#define FLOW_PERF_DEF_BURST	32
+#define FLOW_PERF_DEF_ITERS	(8 * 1024 * 1024)
+#define FLOW_PERF_NUM_IDX	(64 * 1024)	/* random key order, a power of 2 */
+#define FLOW_PERF_DMA_MEM_SIZE	(256 * 1024 * 1024)
+
+
+struct perf_args {
+	u32			num_entries;
+	int			burst;
+	int			iters;
+	int			ipv6;
+	enum mv_flow_tbl_mem	mem;
+};
+
+static const int perf_occupancy[] = {10, 25, 50, 75, 90, 95};
+
+static u8	*perf_keys;	/* num_entries keys to add */
+static u8	*perf_miss_keys;	/* FLOW_PERF_NUM_IDX keys never added */
+static u32	 perf_idx[FLOW_PERF_NUM_IDX];
+static u32	 perf_key_len;
+
+static inline u32 perf_rand(void)
+{
+	return ((u32)rand() << 16) ^ rand();
+}
+
+/* Unique keys: the source address/port hold the key number, the protocol
+ * tells the keys added from the missing ones
+ */
+static void perf_gen_key(u8 *key, u32 num, int ipv6, u8 proto)
+{
+	memset(key, 0, perf_key_len);
+	if (ipv6) {
+		struct mv_flow_tbl_ipv6_5tuple *k = (struct mv_flow_tbl_ipv6_5tuple *)key;
+		int i;
+
+		k->src_ip[0] = 0x20;
+		k->src_ip[1] = 0x01;
+		memcpy(&k->src_ip[12], &num, sizeof(num));
+		for (i = 0; i < 16; i++)
+			k->dst_ip[i] = rand();
+		k->src_port = rand();
+		k->dst_port = rand();
+		k->proto = proto;
+	} else {
+		struct mv_flow_tbl_ipv4_5tuple *k = (struct mv_flow_tbl_ipv4_5tuple *)key;
+
+		k->src_ip = num;
+		k->dst_ip = perf_rand();
+		k->src_port = rand();
+		k->dst_port = rand();
+		k->proto = proto;
+	}
+}
+
+static int perf_fill(struct mv_flow_tbl *tbl, u32 from, u32 to)
+{
+	u32 i;
+	int pos;
+
+	for (i = from; i < to; i++) {
+		pos = mv_flow_tbl_add(tbl, perf_keys + (u64)i * perf_key_len, i);
+		if (pos < 0)
+			return pos;
+	}
+	return 0;
+}
+
+static double perf_bulk(struct perf_args *args, struct mv_flow_tbl *tbl, u8 *keys, u32 num_keys, int exp_hit)
+{
+	const void *burst[MV_FLOW_TBL_MAX_BURST];
+	u64 data[MV_FLOW_TBL_MAX_BURST], hits, all;
+	u32 i, j, n = 0, errs = 0;
+	u64 start;
+
+	all = (args->burst == 64) ? ~0ULL : (1ULL << args->burst) - 1;
+	start = mv_time_usecs();
+	for (i = 0; i < args->iters; i += args->burst) {
+		for (j = 0; j < args->burst; j++, n++)
+			burst[j] = keys + (u64)(perf_idx[n & (FLOW_PERF_NUM_IDX - 1)] % num_keys) * perf_key_len;
+		hits = mv_flow_tbl_lookup_bulk(tbl, burst, args->burst, NULL, data);
+		if (unlikely(hits != (exp_hit ? all : 0)))
+			errs++;
+	}
+	start = mv_time_usecs() - start;
+	if (errs)
+		pr_err("%u bursts with unexpected lookup results!\n", errs);
+	return (double)args->iters / start;
+}
+
+static double perf_single(struct perf_args *args, struct mv_flow_tbl *tbl, u32 num_keys)
+{
+	u32 i, errs = 0;
+	u64 data;
+	u64 start;
+
+	start = mv_time_usecs();
+	for (i = 0; i < args->iters; i++)
+		if (unlikely(mv_flow_tbl_lookup(tbl, perf_keys +
+						(u64)(perf_idx[i & (FLOW_PERF_NUM_IDX - 1)] % num_keys) * perf_key_len,
+						&data) < 0))
+			errs++;
+	start = mv_time_usecs() - start;
+	if (errs)
+		pr_err("%u unexpected lookup misses!\n", errs);
+	return (double)args->iters / start;
+}
+
+/* Add, lookup, delete and re-add; the table must return what was added */
+static int flow_tbl_self_test(struct perf_args *args)
+{
+	struct mv_flow_tbl_params params;
+	struct mv_flow_tbl *tbl;
+	const void *key;
+	u32 i, num = args->num_entries / 2;
+	u64 data;
+	int pos, err = 0;
+
+	memset(&params, 0, sizeof(params));
+	params.num_entries = args->num_entries;
+	params.key_len = perf_key_len;
+	params.mem = args->mem;
+	if (mv_flow_tbl_create(&params, &tbl))
+		return -ENOMEM;
+
+	if (perf_fill(tbl, 0, num)) {
+		pr_err("flow table self test: add failed below 50%% occupancy\n");
+		err = -EFAULT;
+		goto out;
+	}
+	for (i = 0; i < num && !err; i++) {
+		pos = mv_flow_tbl_lookup(tbl, perf_keys + (u64)i * perf_key_len, &data);
+		if (pos < 0 || data != i || mv_flow_tbl_get_key(tbl, pos, &key, NULL) ||
+		    memcmp(key, perf_keys + (u64)i * perf_key_len, perf_key_len))
+			err = -EFAULT;
+	}
+	for (i = 0; i < num && !err; i += 2)
+		if (mv_flow_tbl_del(tbl, perf_keys + (u64)i * perf_key_len) < 0)
+			err = -EFAULT;
+	for (i = 0; i < num && !err; i++)
+		if ((mv_flow_tbl_lookup(tbl, perf_keys + (u64)i * perf_key_len, NULL) < 0) != !(i & 1))
+			err = -EFAULT;
+	if (!err && mv_flow_tbl_lookup(tbl, perf_miss_keys, NULL) >= 0)
+		err = -EFAULT;
+	mv_flow_tbl_reclaim(tbl);
+	if (!err && perf_fill(tbl, num, args->num_entries * 3 / 4))
+		err = -EFAULT;
+	if (err)
+		pr_err("flow table self test failed (key %u)\n", i);
+
+out:
+	mv_flow_tbl_destroy(tbl);
+	return err;
+}
+
+static int flow_tbl_perf(struct perf_args *args)
+{
+	struct mv_flow_tbl_params params;
+	struct mv_flow_tbl_stats stats;
+	struct mv_flow_tbl *tbl;
+	u32 num = 0, target;
+	int i, err;
+
+	memset(&params, 0, sizeof(params));
+	params.num_entries = args->num_entries;
+	params.key_len = perf_key_len;
+	params.mem = args->mem;
+	err = mv_flow_tbl_create(&params, &tbl);
+	if (err)
+		return err;
+
+	mv_flow_tbl_get_stats(tbl, &stats);
+	printf("%u entries, %u buckets, %u byte keys, %lu KB, burst %d\n", stats.max_entries,
+	       stats.num_buckets, perf_key_len, stats.mem_size / 1024, args->burst);
+	printf("occupancy  bulk hit (Mlookups/s)  single hit  bulk miss\n");
+
+	for (i = 0; i < ARRAY_SIZE(perf_occupancy); i++) {
+		target = (u64)args->num_entries * perf_occupancy[i] / 100;
+		if (!target)
+			continue;
+		err = perf_fill(tbl, num, target);
+		if (err) {
+			pr_err("add failed at %u entries\n", num);
+			break;
+		}
+		num = target;
+		printf("%8d%%  %21.2f  %10.2f  %9.2f\n", perf_occupancy[i],
+		       perf_bulk(args, tbl, perf_keys, num, 1), perf_single(args, tbl, num),
+		       perf_bulk(args, tbl, perf_miss_keys, FLOW_PERF_NUM_IDX, 0));
+	}
+
+	mv_flow_tbl_get_stats(tbl, &stats);
+	printf("adds %lu, moves %lu, add fails %lu\n", stats.adds, stats.add_moves, stats.add_fails);
+
+	mv_flow_tbl_destroy(tbl);
+	return err;
+}
+
+static void usage(char *progname)
+{
+	printf("\n"
+	       "Flow table lookup rate against occupancy benchmark\n"
+	       "\n"
+	       "Usage: %s OPTIONS\n"
+	       "\n"
+	       "Optional OPTIONS:\n"
+	       "\t-e <num>	Table size in entries (default: %d)\n"
+	       "\t-b <num>	Lookup burst size, up to %d (default: %d)\n"
+	       "\t-n <num>	Number of lookups per test (default: %d)\n"
+	       "\t-m <mem>	Table memory: heap, dma or huge (default: heap)\n"
+	       "\t-6		IPv6 5-tuple keys (default: IPv4)\n"
+	       "\t-h		Print this help\n"
+	       "\n", progname, FLOW_PERF_DEF_ENTRIES, MV_FLOW_TBL_MAX_BURST, FLOW_PERF_DEF_BURST,
+	       FLOW_PERF_DEF_ITERS);
+}
+
+static int parse_args(struct perf_args *args, int argc, char *argv[])
+{
+	int opt;
+
+	args->num_entries = FLOW_PERF_DEF_ENTRIES;
+	args->burst = FLOW_PERF_DEF_BURST;
+	args->iters = FLOW_PERF_DEF_ITERS;
+	args->ipv6 = 0;
+	args->mem = MV_FLOW_TBL_MEM_HEAP;
+
+	while ((opt = getopt(argc, argv, "e:b:n:m:6h")) != -1) {
+		switch (opt) {
+		case 'e':
+			args->num_entries = atoi(optarg);
+			break;
+		case 'b':
+			args->burst = atoi(optarg);
+			break;
+		case 'n':
+			args->iters = atoi(optarg);
+			break;
+		case 'm':
+			if (!strcmp(optarg, "heap")) {
+				args->mem = MV_FLOW_TBL_MEM_HEAP;
+			} else if (!strcmp(optarg, "dma")) {
+				args->mem = MV_FLOW_TBL_MEM_DMA;
+			} else if (!strcmp(optarg, "huge")) {
+				args->mem = MV_FLOW_TBL_MEM_HUGEPAGE;
+			} else {
+				pr_err("Invalid memory type %s\n", optarg);
+				return -EINVAL;
+			}
+			break;
+		case '6':
+			args->ipv6 = 1;
+			break;
+		case 'h':
+		default:
+			usage(argv[0]);
+			return -EINVAL;
+		}
+	}
+
+	if (args->num_entries < 16) {
+		pr_err("Invalid table size %u\n", args->num_entries);
+		return -EINVAL;
+	}
+	if (args->burst <= 0 || args->burst > MV_FLOW_TBL_MAX_BURST) {
+		pr_err("Invalid burst size %d (up to %d)\n", args->burst, MV_FLOW_TBL_MAX_BURST);
+		return -EINVAL;
+	}
+	if (args->iters <= 0) {
+		pr_err("Invalid number of lookups %d\n", args->iters);
+		return -EINVAL;
+	}
+	/* Whole bursts */
+	args->iters -= args->iters % args->burst;
+	if (!args->iters)
+		args->iters = args->burst;
+
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	struct perf_args args;
+	u32 i;
+	int err;
+
+	printf("Marvell Armada US (Build: %s %s)\n", __DATE__, __TIME__);
+
+	err = parse_args(&args, argc, argv);
+	if (err)
+		return err;
+
+	if (args.mem == MV_FLOW_TBL_MEM_DMA) {
+		err = mv_sys_dma_mem_init(FLOW_PERF_DMA_MEM_SIZE);
+		if (err) {
+			pr_err("DMA memory init failed (%d)\n", err);
+			return err;
+		}
+	}
+
+	perf_key_len = args.ipv6 ? sizeof(struct mv_flow_tbl_ipv6_5tuple) : sizeof(struct mv_flow_tbl_ipv4_5tuple);
+	perf_keys = malloc((u64)args.num_entries * perf_key_len);
+	perf_miss_keys = malloc((u64)FLOW_PERF_NUM_IDX * perf_key_len);
+	if (!perf_keys || !perf_miss_keys) {
+		pr_err("no mem for %u keys!\n", args.num_entries);
+		err = -ENOMEM;
+		goto out;
+	}
+	for (i = 0; i < args.num_entries; i++)
+		perf_gen_key(perf_keys + (u64)i * perf_key_len, i, args.ipv6, IPPROTO_UDP);
+	for (i = 0; i < FLOW_PERF_NUM_IDX; i++) {
+		perf_gen_key(perf_miss_keys + (u64)i * perf_key_len, i, args.ipv6, IPPROTO_TCP);
+		perf_idx[i] = perf_rand();
+	}
+
+	err = flow_tbl_self_test(&args);
+	if (!err)
+		err = flow_tbl_perf(&args);
+	if (err)
+		printf("FAILED!\n");
+
+out:
+	free(perf_keys);
+	free(perf_miss_keys);
+	if (args.mem == MV_FLOW_TBL_MEM_DMA)
+		mv_sys_dma_mem_destroy();
+	return err;
+}
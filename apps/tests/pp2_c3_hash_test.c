@@ -0,0 +1,311 @@
+/******************************************************************************
+ *	Copyright (C) 2016 Marvell International Ltd.
+ *
+ *  If you received this File from Marvell, you may opt to use, redistribute
+ *  and/or modify this File under the following licensing terms.
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *	* Redistributions of source code must retain the above copyright
+ *	  notice, this list of conditions and the following disclaimer.
+ *
+ *	* Redistributions in binary form must reproduce the above copyright
+ *	  notice, this list of conditions and the following disclaimer in the
+ *	  documentation and/or other materials provided with the distribution.
+ *
+ *	* Neither the name of Marvell nor the names of its contributors may be
+ *	  used to endorse or promote products derived from this software
+ *	  without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+/*
+ * Test of the C3 multihash placement planner (cls/pp2_c3_hash.c).
+ * The planner only works on its software model, so no HW is needed: keys with
+ * random candidate entries are added until the table is full, with random
+ * deletes in between, and every plan is replayed on a reference copy of the
+ * table to check that it is valid.
+ */
+
+#include <getopt.h>
+#include <time.h>
+
+#include "std_internal.h"
+#include "drivers/ppv2/pp2_types.h"
+#include "drivers/ppv2/pp2.h"
+#include "drivers/ppv2/pp2_hw_type.h"
+#include "drivers/ppv2/pp2_hw_cls.h"
+
+
+#define C3_TEST_DEF_ROUNDS	20
+#define C3_TEST_BANK_SIZE	(MVPP2_CLS_C3_HASH_TBL_SIZE / MVPP2_CLS3_HASH_BANKS_NUM)
+
+
+struct test_args {
+	int	rounds;
+	u32	depth;
+	u32	seed;
+};
+
+static struct pp2_cls_c3_hash_shadow	test_shadow;
+static struct pp2_cls_c3_hash_shadow	test_saved;
+/* reference table, candidate entries of the key each entry holds */
+static u16 test_ref[MVPP2_CLS_C3_HASH_TBL_SIZE][MVPP2_CLS3_HASH_BANKS_NUM];
+static u8  test_ref_valid[MVPP2_CLS_C3_HASH_TBL_SIZE];
+
+static void test_key_gen(u16 hash_idx[MVPP2_CLS3_HASH_BANKS_NUM])
+{
+	int bank;
+
+	/* as the HW query, one candidate per bank */
+	for (bank = 0; bank < MVPP2_CLS3_HASH_BANKS_NUM; bank++)
+		hash_idx[bank] = bank * C3_TEST_BANK_SIZE + rand() % C3_TEST_BANK_SIZE;
+}
+
+static int test_is_cand(const u16 hash_idx[MVPP2_CLS3_HASH_BANKS_NUM], u32 idx)
+{
+	int bank;
+
+	for (bank = 0; bank < MVPP2_CLS3_HASH_BANKS_NUM; bank++)
+		if (hash_idx[bank] == idx)
+			return 1;
+	return 0;
+}
+
+/* Replay a plan on the reference table: every relocation moves a key to one of
+ * its own candidates, into an entry that is free at that time, and the new key
+ * lands on one of its candidates that is then free.
+ */
+static int test_plan_apply(const u16 hash_idx[MVPP2_CLS3_HASH_BANKS_NUM], u32 idx,
+			   struct pp2_cls_c3_hash_pair *pairs, u32 depth)
+{
+	u32 old_idx, new_idx;
+	int i;
+
+	if (pairs->pair_num > depth) {
+		pr_err("plan relocates %d keys, depth is %d\n", pairs->pair_num, depth);
+		return -EFAULT;
+	}
+
+	for (i = 0; i < pairs->pair_num; i++) {
+		old_idx = pairs->old_idx[i];
+		new_idx = pairs->new_idx[i];
+		if (old_idx >= MVPP2_CLS_C3_HASH_TBL_SIZE || new_idx >= MVPP2_CLS_C3_HASH_TBL_SIZE) {
+			pr_err("relocation %d out of range (0x%x -> 0x%x)\n", i, old_idx, new_idx);
+			return -EFAULT;
+		}
+		if (!test_ref_valid[old_idx] || test_ref_valid[new_idx]) {
+			pr_err("relocation %d from %s entry 0x%x to %s entry 0x%x\n", i,
+			       test_ref_valid[old_idx] ? "used" : "free", old_idx,
+			       test_ref_valid[new_idx] ? "used" : "free", new_idx);
+			return -EFAULT;
+		}
+		if (!test_is_cand(test_ref[old_idx], new_idx)) {
+			pr_err("relocation %d to 0x%x, not a candidate of the key\n", i, new_idx);
+			return -EFAULT;
+		}
+		memcpy(test_ref[new_idx], test_ref[old_idx], sizeof(test_ref[new_idx]));
+		test_ref_valid[new_idx] = 1;
+		test_ref_valid[old_idx] = 0;
+	}
+
+	if (!test_is_cand(hash_idx, idx) || test_ref_valid[idx]) {
+		pr_err("new key placed at %s entry 0x%x%s\n", test_ref_valid[idx] ? "used" : "free", idx,
+		       test_is_cand(hash_idx, idx) ? "" : ", not a candidate");
+		return -EFAULT;
+	}
+	memcpy(test_ref[idx], hash_idx, sizeof(test_ref[idx]));
+	test_ref_valid[idx] = 1;
+	return 0;
+}
+
+/* The model must match the reference table entry by entry */
+static int test_model_check(void)
+{
+	u32 idx, num = 0;
+
+	for (idx = 0; idx < MVPP2_CLS_C3_HASH_TBL_SIZE; idx++) {
+		if (!test_shadow.tbl[idx].valid != !test_ref_valid[idx]) {
+			pr_err("model entry 0x%x is %s, expected %s\n", idx,
+			       test_shadow.tbl[idx].valid ? "used" : "free", test_ref_valid[idx] ? "used" : "free");
+			return -EFAULT;
+		}
+		if (!test_ref_valid[idx])
+			continue;
+		num++;
+		if (memcmp(test_shadow.tbl[idx].hash_idx, test_ref[idx], sizeof(test_ref[idx]))) {
+			pr_err("model entry 0x%x holds another key\n", idx);
+			return -EFAULT;
+		}
+	}
+	if (pp2_cls_c3_hash_shadow_occupancy_get(&test_shadow, NULL) != num) {
+		pr_err("model counts %d entries, %d used\n",
+		       pp2_cls_c3_hash_shadow_occupancy_get(&test_shadow, NULL), num);
+		return -EFAULT;
+	}
+	return 0;
+}
+
+static int test_key_add(u32 depth, int *full)
+{
+	struct pp2_cls_c3_hash_pair pairs;
+	u16 hash_idx[MVPP2_CLS3_HASH_BANKS_NUM];
+	u32 idx;
+	int rc;
+
+	test_key_gen(hash_idx);
+	memcpy(&test_saved, &test_shadow, sizeof(test_saved));
+
+	rc = pp2_cls_c3_hash_shadow_plan(&test_shadow, hash_idx, depth, &idx, &pairs);
+	if (rc == -ENOSPC) {
+		/* a failed plan leaves the model and its counters as they were */
+		if (memcmp(test_saved.tbl, test_shadow.tbl, sizeof(test_shadow.tbl)) ||
+		    test_saved.num_entries != test_shadow.num_entries ||
+		    test_saved.num_full != test_shadow.num_full) {
+			pr_err("failed plan changed the model\n");
+			return -EFAULT;
+		}
+		/* counted by the caller, as the driver does */
+		test_shadow.num_full++;
+		*full = 1;
+		return 0;
+	}
+	if (rc) {
+		pr_err("plan failed (%d)\n", rc);
+		return rc;
+	}
+
+	rc = test_plan_apply(hash_idx, idx, &pairs, depth);
+	if (rc)
+		return rc;
+	return pp2_cls_c3_hash_shadow_commit(&test_shadow, hash_idx, idx, &pairs);
+}
+
+static int test_key_del(void)
+{
+	u32 idx;
+
+	do {
+		idx = rand() % MVPP2_CLS_C3_HASH_TBL_SIZE;
+	} while (!test_ref_valid[idx]);
+
+	test_ref_valid[idx] = 0;
+	return pp2_cls_c3_hash_shadow_del(&test_shadow, idx);
+}
+
+static int test_round(struct test_args *args, int round)
+{
+	u32 num, first_full = 0, max_num = 0;
+	int full = 0, i, rc;
+
+	pp2_cls_c3_hash_shadow_init(&test_shadow);
+	memset(test_ref_valid, 0, sizeof(test_ref_valid));
+
+	/* fill, then churn at the fill level with deletes and adds */
+	for (i = 0; !full || i < 4 * MVPP2_CLS_C3_HASH_TBL_SIZE; i++) {
+		num = pp2_cls_c3_hash_shadow_occupancy_get(&test_shadow, NULL);
+		if (full && num && rand() % 2)
+			rc = test_key_del();
+		else
+			rc = test_key_add(args->depth, &full);
+		if (!rc)
+			rc = test_model_check();
+		if (rc) {
+			pr_err("round %d, operation %d failed\n", round, i);
+			return rc;
+		}
+		num = pp2_cls_c3_hash_shadow_occupancy_get(&test_shadow, NULL);
+		if (full && !first_full)
+			first_full = num;
+		if (num > max_num)
+			max_num = num;
+	}
+
+	printf("round %2d: first full at %4d, max %4d of %d entries, %d inserts, %d relocations, %d full\n",
+	       round, first_full, max_num, MVPP2_CLS_C3_HASH_TBL_SIZE, test_shadow.num_inserts,
+	       test_shadow.num_relocations, test_shadow.num_full);
+	return 0;
+}
+
+static void usage(char *progname)
+{
+	printf("\n"
+	       "C3 multihash placement planner test\n"
+	       "\n"
+	       "Usage: %s OPTIONS\n"
+	       "\n"
+	       "Optional OPTIONS:\n"
+	       "\t-n <num>	Number of rounds (default: %d)\n"
+	       "\t-d <num>	Max relocations per add, up to %d (default: %d)\n"
+	       "\t-s <num>	Random seed (default: time)\n"
+	       "\t-h		Print this help\n"
+	       "\n", progname, C3_TEST_DEF_ROUNDS, MVPP2_CLS_C3_MAX_SEARCH_DEPTH, MVPP2_CLS_C3_MAX_SEARCH_DEPTH);
+}
+
+static int parse_args(struct test_args *args, int argc, char *argv[])
+{
+	int opt;
+
+	args->rounds = C3_TEST_DEF_ROUNDS;
+	args->depth = MVPP2_CLS_C3_MAX_SEARCH_DEPTH;
+	args->seed = time(NULL);
+
+	while ((opt = getopt(argc, argv, "n:d:s:h")) != -1) {
+		switch (opt) {
+		case 'n':
+			args->rounds = atoi(optarg);
+			break;
+		case 'd':
+			args->depth = atoi(optarg);
+			break;
+		case 's':
+			args->seed = strtoul(optarg, NULL, 0);
+			break;
+		case 'h':
+		default:
+			usage(argv[0]);
+			return -EINVAL;
+		}
+	}
+
+	if (args->rounds <= 0) {
+		pr_err("Invalid number of rounds %d\n", args->rounds);
+		return -EINVAL;
+	}
+	if (args->depth > MVPP2_CLS_C3_MAX_SEARCH_DEPTH) {
+		pr_err("Invalid depth %d (up to %d)\n", args->depth, MVPP2_CLS_C3_MAX_SEARCH_DEPTH);
+		return -EINVAL;
+	}
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	struct test_args args;
+	int err = 0, i;
+
+	printf("Marvell Armada US (Build: %s %s)\n", __DATE__, __TIME__);
+
+	err = parse_args(&args, argc, argv);
+	if (err)
+		return err;
+
+	printf("seed %u, depth %d\n", args.seed, args.depth);
+	srand(args.seed);
+	for (i = 0; i < args.rounds && !err; i++)
+		err = test_round(&args, i);
+
+	printf("%s\n", err ? "FAILED!" : "PASSED");
+	return err;
+}
@@ -0,0 +1,441 @@
+/******************************************************************************
+ *	Copyright (C) 2016 Marvell International Ltd.
+ *
+ *  If you received this File from Marvell, you may opt to use, redistribute
+ *  and/or modify this File under the following licensing terms.
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *	* Redistributions of source code must retain the above copyright
+ *	  notice, this list of conditions and the following disclaimer.
+ *
+ *	* Redistributions in binary form must reproduce the above copyright
+ *	  notice, this list of conditions and the following disclaimer in the
+ *	  documentation and/or other materials provided with the distribution.
+ *
+ *	* Neither the name of Marvell nor the names of its contributors may be
+ *	  used to endorse or promote products derived from this software
+ *	  without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+/*
+ * Host test of the parser and classifier software model (cls/pp2_cls_model.c).
+ * The model has no HW access, so this program runs on any host:
+ * - without options it builds small parser, lookup decode, flow and C3 tables
+ *   in software, runs packets through them and checks the results, and checks
+ *   the model file save/load;
+ * - with -l it loads a model file saved on target by "cls_model_run -s" and
+ *   runs a packet through it, to check a rule set without a board.
+ */
+
+#include <getopt.h>
+
+#include "std_internal.h"
+#include "drivers/ppv2/pp2_types.h"
+#include "drivers/ppv2/pp2.h"
+#include "drivers/ppv2/pp2_hw_type.h"
+#include "drivers/ppv2/pp2_hw_cls.h"
+#include "drivers/ppv2/cls/pp2_prs.h"
+#include "drivers/ppv2/cls/pp2_cls_model.h"
+
+
+#define MODEL_TEST_MAX_PKT	1536
+#define MODEL_TEST_PORT		0
+#define MODEL_TEST_LU_L2	0
+#define MODEL_TEST_LU_L3	1
+#define MODEL_TEST_LKPID_IP4	5
+#define MODEL_TEST_LKPID_ARP	6
+#define MODEL_TEST_LKP_TYPE	2
+#define MODEL_TEST_FLOW		10
+#define MODEL_TEST_RXQ		3
+#define MODEL_TEST_MISS_Q	5
+#define MODEL_TEST_HIT_Q	6
+#define MODEL_TEST_ETH_P_IP	0x0800
+#define MODEL_TEST_ETH_P_ARP	0x0806
+#define MODEL_TEST_ETH_P_IPV6	0x86dd
+
+
+struct test_args {
+	char	*model_file;
+	u32	port;
+	char	*hex_pkt;
+};
+
+static struct pp2_cls_model	test_model;
+static struct pp2_cls_model	test_loaded;
+
+/* MH, DA, SA, ARP request for 10.0.0.1 */
+static const u8 test_arp_pkt[] = {
+	0x00, 0x00,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00, 0x50, 0x43, 0x00, 0x00, 0x01,
+	0x08, 0x06,
+	0x00, 0x01, 0x08, 0x00, 0x06, 0x04, 0x00, 0x01,
+	0x00, 0x50, 0x43, 0x00, 0x00, 0x01, 0x0a, 0x00, 0x00, 0x02,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0a, 0x00, 0x00, 0x01,
+};
+static const u8 test_arp_tpa[IPV4_ADDR_SIZE] = {0x0a, 0x00, 0x00, 0x01};
+
+/* Write bits of the parser SRAM, as the driver SRAM helpers of pp2_prs.c */
+static void test_prs_sram_bits_set(struct mv_pp2x_prs_entry *pe, u32 bit_num, u32 num, u32 val)
+{
+	u32 i;
+
+	for (i = 0; i < num; i++) {
+		if (val & BIT(i))
+			pe->sram.byte[SRAM_BIT_TO_BYTE(bit_num + i)] |= BIT((bit_num + i) % BYTE_BITS);
+		else
+			pe->sram.byte[SRAM_BIT_TO_BYTE(bit_num + i)] &= ~BIT((bit_num + i) % BYTE_BITS);
+	}
+}
+
+/* Set a valid parser entry on all ports, matching a lookup ID and an ethertype at the current offset */
+static struct mv_pp2x_prs_entry *test_prs_entry_set(u32 tid, u32 lu, u16 eth_type, u16 eth_type_mask)
+{
+	struct mv_pp2x_prs_entry *pe = &test_model.prs[tid];
+
+	memset(pe, 0, sizeof(*pe));
+	pe->index = tid;
+	pe->tcam.byte[HW_BYTE_OFFS(MVPP2_PRS_TCAM_LU_BYTE)] = lu;
+	pe->tcam.byte[HW_BYTE_OFFS(MVPP2_PRS_TCAM_EN_OFFS(MVPP2_PRS_TCAM_LU_BYTE))] = MVPP2_PRS_LU_MASK;
+	pe->tcam.byte[TCAM_DATA_BYTE(0)] = eth_type >> BYTE_BITS;
+	pe->tcam.byte[TCAM_DATA_MASK(0)] = eth_type_mask >> BYTE_BITS;
+	pe->tcam.byte[TCAM_DATA_BYTE(1)] = eth_type & BYTE_MASK;
+	pe->tcam.byte[TCAM_DATA_MASK(1)] = eth_type_mask & BYTE_MASK;
+
+	return pe;
+}
+
+/* Set a lookup done parser entry: flow ID, result info and L3 offset */
+static void test_prs_done_set(struct mv_pp2x_prs_entry *pe, u32 lkpid, u32 ri, u32 ri_mask, u32 l3_offs)
+{
+	test_prs_sram_bits_set(pe, MVPP2_PRS_SRAM_AI_OFFS, MVPP2_PRS_AI_BITS, lkpid);
+	test_prs_sram_bits_set(pe, MVPP2_PRS_SRAM_AI_CTRL_OFFS, MVPP2_PRS_SRAM_AI_CTRL_BITS,
+			       MVPP2_PRS_FLOW_ID_MASK);
+	pe->sram.word[MVPP2_PRS_SRAM_RI_WORD] = ri;
+	pe->sram.word[MVPP2_PRS_SRAM_RI_CTRL_WORD] = ri_mask;
+	test_prs_sram_bits_set(pe, MVPP2_PRS_SRAM_UDF_TYPE_OFFS, 3, MVPP2_PRS_SRAM_UDF_TYPE_L3);
+	test_prs_sram_bits_set(pe, MVPP2_PRS_SRAM_UDF_OFFS, MVPP2_PRS_SRAM_UDF_BITS, l3_offs);
+	test_prs_sram_bits_set(pe, MVPP2_PRS_SRAM_LU_DONE_BIT, 1, 1);
+}
+
+/* Set a parser entry that shifts the offset and goes on with the next lookup */
+static void test_prs_next_set(struct mv_pp2x_prs_entry *pe, u32 next_lu, u32 shift)
+{
+	test_prs_sram_bits_set(pe, MVPP2_PRS_SRAM_SHIFT_OFFS, MVPP2_PRS_SRAM_SHIFT_BITS, shift);
+	test_prs_sram_bits_set(pe, MVPP2_PRS_SRAM_NEXT_LU_OFFS, 4, next_lu);
+}
+
+/*
+ * Tables of the self test:
+ * - parser: L2 entry skipping MH/DA/SA, L3 entries for IPv4 (lookup done, flow ID
+ *   5), ARP (lookup done, flow ID 6) and IPv6 (loops on the L3 lookup);
+ * - lookup decode: flow ID 5 disabled with a default queue, flow ID 6 enabled on
+ *   one C3 flow entry keyed by the ARP target address;
+ * - C3: one entry for 10.0.0.1 and a miss action.
+ */
+static int test_tables_build(void)
+{
+	struct mv_pp2x_prs_entry *pe;
+	struct mv_pp2x_cls_lookup_entry *lkp;
+	struct mv_pp2x_cls_flow_entry *fe;
+	struct pp2_cls_c3_entry *c3;
+	int rc = 0, i;
+
+	pp2_cls_model_init(&test_model);
+	test_model.port[MODEL_TEST_PORT].prs_lu = MODEL_TEST_LU_L2;
+	test_model.port[MODEL_TEST_PORT].prs_max_loop = 4;
+
+	pe = test_prs_entry_set(0, MODEL_TEST_LU_L2, 0, 0);
+	test_prs_next_set(pe, MODEL_TEST_LU_L3, PP2_MH_SIZE + 2 * ETH_ALEN);
+	pe = test_prs_entry_set(1, MODEL_TEST_LU_L3, MODEL_TEST_ETH_P_IP, 0xffff);
+	test_prs_done_set(pe, MODEL_TEST_LKPID_IP4, MVPP2_PRS_RI_L3_IP4, MVPP2_PRS_RI_L3_PROTO_MASK,
+			  MVPP2_ETH_TYPE_LEN);
+	pe = test_prs_entry_set(2, MODEL_TEST_LU_L3, MODEL_TEST_ETH_P_ARP, 0xffff);
+	test_prs_done_set(pe, MODEL_TEST_LKPID_ARP, MVPP2_PRS_RI_L3_ARP, MVPP2_PRS_RI_L3_PROTO_MASK,
+			  MVPP2_ETH_TYPE_LEN);
+	pe = test_prs_entry_set(3, MODEL_TEST_LU_L3, MODEL_TEST_ETH_P_IPV6, 0xffff);
+	test_prs_next_set(pe, MODEL_TEST_LU_L3, 0);
+
+	lkp = &test_model.lkp[MODEL_TEST_LKPID_IP4][test_model.port[MODEL_TEST_PORT].lkp_way];
+	rc |= mv_pp2x_cls_sw_lkp_rxq_set(lkp, MODEL_TEST_RXQ);
+	lkp = &test_model.lkp[MODEL_TEST_LKPID_ARP][test_model.port[MODEL_TEST_PORT].lkp_way];
+	rc |= mv_pp2x_cls_sw_lkp_rxq_set(lkp, MODEL_TEST_RXQ);
+	rc |= mv_pp2x_cls_sw_lkp_flow_set(lkp, MODEL_TEST_FLOW);
+	rc |= mv_pp2x_cls_sw_lkp_en_set(lkp, 1);
+
+	fe = &test_model.flow[MODEL_TEST_FLOW];
+	mv_pp2x_cls_sw_flow_clear(fe);
+	rc |= mv_pp2x_cls_sw_flow_port_set(fe, MVPP2_SRC_PORT_TYPE_PHY, BIT(MODEL_TEST_PORT));
+	rc |= mv_pp2x_cls_sw_flow_extra_set(fe, MODEL_TEST_LKP_TYPE, 0);
+	rc |= mv_pp2x_cls_sw_flow_hek_num_set(fe, 1);
+	rc |= mv_pp2x_cls_sw_flow_hek_set(fe, 0, ARP_IPV4_DA_FIELD_ID);
+	rc |= mv_pp2x_cls_sw_flow_engine_set(fe, MVPP2_CLS_ENGINE_C3A, 1);
+
+	c3 = &test_model.c3_miss[MODEL_TEST_LKP_TYPE];
+	pp2_cls_c3_sw_clear(c3);
+	rc |= pp2_cls_c3_queue_low_set(c3, MVPP2_ACTION_TYPE_UPDT, MODEL_TEST_MISS_Q);
+
+	c3 = &test_model.c3[0];
+	pp2_cls_c3_sw_clear(c3);
+	rc |= pp2_cls_c3_sw_lkp_type_set(c3, MODEL_TEST_LKP_TYPE);
+	rc |= pp2_cls_c3_sw_port_id_set(c3, MVPP2_SRC_PORT_TYPE_PHY, BIT(MODEL_TEST_PORT));
+	rc |= pp2_cls_c3_sw_hek_size_set(c3, IPV4_ADDR_SIZE);
+	for (i = 0; i < IPV4_ADDR_SIZE; i++)
+		rc |= pp2_cls_c3_sw_hek_byte_set(c3, MVPP2_C3_MAX_HASH_KEY_SIZE - 1 - i, test_arp_tpa[i]);
+	rc |= pp2_cls_c3_queue_low_set(c3, MVPP2_ACTION_TYPE_UPDT_LOCK, MODEL_TEST_HIT_Q);
+	rc |= pp2_cls_c3_flow_id_en(c3, 1);
+
+	if (rc) {
+		pr_err("failed to build the test tables\n");
+		return -EINVAL;
+	}
+	return 0;
+}
+
+static int test_check(const char *name, struct pp2_cls_model_res *res, u32 flags, int prs_tid, u16 queue,
+		      int c3_idx)
+{
+	if (res->flags != flags || res->prs_tid != prs_tid || res->queue != queue || res->c3_idx != c3_idx) {
+		pr_err("%s: flags 0x%x, prs_tid %d, queue %d, c3_idx %d (expected 0x%x, %d, %d, %d)\n",
+		       name, res->flags, res->prs_tid, res->queue, res->c3_idx, flags, prs_tid, queue, c3_idx);
+		return -EFAULT;
+	}
+	printf("%-24s passed\n", name);
+	return 0;
+}
+
+static int test_run(struct pp2_cls_model *model, const char *name, const u8 *pkt, u32 len, u32 flags,
+		    int prs_tid, u16 queue, int c3_idx)
+{
+	struct pp2_cls_model_res res;
+	int rc;
+
+	rc = pp2_cls_model_run(model, MODEL_TEST_PORT, pkt, len, &res);
+	if (rc) {
+		pr_err("%s: model run failed (%d)\n", name, rc);
+		return rc;
+	}
+	return test_check(name, &res, flags, prs_tid, queue, c3_idx);
+}
+
+static int test_self(void)
+{
+	struct pp2_cls_model_res res;
+	u8 pkt[sizeof(test_arp_pkt)];
+	char path[] = "/tmp/pp2_cls_model_XXXXXX";
+	int fd, rc;
+
+	memcpy(pkt, test_arp_pkt, sizeof(pkt));
+
+	/* an empty model has no parser entry */
+	pp2_cls_model_init(&test_model);
+	rc = test_run(&test_model, "empty model", pkt, sizeof(pkt), PP2_CLS_MODEL_F_PRS_MISS, -1, 0, -1);
+	if (rc)
+		return rc;
+
+	rc = test_tables_build();
+	if (rc)
+		return rc;
+
+	/* C3 hit, the queue is locked by the entry */
+	rc = test_run(&test_model, "C3 hit", pkt, sizeof(pkt), PP2_CLS_MODEL_F_FLOW_ID, 2, MODEL_TEST_HIT_Q, 0);
+	if (rc)
+		return rc;
+	rc = pp2_cls_model_run(&test_model, MODEL_TEST_PORT, pkt, sizeof(pkt), &res);
+	if (rc || res.lkpid != MODEL_TEST_LKPID_ARP || res.num_lookups != 2 ||
+	    res.l3_offs != PP2_MH_SIZE + 2 * ETH_ALEN + MVPP2_ETH_TYPE_LEN ||
+	    (res.ri & MVPP2_PRS_RI_L3_PROTO_MASK) != MVPP2_PRS_RI_L3_ARP || res.num_engines != 1) {
+		pr_err("parser result: lkpid %d, lookups %d, l3_offs %d, ri 0x%x, engines %d\n",
+		       res.lkpid, res.num_lookups, res.l3_offs, res.ri, res.num_engines);
+		return -EFAULT;
+	}
+
+	/* other target address, C3 miss action */
+	pkt[sizeof(pkt) - 1] = 0x02;
+	rc = test_run(&test_model, "C3 miss", pkt, sizeof(pkt), 0, 2, MODEL_TEST_MISS_Q, -1);
+	if (rc)
+		return rc;
+
+	/* IPv4: lookup decode entry disabled, default queue */
+	pkt[PP2_MH_SIZE + 2 * ETH_ALEN + 1] = 0x00;
+	rc = test_run(&test_model, "lookup disabled", pkt, sizeof(pkt), PP2_CLS_MODEL_F_LKP_DIS, 1,
+		      MODEL_TEST_RXQ, -1);
+	if (rc)
+		return rc;
+
+	/* IPv6 loops on the L3 lookup until the port max loop */
+	pkt[PP2_MH_SIZE + 2 * ETH_ALEN] = 0x86;
+	pkt[PP2_MH_SIZE + 2 * ETH_ALEN + 1] = 0xdd;
+	rc = test_run(&test_model, "parser max loop", pkt, sizeof(pkt), PP2_CLS_MODEL_F_PRS_LOOP, 3, 0, -1);
+	if (rc)
+		return rc;
+
+	/* unknown ethertype */
+	pkt[PP2_MH_SIZE + 2 * ETH_ALEN] = 0x88;
+	rc = test_run(&test_model, "parser miss", pkt, sizeof(pkt), PP2_CLS_MODEL_F_PRS_MISS, -1, 0, -1);
+	if (rc)
+		return rc;
+
+	/* save/load round trip */
+	fd = mkstemp(path);
+	if (fd < 0) {
+		pr_err("can not create a temporary file\n");
+		return -EIO;
+	}
+	close(fd);
+	rc = pp2_cls_model_save(&test_model, path);
+	if (!rc)
+		rc = pp2_cls_model_load(&test_loaded, path);
+	if (!rc && memcmp(&test_model, &test_loaded, sizeof(test_model)))
+		rc = -EFAULT;
+	if (!rc)
+		rc = test_run(&test_loaded, "loaded model", test_arp_pkt, sizeof(test_arp_pkt),
+			      PP2_CLS_MODEL_F_FLOW_ID, 2, MODEL_TEST_HIT_Q, 0);
+	if (rc) {
+		pr_err("model save/load failed (%d)\n", rc);
+		goto out;
+	}
+
+	/* a file of another version is refused */
+	test_model.version++;
+	rc = pp2_cls_model_save(&test_model, path);
+	if (!rc && pp2_cls_model_load(&test_loaded, path) != -EINVAL) {
+		pr_err("model file of another version was loaded\n");
+		rc = -EFAULT;
+	}
+	if (!rc)
+		printf("%-24s passed\n", "model file");
+out:
+	unlink(path);
+	return rc;
+}
+
+static int test_hex_pkt_parse(const char *hex, u8 *pkt, u32 *len)
+{
+	u32 i, n = strlen(hex);
+	char byte[3] = {0};
+
+	if (!n || n % 2 || n / 2 > MODEL_TEST_MAX_PKT) {
+		pr_err("invalid packet, up to %d bytes in hex\n", MODEL_TEST_MAX_PKT);
+		return -EINVAL;
+	}
+	for (i = 0; i < n / 2; i++) {
+		if (!isxdigit(hex[2 * i]) || !isxdigit(hex[2 * i + 1])) {
+			pr_err("invalid hex packet\n");
+			return -EINVAL;
+		}
+		memcpy(byte, &hex[2 * i], 2);
+		pkt[i] = strtoul(byte, NULL, 16);
+	}
+	*len = n / 2;
+	return 0;
+}
+
+/* Run a packet through a model file saved on target */
+static int test_file_run(struct test_args *args)
+{
+	struct pp2_cls_model_res res;
+	u8 pkt[MODEL_TEST_MAX_PKT];
+	u32 len;
+	int rc;
+
+	rc = test_hex_pkt_parse(args->hex_pkt, pkt, &len);
+	if (rc)
+		return rc;
+	rc = pp2_cls_model_load(&test_loaded, args->model_file);
+	if (rc)
+		return rc;
+	rc = pp2_cls_model_run(&test_loaded, args->port, pkt, len, &res);
+	if (rc)
+		return rc;
+
+	printf("parser: tid %d, lookups %d, lkpid %d, ri 0x%08x, ai 0x%02x, l3 offset %d, l4 offset %d\n",
+	       res.prs_tid, res.num_lookups, res.lkpid, res.ri, res.ai, res.l3_offs, res.l4_offs);
+	printf("result: queue %d, color %d, flow_id %d%s, c2 %d, c3 %d, engines %d, flags 0x%x\n",
+	       res.queue, res.color, res.flow_id, (res.flags & PP2_CLS_MODEL_F_FLOW_ID) ? "" : " (not set)",
+	       res.c2_idx, res.c3_idx, res.num_engines, res.flags);
+	if (res.flags & PP2_CLS_MODEL_F_DROP)
+		printf("packet dropped\n");
+	if (res.flags & (PP2_CLS_MODEL_F_QOS_TBL | PP2_CLS_MODEL_F_RSS | PP2_CLS_MODEL_F_UNSUPP))
+		printf("result depends on QoS tables, RSS or a feature the model lacks\n");
+	return 0;
+}
+
+static void usage(char *progname)
+{
+	printf("\n"
+	       "Parser and classifier software model test, runs without HW\n"
+	       "\n"
+	       "Usage: %s [OPTIONS]\n"
+	       "\n"
+	       "Without options the model self test runs.\n"
+	       "\n"
+	       "Optional OPTIONS:\n"
+	       "\t-l <file>	Model file saved by \"cls_model_run -s\", requires -x\n"
+	       "\t-x <hex_pkt>	Packet to run on the model file, starting with the 2 bytes marvell header\n"
+	       "\t-p <port>	Physical port of the packet (default: 0)\n"
+	       "\t-h		Print this help\n"
+	       "\n", progname);
+}
+
+static int parse_args(struct test_args *args, int argc, char *argv[])
+{
+	int opt;
+
+	memset(args, 0, sizeof(*args));
+
+	while ((opt = getopt(argc, argv, "l:x:p:h")) != -1) {
+		switch (opt) {
+		case 'l':
+			args->model_file = optarg;
+			break;
+		case 'x':
+			args->hex_pkt = optarg;
+			break;
+		case 'p':
+			args->port = atoi(optarg);
+			break;
+		case 'h':
+		default:
+			usage(argv[0]);
+			return -EINVAL;
+		}
+	}
+
+	if (!args->model_file != !args->hex_pkt) {
+		pr_err("-l and -x go together\n");
+		return -EINVAL;
+	}
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	struct test_args args;
+	int err;
+
+	printf("Marvell Armada US (Build: %s %s)\n", __DATE__, __TIME__);
+
+	err = parse_args(&args, argc, argv);
+	if (err)
+		return err;
+
+	if (args.model_file)
+		return test_file_run(&args);
+
+	err = test_self();
+	printf("%s\n", err ? "FAILED!" : "PASSED");
+	return err;
+}
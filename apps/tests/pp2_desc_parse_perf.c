@@ -0,0 +1,284 @@
+/******************************************************************************
+ *	Copyright (C) 2016 Marvell International Ltd.
+ *
+ *  If you received this File from Marvell, you may opt to use, redistribute
+ *  and/or modify this File under the following licensing terms.
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *	* Redistributions of source code must retain the above copyright
+ *	  notice, this list of conditions and the following disclaimer.
+ *
+ *	* Redistributions in binary form must reproduce the above copyright
+ *	  notice, this list of conditions and the following disclaimer in the
+ *	  documentation and/or other materials provided with the distribution.
+ *
+ *	* Neither the name of Marvell nor the names of its contributors may be
+ *	  used to endorse or promote products derived from this software
+ *	  without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include <getopt.h>
+#include <time.h>
+
+#include "std_internal.h"
+#include "mv_pp2_ppio.h"
+
+
+#define DESC_PERF_DEF_BURST	32
+#define DESC_PERF_DEF_ITERS	(32 * 1024 * 1024)
+#define DESC_PERF_RING_SIZE	1024	/* descriptors cycled through, as in an RX queue */
+
+
+struct perf_args {
+	int	burst;
+	int	iters;
+};
+
+static struct pp2_ppio_desc	 perf_ring[DESC_PERF_RING_SIZE];
+static struct pp2_ppio_inq_burst perf_burst;
+
+static inline u32 perf_rand(void)
+{
+	return ((u32)rand() << 16) ^ rand();
+}
+
+/* Descriptors as the parser writes them: mostly good IPv4/IPv6 TCP/UDP frames,
+ * a few with MAC, IP or L4 errors, random buffers and pools
+ */
+static void perf_gen_desc(struct pp2_ppio_desc *desc)
+{
+	u32 l3 = 1 + perf_rand() % 5;
+	u32 l4 = 1 + perf_rand() % 3;
+	u32 cmd0;
+	u64 pa = (perf_rand() & 0xFF) * 0x100000000ULL + (perf_rand() & ~0x3F);
+
+	cmd0 = (PP2_MH_SIZE + 14) | ((l3 >= PP2_INQ_L3_TYPE_IPV6_NO_EXT) ? 10 : 5) << 8 |
+		(perf_rand() % 16) << 16 | l4 << 25 | l3 << 28 | RXD_L4_CHK_OK_MASK;
+	switch (perf_rand() % 64) {
+	case 0:
+		cmd0 |= RXD_ES_MASK | (perf_rand() % 4) << 13;
+		break;
+	case 1:
+		cmd0 |= RXD_IP_HDR_ERR_MASK;
+		break;
+	case 2:
+		cmd0 &= ~RXD_L4_CHK_OK_MASK;
+		break;
+	}
+
+	memset(desc, 0, sizeof(*desc));
+	desc->cmds[0] = cmd0;
+	desc->cmds[1] = (u32)(PP2_MH_SIZE + 60 + perf_rand() % 1455) << 16;
+	desc->cmds[4] = (u32)pa;
+	desc->cmds[5] = (u32)(pa >> 32) | (perf_rand() & RXD_KEY_HASH_MASK);
+	desc->cmds[6] = (u32)pa;
+	desc->cmds[7] = (u32)(pa >> 32);
+}
+
+/* What a data path typically reads of a frame, from the getters */
+static u64 perf_use_getters(struct pp2_ppio_desc *descs, int num)
+{
+	enum pp2_inq_l3_type l3_type;
+	enum pp2_inq_l4_type l4_type;
+	u8 l3_offset, l4_offset;
+	u64 sum = 0;
+	int i;
+
+	for (i = 0; i < num; i++) {
+		pp2_ppio_inq_desc_get_l3_info(&descs[i], &l3_type, &l3_offset);
+		pp2_ppio_inq_desc_get_l4_info(&descs[i], &l4_type, &l4_offset);
+		sum += pp2_ppio_inq_desc_get_cookie(&descs[i]) + pp2_ppio_inq_desc_get_phys_addr(&descs[i]) +
+		       pp2_ppio_inq_desc_get_pkt_len(&descs[i]) + l3_type + l3_offset + l4_type + l4_offset +
+		       pp2_ppio_inq_desc_get_pkt_error(&descs[i]) + DM_RXD_GET_POOL_ID(&descs[i]);
+	}
+	return sum;
+}
+
+/* The same, from a parsed burst */
+static u64 perf_use_burst(struct pp2_ppio_inq_burst *burst, int num)
+{
+	u64 sum = 0;
+	int i;
+
+	for (i = 0; i < num; i++)
+		sum += burst->cookie[i] + burst->phys_addr[i] + burst->len[i] + burst->l3_type[i] +
+		       burst->l3_offset[i] + burst->l4_type[i] + burst->l4_offset[i] + burst->status[i] +
+		       burst->pool_id[i];
+	return sum;
+}
+
+static int desc_parse_check(struct pp2_ppio_desc *desc, struct pp2_ppio_inq_burst *burst, int i)
+{
+	enum pp2_inq_l3_type l3_type;
+	enum pp2_inq_l4_type l4_type;
+	u8 l3_offset, l4_offset;
+
+	pp2_ppio_inq_desc_get_l3_info(desc, &l3_type, &l3_offset);
+	pp2_ppio_inq_desc_get_l4_info(desc, &l4_type, &l4_offset);
+
+	return burst->cookie[i] == pp2_ppio_inq_desc_get_cookie(desc) &&
+	       burst->phys_addr[i] == pp2_ppio_inq_desc_get_phys_addr(desc) &&
+	       burst->len[i] == pp2_ppio_inq_desc_get_pkt_len(desc) &&
+	       burst->l3_type[i] == l3_type && burst->l3_offset[i] == l3_offset &&
+	       burst->l4_type[i] == l4_type && burst->l4_offset[i] == l4_offset &&
+	       burst->status[i] == pp2_ppio_inq_desc_get_pkt_error(desc) &&
+	       burst->pool_id[i] == DM_RXD_GET_POOL_ID(desc);
+}
+
+static int desc_parse_self_test(void)
+{
+	int i, num;
+
+	for (num = 0; num <= PP2_PPIO_INQ_BURST_MAX; num++) {
+		for (i = 0; i < num; i++) {
+			perf_ring[i].cmds[0] = perf_rand();
+			perf_ring[i].cmds[1] = perf_rand();
+			perf_ring[i].cmds[4] = perf_rand();
+			perf_ring[i].cmds[5] = perf_rand();
+			perf_ring[i].cmds[6] = perf_rand();
+			perf_ring[i].cmds[7] = perf_rand();
+		}
+		if (pp2_ppio_inq_descs_parse(perf_ring, num, &perf_burst)) {
+			pr_err("descriptor parse self test: parse of %d failed\n", num);
+			return -EFAULT;
+		}
+		for (i = 0; i < num; i++)
+			if (!desc_parse_check(&perf_ring[i], &perf_burst, i)) {
+				pr_err("descriptor parse self test: descriptor %d of %d differs from the getters\n",
+				       i, num);
+				return -EFAULT;
+			}
+	}
+	return 0;
+}
+
+static int desc_parse_perf(struct perf_args *args)
+{
+	double t_get, t_parse, t_parse_only;
+	u64 start;
+	u64 sum_get = 0, sum_parse = 0;
+	int i, idx;
+
+	for (i = 0; i < DESC_PERF_RING_SIZE; i++)
+		perf_gen_desc(&perf_ring[i]);
+
+	start = mv_time_usecs();
+	for (i = 0, idx = 0; i < args->iters; i += args->burst) {
+		sum_get += perf_use_getters(&perf_ring[idx], args->burst);
+		idx = (idx + args->burst) % (DESC_PERF_RING_SIZE - args->burst + 1);
+	}
+	t_get = (mv_time_usecs() - start) / 1e6;
+
+	start = mv_time_usecs();
+	for (i = 0, idx = 0; i < args->iters; i += args->burst) {
+		pp2_ppio_inq_descs_parse(&perf_ring[idx], args->burst, &perf_burst);
+		sum_parse += perf_use_burst(&perf_burst, args->burst);
+		idx = (idx + args->burst) % (DESC_PERF_RING_SIZE - args->burst + 1);
+	}
+	t_parse = (mv_time_usecs() - start) / 1e6;
+
+	start = mv_time_usecs();
+	for (i = 0, idx = 0; i < args->iters; i += args->burst) {
+		pp2_ppio_inq_descs_parse(&perf_ring[idx], args->burst, &perf_burst);
+		idx = (idx + args->burst) % (DESC_PERF_RING_SIZE - args->burst + 1);
+	}
+	t_parse_only = (mv_time_usecs() - start) / 1e6;
+
+	if (sum_get != sum_parse) {
+		pr_err("getters and parsed burst results differ\n");
+		return -EFAULT;
+	}
+
+	printf("%d descriptors, burst %d\n", args->iters, args->burst);
+	printf("method         ns/desc  Mdesc/s\n");
+	printf("getters       %8.2f %8.2f\n", t_get * 1e9 / args->iters, args->iters / t_get / 1e6);
+	printf("parse + use   %8.2f %8.2f\n", t_parse * 1e9 / args->iters, args->iters / t_parse / 1e6);
+	printf("parse only    %8.2f %8.2f\n", t_parse_only * 1e9 / args->iters, args->iters / t_parse_only / 1e6);
+	return 0;
+}
+
+static void usage(char *progname)
+{
+	printf("\n"
+	       "PPIO inq descriptor burst parse benchmark\n"
+	       "\n"
+	       "Usage: %s OPTIONS\n"
+	       "\n"
+	       "Optional OPTIONS:\n"
+	       "\t-b <num>	Burst size, up to %d (default: %d)\n"
+	       "\t-n <num>	Number of descriptors per test (default: %d)\n"
+	       "\t-h		Print this help\n"
+	       "\n", progname, PP2_PPIO_INQ_BURST_MAX, DESC_PERF_DEF_BURST, DESC_PERF_DEF_ITERS);
+}
+
+static int parse_args(struct perf_args *args, int argc, char *argv[])
+{
+	int opt;
+
+	args->burst = DESC_PERF_DEF_BURST;
+	args->iters = DESC_PERF_DEF_ITERS;
+
+	while ((opt = getopt(argc, argv, "b:n:h")) != -1) {
+		switch (opt) {
+		case 'b':
+			args->burst = atoi(optarg);
+			break;
+		case 'n':
+			args->iters = atoi(optarg);
+			break;
+		case 'h':
+		default:
+			usage(argv[0]);
+			return -EINVAL;
+		}
+	}
+
+	if (args->burst <= 0 || args->burst > PP2_PPIO_INQ_BURST_MAX) {
+		pr_err("Invalid burst size %d (up to %d)\n", args->burst, PP2_PPIO_INQ_BURST_MAX);
+		return -EINVAL;
+	}
+	if (args->iters <= 0) {
+		pr_err("Invalid number of descriptors %d\n", args->iters);
+		return -EINVAL;
+	}
+	/* Whole bursts */
+	args->iters -= args->iters % args->burst;
+	if (!args->iters)
+		args->iters = args->burst;
+
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	struct perf_args args;
+	int err;
+
+	printf("Marvell Armada US (Build: %s %s)\n", __DATE__, __TIME__);
+
+	err = parse_args(&args, argc, argv);
+	if (err)
+		return err;
+
+	srand(time(NULL));
+	err = desc_parse_self_test();
+	if (!err)
+		err = desc_parse_perf(&args);
+
+	if (err)
+		printf("FAILED!\n");
+	return err;
+}
@@ -0,0 +1,306 @@
+/******************************************************************************
+ *	Copyright (C) 2016 Marvell International Ltd.
+ *
+ *  If you received this File from Marvell, you may opt to use, redistribute
+ *  and/or modify this File under the following licensing terms.
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *	* Redistributions of source code must retain the above copyright
+ *	  notice, this list of conditions and the following disclaimer.
+ *
+ *	* Redistributions in binary form must reproduce the above copyright
+ *	  notice, this list of conditions and the following disclaimer in the
+ *	  documentation and/or other materials provided with the distribution.
+ *
+ *	* Neither the name of Marvell nor the names of its contributors may be
+ *	  used to endorse or promote products derived from this software
+ *	  without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+/*
+ * Test of the ppio TX buffer (drivers/ppv2/pp2_ppio_tx_buffer.c).
+ * The TX buffer is built with a stub pp2_ppio_send(), that accepts a random
+ * part of each burst and checks the sequence number stamped in every
+ * descriptor, so no HW is needed. The test checks:
+ * - the descriptors are sent in order, with partial sends and full buffers;
+ * - small adds are coalesced into one send per full buffer;
+ * - the drain timeout sends a buffer only once it expired.
+ */
+
+#include <getopt.h>
+
+#include "std_internal.h"
+#include "drivers/ppv2/pp2_types.h"
+#include "drivers/ppv2/pp2.h"
+
+
+#define TXB_TEST_DEF_ROUNDS	100000
+#define TXB_TEST_SIZE		16
+#define TXB_TEST_MAX_ADD	40
+#define TXB_TEST_SMALL_ADD	3
+#define TXB_TEST_TIMEOUT_US	2000
+#define TXB_TEST_SEQ_WORD	6	/* descriptor word holding the sequence number */
+
+
+struct test_args {
+	int	rounds;
+	u32	seed;
+};
+
+static struct pp2_port		test_port;
+static struct pp2_ppio		test_ppio = { .internal_param = &test_port };
+static struct pp2_ppio_desc	test_descs[TXB_TEST_MAX_ADD];
+static u32			test_sent_seq;
+static int			test_partial;
+static int			test_order_err;
+
+/* Stub of the ppio send: takes all or a random part of the burst, and checks the order */
+int pp2_ppio_send(struct pp2_ppio *ppio, struct pp2_hif *hif, u8 qid, struct pp2_ppio_desc *descs, u16 *num)
+{
+	u16 n = *num, i;
+
+	if (test_partial)
+		n = rand() % (n + 1);
+	for (i = 0; i < n; i++, test_sent_seq++)
+		if (descs[i].cmds[TXB_TEST_SEQ_WORD] != test_sent_seq)
+			test_order_err++;
+	*num = n;
+	return 0;
+}
+
+static void test_descs_stamp(u32 seq, u16 num)
+{
+	u16 i;
+
+	for (i = 0; i < num; i++)
+		test_descs[i].cmds[TXB_TEST_SEQ_WORD] = seq + i;
+}
+
+static int test_params(void)
+{
+	struct pp2_ppio_tx_buffer_params params;
+	struct pp2_ppio_tx_buffer *txb;
+
+	memset(&params, 0, sizeof(params));
+	params.ppio = &test_ppio;
+	params.hif = (struct pp2_hif *)&test_ppio;
+
+	params.qid = test_port.num_tx_queues;
+	if (!pp2_ppio_tx_buffer_init(&params, &txb)) {
+		pr_err("TX buffer created on an invalid queue\n");
+		return -EFAULT;
+	}
+	params.qid = 0;
+	params.size = PP2_PPIO_TX_BUFFER_MAX_SIZE + 1;
+	if (!pp2_ppio_tx_buffer_init(&params, &txb)) {
+		pr_err("TX buffer created with an invalid size\n");
+		return -EFAULT;
+	}
+	printf("%-24s passed\n", "parameters");
+	return 0;
+}
+
+static int test_coalesce(void)
+{
+	struct pp2_ppio_tx_buffer_params params;
+	struct pp2_ppio_tx_buffer_statistics stats;
+	struct pp2_ppio_tx_buffer *txb;
+	u32 seq = test_sent_seq;
+	u16 num;
+	int i, rc;
+
+	memset(&params, 0, sizeof(params));
+	params.ppio = &test_ppio;
+	params.hif = (struct pp2_hif *)&test_ppio;
+	params.size = TXB_TEST_SIZE;
+	rc = pp2_ppio_tx_buffer_init(&params, &txb);
+	if (rc)
+		return rc;
+
+	/* all sends accepted, each full buffer goes in one doorbell */
+	test_partial = 0;
+	for (i = 0; i < TXB_TEST_SIZE; i++) {
+		num = TXB_TEST_SMALL_ADD;
+		test_descs_stamp(seq, num);
+		pp2_ppio_tx_buffer_add(txb, test_descs, &num);
+		seq += num;
+	}
+	pp2_ppio_tx_buffer_get_statistics(txb, &stats, 0);
+	if (stats.added != TXB_TEST_SIZE * TXB_TEST_SMALL_ADD || stats.doorbells != TXB_TEST_SMALL_ADD ||
+	    stats.sent != TXB_TEST_SIZE * TXB_TEST_SMALL_ADD || stats.pending) {
+		pr_err("coalesce: added %lu, sent %lu, doorbells %lu, pending %u\n",
+		       stats.added, stats.sent, stats.doorbells, stats.pending);
+		rc = -EFAULT;
+	}
+	pp2_ppio_tx_buffer_deinit(txb);
+	if (!rc)
+		printf("%-24s passed\n", "coalesce");
+	return rc;
+}
+
+static int test_order(struct test_args *args)
+{
+	struct pp2_ppio_tx_buffer_params params;
+	struct pp2_ppio_tx_buffer_statistics stats;
+	struct pp2_ppio_tx_buffer *txb;
+	u32 seq = test_sent_seq, start = test_sent_seq;
+	u16 num, req;
+	int i, rc;
+
+	memset(&params, 0, sizeof(params));
+	params.ppio = &test_ppio;
+	params.hif = (struct pp2_hif *)&test_ppio;
+	params.size = TXB_TEST_SIZE;
+	rc = pp2_ppio_tx_buffer_init(&params, &txb);
+	if (rc)
+		return rc;
+
+	/* partial sends, adds of random sizes, random flushes and drains */
+	test_partial = 1;
+	for (i = 0; i < args->rounds; i++) {
+		req = rand() % TXB_TEST_MAX_ADD;
+		num = req;
+		test_descs_stamp(seq, num);
+		pp2_ppio_tx_buffer_add(txb, test_descs, &num);
+		if (num > req) {
+			pr_err("order: %u descriptors added of %u\n", num, req);
+			rc = -EFAULT;
+			break;
+		}
+		/* the descriptors not added are sent again by the caller */
+		seq += num;
+		if (!(rand() % 7))
+			pp2_ppio_tx_buffer_flush(txb, NULL);
+		if (!(rand() % 5))
+			pp2_ppio_tx_buffer_drain(txb, NULL);
+	}
+	test_partial = 0;
+	pp2_ppio_tx_buffer_flush(txb, NULL);
+
+	pp2_ppio_tx_buffer_get_statistics(txb, &stats, 1);
+	if (!rc && (test_order_err || stats.pending || test_sent_seq != seq || stats.added != seq - start ||
+		    stats.sent != seq - start)) {
+		pr_err("order: %d out of order, added %lu, sent %lu of %u, pending %u\n",
+		       test_order_err, stats.added, stats.sent, seq - start, stats.pending);
+		rc = -EFAULT;
+	}
+	pp2_ppio_tx_buffer_deinit(txb);
+	if (!rc)
+		printf("%-24s passed (%u descriptors, %lu doorbells)\n", "order", seq - start,
+		       stats.doorbells);
+	return rc;
+}
+
+static int test_drain_timeout(void)
+{
+	struct pp2_ppio_tx_buffer_params params;
+	struct pp2_ppio_tx_buffer *txb;
+	u16 num = 1, before, after;
+	int rc;
+
+	memset(&params, 0, sizeof(params));
+	params.ppio = &test_ppio;
+	params.hif = (struct pp2_hif *)&test_ppio;
+	params.size = TXB_TEST_SIZE;
+	params.drain_timeout_us = TXB_TEST_TIMEOUT_US;
+	rc = pp2_ppio_tx_buffer_init(&params, &txb);
+	if (rc)
+		return rc;
+
+	test_descs_stamp(test_sent_seq, num);
+	pp2_ppio_tx_buffer_add(txb, test_descs, &num);
+	pp2_ppio_tx_buffer_drain(txb, &before);
+	usleep(TXB_TEST_TIMEOUT_US + 1000);
+	pp2_ppio_tx_buffer_drain(txb, &after);
+	pp2_ppio_tx_buffer_deinit(txb);
+
+	if (before || after != 1) {
+		pr_err("drain timeout: %u sent before the timeout, %u after\n", before, after);
+		return -EFAULT;
+	}
+	printf("%-24s passed\n", "drain timeout");
+	return 0;
+}
+
+static void usage(char *progname)
+{
+	printf("\n"
+	       "ppio TX buffer test, runs with a stub send and no HW\n"
+	       "\n"
+	       "Usage: %s OPTIONS\n"
+	       "\n"
+	       "Optional OPTIONS:\n"
+	       "\t-n <num>	Number of random adds (default: %d)\n"
+	       "\t-s <num>	Random seed (default: time)\n"
+	       "\t-h		Print this help\n"
+	       "\n", progname, TXB_TEST_DEF_ROUNDS);
+}
+
+static int parse_args(struct test_args *args, int argc, char *argv[])
+{
+	int opt;
+
+	args->rounds = TXB_TEST_DEF_ROUNDS;
+	args->seed = time(NULL);
+
+	while ((opt = getopt(argc, argv, "n:s:h")) != -1) {
+		switch (opt) {
+		case 'n':
+			args->rounds = atoi(optarg);
+			break;
+		case 's':
+			args->seed = strtoul(optarg, NULL, 0);
+			break;
+		case 'h':
+		default:
+			usage(argv[0]);
+			return -EINVAL;
+		}
+	}
+
+	if (args->rounds <= 0) {
+		pr_err("Invalid number of adds %d\n", args->rounds);
+		return -EINVAL;
+	}
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	struct test_args args;
+	int err;
+
+	printf("Marvell Armada US (Build: %s %s)\n", __DATE__, __TIME__);
+
+	err = parse_args(&args, argc, argv);
+	if (err)
+		return err;
+
+	printf("seed %u\n", args.seed);
+	srand(args.seed);
+	test_port.num_tx_queues = 1;
+
+	err = test_params();
+	if (!err)
+		err = test_coalesce();
+	if (!err)
+		err = test_order(&args);
+	if (!err)
+		err = test_drain_timeout();
+
+	printf("%s\n", err ? "FAILED!" : "PASSED");
+	return err;
+}
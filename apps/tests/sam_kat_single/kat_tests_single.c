@@ -237,6 +237,7 @@ int main(int argc, char **argv)
 	pr_info("DMA Buffer %d bytes allocated: vaddr = %p, paddr = %p\n",
 		aes128_t1_buf.len, aes128_t1_buf.vaddr, (void *)aes128_t1_buf.paddr);
 
+	memset(&cio_params, 0, sizeof(cio_params));
 	cio_params.match = "cio-0:0";
 	cio_params.size = 32;
 	cio_params.num_sessions = 64;
@@ -36,10 +36,6 @@
 
 #include "mv_std.h"
 #include "lib/lib_misc.h"
-#include "lib/mv_aes.h"
-#include "lib/mv_sha1.h"
-#include "lib/mv_sha2.h"
-#include "lib/mv_md5.h"
 #include "mv_sam.h"
 #include "fileSets.h"
 #include "encryptedBlock.h"
@@ -57,6 +53,11 @@
 #define MAX_AAD_SIZE			64 /* Bytes */
 
 static struct sam_cio		*cio_hndl;
+static struct sam_cio		*cio_hndls[SAM_MAX_CIO_NUM];
+static u32			num_cios;
+/* CIO group, used when more than one CIO is given */
+static struct sam_cio_group	*grp_hndl;
+static enum sam_cio_group_policy grp_policy = SAM_CIO_GROUP_SA_AFFINITY;
 static struct sam_sa		*sa_hndl[NUM_CONCURRENT_SESSIONS];
 static struct sam_session_params sa_params[NUM_CONCURRENT_SESSIONS];
 
@@ -206,37 +207,18 @@ static enum sam_auth_alg auth_algorithm_str_to_val(char *data, int auth_key_len)
 	return SAM_AUTH_NONE;
 }
 
-static void gcm_create_auth_key(u8 *key, int key_len, u8 inner[])
+/* Flush all CIO instances */
+static int flush_cios(void)
 {
-	u8 key_input[16] = {0};
-	u32 *ptr32 = (u32 *)inner;
-	int i;
-
-	mv_aes_ecb_encrypt(key_input, key, inner, key_len * 8);
-
-	for (i = 0; i < sizeof(key_input) / 4; i++) {
-		u32 val32;
+	u32 i;
+	int rc;
 
-		val32 = *ptr32;
-		*ptr32++ = __bswap_32(val32);
+	for (i = 0; i < num_cios; i++) {
+		rc = sam_cio_flush(cio_hndls[i]);
+		if (rc)
+			return rc;
 	}
-}
-
-static void hmac_create_iv(enum sam_auth_alg auth_alg, unsigned char key[], int key_len,
-			   unsigned char inner[], unsigned char outer[])
-{
-	if (auth_alg == SAM_AUTH_HMAC_MD5)
-		mv_md5_hmac_iv(key, key_len, inner, outer);
-	else if (auth_alg == SAM_AUTH_HMAC_SHA1)
-		mv_sha1_hmac_iv(key, key_len, inner, outer);
-	else if (auth_alg == SAM_AUTH_HMAC_SHA2_256)
-		mv_sha256_hmac_iv(key, key_len, inner, outer);
-	else if (auth_alg == SAM_AUTH_HMAC_SHA2_384)
-		mv_sha384_hmac_iv(key, key_len, inner, outer);
-	else if (auth_alg == SAM_AUTH_HMAC_SHA2_512)
-		mv_sha512_hmac_iv(key, key_len, inner, outer);
-	else
-		printf("\n%s: Unexpected authentication algorithm - %d\n", __func__, auth_alg);
+	return 0;
 }
 
 static int delete_sessions(void)
@@ -246,21 +228,26 @@ static int delete_sessions(void)
 	i = 0;
 	while (i < NUM_CONCURRENT_SESSIONS) {
 		if (sa_hndl[i]) {
-			if (sam_session_destroy(sa_hndl[i])) {
+			if (grp_hndl)
+				rc = sam_cio_group_session_destroy(grp_hndl, sa_hndl[i]);
+			else
+				rc = sam_session_destroy(sa_hndl[i]);
+			if (rc) {
 				/* flush CIO instanse */
-				rc = sam_cio_flush(cio_hndl);
+				rc = flush_cios();
 				if (rc)
 					break;
 
 				continue;
 			}
+			sa_hndl[i] = NULL;
 			count++;
 		}
 		i++;
 	}
 	printf("%d sessions deleted\n", count);
 
-	rc = sam_cio_flush(cio_hndl);
+	rc = flush_cios();
 	if (rc)
 		return rc;
 
@@ -270,7 +257,7 @@ static int delete_sessions(void)
 static int create_sessions(generic_list tests_db)
 {
 	EncryptedBlockPtr block;
-	int i, num_tests, auth_key_len;
+	int i, num_tests, auth_key_len, rc;
 	u8 cipher_key[MAX_CIPHER_KEY_SIZE];
 	u8 auth_inner[MAX_AUTH_ICV_SIZE];
 	u8 auth_outer[MAX_AUTH_ICV_SIZE];
@@ -317,10 +304,11 @@ static int create_sessions(generic_list tests_db)
 			if (sa_params[i].auth_alg == SAM_AUTH_AES_GCM) {
 				sa_params[i].auth_aad_len = encryptedBlockGetAadLen(block, 0);
 				/* Generate authenticationn key from cipher key */
-				gcm_create_auth_key(sa_params[i].cipher_key, sa_params[i].cipher_key_len, auth_inner);
-
 				sa_params[i].auth_inner = auth_inner;
 				sa_params[i].auth_outer = NULL;
+				if (sam_session_auth_key_set(&sa_params[i], sa_params[i].cipher_key,
+							     sa_params[i].cipher_key_len))
+					return -EINVAL;
 
 			} else {
 				if (auth_key_len > 0) {
@@ -337,15 +325,18 @@ static int create_sessions(generic_list tests_db)
 						printf("Can't get authentication key of %d bytes\n", auth_key_len);
 						return -EINVAL;
 					}
-					hmac_create_iv(sa_params[i].auth_alg, auth_key, auth_key_len,
-							auth_inner, auth_outer);
-
 					sa_params[i].auth_inner = auth_inner;
 					sa_params[i].auth_outer = auth_outer;
+					if (sam_session_auth_key_set(&sa_params[i], auth_key, auth_key_len))
+						return -EINVAL;
 				}
 			}
 		}
-		if (sam_session_create(cio_hndl, &sa_params[i], &sa_hndl[i])) {
+		if (grp_hndl)
+			rc = sam_cio_group_session_create(grp_hndl, &sa_params[i], &sa_hndl[i]);
+		else
+			rc = sam_session_create(cio_hndl, &sa_params[i], &sa_hndl[i]);
+		if (rc) {
 			printf("%s: failed\n", __func__);
 			return -1;
 		}
@@ -652,7 +643,10 @@ static int run_tests(generic_list tests_db)
 						next_request = 0;
 				}
 				num = (u16)num_enq;
-				rc = sam_cio_enq(cio_hndl, requests, &num);
+				if (grp_hndl)
+					rc = sam_cio_group_enq(grp_hndl, requests, &num);
+				else
+					rc = sam_cio_enq(cio_hndl, requests, &num);
 				if (rc) {
 					printf("%s: sam_cio_enq failed. to_enq = %d, num = %d, rc = %d\n",
 						__func__, num_enq, num, rc);
@@ -668,7 +662,10 @@ static int run_tests(generic_list tests_db)
 			/* Get all ready results together */
 			to_deq = min(in_process, num_requests_per_deq);
 			num = (u16)to_deq;
-			rc = sam_cio_deq(cio_hndl, results, &num);
+			if (grp_hndl)
+				rc = sam_cio_group_deq(grp_hndl, results, &num);
+			else
+				rc = sam_cio_deq(cio_hndl, results, &num);
 			if (rc) {
 				printf("%s: sam_cio_deq failed. to_deq = %d, num = %d, rc = %d\n",
 					__func__, to_deq, num, rc);
@@ -705,6 +702,7 @@ static void usage(char *progname)
 {
 	printf("Usage: %s <match> <test_file> [OPTIONS]\n", NO_PATH(progname));
 	printf("<match> string format is cio-0:0\n");
+	printf("\tor a comma separated list, e.g. cio-0:0,cio-1:0, to run the tests through a CIO group\n");
 	printf("OPTIONS are optional:\n");
 	printf("\t-c <number>      - Number of requests to check (default: %d)\n", num_to_check);
 	printf("\t-p <number>      - Number of requests to print (default: %d)\n", num_to_print);
@@ -714,6 +712,7 @@ static void usage(char *progname)
 					SAM_SA_DEBUG_FLAG, SAM_CIO_DEBUG_FLAG);
 	printf("\t--same_bufs      - Use the same buffer as src and dst (default: %s)\n",
 		same_bufs ? "same" : "different");
+	printf("\t--least_busy     - CIO group sends each request to the least busy CIO (default: SA affinity)\n");
 }
 
 static int parse_args(int argc, char *argv[])
@@ -801,6 +800,9 @@ static int parse_args(int argc, char *argv[])
 		} else if (strcmp(argv[i], "--same_bufs") == 0) {
 			same_bufs = true;
 			i += 1;
+		} else if (strcmp(argv[i], "--least_busy") == 0) {
+			grp_policy = SAM_CIO_GROUP_LEAST_BUSY;
+			i += 1;
 		} else {
 			pr_err("argument (%s) not supported!\n", argv[i]);
 			return -EINVAL;
@@ -815,6 +817,48 @@ static int parse_args(int argc, char *argv[])
 	printf("Number per deq : %u\n", num_requests_per_deq);
 	printf("Debug flags    : 0x%x\n", debug_flags);
 	printf("src / dst bufs : %s\n", same_bufs ? "same" : "different");
+	printf("Group policy   : %s\n", (grp_policy == SAM_CIO_GROUP_LEAST_BUSY) ? "least busy" : "SA affinity");
+
+	return 0;
+}
+
+/* Init a CIO per match string of the comma separated list, and a CIO group when more than one */
+static int init_cios(struct sam_cio_params *cio_params)
+{
+	/* CIO params keep a pointer to the match string */
+	static char match_list[128];
+	struct sam_cio_group_params grp_params;
+	char *match;
+
+	strncpy(match_list, sam_match_str, sizeof(match_list) - 1);
+	match_list[sizeof(match_list) - 1] = '\0';
+
+	for (match = strtok(match_list, ","); match; match = strtok(NULL, ",")) {
+		if (num_cios == SAM_MAX_CIO_NUM) {
+			pr_err("Too many CIOs, maximum is %d\n", SAM_MAX_CIO_NUM);
+			return -EINVAL;
+		}
+		cio_params->match = match;
+		if (sam_cio_init(cio_params, &cio_hndls[num_cios]))
+			return -EINVAL;
+		sam_cio_debug_flags_set(cio_hndls[num_cios], debug_flags);
+		num_cios++;
+	}
+	if (!num_cios)
+		return -EINVAL;
+	cio_hndl = cio_hndls[0];
+
+	if (num_cios == 1)
+		return 0;
+
+	memset(&grp_params, 0, sizeof(grp_params));
+	grp_params.cios = cio_hndls;
+	grp_params.num_cios = num_cios;
+	grp_params.policy = grp_policy;
+	if (sam_cio_group_init(&grp_params, &grp_hndl))
+		return -EINVAL;
+
+	printf("CIO group of %u CIOs: %s\n", num_cios, sam_match_str);
 
 	return 0;
 }
@@ -823,6 +867,7 @@ int main(int argc, char **argv)
 {
 	struct sam_cio_params cio_params;
 	struct sam_cio_stats cio_stats;
+	u32 i;
 	int rc;
 
 	rc = parse_args(argc, argv);
@@ -835,7 +880,7 @@ int main(int argc, char **argv)
 		return rc;
 	}
 
-	cio_params.match = sam_match_str;
+	memset(&cio_params, 0, sizeof(cio_params));
 
 	test_db = generic_list_create(fileSetsEncryptedBlockCopyForList,
 				      fileSetsEncryptedBlockDestroyForList);
@@ -852,14 +897,12 @@ int main(int argc, char **argv)
 	cio_params.num_sessions = NUM_CONCURRENT_SESSIONS;
 	cio_params.max_buf_size = MAX_BUFFER_SIZE;
 
-	if (sam_cio_init(&cio_params, &cio_hndl)) {
+	if (init_cios(&cio_params)) {
 		printf("%s: initialization failed\n", argv[0]);
 		return 1;
 	}
 	printf("%s successfully loaded\n", argv[0]);
 
-	sam_cio_debug_flags_set(cio_hndl, debug_flags);
-
 	if (create_sessions(test_db))
 		goto exit;
 
@@ -875,20 +918,27 @@ exit:
 
 	free_bufs();
 
-	if (!sam_cio_stats_get(cio_hndl, &cio_stats, true)) {
-		printf("Enqueue packets             : %lu packets\n", cio_stats.enq_pkts);
-		printf("Enqueue bytes               : %lu bytes\n", cio_stats.enq_bytes);
-		printf("Enqueue full                : %lu times\n", cio_stats.enq_full);
-		printf("Dequeue packets             : %lu packets\n", cio_stats.deq_pkts);
-		printf("Dequeue bytes               : %lu bytes\n", cio_stats.deq_bytes);
-		printf("Dequeue empty               : %lu times\n", cio_stats.deq_empty);
-		printf("Created sessions            : %lu\n", cio_stats.sa_add);
-		printf("Deleted sessions:	    : %lu\n", cio_stats.sa_del);
-		printf("Invalidated sessions:	    : %lu\n", cio_stats.sa_inv);
-	}
-	if (sam_cio_deinit(cio_hndl)) {
-		printf("%s: un-initialization failed\n", argv[0]);
-		return 1;
+	if (grp_hndl)
+		sam_cio_group_deinit(grp_hndl);
+
+	for (i = 0; i < num_cios; i++) {
+		if (num_cios > 1)
+			printf("CIO #%u:\n", i);
+		if (!sam_cio_stats_get(cio_hndls[i], &cio_stats, true)) {
+			printf("Enqueue packets             : %lu packets\n", cio_stats.enq_pkts);
+			printf("Enqueue bytes               : %lu bytes\n", cio_stats.enq_bytes);
+			printf("Enqueue full                : %lu times\n", cio_stats.enq_full);
+			printf("Dequeue packets             : %lu packets\n", cio_stats.deq_pkts);
+			printf("Dequeue bytes               : %lu bytes\n", cio_stats.deq_bytes);
+			printf("Dequeue empty               : %lu times\n", cio_stats.deq_empty);
+			printf("Created sessions            : %lu\n", cio_stats.sa_add);
+			printf("Deleted sessions:	    : %lu\n", cio_stats.sa_del);
+			printf("Invalidated sessions:	    : %lu\n", cio_stats.sa_inv);
+		}
+		if (sam_cio_deinit(cio_hndls[i])) {
+			printf("%s: un-initialization failed\n", argv[0]);
+			return 1;
+		}
 	}
 	printf("%s successfully unloaded\n", argv[0]);
 
@@ -29,6 +29,8 @@
 #include <linux/dma-mapping.h>
 #include <linux/uaccess.h>
 #include <linux/mutex.h>
+#include <linux/interrupt.h>
+#include <linux/spinlock.h>
 
 #define DRIVER_NAME	"mv_sam_uio_drv"
 #define DRIVER_VERSION	"0.1"
@@ -36,6 +38,27 @@
 #define DRIVER_DESC	"UIO platform driver for Security Accelerator"
 
 #define MAX_UIO_DEVS	3
+#define MAX_RING_IRQS	4
+
+/* Bit in sam_uio_ring_irq.flags: ring interrupt line is disabled */
+#define SAM_UIO_IRQ_DISABLED	0
+
+/*
+ * sam_uio_ring_irq
+ * uio device used to notify user space about ring interrupt
+ *
+ * @uio:      uio_info with IRQ and without memory maps
+ * @name:     uio device name: uio_<eip>_<engine>_ring<ring>
+ * @flags:    IRQ line state
+ * @lock:     protects IRQ line state
+ *
+ */
+struct sam_uio_ring_irq {
+	struct uio_info uio;
+	char name[24];
+	unsigned long flags;
+	spinlock_t lock;
+};
 
 /*
  * sam_uio_pdev_info
@@ -53,8 +76,83 @@ struct sam_uio_pdev_info {
 	struct device *dev;
 	char name[16];
 	struct uio_info uio[MAX_UIO_DEVS];
+	int irq_num;
+	struct sam_uio_ring_irq ring_irq[MAX_RING_IRQS];
 };
 
+/*
+ * sam_uio_ring_irq_handler() - ring interrupt handler
+ * - ring interrupt is level triggered, so IRQ line is disabled until
+ *   user space acknowledges the interrupt and re-enables it by write()
+ */
+static irqreturn_t sam_uio_ring_irq_handler(int irq, struct uio_info *uio)
+{
+	struct sam_uio_ring_irq *ring_irq = uio->priv;
+
+	spin_lock(&ring_irq->lock);
+	if (!__test_and_set_bit(SAM_UIO_IRQ_DISABLED, &ring_irq->flags))
+		disable_irq_nosync(irq);
+	spin_unlock(&ring_irq->lock);
+
+	return IRQ_HANDLED;
+}
+
+/*
+ * sam_uio_ring_irqcontrol() - enable/disable ring IRQ line on write() to uio device
+ */
+static int sam_uio_ring_irqcontrol(struct uio_info *uio, s32 irq_on)
+{
+	struct sam_uio_ring_irq *ring_irq = uio->priv;
+	unsigned long flags;
+
+	spin_lock_irqsave(&ring_irq->lock, flags);
+	if (irq_on) {
+		if (__test_and_clear_bit(SAM_UIO_IRQ_DISABLED, &ring_irq->flags))
+			enable_irq(uio->irq);
+	} else {
+		if (!__test_and_set_bit(SAM_UIO_IRQ_DISABLED, &ring_irq->flags))
+			disable_irq_nosync(uio->irq);
+	}
+	spin_unlock_irqrestore(&ring_irq->lock, flags);
+
+	return 0;
+}
+
+/*
+ * sam_uio_ring_irqs_register() - register uio device for each ring interrupt
+ * found in device tree ("ring0".."ring3"). Ring interrupts are optional.
+ */
+static void sam_uio_ring_irqs_register(struct device *dev, struct platform_device *eip_pdev,
+				       struct sam_uio_pdev_info *pdev_info)
+{
+	struct sam_uio_ring_irq *ring_irq;
+	char irq_name[8];
+	int ring, irq;
+
+	for (ring = 0; ring < MAX_RING_IRQS; ring++) {
+		snprintf(irq_name, sizeof(irq_name), "ring%d", ring);
+		irq = platform_get_irq_byname(eip_pdev, irq_name);
+		if (irq <= 0)
+			break;
+
+		ring_irq = &pdev_info->ring_irq[ring];
+		spin_lock_init(&ring_irq->lock);
+		snprintf(ring_irq->name, sizeof(ring_irq->name), "%s_ring%d", pdev_info->name, ring);
+		ring_irq->uio.name = ring_irq->name;
+		ring_irq->uio.version = DRIVER_VERSION;
+		ring_irq->uio.irq = irq;
+		ring_irq->uio.handler = sam_uio_ring_irq_handler;
+		ring_irq->uio.irqcontrol = sam_uio_ring_irqcontrol;
+		ring_irq->uio.priv = ring_irq;
+
+		if (uio_register_device(dev, &ring_irq->uio)) {
+			dev_err(dev, "Failed to register uio device for %s interrupt\n", irq_name);
+			break;
+		}
+		pdev_info->irq_num++;
+	}
+}
+
 /*
  * sam_uio_probe() - mv_pp_uio_drv platform driver probe routine
  * - register uio devices filled with memory maps retrieved from device tree
@@ -131,8 +229,10 @@ static int sam_uio_probe(struct platform_device *pdev)
 
 	pdev_info->map_num = mem_cnt;
 
-	dev_info(dev, "Registered %d uio devices, %d register maps attached\n",
-		pdev_info->uio_num, pdev_info->map_num);
+	sam_uio_ring_irqs_register(dev, eip_pdev, pdev_info);
+
+	dev_info(dev, "Registered %d uio devices, %d register maps, %d ring interrupts attached\n",
+		pdev_info->uio_num, pdev_info->map_num, pdev_info->irq_num);
 
 	platform_set_drvdata(pdev, pdev_info);
 
@@ -156,6 +256,9 @@ static int sam_uio_remove(struct platform_device *pdev)
 	if (!pdev_info)
 		return -EINVAL;
 
+	for (int ring = 0; ring < pdev_info->irq_num; ++ring)
+		uio_unregister_device(&pdev_info->ring_irq[ring].uio);
+
 	if (pdev_info->uio_num != 0) {
 		for (int idx = 0; idx <= pdev_info->uio_num; ++idx)
 			uio_unregister_device(&pdev_info->uio[idx]);
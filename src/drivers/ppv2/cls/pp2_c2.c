@@ -339,371 +339,6 @@ static int pp2_cls_c2_lkp_type_list_pri_get(struct pp2_inst *inst,
 	return 0;
 }
 
-/*******************************************************************************
- * pp2_cls_c2_lkp_type_list_neighbour_pri_get()
- *
- * DESCRIPTION: The routine will get the neighbour priority of given priority.
- *
- * INPUTS:
- *	   inst	      - packet processor instance
- *          lkp_type   - lookup type of list
- *          priority   - interal priority.
- *          highest_pri- current highest priority of list
- *          lowest_pri - current highest priority of list
- *
- * OUTPUTS:
- *          pri_prev   - privious neighbour priority
- *          pri_next   - following(next) neighbour priority
- *
- * RETURNS:
- *	0 on success, error-code otherwise
- * COMMENTS:
- *          The list can not be empty, meet: priority > highest, priority < lowest
- ******************************************************************************/
-static int pp2_cls_c2_lkp_type_list_neighbour_pri_get(struct pp2_inst *inst,
-						      u32 lkp_type,
-						      u32 priority,
-						      u32 highest_pri,
-						      u32 lowest_pri,
-						      u32 *pri_prev,
-						      u32 *pri_next)
-{
-	struct pp2_cls_c2_index_t *c2_index_node;
-	struct pp2_cls_c2_data_t *c2_entry_data;		/*use heap to reduce stack size*/
-	u32 pri_temp_h = 0, pri_temp_l = 0;
-
-	/* para check */
-	if (!pri_prev) {
-		pr_err("%s: null pointer\n", __func__);
-		return -EFAULT;
-	}
-	if (!pri_next) {
-		pr_err("%s: null pointer\n", __func__);
-		return -EFAULT;
-	}
-	if (priority < highest_pri || priority > lowest_pri) {
-		pr_err("Invalid C2 internal priority %d\n", priority);
-		return -EFAULT;
-	}
-
-	if (highest_pri == lowest_pri) {
-		*pri_prev = MVPP2_C2_LKP_TYPE_INVALID_PRI;
-		*pri_next = MVPP2_C2_LKP_TYPE_INVALID_PRI;
-		return 0;
-	}
-
-	c2_entry_data = kmalloc(sizeof(*c2_entry_data), GFP_KERNEL);
-	if (!c2_entry_data)
-		return -ENOMEM;
-
-	memset(c2_entry_data, 0, sizeof(struct pp2_cls_c2_data_t));
-
-	/* Traverse lookup type list */
-	LIST_FOR_EACH_OBJECT(c2_index_node, struct pp2_cls_c2_index_t,
-			     pp2_cls_db_c2_lkp_type_list_head_get(inst, lkp_type),
-			     list_node) {
-		/* get C2 db entry data */
-		if (pp2_cls_db_c2_data_get(inst, c2_index_node->c2_data_db_idx, c2_entry_data)) {
-			free(c2_entry_data);
-			return -EINVAL;
-		}
-		if (priority > c2_entry_data->priority)
-			pri_temp_h = c2_entry_data->priority;
-		if (priority < c2_entry_data->priority && pri_temp_l == 0)
-			pri_temp_l = c2_entry_data->priority;
-	}
-
-	*pri_prev = pri_temp_h;
-	*pri_next = pri_temp_l;
-
-	free(c2_entry_data);
-	return 0;
-}
-
-/*******************************************************************************
- * pp2_cls_c2_lkp_type_pri_node_info_get()
- *
- * DESCRIPTION: Get the node information in the list with the same internal priority,
- *              including, first/last entry node in C2 HW, count of node with same priority
- *
- * INPUTS:
- *          inst       - packet processor instance
- *          lkp_type   - lookup type of list
- *          priority   - internal priority
- *
- * OUTPUTS:
- *          c2_hw_first_node  - first c2 hw node in C2 HW table
- *          c2_hw_last_node   - last c2 hw node in C2 HW table
- *          node_count        - count of node with the same priority
- *
- * RETURNS:
- *	0 on success, error-code otherwise
- * COMMENTS:
- *          None
- ******************************************************************************/
-static int pp2_cls_c2_lkp_type_pri_node_info_get(struct pp2_inst *inst,
-						 u8 lkp_type,
-						 u32 priority,
-						 struct pp2_cls_c2_index_t **c2_hw_first_node,
-						 struct pp2_cls_c2_index_t **c2_hw_last_node,
-						 u32 *node_count)
-{
-	struct pp2_cls_c2_index_t *c2_index_node;
-	struct pp2_cls_c2_data_t *c2_entry_data;		/*use heap to reduce stack size*/
-	int i;
-
-	/* param check */
-	if (!c2_hw_first_node) {
-		pr_err("%s: null pointer\n", __func__);
-		return -EFAULT;
-	}
-	if (!c2_hw_last_node) {
-		pr_err("%s: null pointer\n", __func__);
-		return -EFAULT;
-	}
-	if (!node_count) {
-		pr_err("%s: null pointer\n", __func__);
-		return -EFAULT;
-	}
-	c2_entry_data = kmalloc(sizeof(*c2_entry_data), GFP_KERNEL);
-	if (!c2_entry_data)
-		return -ENOMEM;
-
-	memset(c2_entry_data, 0, sizeof(struct pp2_cls_c2_data_t));
-
-	i = 0;
-	/* Traverse lookup type list */
-	LIST_FOR_EACH_OBJECT(c2_index_node, struct pp2_cls_c2_index_t,
-			     pp2_cls_db_c2_lkp_type_list_head_get(inst, lkp_type),
-			     list_node) {
-		/* get C2 db entry data */
-		if (pp2_cls_db_c2_data_get(inst, c2_index_node->c2_data_db_idx, c2_entry_data)) {
-			free(c2_entry_data);
-			return -EINVAL;
-		}
-		if (c2_entry_data->priority == priority) {
-			if (i == 0) {
-				*c2_hw_first_node = c2_index_node;
-				*c2_hw_last_node = c2_index_node;
-			} else {
-				/* Find the first C2 HW entry in HW table */
-				if ((*c2_hw_first_node)->c2_hw_idx > c2_index_node->c2_hw_idx)
-					*c2_hw_first_node = c2_index_node;
-				/* Find the last C2 HW entry in HW table */
-				if ((*c2_hw_last_node)->c2_hw_idx < c2_index_node->c2_hw_idx)
-					*c2_hw_last_node = c2_index_node;
-			}
-			i++;
-		}
-	}
-
-	/* if no node with pri, return invalid index */
-	if (i == 0) {
-		*c2_hw_first_node = NULL;
-		*c2_hw_last_node = NULL;
-	}
-	*node_count = i;
-
-	free(c2_entry_data);
-	return 0;
-}
-
-/*******************************************************************************
- * pp2_cls_c2_lkp_search_up_block_get()
- *
- * DESCRIPTION: Find the search block between priority pri_start and its privious
- *              neighbour priority.
- *
- * INPUTS:
- *	   inst	      - packet processor instance
- *          lkp_type   - lookup type of list
- *          pri_start  - start priority
- *
- * OUTPUTS:
- *          c2_search_start  - start C2 HW index to search
- *          c2_search_end    - end C2 HW index to search
- *
- * RETURNS:
- *	0 on success, error-code otherwise
- * COMMENTS:
- *          The list can not be empty.
- ******************************************************************************/
-static int pp2_cls_c2_lkp_search_up_block_get(struct pp2_inst *inst,
-					      u8 lkp_type,
-					      u32 pri_start,
-					      u32 *c2_search_start,
-					      u32 *c2_search_end)
-{
-	struct pp2_cls_c2_index_t *c2_index_node;
-	struct pp2_cls_c2_data_t *c2_entry_data;		/*use heap to reduce stack size*/
-	u32 first_pri_find, prev_pri_find;
-	u32 next_pri;
-
-	/* Para check */
-	if (!c2_search_start) {
-		pr_err("%s: null pointer\n", __func__);
-		return -EFAULT;
-	}
-	if (!c2_search_end) {
-		pr_err("%s: null pointer\n", __func__);
-		return -EFAULT;
-	}
-	c2_entry_data = kmalloc(sizeof(*c2_entry_data), GFP_KERNEL);
-	if (!c2_entry_data)
-		return -ENOMEM;
-
-	memset(c2_entry_data, 0, sizeof(struct pp2_cls_c2_data_t));
-
-	first_pri_find = 0;
-	prev_pri_find = 0;
-	next_pri = 0;
-	/* Traverse lookup type list */
-	LIST_FOR_EACH_OBJECT_REVERSE(c2_index_node, struct pp2_cls_c2_index_t,
-				     pp2_cls_db_c2_lkp_type_list_head_get(inst, lkp_type),
-				     list_node) {
-		/* get C2 db entry data */
-		if (pp2_cls_db_c2_data_get(inst, c2_index_node->c2_data_db_idx, c2_entry_data)) {
-			free(c2_entry_data);
-			return -EINVAL;
-		}
-		if (c2_entry_data->priority == pri_start) {
-			if (!first_pri_find) {
-				*c2_search_end = c2_index_node->c2_hw_idx;
-			} else {
-				/* Find the last C2 HW entry in HW table */
-				if (*c2_search_end < c2_index_node->c2_hw_idx)
-					*c2_search_end = c2_index_node->c2_hw_idx;
-			}
-			first_pri_find++;
-		}
-		/* Find the next priority */
-		if (first_pri_find != 0 && c2_entry_data->priority != pri_start) {
-			if (prev_pri_find == 0) {
-				next_pri = c2_entry_data->priority;
-				*c2_search_start = c2_index_node->c2_hw_idx;
-			} else {
-				/* Find the last C2 HW entry in HW table */
-				if (*c2_search_start < c2_index_node->c2_hw_idx)
-					*c2_search_start = c2_index_node->c2_hw_idx;
-			}
-			prev_pri_find++;
-		}
-		/* Stop search */
-		if (prev_pri_find != 0 && c2_entry_data->priority != next_pri)
-			break;
-	}
-	/* if no node with pri, return invalid index */
-	if (first_pri_find == 0)
-		*c2_search_end = MVPP2_C2_ENTRY_INVALID_IDX;
-	if (prev_pri_find == 0) {
-		if (first_pri_find == 0)
-			*c2_search_start = MVPP2_C2_ENTRY_INVALID_IDX;
-		else
-			*c2_search_start = MVPP2_C2_FIRST_ENTRY;
-	}
-
-	free(c2_entry_data);
-	return 0;
-}
-
-/*******************************************************************************
- * pp2_cls_c2_lkp_search_down_block_get()
- *
- * DESCRIPTION: Find the search block between priority pri_start and its next
- *              neighbour priority.
- *
- * INPUTS:
- *	   inst	      - packet processor instance
- *          lkp_type   - lookup type of list
- *          pri_start  - start priority
- *
- * OUTPUTS:
- *          c2_search_start  - start C2 HW index to search
- *          c2_search_end    - end C2 HW index to search
- *
- * RETURNS:
- *	0 on success, error-code otherwise
- * COMMENTS:
- *          The list can not be empty.
- ******************************************************************************/
-static int pp2_cls_c2_lkp_search_down_block_get(struct pp2_inst *inst,
-						u8 lkp_type,
-						u32 pri_start,
-						u32 *c2_search_start,
-						u32 *c2_search_end)
-{
-	struct pp2_cls_c2_index_t *c2_index_node;
-	struct pp2_cls_c2_data_t *c2_entry_data;		/*use heap to reduce stack size*/
-	u32 first_pri_find, next_pri_find;
-	u32 next_pri;
-
-	/* Para check */
-	if (!c2_search_start) {
-		pr_err("%s: null pointer\n", __func__);
-		return -EFAULT;
-	}
-	if (!c2_search_end) {
-		pr_err("%s: null pointer\n", __func__);
-		return -EFAULT;
-	}
-	c2_entry_data = kmalloc(sizeof(*c2_entry_data), GFP_KERNEL);
-	if (!c2_entry_data)
-		return -ENOMEM;
-
-	memset(c2_entry_data, 0, sizeof(struct pp2_cls_c2_data_t));
-
-	first_pri_find = 0;
-	next_pri_find = 0;
-	next_pri = 0;
-	/* Traverse lookup type list */
-	LIST_FOR_EACH_OBJECT(c2_index_node, struct pp2_cls_c2_index_t,
-			     pp2_cls_db_c2_lkp_type_list_head_get(inst, lkp_type),
-			     list_node) {
-		/* get C2 db entry data */
-		if (pp2_cls_db_c2_data_get(inst, c2_index_node->c2_data_db_idx, c2_entry_data)) {
-			free(c2_entry_data);
-			return -EINVAL;
-		}
-		if (c2_entry_data->priority == pri_start) {
-			if (first_pri_find == 0) {
-				*c2_search_start = c2_index_node->c2_hw_idx;
-			} else {
-				/* Find the first C2 HW entry in HW table */
-				if (*c2_search_start > c2_index_node->c2_hw_idx)
-					*c2_search_start = c2_index_node->c2_hw_idx;
-			}
-			first_pri_find++;
-		}
-		/* Find the next priority */
-		if (first_pri_find != 0 && c2_entry_data->priority > pri_start) {
-			if (next_pri_find == 0) {
-				next_pri = c2_entry_data->priority;
-				*c2_search_end = c2_index_node->c2_hw_idx;
-			} else {
-				/* Find the first C2 HW entry in HW table */
-				if (*c2_search_end > c2_index_node->c2_hw_idx)
-					*c2_search_end = c2_index_node->c2_hw_idx;
-			}
-			next_pri_find++;
-		}
-		/* Stop search */
-		if (next_pri_find != 0 && c2_entry_data->priority > next_pri)
-			break;
-	}
-	/* if no node with pri, return invalid index */
-	if (first_pri_find == 0)
-		*c2_search_start = MVPP2_C2_ENTRY_INVALID_IDX;
-	if (next_pri_find == 0) {
-		if (first_pri_find == 0)
-			*c2_search_end = MVPP2_C2_ENTRY_INVALID_IDX;
-		else
-			*c2_search_end = MVPP2_C2_LAST_ENTRY;
-	}
-
-	free(c2_entry_data);
-	return 0;
-}
-
 /*******************************************************************************
  * pp2_cls_c2_lkp_type_list_add()
  *
@@ -751,6 +386,7 @@ static int pp2_cls_c2_lkp_type_list_add(struct pp2_inst *inst,
 	c2_index_node->c2_hw_idx = c2_hw_idx;
 	c2_index_node->c2_data_db_idx = c2_db_idx;
 	c2_index_node->c2_logic_idx = c2_logic_idx;
+	c2_index_node->moved_hits = 0;
 
 	/* Check lkp list is empty or not */
 	if (list_is_empty(lkp_type_list_head)) {
@@ -848,486 +484,238 @@ static int pp2_cls_c2_entry_is_free(struct pp2_inst *inst, u32 c2_hw_idx,
 }
 
 /*******************************************************************************
- * pp2_cls_c2_free_slot_find
- *
- * DESCRIPTION: The API will find the first free slot between index1 and index2.
- *              If found free slot, delete it from free list.
- * INPUTS:
- *           inst    - packet processor instance
- *           index1  - first C2 entry index occupied
- *           index2  - second C2 entry index occupied
- *
- * OUTPUTS:
- *           c2_hw_idx - Free C2 HW entry index
+ * pp2_cls_c2_slot_move_add
  *
- * RETURNS:
- *	0 on success, error-code otherwise
- * COMMENTS:
- *           index2 must greater than index1.
+ * DESCRIPTION: Record one entry move in the slot map and the move list.
  ******************************************************************************/
-static int pp2_cls_c2_free_slot_find(struct pp2_inst *inst, u32 index1,
-				     u32 index2,
-				     u32 *free_idx)
+static void pp2_cls_c2_slot_move_add(struct pp2_cls_c2_slot_map *map, u32 from, u32 to,
+				     struct pp2_cls_c2_slot_move *moves, u32 *num_moves)
 {
-	struct pp2_cls_c2_index_t *c2_index_node;
-	int found = 0;
-
-	if (!free_idx) {
-		pr_err("%s: null pointer\n", __func__);
-		return -EFAULT;
-	}
-	if (index1 >= index2) {
-		*free_idx = MVPP2_C2_ENTRY_INVALID_IDX;
-		return 0;
-	}
-	/* Traverse free list */
-	LIST_FOR_EACH_OBJECT(c2_index_node, struct pp2_cls_c2_index_t,
-			     pp2_cls_db_c2_free_list_head_get(inst), list_node) {
-		if ((c2_index_node->c2_hw_idx > index1) &&
-		    (c2_index_node->c2_hw_idx < index2)) {
-			found++;
-			/* delete it from free list */
-			list_del(&c2_index_node->list_node);
-			/* Change to node valid status to invalid */
-			c2_index_node->valid = MVPP2_C2_ENTRY_INVALID;
-			*free_idx = c2_index_node->c2_hw_idx;
-			break;
-		}
-	}
-	if (found == 0)
-		*free_idx = MVPP2_C2_ENTRY_INVALID_IDX;
-
-	return 0;
+	moves[*num_moves].from = from;
+	moves[*num_moves].to = to;
+	(*num_moves)++;
+	map->priority[to] = map->priority[from];
+	map->used[to] = 1;
+	map->used[from] = 0;
 }
 
 /*******************************************************************************
- * pp2_cls_c2_make_slot_high()
+ * pp2_cls_c2_slot_shift
  *
- * DESCRIPTION: This routine is sub routine of "pp2_cls_c2_make_slot"
+ * DESCRIPTION: Make room at the window edge by moving one entry per priority band
+ *              toward the free slot, the first entry of a band taking the slot
+ *              after the band's last entry.
  *
  * INPUTS:
- *	   inst	      - packet processor instance
- *          lkp_type   - lookup type
- *          priority   - priority for new slot
- *          highest_pri- highest priority of current lookup type list
- *          lowest_pri - lowest priority of current lookup type list
+ *           map       - slot map
+ *           free_slot - free slot to shift into
+ *           edge      - first slot to free, hi when shifting up, lo when shifting down
+ *
  * OUTPUTS:
- *          c2_hw_idx  - available C2 TCAM index for new rule
+ *           moves     - moves made, in order
+ *           num_moves - number of moves
+ *
  * RETURNS:
- *	0 on success, error-code otherwise
- * COMMENTS:
- *           The lkp_type list can not be empty.
- *           priority <= highest_pri
+ *           The slot freed for the new entry.
  ******************************************************************************/
-static int pp2_cls_c2_make_slot_high(struct pp2_inst *inst,
-				     u32 lkp_type,
-				     u32 priority,
-				     u32 highest_pri,
-				     u32 lowest_pri,
-				     u32 *c2_hw_idx)
+static u32 pp2_cls_c2_slot_shift(struct pp2_cls_c2_slot_map *map, u32 free_slot, u32 edge,
+				 struct pp2_cls_c2_slot_move *moves, u32 *num_moves)
 {
-	int ret_code;
-	struct pp2_cls_c2_index_t *c2_index_node = NULL, *c2_first_node = NULL, *c2_last_node = NULL;
-	u32 free_idx, pp2_cls_idx, node_count;
-	u32 c2_search_start, c2_search_end;
-	int pri_tmp, i;
-	struct mv_pp2x_cls_c2_entry c2_entry;
-	uintptr_t cpu_slot = pp2_default_cpu_slot(inst);
-
-	/* No need to agjust C2 way */
-	if (pp2_cls_c2_entry_is_free(inst, MVPP2_C2_FIRST_ENTRY, &c2_index_node) == MVPP2_C2_ENTRY_FREE_TRUE) {
-		/* delete it from free list */
-		list_del(&c2_index_node->list_node);
-		/* Change to node valid status to invalid */
-		c2_index_node->valid = MVPP2_C2_ENTRY_INVALID;
-		/* return c2 hw index */
-		*c2_hw_idx = MVPP2_C2_FIRST_ENTRY;
-		return 0;
-	}
-
-	ret_code = pp2_cls_c2_lkp_type_pri_node_info_get(inst,
-							 lkp_type,
-							 highest_pri,
-							 &c2_first_node,
-							 &c2_last_node,
-							 &node_count);
-	if (ret_code) {
-		pr_err("C2 lookup type list(%d) priority (%d) node info get failed\n",
-		       lkp_type, highest_pri);
-		return -EINVAL;
-	}
-	if (c2_first_node &&
-	    c2_first_node->c2_hw_idx > MVPP2_C2_FIRST_ENTRY) {
-		/* Find the available slot */
-		ret_code = pp2_cls_c2_free_slot_find(inst, MVPP2_C2_FIRST_ENTRY, c2_first_node->c2_hw_idx, &free_idx);
-		if (ret_code) {
-			pr_err("No found free slot between entry(%d) and entry(%d)\n",
-			       MVPP2_C2_FIRST_ENTRY, c2_first_node->c2_hw_idx);
-			return -EINVAL;
-		}
-		if (free_idx != MVPP2_C2_ENTRY_INVALID_IDX) {
-			/* return c2 hw index */
-			*c2_hw_idx = free_idx;
-			return 0;
+	u32 cur = free_slot, first;
+
+	if (free_slot > edge) {
+		while (cur > edge) {
+			first = cur - 1;
+			while (first > edge && map->priority[first - 1] == map->priority[cur - 1])
+				first--;
+			pp2_cls_c2_slot_move_add(map, first, cur, moves, num_moves);
+			cur = first;
 		}
-	}
-
-	/* Search down and adjust C2 original entries */
-	for (pri_tmp = highest_pri; pri_tmp <= lowest_pri; pri_tmp++) {
-		/* Get search block */
-		ret_code = pp2_cls_c2_lkp_search_down_block_get(inst,
-								lkp_type,
-								pri_tmp,
-								&c2_search_start,
-								&c2_search_end);
-		if (ret_code) {
-			pr_err("Search blcok get failed\n");
-			return -EINVAL;
-		}
-		if (c2_search_start != MVPP2_C2_ENTRY_INVALID_IDX) {
-			ret_code = pp2_cls_c2_free_slot_find(inst, c2_search_start, c2_search_end, &free_idx);
-			if (ret_code) {
-				pr_err("No found free slot between (%d) and (%d)\n",
-				       c2_search_start, c2_search_end);
-				return -EINVAL;
-			}
-			if (free_idx != MVPP2_C2_ENTRY_INVALID_IDX) {
-				/* Find free entry, adjust C2 table */
-				for (i = pri_tmp; i >= (int)highest_pri; i--) {
-					pp2_cls_idx = free_idx;
-					/* Find the first entry with priority found free slot */
-					ret_code = pp2_cls_c2_lkp_type_pri_node_info_get(inst,
-											 lkp_type,
-											 i,
-											 &c2_first_node,
-											 &c2_last_node,
-											 &node_count);
-					if (ret_code)
-						return -EINVAL;
-					if (c2_first_node) {
-						mv_pp2x_c2_sw_clear(&c2_entry);
-						mv_pp2x_cls_c2_hw_read(cpu_slot, c2_first_node->c2_hw_idx, &c2_entry);
-						mv_pp2x_cls_c2_hw_write(cpu_slot, free_idx, &c2_entry);
-						/* Continue next move */
-						free_idx = c2_first_node->c2_hw_idx;
-						/* Update C2 index node of the lookup type */
-						c2_first_node->c2_hw_idx = pp2_cls_idx;
-					}
-				}
-				*c2_hw_idx = free_idx;
-				return 0;
-			}
+	} else {
+		while (cur < edge) {
+			first = cur + 1;
+			while (first < edge && map->priority[first + 1] == map->priority[cur + 1])
+				first++;
+			pp2_cls_c2_slot_move_add(map, first, cur, moves, num_moves);
+			cur = first;
 		}
 	}
-
-	return -EINVAL;
+	return cur;
 }
 
 /*******************************************************************************
- * pp2_cls_c2_make_slot_middle()
+ * pp2_cls_c2_slot_spread
  *
- * DESCRIPTION: This routine is sub routine of "pp2_cls_c2_make_slot"
+ * DESCRIPTION: Spread the entries of the smallest region around the insertion
+ *              point that is at most MVPP2_C2_SLOT_DENSITY full, new entry
+ *              included, evenly over the region, so later inserts find gaps.
  *
  * INPUTS:
- *	   inst	      - packet processor instance
- *          lkp_type   - lookup type
- *          priority   - priority for new slot
- *          highest_pri- highest priority of current lookup type list
- *          lowest_pri - lowest priority of current lookup type list
+ *           map       - slot map
+ *           pos       - slot the new entry goes in front of (num_slots for last)
+ *
  * OUTPUTS:
- *          c2_hw_idx  - available C2 TCAM index for new rule
+ *           moves     - moves made, in order
+ *           num_moves - number of moves
+ *
  * RETURNS:
- *	0 on success, error-code otherwise
- * COMMENTS:
- *           The lkp_type list can not be empty.
- *            priority > highest_pri; priority < lowest_pri
+ *           The slot for the new entry.
  ******************************************************************************/
-static int pp2_cls_c2_make_slot_middle(struct pp2_inst *inst,
-				       u32 lkp_type,
-				       u32 priority,
-				       u32 highest_pri,
-				       u32 lowest_pri,
-				       u32 *c2_hw_idx)
+static u32 pp2_cls_c2_slot_spread(struct pp2_cls_c2_slot_map *map, u32 pos,
+				  struct pp2_cls_c2_slot_move *moves, u32 *num_moves)
 {
-	int ret_code;
-	struct pp2_cls_c2_index_t *c2_index_node = NULL, *c2_first_node = NULL, *c2_last_node = NULL;
-	u32 free_idx, pp2_cls_idx, node_count;
-	u32 c2_search_start, c2_search_end, pri_prev, pri_next;
-	int pri_tmp, i;
-	struct mv_pp2x_cls_c2_entry c2_entry;
-	uintptr_t cpu_slot = pp2_default_cpu_slot(inst);
-
-	/* No need adjust other C2 entry way */
-	ret_code = pp2_cls_c2_lkp_type_list_neighbour_pri_get(inst,
-							      lkp_type,
-							      priority,
-							      highest_pri,
-							      lowest_pri,
-							      &pri_prev,
-							      &pri_next);
-	if (ret_code)
-		return -EINVAL;
-	/* Get node info with priority */
-	if (pri_prev != MVPP2_C2_LKP_TYPE_INVALID_PRI) {
-		ret_code = pp2_cls_c2_lkp_type_pri_node_info_get(inst,
-								 lkp_type,
-								 pri_prev,
-								 &c2_first_node,
-								 &c2_last_node,
-								 &node_count);
-		if (ret_code)
-			return -EINVAL;
-		if (c2_last_node)
-			c2_search_start = c2_last_node->c2_hw_idx;
-	}
-	if (pri_next != MVPP2_C2_LKP_TYPE_INVALID_PRI) {
-		ret_code = pp2_cls_c2_lkp_type_pri_node_info_get(inst,
-								 lkp_type,
-								 pri_next,
-								 &c2_first_node,
-								 &c2_last_node,
-								 &node_count);
-		if (ret_code)
-			return -EINVAL;
-		if (c2_first_node)
-			c2_search_end = c2_first_node->c2_hw_idx;
-	}
-	/* Find the available before first node */
-	ret_code = pp2_cls_c2_free_slot_find(inst, c2_search_start, c2_search_end, &free_idx);
-	if (ret_code) {
-		pr_err("No found free slot between (%d) and (%d) on C2 engine\n",
-		       c2_search_start, c2_search_end);
-		return -EINVAL;
-	}
-	if (free_idx != MVPP2_C2_ENTRY_INVALID_IDX) {
-		/* return c2 hw index */
-		*c2_hw_idx = free_idx;
-
-		return 0;
-	}
-
-	/* Search up and adjust C2 original entries */
-	for (pri_tmp = pri_prev; pri_tmp >= (int)highest_pri; pri_tmp--) {
-		/* Get search block */
-		ret_code = pp2_cls_c2_lkp_search_up_block_get(inst,
-							      lkp_type,
-							      pri_tmp,
-							      &c2_search_start,
-							      &c2_search_end);
-		if (c2_search_end != MVPP2_C2_ENTRY_INVALID_IDX) {
-			/* Special handle entry 0 */
-			if (c2_search_start == MVPP2_C2_FIRST_ENTRY &&
-			    pp2_cls_c2_entry_is_free(inst, c2_search_start, &c2_index_node) ==
-							MVPP2_C2_ENTRY_FREE_TRUE) {
-				/* delete it from free list */
-				list_del(&c2_index_node->list_node);
-				/* Change to node valid status to invalid */
-				c2_index_node->valid = MVPP2_C2_ENTRY_INVALID;
-				free_idx = c2_search_start;
-			} else {
-				ret_code = pp2_cls_c2_free_slot_find(inst, c2_search_start, c2_search_end, &free_idx);
-				if (ret_code) {
-					pr_err("No found free slot between (%d) and (%d) failed\n",
-					       c2_search_start, c2_search_end);
-					return -EINVAL;
-				}
-			}
-			if (free_idx != MVPP2_C2_ENTRY_INVALID_IDX) {
-				/* Find free entry, adjust C2 table */
-				for (i = pri_tmp; i <= pri_prev; i++) {
-					pp2_cls_idx = free_idx;
-					/* Find the first entry with priority found free slot */
-					ret_code = pp2_cls_c2_lkp_type_pri_node_info_get(inst,
-											 lkp_type,
-											 i,
-											 &c2_first_node,
-											 &c2_last_node,
-											 &node_count);
-					if (ret_code)
-						return -EINVAL;
-					if (c2_last_node) {
-						mv_pp2x_c2_sw_clear(&c2_entry);
-						mv_pp2x_cls_c2_hw_read(cpu_slot, c2_last_node->c2_hw_idx, &c2_entry);
-						mv_pp2x_cls_c2_hw_write(cpu_slot, free_idx, &c2_entry);
-						/* Continue next move */
-						free_idx = c2_last_node->c2_hw_idx;
-						/* Update C2 index node of the lookup type */
-						c2_last_node->c2_hw_idx = pp2_cls_idx;
-					}
-				}
-				*c2_hw_idx = free_idx;
-				return 0;
-			}
+	u16 cur[MVPP2_C2_ENTRY_MAX + 1], tgt[MVPP2_C2_ENTRY_MAX + 1];
+	u32 num = map->num_slots, size, start, i, cnt, new_pos = 0;
+	int j;
+
+	for (size = 2; ; size *= 2) {
+		if (size >= num) {
+			size = num;
+			start = 0;
+		} else {
+			start = (pos > size / 2) ? pos - size / 2 : 0;
+			if (start + size > num)
+				start = num - size;
 		}
+		for (i = start, cnt = 0; i < start + size; i++)
+			cnt += map->used[i];
+		if ((cnt + 1) * MVPP2_C2_SLOT_DENSITY_DEN <= size * MVPP2_C2_SLOT_DENSITY_NUM || size == num)
+			break;
 	}
 
-	/* Search down and adjust C2 original entries */
-	for (pri_tmp = pri_next; pri_tmp <= (int)lowest_pri; pri_tmp++) {
-		/* Get search block */
-		ret_code = pp2_cls_c2_lkp_search_down_block_get(inst,
-								lkp_type,
-								pri_tmp,
-								&c2_search_start,
-								&c2_search_end);
-		if (c2_search_start != MVPP2_C2_ENTRY_INVALID_IDX) {
-			ret_code = pp2_cls_c2_free_slot_find(inst, c2_search_start, c2_search_end, &free_idx);
-			if (ret_code) {
-				pr_err("No found free slot between (%d) and (%d) failed\n",
-				       c2_search_start, c2_search_end);
-				return -EINVAL;
-			}
-			if (free_idx != MVPP2_C2_ENTRY_INVALID_IDX) {
-				/* Find free entry, adjust C2 table */
-				for (i = pri_tmp; i >= pri_next; i--) {
-					pp2_cls_idx = free_idx;
-					/* Find the first entry with priority found free slot */
-					ret_code = pp2_cls_c2_lkp_type_pri_node_info_get(inst,
-											 lkp_type,
-											 i,
-											 &c2_first_node,
-											 &c2_last_node,
-											 &node_count);
-					if (ret_code)
-						return -EINVAL;
-					if (c2_last_node) {
-						mv_pp2x_c2_sw_clear(&c2_entry);
-						mv_pp2x_cls_c2_hw_read(cpu_slot, c2_first_node->c2_hw_idx, &c2_entry);
-						mv_pp2x_cls_c2_hw_write(cpu_slot, free_idx, &c2_entry);
-						/* Continue next move */
-						free_idx = c2_first_node->c2_hw_idx;
-						/* Update C2 index node of the lookup type */
-						c2_first_node->c2_hw_idx = pp2_cls_idx;
-					}
-				}
-				*c2_hw_idx = free_idx;
-				return 0;
-			}
+	/* Current positions in order, the new entry marked by the invalid slot */
+	for (i = start, cnt = 0; i < start + size; i++) {
+		if (i == pos) {
+			new_pos = cnt;
+			cur[cnt++] = MVPP2_C2_ENTRY_MAX;
 		}
+		if (map->used[i])
+			cur[cnt++] = i;
 	}
+	if (pos >= start + size) {
+		new_pos = cnt;
+		cur[cnt++] = MVPP2_C2_ENTRY_MAX;
+	}
+	for (i = 0; i < cnt; i++)
+		tgt[i] = start + ((2 * i + 1) * size) / (2 * cnt);
 
-	return -EINVAL;
+	/* Entries moving up go first, highest first, then entries moving down, lowest first,
+	 * so a target is always free when written.
+	 */
+	for (j = cnt - 1; j >= 0; j--)
+		if (j != new_pos && tgt[j] > cur[j])
+			pp2_cls_c2_slot_move_add(map, cur[j], tgt[j], moves, num_moves);
+	for (j = 0; j < (int)cnt; j++)
+		if (j != new_pos && tgt[j] < cur[j])
+			pp2_cls_c2_slot_move_add(map, cur[j], tgt[j], moves, num_moves);
+
+	return tgt[new_pos];
 }
 
 /*******************************************************************************
- * pp2_cls_c2_make_slot_low()
+ * pp2_cls_c2_slot_alloc
  *
- * DESCRIPTION: This routine is sub routine of "pp2_cls_c2_make_slot"
+ * DESCRIPTION: Find a slot for a new entry in the slot map of a lookup type,
+ *              keeping entries ordered by priority (lower value in lower index)
+ *              and moving as few entries as possible.
+ *
+ *              A free slot between the entries of lower and higher priority is
+ *              taken directly; between two priority bands the middle free slot
+ *              is taken so both sides keep room. If there is none, the bands
+ *              are shifted toward the nearest free slot when that takes at most
+ *              MVPP2_C2_SLOT_SHIFT_MAX moves, otherwise the region around the
+ *              insertion point is re-spread to leave gaps.
  *
  * INPUTS:
- *	   inst	      - packet processor instance
- *          lkp_type   - lookup type
- *          priority   - priority for new slot
- *          highest_pri- highest priority of current lookup type list
- *          lowest_pri - lowest priority of current lookup type list
+ *           map       - slot map, updated with the moves and the new entry
+ *           priority  - priority of the new entry
+ *
  * OUTPUTS:
- *          c2_hw_idx  - available C2 TCAM index for new rule
+ *           slot      - slot map index for the new entry
+ *           moves     - moves to apply in order, room for map->num_slots moves
+ *           num_moves - number of moves
+ *
  * RETURNS:
  *	0 on success, error-code otherwise
- * COMMENTS:
- *           The lkp_type list can not be empty.
- *           priority >= lowest_pri
  ******************************************************************************/
-static int pp2_cls_c2_make_slot_low(struct pp2_inst *inst,
-				    u32 lkp_type,
-				    u32 priority,
-				    u32 highest_pri,
-				    u32 lowest_pri,
-				    u32 *c2_hw_idx)
+int pp2_cls_c2_slot_alloc(struct pp2_cls_c2_slot_map *map, u32 priority, u32 *slot,
+			  struct pp2_cls_c2_slot_move *moves, u32 *num_moves)
 {
-	int ret_code;
-	struct pp2_cls_c2_index_t *c2_index_node = NULL, *c2_first_node = NULL, *c2_last_node = NULL;
-	u32 free_idx, pp2_cls_idx, node_count;
-	u32 c2_search_start, c2_search_end;
-	int pri_tmp, i;
-	struct mv_pp2x_cls_c2_entry c2_entry;
-	uintptr_t cpu_slot = pp2_default_cpu_slot(inst);
+	u32 num, i, n_free = 0, k, up_cost = 0, down_cost = 0;
+	int lo = -1, hi, up = -1, down = -1;
 
-	/* No need adjust other C2 entry way */
-	/* get last node with lowest priority */
-	ret_code = pp2_cls_c2_lkp_type_pri_node_info_get(inst,
-							 lkp_type,
-							 lowest_pri,
-							 &c2_first_node,
-							 &c2_last_node,
-							 &node_count);
-	if (ret_code) {
-		pr_err("Lookup type list(%d) priority (%d) node info get failed\n",
-		       lkp_type, lowest_pri);
+	if (!map || !slot || !moves || !num_moves) {
+		pr_err("%s: null pointer\n", __func__);
+		return -EFAULT;
+	}
+	num = map->num_slots;
+	hi = num;
+	*num_moves = 0;
+
+	/* Window (lo, hi) between the last lower and the first higher priority entry */
+	for (i = 0; i < num; i++) {
+		if (!map->used[i])
+			continue;
+		if (map->priority[i] < priority)
+			lo = i;
+		else if (map->priority[i] > priority && hi == (int)num)
+			hi = i;
+	}
+	if (lo >= hi) {
+		pr_err("C2 slot map out of priority order\n");
 		return -EINVAL;
 	}
-	/* try to find the slot after last node with lowest_pri */
-	if (c2_last_node) {
-		/* Find the available slot */
-		ret_code = pp2_cls_c2_free_slot_find(inst, c2_last_node->c2_hw_idx, MVPP2_C2_LAST_ENTRY, &free_idx);
-		if (ret_code) {
-			pr_err("Free slot between (%d) and (%d) failed\n",
-			       c2_last_node->c2_hw_idx, MVPP2_C2_LAST_ENTRY);
-			return -EINVAL;
-		}
-		if (free_idx != MVPP2_C2_ENTRY_INVALID_IDX) {
-			/* return c2 hw index */
-			*c2_hw_idx = free_idx;
 
-			return 0;
+	for (i = lo + 1; (int)i < hi; i++)
+		n_free += !map->used[i];
+
+	if (n_free) {
+		if (lo >= 0 && hi < (int)num)
+			k = n_free / 2;
+		else if (hi < (int)num)
+			k = n_free - 1;
+		else
+			k = 0;
+		for (i = lo + 1; ; i++) {
+			if (map->used[i])
+				continue;
+			if (!k--)
+				break;
 		}
-	}
-	/* find available slot above node with current lowest priority */
-	/* Search up and adjust C2 original entries */
-	for (pri_tmp = lowest_pri; pri_tmp >= (int)highest_pri; pri_tmp--) {
-		/* Get search block */
-		ret_code = pp2_cls_c2_lkp_search_up_block_get(inst,
-							      lkp_type,
-							      pri_tmp,
-							      &c2_search_start,
-							      &c2_search_end);
-		if (c2_search_end != MVPP2_C2_ENTRY_INVALID_IDX) {
-			/* Special handle entry 0 */
-			if (c2_search_start == MVPP2_C2_FIRST_ENTRY &&
-			    pp2_cls_c2_entry_is_free(inst, c2_search_start, &c2_index_node) ==
-											MVPP2_C2_ENTRY_FREE_TRUE) {
-				/* delete it from free list */
-				list_del(&c2_index_node->list_node);
-				/* Change to node valid status to invalid */
-				c2_index_node->valid = MVPP2_C2_ENTRY_INVALID;
-				free_idx = c2_search_start;
-			} else {
-				ret_code = pp2_cls_c2_free_slot_find(inst, c2_search_start, c2_search_end, &free_idx);
-				if (ret_code) {
-					pr_err("Free slot between (%d) and (%d) failed\n",
-					       c2_search_start, c2_search_end);
-					return -EINVAL;
-				}
+		*slot = i;
+	} else {
+		/* Nearest free slot on each side and the number of bands in the way */
+		for (i = hi; i < num; i++) {
+			if (!map->used[i]) {
+				up = i;
+				break;
 			}
-			if (free_idx != MVPP2_C2_ENTRY_INVALID_IDX) {
-				/* Find free entry, adjust C2 table */
-				for (i = pri_tmp; i <= (int)lowest_pri; i++) {
-					pp2_cls_idx = free_idx;
-					/* Find the first entry with priority found free slot */
-					ret_code = pp2_cls_c2_lkp_type_pri_node_info_get(inst,
-											 lkp_type,
-											 i,
-											 &c2_first_node,
-											 &c2_last_node,
-											 &node_count);
-					if (ret_code)
-						return -EINVAL;
-					if (c2_last_node) {
-						mv_pp2x_c2_sw_clear(&c2_entry);
-						mv_pp2x_cls_c2_hw_read(cpu_slot, c2_last_node->c2_hw_idx, &c2_entry);
-						mv_pp2x_cls_c2_hw_write(cpu_slot, free_idx, &c2_entry);
-						/* Continue next move */
-						free_idx = c2_last_node->c2_hw_idx;
-						/* Update C2 index node of the lookup type */
-						c2_last_node->c2_hw_idx = pp2_cls_idx;
-					}
-				}
-				*c2_hw_idx = free_idx;
-				return 0;
+			if (i == (u32)hi || map->priority[i] != map->priority[i - 1])
+				up_cost++;
+		}
+		for (i = lo; lo >= 0 && (int)i >= 0; i--) {
+			if (!map->used[i]) {
+				down = i;
+				break;
 			}
+			if (i == (u32)lo || map->priority[i] != map->priority[i + 1])
+				down_cost++;
+		}
+		if (up < 0 && down < 0) {
+			pr_err("No free C2 slot for priority %d\n", priority);
+			return -ENOSPC;
 		}
+		if (up >= 0 && (down < 0 || up_cost <= down_cost) && up_cost <= MVPP2_C2_SLOT_SHIFT_MAX)
+			*slot = pp2_cls_c2_slot_shift(map, up, hi, moves, num_moves);
+		else if (down >= 0 && down_cost <= MVPP2_C2_SLOT_SHIFT_MAX)
+			*slot = pp2_cls_c2_slot_shift(map, down, lo, moves, num_moves);
+		else
+			*slot = pp2_cls_c2_slot_spread(map, hi, moves, num_moves);
 	}
 
-	return -EINVAL;
+	map->used[*slot] = 1;
+	map->priority[*slot] = priority;
+	return 0;
 }
 
 /*******************************************************************************
@@ -1345,6 +733,10 @@ static int pp2_cls_c2_make_slot_low(struct pp2_inst *inst,
  *
  * RETURNS:
  *	0 on success, error-code otherwise
+ * COMMENTS:
+ *           Moved entries are copied to their new index and keep their logical
+ *           index. HW hit counters are clear on read and stay at the HW index,
+ *           so the counter of a moved entry is harvested into moved_hits first.
  ******************************************************************************/
 static int pp2_cls_c2_make_slot(struct pp2_inst *inst,
 				u8 lkp_type,
@@ -1353,7 +745,15 @@ static int pp2_cls_c2_make_slot(struct pp2_inst *inst,
 {
 	int ret_code = 0;
 	struct pp2_cls_c2_index_t *c2_index_node = NULL;
-	u32 highest_pri = 0, lowest_pri = 0;
+	struct pp2_cls_c2_index_t **lkp_node;		/* lookup type node per HW index */
+	struct pp2_cls_c2_data_t *c2_entry_data;	/*use heap to reduce stack size*/
+	struct pp2_cls_c2_slot_map *map;
+	struct pp2_cls_c2_slot_move *moves;
+	struct pp2_cls_c2_slot_stats *stats;
+	struct mv_pp2x_cls_c2_entry c2_entry;
+	u8 *state;
+	u32 i, slot, num_moves = 0, from, to, cnt;
+	uintptr_t cpu_slot = pp2_default_cpu_slot(inst);
 
 	/* Patameter check */
 	if (!c2_hw_idx) {
@@ -1366,38 +766,99 @@ static int pp2_cls_c2_make_slot(struct pp2_inst *inst,
 		return -EINVAL;
 	}
 
-	/* lkp type list empty, find any available slot */
-	if (list_is_empty(pp2_cls_db_c2_lkp_type_list_head_get(inst, lkp_type))) {
-		c2_index_node = LIST_FIRST_OBJECT(pp2_cls_db_c2_free_list_head_get(inst),
-						  struct pp2_cls_c2_index_t,
-						  list_node);
-		/* delete it from free list */
-		list_del(&c2_index_node->list_node);
-		/* Change to node valid status to invalid */
-		c2_index_node->valid = MVPP2_C2_ENTRY_INVALID;
-		/* return c2 hw index */
-		*c2_hw_idx = c2_index_node->c2_hw_idx;
-		return 0;
+	map = kcalloc(1, sizeof(*map), GFP_KERNEL);
+	moves = kcalloc(MVPP2_C2_ENTRY_MAX, sizeof(*moves), GFP_KERNEL);
+	lkp_node = kcalloc(MVPP2_C2_ENTRY_MAX, sizeof(*lkp_node), GFP_KERNEL);
+	state = kcalloc(MVPP2_C2_ENTRY_MAX, sizeof(*state), GFP_KERNEL);
+	c2_entry_data = kcalloc(1, sizeof(*c2_entry_data), GFP_KERNEL);
+	if (!map || !moves || !lkp_node || !state || !c2_entry_data) {
+		pr_err("%s: no memory\n", __func__);
+		ret_code = -ENOMEM;
+		goto out;
 	}
 
-	/* Get the highest priority and lowest priority */
-	ret_code = pp2_cls_c2_lkp_type_list_pri_get(inst, lkp_type, &highest_pri, &lowest_pri);
-	if (ret_code != 0) {
-		pr_err("Lookup type list(%d) priority get failed\n", lkp_type);
-		return -EINVAL;
+	/* Build the slot map from the free list and the lookup type list */
+	LIST_FOR_EACH_OBJECT(c2_index_node, struct pp2_cls_c2_index_t,
+			     pp2_cls_db_c2_free_list_head_get(inst), list_node)
+		state[c2_index_node->c2_hw_idx] = 1;
+	LIST_FOR_EACH_OBJECT(c2_index_node, struct pp2_cls_c2_index_t,
+			     pp2_cls_db_c2_lkp_type_list_head_get(inst, lkp_type), list_node) {
+		ret_code = pp2_cls_db_c2_data_get(inst, c2_index_node->c2_data_db_idx, c2_entry_data);
+		if (ret_code) {
+			pr_err("recvd ret_code(%d)\n", ret_code);
+			goto out;
+		}
+		state[c2_index_node->c2_hw_idx] = 2;
+		lkp_node[c2_index_node->c2_hw_idx] = c2_index_node;
+		map->priority[c2_index_node->c2_hw_idx] = c2_entry_data->priority;
+	}
+	for (i = MVPP2_C2_FIRST_ENTRY; i < MVPP2_C2_ENTRY_MAX; i++) {
+		if (!state[i])
+			continue;
+		map->hw_idx[map->num_slots] = i;
+		map->used[map->num_slots] = (state[i] == 2);
+		map->priority[map->num_slots] = map->priority[i];
+		map->num_slots++;
 	}
 
-	/* According to priority and current priority in list, search available slot */
-	if (priority <= highest_pri)
-		ret_code = pp2_cls_c2_make_slot_high(inst, lkp_type, priority, highest_pri,
-						     lowest_pri, c2_hw_idx);
-	else if (priority >= lowest_pri)
-		ret_code = pp2_cls_c2_make_slot_low(inst, lkp_type, priority, highest_pri,
-						    lowest_pri, c2_hw_idx);
-	else
-		ret_code = pp2_cls_c2_make_slot_middle(inst, lkp_type, priority, highest_pri,
-						       lowest_pri, c2_hw_idx);
+	ret_code = pp2_cls_c2_slot_alloc(map, priority, &slot, moves, &num_moves);
+	if (ret_code) {
+		pr_err("No C2 slot for lookup type %d, priority %d\n", lkp_type, priority);
+		goto out;
+	}
+
+	/* Apply the moves in order, a move target is always free */
+	for (i = 0; i < num_moves; i++) {
+		from = map->hw_idx[moves[i].from];
+		to = map->hw_idx[moves[i].to];
+		if (pp2_cls_c2_entry_is_free(inst, to, &c2_index_node) == MVPP2_C2_ENTRY_FREE_TRUE) {
+			list_del(&c2_index_node->list_node);
+			c2_index_node->valid = MVPP2_C2_ENTRY_INVALID;
+		}
+		/* keep the hits of the entry, and drop the stale ones of the free target */
+		if (!mv_pp2x_c2_hit_cntr_read(cpu_slot, from, &cnt))
+			lkp_node[from]->moved_hits += cnt;
+		mv_pp2x_c2_hit_cntr_read(cpu_slot, to, &cnt);
+		mv_pp2x_c2_sw_clear(&c2_entry);
+		mv_pp2x_cls_c2_hw_read(cpu_slot, from, &c2_entry);
+		mv_pp2x_cls_c2_hw_write(cpu_slot, to, &c2_entry);
+		lkp_node[from]->c2_hw_idx = to;
+		lkp_node[to] = lkp_node[from];
+		lkp_node[from] = NULL;
+	}
+
+	/* Release the slots left behind */
+	for (i = 0; i < num_moves; i++) {
+		if (map->used[moves[i].from] || moves[i].from == slot)
+			continue;
+		from = map->hw_idx[moves[i].from];
+		mv_pp2x_cls_c2_hw_inv(cpu_slot, from);
+		ret_code = pp2_cls_c2_free_list_add(inst, from);
+		if (ret_code) {
+			pr_err("C2 free list add(%d) failed\n", from);
+			goto out;
+		}
+	}
+
+	/* Take the new slot */
+	*c2_hw_idx = map->hw_idx[slot];
+	if (pp2_cls_c2_entry_is_free(inst, *c2_hw_idx, &c2_index_node) == MVPP2_C2_ENTRY_FREE_TRUE) {
+		list_del(&c2_index_node->list_node);
+		c2_index_node->valid = MVPP2_C2_ENTRY_INVALID;
+	}
+
+	stats = pp2_cls_db_c2_slot_stats_get(inst);
+	stats->num_inserts++;
+	stats->num_moves += num_moves;
+	if (num_moves > stats->max_moves)
+		stats->max_moves = num_moves;
 
+out:
+	kfree(map);
+	kfree(moves);
+	kfree(lkp_node);
+	kfree(state);
+	kfree(c2_entry_data);
 	return ret_code;
 }
 
@@ -2272,6 +1733,13 @@ static int pp2_cls_c2_tcam_set(uintptr_t cpu_slot, struct mv_pp2x_c2_add_entry *
 		return ret_code;
 	}
 
+	/* Set sequence attribute */
+	ret_code = mv_pp2x_cls_c2_seq_set(&pp2_cls_c2_entry, c2_entry->seq_miss, 0);
+	if (ret_code) {
+		pr_err("failed to call mv_pp2x_cls_c2_seq_set\n");
+		return ret_code;
+	}
+
 	/* Set C2 HEK */
 	memset(hek_byte, 0, MVPP2_C2_HEK_OFF_MAX);
 	memset(hek_byte_mask, 0, MVPP2_C2_HEK_OFF_MAX);
@@ -2414,7 +1882,9 @@ int pp2_cls_c2_hit_cntr_all_get(struct pp2_inst *inst, int hit_low_thresh,
 /*******************************************************************************
  * pp2_cls_c2_hit_cntr_get
  *
- * DESCRIPTION: The routine returns hit counters of C2 entry
+ * DESCRIPTION: The routine returns hit counters of C2 entry, including the
+ *              hits harvested when the entry was moved. The counter is clear
+ *              on read.
  *
  * INPUTS:
  *	inst  - packet processor instance
@@ -2429,6 +1899,7 @@ int pp2_cls_c2_hit_cntr_all_get(struct pp2_inst *inst, int hit_low_thresh,
 int pp2_cls_c2_hit_cntr_get(struct pp2_inst *inst, int	c2_id,
 			    u32 *cntr)
 {
+	struct pp2_cls_c2_index_t *c2_index_node;
 	u32		hw_id;
 	u32		db_id;
 	u32		rc;
@@ -2439,15 +1910,20 @@ int pp2_cls_c2_hit_cntr_get(struct pp2_inst *inst, int	c2_id,
 		return -EFAULT;
 	}
 	rc = pp2_cls_c2_get_hw_idx_from_logic_idx(inst, c2_id, &hw_id, &db_id);
-	if (!rc) {
-		pr_err("%s: null pointer\n", __func__);
+	if (rc) {
+		pr_err("%s: invalid logical index %d\n", __func__, c2_id);
 		return -EFAULT;
 	}
 	rc = mv_pp2x_c2_hit_cntr_read(cpu_slot, hw_id, cntr);
-	if (!rc) {
-		pr_err("%s: null pointer\n", __func__);
+	if (rc) {
+		pr_err("%s: fail to read hit counter\n", __func__);
 		return -EFAULT;
 	}
+	c2_index_node = pp2_cls_db_c2_index_node_get(inst, db_id);
+	if (c2_index_node) {
+		*cntr += c2_index_node->moved_hits;
+		c2_index_node->moved_hits = 0;
+	}
 	return 0;
 }
 
@@ -2883,7 +2359,8 @@ int pp2_cls_c2_rule_sram_update(struct pp2_inst *inst, u32 logic_index,
 		return ret_code;
 	}
 	/* set seqence instruction info */
-	ret_code = mv_pp2x_cls_c2_seq_set(&hw_entry, 0, sram->instr_info.instr_value.instr_low & 0xff);
+	ret_code = mv_pp2x_cls_c2_seq_set(&hw_entry, sram->seq_miss,
+					  sram->instr_info.instr_value.instr_low & 0xff);
 	if (ret_code) {
 		pr_err("failed to call mv_pp2x_cls_c2_seq_set\n");
 		return ret_code;
@@ -48,6 +48,9 @@
 #define MVPP2_C2_LKP_TYPE_INVALID_PRI	0xFF
 #define MVPP2_C2_TCAM_KEY_LEN_MAX	8
 #define MVPP2_C2_LOGIC_IDX_BASE		1000
+#define MVPP2_C2_SLOT_SHIFT_MAX		4 /* max entries moved by a band shift before re-spreading */
+#define MVPP2_C2_SLOT_DENSITY_NUM	3 /* re-spread a region once it is at most 3/4 full */
+#define MVPP2_C2_SLOT_DENSITY_DEN	4
 
 #define MVPP2_C2_HEK_LKP_TYPE_OFFS	0
 #define MVPP2_C2_HEK_LKP_TYPE_BITS	6
@@ -153,11 +156,36 @@ struct pp2_cls_c2_index_t {
 	u32		c2_logic_idx;	/* logical index, unique inentifier, used for delete C2 entry */
 	u32		c2_hw_idx;	/* HW entry index in C2 engine */
 	u32		c2_data_db_idx;	/* data index in db */
+	u32		moved_hits;	/* hits harvested from previous HW indexes when the entry was moved */
 	struct list	list_node;	/* list node */
 };
 
+/* Compressed view of the C2 TCAM for one lookup type: only free slots and slots
+ * owned by the lookup type, in ascending HW index order. Slots of other lookup
+ * types are not ordered against this one and are left out.
+ */
+struct pp2_cls_c2_slot_map {
+	u32		num_slots;
+	u16		hw_idx[MVPP2_C2_ENTRY_MAX];	/* HW index of each slot */
+	u8		used[MVPP2_C2_ENTRY_MAX];	/* slot holds an entry of the lookup type */
+	u32		priority[MVPP2_C2_ENTRY_MAX];	/* priority of the entry, if used */
+};
+
+/* One entry move, in slot map indexes, to apply in order */
+struct pp2_cls_c2_slot_move {
+	u16		from;
+	u16		to;
+};
+
+struct pp2_cls_c2_slot_stats {
+	u32		num_inserts;	/* slots allocated */
+	u32		num_moves;	/* entries moved to make room */
+	u32		max_moves;	/* most entries moved by one insert */
+};
+
 int pp2_cls_cli_c2_lkp_type_entry_dump(void *arg, int argc, char *argv[]);
 int pp2_cls_cli_c2_free_tcam_dump(void *arg, int argc, char *argv[]);
+int pp2_cls_cli_c2_slot_bench(void *arg, int argc, char *argv[]);
 int pp2_cls_cli_c2_valid_lkp_type_dump(void *arg, int argc, char *argv[]);
 int pp2_cls_cli_c2_hw_dump(void *arg, int argc, char *argv[]);
 int pp2_cls_cli_c2_hw_hit_dump(void *arg, int argc, char *argv[]);
@@ -168,6 +196,8 @@ int pp2_cls_cli_qos_pcp_dump(void *arg, int argc, char *argv[]);
 /******************************************************************************/
 /*                                PROTOTYPE                                   */
 /******************************************************************************/
+int pp2_cls_c2_slot_alloc(struct pp2_cls_c2_slot_map *map, u32 priority, u32 *slot,
+			  struct pp2_cls_c2_slot_move *moves, u32 *num_moves);
 int pp2_cls_c2_get_hw_idx_from_logic_idx(struct pp2_inst *inst, u32 logic_idx, u32 *c2_hw_idx, u32 *c2_db_idx);
 int pp2_cls_c2_free_entry_number_get(struct pp2_inst *inst, u32 *free_entry_number);
 int pp2_cls_c2_rule_add(struct pp2_inst *inst, struct mv_pp2x_c2_add_entry *c2_entry, u32 *c2_logic_index);
@@ -722,11 +722,106 @@ int pp2_cls_cli_c2_free_tcam_dump(void *arg, int argc, char *argv[])
 	int off = 0;
 	struct pp2_inst *inst = (struct pp2_inst *)arg;
 
+	struct pp2_cls_c2_slot_stats *stats = pp2_cls_db_c2_slot_stats_get(inst);
+
 	pp2_cls_c2_dump_freelist(inst);
+	print_horizontal_line(67, "=");
+	printf("slot allocator: inserts %d, moves %d, max moves per insert %d\n",
+	       stats->num_inserts, stats->num_moves, stats->max_moves);
 
 	return off;
 }
 
+/*******************************************************************************
+ * pp2_cls_cli_c2_slot_bench
+ *
+ * DESCRIPTION:
+ *           This function runs the C2 slot allocator on a scratch slot map, with
+ *           random, ascending, descending and few distinct priorities insert
+ *           orders, and reports the entry moves per insert. No HW entry is written.
+ * INPUTS:
+ *       buf     - Shell parameters as char buffer
+ ******************************************************************************/
+int pp2_cls_cli_c2_slot_bench(void *arg, int argc, char *argv[])
+{
+	static const char * const order_str[] = {"random", "ascending", "descending", "random-dup"};
+	struct pp2_cls_c2_slot_map *map;
+	struct pp2_cls_c2_slot_move *moves;
+	u32 num_entries = 180, runs = 100;
+	u32 order, run, i, slot, num_moves, max_moves, priority;
+	unsigned int seed = 1;
+	u64 total_moves;
+	char *ret_ptr;
+	int rc = 0;
+
+	if (argc > 3) {
+		pr_err("Invalid number of arguments for %s command! number of arguments = %d\n", __func__, argc);
+		return -EINVAL;
+	}
+	if (argc > 1) {
+		num_entries = strtoul(argv[1], &ret_ptr, 0);
+		if (argv[1] == ret_ptr || !num_entries ||
+		    num_entries > MVPP2_C2_LAST_ENTRY - MVPP2_C2_FIRST_ENTRY) {
+			printf("parsing fail, wrong input for argv[1] - num_entries\n");
+			return -EINVAL;
+		}
+	}
+	if (argc > 2) {
+		runs = strtoul(argv[2], &ret_ptr, 0);
+		if (argv[2] == ret_ptr || !runs) {
+			printf("parsing fail, wrong input for argv[2] - runs\n");
+			return -EINVAL;
+		}
+	}
+
+	map = kcalloc(1, sizeof(*map), GFP_KERNEL);
+	moves = kcalloc(MVPP2_C2_ENTRY_MAX, sizeof(*moves), GFP_KERNEL);
+	if (!map || !moves) {
+		pr_err("%s: no memory\n", __func__);
+		rc = -ENOMEM;
+		goto out;
+	}
+
+	printf("%d entries in %d slots, %d runs\n", num_entries,
+	       MVPP2_C2_LAST_ENTRY - MVPP2_C2_FIRST_ENTRY, runs);
+	for (order = 0; order < ARRAY_SIZE(order_str); order++) {
+		total_moves = 0;
+		max_moves = 0;
+		for (run = 0; run < runs; run++) {
+			memset(map, 0, sizeof(*map));
+			map->num_slots = MVPP2_C2_LAST_ENTRY - MVPP2_C2_FIRST_ENTRY;
+			for (i = 0; i < map->num_slots; i++)
+				map->hw_idx[i] = MVPP2_C2_FIRST_ENTRY + i;
+
+			for (i = 0; i < num_entries; i++) {
+				if (order == 1)
+					priority = i;
+				else if (order == 2)
+					priority = num_entries - i;
+				else if (order == 3)
+					priority = rand_r(&seed) % 16;
+				else
+					priority = rand_r(&seed);
+				rc = pp2_cls_c2_slot_alloc(map, priority, &slot, moves, &num_moves);
+				if (rc)
+					goto out;
+				total_moves += num_moves;
+				if (num_moves > max_moves)
+					max_moves = num_moves;
+			}
+		}
+		printf("%-12s moves per insert: avg %llu.%02llu, max %d\n", order_str[order],
+		       (unsigned long long)(total_moves / ((u64)runs * num_entries)),
+		       (unsigned long long)((total_moves * 100 / ((u64)runs * num_entries)) % 100),
+		       max_moves);
+	}
+
+out:
+	kfree(map);
+	kfree(moves);
+	return rc;
+}
+
 /*******************************************************************************
  * pp2_cls_cli_c2_free_tcam_dump
  *
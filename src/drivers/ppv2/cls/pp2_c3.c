@@ -839,6 +839,60 @@ int pp2_cls_c3_default_rule_check(struct pp2_cls_c3_add_entry_t *c3_entry)
 	return 0;
 }
 
+/**
+ * pp2_cls_c3_hash_shadow_resync
+ *
+ * The routine resyncs the candidate entries of a key in the multihash model
+ * with HW: entries free in HW are freed, entries used in HW are read back and
+ * their key queried for its own candidate entries
+ *
+ * @param[in]	cpu_slot	cpu slot
+ * @param[in]	shadow		multihash model
+ * @param[in]	cand_idx	candidate multihash entries of the new key, one per bank
+ * @param[in]	occupied_bmp	occupied bitmap of the candidate entries in HW
+ *
+ * @retval	0 on success
+ * @retval	error-code otherwise
+ */
+static int pp2_cls_c3_hash_shadow_resync(uintptr_t cpu_slot, struct pp2_cls_c3_hash_shadow *shadow,
+					 const u16 cand_idx[MVPP2_CLS3_HASH_BANKS_NUM], u8 occupied_bmp)
+{
+	struct pp2_cls_c3_entry c3;
+	int query_idx[MVPP2_CLS3_HASH_BANKS_NUM];
+	u16 hash_idx[MVPP2_CLS3_HASH_BANKS_NUM];
+	int bank, idx, size, ext_idx, rc;
+	u8 bmp;
+
+	for (bank = 0; bank < MVPP2_CLS3_HASH_BANKS_NUM; bank++) {
+		if (!(occupied_bmp & (1 << bank))) {
+			pp2_cls_c3_hash_shadow_del(shadow, cand_idx[bank]);
+			continue;
+		}
+
+		pp2_cls_c3_shadow_get(cand_idx[bank], &size, &ext_idx);
+		if (!size) {
+			/* key not known to SW, keep the entry where it is */
+			for (idx = 0; idx < MVPP2_CLS3_HASH_BANKS_NUM; idx++)
+				hash_idx[idx] = cand_idx[bank];
+		} else {
+			rc = pp2_cls_c3_hw_read(cpu_slot, &c3, cand_idx[bank]);
+			if (!rc)
+				rc = pp2_cls_c3_hw_query(cpu_slot, &c3, &bmp, query_idx);
+			if (rc) {
+				pr_err("failed to read back C3 entry %d\n", cand_idx[bank]);
+				return rc;
+			}
+			for (idx = 0; idx < MVPP2_CLS3_HASH_BANKS_NUM; idx++)
+				hash_idx[idx] = query_idx[idx];
+		}
+		rc = pp2_cls_c3_hash_shadow_set(shadow, cand_idx[bank], hash_idx);
+		if (rc)
+			return rc;
+	}
+
+	return 0;
+}
+
 /**
  * pp2_cls_c3_rule_add
  *
@@ -861,11 +915,12 @@ int pp2_cls_c3_rule_add(struct pp2_inst *inst,
 	struct pp2_cls_c3_entry c3;
 	u32 max_search_depth;
 	struct pp2_cls_c3_hash_pair hash_pair_arr;
-	int rc = 0;
+	struct pp2_cls_c3_hash_shadow *shadow = pp2_cls_db_c3_hash_shadow_get(inst);
+	int query_idx[MVPP2_CLS3_HASH_BANKS_NUM];
+	u16 cand_idx[MVPP2_CLS3_HASH_BANKS_NUM];
+	u8 occupied_bmp;
+	int rc = 0, idx;
 	uintptr_t cpu_slot = pp2_default_cpu_slot(inst);
-#ifdef PP2_CLS_C3_DEBUG
-	int idx;
-#endif
 
 	pr_debug_fmt("reached\n");
 
@@ -917,13 +972,40 @@ int pp2_cls_c3_rule_add(struct pp2_inst *inst,
 		     c3.key.hek.bytes[35], c3.key.hek.bytes[34], c3.key.hek.bytes[33], c3.key.hek.bytes[32],
 		     c3.key.hek.bytes[31], c3.key.hek.bytes[30], c3.key.hek.bytes[29], c3.key.hek.bytes[28]);
 #endif
-	rc = pp2_cls_c3_hw_query_add(cpu_slot, &c3, max_search_depth, &hash_pair_arr);
+	/* get the candidate entries of the key, one per bank */
+	rc = pp2_cls_c3_hw_query(cpu_slot, &c3, &occupied_bmp, query_idx);
+	if (rc) {
+		pr_err("failed to query C3 entry\n");
+		return rc;
+	}
+	for (idx = 0; idx < MVPP2_CLS3_HASH_BANKS_NUM; idx++)
+		cand_idx[idx] = query_idx[idx];
+
+	if (pp2_cls_c3_hash_shadow_occupied_get(shadow, cand_idx) != occupied_bmp) {
+		/* model out of sync with HW, re-read the candidate entries before planning */
+		pr_warn("C3 multihash model out of sync, occupied 0x%x, HW 0x%x\n",
+			pp2_cls_c3_hash_shadow_occupied_get(shadow, cand_idx), occupied_bmp);
+		rc = pp2_cls_c3_hash_shadow_resync(cpu_slot, shadow, cand_idx, occupied_bmp);
+		if (rc) {
+			pr_err("failed to resync C3 multihash model\n");
+			return rc;
+		}
+		shadow->num_resync++;
+	}
+
+	/* plan placement in the model, only final positions are written to HW */
+	rc = pp2_cls_c3_hash_shadow_plan(shadow, cand_idx, max_search_depth, &hash_idx, &hash_pair_arr);
+	if (rc) {
+		shadow->num_full++;
+		pr_err("C3 hash table full, no entry within search depth %d\n", max_search_depth);
+		return rc;
+	}
+	rc = pp2_cls_c3_hw_planned_add(cpu_slot, &c3, hash_idx, &hash_pair_arr);
 	/* do not need to release logic index since it is still not occuppied */
 	if (rc) {
 		pr_err("failed to add C3 entry to HW\n");
 		return rc;
 	}
-	hash_idx = c3.index;
 
 	/* update C3 DB multihash index */
 #ifdef PP2_CLS_C3_DEBUG
@@ -940,6 +1022,12 @@ int pp2_cls_c3_rule_add(struct pp2_inst *inst,
 		return rc;
 	}
 
+	rc = pp2_cls_c3_hash_shadow_commit(shadow, cand_idx, hash_idx, &hash_pair_arr);
+	if (rc) {
+		pr_err("failed to update C3 multihash model\n");
+		return rc;
+	}
+
 	/* save to DB */
 	rc = pp2_cls_db_c3_entry_add(inst, l_logic_idx, hash_idx);
 	if (rc) {
@@ -1055,6 +1143,7 @@ int pp2_cls_c3_rule_del(struct pp2_inst *inst, u32 logic_idx)
 		pr_err("failed to delete C3 entry from HW\n");
 		return rc;
 	}
+	pp2_cls_c3_hash_shadow_del(pp2_cls_db_c3_hash_shadow_get(inst), hash_idx);
 
 	/* remove from DB */
 	rc = pp2_cls_db_c3_entry_del(inst, logic_idx);
@@ -1066,6 +1155,66 @@ int pp2_cls_c3_rule_del(struct pp2_inst *inst, u32 logic_idx)
 	return 0;
 }
 
+/**
+ * pp2_cls_c3_rule_action_update
+ *
+ * The routine rewrites the action of an existing C3 entry in place. The key of
+ * the entry is not changed, so the entry keeps matching during the update.
+ *
+ * @param[in]   inst            packet processor instance
+ * @param[in]	c3_entry		CLS C3 engine entry, with the same key as the existing one
+ * @param[in]	logic_idx		logical index
+ *
+ * @retval	0 on success
+ * @retval	error-code otherwise
+ */
+int pp2_cls_c3_rule_action_update(struct pp2_inst *inst, struct pp2_cls_c3_add_entry_t *c3_entry, u32 logic_idx)
+{
+	u32 hash_idx;
+	struct pp2_cls_c3_entry c3;
+	int rc = 0;
+	uintptr_t cpu_slot = pp2_default_cpu_slot(inst);
+
+	pr_debug_fmt("reached\n");
+
+	/* validation */
+	if (mv_pp2x_ptr_validate(c3_entry))
+		return -EINVAL;
+
+	if (mv_pp2x_range_validate(logic_idx, 0, MVPP2_CLS_C3_HASH_TBL_SIZE - 1))
+		return -EINVAL;
+
+	/* check C3 rule */
+	rc = pp2_cls_c3_rule_check(c3_entry);
+	if (rc) {
+		pr_err("failed to check C3 entry\n");
+		return rc;
+	}
+
+	/* convert the C3 mng entry to LSP entry */
+	pp2_cls_c3_sw_clear(&c3);
+	rc = pp2_cls_c3_rule_convert(c3_entry, &c3);
+	if (rc) {
+		pr_err("failed to call pp2_cls_c3_rule_convert\n");
+		return rc;
+	}
+
+	rc = pp2_cls_db_c3_hash_idx_get(inst, logic_idx, &hash_idx);
+	if (rc) {
+		pr_err("The logical index(%d) does not exist", logic_idx);
+		return rc;
+	}
+
+	/* rewrite the action, the hash index and hit counter are kept */
+	rc = pp2_cls_c3_hw_action_update(cpu_slot, &c3, hash_idx);
+	if (rc) {
+		pr_err("failed to update C3 entry action in HW\n");
+		return rc;
+	}
+
+	return 0;
+}
+
 /**
  * pp2_cls_c3_rule_get
  *
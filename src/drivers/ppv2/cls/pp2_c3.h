@@ -182,6 +182,27 @@ struct pp2_cls_c3_data_t {
 	struct mv_pp2x_duplicate_info		dup_info;	/* pkt duplication flow info*/
 };
 
+/* Software model of one multihash entry */
+struct pp2_cls_c3_hash_shadow_entry {
+	u16	valid;						/* entry holds a key	*/
+	u16	hash_idx[MVPP2_CLS3_HASH_BANKS_NUM];		/* candidate entries of the key, one per bank */
+};
+
+/* Software model of the multihash table */
+struct pp2_cls_c3_hash_shadow {
+	u32	num_entries;		/* used entries			*/
+	u32	num_inserts;		/* keys added			*/
+	u32	num_relocations;	/* keys relocated by inserts	*/
+	u32	num_full;		/* inserts failed without HW access */
+	u32	num_resync;		/* inserts that resynced the model with HW first */
+	struct pp2_cls_c3_hash_shadow_entry	tbl[MVPP2_CLS_C3_HASH_TBL_SIZE];
+	/* placement search scratch */
+	u16	bfs_idx[MVPP2_CLS_C3_HASH_TBL_SIZE];
+	u16	bfs_parent[MVPP2_CLS_C3_HASH_TBL_SIZE];
+	u8	bfs_depth[MVPP2_CLS_C3_HASH_TBL_SIZE];
+	u8	bfs_visited[MVPP2_CLS_C3_HASH_TBL_SIZE];
+};
+
 struct pp2_cls_c3_scan_entry_t {
 	u32	hash_idx;	/* multihash index*/
 	u32	logic_idx;	/* logical index*/
@@ -210,11 +231,29 @@ int pp2_cls_cli_c3_hit_count_get(void *arg, int argc, char *argv[]);
 int pp2_cls_cli_c3_search_depth_set(void *arg, int argc, char *argv[]);
 int pp2_cls_cli_c3_rule_delete(void *arg, int argc, char *argv[]);
 int pp2_cls_cli_c3_rule_add(void *arg, int argc, char *argv[]);
+int pp2_cls_cli_c3_hash_shadow_dump(void *arg, int argc, char *argv[]);
+int pp2_cls_cli_c3_hash_bench(void *arg, int argc, char *argv[]);
+/* Multihash model */
+void pp2_cls_c3_hash_shadow_init(struct pp2_cls_c3_hash_shadow *shadow);
+u8 pp2_cls_c3_hash_shadow_occupied_get(struct pp2_cls_c3_hash_shadow *shadow,
+				       const u16 hash_idx[MVPP2_CLS3_HASH_BANKS_NUM]);
+int pp2_cls_c3_hash_shadow_plan(struct pp2_cls_c3_hash_shadow *shadow,
+				const u16 hash_idx[MVPP2_CLS3_HASH_BANKS_NUM],
+				u32 max_depth, u32 *idx, struct pp2_cls_c3_hash_pair *hash_pair_arr);
+int pp2_cls_c3_hash_shadow_commit(struct pp2_cls_c3_hash_shadow *shadow,
+				  const u16 hash_idx[MVPP2_CLS3_HASH_BANKS_NUM],
+				  u32 idx, struct pp2_cls_c3_hash_pair *hash_pair_arr);
+int pp2_cls_c3_hash_shadow_set(struct pp2_cls_c3_hash_shadow *shadow, u32 idx,
+			       const u16 hash_idx[MVPP2_CLS3_HASH_BANKS_NUM]);
+int pp2_cls_c3_hash_shadow_del(struct pp2_cls_c3_hash_shadow *shadow, u32 idx);
+u32 pp2_cls_c3_hash_shadow_occupancy_get(struct pp2_cls_c3_hash_shadow *shadow,
+					 u32 bank_entries[MVPP2_CLS3_HASH_BANKS_NUM]);
 
 /* External  */
 int pp2_cls_c3_rule_add(struct pp2_inst *inst, struct pp2_cls_c3_add_entry_t *c3_entry, u32 *logic_idx);
 int pp2_cls_c3_default_rule_add(struct pp2_inst *inst, struct pp2_cls_c3_add_entry_t *c3_entry, u32 *logic_idx);
 int pp2_cls_c3_rule_del(struct pp2_inst *inst, u32 logic_idx);
+int pp2_cls_c3_rule_action_update(struct pp2_inst *inst, struct pp2_cls_c3_add_entry_t *c3_entry, u32 logic_idx);
 int pp2_cls_c3_rule_get(uintptr_t cpu_slot, struct pp2_cls_c3_add_entry_t *c3_entry, u32 *entry_num,
 			u32 *logic_idx_arr[]);
 int pp2_cls_c3_hit_count_get(struct pp2_inst *inst, int logic_idx, u32 *hit_count);
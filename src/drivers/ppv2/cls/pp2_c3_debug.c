@@ -1187,3 +1187,110 @@ int pp2_cls_c3_test(struct pp2_inst *inst, int num)
 	}
 	return 0;
 }
+
+/*******************************************************************************
+ * pp2_cls_cli_c3_hash_shadow_dump
+ *
+ * DESCRIPTION:
+ *       This function dumps the C3 multihash model occupancy and counters
+ ******************************************************************************/
+int pp2_cls_cli_c3_hash_shadow_dump(void *arg, int argc, char *argv[])
+{
+	struct pp2_inst *inst = (struct pp2_inst *)arg;
+	struct pp2_cls_c3_hash_shadow *shadow = pp2_cls_db_c3_hash_shadow_get(inst);
+	u32 bank_entries[MVPP2_CLS3_HASH_BANKS_NUM];
+	u32 num_entries;
+	int bank;
+
+	num_entries = pp2_cls_c3_hash_shadow_occupancy_get(shadow, bank_entries);
+
+	print_horizontal_line(67, "=");
+	printf("entries %d/%d, load factor %d.%02d\n", num_entries, MVPP2_CLS_C3_HASH_TBL_SIZE,
+	       num_entries / MVPP2_CLS_C3_HASH_TBL_SIZE, (num_entries * 100 / MVPP2_CLS_C3_HASH_TBL_SIZE) % 100);
+	printf("entries per hash bank:");
+	for (bank = 0; bank < MVPP2_CLS3_HASH_BANKS_NUM; bank++)
+		printf(" %d", bank_entries[bank]);
+	printf("\n");
+	printf("inserts %d, relocations %d, full %d, resync %d\n", shadow->num_inserts,
+	       shadow->num_relocations, shadow->num_full, shadow->num_resync);
+	print_horizontal_line(67, "=");
+
+	return 0;
+}
+
+/*******************************************************************************
+ * pp2_cls_cli_c3_hash_bench
+ *
+ * DESCRIPTION:
+ *       This function fills a scratch C3 multihash model with keys of random
+ *       candidate entries, one in each 1/8 of the table, until the first insert
+ *       fails, and reports the load factor reached and the relocations made.
+ *       No HW entry is written.
+ ******************************************************************************/
+int pp2_cls_cli_c3_hash_bench(void *arg, int argc, char *argv[])
+{
+	struct pp2_cls_c3_hash_shadow *shadow;
+	struct pp2_cls_c3_hash_pair hash_pair_arr;
+	u16 cand_idx[MVPP2_CLS3_HASH_BANKS_NUM];
+	u32 search_depth = MVPP2_C3_DEFAULT_SEARCH_DEPTH, runs = 10;
+	u32 run, idx, min_entries = MVPP2_CLS_C3_HASH_TBL_SIZE, max_path = 0;
+	u64 total_entries = 0, total_relocations = 0;
+	unsigned int seed = 1;
+	char *ret_ptr;
+	int bank;
+
+	if (argc > 3) {
+		pr_err("Invalid number of arguments for %s command! number of arguments = %d\n", __func__, argc);
+		return -EINVAL;
+	}
+	if (argc > 1) {
+		search_depth = strtoul(argv[1], &ret_ptr, 0);
+		if ((argv[1] == ret_ptr) || (search_depth > MVPP2_C3_SEARCH_DEPTHX_MAX)) {
+			printf("parsing fail, wrong input for argv[1] - search_depth\n");
+			return -EINVAL;
+		}
+	}
+	if (argc > 2) {
+		runs = strtoul(argv[2], &ret_ptr, 0);
+		if ((argv[2] == ret_ptr) || !runs) {
+			printf("parsing fail, wrong input for argv[2] - runs\n");
+			return -EINVAL;
+		}
+	}
+
+	shadow = kcalloc(1, sizeof(*shadow), GFP_KERNEL);
+	if (!shadow) {
+		pr_err("%s: no memory\n", __func__);
+		return -ENOMEM;
+	}
+
+	for (run = 0; run < runs; run++) {
+		pp2_cls_c3_hash_shadow_init(shadow);
+		while (1) {
+			for (bank = 0; bank < MVPP2_CLS3_HASH_BANKS_NUM; bank++)
+				cand_idx[bank] = bank * (MVPP2_CLS_C3_HASH_TBL_SIZE / MVPP2_CLS3_HASH_BANKS_NUM) +
+						 rand_r(&seed) % (MVPP2_CLS_C3_HASH_TBL_SIZE / MVPP2_CLS3_HASH_BANKS_NUM);
+			if (pp2_cls_c3_hash_shadow_plan(shadow, cand_idx, search_depth, &idx, &hash_pair_arr))
+				break;
+			if (hash_pair_arr.pair_num > max_path)
+				max_path = hash_pair_arr.pair_num;
+			pp2_cls_c3_hash_shadow_commit(shadow, cand_idx, idx, &hash_pair_arr);
+		}
+		total_entries += shadow->num_entries;
+		total_relocations += shadow->num_relocations;
+		if (shadow->num_entries < min_entries)
+			min_entries = shadow->num_entries;
+	}
+
+	printf("search depth %d, %d runs\n", search_depth, runs);
+	printf("load factor at first failure: avg %llu.%02llu, min %d.%02d\n",
+	       (unsigned long long)(total_entries / runs / MVPP2_CLS_C3_HASH_TBL_SIZE),
+	       (unsigned long long)((total_entries * 100 / runs / MVPP2_CLS_C3_HASH_TBL_SIZE) % 100),
+	       min_entries / MVPP2_CLS_C3_HASH_TBL_SIZE, (min_entries * 100 / MVPP2_CLS_C3_HASH_TBL_SIZE) % 100);
+	printf("relocations per insert: avg %llu.%02llu, max %d\n",
+	       (unsigned long long)(total_relocations / total_entries),
+	       (unsigned long long)((total_relocations * 100 / total_entries) % 100), max_path);
+
+	kfree(shadow);
+	return 0;
+}
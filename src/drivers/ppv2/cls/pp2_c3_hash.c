@@ -0,0 +1,291 @@
+/******************************************************************************
+ *	Copyright (C) 2016 Marvell International Ltd.
+ *
+ *  If you received this File from Marvell, you may opt to use, redistribute
+ *  and/or modify this File under the following licensing terms.
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *	* Redistributions of source code must retain the above copyright
+ *	  notice, this list of conditions and the following disclaimer.
+ *
+ *	* Redistributions in binary form must reproduce the above copyright
+ *	  notice, this list of conditions and the following disclaimer in the
+ *	  documentation and/or other materials provided with the distribution.
+ *
+ *	* Neither the name of Marvell nor the names of its contributors may be
+ *	  used to endorse or promote products derived from this software
+ *	  without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+/**
+ * @file pp2_c3_hash.c
+ *
+ * Software model of the C3 multihash table
+ *
+ * Every multihash entry in the model keeps the candidate entries of the key
+ * it holds, as reported by the HW query of the key. New keys are placed in
+ * memory, relocating resident keys cuckoo-style along the shortest path to a
+ * free entry, so only the final positions are written to HW and a full table
+ * is detected before any HW access.
+ */
+
+/***********************/
+/* c file declarations */
+/***********************/
+#include "std_internal.h"
+
+#include "../pp2_types.h"
+#include "../pp2.h"
+#include "../pp2_hw_type.h"
+#include "../pp2_hw_cls.h"
+
+/**
+ * pp2_cls_c3_hash_shadow_init
+ *
+ * The routine clears the multihash model, all entries free
+ *
+ * @param[in]	shadow		multihash model
+ */
+void pp2_cls_c3_hash_shadow_init(struct pp2_cls_c3_hash_shadow *shadow)
+{
+	memset(shadow, 0, sizeof(*shadow));
+}
+
+/**
+ * pp2_cls_c3_hash_shadow_occupied_get
+ *
+ * The routine gets the occupied bitmap of the candidate entries of a key,
+ * in the format of the HW query occupied bitmap
+ *
+ * @param[in]	shadow		multihash model
+ * @param[in]	hash_idx	candidate multihash entries of the key, one per bank
+ *
+ * @retval	occupied bitmap, bit per bank
+ */
+u8 pp2_cls_c3_hash_shadow_occupied_get(struct pp2_cls_c3_hash_shadow *shadow,
+				       const u16 hash_idx[MVPP2_CLS3_HASH_BANKS_NUM])
+{
+	u8 occupied_bmp = 0;
+	int bank;
+
+	for (bank = 0; bank < MVPP2_CLS3_HASH_BANKS_NUM; bank++)
+		if (shadow->tbl[hash_idx[bank]].valid)
+			occupied_bmp |= (1 << bank);
+
+	return occupied_bmp;
+}
+
+/**
+ * pp2_cls_c3_hash_shadow_plan
+ *
+ * The routine finds the multihash entry for a new key, and the keys to relocate
+ * to free it, with a breadth first search so the fewest keys are moved.
+ * The model is not changed.
+ *
+ * @param[in]	shadow		multihash model
+ * @param[in]	hash_idx	candidate multihash entries of the new key, one per bank
+ * @param[in]	max_depth	max number of keys to relocate
+ *
+ * @param[out]	idx		multihash entry for the new key
+ * @param[out]	hash_pair_arr	keys to relocate, to apply in order before adding the new key
+ *
+ * @retval	0 on success
+ * @retval	-ENOSPC if no entry can be freed within max_depth relocations
+ */
+int pp2_cls_c3_hash_shadow_plan(struct pp2_cls_c3_hash_shadow *shadow,
+				const u16 hash_idx[MVPP2_CLS3_HASH_BANKS_NUM],
+				u32 max_depth, u32 *idx, struct pp2_cls_c3_hash_pair *hash_pair_arr)
+{
+	struct pp2_cls_c3_hash_shadow_entry *entry;
+	u32 head, tail = 0, node, cand;
+	int bank;
+
+	if (mv_pp2x_ptr_validate(idx) || mv_pp2x_ptr_validate(hash_pair_arr))
+		return -EINVAL;
+
+	MVPP2_MEMSET_ZERO(*hash_pair_arr);
+	if (max_depth > MVPP2_CLS_C3_MAX_SEARCH_DEPTH)
+		max_depth = MVPP2_CLS_C3_MAX_SEARCH_DEPTH;
+
+	/* a free candidate needs no relocation */
+	for (bank = 0; bank < MVPP2_CLS3_HASH_BANKS_NUM; bank++) {
+		if (!shadow->tbl[hash_idx[bank]].valid) {
+			*idx = hash_idx[bank];
+			return 0;
+		}
+	}
+
+	/* search level by level for a resident key with a free candidate */
+	memset(shadow->bfs_visited, 0, sizeof(shadow->bfs_visited));
+	for (bank = 0; max_depth && bank < MVPP2_CLS3_HASH_BANKS_NUM; bank++) {
+		if (shadow->bfs_visited[hash_idx[bank]])
+			continue;
+		shadow->bfs_visited[hash_idx[bank]] = 1;
+		shadow->bfs_idx[tail] = hash_idx[bank];
+		shadow->bfs_parent[tail] = MVPP2_CLS_C3_HASH_TBL_SIZE;
+		shadow->bfs_depth[tail++] = 1;
+	}
+
+	for (head = 0; head < tail; head++) {
+		entry = &shadow->tbl[shadow->bfs_idx[head]];
+		for (bank = 0; bank < MVPP2_CLS3_HASH_BANKS_NUM; bank++) {
+			cand = entry->hash_idx[bank];
+			if (cand == shadow->bfs_idx[head])
+				continue;
+			if (!shadow->tbl[cand].valid) {
+				/* relocate along the path, from the free entry back to the new key */
+				for (node = head; node < MVPP2_CLS_C3_HASH_TBL_SIZE; node = shadow->bfs_parent[node]) {
+					hash_pair_arr->old_idx[hash_pair_arr->pair_num] = shadow->bfs_idx[node];
+					hash_pair_arr->new_idx[hash_pair_arr->pair_num] = cand;
+					hash_pair_arr->pair_num++;
+					cand = shadow->bfs_idx[node];
+				}
+				*idx = cand;
+				return 0;
+			}
+			if (shadow->bfs_visited[cand] || shadow->bfs_depth[head] >= max_depth)
+				continue;
+			shadow->bfs_visited[cand] = 1;
+			shadow->bfs_idx[tail] = cand;
+			shadow->bfs_parent[tail] = head;
+			shadow->bfs_depth[tail++] = shadow->bfs_depth[head] + 1;
+		}
+	}
+
+	return -ENOSPC;
+}
+
+/**
+ * pp2_cls_c3_hash_shadow_commit
+ *
+ * The routine applies the relocations to the model and adds the new key
+ *
+ * @param[in]	shadow		multihash model
+ * @param[in]	hash_idx	candidate multihash entries of the new key, one per bank
+ * @param[in]	idx		multihash entry of the new key
+ * @param[in]	hash_pair_arr	keys relocated, in the order applied
+ *
+ * @retval	0 on success
+ * @retval	error-code otherwise
+ */
+int pp2_cls_c3_hash_shadow_commit(struct pp2_cls_c3_hash_shadow *shadow,
+				  const u16 hash_idx[MVPP2_CLS3_HASH_BANKS_NUM],
+				  u32 idx, struct pp2_cls_c3_hash_pair *hash_pair_arr)
+{
+	int i;
+
+	if (mv_pp2x_range_validate(idx, 0, MVPP2_CLS_C3_HASH_TBL_SIZE - 1))
+		return -EINVAL;
+
+	for (i = 0; i < hash_pair_arr->pair_num; i++) {
+		if (mv_pp2x_range_validate(hash_pair_arr->old_idx[i], 0, MVPP2_CLS_C3_HASH_TBL_SIZE - 1) ||
+		    mv_pp2x_range_validate(hash_pair_arr->new_idx[i], 0, MVPP2_CLS_C3_HASH_TBL_SIZE - 1))
+			return -EINVAL;
+		shadow->tbl[hash_pair_arr->new_idx[i]] = shadow->tbl[hash_pair_arr->old_idx[i]];
+		shadow->tbl[hash_pair_arr->old_idx[i]].valid = 0;
+	}
+	shadow->num_relocations += hash_pair_arr->pair_num;
+
+	pp2_cls_c3_hash_shadow_set(shadow, idx, hash_idx);
+	shadow->num_inserts++;
+
+	return 0;
+}
+
+/**
+ * pp2_cls_c3_hash_shadow_set
+ *
+ * The routine sets a multihash entry of the model as used by a key, without
+ * relocation, e.g. to resync the model with an entry read from HW
+ *
+ * @param[in]	shadow		multihash model
+ * @param[in]	idx		multihash entry of the key
+ * @param[in]	hash_idx	candidate multihash entries of the key, one per bank
+ *
+ * @retval	0 on success
+ * @retval	error-code otherwise
+ */
+int pp2_cls_c3_hash_shadow_set(struct pp2_cls_c3_hash_shadow *shadow, u32 idx,
+			       const u16 hash_idx[MVPP2_CLS3_HASH_BANKS_NUM])
+{
+	if (mv_pp2x_range_validate(idx, 0, MVPP2_CLS_C3_HASH_TBL_SIZE - 1))
+		return -EINVAL;
+
+	if (!shadow->tbl[idx].valid)
+		shadow->num_entries++;
+	shadow->tbl[idx].valid = 1;
+	memcpy(shadow->tbl[idx].hash_idx, hash_idx, sizeof(shadow->tbl[idx].hash_idx));
+
+	return 0;
+}
+
+/**
+ * pp2_cls_c3_hash_shadow_del
+ *
+ * The routine removes a key from the model
+ *
+ * @param[in]	shadow		multihash model
+ * @param[in]	idx		multihash entry of the key
+ *
+ * @retval	0 on success
+ * @retval	error-code otherwise
+ */
+int pp2_cls_c3_hash_shadow_del(struct pp2_cls_c3_hash_shadow *shadow, u32 idx)
+{
+	if (mv_pp2x_range_validate(idx, 0, MVPP2_CLS_C3_HASH_TBL_SIZE - 1))
+		return -EINVAL;
+
+	if (shadow->tbl[idx].valid)
+		shadow->num_entries--;
+	shadow->tbl[idx].valid = 0;
+
+	return 0;
+}
+
+/**
+ * pp2_cls_c3_hash_shadow_occupancy_get
+ *
+ * The routine gets the number of used multihash entries, in total and per hash
+ * bank the keys were placed by, the load factor being
+ * num_entries / MVPP2_CLS_C3_HASH_TBL_SIZE
+ *
+ * @param[in]	shadow		multihash model
+ *
+ * @param[out]	bank_entries	used entries per bank, may be NULL
+ *
+ * @retval	number of used entries
+ */
+u32 pp2_cls_c3_hash_shadow_occupancy_get(struct pp2_cls_c3_hash_shadow *shadow,
+					 u32 bank_entries[MVPP2_CLS3_HASH_BANKS_NUM])
+{
+	u32 idx;
+	int bank;
+
+	if (bank_entries) {
+		memset(bank_entries, 0, MVPP2_CLS3_HASH_BANKS_NUM * sizeof(u32));
+		for (idx = 0; idx < MVPP2_CLS_C3_HASH_TBL_SIZE; idx++) {
+			if (!shadow->tbl[idx].valid)
+				continue;
+			for (bank = 0; bank < MVPP2_CLS3_HASH_BANKS_NUM; bank++)
+				if (shadow->tbl[idx].hash_idx[bank] == idx)
+					break;
+			if (bank < MVPP2_CLS3_HASH_BANKS_NUM)
+				bank_entries[bank]++;
+		}
+	}
+
+	return shadow->num_entries;
+}
@@ -45,6 +45,9 @@
 #include "../pp2.h"
 #include "../pp2_hw_type.h"
 #include "../pp2_hw_cls.h"
+#include "pp2_cls_mng.h"
+
+static struct pp2_cls_db_mng_t *mng_db;
 
 /*******************************************************************************
  * pp2_cls_db_mem_alloc_init
@@ -288,6 +291,25 @@ int pp2_cls_db_c3_logic_idx_get(struct pp2_inst *inst, int hash_idx, int *logic_
 	return 0;
 }
 
+/*******************************************************************************
+ * pp2_cls_db_c3_hash_shadow_get()
+ *
+ * DESCRIPTION: Get the software model of the C3 multihash table.
+ *
+ * INPUTS:
+ *	inst      - packet processor instance
+ *
+ * OUTPUTS:
+ *	None
+ *
+ * RETURN:
+ *	The pointer to the model.
+ ******************************************************************************/
+struct pp2_cls_c3_hash_shadow *pp2_cls_db_c3_hash_shadow_get(struct pp2_inst *inst)
+{
+	return &inst->cls_db->c3_db.hash_shadow;
+}
+
 /*******************************************************************************
  * pp2_cls_db_c3_hash_idx_update()
  *
@@ -961,6 +983,55 @@ void pp2_db_cls_init(struct pp2_inst *inst)
 	inst->cls_db->cls_db.log2off[MVPP2_CLS_FREE_LOG2OFF] = MVPP2_CLS_LOG2OFF_START;
 }
 
+/*******************************************************************************
+ * pp2_db_cls_fl_shadow_reset
+ *
+ * DESCRIPTION: The routine sets the flow table shadow to cleared entries, after
+ *		the whole HW flow table was cleared
+ *
+ ******************************************************************************/
+void pp2_db_cls_fl_shadow_reset(struct pp2_inst *inst)
+{
+	int i;
+
+	for (i = 0; i < MVPP2_FLOW_TBL_SIZE; i++) {
+		mv_pp2x_cls_sw_flow_clear(&inst->cls_db->cls_db.fl_shadow[i]);
+		inst->cls_db->cls_db.fl_shadow[i].index = i;
+	}
+	inst->cls_db->cls_db.fl_shadow_valid = true;
+}
+
+/*******************************************************************************
+ * pp2_db_cls_fl_shadow_get
+ *
+ * DESCRIPTION: The routine gets the flow entry last written to HW at an offset
+ *
+ * INPUTS:
+ *	inst      - packet processor instance
+ *	off       - flow table offset
+ *
+ * RETURN:
+ *	The pointer to the shadow entry, NULL if the HW entry is not known
+ ******************************************************************************/
+struct mv_pp2x_cls_flow_entry *pp2_db_cls_fl_shadow_get(struct pp2_inst *inst, u32 off)
+{
+	if (!inst->cls_db->cls_db.fl_shadow_valid || off >= MVPP2_FLOW_TBL_SIZE)
+		return NULL;
+
+	return &inst->cls_db->cls_db.fl_shadow[off];
+}
+
+/*******************************************************************************
+ * pp2_db_cls_fl_upd_stats_get
+ *
+ * DESCRIPTION: The routine gets the flow table update counters
+ *
+ ******************************************************************************/
+struct pp2_cls_fl_upd_stats *pp2_db_cls_fl_upd_stats_get(struct pp2_inst *inst)
+{
+	return &inst->cls_db->cls_db.fl_upd_stats;
+}
+
 /*******************************************************************************
  * pp2_cls_db_c2_lkp_type_list_head_get()
  *
@@ -1001,6 +1072,25 @@ struct list *pp2_cls_db_c2_free_list_head_get(struct pp2_inst *inst)
 	return &inst->cls_db->c2_db.c2_free_head_db;
 }
 
+/*******************************************************************************
+ * pp2_cls_db_c2_slot_stats_get()
+ *
+ * DESCRIPTION: Get the C2 slot allocator counters.
+ *
+ * INPUTS:
+ *	inst      - packet processor instance
+ *
+ * OUTPUTS: None.
+ *
+ * RETURNS:
+ *          The pointer to the counters.
+ *
+ ******************************************************************************/
+struct pp2_cls_c2_slot_stats *pp2_cls_db_c2_slot_stats_get(struct pp2_inst *inst)
+{
+	return &inst->cls_db->c2_db.c2_slot_stats;
+}
+
 /*******************************************************************************
  * pp2_cls_db_c2_index_node_get()
  *
@@ -1189,6 +1279,8 @@ int pp2_cls_db_c2_init(struct pp2_inst *inst)
  *******************************************************************************/
 int pp2_cls_db_mng_init(void)
 {
+	u32 i;
+
 	if (!mng_db) {
 		/* Allocat memory*/
 		mng_db = kmalloc(sizeof(*mng_db), GFP_KERNEL);
@@ -1200,7 +1292,178 @@ int pp2_cls_db_mng_init(void)
 
 		/* Init CLS Manager list head */
 		INIT_LIST(&mng_db->pp2_cls_tbl_head);
+		for (i = 0; i < MVPP2_CLS_DB_MNG_TBL_HASH_SIZE; i++)
+			INIT_LIST(&mng_db->tbl_hash[i]);
+	}
+	return 0;
+}
+
+/* FNV-1a, applied incrementally over the rule key/mask tuple */
+static inline u32 pp2_cls_db_mng_hash_add(u32 hash, const u8 *data, u32 len)
+{
+	u32 i;
+
+	for (i = 0; i < len; i++) {
+		hash ^= data[i];
+		hash *= 16777619;
+	}
+	return hash;
+}
+
+static inline u32 pp2_cls_db_mng_str_len(const u8 *str)
+{
+	return str ? strnlen((const char *)str, CLS_MNG_KEY_SIZE_MAX) : 0;
+}
+
+static inline int pp2_cls_db_mng_str_cmp(const u8 *str1, const u8 *str2)
+{
+	return strncmp(str1 ? (const char *)str1 : "", str2 ? (const char *)str2 : "", CLS_MNG_KEY_SIZE_MAX);
+}
+
+u32 pp2_cls_db_mng_rule_hash(struct pp2_cls_tbl_rule *rule)
+{
+	u32 hash = 2166136261U;
+	u32 i;
+
+	hash = pp2_cls_db_mng_hash_add(hash, &rule->num_fields, sizeof(rule->num_fields));
+	for (i = 0; i < rule->num_fields; i++) {
+		/* key and mask are hashed with their terminating zero, so "1","12" != "11","2" */
+		hash = pp2_cls_db_mng_hash_add(hash, &rule->fields[i].size, sizeof(rule->fields[i].size));
+		hash = pp2_cls_db_mng_hash_add(hash, rule->fields[i].key,
+					       pp2_cls_db_mng_str_len(rule->fields[i].key));
+		hash = pp2_cls_db_mng_hash_add(hash, (const u8 *)"", 1);
+		hash = pp2_cls_db_mng_hash_add(hash, rule->fields[i].mask,
+					       pp2_cls_db_mng_str_len(rule->fields[i].mask));
+		hash = pp2_cls_db_mng_hash_add(hash, (const u8 *)"", 1);
+	}
+	return hash;
+}
+
+bool pp2_cls_db_mng_rule_equal(struct pp2_cls_tbl_rule *rule1, struct pp2_cls_tbl_rule *rule2)
+{
+	u32 i;
+
+	if (rule1->num_fields != rule2->num_fields)
+		return false;
+
+	for (i = 0; i < rule1->num_fields; i++) {
+		if (rule1->fields[i].size != rule2->fields[i].size ||
+		    pp2_cls_db_mng_str_cmp(rule1->fields[i].key, rule2->fields[i].key) ||
+		    pp2_cls_db_mng_str_cmp(rule1->fields[i].mask, rule2->fields[i].mask))
+			return false;
 	}
+	return true;
+}
+
+static inline u32 pp2_cls_db_mng_tbl_hash(struct pp2_cls_tbl *tbl)
+{
+	uintptr_t addr = (uintptr_t)tbl;
+
+	return (u32)((addr >> 4) ^ (addr >> 12)) & (MVPP2_CLS_DB_MNG_TBL_HASH_SIZE - 1);
+}
+
+static struct pp2_cls_tbl_node *pp2_cls_db_mng_tbl_node_get(struct pp2_cls_tbl *tbl)
+{
+	struct pp2_cls_tbl_node *tbl_node;
+
+	LIST_FOR_EACH_OBJECT(tbl_node, struct pp2_cls_tbl_node,
+			     &mng_db->tbl_hash[pp2_cls_db_mng_tbl_hash(tbl)], hash_node) {
+		if (&tbl_node->tbl == tbl)
+			return tbl_node;
+	}
+	return NULL;
+}
+
+static struct pp2_cls_rule_node *pp2_cls_db_mng_rule_node_get(struct pp2_cls_tbl_node *tbl_node,
+							      struct pp2_cls_tbl_rule *rule)
+{
+	struct pp2_cls_rule_node *rule_node;
+	u32 hash = pp2_cls_db_mng_rule_hash(rule);
+	struct list *head = &tbl_node->rule_hash[hash & (tbl_node->rule_hash_size - 1)];
+
+	LIST_FOR_EACH_OBJECT(rule_node, struct pp2_cls_rule_node, head, hash_node) {
+		if (rule_node->hash == hash && pp2_cls_db_mng_rule_equal(&rule_node->rule, rule))
+			return rule_node;
+	}
+	return NULL;
+}
+
+/* Double the number of rule buckets; rules are re-linked from the table rule list */
+static int pp2_cls_db_mng_rule_hash_grow(struct pp2_cls_tbl_node *tbl_node)
+{
+	struct pp2_cls_rule_node *rule_node;
+	struct list *rule_hash;
+	u32 size = tbl_node->rule_hash_size * 2;
+	u32 i;
+
+	rule_hash = kcalloc(size, sizeof(*rule_hash), GFP_KERNEL);
+	if (!rule_hash)
+		return -ENOMEM;
+
+	for (i = 0; i < size; i++)
+		INIT_LIST(&rule_hash[i]);
+
+	LIST_FOR_EACH_OBJECT(rule_node, struct pp2_cls_rule_node, &tbl_node->pp2_cls_tbl_rule_head, list_node)
+		list_add_to_tail(&rule_node->hash_node, &rule_hash[rule_node->hash & (size - 1)]);
+
+	kfree(tbl_node->rule_hash);
+	tbl_node->rule_hash = rule_hash;
+	tbl_node->rule_hash_size = size;
+	return 0;
+}
+
+static void pp2_cls_db_mng_rule_node_free(struct pp2_cls_rule_node *rule_node)
+{
+	u32 i;
+
+	for (i = 0; i < rule_node->rule.num_fields; i++) {
+		kfree(rule_node->rule.fields[i].key);
+		kfree(rule_node->rule.fields[i].mask);
+	}
+	kfree(rule_node->action.cos);
+	kfree(rule_node);
+}
+
+static int pp2_cls_db_mng_rule_copy(struct pp2_cls_rule_node *rule_node, struct pp2_cls_tbl_rule *rule,
+				    struct pp2_cls_tbl_action *action)
+{
+	struct pp2_cls_tbl_rule *rule_db = &rule_node->rule;
+	u8 *key, *mask;
+	u32 i;
+
+	for (i = 0; i < rule->num_fields; i++) {
+		rule_db->fields[i].size = rule->fields[i].size;
+		key = kcalloc(1, CLS_MNG_KEY_SIZE_MAX, GFP_KERNEL);
+		if (!key) {
+			pr_err("no mem for HEK in DB!\n");
+			return -ENOMEM;
+		}
+		if (rule->fields[i].key)
+			strncpy((char *)key, (char *)rule->fields[i].key, CLS_MNG_KEY_SIZE_MAX - 1);
+		rule_db->fields[i].key = key;
+		/* Count the field as soon as it owns memory so that a partial copy can be freed */
+		rule_db->num_fields = i + 1;
+
+		mask = kcalloc(1, CLS_MNG_KEY_SIZE_MAX, GFP_KERNEL);
+		if (!mask) {
+			pr_err("no mem for HEK in DB!\n");
+			return -ENOMEM;
+		}
+		if (rule->fields[i].mask)
+			strncpy((char *)mask, (char *)rule->fields[i].mask, CLS_MNG_KEY_SIZE_MAX - 1);
+		rule_db->fields[i].mask = mask;
+	}
+
+	rule_node->action.cos = kcalloc(1, sizeof(*rule_node->action.cos), GFP_KERNEL);
+	if (!rule_node->action.cos)
+		return -ENOMEM;
+
+	rule_node->action.type = action->type;
+	rule_node->action.next_tbl = action->next_tbl;
+	rule_node->action.mark_type = action->mark_type;
+	rule_node->action.u = action->u;
+	if (action->cos)
+		rule_node->action.cos->tc = action->cos->tc;
 	return 0;
 }
 
@@ -1220,16 +1483,26 @@ int pp2_cls_db_mng_init(void)
 int pp2_cls_db_mng_tbl_add(struct pp2_cls_tbl **tbl)
 {
 	struct pp2_cls_tbl_node *tbl_node;
+	u32 i;
 
-	tbl_node = kmalloc(sizeof(*tbl_node), GFP_KERNEL);
+	tbl_node = kcalloc(1, sizeof(*tbl_node), GFP_KERNEL);
 	if (!tbl_node)
 		return -ENOMEM;
 
 	/* Initialize table's rules db */
 	INIT_LIST(&tbl_node->pp2_cls_tbl_rule_head);
+	tbl_node->rule_hash = kcalloc(MVPP2_CLS_DB_MNG_RULE_HASH_MIN, sizeof(*tbl_node->rule_hash), GFP_KERNEL);
+	if (!tbl_node->rule_hash) {
+		kfree(tbl_node);
+		return -ENOMEM;
+	}
+	for (i = 0; i < MVPP2_CLS_DB_MNG_RULE_HASH_MIN; i++)
+		INIT_LIST(&tbl_node->rule_hash[i]);
+	tbl_node->rule_hash_size = MVPP2_CLS_DB_MNG_RULE_HASH_MIN;
 
 	/* add table to db */
 	list_add_to_tail(&tbl_node->list_node, &mng_db->pp2_cls_tbl_head);
+	list_add_to_tail(&tbl_node->hash_node, &mng_db->tbl_hash[pp2_cls_db_mng_tbl_hash(&tbl_node->tbl)]);
 
 	*tbl = &tbl_node->tbl;
 	return 0;
@@ -1250,13 +1523,7 @@ int pp2_cls_db_mng_tbl_add(struct pp2_cls_tbl **tbl)
  *******************************************************************************/
 int pp2_cls_db_mng_tbl_check(struct pp2_cls_tbl *tbl)
 {
-	struct pp2_cls_tbl_node *tbl_node;
-
-	LIST_FOR_EACH_OBJECT(tbl_node, struct pp2_cls_tbl_node, &mng_db->pp2_cls_tbl_head, list_node) {
-		if (&tbl_node->tbl == tbl)
-			return 0;
-	}
-	return -EFAULT;
+	return pp2_cls_db_mng_tbl_node_get(tbl) ? 0 : -EFAULT;
 }
 
 /*******************************************************************************
@@ -1275,21 +1542,22 @@ int pp2_cls_db_mng_tbl_check(struct pp2_cls_tbl *tbl)
 int pp2_cls_db_mng_tbl_remove(struct pp2_cls_tbl *tbl)
 {
 	struct pp2_cls_tbl_node *tbl_node;
-	struct pp2_cls_rule_node *rule_node;
+	struct pp2_cls_rule_node *rule_node, *tmp;
 
-	LIST_FOR_EACH_OBJECT(tbl_node, struct pp2_cls_tbl_node, &mng_db->pp2_cls_tbl_head, list_node) {
-		if (&tbl_node->tbl == tbl) {
-			/* Remove all rules first */
-			LIST_FOR_EACH_OBJECT(rule_node, struct pp2_cls_rule_node, &tbl_node->pp2_cls_tbl_rule_head,
-					     list_node) {
-					     list_del(&rule_node->list_node);
-					     kfree(rule_node);
-			}
-			list_del(&tbl_node->list_node);
-			kfree(tbl_node);
-			break;
-		}
+	tbl_node = pp2_cls_db_mng_tbl_node_get(tbl);
+	if (!tbl_node)
+		return 0;
+
+	/* Remove all rules first */
+	LIST_FOR_EACH_OBJECT_SAFE(rule_node, tmp, &tbl_node->pp2_cls_tbl_rule_head,
+				  struct pp2_cls_rule_node, list_node) {
+		list_del(&rule_node->list_node);
+		pp2_cls_db_mng_rule_node_free(rule_node);
 	}
+	list_del(&tbl_node->hash_node);
+	list_del(&tbl_node->list_node);
+	kfree(tbl_node->rule_hash);
+	kfree(tbl_node);
 	return 0;
 }
 
@@ -1313,38 +1581,55 @@ int pp2_cls_db_mng_tbl_num_get(void)
 /*******************************************************************************
  * pp2_cls_db_mng_tbl_rule_add()
  *
- * DESCRIPTION: Add a table to CLS Manager db.
+ * DESCRIPTION: Add a copy of a rule and its action to a table in CLS Manager db.
  *
  * INPUTS:
- *	tbl	pointer to the table.
+ *	tbl		pointer to the table.
+ *	rule		pointer to the rule.
+ *	action		pointer to the rule action.
+ *	logic_index	logical index of the rule in C2 or C3 database.
  *
- * OUTPUTS:
- *	rule	pointer to the new rule.
+ * OUTPUTS: None.
  *
  * RETURN:
  *	0 on success, error-code otherwise
  *******************************************************************************/
-int pp2_cls_db_mng_tbl_rule_add(struct pp2_cls_tbl *tbl, struct pp2_cls_tbl_rule **rule, u32 logic_index,
-				struct pp2_cls_tbl_action **action)
+int pp2_cls_db_mng_tbl_rule_add(struct pp2_cls_tbl *tbl, struct pp2_cls_tbl_rule *rule,
+				struct pp2_cls_tbl_action *action, u32 logic_index)
 {
 	struct pp2_cls_tbl_node *tbl_node;
 	struct pp2_cls_rule_node *rule_node;
+	int rc;
 
-	LIST_FOR_EACH_OBJECT(tbl_node, struct pp2_cls_tbl_node, &mng_db->pp2_cls_tbl_head, list_node) {
-		if (&tbl_node->tbl == tbl) {
-			rule_node = kmalloc(sizeof(*rule_node), GFP_KERNEL);
-			if (!rule_node) {
-				pr_err("%s: null pointer\n", __func__);
-				return -ENOMEM;
-			}
-			*rule = &rule_node->rule;
-			*action = &rule_node->action;
-			rule_node->logic_index = logic_index;
-			list_add_to_tail(&rule_node->list_node, &tbl_node->pp2_cls_tbl_rule_head);
-			return 0;
-		}
+	tbl_node = pp2_cls_db_mng_tbl_node_get(tbl);
+	if (!tbl_node)
+		return -EFAULT;
+
+	/* Keep load factor below 1; on allocation failure just live with longer chains */
+	if (tbl_node->num_rules >= tbl_node->rule_hash_size)
+		pp2_cls_db_mng_rule_hash_grow(tbl_node);
+
+	rule_node = kcalloc(1, sizeof(*rule_node), GFP_KERNEL);
+	if (!rule_node) {
+		pr_err("%s: null pointer\n", __func__);
+		return -ENOMEM;
 	}
-	return -EFAULT;
+
+	rc = pp2_cls_db_mng_rule_copy(rule_node, rule, action);
+	if (rc) {
+		pp2_cls_db_mng_rule_node_free(rule_node);
+		return rc;
+	}
+
+	rule_node->logic_index = logic_index;
+	rule_node->hash = pp2_cls_db_mng_rule_hash(&rule_node->rule);
+	rule_node->last_hit_usecs = mv_time_usecs();
+	rule_node->hw_idx = PP2_CLS_DB_RULE_HW_IDX_INVALID;
+	list_add_to_tail(&rule_node->list_node, &tbl_node->pp2_cls_tbl_rule_head);
+	list_add_to_tail(&rule_node->hash_node,
+			 &tbl_node->rule_hash[rule_node->hash & (tbl_node->rule_hash_size - 1)]);
+	tbl_node->num_rules++;
+	return 0;
 }
 
 /*******************************************************************************
@@ -1354,46 +1639,153 @@ int pp2_cls_db_mng_tbl_rule_add(struct pp2_cls_tbl *tbl, struct pp2_cls_tbl_rule
  *
  * INPUTS:
  *	tbl	pointer to the table.
+ *	rule	pointer to the rule.
+ *
+ * OUTPUTS: None.
+ *
+ * RETURN:
+ *	1 if the rule exists, 0 otherwise
+ *******************************************************************************/
+int pp2_cls_db_mng_rule_check(struct pp2_cls_tbl *tbl, struct pp2_cls_tbl_rule *rule)
+{
+	struct pp2_cls_tbl_node *tbl_node;
+
+	tbl_node = pp2_cls_db_mng_tbl_node_get(tbl);
+	if (!tbl_node)
+		return 0;
+
+	return pp2_cls_db_mng_rule_node_get(tbl_node, rule) ? 1 : 0;
+}
+
+/*******************************************************************************
+ * pp2_cls_db_mng_tbl_rule_get()
+ *
+ * DESCRIPTION: Get the logical index of a rule in CLS Manager table db.
+ *
+ * INPUTS:
+ *	tbl	pointer to the table.
+ *	rule	pointer to the rule.
  *
  * OUTPUTS:
- *	rule	pointer to the new rule.
+ *	logic_index	pointer to the logic_index.
  *
  * RETURN:
  *	0 on success, error-code otherwise
  *******************************************************************************/
-int pp2_cls_db_mng_rule_check(struct pp2_cls_tbl *tbl, struct pp2_cls_tbl_rule *rule)
+int pp2_cls_db_mng_tbl_rule_get(struct pp2_cls_tbl *tbl, struct pp2_cls_tbl_rule *rule, u32 *logic_index)
 {
 	struct pp2_cls_tbl_node *tbl_node;
 	struct pp2_cls_rule_node *rule_node;
-	u32 i;
 
-	LIST_FOR_EACH_OBJECT(tbl_node, struct pp2_cls_tbl_node, &mng_db->pp2_cls_tbl_head, list_node) {
-		if (&tbl_node->tbl == tbl) {
-			LIST_FOR_EACH_OBJECT(rule_node, struct pp2_cls_rule_node, &tbl_node->pp2_cls_tbl_rule_head,
-					     list_node) {
-				 pr_debug("num_fields %d %d\n", rule_node->rule.num_fields, rule->num_fields);
-				if (rule_node->rule.num_fields != rule->num_fields)
-					continue;
-
-				for (i = 0; i < rule_node->rule.num_fields; i++) {
-					pr_debug("size %d key %s, mask %s\n", rule_node->rule.fields[i].size,
-						 rule_node->rule.fields[i].key, rule_node->rule.fields[i].mask);
-					pr_debug("size %d key %s, mask %s\n", rule->fields[i].size,
-						 rule->fields[i].key, rule->fields[i].mask);
-					if ((strcmp((char *)rule_node->rule.fields[i].key,
-						    (char *)rule->fields[i].key) == 0) &&
-					    (strcmp((char *)rule_node->rule.fields[i].mask,
-						    (char *)rule->fields[i].mask) == 0) &&
-					    (rule_node->rule.fields[i].size != rule->fields[i].size)) {
-						return 1;
-					}
-				}
-			}
-		}
+	tbl_node = pp2_cls_db_mng_tbl_node_get(tbl);
+	if (!tbl_node)
+		return -EFAULT;
+
+	rule_node = pp2_cls_db_mng_rule_node_get(tbl_node, rule);
+	if (!rule_node)
+		return -ENOENT;
+
+	*logic_index = rule_node->logic_index;
+	return 0;
+}
+
+/*******************************************************************************
+ * pp2_cls_db_mng_tbl_rule_update()
+ *
+ * DESCRIPTION: Update the action and logical index of a rule in CLS Manager table db.
+ *
+ * INPUTS:
+ *	tbl		pointer to the table.
+ *	rule		pointer to the rule.
+ *	action		pointer to the new rule action.
+ *	logic_index	new logical index of the rule in C2 or C3 database.
+ *
+ * OUTPUTS: None.
+ *
+ * RETURN:
+ *	0 on success, error-code otherwise
+ *******************************************************************************/
+int pp2_cls_db_mng_tbl_rule_update(struct pp2_cls_tbl *tbl, struct pp2_cls_tbl_rule *rule,
+				   struct pp2_cls_tbl_action *action, u32 logic_index)
+{
+	struct pp2_cls_tbl_node *tbl_node;
+	struct pp2_cls_rule_node *rule_node;
+
+	tbl_node = pp2_cls_db_mng_tbl_node_get(tbl);
+	if (!tbl_node)
+		return -EFAULT;
+
+	rule_node = pp2_cls_db_mng_rule_node_get(tbl_node, rule);
+	if (!rule_node)
+		return -ENOENT;
+
+	/* The rule may have moved in HW, restart hit counter tracking */
+	if (rule_node->logic_index != logic_index) {
+		rule_node->hw_idx = PP2_CLS_DB_RULE_HW_IDX_INVALID;
+		rule_node->hw_cntr = 0;
 	}
+	rule_node->logic_index = logic_index;
+	rule_node->action.type = action->type;
+	rule_node->action.next_tbl = action->next_tbl;
+	rule_node->action.mark_type = action->mark_type;
+	rule_node->action.u = action->u;
+	if (action->cos)
+		rule_node->action.cos->tc = action->cos->tc;
 	return 0;
 }
 
+/*******************************************************************************
+ * pp2_cls_db_mng_tbl_rule_node_get()
+ *
+ * DESCRIPTION: Get the db node of a rule in CLS Manager table db.
+ *
+ * INPUTS:
+ *	tbl	pointer to the table.
+ *	rule	pointer to the rule.
+ *
+ * OUTPUTS: None.
+ *
+ * RETURN:
+ *	pointer to the rule node, NULL if the rule is not in the table
+ *******************************************************************************/
+struct pp2_cls_rule_node *pp2_cls_db_mng_tbl_rule_node_get(struct pp2_cls_tbl *tbl, struct pp2_cls_tbl_rule *rule)
+{
+	struct pp2_cls_tbl_node *tbl_node;
+
+	tbl_node = pp2_cls_db_mng_tbl_node_get(tbl);
+	if (!tbl_node)
+		return NULL;
+
+	return pp2_cls_db_mng_rule_node_get(tbl_node, rule);
+}
+
+/*******************************************************************************
+ * pp2_cls_db_mng_tbl_rule_list_get()
+ *
+ * DESCRIPTION: Get the rule list of a table in CLS Manager table db.
+ *
+ * INPUTS:
+ *	tbl	pointer to the table.
+ *
+ * OUTPUTS:
+ *	num_rules	number of rules in the list, may be NULL.
+ *
+ * RETURN:
+ *	head of the list of struct pp2_cls_rule_node, NULL if the table does not exist
+ *******************************************************************************/
+struct list *pp2_cls_db_mng_tbl_rule_list_get(struct pp2_cls_tbl *tbl, u32 *num_rules)
+{
+	struct pp2_cls_tbl_node *tbl_node;
+
+	tbl_node = pp2_cls_db_mng_tbl_node_get(tbl);
+	if (!tbl_node)
+		return NULL;
+
+	if (num_rules)
+		*num_rules = tbl_node->num_rules;
+	return &tbl_node->pp2_cls_tbl_rule_head;
+}
+
 /*******************************************************************************
  * pp2_cls_db_mng_tbl_rule_next_get()
  *
@@ -1414,15 +1806,14 @@ int pp2_cls_db_mng_tbl_rule_next_get(struct pp2_cls_tbl *tbl, struct pp2_cls_tbl
 	struct pp2_cls_rule_node *rule_node;
 	struct list *list;
 
-	LIST_FOR_EACH_OBJECT(tbl_node, struct pp2_cls_tbl_node, &mng_db->pp2_cls_tbl_head, list_node) {
-		if (&tbl_node->tbl == tbl) {
-			list = &tbl_node->pp2_cls_tbl_rule_head;
-			rule_node = LIST_FIRST_OBJECT(list, struct pp2_cls_rule_node, list_node);
-			*rule = &rule_node->rule;
-			return 0;
-		}
-	}
-	return -EFAULT;
+	tbl_node = pp2_cls_db_mng_tbl_node_get(tbl);
+	if (!tbl_node || !tbl_node->num_rules)
+		return -EFAULT;
+
+	list = &tbl_node->pp2_cls_tbl_rule_head;
+	rule_node = LIST_FIRST_OBJECT(list, struct pp2_cls_rule_node, list_node);
+	*rule = &rule_node->rule;
+	return 0;
 }
 
 /*******************************************************************************
@@ -1444,43 +1835,21 @@ int pp2_cls_db_mng_tbl_rule_remove(struct pp2_cls_tbl *tbl, struct pp2_cls_tbl_r
 {
 	struct pp2_cls_tbl_node *tbl_node;
 	struct pp2_cls_rule_node *rule_node;
-	u32 i;
-	u32 found;
 
-	LIST_FOR_EACH_OBJECT(tbl_node, struct pp2_cls_tbl_node, &mng_db->pp2_cls_tbl_head, list_node) {
-		if (&tbl_node->tbl == tbl) {
-			LIST_FOR_EACH_OBJECT(rule_node, struct pp2_cls_rule_node, &tbl_node->pp2_cls_tbl_rule_head,
-					     list_node) {
-				found = 1;
-				if (rule_node->rule.num_fields != rule->num_fields) {
-					found = 0;
-					continue;
-				}
-				for (i = 0; i < rule_node->rule.num_fields; i++) {
-					if ((strcmp((char *)rule_node->rule.fields[i].key,
-						    (char *)rule->fields[i].key) != 0) ||
-					    (strcmp((char *)rule_node->rule.fields[i].mask,
-						    (char *)rule->fields[i].mask) != 0) ||
-					    (rule_node->rule.fields[i].size != rule->fields[i].size)) {
-						found = 0;
-						break;
-					}
-				}
-				if (found) {
-					*logic_index = rule_node->logic_index;
-					list_del(&rule_node->list_node);
-					kfree(rule_node->action.cos);
-					for (i = 0; i < rule->num_fields; i++) {
-						kfree(rule_node->rule.fields[i].key);
-						kfree(rule_node->rule.fields[i].mask);
-					}
-					kfree(rule_node);
-					return 0;
-				}
-			}
-		}
-	}
-	return -EFAULT;
+	tbl_node = pp2_cls_db_mng_tbl_node_get(tbl);
+	if (!tbl_node)
+		return -EFAULT;
+
+	rule_node = pp2_cls_db_mng_rule_node_get(tbl_node, rule);
+	if (!rule_node)
+		return -EFAULT;
+
+	*logic_index = rule_node->logic_index;
+	list_del(&rule_node->hash_node);
+	list_del(&rule_node->list_node);
+	tbl_node->num_rules--;
+	pp2_cls_db_mng_rule_node_free(rule_node);
+	return 0;
 }
 
 /*******************************************************************************
@@ -1549,34 +1918,147 @@ int pp2_cls_db_mng_rule_list_dump(struct pp2_cls_tbl *tbl)
 	u32 num_rules;
 	u32 i;
 
-	LIST_FOR_EACH_OBJECT(tbl_node, struct pp2_cls_tbl_node, &mng_db->pp2_cls_tbl_head, list_node) {
-		if (&tbl_node->tbl == tbl) {
-			num_rules = list_num_objs(&tbl_node->pp2_cls_tbl_rule_head);
-			if (!num_rules)
-				return 0;
-			printf("|num_rules %3d |num_fields | size |               key          |", num_rules);
-			printf("             mask           |   type   | tc |\n");
-			print_horizontal_line(110, "=");
-			LIST_FOR_EACH_OBJECT(rule_node, struct pp2_cls_rule_node, &tbl_node->pp2_cls_tbl_rule_head,
-					     list_node) {
-				printf("               |%10d | %4d | %26s | %26s | %8s | %2d |\n",
-				       rule_node->rule.num_fields,
-				       rule_node->rule.fields[0].size,
-				       rule_node->rule.fields[0].key,
-				       rule_node->rule.fields[0].mask,
-				       pp2_cls_utils_tbl_action_type_str_get(rule_node->action.type),
-				       rule_node->action.cos->tc);
-
-				for (i = 1; i < rule_node->rule.num_fields; i++) {
-					printf("               |           | %4d | %26s | %26s |          |    |\n",
-					       rule_node->rule.fields[i].size,
-					       rule_node->rule.fields[i].key,
-					       rule_node->rule.fields[i].mask);
-				}
-				print_horizontal_line(110, "-");
-			}
+	tbl_node = pp2_cls_db_mng_tbl_node_get(tbl);
+	if (!tbl_node)
+		return 0;
+
+	num_rules = tbl_node->num_rules;
+	if (!num_rules)
+		return 0;
+	printf("|num_rules %3d |num_fields | size |               key          |", num_rules);
+	printf("             mask           |   type   | tc |\n");
+	print_horizontal_line(110, "=");
+	LIST_FOR_EACH_OBJECT(rule_node, struct pp2_cls_rule_node, &tbl_node->pp2_cls_tbl_rule_head,
+			     list_node) {
+		printf("               |%10d | %4d | %26s | %26s | %8s | %2d |\n",
+		       rule_node->rule.num_fields,
+		       rule_node->rule.fields[0].size,
+		       rule_node->rule.fields[0].key,
+		       rule_node->rule.fields[0].mask,
+		       pp2_cls_utils_tbl_action_type_str_get(rule_node->action.type),
+		       rule_node->action.cos->tc);
+
+		for (i = 1; i < rule_node->rule.num_fields; i++) {
+			printf("               |           | %4d | %26s | %26s |          |    |\n",
+			       rule_node->rule.fields[i].size,
+			       rule_node->rule.fields[i].key,
+			       rule_node->rule.fields[i].mask);
 		}
+		print_horizontal_line(110, "-");
 	}
 	return 0;
 }
 
+
+static void pp2_cls_db_mng_bench_report(const char *name, u32 num, u64 usecs)
+{
+	printf("%-8s: %8d rules in %8llu usec, %10llu rules/sec\n", name, num, (unsigned long long)usecs,
+	       usecs ? (unsigned long long)num * 1000000 / usecs : 0);
+}
+
+/*******************************************************************************
+ * pp2_cli_cls_db_mng_bench
+ *
+ * DESCRIPTION: The routine bulk loads synthetic rules into a scratch table of
+ *		the CLS Manager db and reports add/lookup/remove rates.
+ *		Only the software db is exercised, no HW entry is written.
+ *
+ * INPUTS:
+ *	arg - packet processor instance pointer
+ *	argc - arguments count
+ *	argv[] - arguments pointer
+ *
+ * RETURNS:
+ *	On success, the function returns 0. On error different types are returned
+ *	according to the case.
+ ******************************************************************************/
+int pp2_cli_cls_db_mng_bench(void *arg, int argc, char *argv[])
+{
+	struct pp2_cls_tbl *tbl;
+	struct pp2_cls_tbl_rule rule;
+	struct pp2_cls_tbl_action action;
+	struct pp2_cls_cos_desc cos;
+	u8 ip[CLS_MNG_KEY_SIZE_MAX], port[CLS_MNG_KEY_SIZE_MAX];
+	u32 num_rules = 10000;
+	u32 i, logic_index, found = 0;
+	char *ret_ptr;
+	u64 start;
+	int rc;
+
+	if (argc > 2) {
+		pr_err("Invalid number of arguments for %s command! number of arguments = %d\n", __func__, argc);
+		return -EINVAL;
+	}
+
+	if (argc == 2) {
+		num_rules = strtoul(argv[1], &ret_ptr, 0);
+		if (argv[1] == ret_ptr || !num_rules) {
+			printf("parsing fail, wrong input for argv[1] - num_rules\n");
+			return -EINVAL;
+		}
+	}
+
+	if (!mng_db) {
+		pr_err("CLS Manager db is not initialized\n");
+		return -EFAULT;
+	}
+
+	rc = pp2_cls_db_mng_tbl_add(&tbl);
+	if (rc)
+		return rc;
+	/* Not a flow table, so the scratch table is skipped by the table dump */
+	tbl->type = PP2_CLS_QOS_TBL;
+
+	memset(&rule, 0, sizeof(rule));
+	memset(&cos, 0, sizeof(cos));
+	action.type = PP2_CLS_TBL_ACT_DONE;
+	action.cos = &cos;
+	rule.num_fields = 2;
+	rule.fields[0].size = 4;
+	rule.fields[0].key = ip;
+	rule.fields[0].mask = (u8 *)"0xffffffff";
+	rule.fields[1].size = 2;
+	rule.fields[1].key = port;
+	rule.fields[1].mask = (u8 *)"0xffff";
+
+#define BENCH_RULE_SET(_i)									\
+	do {											\
+		snprintf((char *)ip, sizeof(ip), "10.%d.%d.%d", ((_i) >> 16) & 0xff,		\
+			 ((_i) >> 8) & 0xff, (_i) & 0xff);					\
+		snprintf((char *)port, sizeof(port), "%d", ((_i) >> 24) + 1024);		\
+	} while (0)
+
+	start = mv_time_usecs();
+	for (i = 0; i < num_rules; i++) {
+		BENCH_RULE_SET(i);
+		if (pp2_cls_db_mng_rule_check(tbl, &rule))
+			continue;
+		rc = pp2_cls_db_mng_tbl_rule_add(tbl, &rule, &action, i);
+		if (rc) {
+			num_rules = i;
+			break;
+		}
+	}
+	pp2_cls_db_mng_bench_report("add", num_rules, mv_time_usecs() - start);
+
+	start = mv_time_usecs();
+	for (i = 0; i < num_rules; i++) {
+		BENCH_RULE_SET(i);
+		found += pp2_cls_db_mng_rule_check(tbl, &rule);
+	}
+	pp2_cls_db_mng_bench_report("lookup", num_rules, mv_time_usecs() - start);
+
+	start = mv_time_usecs();
+	for (i = 0; i < num_rules; i++) {
+		BENCH_RULE_SET(i);
+		pp2_cls_db_mng_tbl_rule_remove(tbl, &rule, &logic_index);
+	}
+	pp2_cls_db_mng_bench_report("remove", num_rules, mv_time_usecs() - start);
+#undef BENCH_RULE_SET
+
+	if (found != num_rules)
+		pr_err("%s: found %d of %d rules\n", __func__, found, num_rules);
+
+	pp2_cls_db_mng_tbl_remove(tbl);
+	return rc;
+}
@@ -52,6 +52,13 @@
 /*PP2 CLS DB init module definition */
 #define MVPP2_CLS_DB_INIT_INVALID_VALUE	(0)	/* Default PP2 CLS DB invalid value	*/
 
+/* CLS Manager db hash sizes, must be power of 2 */
+#define MVPP2_CLS_DB_MNG_TBL_HASH_SIZE	(64)	/* Table handle buckets			*/
+#define MVPP2_CLS_DB_MNG_RULE_HASH_MIN	(64)	/* Initial rule buckets per table	*/
+
+/* Rule HW index not yet known, hit counter tracking restarts from 0 */
+#define PP2_CLS_DB_RULE_HW_IDX_INVALID	(0xFFFFFFFF)
+
 /********************************************************************************/
 /*			ENUMERATIONS						*/
 /********************************************************************************/
@@ -75,6 +82,8 @@ struct pp2_cls_db_c2_t {
 	struct list c2_lu_type_head_db[MVPP2_C2_LKP_TYPE_MAX];
 	/* header of free C2 entry list */
 	struct list c2_free_head_db;
+	/* slot allocator move counters */
+	struct pp2_cls_c2_slot_stats c2_slot_stats;
 };
 
 /* C3 module db structure */
@@ -83,6 +92,7 @@ struct pp2_cls_db_c3_t {
 	u32					max_search_depth;				/* max search depth  */
 	struct pp2_cls_c3_hash_index_entry_t	hash_idx_tbl[MVPP2_CLS_C3_HASH_TBL_SIZE];	/* tbl for hash idx  */
 	struct pp2_cls_c3_logic_index_entry_t	logic_idx_tbl[MVPP2_CLS_C3_HASH_TBL_SIZE];	/* tbl for logic idx */
+	struct pp2_cls_c3_hash_shadow		hash_shadow;					/* multihash model   */
 };
 
 /* CLS module db structure */
@@ -128,6 +138,9 @@ struct pp2_cls_db_cls_t {
 	struct pp2_db_cls_fl_rule_t	fl_rule[MVPP2_FLOW_TBL_SIZE];/*CLS rule DB		*/
 	u16			log2off[MVPP2_CLS_LOG2OFF_TBL_SIZE];/* logical rule ID to offset	*/
 	struct pp2_db_cls_lkp_dcod_t	lkp_dcod[MVPP2_MNG_FLOW_ID_MAX];	/* lookup decode DB	*/
+	struct mv_pp2x_cls_flow_entry	fl_shadow[MVPP2_FLOW_TBL_SIZE];	/* flow table as in HW	*/
+	bool			fl_shadow_valid;		/* fl_shadow matches HW		*/
+	struct pp2_cls_fl_upd_stats	fl_upd_stats;			/* flow update counters	*/
 };
 
 struct pp2_cls_db_prs_t {
@@ -149,28 +162,42 @@ struct pp2_cls_rule_node {
 	struct pp2_cls_tbl_rule		rule;
 	u32				logic_index;	/* Logical index in C2 or C3 database */
 	struct pp2_cls_tbl_action	action;
-	struct list			list_node;
+	struct list			list_node;	/* table rule list, in insertion order */
+	struct list			hash_node;	/* rule hash bucket */
+	u32				hash;		/* hash of the key/mask tuple */
+	u64				hits;		/* hits harvested from HW since the rule was added */
+	u64				last_hit_usecs;	/* time of the last harvested hit, or of rule add */
+	u32				hw_cntr;	/* last HW hit counter value read */
+	u32				hw_idx;		/* HW index hw_cntr was read from */
 };
 
+struct pp2_cls_mng_trans;
+
 struct pp2_cls_tbl {
 	enum pp2_cls_params_tbl_type	type;
 	struct pp2_cls_tbl_params	params;
 	struct pp2_cls_qos_tbl_params	qos_params;
+	struct pp2_cls_mng_trans	*trans;		/* open batch update, NULL if none */
+	u64				stats_usecs;	/* time of the last HW hit counter harvest */
+	struct pp2_cls_tbl		*prev_tbl;	/* maskable table chained to this one, NULL if none */
+	bool				seq_lkp;	/* rules use the lookup sequence lookup type */
 };
 
 struct pp2_cls_tbl_node {
 	struct pp2_cls_tbl		tbl;
 	struct list			list_node;
+	struct list			hash_node;	/* table handle hash bucket */
 	struct list			pp2_cls_tbl_rule_head;
-	struct pp2_cls_rule_node	rule_node;
+	struct list			*rule_hash;	/* rule buckets, indexed by key/mask hash */
+	u32				rule_hash_size;	/* number of rule buckets, power of 2 */
+	u32				num_rules;
 };
 
 struct pp2_cls_db_mng_t {
 	struct list			pp2_cls_tbl_head;
+	struct list			tbl_hash[MVPP2_CLS_DB_MNG_TBL_HASH_SIZE];
 };
 
-struct pp2_cls_db_mng_t *mng_db;		/* PP2_CLS module MNG db */
-
 /********************************************************************************/
 /*			PROTOTYPE						*/
 /********************************************************************************/
@@ -182,6 +209,7 @@ struct pp2_cls_c2_index_t *pp2_cls_db_c2_index_node_get(struct pp2_inst *inst, u
 int pp2_cls_db_c2_index_node_set(struct pp2_inst *inst, u32 c2_node_idx, struct pp2_cls_c2_index_t *c2_index_node);
 int pp2_cls_db_c2_data_get(struct pp2_inst *inst, u32 c2_db_idx, struct pp2_cls_c2_data_t *c2_data);
 int pp2_cls_db_c2_data_set(struct pp2_inst *inst, u32 c2_db_idx, struct pp2_cls_c2_data_t *c2_data);
+struct pp2_cls_c2_slot_stats *pp2_cls_db_c2_slot_stats_get(struct pp2_inst *inst);
 int pp2_cls_db_c2_init(struct pp2_inst *inst);
 
 /* C3 section */
@@ -190,6 +218,7 @@ int pp2_cls_db_c3_entry_add(struct pp2_inst *inst, u32 logic_idx, u32 hash_idx);
 int pp2_cls_db_c3_entry_del(struct pp2_inst *inst, int logic_idx);
 int pp2_cls_db_c3_hash_idx_get(struct pp2_inst *inst, u32 logic_idx, u32 *hash_idx);
 int pp2_cls_db_c3_logic_idx_get(struct pp2_inst *inst, int hash_idx, int *logic_idx);
+struct pp2_cls_c3_hash_shadow *pp2_cls_db_c3_hash_shadow_get(struct pp2_inst *inst);
 int pp2_cls_db_c3_hash_idx_update(struct pp2_inst *inst, struct pp2_cls_c3_hash_pair *hash_pair_arr);
 int pp2_cls_db_c3_scan_param_set(struct pp2_inst *inst, struct pp2_cls_c3_scan_config_t *scan_config);
 int pp2_cls_db_c3_scan_param_get(struct pp2_inst *inst, struct pp2_cls_c3_scan_config_t *scan_config);
@@ -199,6 +228,9 @@ int pp2_cls_db_c3_init(struct pp2_inst *inst);
 
 /* CLS section */
 void pp2_db_cls_init(struct pp2_inst *inst);
+void pp2_db_cls_fl_shadow_reset(struct pp2_inst *inst);
+struct mv_pp2x_cls_flow_entry *pp2_db_cls_fl_shadow_get(struct pp2_inst *inst, u32 off);
+struct pp2_cls_fl_upd_stats *pp2_db_cls_fl_upd_stats_get(struct pp2_inst *inst);
 int  pp2_db_cls_fl_ctrl_set(struct pp2_inst *inst, struct pp2_db_cls_fl_ctrl_t *fl_ctrl);
 int  pp2_db_cls_fl_ctrl_get(struct pp2_inst *inst, struct pp2_db_cls_fl_ctrl_t *fl_ctrl);
 int  pp2_db_cls_fl_rule_set(struct pp2_inst *inst, u32 idx, struct pp2_db_cls_fl_rule_t *fl_rule);
@@ -219,13 +251,21 @@ int pp2_cls_db_mng_tbl_add(struct pp2_cls_tbl **tbl);
 int pp2_cls_db_mng_tbl_remove(struct pp2_cls_tbl *tbl);
 int pp2_cls_db_mng_tbl_check(struct pp2_cls_tbl *tbl);
 int pp2_cls_db_mng_tbl_num_get(void);
-int pp2_cls_db_mng_tbl_rule_add(struct pp2_cls_tbl *tbl, struct pp2_cls_tbl_rule **rule, u32 logic_index,
-				struct pp2_cls_tbl_action **action);
+int pp2_cls_db_mng_tbl_rule_add(struct pp2_cls_tbl *tbl, struct pp2_cls_tbl_rule *rule,
+				struct pp2_cls_tbl_action *action, u32 logic_index);
 int pp2_cls_db_mng_rule_check(struct pp2_cls_tbl *tbl, struct pp2_cls_tbl_rule *rule);
 int pp2_cls_db_mng_tbl_rule_remove(struct pp2_cls_tbl *tbl, struct pp2_cls_tbl_rule *rule, u32 *logic_index);
+int pp2_cls_db_mng_tbl_rule_get(struct pp2_cls_tbl *tbl, struct pp2_cls_tbl_rule *rule, u32 *logic_index);
+int pp2_cls_db_mng_tbl_rule_update(struct pp2_cls_tbl *tbl, struct pp2_cls_tbl_rule *rule,
+				   struct pp2_cls_tbl_action *action, u32 logic_index);
+u32 pp2_cls_db_mng_rule_hash(struct pp2_cls_tbl_rule *rule);
+bool pp2_cls_db_mng_rule_equal(struct pp2_cls_tbl_rule *rule1, struct pp2_cls_tbl_rule *rule2);
 int pp2_cls_db_mng_tbl_rule_next_get(struct pp2_cls_tbl *tbl, struct pp2_cls_tbl_rule **rule);
+struct pp2_cls_rule_node *pp2_cls_db_mng_tbl_rule_node_get(struct pp2_cls_tbl *tbl, struct pp2_cls_tbl_rule *rule);
+struct list *pp2_cls_db_mng_tbl_rule_list_get(struct pp2_cls_tbl *tbl, u32 *num_rules);
 int pp2_cls_db_mng_rule_list_dump(struct pp2_cls_tbl *tbl);
 int pp2_cls_db_mng_tbl_list_dump(void);
+int pp2_cli_cls_db_mng_bench(void *arg, int argc, char *argv[]);
 int pp2_cls_db_mng_qos_tbl_add(struct pp2_cls_tbl **tbl);
 
 /* DB general section */
@@ -82,6 +82,10 @@
 
 #define MVPP2_HWF_MOD_IPTR_MAX		(255)
 #define MVPP2_HW_MOD_DPTR_MAX		(23552)/* Private data 41KB, 41K/2 */
+
+/* Flow ID split over the HWF modification pointers: low byte in IPTR, high byte in DPTR */
+#define MVPP2_CLS_FLOW_ID_LO_MASK	(0xFF)
+#define MVPP2_CLS_FLOW_ID_HI_SHIFT	(8)
 #define MVPP2_POLICER_ID_MAX		MVPP2_CLS3_ACT_DUP_POLICER_MAX
 
 /* WAY definition */
@@ -388,6 +392,7 @@ struct pp2_cls_engine_sram_t {
 	struct mv_pp2x_engine_pkt_mod		pkt_mod;	/* PMT cmd idx and data idx	*/
 	struct mv_pp2x_duplicate_info		dup_info;	/* pkt duplication flow info    */
 	struct pp2_cls_seq_instr_info_t		instr_info;
+	u8					seq_miss;	/* end the lookup sequence on hit */
 };
 
 #endif /* _PP2_CLS_INTERNAL_TYPES_H_ */
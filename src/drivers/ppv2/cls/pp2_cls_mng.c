@@ -34,6 +34,7 @@
 /* c file declarations */
 /***********************/
 #include <arpa/inet.h>
+#include <time.h>
 #include "std_internal.h"
 #include "drivers/ppv2/pp2.h"
 #include "drivers/ppv2/pp2_hw_type.h"
@@ -163,6 +164,7 @@ int pp2_cls_mng_lkp_type_to_prio(int lkp_type)
 		prio = MVPP2_CLS_MUSDK_DEF_PRIO;
 		break;
 	case MVPP2_CLS_LKP_MUSDK_CLS:
+	case MVPP2_CLS_LKP_MUSDK_CLS_SEQ:
 		prio = MVPP2_CLS_MUSDK_CLS_PRIO;
 		break;
 	default:
@@ -466,6 +468,7 @@ static int pp2_cls_mng_add_default_flow(struct pp2_ppio *ppio)
 	struct pp2_cls_tbl *tbl;
 
 	/* add default flow for all lkpid */
+	MVPP2_MEMSET_ZERO(tbl_params);
 	tbl_params.type = PP2_CLS_TBL_MASKABLE;
 	tbl_params.max_num_rules = 1;
 	tbl_params.key.key_size = 0;
@@ -524,46 +527,50 @@ int pp2_cls_mng_set_logical_port_params(struct pp2_ppio *ppio, struct pp2_ppio_p
 	return 0;
 }
 
-int pp2_cls_mng_tbl_init(struct pp2_cls_tbl_params *params, struct pp2_cls_tbl **tbl, int lkp_type)
+/*
+ * pp2_cls_mng_set_tunnel_params()
+ * configure parser tunnel encapsulations for port
+ */
+int pp2_cls_mng_set_tunnel_params(struct pp2_ppio *ppio, struct pp2_ppio_params *params)
 {
-	struct pp2_cls_fl_rule_list_t *fl_rls;
-	struct pp2_ppio *ppio;
-	struct pp2_port *port;
-	struct pp2_inst *inst;
-	struct pp2_cls_tbl *tbl_node = NULL;
-	struct pp2_cls_cos_desc *cos;
-
-	u32 idx;
-	u32 field, match_bm;
-	u32 rc = 0;
-	u32 i, num_lkpid = 0, field_index;
-	u32 five_tuple = 0;
-	u32 ipv4_flag = 0;
-	u32 ipv6_flag = 0;
-	u32 tcp_flag = 0;
-	u32 udp_flag = 0;
-	u32 l4_flag = 0;
-	u16 select_logical_id[30];
+	struct pp2_port *port = GET_PPIO_PORT(ppio);
+	int rc;
 
-	/* Para check */
-	if (mv_pp2x_ptr_validate(params))
+	rc = pp2_prs_tunnel_set(port, params->tunnels);
+	if (rc) {
+		pr_err("%s(%d) pp2_prs_tunnel_set fail\n", __func__, __LINE__);
 		return -EINVAL;
+	}
 
-	if (mv_pp2x_range_validate(params->key.num_fields, 0, PP2_CLS_TBL_MAX_NUM_FIELDS))
-		return -EINVAL;
-	pr_debug("key.num_fields = %d\n", params->key.num_fields);
+	return 0;
+}
 
-	fl_rls = kmalloc(sizeof(*fl_rls), GFP_KERNEL);
-	if (!fl_rls)
-		return -ENOMEM;
+/*
+ * pp2_cls_mng_clear_tunnel_params()
+ * remove parser tunnel encapsulations of port
+ */
+void pp2_cls_mng_clear_tunnel_params(struct pp2_ppio *ppio)
+{
+	pp2_prs_tunnel_remove(GET_PPIO_PORT(ppio));
+}
 
-	/* get packet processor instance */
-	ppio = params->default_act.cos->ppio;
-	port = GET_PPIO_PORT(ppio);
-	inst = port->parent;
+/* protocols referenced by a table key, select the logical flows of the table */
+struct pp2_cls_mng_key_proto {
+	u32	ipv4;
+	u32	ipv6;
+	u32	tcp;
+	u32	udp;
+	u32	l4;
+};
 
-	fl_rls->fl_len = 1;
-	field_index = 0;
+/* Build the flow rule of a table from its key */
+static int pp2_cls_mng_fl_rule_build(struct pp2_cls_tbl_params *params, struct pp2_port *port, int lkp_type,
+				     struct pp2_cls_fl_rule_entry_t *fl, struct pp2_cls_mng_key_proto *key_proto)
+{
+	u32 idx;
+	u32 field, match_bm;
+	u32 five_tuple = 0;
+	int rc;
 
 	/* parse the protocol and protocol fields */
 	for (idx = 0; idx < params->key.num_fields; idx++) {
@@ -571,27 +578,27 @@ int pp2_cls_mng_tbl_init(struct pp2_cls_tbl_params *params, struct pp2_cls_tbl *
 				     params->key.proto_field[idx].field.eth, &field, &match_bm);
 		if (rc) {
 			pr_err("%s(%d) lookup id error!\n", __func__, __LINE__);
-			goto end;
+			return rc;
 		}
 		if (params->key.proto_field[idx].proto == MV_NET_PROTO_IP4) {
-			ipv4_flag = 1;
+			key_proto->ipv4 = 1;
 			if ((params->key.proto_field[idx].field.ipv4 == MV_NET_IP4_F_PROTO) &&
 			    (params->key.num_fields == PP2_CLS_TBL_MAX_NUM_FIELDS))
 				five_tuple = 1;
 		} else if (params->key.proto_field[idx].proto == MV_NET_PROTO_IP6) {
-			ipv6_flag = 1;
+			key_proto->ipv6 = 1;
 			if ((params->key.proto_field[idx].field.ipv6 == MV_NET_IP6_F_NEXT_HDR) &&
 			    (params->key.num_fields == PP2_CLS_TBL_MAX_NUM_FIELDS))
 				five_tuple = 1;
 		}
 		if (params->key.proto_field[idx].proto == MV_NET_PROTO_TCP)
-			tcp_flag = 1;
+			key_proto->tcp = 1;
 		else if (params->key.proto_field[idx].proto == MV_NET_PROTO_UDP)
-			udp_flag = 1;
+			key_proto->udp = 1;
 		else if (params->key.proto_field[idx].proto == MV_NET_PROTO_L4)
-			l4_flag = 1;
+			key_proto->l4 = 1;
 
-		fl_rls->fl[0].field_id[field_index++] = field;
+		fl->field_id[idx] = field;
 	}
 
 	/* engine selection */
@@ -600,47 +607,151 @@ int pp2_cls_mng_tbl_init(struct pp2_cls_tbl_params *params, struct pp2_cls_tbl *
 			pr_err("%s(%d) maskable engine doesn't support 5 tuples!\n", __func__, __LINE__);
 			return -EINVAL;
 		}
-		fl_rls->fl[0].engine = MVPP2_CLS_ENGINE_C2;
+		fl->engine = MVPP2_CLS_ENGINE_C2;
 	} else if (params->type == PP2_CLS_TBL_EXACT_MATCH) {
 		if (five_tuple)
-			fl_rls->fl[0].engine = MVPP2_CLS_ENGINE_C3B;
+			fl->engine = MVPP2_CLS_ENGINE_C3B;
 		else
-			fl_rls->fl[0].engine = MVPP2_CLS_ENGINE_C3A;
+			fl->engine = MVPP2_CLS_ENGINE_C3A;
 	} else {
 		pr_err("%s(%d) unknown engine type!\n", __func__, __LINE__);
 		return -EINVAL;
 	}
 
 	/* port type - TODO fixed to PHY for now */
-	fl_rls->fl[0].port_type = MVPP2_SRC_PORT_TYPE_PHY;
+	fl->port_type = MVPP2_SRC_PORT_TYPE_PHY;
 
 	/* port ID - TODO set it fixed to 1. this value is used only if
 	 * PortIdSelect bit in CLS_FLOW_TBL1 register is set to 0
 	 */
-	fl_rls->fl[0].port_bm = (1 << port->id);
+	fl->port_bm = (1 << port->id);
 
 	/* lookup_type */
-	fl_rls->fl[0].lu_type = lkp_type;
+	fl->lu_type = lkp_type;
 	/* as default DSCP flows should be disabled */
-	fl_rls->fl[0].enabled = (lkp_type != MVPP2_CLS_LKP_MUSDK_DSCP_PRI) ? true : false;
+	fl->enabled = (lkp_type != MVPP2_CLS_LKP_MUSDK_DSCP_PRI) ? true : false;
 
-	fl_rls->fl[0].prio = pp2_cls_mng_lkp_type_to_prio(lkp_type);
-	if (fl_rls->fl[0].prio < 0)
+	fl->prio = pp2_cls_mng_lkp_type_to_prio(lkp_type);
+	if (fl->prio < 0)
 		return -EINVAL;
 
-	fl_rls->fl[0].udf7 = (port->type == PP2_PPIO_T_LOG) ? MVPP2_CLS_MUSDK_LOG_UDF7 : MVPP2_CLS_MUSDK_NIC_UDF7;
-	fl_rls->fl[0].seq_ctrl = MVPP2_CLS_DEF_SEQ_CTRL;
-	fl_rls->fl[0].field_id_cnt = params->key.num_fields - (fl_rls->fl[0].engine == MVPP2_CLS_ENGINE_C3B);
+	fl->udf7 = (port->type == PP2_PPIO_T_LOG) ? MVPP2_CLS_MUSDK_LOG_UDF7 : MVPP2_CLS_MUSDK_NIC_UDF7;
+	fl->seq_ctrl = MVPP2_CLS_DEF_SEQ_CTRL;
+	fl->field_id_cnt = params->key.num_fields - (fl->engine == MVPP2_CLS_ENGINE_C3B);
+	return 0;
+}
+
+/*
+ * Check that a maskable table can chain its lookups into 'next_tbl'.
+ * The rules of both tables use a lookup type of their own, so the exact match
+ * table can be chained only while it has no rules of the standalone type.
+ */
+static int pp2_cls_mng_tbl_chain_check(struct pp2_cls_tbl_params *params, struct pp2_cls_tbl *next_tbl)
+{
+	u32 num_rules;
 
-	pr_debug("ipv4_flag = %d\n", ipv4_flag);
-	pr_debug("ipv6_flag = %d\n", ipv6_flag);
-	pr_debug("l4_flag = %d\n", l4_flag);
-	pr_debug("udp_flag = %d\n", udp_flag);
-	pr_debug("tcp_flag = %d\n", tcp_flag);
+	if (params->type != PP2_CLS_TBL_MASKABLE) {
+		pr_err("%s(%d) only a maskable table can chain lookups\n", __func__, __LINE__);
+		return -EINVAL;
+	}
 
-	if (lkp_type == MVPP2_CLS_LKP_MUSDK_CLS) {
-		num_lkpid = pp2_cls_mng_get_lkpid_for_flow_type(&select_logical_id[0], ipv4_flag, ipv6_flag,
-								tcp_flag, udp_flag, l4_flag);
+	if (pp2_cls_db_mng_tbl_check(next_tbl) || next_tbl->type != PP2_CLS_FLOW_TBL) {
+		pr_err("%s(%d) next table not found in db\n", __func__, __LINE__);
+		return -EINVAL;
+	}
+
+	if (next_tbl->params.type != PP2_CLS_TBL_EXACT_MATCH) {
+		pr_err("%s(%d) next table must be an exact match table\n", __func__, __LINE__);
+		return -EINVAL;
+	}
+
+	if (next_tbl->params.default_act.cos->ppio != params->default_act.cos->ppio) {
+		pr_err("%s(%d) next table is on another ppio\n", __func__, __LINE__);
+		return -EINVAL;
+	}
+
+	if (next_tbl->prev_tbl || next_tbl->params.next_tbl) {
+		pr_err("%s(%d) next table is already chained\n", __func__, __LINE__);
+		return -EBUSY;
+	}
+
+	pp2_cls_db_mng_tbl_rule_list_get(next_tbl, &num_rules);
+	if (!next_tbl->seq_lkp && (num_rules || next_tbl->trans)) {
+		pr_err("%s(%d) next table must have no rules when first chained\n", __func__, __LINE__);
+		return -EBUSY;
+	}
+	return 0;
+}
+
+int pp2_cls_mng_tbl_init(struct pp2_cls_tbl_params *params, struct pp2_cls_tbl **tbl, int lkp_type)
+{
+	struct pp2_cls_fl_rule_list_t *fl_rls;
+	struct pp2_cls_mng_key_proto key_proto;
+	struct pp2_ppio *ppio;
+	struct pp2_port *port;
+	struct pp2_inst *inst;
+	struct pp2_cls_tbl *tbl_node = NULL;
+	struct pp2_cls_cos_desc *cos;
+
+	u32 rc = 0;
+	u32 i, j, num_lkpid = 0;
+	u16 select_logical_id[30];
+
+	/* Para check */
+	if (mv_pp2x_ptr_validate(params))
+		return -EINVAL;
+
+	if (mv_pp2x_range_validate(params->key.num_fields, 0, PP2_CLS_TBL_MAX_NUM_FIELDS))
+		return -EINVAL;
+	pr_debug("key.num_fields = %d\n", params->key.num_fields);
+
+	if (params->next_tbl) {
+		if (lkp_type != MVPP2_CLS_LKP_MUSDK_CLS)
+			return -EINVAL;
+		rc = pp2_cls_mng_tbl_chain_check(params, params->next_tbl);
+		if (rc)
+			return rc;
+		lkp_type = MVPP2_CLS_LKP_MUSDK_CLS_SEQ;
+	}
+
+	fl_rls = kcalloc(1, sizeof(*fl_rls), GFP_KERNEL);
+	if (!fl_rls)
+		return -ENOMEM;
+
+	/* get packet processor instance */
+	ppio = params->default_act.cos->ppio;
+	port = GET_PPIO_PORT(ppio);
+	inst = port->parent;
+
+	MVPP2_MEMSET_ZERO(key_proto);
+	fl_rls->fl_len = 1;
+	rc = pp2_cls_mng_fl_rule_build(params, port, lkp_type, &fl_rls->fl[0], &key_proto);
+	if (rc)
+		goto end;
+
+	/*
+	 * Chained tables: the C2 lookup starts a sequence that the C3 lookup ends.
+	 * A C2 miss, or a C2 hit with the sequence miss attribute, skips the C3
+	 * lookup. The flows are those on which both keys can be extracted.
+	 */
+	if (params->next_tbl) {
+		fl_rls->fl_len = 2;
+		rc = pp2_cls_mng_fl_rule_build(&params->next_tbl->params, port, lkp_type, &fl_rls->fl[1], &key_proto);
+		if (rc)
+			goto end;
+		fl_rls->fl[0].seq_ctrl = MVPP2_CLS_SEQ_CTRL_FIRST_TYPE_1;
+		fl_rls->fl[1].seq_ctrl = MVPP2_CLS_SEQ_CTRL_LAST;
+	}
+
+	pr_debug("ipv4_flag = %d\n", key_proto.ipv4);
+	pr_debug("ipv6_flag = %d\n", key_proto.ipv6);
+	pr_debug("l4_flag = %d\n", key_proto.l4);
+	pr_debug("udp_flag = %d\n", key_proto.udp);
+	pr_debug("tcp_flag = %d\n", key_proto.tcp);
+
+	if (lkp_type == MVPP2_CLS_LKP_MUSDK_CLS || lkp_type == MVPP2_CLS_LKP_MUSDK_CLS_SEQ) {
+		num_lkpid = pp2_cls_mng_get_lkpid_for_flow_type(&select_logical_id[0], key_proto.ipv4, key_proto.ipv6,
+								key_proto.tcp, key_proto.udp, key_proto.l4);
 	} else {
 		num_lkpid = pp2_cls_mng_get_lkpid_for_lkp_type(lkp_type, &select_logical_id[0]);
 	}
@@ -648,7 +759,8 @@ int pp2_cls_mng_tbl_init(struct pp2_cls_tbl_params *params, struct pp2_cls_tbl *
 	/* add current rule for all selected logical flow id */
 	for (i = 0; i < num_lkpid; i++) {
 		pr_debug("select_logical_id = %d\n", select_logical_id[i]);
-		fl_rls->fl[0].fl_log_id = select_logical_id[i];
+		for (j = 0; j < fl_rls->fl_len; j++)
+			fl_rls->fl[j].fl_log_id = select_logical_id[i];
 
 		/* Add flow rule */
 		pp2_cls_lkp_dcod_set_and_disable(inst, select_logical_id[i]);
@@ -666,6 +778,17 @@ int pp2_cls_mng_tbl_init(struct pp2_cls_tbl_params *params, struct pp2_cls_tbl *
 	tbl_node->params.type = params->type;
 	tbl_node->type = PP2_CLS_FLOW_TBL;
 	tbl_node->params.default_act.type = params->default_act.type;
+	tbl_node->params.stats_mode = params->stats_mode;
+	tbl_node->params.stats_interval_ms = params->stats_interval_ms;
+	tbl_node->params.aging_mode = params->aging_mode;
+	tbl_node->params.aging_timeout_ms = params->aging_timeout_ms;
+	tbl_node->stats_usecs = mv_time_usecs();
+	if (params->next_tbl) {
+		tbl_node->params.next_tbl = params->next_tbl;
+		tbl_node->seq_lkp = true;
+		params->next_tbl->prev_tbl = tbl_node;
+		params->next_tbl->seq_lkp = true;
+	}
 	cos = kmalloc(sizeof(*cos), GFP_KERNEL);
 	if (!cos) {
 		pr_err("%s(%d) no mem for pp2_cls_cos_desc!\n", __func__, __LINE__);
@@ -695,6 +818,15 @@ int pp2_cls_mng_table_deinit(struct pp2_cls_tbl *tbl)
 	struct pp2_cls_tbl_rule *rule = NULL;
 	u32 rc;
 
+	/* The lookups of the previous table still continue into this one */
+	if (tbl->prev_tbl) {
+		pr_err("%s(%d) table is chained to another table\n", __func__, __LINE__);
+		return -EBUSY;
+	}
+
+	/* Drop a batch update that was never committed */
+	pp2_cls_mng_trans_abort(tbl);
+
 	/* Remove configured rules in table */
 	for (i = 0; i < tbl->params.max_num_rules; i++) {
 		rc = pp2_cls_db_mng_tbl_rule_next_get(tbl, &rule);
@@ -704,6 +836,10 @@ int pp2_cls_mng_table_deinit(struct pp2_cls_tbl *tbl)
 
 	/*TODO remove flow from HW */
 
+	/* The next table keeps the sequence lookup type, it can be chained again */
+	if (tbl->params.next_tbl)
+		tbl->params.next_tbl->prev_tbl = NULL;
+
 	/* Remove rules and table from database */
 	kfree(tbl->params.default_act.cos);
 
@@ -1159,8 +1295,14 @@ static void pp2_cls_mng_set_c2_action(struct pp2_port *port,
 	} else {
 	/* for classifier and default rules */
 		if (action->cos->tc >= 0 && action->cos->tc < PP2_PPIO_MAX_NUM_TCS) {
-			pkt_action->q_low_act = MVPP2_ACTION_TYPE_UPDT_LOCK;
-			pkt_action->q_high_act = MVPP2_ACTION_TYPE_UPDT_LOCK;
+			/* let the next lookup override the queue */
+			if (action->type == PP2_CLS_TBL_ACT_LU) {
+				pkt_action->q_low_act = MVPP2_ACTION_TYPE_UPDT;
+				pkt_action->q_high_act = MVPP2_ACTION_TYPE_UPDT;
+			} else {
+				pkt_action->q_low_act = MVPP2_ACTION_TYPE_UPDT_LOCK;
+				pkt_action->q_high_act = MVPP2_ACTION_TYPE_UPDT_LOCK;
+			}
 			queue = port->tc[action->cos->tc].tc_config.first_rxq;
 			pkt_qos->q_high = ((u16)queue) >> MVPP2_CLS2_ACT_QOS_ATTR_QL_BITS;
 			pkt_qos->q_low = ((u16)queue) & ((1 << MVPP2_CLS2_ACT_QOS_ATTR_QL_BITS) - 1);
@@ -1203,57 +1345,148 @@ static void pp2_cls_mng_set_c3_action(struct pp2_port *port,
 	}
 }
 
-static int pp2_cls_mng_rule_update_db(struct pp2_cls_tbl_rule *rule, struct pp2_cls_tbl_rule *rule_db,
-				      struct pp2_cls_tbl_action *action, struct pp2_cls_tbl_action *action_db)
+/*
+ * The flow ID is reported in the RX descriptor from the HWF modification
+ * pointers of the matching C2/C3 action when FlowID is enabled. Those pointers
+ * are only used for HW forwarded packets, so they are free for packets to CPU.
+ */
+static int pp2_cls_mng_set_flow_id(struct pp2_cls_tbl_action *action,
+				   struct mv_pp2x_engine_pkt_action *pkt_action,
+				   struct mv_pp2x_engine_pkt_mod *pkt_mod)
 {
-	u8 *key, *mask;
-	u32 i;
+	if (action->mark_type == PP2_CLS_TBL_MARK_TYPE_NONE)
+		return 0;
 
-	rule_db->num_fields = rule->num_fields;
+	if (action->mark_type != PP2_CLS_TBL_MARK_TYPE_FLOW_ID) {
+		pr_err("%s(%d) unknown mark type %d\n", __func__, __LINE__, action->mark_type);
+		return -EINVAL;
+	}
 
-	for (i = 0; i < rule->num_fields; i++) {
-		rule_db->fields[i].size = rule->fields[i].size;
-		key = kmalloc(CLS_MNG_KEY_SIZE_MAX, GFP_KERNEL);
-		if (!key) {
-			pr_err("no mem for HEK in DB!\n");
-			return -ENOMEM;
+	pkt_action->flowid_act = MVPP2_ACTION_FLOWID_ENABLE;
+	pkt_mod->mod_cmd_idx = action->u.flow_id & MVPP2_CLS_FLOW_ID_LO_MASK;
+	pkt_mod->mod_data_idx = action->u.flow_id >> MVPP2_CLS_FLOW_ID_HI_SHIFT;
+	return 0;
+}
+
+/* HW entry of a rule, built from its key and action before any HW access */
+struct pp2_cls_mng_rule_entry {
+	struct pp2_cls_pkt_key_t	pkt_key;
+	struct pp2_cls_mng_pkt_key_t	mng_pkt_key;
+	struct mv_pp2x_c2_add_entry	c2_entry;
+	struct pp2_cls_c3_add_entry_t	c3_entry;
+};
+
+static int pp2_cls_mng_rule_entry_build(struct pp2_cls_tbl *tbl, struct pp2_cls_tbl_rule *rule,
+					struct pp2_cls_tbl_action *action, int lkp_type,
+					struct pp2_cls_mng_rule_entry *entry)
+{
+	struct mv_pp2x_engine_pkt_action pkt_action;
+	struct mv_pp2x_qos_value pkt_qos;
+	struct mv_pp2x_src_port rule_port;
+	struct pp2_cls_tbl_params *params = &tbl->params;
+	struct pp2_port *port;
+	int rc;
+
+	/* init value */
+	MVPP2_MEMSET_ZERO(*entry);
+	MVPP2_MEMSET_ZERO(pkt_action);
+	MVPP2_MEMSET_ZERO(pkt_qos);
+	entry->mng_pkt_key.pkt_key = &entry->pkt_key;
+
+	if (action->type == PP2_CLS_TBL_ACT_LU &&
+	    (!params->next_tbl || action->next_tbl != params->next_tbl)) {
+		pr_err("%s(%d) lookup action must continue into the next table of the table\n", __func__, __LINE__);
+		return -EINVAL;
+	}
+
+	/* Rules of chained tables are matched by the sequence flow rules only */
+	if (tbl->seq_lkp && lkp_type == MVPP2_CLS_LKP_MUSDK_CLS)
+		lkp_type = MVPP2_CLS_LKP_MUSDK_CLS_SEQ;
+
+	port = GET_PPIO_PORT(params->default_act.cos->ppio);
+	rc = pp2_cls_set_rule_info(&entry->mng_pkt_key, &rule_port, params, rule, port);
+	if (rc) {
+		pr_err("%s(%d) pp2_cls_set_rule_info failed\n", __func__, __LINE__);
+		return rc;
+	}
+
+	if (params->type == PP2_CLS_TBL_MASKABLE) {
+		struct mv_pp2x_c2_add_entry *c2_entry = &entry->c2_entry;
+
+		c2_entry->mng_pkt_key = &entry->mng_pkt_key;
+		c2_entry->lkp_type = lkp_type;
+		c2_entry->lkp_type_mask = MVPP2_C2_HEK_LKP_TYPE_MASK >> MVPP2_C2_HEK_LKP_TYPE_OFFS;
+		pp2_cls_mng_set_c2_action(port, c2_entry, &pkt_qos, &pkt_action, action, lkp_type);
+		rc = pp2_cls_mng_set_flow_id(action, &pkt_action, &c2_entry->pkt_mod);
+		if (rc)
+			return rc;
+		/* only lookup actions continue into the next table */
+		c2_entry->seq_miss = (params->next_tbl && action->type != PP2_CLS_TBL_ACT_LU);
+
+		memcpy(&c2_entry->port, &rule_port, sizeof(rule_port));
+		memcpy(&c2_entry->action, &pkt_action, sizeof(pkt_action));
+		memcpy(&c2_entry->qos_value, &pkt_qos, sizeof(pkt_qos));
+	} else if (params->type == PP2_CLS_TBL_EXACT_MATCH) {
+		struct pp2_cls_c3_add_entry_t *c3_entry = &entry->c3_entry;
+
+		c3_entry->mng_pkt_key = &entry->mng_pkt_key;
+		c3_entry->lkp_type = lkp_type;
+
+		pp2_cls_mng_set_c3_action(port, &pkt_qos, &pkt_action, action, lkp_type);
+		rc = pp2_cls_mng_set_flow_id(action, &pkt_action, &c3_entry->pkt_mod);
+		if (rc)
+			return rc;
+
+		memcpy(&c3_entry->port, &rule_port, sizeof(rule_port));
+		memcpy(&c3_entry->action, &pkt_action, sizeof(pkt_action));
+		memcpy(&c3_entry->qos_value, &pkt_qos, sizeof(pkt_qos));
+	} else {
+		pr_err("%s(%d) unknown engine type!\n", __func__, __LINE__);
+		return -EINVAL;
+	}
+	return 0;
+}
+
+static int pp2_cls_mng_rule_entry_write(struct pp2_inst *inst, struct pp2_cls_tbl *tbl,
+					struct pp2_cls_mng_rule_entry *entry, u32 *logic_idx)
+{
+	int rc;
+
+	if (tbl->params.type == PP2_CLS_TBL_MASKABLE) {
+		rc = pp2_cls_c2_rule_add(inst, &entry->c2_entry, logic_idx);
+		if (rc) {
+			pr_err("fail to add C2 rule\n");
+			return rc;
 		}
-		memcpy(key, rule->fields[i].key, CLS_MNG_KEY_SIZE_MAX);
-		rule_db->fields[i].key = key;
-
-		mask = kmalloc(CLS_MNG_KEY_SIZE_MAX, GFP_KERNEL);
-		if (!mask) {
-			kfree(key);
-			pr_err("no mem for HEK in DB!\n");
-			return -ENOMEM;
+		pr_debug("Rule added in C2: logic_idx: %d\n", *logic_idx);
+	} else {
+		rc = pp2_cls_c3_rule_add(inst, &entry->c3_entry, logic_idx);
+		if (rc) {
+			pr_err("fail to add C3 rule\n");
+			return rc;
 		}
-		memcpy(mask, rule->fields[i].mask, CLS_MNG_KEY_SIZE_MAX);
-		rule_db->fields[i].mask = mask;
+		pr_debug("Rule added in C3: logic_idx: %d\n", *logic_idx);
 	}
+	return 0;
+}
 
-	action_db->cos = kmalloc(sizeof(*action_db->cos), GFP_KERNEL);
-	if (!action_db->cos)
-		return -ENOMEM;
+static int pp2_cls_mng_rule_entry_del(struct pp2_inst *inst, struct pp2_cls_tbl *tbl, u32 logic_idx)
+{
+	if (tbl->params.type == PP2_CLS_TBL_MASKABLE)
+		return pp2_cls_c2_rule_del(inst, logic_idx);
+	else if (tbl->params.type == PP2_CLS_TBL_EXACT_MATCH)
+		return pp2_cls_c3_rule_del(inst, logic_idx);
 
-	action_db->type = action->type;
-	action_db->cos->tc = action->cos->tc;
-	return 0;
+	pr_err("%s(%d) unknown engine type!\n", __func__, __LINE__);
+	return -EINVAL;
 }
 
 int pp2_cls_mng_rule_add(struct pp2_cls_tbl *tbl, struct pp2_cls_tbl_rule *rule,
 			 struct pp2_cls_tbl_action *action, int lkp_type)
 {
-	struct pp2_cls_pkt_key_t pkt_key;
-	struct pp2_cls_mng_pkt_key_t mng_pkt_key;
-	struct mv_pp2x_engine_pkt_action pkt_action;
-	struct mv_pp2x_qos_value pkt_qos;
-	struct mv_pp2x_src_port rule_port;
-	struct pp2_port *port;
+	struct pp2_cls_mng_rule_entry entry;
 	struct pp2_inst *inst;
 	u32 rc = 0, logic_idx;
-	struct pp2_cls_tbl_params *params = &tbl->params;
-	struct pp2_cls_tbl_rule *rule_db;
-	struct pp2_cls_tbl_action *action_db;
 
 	/* check if table exists in DB */
 	if (tbl->type != PP2_CLS_FLOW_TBL) {
@@ -1275,73 +1508,17 @@ int pp2_cls_mng_rule_add(struct pp2_cls_tbl *tbl, struct pp2_cls_tbl_rule *rule,
 		return -EFAULT;
 	}
 
-	/* init value */
-	MVPP2_MEMSET_ZERO(pkt_key);
-	MVPP2_MEMSET_ZERO(mng_pkt_key);
-	MVPP2_MEMSET_ZERO(pkt_action);
-	MVPP2_MEMSET_ZERO(pkt_qos);
-	mng_pkt_key.pkt_key = &pkt_key;
-
-	port = GET_PPIO_PORT(params->default_act.cos->ppio);
-	inst = port->parent;
-	rc = pp2_cls_set_rule_info(&mng_pkt_key, &rule_port, params, rule, port);
-	if (rc) {
-		pr_err("%s(%d) pp2_cls_set_rule_info failed\n", __func__, __LINE__);
+	rc = pp2_cls_mng_rule_entry_build(tbl, rule, action, lkp_type, &entry);
+	if (rc)
 		return rc;
-	}
-
-	if (params->type == PP2_CLS_TBL_MASKABLE) {
-		struct mv_pp2x_c2_add_entry c2_entry;
-
-		MVPP2_MEMSET_ZERO(c2_entry);
-		c2_entry.mng_pkt_key = &mng_pkt_key;
-		c2_entry.mng_pkt_key->pkt_key = &pkt_key;
-		c2_entry.lkp_type = lkp_type;
-		c2_entry.lkp_type_mask = MVPP2_C2_HEK_LKP_TYPE_MASK >> MVPP2_C2_HEK_LKP_TYPE_OFFS;
-		pp2_cls_mng_set_c2_action(port, &c2_entry, &pkt_qos, &pkt_action, action, lkp_type);
 
-		memcpy(&c2_entry.port, &rule_port, sizeof(rule_port));
-		memcpy(&c2_entry.action, &pkt_action, sizeof(pkt_action));
-		memcpy(&c2_entry.qos_value, &pkt_qos, sizeof(pkt_qos));
-
-		/* add rule */
-		rc = pp2_cls_c2_rule_add(inst, &c2_entry, &logic_idx);
-		if (rc) {
-			pr_err("fail to add C2 rule\n");
-			return rc;
-		}
-		pr_debug("Rule added in C2: logic_idx: %d\n", logic_idx);
-	} else if (params->type == PP2_CLS_TBL_EXACT_MATCH) {
-		struct pp2_cls_c3_add_entry_t c3_entry;
-
-		MVPP2_MEMSET_ZERO(c3_entry);
-		c3_entry.mng_pkt_key = &mng_pkt_key;
-		c3_entry.mng_pkt_key->pkt_key = &pkt_key;
-		c3_entry.lkp_type = lkp_type;
-
-		pp2_cls_mng_set_c3_action(port, &pkt_qos, &pkt_action, action, lkp_type);
-
-		memcpy(&c3_entry.port, &rule_port, sizeof(rule_port));
-		memcpy(&c3_entry.action, &pkt_action, sizeof(pkt_action));
-		memcpy(&c3_entry.qos_value, &pkt_qos, sizeof(pkt_qos));
-
-		/* add rule */
-		rc = pp2_cls_c3_rule_add(inst, &c3_entry, &logic_idx);
-		if (rc) {
-			pr_err("fail to add C3 rule\n");
-			return rc;
-		}
-		pr_debug("Rule added in C3: logic_idx: %d\n", logic_idx);
-	} else {
-		pr_err("%s(%d) unknown engine type!\n", __func__, __LINE__);
-		return -EINVAL;
-	}
-	/* Update database */
-	rc = pp2_cls_db_mng_tbl_rule_add(tbl, &rule_db, logic_idx, &action_db);
+	inst = GET_PPIO_PORT(tbl->params.default_act.cos->ppio)->parent;
+	rc = pp2_cls_mng_rule_entry_write(inst, tbl, &entry, &logic_idx);
 	if (rc)
-		return -EFAULT;
+		return rc;
 
-	rc = pp2_cls_mng_rule_update_db(rule, rule_db, action, action_db);
+	/* Update database */
+	rc = pp2_cls_db_mng_tbl_rule_add(tbl, rule, action, logic_idx);
 	if (rc)
 		return -EFAULT;
 
@@ -1371,13 +1548,10 @@ int pp2_cls_mng_rule_remove(struct pp2_cls_tbl *tbl, struct pp2_cls_tbl_rule *ru
 		return -EFAULT;
 
 	pr_debug("logic_index %d\n", logic_index);
-	if (params->type == PP2_CLS_TBL_MASKABLE) {
-		pp2_cls_c2_rule_del(inst, logic_index);
-	} else if (params->type == PP2_CLS_TBL_EXACT_MATCH) {
-		pp2_cls_c3_rule_del(inst, logic_index);
-	} else {
-		pr_err("%s(%d) unknown engine type!\n", __func__, __LINE__);
-		return -EINVAL;
+	rc = pp2_cls_mng_rule_entry_del(inst, tbl, logic_index);
+	if (rc) {
+		pr_err("failed to delete rule entry %d from HW (%d)\n", logic_index, rc);
+		return rc;
 	}
 	return 0;
 }
@@ -1406,6 +1580,587 @@ int pp2_cls_mng_rule_modify(struct pp2_cls_tbl *tbl, struct pp2_cls_tbl_rule *ru
 	}
 	return 0;
 }
+
+/* Per-rule hit statistics and aging */
+
+/*
+ * Read the hits of a rule since the previous read.
+ * C2 hit counters are cleared on read. C3 hit counters can only be cleared per
+ * lookup type, which all flow tables share, so the delta against the previous
+ * value is used instead. When the entry is new or was relocated in the hash
+ * table, the first read only takes the baseline and reports no hits.
+ */
+static int pp2_cls_mng_rule_hits_read(struct pp2_inst *inst, struct pp2_cls_tbl *tbl,
+				      struct pp2_cls_rule_node *node, u32 *hits)
+{
+	uintptr_t cpu_slot = pp2_default_cpu_slot(inst);
+	u32 hw_idx, db_idx, cntr;
+	int rc;
+
+	if (tbl->params.type == PP2_CLS_TBL_MASKABLE) {
+		rc = pp2_cls_c2_get_hw_idx_from_logic_idx(inst, node->logic_index, &hw_idx, &db_idx);
+		if (rc)
+			return rc;
+		/* includes the hits harvested when the entry was moved */
+		rc = pp2_cls_c2_hit_cntr_get(inst, node->logic_index, hits);
+		if (rc)
+			return rc;
+		node->hw_idx = hw_idx;
+		return 0;
+	}
+
+	rc = pp2_cls_db_c3_hash_idx_get(inst, node->logic_index, &hw_idx);
+	if (rc)
+		return rc;
+	rc = pp2_cls_c3_hit_cntrs_read(cpu_slot, hw_idx, &cntr);
+	if (rc)
+		return rc;
+	if (hw_idx != node->hw_idx)
+		node->hw_cntr = cntr;
+	*hits = (cntr - node->hw_cntr) & MVPP2_CLS3_HIT_COUNTER_MASK;
+	node->hw_cntr = cntr;
+	node->hw_idx = hw_idx;
+	return 0;
+}
+
+static void pp2_cls_mng_rule_stats_fill(struct pp2_cls_rule_node *node, u64 now,
+					struct pp2_cls_tbl_rule_stats *stats)
+{
+	stats->rule = &node->rule;
+	stats->pkts = node->hits;
+	stats->idle_ms = (now - node->last_hit_usecs) / 1000;
+}
+
+int pp2_cls_mng_stats_poll(struct pp2_cls_tbl *tbl, u32 *num_aged)
+{
+	struct pp2_cls_rule_node *node, *tmp;
+	struct pp2_inst *inst;
+	struct list *head;
+	u32 hits, aged = 0;
+	u64 now;
+	int rc;
+
+	if (num_aged)
+		*num_aged = 0;
+
+	if (tbl->type != PP2_CLS_FLOW_TBL || tbl->params.stats_mode == PP2_CLS_TBL_STATS_M_NONE)
+		return -EOPNOTSUPP;
+
+	head = pp2_cls_db_mng_tbl_rule_list_get(tbl, NULL);
+	if (!head) {
+		pr_err("table not found in db\n");
+		return -EFAULT;
+	}
+
+	now = mv_time_usecs();
+	if (now - tbl->stats_usecs < (u64)tbl->params.stats_interval_ms * 1000)
+		return 0;
+	tbl->stats_usecs = now;
+
+	inst = GET_PPIO_PORT(tbl->params.default_act.cos->ppio)->parent;
+	LIST_FOR_EACH_OBJECT(node, struct pp2_cls_rule_node, head, list_node) {
+		rc = pp2_cls_mng_rule_hits_read(inst, tbl, node, &hits);
+		if (rc) {
+			pr_err("fail to read hit counter for logical index(%d)\n", node->logic_index);
+			return rc;
+		}
+		if (hits) {
+			node->hits += hits;
+			node->last_hit_usecs = now;
+		}
+	}
+
+	/* Removing a staged rule would break the open batch */
+	if (tbl->params.aging_mode != PP2_CLS_TBL_AGING_M_IDLE || tbl->trans)
+		return 0;
+
+	LIST_FOR_EACH_OBJECT_SAFE(node, tmp, head, struct pp2_cls_rule_node, list_node) {
+		if (now - node->last_hit_usecs < (u64)tbl->params.aging_timeout_ms * 1000)
+			continue;
+		rc = pp2_cls_mng_rule_remove(tbl, &node->rule);
+		if (rc) {
+			pr_err("fail to age rule\n");
+			return rc;
+		}
+		aged++;
+	}
+
+	if (num_aged)
+		*num_aged = aged;
+	return 0;
+}
+
+int pp2_cls_mng_rule_stats_get(struct pp2_cls_tbl *tbl, struct pp2_cls_tbl_rule *rule,
+			       struct pp2_cls_tbl_rule_stats *stats)
+{
+	struct pp2_cls_rule_node *node;
+
+	if (tbl->params.stats_mode == PP2_CLS_TBL_STATS_M_NONE)
+		return -EOPNOTSUPP;
+
+	node = pp2_cls_db_mng_tbl_rule_node_get(tbl, rule);
+	if (!node)
+		return -ENOENT;
+
+	pp2_cls_mng_rule_stats_fill(node, mv_time_usecs(), stats);
+	return 0;
+}
+
+int pp2_cls_mng_top_n_get(struct pp2_cls_tbl *tbl, struct pp2_cls_tbl_rule_stats stats[], u32 *num)
+{
+	struct pp2_cls_rule_node *node;
+	struct list *head;
+	u32 i, cnt = 0;
+	u64 now;
+
+	if (tbl->params.stats_mode == PP2_CLS_TBL_STATS_M_NONE)
+		return -EOPNOTSUPP;
+
+	head = pp2_cls_db_mng_tbl_rule_list_get(tbl, NULL);
+	if (!head)
+		return -EFAULT;
+
+	/* Insertion into a sorted array of the *num best; N is expected to be small */
+	now = mv_time_usecs();
+	LIST_FOR_EACH_OBJECT(node, struct pp2_cls_rule_node, head, list_node) {
+		if (cnt == *num && (!cnt || node->hits <= stats[cnt - 1].pkts))
+			continue;
+		if (cnt < *num)
+			cnt++;
+		for (i = cnt - 1; i > 0 && stats[i - 1].pkts < node->hits; i--)
+			stats[i] = stats[i - 1];
+		pp2_cls_mng_rule_stats_fill(node, now, &stats[i]);
+	}
+
+	*num = cnt;
+	return 0;
+}
+
+int pp2_cls_mng_idle_get(struct pp2_cls_tbl *tbl, u64 idle_ms, struct pp2_cls_tbl_rule_stats stats[], u32 *num)
+{
+	struct pp2_cls_rule_node *node;
+	struct list *head;
+	u32 cnt = 0;
+	u64 now;
+
+	if (tbl->params.stats_mode == PP2_CLS_TBL_STATS_M_NONE)
+		return -EOPNOTSUPP;
+
+	head = pp2_cls_db_mng_tbl_rule_list_get(tbl, NULL);
+	if (!head)
+		return -EFAULT;
+
+	now = mv_time_usecs();
+	LIST_FOR_EACH_OBJECT(node, struct pp2_cls_rule_node, head, list_node) {
+		if (cnt == *num)
+			break;
+		if (now - node->last_hit_usecs < idle_ms * 1000)
+			continue;
+		pp2_cls_mng_rule_stats_fill(node, now, &stats[cnt++]);
+	}
+
+	*num = cnt;
+	return 0;
+}
+
+/* Batch (transactional) rule update */
+struct pp2_cls_mng_trans_op {
+	struct list			list_node;
+	enum pp2_cls_mng_trans_op_type	type;
+	u32				hash;
+	u32				logic_idx;
+	struct pp2_cls_tbl_rule		rule;
+	u8				key[PP2_CLS_TBL_MAX_NUM_FIELDS][CLS_MNG_KEY_SIZE_MAX];
+	u8				mask[PP2_CLS_TBL_MAX_NUM_FIELDS][CLS_MNG_KEY_SIZE_MAX];
+	struct pp2_cls_tbl_action	action;
+	struct pp2_cls_cos_desc		cos;
+	struct pp2_cls_mng_rule_entry	entry;
+	/* rule as in the table before the batch, to roll back a modify or remove */
+	struct pp2_cls_tbl_action	old_action;
+	struct pp2_cls_cos_desc		old_cos;
+	struct pp2_cls_mng_rule_entry	old_entry;
+	int				applied;	/* written to HW and DB by the commit */
+};
+
+struct pp2_cls_mng_trans {
+	struct list			op_list;
+	u32				num_ops;
+};
+
+static void pp2_cls_mng_trans_action_copy(struct pp2_cls_tbl_action *dst, struct pp2_cls_cos_desc *dst_cos,
+					  struct pp2_cls_tbl_action *src)
+{
+	dst->type = src->type;
+	dst->next_tbl = src->next_tbl;
+	dst->mark_type = src->mark_type;
+	dst->u = src->u;
+	dst->cos = dst_cos;
+	if (src->cos)
+		*dst_cos = *src->cos;
+}
+
+static void pp2_cls_mng_trans_op_action_set(struct pp2_cls_mng_trans_op *op, struct pp2_cls_tbl_action *action)
+{
+	pp2_cls_mng_trans_action_copy(&op->action, &op->cos, action);
+}
+
+static struct pp2_cls_mng_trans_op *pp2_cls_mng_trans_op_alloc(enum pp2_cls_mng_trans_op_type type,
+							       struct pp2_cls_tbl_rule *rule,
+							       struct pp2_cls_tbl_action *action)
+{
+	struct pp2_cls_mng_trans_op *op;
+	u32 i;
+
+	if (rule->num_fields > PP2_CLS_TBL_MAX_NUM_FIELDS) {
+		pr_err("%s: too many fields (%d)\n", __func__, rule->num_fields);
+		return NULL;
+	}
+
+	op = kcalloc(1, sizeof(*op), GFP_KERNEL);
+	if (!op)
+		return NULL;
+
+	op->type = type;
+	op->rule.num_fields = rule->num_fields;
+	for (i = 0; i < rule->num_fields; i++) {
+		op->rule.fields[i].size = rule->fields[i].size;
+		if (rule->fields[i].key)
+			strncpy((char *)op->key[i], (char *)rule->fields[i].key, CLS_MNG_KEY_SIZE_MAX - 1);
+		if (rule->fields[i].mask)
+			strncpy((char *)op->mask[i], (char *)rule->fields[i].mask, CLS_MNG_KEY_SIZE_MAX - 1);
+		op->rule.fields[i].key = op->key[i];
+		op->rule.fields[i].mask = op->mask[i];
+	}
+	op->hash = pp2_cls_db_mng_rule_hash(&op->rule);
+	if (action)
+		pp2_cls_mng_trans_op_action_set(op, action);
+	return op;
+}
+
+static void pp2_cls_mng_trans_free(struct pp2_cls_tbl *tbl)
+{
+	struct pp2_cls_mng_trans_op *op, *tmp;
+
+	LIST_FOR_EACH_OBJECT_SAFE(op, tmp, &tbl->trans->op_list, struct pp2_cls_mng_trans_op, list_node) {
+		list_del(&op->list_node);
+		kfree(op);
+	}
+	kfree(tbl->trans);
+	tbl->trans = NULL;
+}
+
+int pp2_cls_mng_trans_begin(struct pp2_cls_tbl *tbl)
+{
+	if (tbl->type != PP2_CLS_FLOW_TBL) {
+		pr_err("%s(%d) wrong table type inserted\n", __func__, __LINE__);
+		return -EFAULT;
+	}
+
+	if (tbl->trans) {
+		pr_err("batch update already open on table\n");
+		return -EBUSY;
+	}
+
+	tbl->trans = kcalloc(1, sizeof(*tbl->trans), GFP_KERNEL);
+	if (!tbl->trans)
+		return -ENOMEM;
+
+	INIT_LIST(&tbl->trans->op_list);
+	return 0;
+}
+
+void pp2_cls_mng_trans_abort(struct pp2_cls_tbl *tbl)
+{
+	if (tbl->trans)
+		pp2_cls_mng_trans_free(tbl);
+}
+
+/*
+ * Staged operations on the same rule are folded on the fly, so that a batch
+ * holds at most one operation per rule:
+ *	add + modify	-> add with the new action
+ *	add + remove	-> nothing
+ *	modify + modify	-> modify with the new action
+ *	modify + remove	-> remove
+ *	remove + add	-> modify with the new action
+ */
+int pp2_cls_mng_trans_rule_stage(struct pp2_cls_tbl *tbl, enum pp2_cls_mng_trans_op_type type,
+				 struct pp2_cls_tbl_rule *rule, struct pp2_cls_tbl_action *action)
+{
+	struct pp2_cls_mng_trans *trans = tbl->trans;
+	struct pp2_cls_mng_trans_op *op, *new_op;
+
+	new_op = pp2_cls_mng_trans_op_alloc(type, rule, action);
+	if (!new_op)
+		return -ENOMEM;
+
+	LIST_FOR_EACH_OBJECT(op, struct pp2_cls_mng_trans_op, &trans->op_list, list_node) {
+		if (op->hash == new_op->hash && pp2_cls_db_mng_rule_equal(&op->rule, &new_op->rule))
+			break;
+	}
+	if (&op->list_node == &trans->op_list) {
+		list_add_to_tail(&new_op->list_node, &trans->op_list);
+		trans->num_ops++;
+		return 0;
+	}
+
+	kfree(new_op);
+
+	if ((op->type == PP2_CLS_MNG_TRANS_OP_REMOVE) != (type == PP2_CLS_MNG_TRANS_OP_ADD)) {
+		pr_err("rule is %s in batch\n", (op->type == PP2_CLS_MNG_TRANS_OP_REMOVE) ? "removed" : "duplicated");
+		return (op->type == PP2_CLS_MNG_TRANS_OP_REMOVE) ? -ENOENT : -EEXIST;
+	}
+
+	if (type == PP2_CLS_MNG_TRANS_OP_REMOVE) {
+		if (op->type == PP2_CLS_MNG_TRANS_OP_ADD) {
+			list_del(&op->list_node);
+			kfree(op);
+			trans->num_ops--;
+		} else {
+			op->type = PP2_CLS_MNG_TRANS_OP_REMOVE;
+		}
+		return 0;
+	}
+
+	if (op->type == PP2_CLS_MNG_TRANS_OP_REMOVE)
+		op->type = PP2_CLS_MNG_TRANS_OP_MODIFY;
+	pp2_cls_mng_trans_op_action_set(op, action);
+	return 0;
+}
+
+static int pp2_cls_mng_trans_prepare(struct pp2_inst *inst, struct pp2_cls_tbl *tbl, u32 *num_add)
+{
+	struct pp2_cls_mng_trans_op *op;
+	struct pp2_cls_rule_node *node;
+	u32 free_num;
+	int rc;
+
+	*num_add = 0;
+	LIST_FOR_EACH_OBJECT(op, struct pp2_cls_mng_trans_op, &tbl->trans->op_list, list_node) {
+		rc = pp2_cls_db_mng_tbl_rule_get(tbl, &op->rule, &op->logic_idx);
+		if (op->type == PP2_CLS_MNG_TRANS_OP_ADD && !rc) {
+			pr_err("rule is duplicated in table\n");
+			return -EEXIST;
+		}
+		if (op->type != PP2_CLS_MNG_TRANS_OP_ADD && rc) {
+			pr_err("rule not found in table\n");
+			return -ENOENT;
+		}
+
+		if (op->type != PP2_CLS_MNG_TRANS_OP_ADD) {
+			/* keep the current version of the rule for rollback */
+			node = pp2_cls_db_mng_tbl_rule_node_get(tbl, &op->rule);
+			if (!node)
+				return -ENOENT;
+			pp2_cls_mng_trans_action_copy(&op->old_action, &op->old_cos, &node->action);
+			rc = pp2_cls_mng_rule_entry_build(tbl, &op->rule, &op->old_action, MVPP2_CLS_LKP_MUSDK_CLS,
+							  &op->old_entry);
+			if (rc)
+				return rc;
+		}
+
+		if (op->type == PP2_CLS_MNG_TRANS_OP_REMOVE)
+			continue;
+
+		rc = pp2_cls_mng_rule_entry_build(tbl, &op->rule, &op->action, MVPP2_CLS_LKP_MUSDK_CLS, &op->entry);
+		if (rc)
+			return rc;
+
+		if (op->type == PP2_CLS_MNG_TRANS_OP_ADD)
+			(*num_add)++;
+	}
+
+	/* C2 TCAM entries are placed per rule, but the whole batch must fit before any write */
+	if (tbl->params.type == PP2_CLS_TBL_MASKABLE) {
+		rc = pp2_cls_c2_free_entry_number_get(inst, &free_num);
+		if (rc)
+			return rc;
+		if (free_num < *num_add) {
+			pr_err("not enough C2 entries for batch (%d free, %d needed)\n", free_num, *num_add);
+			return -ENOSPC;
+		}
+	}
+	return 0;
+}
+
+/* Rewrite the action of a rule in place, its key stays valid in HW all along */
+static int pp2_cls_mng_trans_op_modify(struct pp2_inst *inst, struct pp2_cls_tbl *tbl,
+				       struct pp2_cls_mng_trans_op *op, struct pp2_cls_mng_rule_entry *entry,
+				       struct pp2_cls_tbl_action *action)
+{
+	struct pp2_cls_engine_sram_t sram;
+	int rc;
+
+	if (tbl->params.type == PP2_CLS_TBL_MASKABLE) {
+		struct mv_pp2x_c2_add_entry *c2_entry = &entry->c2_entry;
+
+		MVPP2_MEMSET_ZERO(sram);
+		sram.qos_info = c2_entry->qos_info;
+		sram.action = c2_entry->action;
+		sram.qos_value = c2_entry->qos_value;
+		sram.pkt_mod = c2_entry->pkt_mod;
+		sram.dup_info = c2_entry->flow_info;
+		sram.seq_miss = c2_entry->seq_miss;
+		rc = pp2_cls_c2_rule_sram_update(inst, op->logic_idx, &sram);
+	} else {
+		rc = pp2_cls_c3_rule_action_update(inst, &entry->c3_entry, op->logic_idx);
+	}
+	if (rc)
+		return rc;
+	return pp2_cls_db_mng_tbl_rule_update(tbl, &op->rule, action, op->logic_idx);
+}
+
+/* Number of HW entries the C2 and C3 engines moved so far to make room for new rules */
+static u32 pp2_cls_mng_trans_moves_get(struct pp2_inst *inst)
+{
+	return pp2_cls_db_c2_slot_stats_get(inst)->num_moves +
+	       pp2_cls_db_c3_hash_shadow_get(inst)->num_relocations;
+}
+
+/*
+ * Undo the operations of a batch already written to HW, in reverse phase order:
+ * removed rules are added back, modified rules get their previous action and
+ * added rules are deleted. Rollback is best effort, a failure is only logged.
+ */
+static void pp2_cls_mng_trans_rollback(struct pp2_inst *inst, struct pp2_cls_tbl *tbl)
+{
+	struct pp2_cls_mng_trans_op *op;
+	u32 logic_idx;
+	int rc;
+
+	LIST_FOR_EACH_OBJECT(op, struct pp2_cls_mng_trans_op, &tbl->trans->op_list, list_node) {
+		if (!op->applied || op->type != PP2_CLS_MNG_TRANS_OP_REMOVE)
+			continue;
+		rc = pp2_cls_mng_rule_entry_write(inst, tbl, &op->old_entry, &logic_idx);
+		if (!rc) {
+			rc = pp2_cls_db_mng_tbl_rule_add(tbl, &op->rule, &op->old_action, logic_idx);
+			if (rc)
+				pp2_cls_mng_rule_entry_del(inst, tbl, logic_idx);
+		}
+		if (rc)
+			pr_err("cls manager batch - failed to restore removed rule (%d)\n", rc);
+	}
+
+	LIST_FOR_EACH_OBJECT(op, struct pp2_cls_mng_trans_op, &tbl->trans->op_list, list_node) {
+		if (!op->applied || op->type != PP2_CLS_MNG_TRANS_OP_MODIFY)
+			continue;
+		rc = pp2_cls_mng_trans_op_modify(inst, tbl, op, &op->old_entry, &op->old_action);
+		if (rc)
+			pr_err("cls manager batch - failed to restore modified rule (%d)\n", rc);
+	}
+
+	LIST_FOR_EACH_OBJECT(op, struct pp2_cls_mng_trans_op, &tbl->trans->op_list, list_node) {
+		if (!op->applied || op->type != PP2_CLS_MNG_TRANS_OP_ADD)
+			continue;
+		rc = pp2_cls_db_mng_tbl_rule_remove(tbl, &op->rule, &logic_idx);
+		if (!rc)
+			rc = pp2_cls_mng_rule_entry_del(inst, tbl, logic_idx);
+		if (rc)
+			pr_err("cls manager batch - failed to delete added rule (%d)\n", rc);
+	}
+}
+
+/*
+ * Apply a batch. Nothing is written to HW until every staged rule has been
+ * validated against the table and converted to its C2/C3 entry. Then new rules
+ * are added, existing rules get their new action in place and finally old rules
+ * are removed, so a packet always hits either the previous or the new version
+ * of a rule. If any HW write fails, the operations already applied are rolled
+ * back and the table is left as before the batch. During the rollback, the
+ * rules removed by the batch are added back and so may miss for a short time.
+ */
+int pp2_cls_mng_trans_commit(struct pp2_cls_tbl *tbl, struct pp2_cls_tbl_commit_stats *stats)
+{
+	struct pp2_cls_mng_trans_op *op;
+	struct pp2_cls_tbl_commit_stats l_stats;
+	struct pp2_inst *inst;
+	u32 num_add, logic_idx, num_moves;
+	u64 start;
+	int rc;
+
+	if (!tbl->trans) {
+		pr_err("no batch update open on table\n");
+		return -EINVAL;
+	}
+
+	MVPP2_MEMSET_ZERO(l_stats);
+	inst = GET_PPIO_PORT(tbl->params.default_act.cos->ppio)->parent;
+
+	rc = pp2_cls_mng_trans_prepare(inst, tbl, &num_add);
+	if (rc)
+		goto end;
+
+	start = mv_time_usecs();
+	num_moves = pp2_cls_mng_trans_moves_get(inst);
+
+	LIST_FOR_EACH_OBJECT(op, struct pp2_cls_mng_trans_op, &tbl->trans->op_list, list_node) {
+		if (op->type != PP2_CLS_MNG_TRANS_OP_ADD)
+			continue;
+
+		rc = pp2_cls_mng_rule_entry_write(inst, tbl, &op->entry, &op->logic_idx);
+		if (!rc) {
+			rc = pp2_cls_db_mng_tbl_rule_add(tbl, &op->rule, &op->action, op->logic_idx);
+			if (rc)
+				pp2_cls_mng_rule_entry_del(inst, tbl, op->logic_idx);
+		}
+		if (rc) {
+			pr_err("cls manager batch - add error\n");
+			goto rollback;
+		}
+		op->applied = 1;
+		l_stats.num_add++;
+		l_stats.num_hw_writes++;
+	}
+
+	LIST_FOR_EACH_OBJECT(op, struct pp2_cls_mng_trans_op, &tbl->trans->op_list, list_node) {
+		if (op->type != PP2_CLS_MNG_TRANS_OP_MODIFY)
+			continue;
+
+		rc = pp2_cls_mng_trans_op_modify(inst, tbl, op, &op->entry, &op->action);
+		if (rc) {
+			pr_err("cls manager batch - modify error\n");
+			goto rollback;
+		}
+		op->applied = 1;
+		l_stats.num_modify++;
+		l_stats.num_hw_writes++;
+	}
+
+	LIST_FOR_EACH_OBJECT(op, struct pp2_cls_mng_trans_op, &tbl->trans->op_list, list_node) {
+		if (op->type != PP2_CLS_MNG_TRANS_OP_REMOVE)
+			continue;
+
+		rc = pp2_cls_db_mng_tbl_rule_remove(tbl, &op->rule, &logic_idx);
+		if (!rc) {
+			rc = pp2_cls_mng_rule_entry_del(inst, tbl, op->logic_idx);
+			if (rc)
+				pp2_cls_db_mng_tbl_rule_add(tbl, &op->rule, &op->old_action, op->logic_idx);
+		}
+		if (rc) {
+			pr_err("cls manager batch - remove error\n");
+			goto rollback;
+		}
+		op->applied = 1;
+		l_stats.num_remove++;
+		l_stats.num_hw_writes++;
+	}
+
+	l_stats.num_hw_writes += pp2_cls_mng_trans_moves_get(inst) - num_moves;
+	l_stats.usecs = mv_time_usecs() - start;
+	pr_debug("batch: %d added, %d modified, %d removed, %d HW writes in %llu usec\n",
+		 l_stats.num_add, l_stats.num_modify, l_stats.num_remove, l_stats.num_hw_writes,
+		 (unsigned long long)l_stats.usecs);
+	goto end;
+rollback:
+	pp2_cls_mng_trans_rollback(inst, tbl);
+	MVPP2_MEMSET_ZERO(l_stats);
+end:
+	if (stats)
+		*stats = l_stats;
+	pp2_cls_mng_trans_free(tbl);
+	return rc;
+}
+
 void pp2_cls_mng_init(struct pp2_inst *inst)
 {
 	if (inst->cls_db)
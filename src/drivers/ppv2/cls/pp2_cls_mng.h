@@ -62,8 +62,27 @@ int pp2_cls_mng_rule_add(struct pp2_cls_tbl *tbl, struct pp2_cls_tbl_rule *rule,
 int pp2_cls_mng_rule_modify(struct pp2_cls_tbl *tbl, struct pp2_cls_tbl_rule *rule, struct pp2_cls_tbl_action *action);
 int pp2_cls_mng_rule_remove(struct pp2_cls_tbl *tbl, struct pp2_cls_tbl_rule *rule);
 int pp2_cls_mng_set_logical_port_params(struct pp2_ppio *ppio, struct pp2_ppio_params *params);
+int pp2_cls_mng_set_tunnel_params(struct pp2_ppio *ppio, struct pp2_ppio_params *params);
+void pp2_cls_mng_clear_tunnel_params(struct pp2_ppio *ppio);
 int pp2_cls_dscp_flow_modify(struct pp2_port *port, int set);
 int pp2_cls_mng_qos_tbl_init(struct pp2_cls_qos_tbl_params *qos_params, struct pp2_cls_tbl **tbl);
 int pp2_cls_mng_lkp_type_to_prio(int lkp_type);
+int pp2_cls_mng_stats_poll(struct pp2_cls_tbl *tbl, u32 *num_aged);
+int pp2_cls_mng_rule_stats_get(struct pp2_cls_tbl *tbl, struct pp2_cls_tbl_rule *rule,
+			       struct pp2_cls_tbl_rule_stats *stats);
+int pp2_cls_mng_top_n_get(struct pp2_cls_tbl *tbl, struct pp2_cls_tbl_rule_stats stats[], u32 *num);
+int pp2_cls_mng_idle_get(struct pp2_cls_tbl *tbl, u64 idle_ms, struct pp2_cls_tbl_rule_stats stats[], u32 *num);
+
+enum pp2_cls_mng_trans_op_type {
+	PP2_CLS_MNG_TRANS_OP_ADD,
+	PP2_CLS_MNG_TRANS_OP_MODIFY,
+	PP2_CLS_MNG_TRANS_OP_REMOVE
+};
+
+int pp2_cls_mng_trans_begin(struct pp2_cls_tbl *tbl);
+int pp2_cls_mng_trans_rule_stage(struct pp2_cls_tbl *tbl, enum pp2_cls_mng_trans_op_type type,
+				 struct pp2_cls_tbl_rule *rule, struct pp2_cls_tbl_action *action);
+int pp2_cls_mng_trans_commit(struct pp2_cls_tbl *tbl, struct pp2_cls_tbl_commit_stats *stats);
+void pp2_cls_mng_trans_abort(struct pp2_cls_tbl *tbl);
 
 #endif /* _PP2_MNG_H_ */
@@ -0,0 +1,959 @@
+/******************************************************************************
+ *	Copyright (C) 2016 Marvell International Ltd.
+ *
+ *  If you received this File from Marvell, you may opt to use, redistribute
+ *  and/or modify this File under the following licensing terms.
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *	* Redistributions of source code must retain the above copyright
+ *	  notice, this list of conditions and the following disclaimer.
+ *
+ *	* Redistributions in binary form must reproduce the above copyright
+ *	  notice, this list of conditions and the following disclaimer in the
+ *	  documentation and/or other materials provided with the distribution.
+ *
+ *	* Neither the name of Marvell nor the names of its contributors may be
+ *	  used to endorse or promote products derived from this software
+ *	  without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+/**
+ * @file pp2_cls_model.c
+ *
+ * Software model of the parser and classifier
+ *
+ * The model runs a packet through images of the parser TCAM/SRAM, the lookup
+ * decode table, the flow table and the C2/C3 engine tables, in the format the
+ * driver writes them to HW. It has no HW access, the images are either read
+ * from HW by pp2_cls_model_snapshot() or loaded from a file, so rule sets can
+ * be checked off target.
+ *
+ * The engine keys are built with the HEK layout of the driver, C3 keys are
+ * searched by key compare instead of by hash, and QoS table, RSS and C4
+ * results are only reported by flags.
+ */
+
+/***********************/
+/* c file declarations */
+/***********************/
+#include "std_internal.h"
+
+#include "../pp2_types.h"
+#include "../pp2.h"
+#include "../pp2_hw_type.h"
+#include "../pp2_hw_cls.h"
+#include "pp2_prs.h"
+#include "pp2_cls_model.h"
+
+#define PP2_CLS_MODEL_PRS_DATA_BYTES	8	/* packet bytes seen by a parser TCAM lookup */
+#define PP2_CLS_MODEL_COLOR_RED		3
+
+/* Packet fields needed to build the engine keys */
+struct pp2_cls_model_pkt {
+	const u8	*data;
+	u32		len;
+	u32		ri;
+	int		l3_offs;
+	int		l4_offs;
+};
+
+/* Engine actions, decoded from the C2 or C3 action registers */
+struct pp2_cls_model_act {
+	u32	color_act;
+	u32	ql_act;
+	u32	qh_act;
+	u32	rss_act;
+	u32	fid_en;
+	u32	ql;
+	u32	qh;
+	u32	flow_id;
+	u32	rss_en;
+	u32	qos_tbl;	/* queue/color taken from a QoS table */
+};
+
+/* Result fields locked by an engine action */
+struct pp2_cls_model_lock {
+	bool	color;
+	bool	ql;
+	bool	qh;
+	bool	rss;
+};
+
+/**
+ * pp2_cls_model_init
+ *
+ * The routine clears the model images. All parser and C2 entries are invalid,
+ * all lookup decode entries are disabled.
+ *
+ * @param[in]	model	model images
+ */
+void pp2_cls_model_init(struct pp2_cls_model *model)
+{
+	int i;
+
+	memset(model, 0, sizeof(*model));
+	model->magic = PP2_CLS_MODEL_MAGIC;
+	model->version = PP2_CLS_MODEL_VERSION;
+
+	for (i = 0; i < MVPP2_PRS_TCAM_SRAM_SIZE; i++) {
+		model->prs[i].index = i;
+		model->prs[i].tcam.word[MVPP2_PRS_TCAM_INV_WORD] = MVPP2_PRS_TCAM_INV_MASK;
+	}
+	for (i = 0; i < MVPP2_CLS_C2_TCAM_SIZE; i++) {
+		model->c2[i].index = i;
+		model->c2[i].inv = 1;
+	}
+}
+
+/* Get bits of the parser SRAM, bit_num in the bit numbering of the SRAM defines */
+static u32 pp2_cls_model_sram_bits_get(struct mv_pp2x_prs_entry *pe, int bit_num, int num)
+{
+	u32 val = 0;
+	int i;
+
+	for (i = 0; i < num; i++)
+		if (pe->sram.byte[SRAM_BIT_TO_BYTE(bit_num + i)] & BIT((bit_num + i) % BYTE_BITS))
+			val |= BIT(i);
+
+	return val;
+}
+
+/* Get a big endian bit field of the packet, 0 beyond the packet end */
+static u32 pp2_cls_model_pkt_bits(struct pp2_cls_model_pkt *pkt, int offs, u32 bit_offs, u32 bits)
+{
+	u32 pos, byte, val = 0;
+
+	if (offs < 0)
+		return 0;
+
+	for (pos = bit_offs; pos < bit_offs + bits; pos++) {
+		byte = offs + pos / BYTE_BITS;
+		val <<= 1;
+		if (byte < pkt->len)
+			val |= (pkt->data[byte] >> (BYTE_BITS - 1 - pos % BYTE_BITS)) & 1;
+	}
+
+	return val;
+}
+
+static void pp2_cls_model_pkt_bytes(struct pp2_cls_model_pkt *pkt, int offs, u8 bytes[], u32 num)
+{
+	u32 i;
+
+	for (i = 0; i < num; i++)
+		bytes[i] = pp2_cls_model_pkt_bits(pkt, offs + i, 0, BYTE_BITS);
+}
+
+/**
+ * pp2_cls_model_prs_match
+ *
+ * The routine gets the first parser TCAM entry that matches a lookup
+ *
+ * @retval	TCAM index, -1 on miss
+ */
+static int pp2_cls_model_prs_match(struct pp2_cls_model *model, u32 port, u32 lu, u32 ai,
+				   struct pp2_cls_model_pkt *pkt, int offs)
+{
+	struct mv_pp2x_prs_entry *pe;
+	u8 *tcam;
+	u32 i;
+	int tid;
+
+	for (tid = 0; tid < MVPP2_PRS_TCAM_SRAM_SIZE; tid++) {
+		pe = &model->prs[tid];
+		tcam = pe->tcam.byte;
+		if (pe->tcam.word[MVPP2_PRS_TCAM_INV_WORD] & MVPP2_PRS_TCAM_INV_MASK)
+			continue;
+
+		if ((tcam[HW_BYTE_OFFS(MVPP2_PRS_TCAM_LU_BYTE)] ^ lu) &
+		    tcam[HW_BYTE_OFFS(MVPP2_PRS_TCAM_EN_OFFS(MVPP2_PRS_TCAM_LU_BYTE))] & MVPP2_PRS_LU_MASK)
+			continue;
+		/* a port takes part when its enable bit is clear */
+		if ((tcam[HW_BYTE_OFFS(MVPP2_PRS_TCAM_PORT_BYTE)] ^ BIT(port)) &
+		    tcam[HW_BYTE_OFFS(MVPP2_PRS_TCAM_EN_OFFS(MVPP2_PRS_TCAM_PORT_BYTE))])
+			continue;
+		if ((tcam[HW_BYTE_OFFS(MVPP2_PRS_TCAM_AI_BYTE)] ^ ai) &
+		    tcam[HW_BYTE_OFFS(MVPP2_PRS_TCAM_EN_OFFS(MVPP2_PRS_TCAM_AI_BYTE))])
+			continue;
+
+		for (i = 0; i < PP2_CLS_MODEL_PRS_DATA_BYTES; i++)
+			if ((pp2_cls_model_pkt_bits(pkt, offs + i, 0, BYTE_BITS) ^ tcam[TCAM_DATA_BYTE(i)]) &
+			    tcam[TCAM_DATA_MASK(i)])
+				break;
+		if (i == PP2_CLS_MODEL_PRS_DATA_BYTES)
+			return tid;
+	}
+
+	return -1;
+}
+
+/**
+ * pp2_cls_model_prs_run
+ *
+ * The routine runs the parser lookups of a packet, until a lookup done entry,
+ * a TCAM miss or the port max loop, and sets the parser results
+ */
+static void pp2_cls_model_prs_run(struct pp2_cls_model *model, u32 port, struct pp2_cls_model_pkt *pkt,
+				  struct pp2_cls_model_res *res)
+{
+	struct pp2_cls_model_port *port_cfg = &model->port[port];
+	struct mv_pp2x_prs_entry *pe;
+	u32 lu = port_cfg->prs_lu, max_loop, ai_ctrl, ri_ctrl, udf_type;
+	int offs = port_cfg->prs_offs, shift, udf;
+
+	max_loop = port_cfg->prs_max_loop ? port_cfg->prs_max_loop : PP2_CLS_MODEL_MAX_LOOKUPS;
+
+	while (1) {
+		if (res->num_lookups == max_loop) {
+			res->flags |= PP2_CLS_MODEL_F_PRS_LOOP;
+			return;
+		}
+		res->num_lookups++;
+
+		res->prs_tid = pp2_cls_model_prs_match(model, port, lu, res->ai, pkt, offs);
+		if (res->prs_tid < 0) {
+			res->flags |= PP2_CLS_MODEL_F_PRS_MISS;
+			return;
+		}
+		pe = &model->prs[res->prs_tid];
+
+		ri_ctrl = pe->sram.word[MVPP2_PRS_SRAM_RI_CTRL_WORD];
+		res->ri = (res->ri & ~ri_ctrl) | (pe->sram.word[MVPP2_PRS_SRAM_RI_WORD] & ri_ctrl);
+		ai_ctrl = pp2_cls_model_sram_bits_get(pe, MVPP2_PRS_SRAM_AI_CTRL_OFFS, MVPP2_PRS_SRAM_AI_CTRL_BITS);
+		res->ai = (res->ai & ~ai_ctrl) |
+			  (pp2_cls_model_sram_bits_get(pe, MVPP2_PRS_SRAM_AI_OFFS, MVPP2_PRS_AI_BITS) & ai_ctrl);
+
+		/* L3/L4 offsets and the shift are both relative to the current offset */
+		udf_type = pp2_cls_model_sram_bits_get(pe, MVPP2_PRS_SRAM_UDF_TYPE_OFFS, 3);
+		udf = pp2_cls_model_sram_bits_get(pe, MVPP2_PRS_SRAM_UDF_OFFS, MVPP2_PRS_SRAM_UDF_BITS);
+		if (pp2_cls_model_sram_bits_get(pe, MVPP2_PRS_SRAM_UDF_SIGN_BIT, 1))
+			udf = -udf;
+		if (udf_type == MVPP2_PRS_SRAM_UDF_TYPE_L3)
+			res->l3_offs = offs + udf;
+		else if (udf_type == MVPP2_PRS_SRAM_UDF_TYPE_L4)
+			res->l4_offs = offs + udf;
+
+		shift = pp2_cls_model_sram_bits_get(pe, MVPP2_PRS_SRAM_SHIFT_OFFS, MVPP2_PRS_SRAM_SHIFT_BITS);
+		if (pp2_cls_model_sram_bits_get(pe, MVPP2_PRS_SRAM_SHIFT_SIGN_BIT, 1))
+			shift = -shift;
+		offs += shift;
+
+		if (pp2_cls_model_sram_bits_get(pe, MVPP2_PRS_SRAM_LU_DONE_BIT, 1))
+			break;
+		lu = pp2_cls_model_sram_bits_get(pe, MVPP2_PRS_SRAM_NEXT_LU_OFFS, 4);
+	}
+
+	res->lkpid = res->ai & MVPP2_PRS_FLOW_ID_MASK;
+}
+
+/**
+ * pp2_cls_model_field_get
+ *
+ * The routine extracts a classifier field from the packet, an integer field to
+ * value, an address field to bytes
+ *
+ * @retval	0 on success
+ * @retval	-EINVAL for a field the model does not extract
+ */
+static int pp2_cls_model_field_get(struct pp2_cls_model_pkt *pkt, u32 field_id, u32 *value, u8 bytes[])
+{
+	int l2_tag = PP2_MH_SIZE + 2 * ETH_ALEN;
+	int l3 = pkt->l3_offs, l4 = pkt->l4_offs;
+	int eth_type, num_tags;
+	u32 l3_type = pkt->ri & MVPP2_PRS_RI_L3_PROTO_MASK;
+	bool ip6 = (l3_type == MVPP2_PRS_RI_L3_IP6 || l3_type == MVPP2_PRS_RI_L3_IP6_EXT);
+
+	switch (pkt->ri & MVPP2_PRS_RI_VLAN_MASK) {
+	case MVPP2_PRS_RI_VLAN_SINGLE:
+		num_tags = 1;
+		break;
+	case MVPP2_PRS_RI_VLAN_DOUBLE:
+		num_tags = 2;
+		break;
+	case MVPP2_PRS_RI_VLAN_TRIPLE:
+		num_tags = 3;
+		break;
+	default:
+		num_tags = 0;
+	}
+	eth_type = l2_tag + num_tags * MVPP2_VLAN_TAG_LEN;
+
+	switch (field_id) {
+	case MH_FIELD_ID:
+		*value = pp2_cls_model_pkt_bits(pkt, 0, 0, MH_FIELD_SIZE);
+		break;
+	case MAC_DA_FIELD_ID:
+		pp2_cls_model_pkt_bytes(pkt, PP2_MH_SIZE, bytes, ETH_ALEN);
+		break;
+	case MAC_SA_FIELD_ID:
+		pp2_cls_model_pkt_bytes(pkt, PP2_MH_SIZE + ETH_ALEN, bytes, ETH_ALEN);
+		break;
+	case OUT_TPID_FIELD_ID:
+		*value = pp2_cls_model_pkt_bits(pkt, l2_tag, 0, OUT_TPID_FIELD_SIZE);
+		break;
+	case OUT_VLAN_PRI_FIELD_ID:
+		*value = pp2_cls_model_pkt_bits(pkt, l2_tag + MVPP2_ETH_TYPE_LEN, 0, OUT_VLAN_PRI_FIELD_SIZE);
+		break;
+	case OUT_VLAN_CFI_FIELD_ID:
+		*value = pp2_cls_model_pkt_bits(pkt, l2_tag + MVPP2_ETH_TYPE_LEN, MVPP2_CFI_OFFSET_BITS,
+						OUT_VLAN_CFI_FIELD_SIZE);
+		break;
+	case OUT_VLAN_ID_FIELD_ID:
+		*value = pp2_cls_model_pkt_bits(pkt, l2_tag + MVPP2_ETH_TYPE_LEN, MVPP2_CFI_OFFSET_BITS + 1,
+						OUT_VLAN_ID_FIELD_SIZE);
+		break;
+	case IN_TPID_FIELD_ID:
+		*value = pp2_cls_model_pkt_bits(pkt, l2_tag + MVPP2_VLAN_TAG_LEN, 0, IN_TPID_FIELD_SIZE);
+		break;
+	case IN_VLAN_PRI_FIELD_ID:
+		*value = pp2_cls_model_pkt_bits(pkt, l2_tag + MVPP2_VLAN_TAG_LEN + MVPP2_ETH_TYPE_LEN, 0,
+						IN_VLAN_PRI_FIELD_SIZE);
+		break;
+	case IN_VLAN_CFI_FIELD_ID:
+		*value = pp2_cls_model_pkt_bits(pkt, l2_tag + MVPP2_VLAN_TAG_LEN + MVPP2_ETH_TYPE_LEN,
+						MVPP2_CFI_OFFSET_BITS, IN_VLAN_CFI_FIELD_SIZE);
+		break;
+	case IN_VLAN_ID_FIELD_ID:
+		*value = pp2_cls_model_pkt_bits(pkt, l2_tag + MVPP2_VLAN_TAG_LEN + MVPP2_ETH_TYPE_LEN,
+						MVPP2_CFI_OFFSET_BITS + 1, IN_VLAN_ID_FIELD_SIZE);
+		break;
+	case ETH_TYPE_FIELD_ID:
+		*value = pp2_cls_model_pkt_bits(pkt, eth_type, 0, ETH_TYPE_FIELD_SIZE);
+		break;
+	case PPPOE_FIELD_ID:
+		/* session ID, after the version/type and code bytes */
+		*value = pp2_cls_model_pkt_bits(pkt, eth_type + MVPP2_ETH_TYPE_LEN + 2, 0, PPPOE_FIELD_SIZE);
+		break;
+	case PPPOE_PROTO_ID:
+		*value = pp2_cls_model_pkt_bits(pkt, eth_type + MVPP2_ETH_TYPE_LEN + MVPP2_PPPOE_HDR_SIZE - 2, 0,
+						PPPOE_FIELD_SIZE);
+		break;
+	case IP_VER_FIELD_ID:
+		*value = pp2_cls_model_pkt_bits(pkt, l3, 0, IP_VER_FIELD_SIZE);
+		break;
+	case IPV4_DSCP_FIELD_ID:
+		*value = pp2_cls_model_pkt_bits(pkt, l3 + 1, 0, IPV4_DSCP_FIELD_SIZE);
+		break;
+	case IPV4_ECN_FIELD_ID:
+		*value = pp2_cls_model_pkt_bits(pkt, l3 + 1, IPV4_DSCP_FIELD_SIZE, IPV4_ECN_FIELD_SIZE);
+		break;
+	case IPV4_LEN_FIELD_ID:
+		*value = pp2_cls_model_pkt_bits(pkt, l3 + 2, 0, IPV4_LEN_FIELD_SIZE);
+		break;
+	case IPV4_TTL_FIELD_ID:
+		*value = pp2_cls_model_pkt_bits(pkt, ip6 ? l3 + 7 : l3 + 8, 0, IPV4_TTL_FIELD_SIZE);
+		break;
+	case IPV4_PROTO_FIELD_ID:
+		*value = pp2_cls_model_pkt_bits(pkt, ip6 ? l3 + 6 : l3 + 9, 0, IPV4_PROTO_FIELD_SIZE);
+		break;
+	case IPV4_SA_FIELD_ID:
+		pp2_cls_model_pkt_bytes(pkt, l3 + 12, bytes, IPV4_ADDR_SIZE);
+		break;
+	case IPV4_DA_FIELD_ID:
+		pp2_cls_model_pkt_bytes(pkt, l3 + 16, bytes, IPV4_ADDR_SIZE);
+		break;
+	case IPV6_DSCP_FIELD_ID:
+		*value = pp2_cls_model_pkt_bits(pkt, l3, IP_VER_FIELD_SIZE, IPV6_DSCP_FIELD_SIZE);
+		break;
+	case IPV6_ECN_FIELD_ID:
+		*value = pp2_cls_model_pkt_bits(pkt, l3, IP_VER_FIELD_SIZE + IPV6_DSCP_FIELD_SIZE,
+						IPV6_ECN_FIELD_SIZE);
+		break;
+	case IPV6_FLOW_LBL_FIELD_ID:
+		*value = pp2_cls_model_pkt_bits(pkt, l3, 32 - IPV6_FLOW_LBL_FIELD_SIZE, IPV6_FLOW_LBL_FIELD_SIZE);
+		break;
+	case IPV6_PAYLOAD_LEN_FIELD_ID:
+		*value = pp2_cls_model_pkt_bits(pkt, l3 + 4, 0, IPV6_PAYLOAD_LEN_FIELD_SIZE);
+		break;
+	case IPV6_NH_FIELD_ID:
+		*value = pp2_cls_model_pkt_bits(pkt, l3 + 6, 0, IPV6_NH_FIELD_SIZE);
+		break;
+	case IPV6_SA_FIELD_ID:
+	case IPV6_SA_PREF_FIELD_ID:
+	case IPV6_SA_SUFF_FIELD_ID:
+		pp2_cls_model_pkt_bytes(pkt, l3 + 8, bytes, IPV6_ADDR_SIZE);
+		break;
+	case IPV6_DA_FIELD_ID:
+	case IPV6_DA_PREF_FIELD_ID:
+	case IPV6_DA_SUFF_FIELD_ID:
+		pp2_cls_model_pkt_bytes(pkt, l3 + 8 + IPV6_ADDR_SIZE, bytes, IPV6_ADDR_SIZE);
+		break;
+	case L4_SRC_FIELD_ID:
+		*value = pp2_cls_model_pkt_bits(pkt, l4, 0, L4_SRC_FIELD_SIZE);
+		break;
+	case L4_DST_FIELD_ID:
+		*value = pp2_cls_model_pkt_bits(pkt, l4 + 2, 0, L4_DST_FIELD_SIZE);
+		break;
+	case TCP_FLAGS_FIELD_ID:
+		*value = pp2_cls_model_pkt_bits(pkt, l4 + 13, 0, TCP_FLAGS_FIELD_SIZE);
+		break;
+	case ARP_IPV4_DA_FIELD_ID:
+		/* target protocol address */
+		pp2_cls_model_pkt_bytes(pkt, l3 + 24, bytes, IPV4_ADDR_SIZE);
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+/* Store a field on its own byte boundary, as pp2_cls_c3_common_field_hek_get() */
+static void pp2_cls_model_hek_common(u32 value, u32 field_bytes, u32 field_size, u8 hek[], u32 *bytes_used)
+{
+	u32 idx;
+
+	for (idx = 0; idx < field_bytes; idx++) {
+		if (field_size % BYTE_BITS) {
+			if (idx < field_bytes - 1)
+				hek[*bytes_used] = (value >> (BYTE_BITS * (field_bytes - 2 - idx) +
+						    field_size % BYTE_BITS)) & BYTE_MASK;
+			else
+				hek[*bytes_used] = (value << (BYTE_BITS - field_size % BYTE_BITS)) & BYTE_MASK;
+		} else {
+			hek[*bytes_used] = (value >> (BYTE_BITS * (field_bytes - 1 - idx))) & BYTE_MASK;
+		}
+		(*bytes_used)++;
+	}
+}
+
+/* Store a field sharing a byte with the previous one, as pp2_cls_c3_shared_field_hek_get() */
+static void pp2_cls_model_hek_shared(u32 value, u32 field_bytes, u32 field_size, bool comb_flag,
+				     u32 comb_offset, u8 hek[], u32 *bytes_used)
+{
+	u32 idx, left_bits = field_size;
+	bool comb_first = comb_flag, comb_rest = comb_flag;
+
+	for (idx = 0; idx < field_bytes; idx++) {
+		if (!comb_rest) {
+			hek[(*bytes_used)++] = (value >> (BYTE_BITS * (field_bytes - 1 - idx))) & BYTE_MASK;
+		} else if (comb_first) {
+			hek[*bytes_used - 1] |= (value >> (field_size - comb_offset)) & BYTE_MASK;
+			if ((field_size % BYTE_BITS) + comb_offset > BYTE_BITS || field_size > BYTE_BITS)
+				value &= (1 << (field_size - comb_offset)) - 1;
+			left_bits = field_size - comb_offset;
+			comb_first = false;
+		} else {
+			if (left_bits % BYTE_BITS) {
+				if (idx < field_bytes - 1)
+					hek[*bytes_used] = (value >> (BYTE_BITS * (field_bytes - 2 - idx) +
+							    left_bits % BYTE_BITS)) & BYTE_MASK;
+				else
+					hek[*bytes_used] = (value << (BYTE_BITS - left_bits % BYTE_BITS)) & BYTE_MASK;
+			} else {
+				hek[*bytes_used] = (value >> (BYTE_BITS * (field_bytes - 1 - idx))) & BYTE_MASK;
+			}
+			(*bytes_used)++;
+			comb_rest = false;
+		}
+	}
+}
+
+/**
+ * pp2_cls_model_hek_build
+ *
+ * The routine builds the HEK of a flow entry lookup from the packet, with the
+ * field order, byte alignment and bit sharing rules the driver uses to build
+ * the C2 and C3 rule keys
+ *
+ * @param[in]	pkt		packet fields
+ * @param[in]	field_ids	flow entry field IDs
+ * @param[in]	num_fields	number of flow entry fields
+ * @param[in]	max_bytes	engine HEK size
+ * @param[out]	hek		HEK bytes, in field order
+ * @param[out]	size		HEK bytes used
+ *
+ * @retval	0 on success
+ * @retval	-EINVAL for a field the model does not extract or a HEK beyond the engine size
+ */
+static int pp2_cls_model_hek_build(struct pp2_cls_model_pkt *pkt, const u32 field_ids[], u32 num_fields,
+				   u32 max_bytes, u8 hek[], u32 *size)
+{
+	u8 addr[IPV6_ADDR_SIZE];
+	u32 i, idx, field_id, field_size, field_bytes, value = 0, used = 0, pre_field_id = 0, comb_offset;
+	bool comb_flag;
+
+	memset(hek, 0, max_bytes);
+	for (i = 0; i < num_fields; i++) {
+		field_id = field_ids[i];
+		field_size = pp2_cls_field_size_get(field_id);
+		if (field_size % BYTE_BITS)
+			field_bytes = (field_size / BYTE_BITS) + 1;
+		else
+			field_bytes = field_size / BYTE_BITS;
+		if (!field_size || pp2_cls_model_field_get(pkt, field_id, &value, addr))
+			return -EINVAL;
+
+		comb_flag = false;
+		comb_offset = 0;
+		switch (field_id) {
+		case OUT_VLAN_CFI_FIELD_ID:
+		case IN_VLAN_CFI_FIELD_ID:
+			if (used + 1 > max_bytes)
+				return -EINVAL;
+			hek[used++] = value << (BYTE_BITS - 1 - (MVPP2_CFI_OFFSET_BITS % BYTE_BITS));
+			break;
+
+		/* Share bits combination, the checks follow the fallthrough of the driver */
+		case IN_VLAN_ID_FIELD_ID:
+		case OUT_VLAN_ID_FIELD_ID:
+		case IPV4_ECN_FIELD_ID:
+		case IPV6_DSCP_FIELD_ID:
+		case IPV6_ECN_FIELD_ID:
+		case IPV6_FLOW_LBL_FIELD_ID:
+			if ((pre_field_id == OUT_VLAN_PRI_FIELD_ID && field_id == OUT_VLAN_ID_FIELD_ID) ||
+			    (pre_field_id == IN_VLAN_PRI_FIELD_ID && field_id == IN_VLAN_ID_FIELD_ID)) {
+				comb_flag = true;
+				comb_offset = 4;
+			}
+			if (pre_field_id == IPV4_DSCP_FIELD_ID && field_id == IPV4_ECN_FIELD_ID) {
+				comb_flag = true;
+				comb_offset = 2;
+			}
+			if (field_id != IPV6_ECN_FIELD_ID && field_id != IPV6_FLOW_LBL_FIELD_ID &&
+			    (pre_field_id == IP_VER_FIELD_ID || field_id == IPV6_DSCP_FIELD_ID)) {
+				comb_flag = true;
+				comb_offset = 4;
+				if (pre_field_id != IP_VER_FIELD_ID)
+					used++;
+			}
+			if (pre_field_id == IPV6_DSCP_FIELD_ID && field_id == IPV6_ECN_FIELD_ID) {
+				comb_flag = true;
+				comb_offset = 2;
+			}
+			if (field_id == IPV6_FLOW_LBL_FIELD_ID &&
+			    (pre_field_id == IPV6_DSCP_FIELD_ID || pre_field_id == IPV6_ECN_FIELD_ID)) {
+				comb_flag = true;
+				comb_offset = 4;
+			}
+			if (comb_flag && field_size < BYTE_BITS && field_size + comb_offset > BYTE_BITS)
+				field_bytes++;
+			if (used > max_bytes || field_bytes > max_bytes - used)
+				return -EINVAL;
+			pp2_cls_model_hek_shared(value, field_bytes, field_size, comb_flag, comb_offset, hek, &used);
+			break;
+
+		case MAC_DA_FIELD_ID:
+		case MAC_SA_FIELD_ID:
+		case IPV4_SA_FIELD_ID:
+		case IPV4_DA_FIELD_ID:
+		case ARP_IPV4_DA_FIELD_ID:
+		case IPV6_SA_FIELD_ID:
+		case IPV6_DA_FIELD_ID:
+		case IPV6_SA_PREF_FIELD_ID:
+		case IPV6_DA_PREF_FIELD_ID:
+			if (field_bytes > max_bytes - used)
+				return -EINVAL;
+			for (idx = 0; idx < field_bytes; idx++)
+				hek[used++] = addr[idx];
+			break;
+
+		case IPV6_SA_SUFF_FIELD_ID:
+		case IPV6_DA_SUFF_FIELD_ID:
+			if (IPV6_ADDR_SIZE - field_bytes > max_bytes - used)
+				return -EINVAL;
+			for (idx = field_bytes; idx < IPV6_ADDR_SIZE; idx++)
+				hek[used++] = addr[idx];
+			break;
+
+		default:
+			if (field_bytes > max_bytes - used)
+				return -EINVAL;
+			pp2_cls_model_hek_common(value, field_bytes, field_size, hek, &used);
+		}
+		pre_field_id = field_id;
+	}
+	*size = used;
+
+	return 0;
+}
+
+/* Decode the actions of a C2 entry */
+static void pp2_cls_model_c2_act_get(struct mv_pp2x_cls_c2_entry *c2, struct pp2_cls_model_act *act)
+{
+	u32 actions = c2->sram.regs.actions;
+
+	act->color_act = (actions & MVPP2_CLS2_ACT_COLOR_MASK) >> MVPP2_CLS2_ACT_COLOR_OFF;
+	act->ql_act = (actions & MVPP2_CLS2_ACT_QL_MASK) >> MVPP2_CLS2_ACT_QL_OFF;
+	act->qh_act = (actions & MVPP2_CLS2_ACT_QH_MASK) >> MVPP2_CLS2_ACT_QH_OFF;
+	act->rss_act = (actions & MVPP2_CLS2_ACT_RSS_MASK) >> MVPP2_CLS2_ACT_RSS_OFF;
+	act->fid_en = !!(actions & MVPP2_CLS2_ACT_FLD_EN_MASK);
+	act->ql = (c2->sram.regs.qos_attr & MVPP2_CLS2_ACT_QOS_ATTR_QL_MASK) >> MVPP2_CLS2_ACT_QOS_ATTR_QL_OFF;
+	act->qh = (c2->sram.regs.qos_attr & MVPP2_CLS2_ACT_QOS_ATTR_QH_MASK) >> MVPP2_CLS2_ACT_QOS_ATTR_QH_OFF;
+	act->flow_id = (((c2->sram.regs.hwf_attr & MVPP2_CLS2_ACT_HWF_ATTR_DPTR_MASK) >>
+			 MVPP2_CLS2_ACT_HWF_ATTR_DPTR_OFF) << MVPP2_CLS_FLOW_ID_HI_SHIFT) |
+		       ((c2->sram.regs.hwf_attr & MVPP2_CLS2_ACT_HWF_ATTR_IPTR_MASK) >>
+			MVPP2_CLS2_ACT_HWF_ATTR_IPTR_OFF);
+	act->rss_en = !!(c2->sram.regs.rss_attr & MVPP2_CLS2_ACT_DUP_ATTR_RSSEN_MASK);
+	act->qos_tbl = c2->sram.regs.action_tbl & (MVPP2_CLS2_ACT_DATA_TBL_LOW_Q_MASK |
+						    MVPP2_CLS2_ACT_DATA_TBL_HIGH_Q_MASK |
+						    MVPP2_CLS2_ACT_DATA_TBL_COLOR_MASK);
+}
+
+/* Decode the actions of a C3 entry */
+static void pp2_cls_model_c3_act_get(struct pp2_cls_c3_entry *c3, struct pp2_cls_model_act *act)
+{
+	u32 actions = c3->sram.regs.actions;
+
+	act->qos_tbl = 0;
+	act->color_act = (actions & MVPP2_CLS3_ACT_COLOR_MASK) >> MVPP2_CLS3_ACT_COLOR;
+	act->ql_act = (actions & MVPP2_CLS3_ACT_LOW_Q_MASK) >> MVPP2_CLS3_ACT_LOW_Q;
+	act->qh_act = (actions & MVPP2_CLS3_ACT_HIGH_Q_MASK) >> MVPP2_CLS3_ACT_HIGH_Q;
+	act->rss_act = (actions & MVPP2_CLS3_ACT_RSS_EN_MASK) >> MVPP2_CLS3_ACT_RSS_EN;
+	act->fid_en = !!(actions & MVPP2_CLS3_ACT_FLOW_ID_EN_MASK);
+	act->ql = (c3->sram.regs.qos_attr & MVPP2_CLS3_ACT_QOS_ATTR_LOW_Q_MASK) >> MVPP2_CLS3_ACT_QOS_ATTR_LOW_Q;
+	act->qh = (c3->sram.regs.qos_attr & MVPP2_CLS3_ACT_QOS_ATTR_HIGH_Q_MASK) >> MVPP2_CLS3_ACT_QOS_ATTR_HIGH_Q;
+	act->flow_id = (((c3->sram.regs.hwf_attr & MVPP2_CLS3_ACT_HWF_ATTR_DPTR_MASK) >>
+			 MVPP2_CLS3_ACT_HWF_ATTR_DPTR) << MVPP2_CLS_FLOW_ID_HI_SHIFT) |
+		       ((c3->sram.regs.hwf_attr & MVPP2_CLS3_ACT_HWF_ATTR_IPTR_MASK) >>
+			MVPP2_CLS3_ACT_HWF_ATTR_IPTR);
+	act->rss_en = !!(c3->sram.regs.dup_attr & MVPP2_CLS3_ACT_DUP_RSS_EN_MASK);
+}
+
+/* Apply an update/lock action on a result field */
+static void pp2_cls_model_gen_act_apply(u32 act, u32 val, bool *lock, u32 *field)
+{
+	if (*lock)
+		return;
+	if (act == MVPP2_ACTION_TYPE_UPDT || act == MVPP2_ACTION_TYPE_UPDT_LOCK)
+		*field = val;
+	if (act == MVPP2_ACTION_TYPE_NO_UPDT_LOCK || act == MVPP2_ACTION_TYPE_UPDT_LOCK)
+		*lock = true;
+}
+
+static void pp2_cls_model_act_apply(struct pp2_cls_model_act *act, struct pp2_cls_model_lock *lock,
+				    struct pp2_cls_model_res *res)
+{
+	u32 ql = res->queue & ((1 << MVPP2_CLS2_ACT_QOS_ATTR_QL_BITS) - 1);
+	u32 qh = res->queue >> MVPP2_CLS2_ACT_QOS_ATTR_QL_BITS;
+	u32 rss_en = !!(res->flags & PP2_CLS_MODEL_F_RSS);
+
+	if (act->qos_tbl && (act->ql_act >= MVPP2_ACTION_TYPE_UPDT || act->qh_act >= MVPP2_ACTION_TYPE_UPDT ||
+			     act->color_act >= MVPP2_COLOR_ACTION_TYPE_GREEN))
+		res->flags |= PP2_CLS_MODEL_F_QOS_TBL;
+
+	/* colors are ordered none/green/yellow/red, each followed by its lock variant */
+	if (!lock->color) {
+		if (act->color_act >= MVPP2_COLOR_ACTION_TYPE_GREEN)
+			res->color = act->color_act >> 1;
+		lock->color = act->color_act & 1;
+	}
+	pp2_cls_model_gen_act_apply(act->ql_act, act->ql, &lock->ql, &ql);
+	pp2_cls_model_gen_act_apply(act->qh_act, act->qh, &lock->qh, &qh);
+	res->queue = (qh << MVPP2_CLS2_ACT_QOS_ATTR_QL_BITS) | ql;
+
+	pp2_cls_model_gen_act_apply(act->rss_act, act->rss_en, &lock->rss, &rss_en);
+	if (rss_en)
+		res->flags |= PP2_CLS_MODEL_F_RSS;
+	else
+		res->flags &= ~PP2_CLS_MODEL_F_RSS;
+
+	if (act->fid_en) {
+		res->flow_id = act->flow_id;
+		res->flags |= PP2_CLS_MODEL_F_FLOW_ID;
+	}
+}
+
+/**
+ * pp2_cls_model_c2_lookup
+ *
+ * The routine gets the first C2 TCAM entry matching the HEK, lookup type and port
+ *
+ * @retval	C2 TCAM index, -1 on miss
+ */
+static int pp2_cls_model_c2_lookup(struct pp2_cls_model *model, const u8 hek[], u32 lkp_type,
+				   u32 port_type, u32 port_id)
+{
+	u8 key[MVPP2_CLS_C2_TCAM_DATA_BYTES];
+	struct mv_pp2x_cls_c2_entry *c2;
+	int i, idx;
+
+	for (i = 0; i < MVPP2_C2_HEK_OFF_LKP_PORT_TYPE; i++)
+		key[MVPP2_C2_HEK_OFF_BYTE7 - i] = hek[i];
+	key[MVPP2_C2_HEK_OFF_LKP_PORT_TYPE] = (port_type << MVPP2_C2_HEK_PORT_TYPE_OFFS) |
+					      (lkp_type << MVPP2_C2_HEK_LKP_TYPE_OFFS);
+	key[MVPP2_C2_HEK_OFF_PORT_ID] = port_id;
+
+	for (idx = 0; idx < MVPP2_CLS_C2_TCAM_SIZE; idx++) {
+		c2 = &model->c2[idx];
+		if (c2->inv)
+			continue;
+		for (i = 0; i < MVPP2_CLS_C2_TCAM_DATA_BYTES; i++)
+			if ((key[i] ^ c2->tcam.bytes[TCAM_DATA_BYTE(i)]) & c2->tcam.bytes[TCAM_DATA_MASK(i)])
+				break;
+		if (i == MVPP2_CLS_C2_TCAM_DATA_BYTES)
+			return idx;
+	}
+
+	return -1;
+}
+
+/**
+ * pp2_cls_model_c3_lookup
+ *
+ * The routine searches the C3 multihash entries for the key. The multihash
+ * functions are not modeled, so the entries are compared one by one.
+ *
+ * @retval	multihash index, -1 on miss
+ */
+static int pp2_cls_model_c3_lookup(struct pp2_cls_model *model, struct pp2_cls_model_pkt *pkt,
+				   const u8 hek[], u32 hek_size, u32 lkp_type, u32 port_type, u32 port_id)
+{
+	struct pp2_cls_c3_entry key, *c3;
+	u32 key_ctrl, l4_type = 0, l4_ri = pkt->ri & MVPP2_PRS_RI_L4_PROTO_MASK;
+	u32 i;
+	int idx;
+
+	memset(&key, 0, sizeof(key));
+	for (i = 0; i < hek_size; i++)
+		key.key.hek.bytes[HW_BYTE_OFFS(MVPP2_C3_MAX_HASH_KEY_SIZE - 1 - i)] = hek[i];
+	key_ctrl = (lkp_type << KEY_CTRL_LKP_TYPE) | (port_type << KEY_CTRL_PRT_ID_TYPE) |
+		   (port_id << KEY_CTRL_PRT_ID) | (hek_size << KEY_CTRL_HEK_SIZE);
+	if (l4_ri == MVPP2_PRS_RI_L4_TCP)
+		l4_type = MVPP2_L4_TYPE_TCP;
+	else if (l4_ri == MVPP2_PRS_RI_L4_UDP)
+		l4_type = MVPP2_L4_TYPE_UDP;
+
+	for (idx = 0; idx < MVPP2_CLS_C3_HASH_TBL_SIZE; idx++) {
+		c3 = &model->c3[idx];
+		if (!(c3->key.key_ctrl & KEY_CTRL_HEK_SIZE_MASK))
+			continue;
+		if ((c3->key.key_ctrl & ~KEY_CTRL_L4_MASK) != key_ctrl)
+			continue;
+		/* the driver sets the L4 info on 5-tuple keys only */
+		if ((c3->key.key_ctrl & KEY_CTRL_L4_MASK) &&
+		    ((c3->key.key_ctrl & KEY_CTRL_L4_MASK) >> KEY_CTRL_L4) != l4_type)
+			continue;
+		if (!memcmp(c3->key.hek.bytes, key.key.hek.bytes, sizeof(key.key.hek.bytes)))
+			return idx;
+	}
+
+	return -1;
+}
+
+/**
+ * pp2_cls_model_flows_run
+ *
+ * The routine runs the flow entries of a lookup, from the first flow entry to
+ * the last one, and applies the actions of the engine lookups
+ */
+static void pp2_cls_model_flows_run(struct pp2_cls_model *model, u32 port, struct pp2_cls_model_pkt *pkt,
+				    u32 flow_idx, struct pp2_cls_model_res *res)
+{
+	struct mv_pp2x_cls_flow_entry *fe;
+	struct pp2_cls_model_lock lock;
+	struct pp2_cls_model_act act;
+	u32 field_ids[MVPP2_FLOW_FIELDS_NUM_MAX];
+	u8 hek[MVPP2_C3_MAX_HASH_KEY_SIZE];
+	u32 engine, lkp_type, port_type, port_id, num_fields, seq_ctrl, udf7, hek_size, i;
+	bool seq_skip = false;
+	int idx;
+
+	memset(&lock, 0, sizeof(lock));
+	udf7 = (pkt->ri & MVPP2_PRS_RI_UDF7_MASK) >> 29;
+
+	for (; flow_idx < MVPP2_CLS_FLOWS_TBL_SIZE; flow_idx++) {
+		fe = &model->flow[flow_idx];
+		engine = (fe->data[0] & MVPP2_FLOW_ENGINE_MASK) >> MVPP2_FLOW_ENGINE;
+		port_type = (fe->data[0] & MVPP2_FLOW_PORT_TYPE_MASK) >> MVPP2_FLOW_PORT_TYPE;
+		port_id = (fe->data[0] & MVPP2_FLOW_PORT_ID_MASK) >> MVPP2_FLOW_PORT_ID;
+		lkp_type = (fe->data[1] & MVPP2_FLOW_LKP_TYPE_MASK) >> MVPP2_FLOW_LKP_TYPE;
+		num_fields = (fe->data[1] & MVPP2_FLOW_FIELDS_NUM_MASK) >> MVPP2_FLOW_FIELDS_NUM;
+		seq_ctrl = (fe->data[1] & MVPP2_FLOW_SEQ_CTRL_MASK) >> MVPP2_FLOW_SEQ_CTRL;
+
+		/* A physical port flow entry applies to the ports of its bitmap */
+		if (port_type == MVPP2_SRC_PORT_TYPE_PHY && !(port_id & BIT(port)))
+			goto next;
+		if ((fe->data[0] & MVPP2_FLOW_UDF7_MASK) &&
+		    ((fe->data[0] & MVPP2_FLOW_UDF7_MASK) >> MVPP2_FLOW_UDF7) != udf7)
+			goto next;
+		if (!(fe->data[0] & MVPP2_FLOW_PORT_ID_SEL_MASK))
+			port_id = (port_type == MVPP2_SRC_PORT_TYPE_PHY) ? BIT(port) : port;
+
+		if (seq_ctrl == MVPP2_CLS_SEQ_CTRL_FIRST_TYPE_1 || seq_ctrl == MVPP2_CLS_SEQ_CTRL_FIRST_TYPE_2)
+			seq_skip = false;
+		else if (seq_ctrl == MVPP2_CLS_SEQ_CTRL_MIDDLE || seq_ctrl == MVPP2_CLS_SEQ_CTRL_LAST)
+			if (seq_skip)
+				goto next;
+
+		if (num_fields > MVPP2_FLOW_FIELDS_NUM_MAX)
+			num_fields = MVPP2_FLOW_FIELDS_NUM_MAX;
+		for (i = 0; i < num_fields; i++)
+			field_ids[i] = (fe->data[2] & MVPP2_FLOW_FIELD_MASK(i)) >> MVPP2_FLOW_FIELD_ID(i);
+
+		switch (engine) {
+		case MVPP2_CLS_ENGINE_C2:
+			res->num_engines++;
+			if (pp2_cls_model_hek_build(pkt, field_ids, num_fields, MVPP2_C2_HEK_OFF_LKP_PORT_TYPE,
+						    hek, &hek_size)) {
+				res->flags |= PP2_CLS_MODEL_F_UNSUPP;
+				break;
+			}
+			idx = pp2_cls_model_c2_lookup(model, hek, lkp_type, port_type, port_id);
+			if (idx < 0) {
+				/* a C2 miss ends the sequence */
+				seq_skip = true;
+				break;
+			}
+			res->c2_idx = idx;
+			pp2_cls_model_c2_act_get(&model->c2[idx], &act);
+			pp2_cls_model_act_apply(&act, &lock, res);
+			if (model->c2[idx].sram.regs.seq_attr & MVPP22_CLS2_ACT_SEQ_ATTR_MISS_MASK)
+				seq_skip = true;
+			break;
+		case MVPP2_CLS_ENGINE_C3A:
+		case MVPP2_CLS_ENGINE_C3B:
+		case MVPP2_CLS_ENGINE_C3HA:
+		case MVPP2_CLS_ENGINE_C3HB:
+			res->num_engines++;
+			if (pp2_cls_model_hek_build(pkt, field_ids, num_fields, MVPP2_C3_MAX_HASH_KEY_SIZE,
+						    hek, &hek_size)) {
+				res->flags |= PP2_CLS_MODEL_F_UNSUPP;
+				break;
+			}
+			idx = pp2_cls_model_c3_lookup(model, pkt, hek, hek_size, lkp_type, port_type, port_id);
+			if (idx < 0) {
+				pp2_cls_model_c3_act_get(&model->c3_miss[lkp_type], &act);
+			} else {
+				res->c3_idx = idx;
+				pp2_cls_model_c3_act_get(&model->c3[idx], &act);
+			}
+			pp2_cls_model_act_apply(&act, &lock, res);
+			break;
+		default:
+			res->flags |= PP2_CLS_MODEL_F_UNSUPP;
+		}
+next:
+		if (fe->data[0] & MVPP2_FLOW_LAST_MASK)
+			break;
+	}
+}
+
+/**
+ * pp2_cls_model_run
+ *
+ * The routine runs a packet through the parser, the lookup decode table and
+ * the flow entries of its lookup, as received on a port
+ *
+ * @param[in]	model	model images
+ * @param[in]	port	physical port of the parser port map
+ * @param[in]	pkt	packet, starting with the 2 bytes marvell header
+ * @param[in]	len	packet length
+ * @param[out]	res	result
+ *
+ * @retval	0 on success
+ * @retval	error-code otherwise
+ */
+int pp2_cls_model_run(struct pp2_cls_model *model, u32 port, const u8 *pkt, u32 len,
+		      struct pp2_cls_model_res *res)
+{
+	struct mv_pp2x_cls_lookup_entry *lkp;
+	struct pp2_cls_model_pkt model_pkt;
+
+	if (port >= PP2_CLS_MODEL_PORTS) {
+		pr_err("%s: invalid port %d\n", __func__, port);
+		return -EINVAL;
+	}
+
+	memset(res, 0, sizeof(*res));
+	res->prs_tid = -1;
+	res->c2_idx = -1;
+	res->c3_idx = -1;
+	res->l3_offs = -1;
+	res->l4_offs = -1;
+
+	model_pkt.data = pkt;
+	model_pkt.len = len;
+	pp2_cls_model_prs_run(model, port, &model_pkt, res);
+	if (res->ri & MVPP2_PRS_RI_DROP_MASK)
+		res->flags |= PP2_CLS_MODEL_F_DROP;
+	if (res->flags & (PP2_CLS_MODEL_F_PRS_MISS | PP2_CLS_MODEL_F_PRS_LOOP))
+		return 0;
+
+	model_pkt.ri = res->ri;
+	model_pkt.l3_offs = res->l3_offs;
+	model_pkt.l4_offs = res->l4_offs;
+
+	lkp = &model->lkp[res->lkpid][model->port[port].lkp_way];
+	res->queue = (lkp->data & MVPP2_FLOWID_RXQ_MASK) >> MVPP2_FLOWID_RXQ;
+	if (!(lkp->data & MVPP2_FLOWID_EN_MASK)) {
+		res->flags |= PP2_CLS_MODEL_F_LKP_DIS;
+		return 0;
+	}
+
+	pp2_cls_model_flows_run(model, port, &model_pkt,
+				(lkp->data & MVPP2_FLOWID_FLOW_MASK) >> MVPP2_FLOWID_FLOW, res);
+	if (res->color == PP2_CLS_MODEL_COLOR_RED)
+		res->flags |= PP2_CLS_MODEL_F_DROP;
+
+	return 0;
+}
+
+/**
+ * pp2_cls_model_save
+ *
+ * The routine writes the model images to a file
+ *
+ * @retval	0 on success
+ * @retval	error-code otherwise
+ */
+int pp2_cls_model_save(struct pp2_cls_model *model, const char *path)
+{
+	FILE *f;
+	size_t n;
+
+	f = fopen(path, "wb");
+	if (!f) {
+		pr_err("%s: can not open %s\n", __func__, path);
+		return -EIO;
+	}
+	n = fwrite(model, sizeof(*model), 1, f);
+	fclose(f);
+	if (n != 1) {
+		pr_err("%s: failed to write %s\n", __func__, path);
+		return -EIO;
+	}
+
+	return 0;
+}
+
+/**
+ * pp2_cls_model_load
+ *
+ * The routine reads model images written by pp2_cls_model_save()
+ *
+ * @retval	0 on success
+ * @retval	error-code otherwise
+ */
+int pp2_cls_model_load(struct pp2_cls_model *model, const char *path)
+{
+	FILE *f;
+	size_t n;
+
+	f = fopen(path, "rb");
+	if (!f) {
+		pr_err("%s: can not open %s\n", __func__, path);
+		return -EIO;
+	}
+	n = fread(model, sizeof(*model), 1, f);
+	fclose(f);
+	if (n != 1 || model->magic != PP2_CLS_MODEL_MAGIC || model->version != PP2_CLS_MODEL_VERSION) {
+		pr_err("%s: %s is not a classifier model file of this version\n", __func__, path);
+		return -EINVAL;
+	}
+
+	return 0;
+}
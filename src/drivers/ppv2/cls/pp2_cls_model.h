@@ -0,0 +1,118 @@
+/******************************************************************************
+ *	Copyright (C) 2016 Marvell International Ltd.
+ *
+ *  If you received this File from Marvell, you may opt to use, redistribute
+ *  and/or modify this File under the following licensing terms.
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *	* Redistributions of source code must retain the above copyright
+ *	  notice, this list of conditions and the following disclaimer.
+ *
+ *	* Redistributions in binary form must reproduce the above copyright
+ *	  notice, this list of conditions and the following disclaimer in the
+ *	  documentation and/or other materials provided with the distribution.
+ *
+ *	* Neither the name of Marvell nor the names of its contributors may be
+ *	  used to endorse or promote products derived from this software
+ *	  without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+/**
+ * @file pp2_cls_model.h
+ *
+ * Software model of the parser and classifier (PRS, lookup decode, flow
+ * table, C2 and C3)
+ */
+
+/***********************/
+/* h file declarations */
+/***********************/
+#ifndef _PP2_CLS_MODEL_H_
+#define _PP2_CLS_MODEL_H_
+
+/******************************************************************************/
+/*                                 MACROS                                     */
+/******************************************************************************/
+#define PP2_CLS_MODEL_MAGIC		0x32707063 /* "cpp2" */
+#define PP2_CLS_MODEL_VERSION		1
+#define PP2_CLS_MODEL_PORTS		MVPP2_MAX_PORTS
+#define PP2_CLS_MODEL_LKP_WAYS		2
+#define PP2_CLS_MODEL_MAX_LOOKUPS	32	/* parser lookups when the port max loop is not set */
+
+/* Result flags */
+#define PP2_CLS_MODEL_F_DROP		BIT(0)	/* packet dropped, by the parser or a red color */
+#define PP2_CLS_MODEL_F_PRS_MISS	BIT(1)	/* no parser TCAM entry matched */
+#define PP2_CLS_MODEL_F_PRS_LOOP	BIT(2)	/* parser max loop reached before lookup done */
+#define PP2_CLS_MODEL_F_LKP_DIS		BIT(3)	/* lookup decode entry disabled, no classification */
+#define PP2_CLS_MODEL_F_FLOW_ID		BIT(4)	/* flow_id valid */
+#define PP2_CLS_MODEL_F_QOS_TBL		BIT(5)	/* a queue/color came from a QoS table, not modeled */
+#define PP2_CLS_MODEL_F_RSS		BIT(6)	/* RSS enabled by an engine, hash not modeled */
+#define PP2_CLS_MODEL_F_UNSUPP		BIT(7)	/* a flow entry used an engine or field the model lacks */
+
+/******************************************************************************/
+/*                               STRUCTURES                                   */
+/******************************************************************************/
+/* Per port parser and classifier configuration */
+struct pp2_cls_model_port {
+	u8	prs_lu;		/* first parser lookup ID */
+	u8	prs_offs;	/* first parser offset */
+	u8	prs_max_loop;	/* max parser lookups, 0: PP2_CLS_MODEL_MAX_LOOKUPS */
+	u8	lkp_way;	/* lookup decode table way */
+};
+
+/* Images of the parser and classifier tables, as read from or written to HW */
+struct pp2_cls_model {
+	u32				magic;
+	u32				version;
+	struct pp2_cls_model_port	port[PP2_CLS_MODEL_PORTS];
+	struct mv_pp2x_prs_entry	prs[MVPP2_PRS_TCAM_SRAM_SIZE];
+	struct mv_pp2x_cls_lookup_entry	lkp[MVPP2_CLS_LKP_TBL_SIZE][PP2_CLS_MODEL_LKP_WAYS];
+	struct mv_pp2x_cls_flow_entry	flow[MVPP2_CLS_FLOWS_TBL_SIZE];
+	struct mv_pp2x_cls_c2_entry	c2[MVPP2_CLS_C2_TCAM_SIZE];
+	struct pp2_cls_c3_entry		c3[MVPP2_CLS_C3_HASH_TBL_SIZE];
+	struct pp2_cls_c3_entry		c3_miss[MVPP2_CLS_C3_MISS_TBL_SIZE];
+};
+
+/* Result of a packet run through the model */
+struct pp2_cls_model_res {
+	u32	flags;		/* PP2_CLS_MODEL_F_* */
+	u32	ri;		/* parser result info */
+	u8	ai;		/* parser additional info */
+	u8	lkpid;		/* parser flow ID, lookup decode index */
+	u8	num_lookups;	/* parser lookups done */
+	u8	color;		/* 0: none, 1: green, 2: yellow, 3: red */
+	int	prs_tid;	/* last parser TCAM entry, -1 on miss */
+	int	l3_offs;	/* from the packet start including MH, -1 when not set */
+	int	l4_offs;
+	u16	queue;		/* physical RX queue */
+	u16	flow_id;
+	int	c2_idx;		/* last C2 TCAM hit, -1 when none */
+	int	c3_idx;		/* last C3 multihash hit, -1 when none */
+	u32	num_engines;	/* flow entries that ran a lookup */
+};
+
+/******************************************************************************/
+/*                                PROTOTYPE                                   */
+/******************************************************************************/
+void pp2_cls_model_init(struct pp2_cls_model *model);
+int pp2_cls_model_run(struct pp2_cls_model *model, u32 port, const u8 *pkt, u32 len,
+		      struct pp2_cls_model_res *res);
+int pp2_cls_model_save(struct pp2_cls_model *model, const char *path);
+int pp2_cls_model_load(struct pp2_cls_model *model, const char *path);
+int pp2_cls_model_snapshot(struct pp2_inst *inst, struct pp2_cls_model *model);
+int pp2_cls_cli_model_run(void *arg, int argc, char *argv[]);
+
+#endif /* _PP2_CLS_MODEL_H_ */
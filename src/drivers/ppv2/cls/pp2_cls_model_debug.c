@@ -0,0 +1,235 @@
+/******************************************************************************
+ *	Copyright (C) 2016 Marvell International Ltd.
+ *
+ *  If you received this File from Marvell, you may opt to use, redistribute
+ *  and/or modify this File under the following licensing terms.
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *	* Redistributions of source code must retain the above copyright
+ *	  notice, this list of conditions and the following disclaimer.
+ *
+ *	* Redistributions in binary form must reproduce the above copyright
+ *	  notice, this list of conditions and the following disclaimer in the
+ *	  documentation and/or other materials provided with the distribution.
+ *
+ *	* Neither the name of Marvell nor the names of its contributors may be
+ *	  used to endorse or promote products derived from this software
+ *	  without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+
+/**
+ * @file pp2_cls_model_debug.c
+ *
+ * Snapshot of the parser and classifier HW tables into the software model,
+ * and the model CLI
+ */
+
+/***********************/
+/* c file declarations */
+/***********************/
+#include "std_internal.h"
+
+#include "../pp2_types.h"
+#include "../pp2.h"
+#include "../pp2_hw_type.h"
+#include "../pp2_hw_cls.h"
+#include "pp2_prs.h"
+#include "pp2_cls_model.h"
+
+#define PP2_CLS_MODEL_CLI_PKT_MAX	512
+
+/**
+ * pp2_cls_model_snapshot
+ *
+ * The routine reads the parser and classifier tables and the per port
+ * configuration from HW into the model images
+ *
+ * @param[in]	inst	packet processor instance
+ * @param[out]	model	model images
+ *
+ * @retval	0 on success
+ * @retval	error-code otherwise
+ */
+int pp2_cls_model_snapshot(struct pp2_inst *inst, struct pp2_cls_model *model)
+{
+	uintptr_t cpu_slot = pp2_default_cpu_slot(inst);
+	u32 reg_val, way_val;
+	int i, way, rc;
+
+	pp2_cls_model_init(model);
+
+	way_val = pp2_reg_read(cpu_slot, MVPP2_CLS_PORT_WAY_REG);
+	for (i = 0; i < PP2_CLS_MODEL_PORTS; i++) {
+		reg_val = pp2_reg_read(cpu_slot, MVPP2_PRS_INIT_LOOKUP_REG);
+		model->port[i].prs_lu = (reg_val >> (i * 4)) & MVPP2_PRS_PORT_LU_MAX;
+		reg_val = pp2_reg_read(cpu_slot, MVPP2_PRS_INIT_OFFS_REG(i));
+		model->port[i].prs_offs = (reg_val & MVPP2_PRS_INIT_OFF_MASK(i)) >> ((i % 4) * 8);
+		reg_val = pp2_reg_read(cpu_slot, MVPP2_PRS_MAX_LOOP_REG(i));
+		model->port[i].prs_max_loop = (reg_val & MVPP2_PRS_MAX_LOOP_MASK(i)) >> ((i % 4) * 8);
+		model->port[i].lkp_way = (way_val >> i) & 1;
+	}
+
+	for (i = 0; i < MVPP2_PRS_TCAM_SRAM_SIZE; i++) {
+		model->prs[i].index = i;
+		/* an invalid entry keeps its invalid bit, the rest is not read */
+		rc = mv_pp2x_prs_hw_read(cpu_slot, &model->prs[i]);
+		if (rc < 0)
+			return rc;
+	}
+
+	for (i = 0; i < MVPP2_CLS_LKP_TBL_SIZE; i++)
+		for (way = 0; way < PP2_CLS_MODEL_LKP_WAYS; way++) {
+			rc = mv_pp2x_cls_hw_lkp_read(cpu_slot, i, way, &model->lkp[i][way]);
+			if (rc)
+				return -EIO;
+		}
+
+	for (i = 0; i < MVPP2_CLS_FLOWS_TBL_SIZE; i++) {
+		rc = mv_pp2x_cls_hw_flow_read(cpu_slot, i, &model->flow[i]);
+		if (rc)
+			return -EIO;
+	}
+
+	for (i = 0; i < MVPP2_CLS_C2_TCAM_SIZE; i++) {
+		rc = mv_pp2x_cls_c2_hw_read(cpu_slot, i, &model->c2[i]);
+		if (rc)
+			return -EIO;
+	}
+
+	for (i = 0; i < MVPP2_CLS_C3_HASH_TBL_SIZE; i++) {
+		rc = pp2_cls_c3_hw_read(cpu_slot, &model->c3[i], i);
+		if (rc)
+			return rc;
+	}
+	for (i = 0; i < MVPP2_CLS_C3_MISS_TBL_SIZE; i++) {
+		rc = pp2_cls_c3_hw_miss_read(cpu_slot, &model->c3_miss[i], i);
+		if (rc)
+			return rc;
+	}
+
+	return 0;
+}
+
+/* Convert a hex string to bytes, returns the number of bytes or -1 */
+static int pp2_cls_model_hex_parse(const char *str, u8 *buf, int max)
+{
+	char byte_str[3] = {0};
+	char *ret_ptr;
+	int len = 0;
+
+	if (!strncmp(str, "0x", 2))
+		str += 2;
+	while (str[0] && str[1]) {
+		if (len == max)
+			return -1;
+		byte_str[0] = str[0];
+		byte_str[1] = str[1];
+		buf[len++] = strtoul(byte_str, &ret_ptr, 16);
+		if (ret_ptr != &byte_str[2])
+			return -1;
+		str += 2;
+	}
+
+	return str[0] ? -1 : len;
+}
+
+/*******************************************************************************
+ * pp2_cls_cli_model_run
+ *
+ * DESCRIPTION:
+ *           This function runs a packet through the software model of the
+ *           parser and classifier. The model is a snapshot of the HW tables,
+ *           or a model file saved before. No HW entry is written.
+ * INPUTS:
+ *       buf     - Shell parameters as char buffer
+ ******************************************************************************/
+int pp2_cls_cli_model_run(void *arg, int argc, char *argv[])
+{
+	static const char * const color_str[] = {"none", "green", "yellow", "red"};
+	struct pp2_inst *inst = (struct pp2_inst *)arg;
+	struct pp2_cls_model *model;
+	struct pp2_cls_model_res res;
+	u8 pkt[PP2_MH_SIZE + PP2_CLS_MODEL_CLI_PKT_MAX];
+	char *ret_ptr, *file = NULL;
+	bool load = false;
+	u32 port;
+	int len, rc;
+
+	if (argc != 3 && argc != 5) {
+		pr_err("Invalid number of arguments for %s command! number of arguments = %d\n", __func__, argc);
+		return -EINVAL;
+	}
+	port = strtoul(argv[1], &ret_ptr, 0);
+	if (argv[1] == ret_ptr || port >= PP2_CLS_MODEL_PORTS) {
+		printf("parsing fail, wrong input for argv[1] - port\n");
+		return -EINVAL;
+	}
+	/* the packet is an ethernet frame, a zero marvell header is added */
+	memset(pkt, 0, PP2_MH_SIZE);
+	len = pp2_cls_model_hex_parse(argv[2], &pkt[PP2_MH_SIZE], PP2_CLS_MODEL_CLI_PKT_MAX);
+	if (len <= 0) {
+		printf("parsing fail, wrong input for argv[2] - packet\n");
+		return -EINVAL;
+	}
+	if (argc == 5) {
+		if (!strcmp(argv[3], "-l")) {
+			load = true;
+		} else if (strcmp(argv[3], "-s")) {
+			printf("parsing fail, wrong input for argv[3] - expected -l or -s\n");
+			return -EINVAL;
+		}
+		file = argv[4];
+	}
+
+	model = kcalloc(1, sizeof(*model), GFP_KERNEL);
+	if (!model) {
+		pr_err("%s: no memory\n", __func__);
+		return -ENOMEM;
+	}
+
+	if (load)
+		rc = pp2_cls_model_load(model, file);
+	else
+		rc = pp2_cls_model_snapshot(inst, model);
+	if (!rc && file && !load)
+		rc = pp2_cls_model_save(model, file);
+	if (!rc)
+		rc = pp2_cls_model_run(model, port, pkt, PP2_MH_SIZE + len, &res);
+	kfree(model);
+	if (rc) {
+		printf("model run failed, rc %d\n", rc);
+		return rc;
+	}
+
+	printf("parser: lookups %d, last tid %d, ri 0x%08x, ai 0x%02x, lookup id %d, l3 offs %d, l4 offs %d%s%s\n",
+	       res.num_lookups, res.prs_tid, res.ri, res.ai, res.lkpid, res.l3_offs, res.l4_offs,
+	       (res.flags & PP2_CLS_MODEL_F_PRS_MISS) ? ", tcam miss" : "",
+	       (res.flags & PP2_CLS_MODEL_F_PRS_LOOP) ? ", max loop" : "");
+	printf("classifier: engines %d, c2 idx %d, c3 idx %d%s\n", res.num_engines, res.c2_idx, res.c3_idx,
+	       (res.flags & PP2_CLS_MODEL_F_LKP_DIS) ? ", lookup disabled" : "");
+	printf("result: %s, queue %d, color %s, rss %s", (res.flags & PP2_CLS_MODEL_F_DROP) ? "drop" : "pass",
+	       res.queue, color_str[res.color], (res.flags & PP2_CLS_MODEL_F_RSS) ? "on" : "off");
+	if (res.flags & PP2_CLS_MODEL_F_FLOW_ID)
+		printf(", flow id %d", res.flow_id);
+	printf("\n");
+	if (res.flags & PP2_CLS_MODEL_F_QOS_TBL)
+		printf("note: queue or color taken from a QoS table, not modeled\n");
+	if (res.flags & PP2_CLS_MODEL_F_UNSUPP)
+		printf("note: a flow entry uses an engine or field not modeled\n");
+
+	return 0;
+}
@@ -199,11 +199,13 @@ int pp2_cls_lkp_dcod_set(struct pp2_inst *inst, struct pp2_cls_lkp_dcod_entry_t
 /*******************************************************************************
  * pp2_cls_lkp_dcod_hw_set
  *
- * DESCRIPTION: The routine write to HW the lookup decode entry
+ * DESCRIPTION: The routine write to HW the lookup decode entries of a logical
+ *		flow ID, pointing at a flow offset
  *
  * INPUTS:
  *	inst - packet processor instance
- *	fl - flow rules structure
+ *	fl_log_id - the logical flow ID
+ *	flow_idx - the flow table offset of the first flow rule
  *
  * OUTPUTS:
  *	None
@@ -211,25 +213,19 @@ int pp2_cls_lkp_dcod_set(struct pp2_inst *inst, struct pp2_cls_lkp_dcod_entry_t
  * RETURNS:
  *	0 on success, error-code otherwise
  *******************************************************************************/
-static int pp2_cls_lkp_dcod_hw_set(struct pp2_inst *inst, struct pp2_cls_fl_t *fl)
+static int pp2_cls_lkp_dcod_hw_set(struct pp2_inst *inst, u16 fl_log_id, u16 flow_idx)
 {
 	struct mv_pp2x_cls_lookup_entry fe;
 	int rc;
-	u16 luid, rl = 0;
+	u16 luid;
 	struct pp2_db_cls_lkp_dcod_t lkp_dcod_db;
-	struct pp2_db_cls_fl_rule_list_t *fl_rl_db;
-	u16 rl_off;
+	struct pp2_cls_fl_upd_stats *stats = pp2_db_cls_fl_upd_stats_get(inst);
 	uintptr_t cpu_slot = pp2_default_cpu_slot(inst);
 
-	if (!fl) {
-		pr_err("%s: null pointer\n", __func__);
-		return -EFAULT;
-	}
-
 	/* get the lookup DB for this logical flow ID */
-	rc = pp2_db_cls_lkp_dcod_get(inst, fl->fl_log_id, &lkp_dcod_db);
+	rc = pp2_db_cls_lkp_dcod_get(inst, fl_log_id, &lkp_dcod_db);
 	if (rc) {
-		pr_err("failed to get lookup decode info for fl_log_id %d\n", fl->fl_log_id);
+		pr_err("failed to get lookup decode info for fl_log_id %d\n", fl_log_id);
 		return rc;
 	}
 
@@ -238,55 +234,30 @@ static int pp2_cls_lkp_dcod_hw_set(struct pp2_inst *inst, struct pp2_cls_fl_t *f
 		return 0;
 	}
 
-	/* get the rule list for this logical flow ID */
-	fl_rl_db = kmalloc(sizeof(*fl_rl_db), GFP_KERNEL);
-	if (!fl_rl_db)
-		return -ENOMEM;
-
-	memset(fl_rl_db, 0, sizeof(struct pp2_db_cls_fl_rule_list_t));
-	rc = pp2_db_cls_fl_rule_list_get(inst, lkp_dcod_db.flow_off, lkp_dcod_db.flow_len, &fl_rl_db->flow[0]);
-	if (rc) {
-		pr_err("failed to get flow rule list fl_log_id=%d flow_off=%d flow_len=%d\n",
-		       fl->fl_log_id, lkp_dcod_db.flow_off, lkp_dcod_db.flow_len);
-		kfree(fl_rl_db);
-		return rc;
-	}
-
 	/* iterate over all LUIDs */
 	for (luid = 0; luid < lkp_dcod_db.luid_num; luid++) {
 		/* Exclude MAC default LookupID by LSP */
 		if (LUID_IS_LSP_RESERVED(lkp_dcod_db.luid_list[luid].luid))
 			continue;
 
-		/* found the rule, get it`s offset */
-		rc = pp2_db_cls_rl_off_get(inst, &rl_off, fl_rl_db->flow[rl].rl_log_id);
-		if (rc) {
-			pr_err("recvd ret_code(%d)\n", rc);
-			kfree(fl_rl_db);
-			return rc;
-		}
-
 		/* updated the HW */
 		mv_pp2x_cls_sw_lkp_clear(&fe);
 
-		rc = mv_pp2x_cls_sw_lkp_flow_set(&fe, rl_off);
+		rc = mv_pp2x_cls_sw_lkp_flow_set(&fe, flow_idx);
 		if (rc) {
 			pr_err("recvd ret_code(%d)\n", rc);
-			kfree(fl_rl_db);
 			return rc;
 		}
 
 		rc = mv_pp2x_cls_sw_lkp_rxq_set(&fe, lkp_dcod_db.cpu_q);
 		if (rc) {
 			pr_err("recvd ret_code(%d)\n", rc);
-			kfree(fl_rl_db);
 			return rc;
 		}
 
 		rc = mv_pp2x_cls_sw_lkp_en_set(&fe, lkp_dcod_db.enabled);
 		if (rc) {
 			pr_err("recvd ret_code(%d)\n", rc);
-			kfree(fl_rl_db);
 			return rc;
 		}
 
@@ -295,18 +266,15 @@ static int pp2_cls_lkp_dcod_hw_set(struct pp2_inst *inst, struct pp2_cls_fl_t *f
 		rc = mv_pp2x_cls_hw_lkp_write(cpu_slot, &fe);
 		if (rc) {
 			pr_err("recvd ret_code(%d)\n", rc);
-			kfree(fl_rl_db);
 			return rc;
 		}
+		stats->num_writes++;
+		stats->op_writes++;
 
-		pr_debug("fl_log_id[%2d] lid_nr[%2d] rl_log_id[%3d] prio[%2d] rl_off[%3d] luid[%2d]\n",
-			 fl->fl_log_id, luid, fl_rl_db->flow[rl].rl_log_id,
-			 fl_rl_db->flow[rl].prio,
-			 rl_off,
-			 lkp_dcod_db.luid_list[luid].luid);
+		pr_debug("fl_log_id[%2d] lid_nr[%2d] flow_idx[%3d] luid[%2d]\n",
+			 fl_log_id, luid, flow_idx, lkp_dcod_db.luid_list[luid].luid);
 	}
 
-	kfree(fl_rl_db);
 	return 0;
 }
 
@@ -1743,25 +1711,112 @@ static int pp2_cls_fl_rl_db_set(struct pp2_inst *inst,
 }
 
 /*******************************************************************************
- * pp2_cls_fl_rl_hw_set
+ * pp2_cls_fl_hw_read
+ *
+ * DESCRIPTION: The routine reads a flow entry, from the flow table shadow when
+ *		it holds the HW entry, else from HW
+ *
+ * INPUTS:
+ *	inst - packet processor instance
+ *	off - the offset of the entry
+ *
+ * OUTPUTS:
+ *	fe - the flow entry
+ *
+ * RETURNS:
+ *	0 on success, error-code otherwise
+ ******************************************************************************/
+static int pp2_cls_fl_hw_read(struct pp2_inst *inst, u16 off, struct mv_pp2x_cls_flow_entry *fe)
+{
+	struct mv_pp2x_cls_flow_entry *shadow = pp2_db_cls_fl_shadow_get(inst, off);
+
+	if (!shadow)
+		return mv_pp2x_cls_hw_flow_read(pp2_default_cpu_slot(inst), off, fe);
+
+	memcpy(fe, shadow, sizeof(*fe));
+
+	return 0;
+}
+
+/*******************************************************************************
+ * pp2_cls_fl_hw_changed
+ *
+ * DESCRIPTION: The routine checks if a flow entry differs from the HW entry,
+ *		according to the flow table shadow
+ *
+ * INPUTS:
+ *	inst - packet processor instance
+ *	fe - the flow entry, fe->index is the HW offset
+ *
+ * RETURNS:
+ *	true if the entry must be written, false if HW holds it already
+ ******************************************************************************/
+static bool pp2_cls_fl_hw_changed(struct pp2_inst *inst, struct mv_pp2x_cls_flow_entry *fe)
+{
+	struct mv_pp2x_cls_flow_entry *shadow = pp2_db_cls_fl_shadow_get(inst, fe->index);
+
+	return !shadow || memcmp(shadow->data, fe->data, sizeof(fe->data));
+}
+
+/*******************************************************************************
+ * pp2_cls_fl_hw_write
+ *
+ * DESCRIPTION: The routine writes a flow entry to HW and to the flow table
+ *		shadow, an entry HW already holds is not written
+ *
+ * INPUTS:
+ *	inst - packet processor instance
+ *	fe - the flow entry, fe->index is the HW offset
+ *
+ * OUTPUTS:
+ *	None
+ *
+ * RETURNS:
+ *	0 on success, error-code otherwise
+ ******************************************************************************/
+static int pp2_cls_fl_hw_write(struct pp2_inst *inst, struct mv_pp2x_cls_flow_entry *fe)
+{
+	struct mv_pp2x_cls_flow_entry *shadow = pp2_db_cls_fl_shadow_get(inst, fe->index);
+	struct pp2_cls_fl_upd_stats *stats = pp2_db_cls_fl_upd_stats_get(inst);
+	int rc;
+
+	if (!pp2_cls_fl_hw_changed(inst, fe)) {
+		stats->num_skipped++;
+		return 0;
+	}
+
+	rc = mv_pp2x_cls_hw_flow_write(pp2_default_cpu_slot(inst), fe);
+	if (rc) {
+		pr_err("recvd ret_code(%d)\n", rc);
+		return rc;
+	}
+	if (shadow)
+		memcpy(shadow->data, fe->data, sizeof(fe->data));
+	stats->num_writes++;
+	stats->op_writes++;
+
+	return 0;
+}
+
+/*******************************************************************************
+ * pp2_cls_fl_rl_hw_build
  *
- * DESCRIPTION: The routine writes a flow rule to HW
+ * DESCRIPTION: The routine builds the HW flow entry of a flow rule
  *
  * INPUTS:
  *	rl - the rule to enable information structure
  *	is_last - a flag indicating if he rule is last in flow
  *
  * OUTPUTS:
- *	None
+ *	fe - the flow entry, at the rule offset
  *
  * RETURNS:
  *	0 on success, error-code otherwise
  ******************************************************************************/
-static int pp2_cls_fl_rl_hw_set(uintptr_t cpu_slot,
-				struct pp2_cls_rl_entry_t *rl,
-				bool is_last)
+static int pp2_cls_fl_rl_hw_build(struct pp2_cls_rl_entry_t *rl,
+				  bool is_last,
+				  struct mv_pp2x_cls_flow_entry *fe)
 {
-	struct mv_pp2x_cls_flow_entry fe;
 	int rc;
 	u16 fid;
 	/* enum pp2_init_us_2g_trunk_mode_t us_2g_trunk_support; */
@@ -1771,9 +1826,9 @@ static int pp2_cls_fl_rl_hw_set(uintptr_t cpu_slot,
 		return -EFAULT;
 	}
 
-	mv_pp2x_cls_sw_flow_clear(&fe);
+	mv_pp2x_cls_sw_flow_clear(fe);
 
-	rc = mv_pp2x_cls_sw_flow_engine_set(&fe, rl->engine, is_last);
+	rc = mv_pp2x_cls_sw_flow_engine_set(fe, rl->engine, is_last);
 	if (rc) {
 		pr_err("recvd ret_code(%d)\n", rc);
 		return rc;
@@ -1781,22 +1836,22 @@ static int pp2_cls_fl_rl_hw_set(uintptr_t cpu_slot,
 
 	/* set the port_type and port_bm according to enable configuration */
 	if (rl->enabled)
-		rc = mv_pp2x_cls_sw_flow_port_set(&fe, rl->port_type, rl->port_bm);
+		rc = mv_pp2x_cls_sw_flow_port_set(fe, rl->port_type, rl->port_bm);
 	else
-		rc = mv_pp2x_cls_sw_flow_port_set(&fe, 0, 0);
+		rc = mv_pp2x_cls_sw_flow_port_set(fe, 0, 0);
 
 	if (rc) {
 		pr_err("recvd ret_code(%d)\n", rc);
 		return rc;
 	}
 
-	rc = mv_pp2x_cls_sw_flow_extra_set(&fe, rl->lu_type, rl->prio);
+	rc = mv_pp2x_cls_sw_flow_extra_set(fe, rl->lu_type, rl->prio);
 	if (rc) {
 		pr_err("recvd ret_code(%d)\n", rc);
 		return rc;
 	}
 
-	rc = mv_pp2x_cls_sw_flow_hek_num_set(&fe, rl->field_id_cnt);
+	rc = mv_pp2x_cls_sw_flow_hek_num_set(fe, rl->field_id_cnt);
 	if (rc) {
 		pr_err("recvd ret_code(%d)\n", rc);
 		return rc;
@@ -1812,43 +1867,38 @@ static int pp2_cls_fl_rl_hw_set(uintptr_t cpu_slot,
 	 * and the src port value of C2/3 comes from classifier, not packet
 	 */
 	/* if (TPM_US_2G_TRUNK_SUPPORTED == us_2g_trunk_support)
-	 *	rc = mv_pp2x_cls_sw_flow_portid_select(&fe, MVPP2_CLS_PORT_ID_FROM_TBL);
+	 *	rc = mv_pp2x_cls_sw_flow_portid_select(fe, MVPP2_CLS_PORT_ID_FROM_TBL);
 	 * else
-	 *	rc = mv_pp2x_cls_sw_flow_portid_select(&fe, MVPP2_CLS_PORT_ID_FROM_PKT);
+	 *	rc = mv_pp2x_cls_sw_flow_portid_select(fe, MVPP2_CLS_PORT_ID_FROM_PKT);
 	 *
 	 */
 
-	rc = mv_pp2x_cls_sw_flow_portid_select(&fe, MVPP2_CLS_PORT_ID_FROM_PKT);
+	rc = mv_pp2x_cls_sw_flow_portid_select(fe, MVPP2_CLS_PORT_ID_FROM_PKT);
 	if (rc) {
 		pr_err("recvd ret_code(%d)\n", rc);
 		return rc;
 	}
 
-	rc = mv_pp2x_cls_sw_flow_seq_ctrl_set(&fe, rl->seq_ctrl);
+	rc = mv_pp2x_cls_sw_flow_seq_ctrl_set(fe, rl->seq_ctrl);
 	if (rc) {
 		pr_err("recvd ret_code(%d)\n", rc);
 		return rc;
 	}
 
-	rc = mv_pp2x_cls_sw_flow_udf7_set(&fe, rl->udf7);
+	rc = mv_pp2x_cls_sw_flow_udf7_set(fe, rl->udf7);
 	if (rc) {
 		pr_err("recvd ret_code(%d)\n", rc);
 		return rc;
 	}
 
 	for (fid = 0; fid < rl->field_id_cnt; fid++) {
-		rc = mv_pp2x_cls_sw_flow_hek_set(&fe, fid, rl->field_id[fid]);
+		rc = mv_pp2x_cls_sw_flow_hek_set(fe, fid, rl->field_id[fid]);
 		if (rc) {
 			pr_err("recvd ret_code(%d)\n", rc);
 			return rc;
 		}
 	}
-	fe.index = rl->rl_off;
-	rc = mv_pp2x_cls_hw_flow_write(cpu_slot, &fe);
-	if (rc) {
-		pr_err("recvd ret_code(%d)\n", rc);
-		return rc;
-	}
+	fe->index = rl->rl_off;
 
 	return 0;
 }
@@ -1874,7 +1924,6 @@ static int pp2_cls_fl_rl_hw_ena(struct pp2_inst *inst, struct pp2_cls_fl_rule_en
 	struct mv_pp2x_cls_flow_entry fe;
 	int rc;
 	u16 off;
-	uintptr_t cpu_slot = pp2_default_cpu_slot(inst);
 
 	if (!rl_en) {
 		pr_err("%s: null pointer\n", __func__);
@@ -1888,7 +1937,7 @@ static int pp2_cls_fl_rl_hw_ena(struct pp2_inst *inst, struct pp2_cls_fl_rule_en
 		return rc;
 	}
 
-	rc = mv_pp2x_cls_hw_flow_read(cpu_slot, off, &fe);
+	rc = pp2_cls_fl_hw_read(inst, off, &fe);
 	if (rc) {
 		pr_err("recvd ret_code(%d)\n", rc);
 		return rc;
@@ -1902,7 +1951,7 @@ static int pp2_cls_fl_rl_hw_ena(struct pp2_inst *inst, struct pp2_cls_fl_rule_en
 	}
 
 	fe.index = off;
-	rc = mv_pp2x_cls_hw_flow_write(cpu_slot, &fe);
+	rc = pp2_cls_fl_hw_write(inst, &fe);
 	if (rc) {
 		pr_err("recvd ret_code(%d)\n", rc);
 		return rc;
@@ -1918,6 +1967,7 @@ static int pp2_cls_fl_rl_hw_ena(struct pp2_inst *inst, struct pp2_cls_fl_rule_en
  *		port_bm to zero
  *
  * INPUTS:
+ *	inst - packet processor instance
  *	off - the offset of the rule
  *
  * OUTPUTS:
@@ -1926,12 +1976,12 @@ static int pp2_cls_fl_rl_hw_ena(struct pp2_inst *inst, struct pp2_cls_fl_rule_en
  * RETURNS:
  *	0 on success, error-code otherwise
  ******************************************************************************/
-static int pp2_cls_fl_rl_hw_dis(uintptr_t cpu_slot, u16 off)
+static int pp2_cls_fl_rl_hw_dis(struct pp2_inst *inst, u16 off)
 {
 	struct mv_pp2x_cls_flow_entry	fe;
 	int			rc;
 
-	rc = mv_pp2x_cls_hw_flow_read(cpu_slot, off, &fe);
+	rc = pp2_cls_fl_hw_read(inst, off, &fe);
 	if (rc) {
 		pr_err("recvd ret_code(%d)\n", rc);
 		return rc;
@@ -1944,7 +1994,7 @@ static int pp2_cls_fl_rl_hw_dis(uintptr_t cpu_slot, u16 off)
 	}
 
 	fe.index = off;
-	rc = mv_pp2x_cls_hw_flow_write(cpu_slot, &fe);
+	rc = pp2_cls_fl_hw_write(inst, &fe);
 	if (rc) {
 		pr_err("recvd ret_code(%d)\n", rc);
 		return rc;
@@ -1956,7 +2006,13 @@ static int pp2_cls_fl_rl_hw_dis(uintptr_t cpu_slot, u16 off)
 /*******************************************************************************
  * pp2_cls_fl_rls_set
  *
- * DESCRIPTION: The routine sets the merged flow to HW and updated DBs
+ * DESCRIPTION: The routine sets the merged flow to HW and updated DBs.
+ *		Only the flow entries that changed are written. When more than
+ *		one entry a lookup can reach changes, the new flow is first
+ *		written to free flow table rows and the lookup decode entries
+ *		are pointed at it, so packets never see a half-written flow.
+ *		When there are not enough free rows the entries are written in
+ *		place, last entry first.
  *
  * INPUTS:
  *	inst - packet processor instance
@@ -1976,8 +2032,11 @@ static int pp2_cls_fl_rls_set(struct pp2_inst *inst, struct pp2_cls_fl_t *fl_rls
 	u16 rl_idx;
 	bool is_last;
 	u16 new_rl_cnt = 0;
+	u16 live_cnt = 0;
+	bool use_spare;
 	struct pp2_cls_rl_entry_t *rl;
-	uintptr_t cpu_slot = pp2_default_cpu_slot(inst);
+	struct pp2_db_cls_fl_ctrl_t fl_ctrl;
+	struct mv_pp2x_cls_flow_entry *fe, spare_fe;
 
 	if (!fl_rls) {
 		pr_err("%s: null pointer\n", __func__);
@@ -2013,26 +2072,80 @@ static int pp2_cls_fl_rls_set(struct pp2_inst *inst, struct pp2_cls_fl_t *fl_rls
 		}
 	}
 
-	/* set the flow rules */
+	/* build the flow entries and find the ones that changed */
+	fe = kcalloc(fl_rls->fl_len, sizeof(*fe), GFP_KERNEL);
+	if (!fe)
+		return -ENOMEM;
+
 	for (rl_idx = 0; rl_idx < fl_rls->fl_len; rl_idx++) {
 		rl = &fl_rls->fl[rl_idx];
 		is_last = (rl_idx == fl_rls->fl_len - 1) ? true : false;
 
-		/* write rule to HW */
-		rc = pp2_cls_fl_rl_hw_set(cpu_slot, rl, is_last);
+		rc = pp2_cls_fl_rl_hw_build(rl, is_last, &fe[rl_idx]);
 		if (rc) {
 			pr_err("recvd ret_code(%d)\n", rc);
+			kfree(fe);
 			return rc;
 		}
+
+		/* entries beyond the current flow length are not reachable */
+		if (pp2_cls_fl_hw_changed(inst, &fe[rl_idx]) &&
+		    lkp_dcod_db.enabled && rl_idx < lkp_dcod_db.flow_len)
+			live_cnt++;
 	}
 
-	/* set the lookup decode table */
-	rc = pp2_cls_lkp_dcod_hw_set(inst, fl_rls);
+	rc = pp2_db_cls_fl_ctrl_get(inst, &fl_ctrl);
 	if (rc) {
 		pr_err("recvd ret_code(%d)\n", rc);
+		kfree(fe);
 		return rc;
 	}
 
+	use_spare = (live_cnt > 1 && fl_ctrl.f_end - fl_ctrl.f_start >= fl_rls->fl_len);
+	if (use_spare) {
+		/* write the new flow to free rows and redirect the lookups to it */
+		for (rl_idx = fl_rls->fl_len; rl_idx > 0; rl_idx--) {
+			spare_fe = fe[rl_idx - 1];
+			spare_fe.index = fl_ctrl.f_start + rl_idx - 1;
+			rc = pp2_cls_fl_hw_write(inst, &spare_fe);
+			if (rc) {
+				pr_err("recvd ret_code(%d)\n", rc);
+				kfree(fe);
+				return rc;
+			}
+		}
+
+		rc = pp2_cls_lkp_dcod_hw_set(inst, fl_rls->fl_log_id, fl_ctrl.f_start);
+		if (rc) {
+			pr_err("recvd ret_code(%d)\n", rc);
+			kfree(fe);
+			return rc;
+		}
+		pp2_db_cls_fl_upd_stats_get(inst)->num_swaps++;
+	} else if (live_cnt > 1) {
+		pp2_db_cls_fl_upd_stats_get(inst)->num_in_place++;
+	}
+
+	/* set the flow rules, last first so a lookup reaches at most one new entry */
+	for (rl_idx = fl_rls->fl_len; rl_idx > 0; rl_idx--) {
+		rc = pp2_cls_fl_hw_write(inst, &fe[rl_idx - 1]);
+		if (rc) {
+			pr_err("recvd ret_code(%d)\n", rc);
+			kfree(fe);
+			return rc;
+		}
+	}
+	kfree(fe);
+
+	/* point the lookup decode table back at the flow */
+	if (use_spare) {
+		rc = pp2_cls_lkp_dcod_hw_set(inst, fl_rls->fl_log_id, lkp_dcod_db.flow_off);
+		if (rc) {
+			pr_err("recvd ret_code(%d)\n", rc);
+			return rc;
+		}
+	}
+
 	/* update DB for rules and lookup decode */
 	for (rl_idx = 0; rl_idx < fl_rls->fl_len; rl_idx++) {
 		rl = &fl_rls->fl[rl_idx];
@@ -2300,6 +2413,30 @@ static int pp2_cls_fl_nt_rule_reorder(struct pp2_cls_fl_t *fl_rls)
 	return 0;
 }
 
+/*******************************************************************************
+ * pp2_cls_fl_upd_stats_done
+ *
+ * DESCRIPTION: The routine accounts the HW writes of a rule add operation
+ *
+ * INPUTS:
+ *	inst - packet processor instance
+ *
+ * OUTPUTS:
+ *	None
+ *
+ * RETURNS:
+ *	None
+ ******************************************************************************/
+static void pp2_cls_fl_upd_stats_done(struct pp2_inst *inst)
+{
+	struct pp2_cls_fl_upd_stats *stats = pp2_db_cls_fl_upd_stats_get(inst);
+
+	stats->num_adds++;
+	stats->last_add_writes = stats->op_writes;
+	if (stats->op_writes > stats->max_add_writes)
+		stats->max_add_writes = stats->op_writes;
+}
+
 /*******************************************************************************
  * pp2_cls_fl_rule_add
  *
@@ -2321,7 +2458,7 @@ int pp2_cls_fl_rule_add(struct pp2_inst *inst, struct pp2_cls_fl_rule_list_t *fl
 	struct pp2_cls_fl_t *merge_fl;
 	struct pp2_cls_fl_t *cur_fl;
 	struct pp2_cls_fl_rule_entry_t *fl_rl;
-	struct pp2_cls_rl_entry_t *fl;
+	struct pp2_cls_rl_entry_t *fl, rl_tmp;
 	struct pp2_db_cls_lkp_dcod_t lkp_dcod_db;
 	int rc;
 	u16 i, j, fl_log_id;
@@ -2332,6 +2469,8 @@ int pp2_cls_fl_rule_add(struct pp2_inst *inst, struct pp2_cls_fl_rule_list_t *fl
 		return -EFAULT;
 	}
 
+	pp2_db_cls_fl_upd_stats_get(inst)->op_writes = 0;
+
 	new_fl = kmalloc(sizeof(*new_fl), GFP_KERNEL);
 	if (!new_fl)
 		return -ENOMEM;
@@ -2452,6 +2591,15 @@ int pp2_cls_fl_rule_add(struct pp2_inst *inst, struct pp2_cls_fl_rule_list_t *fl
 				goto err3;
 			}
 
+			/* keep the new flow sorted by prio, after rules of equal prio */
+			rl_tmp = *fl;
+			for (j = new_fl->fl_len; j > 0; j--) {
+				if (cmp_prio(&new_fl->fl[j - 1], &rl_tmp) != 1)
+					break;
+				new_fl->fl[j] = new_fl->fl[j - 1];
+			}
+			new_fl->fl[j] = rl_tmp;
+
 			new_fl->fl_len++;
 		}
 
@@ -2461,10 +2609,6 @@ int pp2_cls_fl_rule_add(struct pp2_inst *inst, struct pp2_cls_fl_rule_list_t *fl
 
 		/* merge the current and new flow rules together */
 
-		/* sort the new flow according to prio */
-		if (new_fl->fl_len > 1)
-			pp2_cls_fl_rls_sort(new_fl->fl, new_fl->fl_len);
-
 		/* merge the two flows (new & curr) */
 		rc = pp2_cls_fl_rls_merge(inst, fl_log_id, cur_fl, new_fl, merge_fl);
 		if (rc) {
@@ -2497,6 +2641,7 @@ int pp2_cls_fl_rule_add(struct pp2_inst *inst, struct pp2_cls_fl_rule_list_t *fl
 	kfree(cur_fl);
 	kfree(merge_fl);
 	kfree(new_fl);
+	pp2_cls_fl_upd_stats_done(inst);
 
 	return 0;
 err3:
@@ -2505,6 +2650,7 @@ err2:
 	kfree(merge_fl);
 err1:
 	kfree(new_fl);
+	pp2_cls_fl_upd_stats_done(inst);
 
 	return rc;
 }
@@ -2732,7 +2878,6 @@ int pp2_cls_fl_rule_disable(struct pp2_inst *inst, u16 *rl_log_id,
 	int loop;
 	struct pp2_cls_fl_rule_entry_t rl_en;
 	u32 port_id = 0;
-	uintptr_t cpu_slot = pp2_default_cpu_slot(inst);
 
 	if (!rl_log_id) {
 		pr_err("%s: rl_log_id is null pointer\n", __func__);
@@ -2771,7 +2916,7 @@ int pp2_cls_fl_rule_disable(struct pp2_inst *inst, u16 *rl_log_id,
 		for (loop = 0; loop < MVPP2_MAX_NUM_GMACS; loop++)
 			ref_sum += rl_db.ref_cnt[loop];
 		if (ref_sum == 1) {
-			rc = pp2_cls_fl_rl_hw_dis(cpu_slot, rl_off);
+			rc = pp2_cls_fl_rl_hw_dis(inst, rl_off);
 			if (rc) {
 				pr_err("recvd ret_code(%d)\n", rc);
 				return rc;
@@ -3076,6 +3221,7 @@ int pp2_cls_init(struct pp2_inst *inst)
 		pr_err("mv_pp2x_cls_hw_flow_clear_all fail rc = %d\n", rc);
 		goto end;
 	}
+	pp2_db_cls_fl_shadow_reset(inst);
 
 	/* add rules and set HW */
 	if (fl_rls->fl_len)
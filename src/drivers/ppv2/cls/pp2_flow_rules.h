@@ -178,6 +178,18 @@ struct pp2_cls_fl_t {
 	struct pp2_cls_fl_eng_cnt_t	eng_cnt;			/* flow rules engine count	*/
 };
 
+/* Flow table update counters */
+struct pp2_cls_fl_upd_stats {
+	u32			num_adds;			/* rule add operations		*/
+	u32			last_add_writes;		/* HW writes of the last add	*/
+	u32			max_add_writes;			/* most HW writes of an add	*/
+	u32			op_writes;			/* HW writes of the running add	*/
+	u64			num_writes;			/* flow and lookup decode writes*/
+	u64			num_skipped;			/* unchanged flow entries	*/
+	u32			num_swaps;			/* flows moved to spare entries	*/
+	u32			num_in_place;			/* flows rewritten in place	*/
+};
+
 /* cli functions */
 int pp2_cli_cls_lkp_dcod_entry_set(void *arg, int argc, char *argv[]);
 int pp2_cli_cls_lkp_dcod_luid_set(void *arg, int argc, char *argv[]);
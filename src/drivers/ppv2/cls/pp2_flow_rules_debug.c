@@ -623,6 +623,7 @@ int pp2_cli_cls_fl_rls_dump(void *arg, int argc, char *argv[])
 	u16 ref_sum = 0;
 	int rc;
 	struct pp2_inst *inst = (struct pp2_inst *)arg;
+	struct pp2_cls_fl_upd_stats *stats;
 
 	fl_rl_list_db = kmalloc(sizeof(*fl_rl_list_db), GFP_KERNEL);
 	if (!fl_rl_list_db) {
@@ -686,6 +687,13 @@ int pp2_cli_cls_fl_rls_dump(void *arg, int argc, char *argv[])
 			printf("\n");
 	}
 
+	stats = pp2_db_cls_fl_upd_stats_get(inst);
+	printf("flow table updates: adds %d, writes last/max %d/%d, total writes %llu, skipped %llu\n",
+	       stats->num_adds, stats->last_add_writes, stats->max_add_writes,
+	       (unsigned long long)stats->num_writes, (unsigned long long)stats->num_skipped);
+	printf("                    spare row swaps %d, in place updates %d\n",
+	       stats->num_swaps, stats->num_in_place);
+
 	kfree(fl_rl_list_db);
 	return 0;
 }
@@ -458,7 +458,7 @@ static int mv_pp2x_prs_hw_write(uintptr_t cpu_slot, struct mv_pp2x_prs_entry *pe
 }
 
 /* Read tcam entry from hw */
-static int mv_pp2x_prs_hw_read(uintptr_t cpu_slot, struct mv_pp2x_prs_entry *pe)
+int mv_pp2x_prs_hw_read(uintptr_t cpu_slot, struct mv_pp2x_prs_entry *pe)
 {
 	int i;
 
@@ -1236,6 +1236,338 @@ static int pp2_prs_log_port_ip4_proto(struct pp2_port *port, u16 proto,
 }
 
 
+/* pp2_prs_tunnel_entry_init
+ *
+ * DESCRIPTION:	Allocate a MUSDK IPv4 lookup entry, matching a single port
+ *
+ * INPUTS:	port	- port to be configured
+ *
+ * OUTPUTS:	pe	- parser entry, to be completed by the caller
+ *
+ * RETURNS:	0 on success, error-code otherwise
+ */
+static int pp2_prs_tunnel_entry_init(struct pp2_port *port, struct mv_pp2x_prs_entry *pe)
+{
+	int tid;
+
+	tid = pp2_prs_tcam_first_free(port->parent, MVPP2_PE_FIRST_FREE_TID,
+				      MVPP2_PE_LAST_FREE_TID);
+	if (tid < 0)
+		return tid;
+
+	memset(pe, 0, sizeof(struct mv_pp2x_prs_entry));
+	mv_pp2x_prs_tcam_lu_set(pe, MVPP2_PRS_LU_IP4);
+	pe->index = tid;
+
+	/* Mask all ports but this one */
+	mv_pp2x_prs_tcam_port_map_set(pe, 0);
+	mv_pp2x_prs_tcam_port_set(pe, port->id, true);
+
+	return 0;
+}
+
+/* pp2_prs_tunnel_entry_write
+ *
+ * DESCRIPTION:	Update shadow table and hw with a MUSDK tunnel entry
+ *
+ * INPUTS:	port	- port to be configured
+ *		pe	- parser entry
+ *
+ * OUTPUTS:	None
+ *
+ * RETURNS:	None
+ */
+static void pp2_prs_tunnel_entry_write(struct pp2_port *port, struct mv_pp2x_prs_entry *pe)
+{
+	struct pp2_inst *inst = port->parent;
+
+	/* Keep the entry, to remove it with the port */
+	port->prs_tunnel_tid[port->num_prs_tunnel_tids++] = pe->index;
+	mv_pp2x_prs_shadow_set(inst, pe->index, MVPP2_PRS_LU_IP4);
+	mv_pp2x_prs_shadow_ri_set(inst, pe->index, mv_pp2x_prs_sram_ri_get(pe),
+				  mv_pp2x_prs_sram_ri_mask_get(pe));
+	mv_pp2x_prs_hw_write(pp2_default_cpu_slot(inst), pe);
+}
+
+/* pp2_prs_tunnel_ip4_proto
+ *
+ * DESCRIPTION:	Add an outer IPv4 protocol entry for a tunnel.
+ *		Same as the kernel IPv4 protocol entry, except that the additional
+ *		info tunnel bit is set, so that the following IPv4 address lookup
+ *		can look into the tunnel header.
+ *
+ * INPUTS:	port	- port to be configured
+ *		proto	- IPv4 protocol of the tunnel
+ *		ri	- L4 result info
+ *		ai	- tunnel additional info bit, 0 for none
+ *		frag	- match fragmented (true) or not fragmented (false) packets
+ *
+ * OUTPUTS:	None
+ *
+ * RETURNS:	0 on success, error-code otherwise
+ */
+static int pp2_prs_tunnel_ip4_proto(struct pp2_port *port, u16 proto, u32 ri, u32 ai, bool frag)
+{
+	struct mv_pp2x_prs_entry pe;
+	int rc;
+
+	rc = pp2_prs_tunnel_entry_init(port, &pe);
+	if (rc)
+		return rc;
+
+	/* Set next lu to IPv4, at the destination address */
+	mv_pp2x_prs_sram_next_lu_set(&pe, MVPP2_PRS_LU_IP4);
+	mv_pp2x_prs_sram_shift_set(&pe, 12, MVPP2_PRS_SRAM_OP_SEL_SHIFT_ADD);
+	/* Set L4 offset */
+	mv_pp2x_prs_sram_offset_set(&pe, MVPP2_PRS_SRAM_UDF_TYPE_L4,
+				    sizeof(struct iphdr) - 4,
+				    MVPP2_PRS_SRAM_OP_SEL_UDF_ADD);
+	mv_pp2x_prs_sram_ai_update(&pe, MVPP2_PRS_IPV4_DIP_AI_BIT | ai,
+				   MVPP2_PRS_IPV4_DIP_AI_BIT | ai);
+	mv_pp2x_prs_sram_ri_update(&pe, ri | (frag ? MVPP2_PRS_RI_IP_FRAG_TRUE : MVPP2_PRS_RI_IP_FRAG_FALSE),
+				   MVPP2_PRS_RI_L4_PROTO_MASK | MVPP2_PRS_RI_IP_FRAG_MASK);
+
+	if (!frag) {
+		mv_pp2x_prs_tcam_data_byte_set(&pe, 2, 0x00,
+					       MVPP2_PRS_TCAM_PROTO_MASK_L);
+		mv_pp2x_prs_tcam_data_byte_set(&pe, 3, 0x00,
+					       MVPP2_PRS_TCAM_PROTO_MASK);
+	}
+	mv_pp2x_prs_tcam_data_byte_set(&pe, 5, proto, MVPP2_PRS_TCAM_PROTO_MASK);
+	mv_pp2x_prs_tcam_ai_update(&pe, 0, MVPP2_PRS_IPV4_DIP_AI_BIT);
+
+	pp2_prs_tunnel_entry_write(port, &pe);
+
+	return 0;
+}
+
+/* pp2_prs_tunnel_inner_entry_init
+ *
+ * DESCRIPTION:	Allocate the entry following a tunnel outer IPv4 protocol entry.
+ *		The entry matches the outer destination address lookup of a
+ *		unicast packet, marked with the tunnel additional info bit.
+ *		The tunnel header is at data offset 4.
+ *
+ * INPUTS:	port	- port to be configured
+ *		ai	- tunnel additional info bit
+ *
+ * OUTPUTS:	pe	- parser entry, to be completed by the caller
+ *
+ * RETURNS:	0 on success, error-code otherwise
+ */
+static int pp2_prs_tunnel_inner_entry_init(struct pp2_port *port, u32 ai, struct mv_pp2x_prs_entry *pe)
+{
+	int rc;
+
+	rc = pp2_prs_tunnel_entry_init(port, pe);
+	if (rc)
+		return rc;
+
+	/* Outer multicast and broadcast are caught by the kernel entries */
+	mv_pp2x_prs_sram_ri_update(pe, MVPP2_PRS_RI_L3_UCAST, MVPP2_PRS_RI_L3_ADDR_MASK);
+	/* Inner header is parsed from scratch */
+	mv_pp2x_prs_sram_ai_update(pe, 0, MVPP2_PRS_IPV4_DIP_AI_BIT | ai);
+	mv_pp2x_prs_tcam_ai_update(pe, MVPP2_PRS_IPV4_DIP_AI_BIT | ai,
+				   MVPP2_PRS_IPV4_DIP_AI_BIT | ai);
+
+	return 0;
+}
+
+/* pp2_prs_tunnel_ipip
+ *
+ * DESCRIPTION:	Configure parser IPv4 in IPv4 tunnel for port
+ *
+ * INPUTS:	port	- port to be configured
+ *
+ * OUTPUTS:	None
+ *
+ * RETURNS:	0 on success, error-code otherwise
+ */
+static int pp2_prs_tunnel_ipip(struct pp2_port *port)
+{
+	struct mv_pp2x_prs_entry pe;
+	int rc;
+
+	rc = pp2_prs_tunnel_ip4_proto(port, IPPROTO_IPIP, MVPP2_PRS_RI_L4_OTHER,
+				      MVPP2_PRS_IPV4_IPIP_AI_BIT, false);
+	if (rc)
+		return rc;
+
+	rc = pp2_prs_tunnel_inner_entry_init(port, MVPP2_PRS_IPV4_IPIP_AI_BIT, &pe);
+	if (rc)
+		return rc;
+
+	/* Inner IPv4 header without options */
+	mv_pp2x_prs_tcam_data_byte_set(&pe, 4, MVPP2_PRS_IPV4_HEAD | MVPP2_PRS_IPV4_IHL,
+				       MVPP2_PRS_IPV4_HEAD_MASK | MVPP2_PRS_IPV4_IHL_MASK);
+
+	/* Set L3 offset to inner header and continue with inner IPv4 protocol */
+	mv_pp2x_prs_sram_offset_set(&pe, MVPP2_PRS_SRAM_UDF_TYPE_L3, 4,
+				    MVPP2_PRS_SRAM_OP_SEL_UDF_ADD);
+	mv_pp2x_prs_sram_shift_set(&pe, 4 + 4, MVPP2_PRS_SRAM_OP_SEL_SHIFT_ADD);
+	mv_pp2x_prs_sram_next_lu_set(&pe, MVPP2_PRS_LU_IP4);
+
+	pp2_prs_tunnel_entry_write(port, &pe);
+
+	return 0;
+}
+
+/* pp2_prs_tunnel_gre
+ *
+ * DESCRIPTION:	Configure parser GRE tunnel (no optional fields, IPv4 payload) for port
+ *
+ * INPUTS:	port	- port to be configured
+ *
+ * OUTPUTS:	None
+ *
+ * RETURNS:	0 on success, error-code otherwise
+ */
+static int pp2_prs_tunnel_gre(struct pp2_port *port)
+{
+	struct mv_pp2x_prs_entry pe;
+	int rc;
+
+	rc = pp2_prs_tunnel_ip4_proto(port, IPPROTO_GRE, MVPP2_PRS_RI_L4_OTHER,
+				      MVPP2_PRS_IPV4_GRE_AI_BIT, false);
+	if (rc)
+		return rc;
+
+	rc = pp2_prs_tunnel_inner_entry_init(port, MVPP2_PRS_IPV4_GRE_AI_BIT, &pe);
+	if (rc)
+		return rc;
+
+	/* No checksum, key or sequence number, version 0 */
+	mv_pp2x_prs_tcam_data_byte_set(&pe, 4, 0x00, 0xff);
+	mv_pp2x_prs_tcam_data_byte_set(&pe, 5, 0x00, 0xff);
+	mv_pp2x_prs_match_etype(&pe, 6, MVPP2_PRS_GRE_PROTO_IP);
+
+	/* Set L3 offset to inner header and continue with inner IPv4 protocol */
+	mv_pp2x_prs_sram_offset_set(&pe, MVPP2_PRS_SRAM_UDF_TYPE_L3,
+				    4 + MVPP2_PRS_GRE_HDR_LEN,
+				    MVPP2_PRS_SRAM_OP_SEL_UDF_ADD);
+	mv_pp2x_prs_sram_shift_set(&pe, 4 + MVPP2_PRS_GRE_HDR_LEN + 4,
+				   MVPP2_PRS_SRAM_OP_SEL_SHIFT_ADD);
+	mv_pp2x_prs_sram_next_lu_set(&pe, MVPP2_PRS_LU_IP4);
+
+	pp2_prs_tunnel_entry_write(port, &pe);
+
+	return 0;
+}
+
+/* pp2_prs_tunnel_vxlan
+ *
+ * DESCRIPTION:	Configure parser VXLAN tunnel for port.
+ *		The kernel UDP entries precede the MUSDK entries in the TCAM, so
+ *		port is removed from them and replaced by port specific entries.
+ *
+ * INPUTS:	port	- port to be configured
+ *
+ * OUTPUTS:	None
+ *
+ * RETURNS:	0 on success, error-code otherwise
+ */
+static int pp2_prs_tunnel_vxlan(struct pp2_port *port)
+{
+	struct mv_pp2x_prs_entry pe;
+	struct pp2_inst *inst = port->parent;
+	struct mv_pp2x_prs_shadow *prs_shadow = inst->cls_db->prs_db.prs_shadow;
+	uintptr_t cpu_slot = pp2_default_cpu_slot(inst);
+	struct prs_lkp_tcam_list tcam_list;
+	int rc, i;
+
+	memset(&tcam_list, 0, sizeof(struct prs_lkp_tcam_list));
+
+	/* get the kernel indexes with lookup id MVPP2_PRS_LU_IP4 and proto UDP */
+	pp2_prs_tcam_lk_idx_list_get(inst, MVPP2_PRS_LU_IP4, IPPROTO_UDP, &tcam_list);
+
+	/* step 1: Not fragmented packet, look into UDP header */
+	rc = pp2_prs_tunnel_ip4_proto(port, IPPROTO_UDP, MVPP2_PRS_RI_L4_UDP,
+				      MVPP2_PRS_IPV4_VXLAN_AI_BIT, false);
+	if (rc)
+		return rc;
+
+	/* step 2: Fragmented packet */
+	rc = pp2_prs_tunnel_ip4_proto(port, IPPROTO_UDP, MVPP2_PRS_RI_L4_UDP, 0, true);
+	if (rc)
+		return rc;
+
+	/* step 3: VXLAN destination port */
+	rc = pp2_prs_tunnel_inner_entry_init(port, MVPP2_PRS_IPV4_VXLAN_AI_BIT, &pe);
+	if (rc)
+		return rc;
+
+	mv_pp2x_prs_match_etype(&pe, 6, MVPP2_PRS_VXLAN_UDP_PORT);
+
+	/* Continue with inner ethertype */
+	mv_pp2x_prs_sram_shift_set(&pe, 4 + MVPP2_PRS_UDP_HDR_LEN + MVPP2_PRS_VXLAN_HDR_LEN + 2 * ETH_ALEN,
+				   MVPP2_PRS_SRAM_OP_SEL_SHIFT_ADD);
+	mv_pp2x_prs_sram_next_lu_set(&pe, MVPP2_PRS_LU_L2);
+
+	pp2_prs_tunnel_entry_write(port, &pe);
+
+	/* Remove port from kernel UDP entries */
+	for (i = 0; i < tcam_list.size; i++) {
+		if (!prs_shadow[tcam_list.idx[i]].valid_in_kernel || tcam_list.log_port[i])
+			continue;
+		pe.index = tcam_list.idx[i];
+		mv_pp2x_prs_hw_read(cpu_slot, &pe);
+		mv_pp2x_prs_tcam_port_set(&pe, port->id, false);
+		mv_pp2x_prs_hw_write(cpu_slot, &pe);
+	}
+	port->prs_tunnels |= PP2_PPIO_TUNNEL_VXLAN;
+
+	return 0;
+}
+
+/* pp2_prs_tunnel_remove
+ *
+ * DESCRIPTION:	Remove the parser entries added for tunnel parsing of port,
+ *		and return port to the kernel UDP entries if it was removed from
+ *		them for VXLAN.
+ *
+ * INPUTS:	port	- port to be configured
+ *
+ * OUTPUTS:	None
+ *
+ * RETURNS:	None
+ */
+void pp2_prs_tunnel_remove(struct pp2_port *port)
+{
+	struct mv_pp2x_prs_entry pe;
+	struct pp2_inst *inst = port->parent;
+	struct mv_pp2x_prs_shadow *prs_shadow;
+	uintptr_t cpu_slot = pp2_default_cpu_slot(inst);
+	struct prs_lkp_tcam_list tcam_list;
+	int tid, i;
+
+	if (!port->num_prs_tunnel_tids)
+		return;
+
+	prs_shadow = inst->cls_db->prs_db.prs_shadow;
+	for (i = 0; i < port->num_prs_tunnel_tids; i++) {
+		tid = port->prs_tunnel_tid[i];
+		pr_debug("parser: removing tunnel idx %d\n", tid);
+		mv_pp2x_prs_hw_inv(cpu_slot, tid);
+		memset(&prs_shadow[tid], 0, sizeof(struct mv_pp2x_prs_shadow));
+	}
+	port->num_prs_tunnel_tids = 0;
+
+	if (port->prs_tunnels & PP2_PPIO_TUNNEL_VXLAN) {
+		memset(&tcam_list, 0, sizeof(struct prs_lkp_tcam_list));
+		pp2_prs_tcam_lk_idx_list_get(inst, MVPP2_PRS_LU_IP4, IPPROTO_UDP, &tcam_list);
+		for (i = 0; i < tcam_list.size; i++) {
+			if (!prs_shadow[tcam_list.idx[i]].valid_in_kernel || tcam_list.log_port[i])
+				continue;
+			memset(&pe, 0, sizeof(struct mv_pp2x_prs_entry));
+			pe.index = tcam_list.idx[i];
+			mv_pp2x_prs_hw_read(cpu_slot, &pe);
+			mv_pp2x_prs_tcam_port_set(&pe, port->id, true);
+			mv_pp2x_prs_hw_write(cpu_slot, &pe);
+		}
+	}
+	port->prs_tunnels = 0;
+}
+
 /* pp2_prs_dsa_tag_mode_set
  *
  * DESCRIPTION:	Configure parser DSA entries
@@ -1627,6 +1959,66 @@ int pp2_prs_set_log_port(struct pp2_port *port, struct pp2_ppio_log_port_params
 	return 0;
 }
 
+/* pp2_prs_tunnel_set
+ *
+ * DESCRIPTION:	Configure parser to look into tunnel encapsulations, so that
+ *		L3/L4 offsets and result info refer to the inner headers
+ *
+ * INPUTS:	port	- port to be configured
+ *		tunnels	- bit-mask of enum pp2_ppio_tunnel
+ *
+ * OUTPUTS:	None
+ *
+ * RETURNS:	0 on success, error-code otherwise
+ */
+int pp2_prs_tunnel_set(struct pp2_port *port, u32 tunnels)
+{
+	int rc;
+
+	if (mv_pp2x_ptr_validate(port))
+		return -EINVAL;
+
+	if (tunnels & ~(PP2_PPIO_TUNNEL_IPIP | PP2_PPIO_TUNNEL_GRE | PP2_PPIO_TUNNEL_VXLAN)) {
+		pr_err("invalid tunnel mask 0x%x\n", tunnels);
+		return -EINVAL;
+	}
+
+	if (tunnels && port->type == PP2_PPIO_T_LOG) {
+		pr_err("tunnel parsing is not supported on logical port\n");
+		return -EINVAL;
+	}
+
+	/* Entries of a previous open of the port were removed by pp2_prs_tunnel_remove() */
+	port->prs_tunnels = 0;
+	port->num_prs_tunnel_tids = 0;
+
+	if (tunnels & PP2_PPIO_TUNNEL_IPIP) {
+		rc = pp2_prs_tunnel_ipip(port);
+		if (rc)
+			goto err;
+		port->prs_tunnels |= PP2_PPIO_TUNNEL_IPIP;
+	}
+
+	if (tunnels & PP2_PPIO_TUNNEL_GRE) {
+		rc = pp2_prs_tunnel_gre(port);
+		if (rc)
+			goto err;
+		port->prs_tunnels |= PP2_PPIO_TUNNEL_GRE;
+	}
+
+	if (tunnels & PP2_PPIO_TUNNEL_VXLAN) {
+		rc = pp2_prs_tunnel_vxlan(port);
+		if (rc)
+			goto err;
+	}
+
+	return 0;
+err:
+	/* Do not leave a partial tunnel configuration */
+	pp2_prs_tunnel_remove(port);
+	return rc;
+}
+
 /* pp2_prs_eth_start_hdr_set
  *
  * DESCRIPTION:	Set Marvell's port ethernet start header mode
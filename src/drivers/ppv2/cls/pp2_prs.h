@@ -128,8 +128,11 @@ struct prs_lkp_tcam_list {
 int pp2_cls_prs_init(struct pp2_inst *inst);
 void pp2_cls_prs_deinit(struct pp2_inst *inst);
 int mv_pp2x_prs_flow_id_attr_get(int flow_id);
+int mv_pp2x_prs_hw_read(uintptr_t cpu_slot, struct mv_pp2x_prs_entry *pe);
 int pp2_prs_eth_start_hdr_set(struct pp2_port *port, enum pp2_ppio_eth_start_hdr eth_start_hdr);
 int pp2_prs_set_log_port(struct pp2_port *port, struct pp2_ppio_log_port_params *params);
+int pp2_prs_tunnel_set(struct pp2_port *port, u32 tunnels);
+void pp2_prs_tunnel_remove(struct pp2_port *port);
 
 #endif /*_PP2_CLS_PRS_H_*/
 
@@ -130,12 +130,34 @@ struct pp2_dm_if {
 #define PP2_TXQ_PREFETCH_64     (64)
 
 
+/* Bursts of the average size a descriptor reservation should last */
+#define PP2_TXQ_RSRV_BURSTS	(8)
+
 struct pp2_txq_dm_if {
 	u32 desc_rsrvd;
+	/* Descriptors requested per reservation */
+	u32 rsrv_chunk;
+	/* Sends and descriptors sent since the last reservation */
+	u32 rsrv_sends;
+	u32 rsrv_descs;
+	/* Reservation statistics */
+	u64 rsrv_req;
+	u64 rsrv_partial;
+};
+
+/* RXQ statistics, accumulated in 64-bit from the clear-on-read HW counters */
+struct pp2_rxq_stats {
+	u64 enq_desc;
+	u64 drop_early;
+	u64 drop_fullq;
+	u64 drop_bm;
 };
 
-/* Automatic statistics update threshold (in received packetes) */
-#define PP2_STAT_UPDATE_THRESHOLD	(0xEFFFFFFF)
+/* Port drop statistics, accumulated in 64-bit from the clear-on-read HW counters */
+struct pp2_port_stats {
+	u64 rx_fifo_dropped;
+	u64 rx_cls_dropped;
+};
 
 #define PP2_UPDATE_CNT32(counter, value) {						\
 	counter = ((u64)(counter + value) > UINT_MAX) ? UINT_MAX : counter + value;	\
@@ -171,10 +193,14 @@ struct pp2_tx_queue {
 	/* Virtual addr of the first TXD of the TXD array */
 	struct pp2_desc *desc_virt_arr;
 	struct pp2_txq_dm_if txq_dm_if[PP2_NUM_REGSPACES];
+	/* Reservation chunk bounds; equal when the chunk does not adapt */
+	u32 rsrv_chunk_min;
+	u32 rsrv_chunk_max;
 	/* TXQ statistics */
 	struct pp2_ppio_outq_statistics stats;
-	/* TXQ statistics update threshold */
-	u32 threshold_tx_pkts;
+	/* DM-IF reservation counts at the last statistics reset, the DM-IF counters are never cleared */
+	u64 rsrv_req_base;
+	u64 rsrv_partial_base;
 };
 
 /**
@@ -203,9 +229,7 @@ struct pp2_rx_queue {
 	/* Virtual addr of the first RXD of the RXD array */
 	struct pp2_desc *desc_virt_arr;
 	/* RXQ statistics */
-	struct pp2_ppio_inq_statistics stats;
-	/* RXQ statistics update threshold */
-	u32 threshold_rx_pkts;
+	struct pp2_rxq_stats stats;
 };
 
 /**
@@ -267,6 +291,9 @@ struct pp2_bm_pool {
 
 /* Port default MTU in bytes */
 #define PP2_PORT_DEFAULT_MTU     (1500)
+
+/* Parser entries added for tunnel parsing: 2 for IPIP, 2 for GRE, 3 for VXLAN */
+#define PP2_PORT_PRS_TUNNEL_TIDS	(7)
 /* Port TX FIFO constants */
 
 /* Minimum threshold 256 bytes */
@@ -299,6 +326,8 @@ struct pp2_tc {
 struct pp2_txq_config {
 	u16 size;
 	u16 weight;
+	u16 rsrv_chunk;
+	u16 rsrv_chunk_max;
 };
 
 enum port_status {
@@ -309,6 +338,16 @@ enum port_status {
 	PP2_PORT_MUSDK_LOOPBACK,
 };
 
+/* MAC rate sampling, totals are never reset */
+struct pp2_mac_rate_smpl {
+	u64 usecs;		/* time of the last sample, 0: no sample */
+	u64 rx_frames;
+	u64 rx_octets;
+	u64 rx_errors;
+	u64 tx_frames;
+	u64 tx_octets;
+};
+
 /* PP Port internal structure */
 struct pp2_port {
 	/* Port ID */
@@ -352,12 +391,23 @@ struct pp2_port {
 	char linux_name[16];
 	/* tx_fifo_size in KB */
 	u32 tx_fifo_size;
-	/* Flag to indicate the automatic statistics update */
+	/* Flag to indicate the HW counters are harvested by the statistics collector */
 	int maintain_stats;
 	/* Port statistics */
-	struct pp2_ppio_statistics stats;
+	struct pp2_port_stats stats;
+	/* MAC MIB statistics, accumulated from the clear-on-read HW counters */
+	struct pp2_ppio_mac_statistics mac_stats;
+	/* MAC totals, running and at the last rate sample */
+	struct pp2_mac_rate_smpl mac_tot;
+	struct pp2_mac_rate_smpl mac_smpl;
+	/* MAC rates of the last sample */
+	struct pp2_ppio_mac_rates mac_rates;
 	/* Logical or nic port */
 	enum pp2_ppio_type type;
+	/* Tunnels parsed (enum pp2_ppio_tunnel bit-mask) and the parser entries added for them */
+	u32 prs_tunnels;
+	u32 num_prs_tunnel_tids;
+	int prs_tunnel_tid[PP2_PORT_PRS_TUNNEL_TIDS];
 };
 
 /**
@@ -543,4 +593,7 @@ int pp2_netdev_if_info_get(struct netdev_if_params *netdev_params);
 int pp2_netdev_ifname_get(u32 pp_id, u32 ppio_id, char *ifname);
 int pp2_netdev_if_admin_status_get(u32 pp_id, u32 ppio_id, u32 *admin_status);
 
+int pp2_stats_register(struct pp2_ppio *ppio);
+void pp2_stats_unregister(struct pp2_ppio *ppio);
+
 #endif /* _PP2_H_ */
@@ -51,6 +51,19 @@ int pp2_cls_tbl_init(struct pp2_cls_tbl_params *params, struct pp2_cls_tbl **tbl
 	if (mv_pp2x_ptr_validate(params))
 		return -EINVAL;
 
+	if (params->stats_mode > PP2_CLS_TBL_STATS_M_FRM ||
+	    params->aging_mode > PP2_CLS_TBL_AGING_M_IDLE) {
+		pr_err("invalid statistics or aging mode\n");
+		return -EINVAL;
+	}
+
+	/* Aging relies on the harvested hit counters */
+	if (params->aging_mode != PP2_CLS_TBL_AGING_M_NONE &&
+	    params->stats_mode == PP2_CLS_TBL_STATS_M_NONE) {
+		pr_err("aging requires statistics to be enabled\n");
+		return -EINVAL;
+	}
+
 	rc = pp2_cls_mng_tbl_init(params, tbl, MVPP2_CLS_LKP_MUSDK_CLS);
 	if (rc) {
 		pr_err("cls manager table init error\n");
@@ -109,6 +122,9 @@ int pp2_cls_tbl_add_rule(struct pp2_cls_tbl		*tbl,
 	if (mv_pp2x_ptr_validate(action))
 		return -EINVAL;
 
+	if (tbl->trans)
+		return pp2_cls_mng_trans_rule_stage(tbl, PP2_CLS_MNG_TRANS_OP_ADD, rule, action);
+
 	rc = pp2_cls_mng_rule_add(tbl, rule, action, MVPP2_CLS_LKP_MUSDK_CLS);
 	if (rc)
 		pr_err("cls mng: unable to add rule\n");
@@ -132,6 +148,9 @@ int pp2_cls_tbl_modify_rule(struct pp2_cls_tbl		*tbl,
 	if (mv_pp2x_ptr_validate(action))
 		return -EINVAL;
 
+	if (tbl->trans)
+		return pp2_cls_mng_trans_rule_stage(tbl, PP2_CLS_MNG_TRANS_OP_MODIFY, rule, action);
+
 	rc = pp2_cls_mng_rule_modify(tbl, rule, action);
 	if (rc)
 		pr_err("cls mng: unable to modify rule\n");
@@ -151,9 +170,77 @@ int pp2_cls_tbl_remove_rule(struct pp2_cls_tbl		*tbl,
 	if (mv_pp2x_ptr_validate(rule))
 		return -EINVAL;
 
+	if (tbl->trans)
+		return pp2_cls_mng_trans_rule_stage(tbl, PP2_CLS_MNG_TRANS_OP_REMOVE, rule, NULL);
+
 	rc = pp2_cls_mng_rule_remove(tbl, rule);
 	if (rc)
 		pr_err("cls mng: unable to remove rule\n");
 
 	return rc;
 }
+
+int pp2_cls_tbl_begin(struct pp2_cls_tbl *tbl)
+{
+	/* Para check */
+	if (mv_pp2x_ptr_validate(tbl))
+		return -EINVAL;
+
+	return pp2_cls_mng_trans_begin(tbl);
+}
+
+int pp2_cls_tbl_commit(struct pp2_cls_tbl *tbl, struct pp2_cls_tbl_commit_stats *stats)
+{
+	int rc;
+
+	/* Para check */
+	if (mv_pp2x_ptr_validate(tbl))
+		return -EINVAL;
+
+	rc = pp2_cls_mng_trans_commit(tbl, stats);
+	if (rc)
+		pr_err("cls mng: unable to commit batch update\n");
+
+	return rc;
+}
+
+void pp2_cls_tbl_abort(struct pp2_cls_tbl *tbl)
+{
+	if (mv_pp2x_ptr_validate(tbl))
+		return;
+
+	pp2_cls_mng_trans_abort(tbl);
+}
+
+int pp2_cls_tbl_stats_poll(struct pp2_cls_tbl *tbl, u32 *num_aged)
+{
+	if (mv_pp2x_ptr_validate(tbl))
+		return -EINVAL;
+
+	return pp2_cls_mng_stats_poll(tbl, num_aged);
+}
+
+int pp2_cls_tbl_rule_stats_get(struct pp2_cls_tbl *tbl, struct pp2_cls_tbl_rule *rule,
+			       struct pp2_cls_tbl_rule_stats *stats)
+{
+	if (mv_pp2x_ptr_validate(tbl) || mv_pp2x_ptr_validate(rule) || mv_pp2x_ptr_validate(stats))
+		return -EINVAL;
+
+	return pp2_cls_mng_rule_stats_get(tbl, rule, stats);
+}
+
+int pp2_cls_tbl_top_n_get(struct pp2_cls_tbl *tbl, struct pp2_cls_tbl_rule_stats stats[], u32 *num)
+{
+	if (mv_pp2x_ptr_validate(tbl) || mv_pp2x_ptr_validate(stats) || mv_pp2x_ptr_validate(num))
+		return -EINVAL;
+
+	return pp2_cls_mng_top_n_get(tbl, stats, num);
+}
+
+int pp2_cls_tbl_idle_get(struct pp2_cls_tbl *tbl, u64 idle_ms, struct pp2_cls_tbl_rule_stats stats[], u32 *num)
+{
+	if (mv_pp2x_ptr_validate(tbl) || mv_pp2x_ptr_validate(stats) || mv_pp2x_ptr_validate(num))
+		return -EINVAL;
+
+	return pp2_cls_mng_idle_get(tbl, idle_ms, stats, num);
+}
@@ -1127,6 +1127,29 @@ int pp2_gop_port_events_clear(struct gop_hw *gop, struct pp2_mac_data *mac)
 	return 0;
 }
 
+/* Read and clear the port events, returns 1 when a link change is pending */
+int pp2_gop_port_events_get(struct gop_hw *gop, struct pp2_mac_data *mac)
+{
+	int port_num = mac->gop_index;
+	u32 reg_val;
+
+	switch (mac->phy_mode) {
+	case PHY_INTERFACE_MODE_RGMII:
+	case PHY_INTERFACE_MODE_SGMII:
+	case PHY_INTERFACE_MODE_QSGMII:
+		reg_val = pp2_gop_gmac_read(gop, port_num, PP2_GMAC_INTERRUPT_CAUSE_REG);
+		return (reg_val & PP2_GMAC_INTERRUPT_CAUSE_LINK_CHANGE_MASK) ? 1 : 0;
+	case PHY_INTERFACE_MODE_XAUI:
+	case PHY_INTERFACE_MODE_RXAUI:
+	case PHY_INTERFACE_MODE_KR:
+		reg_val = pp2_gop_xlg_mac_read(gop, port_num, PP2_XLG_INTERRUPT_CAUSE_REG);
+		return (reg_val & PP2_XLG_INTERRUPT_LINK_CHANGE_MASK) ? 1 : 0;
+	default:
+		pr_err("%s: Wrong port mode (%d)", __func__, mac->phy_mode);
+		return -1;
+	}
+}
+
 int pp2_gop_status_show(struct gop_hw *gop, struct pp2_mac_data *mac)
 {
 	int port_num = mac->gop_index;
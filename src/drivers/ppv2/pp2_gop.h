@@ -246,6 +246,7 @@ int pp2_gop_port_regs(struct gop_hw *gop, struct pp2_mac_data *mac);
 int pp2_gop_port_events_mask(struct gop_hw *gop, struct pp2_mac_data *mac);
 int pp2_gop_port_events_unmask(struct gop_hw *gop, struct pp2_mac_data *mac);
 int pp2_gop_port_events_clear(struct gop_hw *gop, struct pp2_mac_data *mac);
+int pp2_gop_port_events_get(struct gop_hw *gop, struct pp2_mac_data *mac);
 int pp2_gop_status_show(struct gop_hw *gop, struct pp2_mac_data *mac);
 int pp2_gop_speed_duplex_get(struct gop_hw *gop, struct pp2_mac_data *mac,
 			     enum pp2_port_speed *speed,
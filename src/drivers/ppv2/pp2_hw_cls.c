@@ -1941,11 +1941,11 @@ int mv_pp2x_cls_c2_seq_set(struct mv_pp2x_cls_c2_entry *c2, int miss, int id)
 		return MV_ERROR;
 
 	if (mv_pp2x_range_validate(id, 0,
-				   MVPP21_CLS2_ACT_SEQ_ATTR_ID_MAX) == MV_ERROR)
+				   MVPP22_CLS2_ACT_SEQ_ATTR_ID_MASK) == MV_ERROR)
 		return MV_ERROR;
 
 	c2->sram.regs.seq_attr = 0;
-	c2->sram.regs.seq_attr = ((id << MVPP21_CLS2_ACT_SEQ_ATTR_ID) | (miss << MVPP21_CLS2_ACT_SEQ_ATTR_MISS_OFF));
+	c2->sram.regs.seq_attr = ((id << MVPP22_CLS2_ACT_SEQ_ATTR_ID) | (miss << MVPP22_CLS2_ACT_SEQ_ATTR_MISS_OFF));
 
 	return 0;
 }
@@ -2027,6 +2027,10 @@ int mv_pp2x_cls_c2_hw_write(uintptr_t cpu_slot, int index,
 	pp2_reg_write(cpu_slot, MVPP2_CLS2_ACT_DUP_ATTR_REG,
 		     c2->sram.regs.rss_attr);
 
+	/* write seq_attr CLSC2_ATTR3 */
+	pp2_reg_write(cpu_slot, MVPP22_CLS2_ACT_SEQ_ATTR_REG,
+		     c2->sram.regs.seq_attr);
+
 	return 0;
 }
 
@@ -2063,7 +2067,7 @@ int mv_pp2x_cls_c2_hw_read(uintptr_t cpu_slot, int index, struct mv_pp2x_cls_c2_
 	c2->sram.regs.qos_attr = pp2_reg_read(cpu_slot, MVPP2_CLS2_ACT_QOS_ATTR_REG);
 	c2->sram.regs.hwf_attr = pp2_reg_read(cpu_slot, MVPP2_CLS2_ACT_HWF_ATTR_REG);
 	c2->sram.regs.rss_attr = pp2_reg_read(cpu_slot, MVPP2_CLS2_ACT_DUP_ATTR_REG);
-	c2->sram.regs.seq_attr = pp2_reg_read(cpu_slot, MVPP21_CLS2_ACT_SEQ_ATTR_REG);
+	c2->sram.regs.seq_attr = pp2_reg_read(cpu_slot, MVPP22_CLS2_ACT_SEQ_ATTR_REG);
 
 	return 0;
 }
@@ -2455,8 +2459,8 @@ int mv_pp2x_c2_sw_dump(struct mv_pp2x_cls_c2_entry *c2)
 	/*PPv2.1 new feature MAS 3.14*/
 	printf("SEQ_ATTR:		ID	MISS\n");
 	printf("			0x%2.2x    0x%2.2x\n",
-	      ((c2->sram.regs.seq_attr & MVPP21_CLS2_ACT_SEQ_ATTR_ID_MASK) >> MVPP21_CLS2_ACT_SEQ_ATTR_ID),
-	      ((c2->sram.regs.seq_attr & MVPP21_CLS2_ACT_SEQ_ATTR_MISS_MASK) >> MVPP21_CLS2_ACT_SEQ_ATTR_MISS_OFF));
+	      ((c2->sram.regs.seq_attr & MVPP22_CLS2_ACT_SEQ_ATTR_ID_MASK) >> MVPP22_CLS2_ACT_SEQ_ATTR_ID),
+	      ((c2->sram.regs.seq_attr & MVPP22_CLS2_ACT_SEQ_ATTR_MISS_MASK) >> MVPP22_CLS2_ACT_SEQ_ATTR_MISS_OFF));
 
 	printf("\n\n");
 
@@ -3397,6 +3401,39 @@ int pp2_cls_c3_hw_miss_add(uintptr_t cpu_slot, struct pp2_cls_c3_entry *c3, int
 	return 0;
 }
 
+/*-------------------------------------------------------------------------------*/
+/*	Rewrite the action of a valid hash table entry, the key is left in place	  */
+/*-------------------------------------------------------------------------------*/
+int pp2_cls_c3_hw_action_update(uintptr_t cpu_slot, struct pp2_cls_c3_entry *c3, int index)
+{
+	u32 reg_val = 0;
+
+	if (mv_pp2x_ptr_validate(c3))
+		return -EINVAL;
+
+	if (mv_pp2x_range_validate(index, 0, MVPP2_CLS3_HASH_OP_TBL_ADDR_MAX))
+		return -EINVAL;
+
+	if (pp2_cls_c3_shadow_tbl[index].size == 0) {
+		pr_err("%s: entry %d not in use\n", __func__, index);
+		return -ENOENT;
+	}
+
+	/* select the entry, no hash operation is triggered */
+	reg_val |= (index << MVPP2_CLS3_HASH_OP_TBL_ADDR);
+	pp2_reg_write(cpu_slot, MVPP2_CLS3_HASH_OP_REG, reg_val);
+
+	/* write action table registers */
+	pp2_reg_write(cpu_slot, MVPP2_CLS3_ACT_REG, c3->sram.regs.actions);
+	pp2_reg_write(cpu_slot, MVPP2_CLS3_ACT_QOS_ATTR_REG, c3->sram.regs.qos_attr);
+	pp2_reg_write(cpu_slot, MVPP2_CLS3_ACT_HWF_ATTR_REG, c3->sram.regs.hwf_attr);
+	pp2_reg_write(cpu_slot, MVPP2_CLS3_ACT_DUP_ATTR_REG, c3->sram.regs.dup_attr);
+	pp2_reg_write(cpu_slot, MVPP2_CLS3_ACT_SEQ_L_ATTR_REG, c3->sram.regs.seq_l_attr);
+	pp2_reg_write(cpu_slot, MVPP2_CLS3_ACT_SEQ_H_ATTR_REG, c3->sram.regs.seq_h_attr);
+
+	return 0;
+}
+
 /*-------------------------------------------------------------------------------*/
 int pp2_cls_c3_hw_del(uintptr_t cpu_slot, int index)
 {
@@ -3519,7 +3556,7 @@ static int pp2_cls_c3_hw_query_add_relocate(uintptr_t cpu_slot, int new_idx, int
 	ret_val = pp2_cls_c3_hw_add(cpu_slot, &local_c3, index_free, local_c3.ext_index);
 
 	/* update the hash pair */
-	if (!hash_pair_arr) {
+	if (hash_pair_arr) {
 		hash_pair_arr->old_idx[hash_pair_arr->pair_num] = new_idx;
 		hash_pair_arr->new_idx[hash_pair_arr->pair_num] = index_free;
 		hash_pair_arr->pair_num++;
@@ -3598,6 +3635,58 @@ int pp2_cls_c3_hw_query_add(uintptr_t cpu_slot, struct pp2_cls_c3_entry *c3, int
 	return 0;
 }
 
+/*-------------------------------------------------------------------------------*/
+/* Add entry at a planned index, relocating the keys of hash_pair_arr in order	  */
+/* first. Every relocation target must be free when it is written.		  */
+/*-------------------------------------------------------------------------------*/
+int pp2_cls_c3_hw_planned_add(uintptr_t cpu_slot, struct pp2_cls_c3_entry *c3, int index,
+			      struct pp2_cls_c3_hash_pair *hash_pair_arr)
+{
+	struct pp2_cls_c3_entry local_c3;
+	int idx, hek_size, ret_val, ext_index = 0;
+
+	if (mv_pp2x_ptr_validate(c3) || mv_pp2x_ptr_validate(hash_pair_arr))
+		return -EINVAL;
+
+	hek_size = ((c3->key.key_ctrl & KEY_CTRL_HEK_SIZE_MASK) >> KEY_CTRL_HEK_SIZE);
+
+	if (hek_size > MVPP2_CLS_C3_HEK_BYTES) {
+		/* Get Free Extension Index, before any relocation is written to HW.
+		 * Relocated entries keep their extension index.
+		 */
+		ext_index = pp2_cls_c3_shadow_ext_free_get();
+
+		if (ext_index == MVPP2_CLS_C3_EXT_TBL_SIZE) {
+			pr_err("%s:Error - Extension table is full.\n", __func__);
+			return -EIO;
+		}
+	}
+
+	for (idx = 0; idx < hash_pair_arr->pair_num; idx++) {
+		pp2_cls_c3_sw_clear(&local_c3);
+		ret_val = pp2_cls_c3_hw_read(cpu_slot, &local_c3, hash_pair_arr->old_idx[idx]);
+		if (ret_val) {
+			pr_err("%s could not get key for index [0x%x]\n", __func__, hash_pair_arr->old_idx[idx]);
+			return ret_val;
+		}
+
+		/*We do not chage extension tabe*/
+		ret_val = pp2_cls_c3_hw_add(cpu_slot, &local_c3, hash_pair_arr->new_idx[idx], local_c3.ext_index);
+		if (ret_val) {
+			pr_err("%s:Error - pp2_cls_c3_hw_add failed\n", __func__);
+			return ret_val;
+		}
+	}
+
+	ret_val = pp2_cls_c3_hw_add(cpu_slot, c3, index, ext_index);
+	if (ret_val != 0) {
+		pr_err("%s:Error - pp2_cls_c3_hw_add failed\n", __func__);
+		return ret_val;
+	}
+
+	return 0;
+}
+
 /*-------------------------------------------------------------------------------*/
 /*	if index or occupied_bmp is NULL dump the data					  */
 /*	index[] size must be 8							  */
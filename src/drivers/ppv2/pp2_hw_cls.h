@@ -191,6 +191,7 @@ void pp2_cls_c3_shadow_get(int index, int *hek_size, int *ext_index);
 int pp2_cls_c3_hw_read(uintptr_t cpu_slot, struct pp2_cls_c3_entry *c3, int index);
 int pp2_cls_c3_hw_add(uintptr_t cpu_slot, struct pp2_cls_c3_entry *c3, int index, int ext_index);
 int pp2_cls_c3_hw_miss_add(uintptr_t cpu_slot, struct pp2_cls_c3_entry *c3, int lkp_type);
+int pp2_cls_c3_hw_action_update(uintptr_t cpu_slot, struct pp2_cls_c3_entry *c3, int index);
 int pp2_cls_c3_hw_del(uintptr_t cpu_slot, int index);
 int pp2_cls_c3_hw_del_all(uintptr_t cpu_slot);
 void pp2_cls_c3_sw_clear(struct pp2_cls_c3_entry *c3);
@@ -198,6 +199,8 @@ void pp2_cls_c3_hw_init_ctr_set(int cnt_val);
 int pp2_cls_c3_hw_query(uintptr_t cpu_slot, struct pp2_cls_c3_entry *c3, u8 *occupied_bmp, int index[]);
 int pp2_cls_c3_hw_query_add(uintptr_t cpu_slot, struct pp2_cls_c3_entry *c3, int max_search_depth,
 			    struct pp2_cls_c3_hash_pair *hash_pair_arr);
+int pp2_cls_c3_hw_planned_add(uintptr_t cpu_slot, struct pp2_cls_c3_entry *c3, int index,
+			      struct pp2_cls_c3_hash_pair *hash_pair_arr);
 int pp2_cls_c3_hw_miss_read(uintptr_t cpu_slot, struct pp2_cls_c3_entry *c3, int lkp_type);
 
 /*-------------------------------------------------------------------------------*/
@@ -574,7 +574,7 @@
 #define MVPP22_CLS2_ACT_SEQ_ATTR_ID_MASK	0x0000ffff
 #define MVPP22_CLS2_ACT_SEQ_ATTR_MISS_OFF	16
 #define MVPP22_CLS2_ACT_SEQ_ATTR_MISS_BITS	1
-#define MVPP22_CLS2_ACT_SEQ_ATTR_MISS_MASK	0x0001000
+#define MVPP22_CLS2_ACT_SEQ_ATTR_MISS_MASK	0x00010000
 #define MVPP2_CLS2_TCAM_CFG0_REG		0x1b80
 #define MVPP2_CLS2_TCAM_CFG0_EN_OFF		0
 #define MVPP2_CLS2_TCAM_CFG0_EN_MASK		0x00000001
@@ -1401,6 +1401,11 @@ enum mv_pp2x_tag_type {
 #define MVPP2_PRS_TCAM_PROTO_MASK	0xff
 #define MVPP2_PRS_TCAM_PROTO_MASK_L	0x3f
 #define MVPP2_PRS_DBL_VLANS_MAX		100
+#define MVPP2_PRS_GRE_HDR_LEN		4
+#define MVPP2_PRS_GRE_PROTO_IP		0x0800
+#define MVPP2_PRS_UDP_HDR_LEN		8
+#define MVPP2_PRS_VXLAN_HDR_LEN		8
+#define MVPP2_PRS_VXLAN_UDP_PORT	4789
 
 /* There is TCAM range reserved for MAC entries, range size is 113
  * 1 BC MAC entry for all ports
@@ -1557,6 +1562,9 @@ enum mv_pp2x_tag_type {
 
 /* Sram additional info bits assignment */
 #define MVPP2_PRS_IPV4_DIP_AI_BIT		BIT(0)
+#define MVPP2_PRS_IPV4_IPIP_AI_BIT		BIT(1)
+#define MVPP2_PRS_IPV4_GRE_AI_BIT		BIT(2)
+#define MVPP2_PRS_IPV4_VXLAN_AI_BIT		BIT(3)
 #define MVPP2_PRS_IPV6_NO_EXT_AI_BIT		BIT(0)
 #define MVPP2_PRS_IPV6_EXT_AI_BIT		BIT(1)
 #define MVPP2_PRS_IPV6_EXT_AH_AI_BIT		BIT(2)
@@ -1799,6 +1807,7 @@ enum mv_pp2x_cls_lkp_type {
 	MVPP2_CLS_LKP_MUSDK_DSCP_PRI,
 	MVPP2_CLS_LKP_MUSDK_LOG_PORT_DEF,
 	MVPP2_CLS_LKP_MUSDK_CLS,
+	MVPP2_CLS_LKP_MUSDK_CLS_SEQ,
 	MVPP2_CLS_LKP_MAX,
 };
 
@@ -2316,6 +2325,8 @@ struct mv_pp2x_c2_add_entry {
 	int				rss_en;
 	/* pkt duplication flow info */
 	struct mv_pp2x_duplicate_info	flow_info;
+	/* end the lookup sequence on hit */
+	u8				seq_miss;
 };
 
 struct mv_pp2x_c2_rule_idx {
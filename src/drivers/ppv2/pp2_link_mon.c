@@ -0,0 +1,282 @@
+/******************************************************************************
+ *	Copyright (C) 2016 Marvell International Ltd.
+ *
+ *  If you received this File from Marvell, you may opt to use, redistribute
+ *  and/or modify this File under the following licensing terms.
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *	* Redistributions of source code must retain the above copyright
+ *	  notice, this list of conditions and the following disclaimer.
+ *
+ *	* Redistributions in binary form must reproduce the above copyright
+ *	  notice, this list of conditions and the following disclaimer in the
+ *	  documentation and/or other materials provided with the distribution.
+ *
+ *	* Neither the name of Marvell nor the names of its contributors may be
+ *	  used to endorse or promote products derived from this software
+ *	  without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include "std_internal.h"
+
+#include "pp2_types.h"
+#include "pp2.h"
+#include "pp2_port.h"
+
+/* Default poll interval, in usec */
+#define PP2_LINK_MON_INTERVAL_US	1000
+/* Link state is read from HW at least every REFRESH polls, also without a link event */
+#define PP2_LINK_MON_REFRESH		100
+
+/* Link up flags published to the data path, each in its own cache line */
+struct pp2_link_mon_flag {
+	volatile int up;
+} __attribute__((aligned(L1_CACHE_LINE_BYTES)));
+
+/* Link monitor state of a registered ppio */
+struct pp2_link_mon_ppio {
+	struct pp2_ppio			*ppio;
+	struct pp2_ppio_link_mon_params	params;
+	struct pp2_ppio_link_state	state;
+	u32				polls;
+};
+
+/* Link change to report, copied out of the monitor state to call the callback without the lock */
+struct pp2_link_mon_event {
+	struct pp2_ppio			*ppio;
+	pp2_ppio_link_cb		cb;
+	void				*arg;
+	struct pp2_ppio_link_state	state;
+};
+
+struct pp2_link_mon {
+	spinlock_t			ctrl_lock;	/* serializes register/unregister, held across the
+							 * thread create and join
+							 */
+	spinlock_t			lock;
+	spinlock_t			cb_lock;	/* held by the thread while it calls the callbacks */
+	pthread_t			thread;
+	int				running;
+	u32				interval_us;
+	u32				num_ppios;
+	struct pp2_link_mon_ppio	*ppios[PP2_MAX_NUM_PACKPROCS][PP2_NUM_ETH_PPIO];
+	struct pp2_link_mon_event	events[PP2_MAX_NUM_PACKPROCS * PP2_NUM_ETH_PPIO];
+};
+
+static struct pp2_link_mon link_mon = {
+	.ctrl_lock = PTHREAD_MUTEX_INITIALIZER,
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+	.cb_lock = PTHREAD_MUTEX_INITIALIZER,
+};
+static struct pp2_link_mon_flag link_flags[PP2_MAX_NUM_PACKPROCS][PP2_NUM_ETH_PPIO];
+
+/* Poll a ppio, return 1 and the event to report if its link state changed. Called with the lock held */
+static int pp2_link_mon_poll(struct pp2_link_mon_ppio *mon, struct pp2_link_mon_event *ev)
+{
+	struct pp2_port *port = GET_PPIO_PORT(mon->ppio);
+	struct pp2_ppio_link_state state;
+	int event;
+
+	event = pp2_gop_port_events_get(&port->parent->hw.gop, &port->mac_data);
+	if (event <= 0 && ++mon->polls < PP2_LINK_MON_REFRESH)
+		return 0;
+	mon->polls = 0;
+
+	if (pp2_port_link_state_get(port, &state))
+		return 0;
+
+	if (state.up == mon->state.up && state.speed == mon->state.speed &&
+	    state.full_duplex == mon->state.full_duplex)
+		return 0;
+
+	pr_info("PORT: Port%u - link is %s, %u Mbps, %s duplex\n", port->id,
+		state.up ? "up" : "down", state.speed, state.full_duplex ? "full" : "half");
+	mon->state = state;
+	link_flags[mon->ppio->pp2_id][mon->ppio->port_id].up = state.up;
+
+	if (!mon->params.cb)
+		return 0;
+	ev->ppio = mon->ppio;
+	ev->cb = mon->params.cb;
+	ev->arg = mon->params.arg;
+	ev->state = state;
+	return 1;
+}
+
+static void *pp2_link_mon_thread(void *arg)
+{
+	struct pp2_link_mon *mon = (struct pp2_link_mon *)arg;
+	struct pp2_link_mon_event *ev;
+	u32 interval_us;
+	int i, j, num_events;
+
+	while (1) {
+		spin_lock(&mon->lock);
+		if (!mon->running) {
+			spin_unlock(&mon->lock);
+			break;
+		}
+		num_events = 0;
+		for (i = 0; i < PP2_MAX_NUM_PACKPROCS; i++)
+			for (j = 0; j < PP2_NUM_ETH_PPIO; j++)
+				if (mon->ppios[i][j])
+					num_events += pp2_link_mon_poll(mon->ppios[i][j], &mon->events[num_events]);
+		interval_us = mon->interval_us;
+		/* taken before the lock is released, so an unregister waits for the callbacks of this poll */
+		spin_lock(&mon->cb_lock);
+		spin_unlock(&mon->lock);
+
+		for (ev = mon->events; ev < &mon->events[num_events]; ev++)
+			ev->cb(ev->ppio, &ev->state, ev->arg);
+		spin_unlock(&mon->cb_lock);
+
+		usleep(interval_us);
+	}
+
+	return NULL;
+}
+
+/* Set the poll interval to the smallest interval of the registered ppios. Called with the lock held */
+static void pp2_link_mon_interval_upd(struct pp2_link_mon *mon)
+{
+	u32 interval_us = 0;
+	int i, j;
+
+	for (i = 0; i < PP2_MAX_NUM_PACKPROCS; i++)
+		for (j = 0; j < PP2_NUM_ETH_PPIO; j++)
+			if (mon->ppios[i][j] &&
+			    (!interval_us || mon->ppios[i][j]->params.interval_us < interval_us))
+				interval_us = mon->ppios[i][j]->params.interval_us;
+
+	mon->interval_us = interval_us ? interval_us : PP2_LINK_MON_INTERVAL_US;
+}
+
+int pp2_ppio_get_link_state(struct pp2_ppio *ppio, struct pp2_ppio_link_state *state)
+{
+	struct pp2_port *port = GET_PPIO_PORT(ppio);
+
+	if (!state)
+		return -EINVAL;
+
+	return pp2_port_link_state_get(port, state);
+}
+
+int pp2_ppio_link_monitor_register(struct pp2_ppio *ppio, struct pp2_ppio_link_mon_params *params)
+{
+	struct pp2_port *port = GET_PPIO_PORT(ppio);
+	struct pp2_link_mon_ppio *mon;
+	int rc;
+
+	if (port->type == PP2_PPIO_T_LOG) {
+		pr_err("[%s] link monitor not supported on a logical port\n", __func__);
+		return -ENOTSUP;
+	}
+
+	spin_lock(&link_mon.ctrl_lock);
+	spin_lock(&link_mon.lock);
+	if (link_mon.ppios[ppio->pp2_id][ppio->port_id]) {
+		rc = -EEXIST;
+		pr_err("[%s] ppio already registered\n", __func__);
+		goto err;
+	}
+
+	mon = kcalloc(1, sizeof(*mon), GFP_KERNEL);
+	if (!mon) {
+		rc = -ENOMEM;
+		goto err;
+	}
+	mon->ppio = ppio;
+	if (params)
+		mon->params = *params;
+
+	/* initial state, published without a callback */
+	pp2_gop_port_events_get(&port->parent->hw.gop, &port->mac_data);
+	rc = pp2_port_link_state_get(port, &mon->state);
+	if (rc) {
+		kfree(mon);
+		goto err;
+	}
+	link_flags[ppio->pp2_id][ppio->port_id].up = mon->state.up;
+
+	link_mon.ppios[ppio->pp2_id][ppio->port_id] = mon;
+	link_mon.num_ppios++;
+	pp2_link_mon_interval_upd(&link_mon);
+
+	if (!link_mon.running) {
+		link_mon.running = 1;
+		rc = pthread_create(&link_mon.thread, NULL, pp2_link_mon_thread, &link_mon);
+		if (rc) {
+			pr_err("[%s] failed to create the link monitor thread (%d)\n", __func__, rc);
+			link_mon.running = 0;
+			link_mon.ppios[ppio->pp2_id][ppio->port_id] = NULL;
+			link_mon.num_ppios--;
+			kfree(mon);
+			rc = -rc;
+			goto err;
+		}
+	}
+	spin_unlock(&link_mon.lock);
+	spin_unlock(&link_mon.ctrl_lock);
+
+	return 0;
+
+err:
+	spin_unlock(&link_mon.lock);
+	spin_unlock(&link_mon.ctrl_lock);
+	return rc;
+}
+
+int pp2_ppio_link_monitor_unregister(struct pp2_ppio *ppio)
+{
+	struct pp2_link_mon_ppio *mon;
+	int stop = 0;
+
+	/* held until the thread is joined, so a register can not start a thread meanwhile */
+	spin_lock(&link_mon.ctrl_lock);
+	spin_lock(&link_mon.lock);
+	mon = link_mon.ppios[ppio->pp2_id][ppio->port_id];
+	if (!mon) {
+		spin_unlock(&link_mon.lock);
+		spin_unlock(&link_mon.ctrl_lock);
+		return -ENOENT;
+	}
+
+	link_mon.ppios[ppio->pp2_id][ppio->port_id] = NULL;
+	link_mon.num_ppios--;
+	pp2_link_mon_interval_upd(&link_mon);
+	if (!link_mon.num_ppios) {
+		link_mon.running = 0;
+		stop = 1;
+	}
+	spin_unlock(&link_mon.lock);
+
+	if (stop) {
+		pthread_join(link_mon.thread, NULL);
+	} else {
+		/* wait for a callback of the ppio the thread may be calling */
+		spin_lock(&link_mon.cb_lock);
+		spin_unlock(&link_mon.cb_lock);
+	}
+	spin_unlock(&link_mon.ctrl_lock);
+	kfree(mon);
+
+	return 0;
+}
+
+const volatile int *pp2_ppio_get_link_flag(struct pp2_ppio *ppio)
+{
+	return &link_flags[ppio->pp2_id][ppio->port_id].up;
+}
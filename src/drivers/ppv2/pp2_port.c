@@ -49,6 +49,7 @@
 #include "pp2_port.h"
 #include "pp2_bm.h"
 #include "pp2_hw_cls.h"
+#include "pp2_gop_def.h"
 #include "pp2_gop_dbg.h"
 
 /*
@@ -462,8 +463,16 @@ pp2_txq_init(struct pp2_port *port, struct pp2_tx_queue *txq)
 		pp2_reg_read(cpu_slot, MVPP22_TXQ_SENT_REG(txq->id));
 	}
 
+	/* The HW reservations of all DM-IFs were cleared above */
+	txq->rsrv_chunk_min = port->txq_config[txq->log_id].rsrv_chunk;
+	txq->rsrv_chunk_max = port->txq_config[txq->log_id].rsrv_chunk_max;
+	memset(txq->txq_dm_if, 0, sizeof(txq->txq_dm_if));
+	for (j = 0; j < PP2_NUM_REGSPACES; j++)
+		txq->txq_dm_if[j].rsrv_chunk = txq->rsrv_chunk_min;
+
 	memset(&txq->stats, 0, sizeof(txq->stats));
-	txq->threshold_tx_pkts = 0;
+	txq->rsrv_req_base = 0;
+	txq->rsrv_partial_base = 0;
 }
 
 /* Initializes and sets TXQ related registers for all TXQs
@@ -615,7 +624,6 @@ pp2_rxq_init(struct pp2_port *port, struct pp2_rx_queue *rxq)
 	pp2_reg_write(cpu_slot, MVPP2_RXQ_STATUS_UPDATE_REG(rxq->id), val);
 
 	memset(&rxq->stats, 0, sizeof(rxq->stats));
-	rxq->threshold_rx_pkts = 0;
 }
 
 /* Initializes and sets RXQ related registers for all RXQs
@@ -1182,8 +1190,22 @@ pp2_port_open(struct pp2 *pp2, struct pp2_ppio_params *param, u8 pp2_id, u8 port
 	port->num_rx_queues = total_num_in_qs;
 	port->num_tx_queues = param->outqs_params.num_outqs;
 	for (i = 0; i < port->num_tx_queues; i++) {
-		port->txq_config[i].size = param->outqs_params.outqs_params[i].size;
-		port->txq_config[i].weight = param->outqs_params.outqs_params[i].weight;
+		struct pp2_ppio_outq_params *outq_params = &param->outqs_params.outqs_params[i];
+		struct pp2_txq_config *txq_config = &port->txq_config[i];
+
+		txq_config->size = outq_params->size;
+		txq_config->weight = outq_params->weight;
+		txq_config->rsrv_chunk = outq_params->rsrv_chunk ? outq_params->rsrv_chunk : MVPP2_CPU_DESC_CHUNK;
+		txq_config->rsrv_chunk_max = outq_params->rsrv_chunk_max ?
+					     outq_params->rsrv_chunk_max : txq_config->rsrv_chunk;
+		if (txq_config->rsrv_chunk_max < txq_config->rsrv_chunk ||
+		    txq_config->rsrv_chunk_max > MVPP2_TXQ_RSVD_RSLT_MASK ||
+		    ((outq_params->rsrv_chunk || outq_params->rsrv_chunk_max) &&
+		     txq_config->rsrv_chunk_max > txq_config->size / 2)) {
+			pr_err("[%s] outq %d: invalid reservation chunk %u-%u for size %u\n", __func__, i,
+			       txq_config->rsrv_chunk, txq_config->rsrv_chunk_max, txq_config->size);
+			return -EINVAL;
+		}
 	}
 
 	for (i = 0; i < PP2_PPIO_MAX_NUM_HASH; i++)
@@ -1348,6 +1370,29 @@ static inline void pp2_port_tx_desc_swap_ncopy(struct pp2_desc *dst, struct pp2_
 }
 
 /* Enqueue implementation */
+/* Called on each reservation request of a DM-IF: a chunk that lasts fewer than
+ * PP2_TXQ_RSRV_BURSTS sends of the average size since the previous request grows,
+ * up to the outq max; a partial grant means the outq is short of descriptors, and
+ * halves the chunk, down to the outq min.
+ */
+static inline void pp2_txq_rsrv_chunk_adapt(struct pp2_tx_queue *txq, struct pp2_txq_dm_if *txq_dm_if, int partial)
+{
+	u32 chunk;
+
+	if (unlikely(partial)) {
+		chunk = max(txq_dm_if->rsrv_chunk / 2, txq->rsrv_chunk_min);
+	} else if (txq_dm_if->rsrv_sends) {
+		chunk = txq_dm_if->rsrv_descs / txq_dm_if->rsrv_sends * PP2_TXQ_RSRV_BURSTS;
+		chunk = min(max(chunk, txq_dm_if->rsrv_chunk), txq->rsrv_chunk_max);
+	} else {
+		chunk = txq_dm_if->rsrv_chunk;
+	}
+
+	txq_dm_if->rsrv_chunk = chunk;
+	txq_dm_if->rsrv_sends = 0;
+	txq_dm_if->rsrv_descs = 0;
+}
+
 uint16_t pp2_port_enqueue(struct pp2_port *port, struct pp2_dm_if *dm_if, uint8_t out_qid, uint16_t num_txds,
 			  struct pp2_ppio_desc desc[])
 {
@@ -1389,13 +1434,18 @@ uint16_t pp2_port_enqueue(struct pp2_port *port, struct pp2_dm_if *dm_if, uint8_
 	if (unlikely(txq_dm_if->desc_rsrvd < num_txds)) {
 		u32 req_val, result_val, res_req;
 
-		res_req = max((uint32_t)(num_txds - txq_dm_if->desc_rsrvd), (uint32_t)MVPP2_CPU_DESC_CHUNK);
+		res_req = max((uint32_t)(num_txds - txq_dm_if->desc_rsrvd), txq_dm_if->rsrv_chunk);
 
 		req_val = ((txq->id << MVPP2_TXQ_RSVD_REQ_Q_OFFSET) | res_req);
 		pp2_relaxed_reg_write(cpu_slot, MVPP2_TXQ_RSVD_REQ_REG, req_val);
 		result_val = pp2_relaxed_reg_read(cpu_slot, MVPP2_TXQ_RSVD_RSLT_REG) & MVPP2_TXQ_RSVD_RSLT_MASK;
 
 		txq_dm_if->desc_rsrvd += result_val;
+		txq_dm_if->rsrv_req++;
+		if (unlikely(result_val < res_req))
+			txq_dm_if->rsrv_partial++;
+		if (txq->rsrv_chunk_max > txq->rsrv_chunk_min)
+			pp2_txq_rsrv_chunk_adapt(txq, txq_dm_if, result_val < res_req);
 
 		if (unlikely(txq_dm_if->desc_rsrvd < num_txds)) {
 			pr_debug("%s prev_desc_rsrvd(%d) desc_rsrvd(%d) res_request(%d) num_txds(%d)\n", __func__,
@@ -1453,6 +1503,8 @@ uint16_t pp2_port_enqueue(struct pp2_port *port, struct pp2_dm_if *dm_if, uint8_
 	/* Sync reserve count with the AGGR_Q and the Physical TXQ */
 	dm_if->free_count -= num_txds;
 	txq_dm_if->desc_rsrvd -= num_txds;
+	txq_dm_if->rsrv_sends++;
+	txq_dm_if->rsrv_descs += num_txds;
 
 	return num_txds;
 }
@@ -1974,3 +2026,158 @@ int pp2_port_link_status(struct pp2_port *port)
 
 	return link_is_up;
 }
+
+/* Accumulate the MAC MIB counters, each HW counter is cleared when read */
+void pp2_port_mac_stats_update(struct pp2_port *port)
+{
+	struct gop_hw *gop = &port->parent->hw.gop;
+	struct pp2_ppio_mac_statistics *s = &port->mac_stats;
+	struct pp2_mac_rate_smpl *tot = &port->mac_tot;
+	int mac = port->mac_data.gop_index;
+	u64 rx_octets, rx_frames, rx_errors, tx_octets, tx_frames, val;
+
+	rx_octets = pp2_gop_mib_read64(gop, mac, PP2_MIB_GOOD_OCTETS_RECEIVED_LOW);
+	s->rx_good_octets += rx_octets;
+	s->rx_bad_octets += pp2_gop_mib_read64(gop, mac, PP2_MIB_BAD_OCTETS_RECEIVED);
+	s->tx_crc_errors += pp2_gop_mib_read64(gop, mac, PP2_MIB_CRC_ERRORS_SENT);
+	rx_frames = val = pp2_gop_mib_read64(gop, mac, PP2_MIB_UNICAST_FRAMES_RECEIVED);
+	s->rx_unicast += val;
+	rx_frames += val = pp2_gop_mib_read64(gop, mac, PP2_MIB_BROADCAST_FRAMES_RECEIVED);
+	s->rx_broadcast += val;
+	rx_frames += val = pp2_gop_mib_read64(gop, mac, PP2_MIB_MULTICAST_FRAMES_RECEIVED);
+	s->rx_multicast += val;
+
+	s->frames_64 += pp2_gop_mib_read64(gop, mac, PP2_MIB_FRAMES_64_OCTETS);
+	s->frames_65_127 += pp2_gop_mib_read64(gop, mac, PP2_MIB_FRAMES_65_TO_127_OCTETS);
+	s->frames_128_255 += pp2_gop_mib_read64(gop, mac, PP2_MIB_FRAMES_128_TO_255_OCTETS);
+	s->frames_256_511 += pp2_gop_mib_read64(gop, mac, PP2_MIB_FRAMES_256_TO_511_OCTETS);
+	s->frames_512_1023 += pp2_gop_mib_read64(gop, mac, PP2_MIB_FRAMES_512_TO_1023_OCTETS);
+	s->frames_1024_max += pp2_gop_mib_read64(gop, mac, PP2_MIB_FRAMES_1024_TO_MAX_OCTETS);
+
+	tx_octets = pp2_gop_mib_read64(gop, mac, PP2_MIB_GOOD_OCTETS_SENT_LOW);
+	s->tx_good_octets += tx_octets;
+	tx_frames = val = pp2_gop_mib_read64(gop, mac, PP2_MIB_UNICAST_FRAMES_SENT);
+	s->tx_unicast += val;
+	tx_frames += val = pp2_gop_mib_read64(gop, mac, PP2_MIB_MULTICAST_FRAMES_SENT);
+	s->tx_multicast += val;
+	tx_frames += val = pp2_gop_mib_read64(gop, mac, PP2_MIB_BROADCAST_FRAMES_SENT);
+	s->tx_broadcast += val;
+
+	s->tx_fc += pp2_gop_mib_read64(gop, mac, PP2_MIB_FC_SENT);
+	s->rx_fc += pp2_gop_mib_read64(gop, mac, PP2_MIB_FC_RECEIVED);
+	s->rx_fifo_overrun += pp2_gop_mib_read64(gop, mac, PP2_MIB_RX_FIFO_OVERRUN);
+	rx_errors = val = pp2_gop_mib_read64(gop, mac, PP2_MIB_UNDERSIZE_RECEIVED);
+	s->rx_undersize += val;
+	rx_errors += val = pp2_gop_mib_read64(gop, mac, PP2_MIB_FRAGMENTS_RECEIVED);
+	s->rx_fragments += val;
+	rx_errors += val = pp2_gop_mib_read64(gop, mac, PP2_MIB_OVERSIZE_RECEIVED);
+	s->rx_oversize += val;
+	rx_errors += val = pp2_gop_mib_read64(gop, mac, PP2_MIB_JABBER_RECEIVED);
+	s->rx_jabber += val;
+	rx_errors += val = pp2_gop_mib_read64(gop, mac, PP2_MIB_MAC_RECEIVE_ERROR);
+	s->rx_mac_errors += val;
+	rx_errors += val = pp2_gop_mib_read64(gop, mac, PP2_MIB_BAD_CRC_EVENT);
+	s->rx_crc_errors += val;
+	s->collisions += pp2_gop_mib_read64(gop, mac, PP2_MIB_COLLISION);
+	/* This counter must be read last, as in pp2_gop_mib_counters_show() */
+	s->late_collisions += pp2_gop_mib_read64(gop, mac, PP2_MIB_LATE_COLLISION);
+
+	tot->rx_octets += rx_octets;
+	tot->rx_frames += rx_frames;
+	tot->rx_errors += rx_errors;
+	tot->tx_octets += tx_octets;
+	tot->tx_frames += tx_frames;
+}
+
+/* Per second rate of a counter delta over a period, divided first so that a large delta does not overflow */
+static inline u64 pp2_port_rate(u64 delta, u64 usecs)
+{
+	return (delta / usecs) * 1000000 + ((delta % usecs) * 1000000 + usecs / 2) / usecs;
+}
+
+/* Get MAC MIB statistics and rates */
+int pp2_port_get_mac_statistics(struct pp2_port *port, struct pp2_ppio_mac_statistics *stats,
+				struct pp2_ppio_mac_rates *rates, u32 rate_period_ms, int reset)
+{
+	struct pp2_mac_rate_smpl *tot = &port->mac_tot;
+	struct pp2_mac_rate_smpl *smpl = &port->mac_smpl;
+	u64 now, usecs;
+
+	pp2_port_mac_stats_update(port);
+
+	if (rates) {
+		now = mv_time_usecs();
+		usecs = now - smpl->usecs;
+		if (!smpl->usecs) {
+			/* first sample, rates are known on the next one */
+			*smpl = *tot;
+			smpl->usecs = now;
+		} else if (usecs && usecs >= (u64)rate_period_ms * 1000) {
+			port->mac_rates.period_ms = (u32)(usecs / 1000);
+			port->mac_rates.rx_frames = pp2_port_rate(tot->rx_frames - smpl->rx_frames, usecs);
+			port->mac_rates.rx_bits = pp2_port_rate((tot->rx_octets - smpl->rx_octets) * 8, usecs);
+			port->mac_rates.rx_errors = pp2_port_rate(tot->rx_errors - smpl->rx_errors, usecs);
+			port->mac_rates.tx_frames = pp2_port_rate(tot->tx_frames - smpl->tx_frames, usecs);
+			port->mac_rates.tx_bits = pp2_port_rate((tot->tx_octets - smpl->tx_octets) * 8, usecs);
+			*smpl = *tot;
+			smpl->usecs = now;
+		}
+		memcpy(rates, &port->mac_rates, sizeof(*rates));
+	}
+
+	if (stats)
+		memcpy(stats, &port->mac_stats, sizeof(*stats));
+
+	if (reset)
+		memset(&port->mac_stats, 0, sizeof(port->mac_stats));
+
+	return 0;
+}
+
+/* Get link state, speed and duplex */
+int pp2_port_link_state_get(struct pp2_port *port, struct pp2_ppio_link_state *state)
+{
+	struct gop_hw *gop = &port->parent->hw.gop;
+	struct pp2_port_link_status status;
+
+	if (port->use_mac_lb) {
+		/* MAC loopback, no link */
+		state->up = 1;
+		state->speed = 0;
+		state->full_duplex = 1;
+		return 0;
+	}
+
+	if (pp2_gop_port_link_status(gop, &port->mac_data, &status))
+		return -EINVAL;
+
+	state->up = status.linkup ? 1 : 0;
+	state->full_duplex = (status.duplex == PP2_PORT_DUPLEX_FULL) ? 1 : 0;
+	switch (status.speed) {
+	case PP2_PORT_SPEED_10:
+		state->speed = 10;
+		break;
+	case PP2_PORT_SPEED_100:
+		state->speed = 100;
+		break;
+	case PP2_PORT_SPEED_1000:
+		state->speed = 1000;
+		break;
+	case PP2_PORT_SPEED_2500:
+		state->speed = 2500;
+		break;
+	case PP2_PORT_SPEED_10000:
+		state->speed = 10000;
+		break;
+	default:
+		state->speed = 0;
+		break;
+	}
+
+	if (state->up)
+		port->mac_data.flags |= MV_EMAC_F_LINK_UP;
+	else
+		port->mac_data.flags &= ~MV_EMAC_F_LINK_UP;
+
+	return 0;
+}
@@ -436,6 +436,16 @@ int pp2_port_remove_vlan(struct pp2_port *port, u16 vlan);
 /* Enable or disable RSS */
 void pp2_port_set_rss(struct pp2_port *port, uint32_t en);
 
+/* Get link state */
+int pp2_port_link_state_get(struct pp2_port *port, struct pp2_ppio_link_state *state);
+
+/* Accumulate the MAC MIB counters */
+void pp2_port_mac_stats_update(struct pp2_port *port);
+
+/* Get MAC MIB statistics and rates */
+int pp2_port_get_mac_statistics(struct pp2_port *port, struct pp2_ppio_mac_statistics *stats,
+				struct pp2_ppio_mac_rates *rates, u32 rate_period_ms, int reset);
+
 /* Get number of Rx descriptors occupied by received packets */
 static inline uint32_t
 pp2_rxq_received(struct pp2_port *port, const int rxq_id)
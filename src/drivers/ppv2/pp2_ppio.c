@@ -32,6 +32,10 @@
 
 #include "std_internal.h"
 
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 #include "pp2_types.h"
 #include "pp2_hif.h"
 #include "pp2.h"
@@ -102,11 +106,33 @@ int pp2_ppio_init(struct pp2_ppio_params *params, struct pp2_ppio **ppio)
 		}
 	}
 
+	if (params->tunnels) {
+		rc = pp2_cls_mng_set_tunnel_params(*ppio, params);
+		if (rc) {
+			pr_err("[%s] ppio init failed while initialize tunnel parsing\n", __func__);
+			return -EFAULT;
+		}
+	}
+
+	/* HW counters are harvested by the statistics collector, not by the data path */
+	if ((*port)->maintain_stats) {
+		rc = pp2_stats_register(*ppio);
+		if (rc) {
+			pr_err("[%s] ppio init failed while registering to the statistics collector\n", __func__);
+			pp2_cls_mng_clear_tunnel_params(*ppio);
+			return rc;
+		}
+	}
+
 	return rc;
 }
 
 void pp2_ppio_deinit(struct pp2_ppio *ppio)
 {
+	/* a registered ppio is removed from the link monitor */
+	pp2_ppio_link_monitor_unregister(ppio);
+	pp2_stats_unregister(ppio);
+	pp2_cls_mng_clear_tunnel_params(ppio);
 	pp2_port_close(GET_PPIO_PORT(ppio));
 }
 
@@ -129,92 +155,202 @@ void pp2_ppio_outq_desc_set_pool(struct pp2_ppio_desc *desc, struct pp2_bpool *p
 		(pool->id << 16 & TXD_POOL_ID_MASK) | (1 << 7 & TXD_BUFMODE_MASK);
 }
 
-int pp2_ppio_inq_get_statistics(struct pp2_ppio *ppio, u8 tc, u8 qid,
-				struct pp2_ppio_inq_statistics *stats, int reset)
+int pp2_ppio_send(struct pp2_ppio *ppio, struct pp2_hif *hif, u8 qid, struct pp2_ppio_desc *descs, u16 *num)
 {
+	struct pp2_dm_if *dm_if;
+	u16 desc_sent, desc_req = *num;
 	struct pp2_port *port = GET_PPIO_PORT(ppio);
-	uintptr_t cpu_slot = port->cpu_slot;
-	struct pp2_rx_queue *rxq;
-	int log_rxq;
 
-	if (unlikely(qid >= port->tc[tc].tc_config.num_in_qs)) {
-		pr_err("[%s] invalid queue id (%d)!\n", __func__, qid);
-		return -EINVAL;
+	dm_if = pp2_dm_if_get(ppio, hif);
+
+	desc_sent = pp2_port_enqueue(port, dm_if, qid, desc_req, descs);
+	if (unlikely(desc_sent < desc_req)) {
+		pr_debug("[%s] pp2_id %u Port %u qid %u, send_request %u sent %u!\n", __func__,
+			 ppio->pp2_id, ppio->port_id, qid, *num, desc_sent);
+		*num = desc_sent;
 	}
 
-	log_rxq = port->tc[tc].first_log_rxq + qid;
-	rxq = port->rxqs[log_rxq];
+	return 0;
+}
 
-	pp2_relaxed_reg_write(cpu_slot, MVPP2_CNT_IDX_REG, rxq->id);
-	PP2_READ_UPDATE_CNT64(rxq->stats.enq_desc, cpu_slot, MVPP2_RX_DESC_ENQ_REG);
-	PP2_READ_UPDATE_CNT32(rxq->stats.drop_fullq, cpu_slot, MVPP2_RX_PKT_FULLQ_DROP_REG);
-	PP2_READ_UPDATE_CNT32(rxq->stats.drop_early, cpu_slot, MVPP2_RX_PKT_EARLY_DROP_REG);
-	PP2_READ_UPDATE_CNT32(rxq->stats.drop_bm, cpu_slot, MVPP2_RX_PKT_BM_DROP_REG);
+static inline void pp2_ppio_inq_desc_parse(struct pp2_ppio_desc *desc, struct pp2_ppio_inq_burst *burst, u16 i)
+{
+	u32 cmd0 = desc->cmds[0];
+	u8 l3_off = (cmd0 & RXD_L3_OFF_MASK) >> 0;
+	u8 status;
+
+	burst->cookie[i] = ((u64)(desc->cmds[7] & RXD_BUF_VIRT_HI_MASK) << 32) | (desc->cmds[6] & RXD_BUF_VIRT_LO_MASK);
+	burst->phys_addr[i] = ((u64)(desc->cmds[5] & RXD_BUF_PHYS_HI_MASK) << 32) | (desc->cmds[4] & RXD_BUF_PHYS_LO_MASK);
+	burst->len[i] = ((desc->cmds[1] & RXD_BYTE_COUNT_MASK) >> 16) - PP2_MH_SIZE;
+	burst->l3_type[i] = (cmd0 & RXD_L3_PRS_INFO_MASK) >> 28;
+	burst->l3_offset[i] = l3_off - PP2_MH_SIZE;
+	burst->l4_type[i] = (cmd0 & RXD_L4_PRS_INFO_MASK) >> 25;
+	burst->l4_offset[i] = l3_off + sizeof(u32) * ((cmd0 & RXD_IPHDR_LEN_MASK) >> 8) - PP2_MH_SIZE;
+	burst->pool_id[i] = (cmd0 & RXD_POOL_ID_MASK) >> 16;
+
+	/* Same precedence as pp2_ppio_inq_desc_get_pkt_error() */
+	if (unlikely(cmd0 & RXD_ES_MASK))
+		status = 1 + ((cmd0 & RXD_EC_MASK) >> 13);
+	else if (unlikely(cmd0 & RXD_IP_HDR_ERR_MASK))
+		status = PP2_DESC_ERR_IPV4_HDR;
+	else if (likely(cmd0 & RXD_L4_CHK_OK_MASK))
+		status = PP2_DESC_ERR_MAC_OK;
+	else
+		status = PP2_DESC_ERR_L4_CHECKSUM;
+	burst->status[i] = status;
+}
 
-	if (stats)
-		memcpy(stats, &rxq->stats, sizeof(rxq->stats));
+#if defined(__ARM_NEON) && defined(__aarch64__) && defined(MVCONF_ARCH_DMA_ADDR_T_64BIT)
+static inline void pp2_ppio_inq_vst_u8(u8 *dst, uint32x4_t v)
+{
+	uint16x4_t v16 = vmovn_u32(v);
 
-	if (reset)
-		memset(&rxq->stats, 0, sizeof(rxq->stats));
+	vst1_lane_u32((uint32_t *)dst, vreinterpret_u32_u8(vmovn_u16(vcombine_u16(v16, v16))), 0);
+}
 
-	return 0;
+/* Parse descriptors i..i+3: two de-interleaving loads and unzips transpose them so that
+ * w[n] holds word n of the four descriptors.
+ */
+static inline void pp2_ppio_inq_descs_parse4(struct pp2_ppio_desc *descs, struct pp2_ppio_inq_burst *burst, u16 i)
+{
+	uint32x4x4_t a = vld4q_u32(descs[i].cmds);
+	uint32x4x4_t b = vld4q_u32(descs[i + 2].cmds);
+	uint32x4_t w[PP2_PPIO_DESC_NUM_WORDS];
+	uint32x4_t mh = vdupq_n_u32(PP2_MH_SIZE);
+	uint32x4_t lo8 = vdupq_n_u32(0xFF);
+	uint32x4_t l3_off, st;
+	int n;
+
+	for (n = 0; n < 4; n++) {
+		w[n] = vuzp1q_u32(a.val[n], b.val[n]);
+		w[n + 4] = vuzp2q_u32(a.val[n], b.val[n]);
+	}
+
+	vst1q_u64(&burst->cookie[i],
+		  vreinterpretq_u64_u32(vzip1q_u32(w[6], vandq_u32(w[7], lo8))));
+	vst1q_u64(&burst->cookie[i + 2],
+		  vreinterpretq_u64_u32(vzip2q_u32(w[6], vandq_u32(w[7], lo8))));
+	vst1q_u64((uint64_t *)&burst->phys_addr[i],
+		  vreinterpretq_u64_u32(vzip1q_u32(w[4], vandq_u32(w[5], lo8))));
+	vst1q_u64((uint64_t *)&burst->phys_addr[i + 2],
+		  vreinterpretq_u64_u32(vzip2q_u32(w[4], vandq_u32(w[5], lo8))));
+
+	vst1_u16(&burst->len[i], vmovn_u32(vsubq_u32(vshrq_n_u32(w[1], 16), mh)));
+
+	l3_off = vandq_u32(w[0], vdupq_n_u32(RXD_L3_OFF_MASK));
+	pp2_ppio_inq_vst_u8(&burst->l3_offset[i], vsubq_u32(l3_off, mh));
+	pp2_ppio_inq_vst_u8(&burst->l4_offset[i],
+			    vsubq_u32(vaddq_u32(l3_off, vshrq_n_u32(vandq_u32(w[0], vdupq_n_u32(RXD_IPHDR_LEN_MASK)), 6)),
+				      mh));
+	pp2_ppio_inq_vst_u8(&burst->l3_type[i], vshrq_n_u32(vandq_u32(w[0], vdupq_n_u32(RXD_L3_PRS_INFO_MASK)), 28));
+	pp2_ppio_inq_vst_u8(&burst->l4_type[i], vshrq_n_u32(vandq_u32(w[0], vdupq_n_u32(RXD_L4_PRS_INFO_MASK)), 25));
+	pp2_ppio_inq_vst_u8(&burst->pool_id[i], vshrq_n_u32(vandq_u32(w[0], vdupq_n_u32(RXD_POOL_ID_MASK)), 16));
+
+	/* Lowest precedence first, as in pp2_ppio_inq_desc_get_pkt_error() */
+	st = vbslq_u32(vtstq_u32(w[0], vdupq_n_u32(RXD_L4_CHK_OK_MASK)),
+		       vdupq_n_u32(PP2_DESC_ERR_MAC_OK), vdupq_n_u32(PP2_DESC_ERR_L4_CHECKSUM));
+	st = vbslq_u32(vtstq_u32(w[0], vdupq_n_u32(RXD_IP_HDR_ERR_MASK)), vdupq_n_u32(PP2_DESC_ERR_IPV4_HDR), st);
+	st = vbslq_u32(vtstq_u32(w[0], vdupq_n_u32(RXD_ES_MASK)),
+		       vaddq_u32(vshrq_n_u32(vandq_u32(w[0], vdupq_n_u32(RXD_EC_MASK)), 13), vdupq_n_u32(1)), st);
+	pp2_ppio_inq_vst_u8(&burst->status[i], st);
 }
+#endif
 
-int pp2_ppio_outq_get_statistics(struct pp2_ppio *ppio, u8 qid,
-				 struct pp2_ppio_outq_statistics *stats, int reset)
+int pp2_ppio_inq_descs_parse(struct pp2_ppio_desc *descs, u16 num, struct pp2_ppio_inq_burst *burst)
 {
-	struct pp2_port *port = GET_PPIO_PORT(ppio);
-	uintptr_t cpu_slot = port->cpu_slot;
-	struct pp2_tx_queue *txq;
+	u16 i = 0;
 
-	if (unlikely(qid >= port->num_tx_queues)) {
-		pr_err("[%s] invalid queue id (%d)!\n", __func__, qid);
+	if (unlikely(num > PP2_PPIO_INQ_BURST_MAX)) {
+		pr_err("[%s] burst of %u exceeds %u descriptors!\n", __func__, num, PP2_PPIO_INQ_BURST_MAX);
 		return -EINVAL;
 	}
-	txq = port->txqs[qid];
-
-	pp2_relaxed_reg_write(cpu_slot, MVPP2_CNT_IDX_REG, MVPP2_CNT_IDX_TX(port->id, txq->log_id));
-	PP2_READ_UPDATE_CNT64(txq->stats.enq_desc, cpu_slot, MVPP2_TX_DESC_ENQ_REG);
-	PP2_READ_UPDATE_CNT64(txq->stats.enq_dec_to_ddr, cpu_slot, MVPP2_TX_DESC_ENQ_TO_DRAM_REG);
-	PP2_READ_UPDATE_CNT64(txq->stats.enq_buf_to_ddr, cpu_slot, MVPP2_TX_BUF_ENQ_TO_DRAM_REG);
-	PP2_READ_UPDATE_CNT64(txq->stats.deq_desc, cpu_slot, MVPP2_TX_PKT_DQ_REG);
-
-	if (stats)
-		memcpy(stats, &txq->stats, sizeof(txq->stats));
 
-	if (reset)
-		memset(&txq->stats, 0, sizeof(txq->stats));
+#if defined(__ARM_NEON) && defined(__aarch64__) && defined(MVCONF_ARCH_DMA_ADDR_T_64BIT)
+	for (; i + 4 <= num; i += 4)
+		pp2_ppio_inq_descs_parse4(descs, burst, i);
+#endif
+	for (; i < num; i++)
+		pp2_ppio_inq_desc_parse(&descs[i], burst, i);
 
 	return 0;
-
 }
 
-int pp2_ppio_send(struct pp2_ppio *ppio, struct pp2_hif *hif, u8 qid, struct pp2_ppio_desc *descs, u16 *num)
+/* In-Q parser L3/L4 info to out-Q L3/L4 type */
+static const u8 pp2_fwd_l3_type[8] = {
+	[PP2_INQ_L3_TYPE_NA]		= PP2_OUTQ_L3_TYPE_OTHER,
+	[PP2_INQ_L3_TYPE_IPV4_NO_OPTS]	= PP2_OUTQ_L3_TYPE_IPV4,
+	[PP2_INQ_L3_TYPE_IPV4_OK]	= PP2_OUTQ_L3_TYPE_IPV4,
+	[PP2_INQ_L3_TYPE_IPV4_TTL_ZERO]	= PP2_OUTQ_L3_TYPE_IPV4,
+	[PP2_INQ_L3_TYPE_IPV6_NO_EXT]	= PP2_OUTQ_L3_TYPE_IPV6,
+	[PP2_INQ_L3_TYPE_IPV6_EXT]	= PP2_OUTQ_L3_TYPE_IPV6,
+	[6]				= PP2_OUTQ_L3_TYPE_OTHER,
+	[7]				= PP2_OUTQ_L3_TYPE_OTHER,
+};
+
+static const u8 pp2_fwd_l4_type[8] = {
+	[PP2_INQ_L4_TYPE_NA]		= PP2_OUTQ_L4_TYPE_OTHER,
+	[PP2_INQ_L4_TYPE_TCP]		= PP2_OUTQ_L4_TYPE_TCP,
+	[PP2_INQ_L4_TYPE_UDP]		= PP2_OUTQ_L4_TYPE_UDP,
+	[PP2_INQ_L4_TYPE_OTHER]		= PP2_OUTQ_L4_TYPE_OTHER,
+	[4]				= PP2_OUTQ_L4_TYPE_OTHER,
+	[5]				= PP2_OUTQ_L4_TYPE_OTHER,
+	[6]				= PP2_OUTQ_L4_TYPE_OTHER,
+	[7]				= PP2_OUTQ_L4_TYPE_OTHER,
+};
+
+/* Convert an in-Q descriptor to an out-Q one in place. The buffer address, cookie
+ * and pool ID share their positions in both formats and are left untouched.
+ */
+static inline void pp2_ppio_fwd_desc_conv(struct pp2_ppio_desc *desc, u32 tx_flags, u8 pkt_offset,
+					  int l3_csum, int l4_csum)
 {
-	struct pp2_dm_if *dm_if;
-	u16 desc_sent, desc_req = *num;
-	struct pp2_port *port = GET_PPIO_PORT(ppio);
+	u32 cmd0 = desc->cmds[0];
+	u32 l3_info = (cmd0 & RXD_L3_PRS_INFO_MASK) >> 28;
+	u32 l4_info = (cmd0 & RXD_L4_PRS_INFO_MASK) >> 25;
+	u32 l3_type = pp2_fwd_l3_type[l3_info];
+	u32 l4_type = pp2_fwd_l4_type[l4_info];
+	u32 l3_off = cmd0 & RXD_L3_OFF_MASK;
+	u16 len = (desc->cmds[1] & RXD_BYTE_COUNT_MASK) >> 16;
+	u32 ip_chk = TXD_IP_CHK_DISABLE;
+	u32 l4_chk = TXD_L4_CHK_DISABLE;
+
+	if (l3_csum && l3_type == PP2_OUTQ_L3_TYPE_IPV4)
+		ip_chk = TXD_IP_CHK_ENABLE;
+	if (l4_csum && l4_type != PP2_OUTQ_L4_TYPE_OTHER && !(cmd0 & RXD_L4_IP_FRAG_MASK))
+		l4_chk = TXD_L4_CHK_ENABLE;
+
+	l3_off = (l3_off >= PP2_MH_SIZE) ? (l3_off - PP2_MH_SIZE) : 0;
+	len = (len >= PP2_MH_SIZE) ? (len - PP2_MH_SIZE) : 0;
+
+	desc->cmds[0] = tx_flags |
+			(cmd0 & (RXD_IPHDR_LEN_MASK | RXD_POOL_ID_MASK)) |
+			(l3_off & TXD_L3_OFFSET_MASK) |
+			(l4_chk << 13 & TXD_GEN_L4_CHK_MASK) |
+			(ip_chk << 15 & TXD_GEN_IP_CHK_MASK) |
+			(l4_type << 24 & TXD_L4_TYPE_MASK) |
+			(l3_type << 26 & TXD_L3_TYPE_MASK);
+	desc->cmds[1] = (pkt_offset & TXD_PKT_OFF_MASK) | ((u32)len << 16 & TXD_BYTE_COUNT_MASK);
+	desc->cmds[2] = 0;
+	desc->cmds[3] = 0;
+	desc->cmds[5] &= TXD_BUF_PHYS_HI_MASK;
+	desc->cmds[7] &= TXD_BUF_VIRT_HI_MASK;
+}
 
-	dm_if = pp2_dm_if_get(ppio, hif);
+int pp2_ppio_forward(struct pp2_ppio *ppio, struct pp2_hif *hif, u8 qid, struct pp2_ppio_desc *descs,
+		     u16 *num, u8 pkt_offset, u32 flags)
+{
+	u32 tx_flags = TXD_FIRST_LAST << 28;
+	int l3_csum = !!(flags & PP2_PPIO_FWD_F_L3_CSUM);
+	int l4_csum = !!(flags & PP2_PPIO_FWD_F_L4_CSUM);
+	u16 i;
 
-	desc_sent = pp2_port_enqueue(port, dm_if, qid, desc_req, descs);
-	if (unlikely(desc_sent < desc_req)) {
-		pr_debug("[%s] pp2_id %u Port %u qid %u, send_request %u sent %u!\n", __func__,
-			 ppio->pp2_id, ppio->port_id, qid, *num, desc_sent);
-		*num = desc_sent;
-	}
+	if (flags & PP2_PPIO_FWD_F_HW_RELEASE)
+		tx_flags |= TXD_BUFMODE_MASK;
 
-	if (port->maintain_stats) {
-		struct pp2_tx_queue *txq;
+	for (i = 0; i < *num; i++)
+		pp2_ppio_fwd_desc_conv(&descs[i], tx_flags, pkt_offset, l3_csum, l4_csum);
 
-		txq = port->txqs[qid];
-		txq->threshold_tx_pkts += desc_sent;
-		if (unlikely(txq->threshold_tx_pkts > PP2_STAT_UPDATE_THRESHOLD)) {
-			pp2_ppio_outq_get_statistics(ppio, qid, NULL, 0);
-			txq->threshold_tx_pkts = 0;
-		}
-	}
-	return 0;
+	return pp2_ppio_send(ppio, hif, qid, descs, num);
 }
 
 int pp2_ppio_send_sg(struct pp2_ppio *ppio,
@@ -291,13 +427,6 @@ int pp2_ppio_recv(struct pp2_ppio *ppio, u8 tc, u8 qid, struct pp2_ppio_desc *de
 	pp2_port_inq_update(port, log_rxq, recv_req, recv_req);
 	rxq->desc_received -= recv_req;
 
-	if (port->maintain_stats) {
-		rxq->threshold_rx_pkts += recv_req;
-		if (unlikely(rxq->threshold_rx_pkts > PP2_STAT_UPDATE_THRESHOLD)) {
-			pp2_ppio_inq_get_statistics(ppio, tc, qid, NULL, 0);
-			rxq->threshold_rx_pkts = 0;
-		}
-	}
 	return 0;
 }
 
@@ -423,54 +552,3 @@ int pp2_ppio_flush_vlan(struct pp2_ppio *ppio)
 	pr_err("[%s] routine not supported yet!\n", __func__);
 	return -ENOTSUP;
 }
-
-int pp2_ppio_get_statistics(struct pp2_ppio *ppio, struct pp2_ppio_statistics *stats, int reset)
-{
-	struct pp2_port *port = GET_PPIO_PORT(ppio);
-	int qid, tc;
-	u32 rx_fifo_dropped, rx_cls_dropped;
-
-	/*
-	* Reset all port statistics updated from queues statistics
-	* except of rx_fifo_dropped and rx_cls_dropped that will be
-	* read and aggregated from HW registers.
-	*/
-	rx_fifo_dropped = port->stats.rx_fifo_dropped;
-	rx_cls_dropped = port->stats.rx_cls_dropped;
-	memset(&port->stats, 0, sizeof(port->stats));
-
-	port->stats.rx_fifo_dropped = rx_fifo_dropped;
-	port->stats.rx_cls_dropped = rx_cls_dropped;
-	PP2_READ_UPDATE_CNT32(port->stats.rx_fifo_dropped, port->cpu_slot, MV_PP2_OVERRUN_DROP_REG(port->id));
-	PP2_READ_UPDATE_CNT32(port->stats.rx_cls_dropped, port->cpu_slot, MV_PP2_CLS_DROP_REG(port->id));
-
-	/* Update Rx Statistics */
-	for (tc = 0; tc < port->num_tcs; tc++) {
-		for (qid = 0; qid < port->tc[tc].tc_config.num_in_qs; qid++) {
-			struct pp2_ppio_inq_statistics rx_stats;
-
-			pp2_ppio_inq_get_statistics(ppio, tc, qid, &rx_stats, reset);
-			PP2_UPDATE_CNT64(port->stats.rx_packets, rx_stats.enq_desc);
-			PP2_UPDATE_CNT32(port->stats.rx_fullq_dropped, rx_stats.drop_fullq);
-			PP2_UPDATE_CNT32(port->stats.rx_bm_dropped, rx_stats.drop_bm);
-			PP2_UPDATE_CNT32(port->stats.rx_early_dropped, rx_stats.drop_early);
-		}
-	}
-
-	/* Update Tx Statistics */
-	for (qid = 0; qid < port->num_tx_queues; qid++) {
-		struct pp2_ppio_outq_statistics tx_stats;
-
-		pp2_ppio_outq_get_statistics(ppio, qid, &tx_stats, reset);
-		PP2_UPDATE_CNT64(port->stats.tx_packets, tx_stats.enq_desc);
-	}
-	if (stats)
-		memcpy(stats, &port->stats, sizeof(port->stats));
-
-	if (reset)
-		memset(&port->stats, 0, sizeof(port->stats));
-
-	return 0;
-
-}
-
@@ -0,0 +1,175 @@
+/******************************************************************************
+ *	Copyright (C) 2016 Marvell International Ltd.
+ *
+ *  If you received this File from Marvell, you may opt to use, redistribute
+ *  and/or modify this File under the following licensing terms.
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *	* Redistributions of source code must retain the above copyright
+ *	  notice, this list of conditions and the following disclaimer.
+ *
+ *	* Redistributions in binary form must reproduce the above copyright
+ *	  notice, this list of conditions and the following disclaimer in the
+ *	  documentation and/or other materials provided with the distribution.
+ *
+ *	* Neither the name of Marvell nor the names of its contributors may be
+ *	  used to endorse or promote products derived from this software
+ *	  without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include "std_internal.h"
+
+#include "pp2_types.h"
+#include "pp2.h"
+
+struct pp2_ppio_tx_buffer {
+	struct pp2_ppio				*ppio;
+	struct pp2_hif				*hif;
+	u8					 qid;
+	u16					 size;
+	u16					 num;
+	u32					 drain_timeout_us;
+	u64					 first_usecs;	/* when the oldest buffered descriptor was added */
+	struct pp2_ppio_tx_buffer_statistics	 stats;
+	struct pp2_ppio_desc			 descs[];
+};
+
+/* Send the buffered descriptors in one pp2_ppio_send() call, keeping the unsent ones in order */
+static u16 pp2_ppio_tx_buffer_send(struct pp2_ppio_tx_buffer *txb)
+{
+	u16 tx_num = txb->num;
+
+	pp2_ppio_send(txb->ppio, txb->hif, txb->qid, txb->descs, &tx_num);
+	if (unlikely(!tx_num))
+		return 0;
+
+	txb->stats.doorbells++;
+	txb->stats.sent += tx_num;
+	txb->num -= tx_num;
+	if (unlikely(txb->num))
+		memmove(txb->descs, &txb->descs[tx_num], txb->num * sizeof(struct pp2_ppio_desc));
+
+	return tx_num;
+}
+
+int pp2_ppio_tx_buffer_init(struct pp2_ppio_tx_buffer_params *params, struct pp2_ppio_tx_buffer **txb)
+{
+	struct pp2_ppio_tx_buffer *buf;
+	u16 size;
+
+	if (!params->ppio || !params->hif) {
+		pr_err("[%s] ppio and hif are required!\n", __func__);
+		return -EINVAL;
+	}
+	if (params->qid >= GET_PPIO_PORT(params->ppio)->num_tx_queues) {
+		pr_err("[%s] invalid queue id (%d)!\n", __func__, params->qid);
+		return -EINVAL;
+	}
+	size = params->size ? params->size : PP2_PPIO_TX_BUFFER_DEF_SIZE;
+	if (size > PP2_PPIO_TX_BUFFER_MAX_SIZE) {
+		pr_err("[%s] invalid size %u (up to %u)!\n", __func__, size, PP2_PPIO_TX_BUFFER_MAX_SIZE);
+		return -EINVAL;
+	}
+
+	buf = kcalloc(1, sizeof(*buf) + size * sizeof(struct pp2_ppio_desc), GFP_KERNEL);
+	if (!buf) {
+		pr_err("[%s] no mem for TX buffer!\n", __func__);
+		return -ENOMEM;
+	}
+	buf->ppio = params->ppio;
+	buf->hif = params->hif;
+	buf->qid = params->qid;
+	buf->size = size;
+	buf->drain_timeout_us = params->drain_timeout_us;
+
+	*txb = buf;
+	return 0;
+}
+
+void pp2_ppio_tx_buffer_deinit(struct pp2_ppio_tx_buffer *txb)
+{
+	if (txb->num)
+		pp2_ppio_tx_buffer_send(txb);
+	if (txb->num)
+		pr_warn("[%s] %u descriptors not sent\n", __func__, txb->num);
+	kfree(txb);
+}
+
+int pp2_ppio_tx_buffer_add(struct pp2_ppio_tx_buffer *txb, struct pp2_ppio_desc *descs, u16 *num)
+{
+	u16 req = *num, added = 0, n;
+
+	while (added < req) {
+		n = req - added;
+		if (n > txb->size - txb->num)
+			n = txb->size - txb->num;
+		if (n) {
+			if (!txb->num && txb->drain_timeout_us)
+				txb->first_usecs = mv_time_usecs();
+			memcpy(&txb->descs[txb->num], &descs[added], n * sizeof(struct pp2_ppio_desc));
+			txb->num += n;
+			added += n;
+		}
+		if (txb->num == txb->size) {
+			txb->stats.flush_full++;
+			if (!pp2_ppio_tx_buffer_send(txb))
+				break;
+		}
+	}
+
+	txb->stats.added += added;
+	*num = added;
+	return 0;
+}
+
+int pp2_ppio_tx_buffer_flush(struct pp2_ppio_tx_buffer *txb, u16 *num)
+{
+	u16 tx_num = 0;
+
+	if (txb->num) {
+		txb->stats.flush_explicit++;
+		tx_num = pp2_ppio_tx_buffer_send(txb);
+	}
+	if (num)
+		*num = tx_num;
+	return 0;
+}
+
+int pp2_ppio_tx_buffer_drain(struct pp2_ppio_tx_buffer *txb, u16 *num)
+{
+	u16 tx_num = 0;
+
+	if (txb->num &&
+	    (!txb->drain_timeout_us || mv_time_usecs() - txb->first_usecs >= txb->drain_timeout_us)) {
+		txb->stats.flush_timeout++;
+		tx_num = pp2_ppio_tx_buffer_send(txb);
+	}
+	if (num)
+		*num = tx_num;
+	return 0;
+}
+
+int pp2_ppio_tx_buffer_get_statistics(struct pp2_ppio_tx_buffer *txb,
+				      struct pp2_ppio_tx_buffer_statistics *stats, int reset)
+{
+	if (stats) {
+		memcpy(stats, &txb->stats, sizeof(txb->stats));
+		stats->pending = txb->num;
+	}
+	if (reset)
+		memset(&txb->stats, 0, sizeof(txb->stats));
+	return 0;
+}
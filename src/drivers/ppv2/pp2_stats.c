@@ -0,0 +1,389 @@
+/******************************************************************************
+ *	Copyright (C) 2016 Marvell International Ltd.
+ *
+ *  If you received this File from Marvell, you may opt to use, redistribute
+ *  and/or modify this File under the following licensing terms.
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *	* Redistributions of source code must retain the above copyright
+ *	  notice, this list of conditions and the following disclaimer.
+ *
+ *	* Redistributions in binary form must reproduce the above copyright
+ *	  notice, this list of conditions and the following disclaimer in the
+ *	  documentation and/or other materials provided with the distribution.
+ *
+ *	* Neither the name of Marvell nor the names of its contributors may be
+ *	  used to endorse or promote products derived from this software
+ *	  without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+
+#include "std_internal.h"
+
+#include "pp2_types.h"
+#include "pp2.h"
+#include "pp2_port.h"
+
+/* Default collection interval, in usec */
+#define PP2_STATS_COL_INTERVAL_US	1000000
+/* The collector thread checks for a stop request at least every SLICE */
+#define PP2_STATS_COL_SLICE_US		10000
+
+/*
+ * Statistics collector
+ *
+ * The HW counters are cleared on read and the queue counters are read through
+ * a shared index register, so all harvesting and all reading of the SW totals
+ * is done under the collector lock. The data path does no statistics work.
+ */
+struct pp2_stats_col {
+	spinlock_t		run_lock;	/* serializes the thread start/stop, held across the create
+						 * and join
+						 */
+	spinlock_t		lock;
+	pthread_t		thread;
+	int			running;
+	u32			interval_us;
+	u32			num_ppios;
+	struct pp2_ppio		*ppios[PP2_MAX_NUM_PACKPROCS][PP2_NUM_ETH_PPIO];
+};
+
+static struct pp2_stats_col stats_col = {
+	.run_lock = PTHREAD_MUTEX_INITIALIZER,
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+	.interval_us = PP2_STATS_COL_INTERVAL_US,
+};
+
+static inline u32 pp2_stats_cnt32(u64 cnt)
+{
+	return (cnt > UINT_MAX) ? UINT_MAX : (u32)cnt;
+}
+
+/* Harvest the HW counters of an RXQ. Called with the lock held */
+static void pp2_stats_rxq_update(struct pp2_port *port, struct pp2_rx_queue *rxq)
+{
+	uintptr_t cpu_slot = port->cpu_slot;
+
+	pp2_relaxed_reg_write(cpu_slot, MVPP2_CNT_IDX_REG, rxq->id);
+	PP2_READ_UPDATE_CNT64(rxq->stats.enq_desc, cpu_slot, MVPP2_RX_DESC_ENQ_REG);
+	PP2_READ_UPDATE_CNT64(rxq->stats.drop_fullq, cpu_slot, MVPP2_RX_PKT_FULLQ_DROP_REG);
+	PP2_READ_UPDATE_CNT64(rxq->stats.drop_early, cpu_slot, MVPP2_RX_PKT_EARLY_DROP_REG);
+	PP2_READ_UPDATE_CNT64(rxq->stats.drop_bm, cpu_slot, MVPP2_RX_PKT_BM_DROP_REG);
+}
+
+/* Harvest the HW counters of a TXQ. Called with the lock held */
+static void pp2_stats_txq_update(struct pp2_port *port, struct pp2_tx_queue *txq)
+{
+	uintptr_t cpu_slot = port->cpu_slot;
+
+	pp2_relaxed_reg_write(cpu_slot, MVPP2_CNT_IDX_REG, MVPP2_CNT_IDX_TX(port->id, txq->log_id));
+	PP2_READ_UPDATE_CNT64(txq->stats.enq_desc, cpu_slot, MVPP2_TX_DESC_ENQ_REG);
+	PP2_READ_UPDATE_CNT64(txq->stats.enq_dec_to_ddr, cpu_slot, MVPP2_TX_DESC_ENQ_TO_DRAM_REG);
+	PP2_READ_UPDATE_CNT64(txq->stats.enq_buf_to_ddr, cpu_slot, MVPP2_TX_BUF_ENQ_TO_DRAM_REG);
+	PP2_READ_UPDATE_CNT64(txq->stats.deq_desc, cpu_slot, MVPP2_TX_PKT_DQ_REG);
+}
+
+/* Harvest the port drop counters. Called with the lock held */
+static void pp2_stats_port_drop_update(struct pp2_port *port)
+{
+	PP2_READ_UPDATE_CNT64(port->stats.rx_fifo_dropped, port->cpu_slot, MV_PP2_OVERRUN_DROP_REG(port->id));
+	PP2_READ_UPDATE_CNT64(port->stats.rx_cls_dropped, port->cpu_slot, MV_PP2_CLS_DROP_REG(port->id));
+}
+
+/* Harvest all the HW counters of a port. Called with the lock held */
+static void pp2_stats_port_update(struct pp2_port *port)
+{
+	u32 i;
+
+	for (i = 0; i < port->num_rx_queues; i++)
+		pp2_stats_rxq_update(port, port->rxqs[i]);
+	for (i = 0; i < port->num_tx_queues; i++)
+		pp2_stats_txq_update(port, port->txqs[i]);
+	pp2_stats_port_drop_update(port);
+
+	/* The MAC of a logical port is owned by the kernel */
+	if (port->type != PP2_PPIO_T_LOG)
+		pp2_port_mac_stats_update(port);
+}
+
+/* Harvest all the registered ppios. Called with the lock held */
+static void pp2_stats_col_update(struct pp2_stats_col *col)
+{
+	int i, j;
+
+	for (i = 0; i < PP2_MAX_NUM_PACKPROCS; i++)
+		for (j = 0; j < PP2_NUM_ETH_PPIO; j++)
+			if (col->ppios[i][j])
+				pp2_stats_port_update(GET_PPIO_PORT(col->ppios[i][j]));
+}
+
+static void *pp2_stats_col_thread(void *arg)
+{
+	struct pp2_stats_col *col = (struct pp2_stats_col *)arg;
+	u32 slept_us = 0, slice_us;
+
+	while (1) {
+		spin_lock(&col->lock);
+		if (!col->running) {
+			spin_unlock(&col->lock);
+			break;
+		}
+		if (slept_us >= col->interval_us) {
+			pp2_stats_col_update(col);
+			slept_us = 0;
+		}
+		slice_us = (col->interval_us < PP2_STATS_COL_SLICE_US) ? col->interval_us : PP2_STATS_COL_SLICE_US;
+		spin_unlock(&col->lock);
+
+		usleep(slice_us);
+		slept_us += slice_us;
+	}
+
+	return NULL;
+}
+
+/* Start or stop the collector thread, according to the registered ppios and the interval */
+static int pp2_stats_col_run(struct pp2_stats_col *col)
+{
+	int run, stop = 0;
+	int rc;
+
+	/* a concurrent run would otherwise start a thread before this one joined the previous one */
+	spin_lock(&col->run_lock);
+	spin_lock(&col->lock);
+	run = col->num_ppios && col->interval_us;
+	if (run && !col->running) {
+		col->running = 1;
+		rc = pthread_create(&col->thread, NULL, pp2_stats_col_thread, col);
+		if (rc) {
+			pr_err("[%s] failed to create the statistics collector thread (%d)\n", __func__, rc);
+			col->running = 0;
+			spin_unlock(&col->lock);
+			spin_unlock(&col->run_lock);
+			return -rc;
+		}
+	} else if (!run && col->running) {
+		col->running = 0;
+		stop = 1;
+	}
+	spin_unlock(&col->lock);
+
+	if (stop)
+		pthread_join(col->thread, NULL);
+	spin_unlock(&col->run_lock);
+
+	return 0;
+}
+
+int pp2_stats_register(struct pp2_ppio *ppio)
+{
+	int rc;
+
+	spin_lock(&stats_col.lock);
+	if (stats_col.ppios[ppio->pp2_id][ppio->port_id]) {
+		spin_unlock(&stats_col.lock);
+		pr_err("[%s] ppio already registered\n", __func__);
+		return -EEXIST;
+	}
+	stats_col.ppios[ppio->pp2_id][ppio->port_id] = ppio;
+	stats_col.num_ppios++;
+	spin_unlock(&stats_col.lock);
+
+	rc = pp2_stats_col_run(&stats_col);
+	if (rc)
+		pp2_stats_unregister(ppio);
+
+	return rc;
+}
+
+void pp2_stats_unregister(struct pp2_ppio *ppio)
+{
+	spin_lock(&stats_col.lock);
+	if (!stats_col.ppios[ppio->pp2_id][ppio->port_id]) {
+		spin_unlock(&stats_col.lock);
+		return;
+	}
+	stats_col.ppios[ppio->pp2_id][ppio->port_id] = NULL;
+	stats_col.num_ppios--;
+	spin_unlock(&stats_col.lock);
+
+	pp2_stats_col_run(&stats_col);
+}
+
+int pp2_stats_poll(void)
+{
+	if (pp2_is_init() == false)
+		return -EPERM;
+
+	spin_lock(&stats_col.lock);
+	pp2_stats_col_update(&stats_col);
+	spin_unlock(&stats_col.lock);
+
+	return 0;
+}
+
+int pp2_stats_collector_set_interval(u32 interval_us)
+{
+	spin_lock(&stats_col.lock);
+	stats_col.interval_us = interval_us;
+	spin_unlock(&stats_col.lock);
+
+	return pp2_stats_col_run(&stats_col);
+}
+
+/* Get RXQ statistics. Called with the lock held */
+static void pp2_stats_rxq_get(struct pp2_port *port, struct pp2_rx_queue *rxq,
+			      struct pp2_ppio_inq_statistics *stats, int reset)
+{
+	pp2_stats_rxq_update(port, rxq);
+
+	if (stats) {
+		stats->enq_desc = rxq->stats.enq_desc;
+		stats->drop_early = pp2_stats_cnt32(rxq->stats.drop_early);
+		stats->drop_fullq = pp2_stats_cnt32(rxq->stats.drop_fullq);
+		stats->drop_bm = pp2_stats_cnt32(rxq->stats.drop_bm);
+	}
+
+	if (reset)
+		memset(&rxq->stats, 0, sizeof(rxq->stats));
+}
+
+/* Get TXQ statistics. Called with the lock held */
+static void pp2_stats_txq_get(struct pp2_port *port, struct pp2_tx_queue *txq,
+			      struct pp2_ppio_outq_statistics *stats, int reset)
+{
+	u64 rsrv_req = 0, rsrv_partial = 0;
+	int i;
+
+	pp2_stats_txq_update(port, txq);
+
+	/* Reservations are counted per DM-IF, by the thread using it without a lock,
+	 * so they are read against the totals of the last reset rather than cleared
+	 */
+	for (i = 0; i < PP2_NUM_REGSPACES; i++) {
+		rsrv_req += txq->txq_dm_if[i].rsrv_req;
+		rsrv_partial += txq->txq_dm_if[i].rsrv_partial;
+	}
+	txq->stats.rsrv_req = rsrv_req - txq->rsrv_req_base;
+	txq->stats.rsrv_partial = rsrv_partial - txq->rsrv_partial_base;
+
+	if (stats)
+		memcpy(stats, &txq->stats, sizeof(txq->stats));
+
+	if (reset) {
+		memset(&txq->stats, 0, sizeof(txq->stats));
+		txq->rsrv_req_base = rsrv_req;
+		txq->rsrv_partial_base = rsrv_partial;
+	}
+}
+
+int pp2_ppio_inq_get_statistics(struct pp2_ppio *ppio, u8 tc, u8 qid,
+				struct pp2_ppio_inq_statistics *stats, int reset)
+{
+	struct pp2_port *port = GET_PPIO_PORT(ppio);
+	struct pp2_rx_queue *rxq;
+
+	if (unlikely(qid >= port->tc[tc].tc_config.num_in_qs)) {
+		pr_err("[%s] invalid queue id (%d)!\n", __func__, qid);
+		return -EINVAL;
+	}
+	rxq = port->rxqs[port->tc[tc].first_log_rxq + qid];
+
+	spin_lock(&stats_col.lock);
+	pp2_stats_rxq_get(port, rxq, stats, reset);
+	spin_unlock(&stats_col.lock);
+
+	return 0;
+}
+
+int pp2_ppio_outq_get_statistics(struct pp2_ppio *ppio, u8 qid,
+				 struct pp2_ppio_outq_statistics *stats, int reset)
+{
+	struct pp2_port *port = GET_PPIO_PORT(ppio);
+
+	if (unlikely(qid >= port->num_tx_queues)) {
+		pr_err("[%s] invalid queue id (%d)!\n", __func__, qid);
+		return -EINVAL;
+	}
+
+	spin_lock(&stats_col.lock);
+	pp2_stats_txq_get(port, port->txqs[qid], stats, reset);
+	spin_unlock(&stats_col.lock);
+
+	return 0;
+}
+
+int pp2_ppio_get_statistics(struct pp2_ppio *ppio, struct pp2_ppio_statistics *stats, int reset)
+{
+	struct pp2_port *port = GET_PPIO_PORT(ppio);
+	struct pp2_ppio_statistics port_stats;
+	int qid, tc;
+
+	memset(&port_stats, 0, sizeof(port_stats));
+
+	/* Port statistics are summed from a single snapshot of all its queues */
+	spin_lock(&stats_col.lock);
+	pp2_stats_port_drop_update(port);
+	port_stats.rx_fifo_dropped = pp2_stats_cnt32(port->stats.rx_fifo_dropped);
+	port_stats.rx_cls_dropped = pp2_stats_cnt32(port->stats.rx_cls_dropped);
+	if (reset)
+		memset(&port->stats, 0, sizeof(port->stats));
+
+	/* Update Rx Statistics */
+	for (tc = 0; tc < port->num_tcs; tc++) {
+		for (qid = 0; qid < port->tc[tc].tc_config.num_in_qs; qid++) {
+			struct pp2_ppio_inq_statistics rx_stats;
+
+			pp2_stats_rxq_get(port, port->rxqs[port->tc[tc].first_log_rxq + qid], &rx_stats, reset);
+			PP2_UPDATE_CNT64(port_stats.rx_packets, rx_stats.enq_desc);
+			PP2_UPDATE_CNT32(port_stats.rx_fullq_dropped, rx_stats.drop_fullq);
+			PP2_UPDATE_CNT32(port_stats.rx_bm_dropped, rx_stats.drop_bm);
+			PP2_UPDATE_CNT32(port_stats.rx_early_dropped, rx_stats.drop_early);
+		}
+	}
+
+	/* Update Tx Statistics */
+	for (qid = 0; qid < port->num_tx_queues; qid++) {
+		struct pp2_ppio_outq_statistics tx_stats;
+
+		pp2_stats_txq_get(port, port->txqs[qid], &tx_stats, reset);
+		PP2_UPDATE_CNT64(port_stats.tx_packets, tx_stats.enq_desc);
+	}
+	spin_unlock(&stats_col.lock);
+
+	if (stats)
+		memcpy(stats, &port_stats, sizeof(port_stats));
+
+	return 0;
+}
+
+int pp2_ppio_get_mac_statistics(struct pp2_ppio *ppio, struct pp2_ppio_mac_statistics *stats,
+				struct pp2_ppio_mac_rates *rates, u32 rate_period_ms, int reset)
+{
+	struct pp2_port *port = GET_PPIO_PORT(ppio);
+	int rc;
+
+	if (port->type == PP2_PPIO_T_LOG) {
+		pr_err("[%s] MAC statistics not supported on a logical port\n", __func__);
+		return -ENOTSUP;
+	}
+
+	spin_lock(&stats_col.lock);
+	rc = pp2_port_get_mac_statistics(port, stats, rates, rate_period_ms, reset);
+	spin_unlock(&stats_col.lock);
+
+	return rc;
+}
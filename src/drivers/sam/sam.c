@@ -71,6 +71,13 @@ void sam_dma_buf_free(struct sam_buf_info *dma_buf)
 		mv_sys_dma_mem_free(dma_buf->vaddr);
 }
 
+static inline void sam_cio_doorbell(struct sam_cio *cio)
+{
+	sam_hw_ring_submit(&cio->hw_ring, cio->pending_submit);
+	cio->pending_submit = 0;
+	SAM_STATS(cio->stats.doorbells++);
+}
+
 static struct sam_sa *sam_session_alloc(struct sam_cio *cio)
 {
 	int i;
@@ -271,6 +278,15 @@ int sam_cio_init(struct sam_cio_params *params, struct sam_cio **cio)
 			params->match);
 		return -EINVAL;
 	}
+	if (sam_max_check((int)params->compl_mode, SAM_CIO_COMPL_LAST, "compl_mode"))
+		return -EINVAL;
+
+	if (params->submit_thresh >= params->size) {
+		pr_err("Invalid submit_thresh %d. Must be less than ring size %d\n",
+			params->submit_thresh, params->size);
+		return -EINVAL;
+	}
+
 	cio_idx = sam_cio_free_idx_get();
 	if (cio_idx < 0) {
 		pr_err("No free place for new CIO: active_cios = %d, max_cios = %d\n",
@@ -431,6 +447,7 @@ int sam_session_create(struct sam_cio *cio, struct sam_session_params *params, s
 	/* Clear session structure */
 	memset(&session->sa_params, 0, sizeof(session->sa_params));
 	memset(&session->basic_params, 0, sizeof(session->basic_params));
+	session->grp_sas = NULL;
 
 #ifdef MVCONF_SAM_DEBUG
 	if (cio->debug_flags & SAM_SA_DEBUG_FLAG) {
@@ -557,9 +574,14 @@ int sam_session_destroy(struct sam_sa *session)
 		operation->sa = session;
 		operation->num_bufs = 0;
 
+		/* Submit pending requests before session invalidation */
+		if (cio->pending_submit)
+			sam_cio_doorbell(cio);
+
 		/* Invalidate session in HW */
 		sam_hw_session_invalidate(&cio->hw_ring, &session->sa_buf, cio->next_request);
 		SAM_STATS(cio->stats.sa_inv++);
+		SAM_STATS(cio->stats.doorbells++);
 
 		cio->next_request = sam_cio_next_idx(cio, cio->next_request);
 	} else {
@@ -628,6 +650,7 @@ int sam_cio_enq(struct sam_cio *cio, struct sam_cio_op_params *requests, u16 *nu
 		operation->cookie = request->cookie;
 		operation->num_bufs = request->num_bufs;
 		operation->auth_icv_offset = request->auth_icv_offset;
+		operation->compl_cb = request->compl_cb;
 		for (j = 0;  j < request->num_bufs; j++) {
 			operation->out_frags[j].vaddr = request->dst[j].vaddr;
 			operation->out_frags[j].paddr = request->dst[j].paddr;
@@ -661,7 +684,12 @@ int sam_cio_enq(struct sam_cio *cio, struct sam_cio_op_params *requests, u16 *nu
 	}
 	/* submit requests */
 	if (i) {
-		sam_hw_ring_submit(&cio->hw_ring, i);
+		if (!cio->pending_submit && cio->params.submit_timeout_us)
+			cio->pending_usecs = mv_time_usecs();
+		cio->pending_submit += i;
+		if (cio->pending_submit >= cio->params.submit_thresh)
+			sam_cio_doorbell(cio);
+
 		SAM_STATS(cio->stats.enq_pkts += i);
 	}
 	*num = (u16)i;
@@ -672,20 +700,65 @@ error_enq:
 	return -EINVAL;
 }
 
-/* Process crypto operation result */
-int sam_cio_deq(struct sam_cio *cio, struct sam_cio_op_result *results, u16 *num)
+int sam_cio_kick(struct sam_cio *cio)
+{
+	if (cio->pending_submit)
+		sam_cio_doorbell(cio);
+
+	return 0;
+}
+
+/*
+ * Deferred requests are submitted on dequeue only when no submitted request is
+ * in process, so polling between enqueues doesn't defeat submit_thresh: they are
+ * submitted once the previous burst is done, or after submit_timeout_us.
+ */
+static inline bool sam_cio_flush_due(struct sam_cio *cio)
+{
+	if (sam_cio_occupied(cio) == cio->pending_submit)
+		return true;
+
+	return (cio->params.submit_timeout_us &&
+		(mv_time_usecs() - cio->pending_usecs) >= cio->params.submit_timeout_us);
+}
+
+static inline bool sam_cio_results_ready(struct sam_cio *cio)
+{
+	struct sam_hw_res_desc *res_desc;
+
+	if (!cio->hw_ring.own_mode)
+		return (sam_hw_ring_ready_get(&cio->hw_ring) != 0);
+
+	if (sam_cio_is_empty(cio))
+		return false;
+
+	res_desc = sam_hw_res_desc_get(&cio->hw_ring, cio->next_result);
+	return sam_hw_rdr_own_word_is_set(&cio->hw_ring, res_desc);
+}
+
+/* Process crypto operation result. Completion callbacks are saved to "cbs" array if not NULL */
+static int sam_cio_deq_results(struct sam_cio *cio, struct sam_cio_op_result *results,
+			       sam_cio_compl_cb *cbs, u16 *num)
 {
 	unsigned int i, count, todo, done, out_len;
 	struct sam_cio_op *operation;
 	struct sam_hw_res_desc *res_desc;
 	struct sam_cio_op_result *result;
 
-	/* Try to get the processed packet from the RDR */
-	done = sam_hw_ring_ready_get(&cio->hw_ring);
-	if (!done) {
-		SAM_STATS(cio->stats.deq_empty++);
-		*num = 0;
-		return 0;
+	if (cio->pending_submit && sam_cio_flush_due(cio))
+		sam_cio_doorbell(cio);
+
+	if (cio->hw_ring.own_mode) {
+		/* Processed descriptors are detected by ownership word, limited by counter size */
+		done = SAM_RING_PKT_COUNT_MASK;
+	} else {
+		/* Try to get the processed packet from the RDR */
+		done = sam_hw_ring_ready_get(&cio->hw_ring);
+		if (!done) {
+			SAM_STATS(cio->stats.deq_empty++);
+			*num = 0;
+			return 0;
+		}
 	}
 	todo = *num;
 
@@ -695,6 +768,12 @@ int sam_cio_deq(struct sam_cio *cio, struct sam_cio_op_result *results, u16 *num
 	while ((i < done) && (count < todo)) {
 		res_desc = sam_hw_res_desc_get(&cio->hw_ring, cio->next_result);
 
+		if (cio->hw_ring.own_mode) {
+			if (sam_cio_is_empty(cio) ||
+			    !sam_hw_rdr_own_word_is_set(&cio->hw_ring, res_desc))
+				break;
+		}
+
 #ifdef MVCONF_SAM_DEBUG
 		if (cio->debug_flags & SAM_CIO_DEBUG_FLAG)
 			print_result_desc(res_desc);
@@ -717,6 +796,8 @@ int sam_cio_deq(struct sam_cio *cio, struct sam_cio_op_result *results, u16 *num
 		cio->next_result = sam_cio_next_idx(cio, cio->next_result);
 
 		result->cookie = operation->cookie;
+		if (cbs)
+			cbs[count] = operation->compl_cb;
 
 		/* Check output buffer size */
 		if (operation->out_frags[0].len < out_len) {
@@ -734,9 +815,18 @@ int sam_cio_deq(struct sam_cio *cio, struct sam_cio_op_result *results, u16 *num
 		result++;
 		count++;
 	}
+	if (!i) {
+		SAM_STATS(cio->stats.deq_empty++);
+		*num = 0;
+		return 0;
+	}
 	/* Update RDR registers */
 	sam_hw_ring_update(&cio->hw_ring, i);
 
+	/* The dequeued burst may have been the last one in process */
+	if (cio->pending_submit && sam_cio_flush_due(cio))
+		sam_cio_doorbell(cio);
+
 	SAM_STATS(cio->stats.deq_pkts += count);
 
 	*num = (u16)count;
@@ -744,6 +834,86 @@ int sam_cio_deq(struct sam_cio *cio, struct sam_cio_op_result *results, u16 *num
 	return 0;
 }
 
+int sam_cio_deq(struct sam_cio *cio, struct sam_cio_op_result *results, u16 *num)
+{
+	return sam_cio_deq_results(cio, results, NULL, num);
+}
+
+int sam_cio_deq_cb(struct sam_cio *cio, u16 *num)
+{
+	struct sam_cio_op_result results[SAM_CIO_DEQ_CB_BURST];
+	sam_cio_compl_cb cbs[SAM_CIO_DEQ_CB_BURST];
+	u16 i, todo, burst, total = 0;
+	int rc = 0;
+
+	todo = *num;
+	while (total < todo) {
+		burst = todo - total;
+		if (burst > SAM_CIO_DEQ_CB_BURST)
+			burst = SAM_CIO_DEQ_CB_BURST;
+
+		rc = sam_cio_deq_results(cio, results, cbs, &burst);
+		if (rc)
+			break;
+
+		for (i = 0; i < burst; i++) {
+			if (cbs[i])
+				cbs[i](&results[i]);
+		}
+		total += burst;
+
+		/* No more results ready */
+		if (burst < SAM_CIO_DEQ_CB_BURST)
+			break;
+	}
+	*num = total;
+
+	return rc;
+}
+
+int sam_cio_event_fd_get(struct sam_cio *cio, int *fd)
+{
+	int rc;
+
+	rc = sam_hw_ring_irq_init(&cio->hw_ring);
+	if (rc)
+		return rc;
+
+	*fd = cio->hw_ring.irq_fd;
+
+	return 0;
+}
+
+int sam_cio_event_arm(struct sam_cio *cio)
+{
+	int rc;
+
+	rc = sam_hw_ring_irq_init(&cio->hw_ring);
+	if (rc)
+		return rc;
+
+	/* Results of deferred requests will never come if not submitted */
+	if (cio->pending_submit)
+		sam_cio_doorbell(cio);
+
+	return sam_hw_ring_irq_arm(&cio->hw_ring);
+}
+
+int sam_cio_event_wait(struct sam_cio *cio, int timeout_ms)
+{
+	int rc;
+
+	rc = sam_cio_event_arm(cio);
+	if (rc)
+		return rc;
+
+	/* Results can be ready before notification is armed */
+	if (sam_cio_results_ready(cio))
+		return 0;
+
+	return sam_hw_ring_irq_wait(&cio->hw_ring, timeout_ms);
+}
+
 int sam_cio_debug_flags_set(struct sam_cio *cio, u32 debug_flags)
 {
 #ifdef MVCONF_SAM_DEBUG
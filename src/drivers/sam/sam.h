@@ -59,6 +59,9 @@
 /* max TCR data size in bytes */
 #define SAM_TCR_DATA_SIZE		(9 * 4)
 
+/* max number of results processed by sam_cio_deq_cb() in one iteration */
+#define SAM_CIO_DEQ_CB_BURST		32
+
 struct sam_cio_op {
 	bool is_valid;
 	struct sam_sa *sa;
@@ -70,6 +73,7 @@ struct sam_cio_op {
 	u32 token_header_word;
 	u32 token_words;
 	u32 copy_len;
+	sam_cio_compl_cb compl_cb;
 };
 
 
@@ -87,6 +91,8 @@ struct sam_cio {
 	struct sam_hw_ring hw_ring;
 	u32 next_request;
 	u32 next_result;
+	u32 pending_submit;		/* number of enqueued requests not submitted to HW yet */
+	u64 pending_usecs;		/* time the oldest pending request was enqueued, for submit_timeout_us */
 };
 
 struct sam_sa {
@@ -102,6 +108,32 @@ struct sam_sa {
 	u8				tcr_data[SAM_TCR_DATA_SIZE];
 	u32				tcr_words;
 	u32				token_words;
+	struct sam_sa			**grp_sas;	/* sessions on all CIOs of group (least busy policy) */
+};
+
+/* Maximum number of sessions waiting for result, that not block merged dequeue of the group */
+#define SAM_CIO_GROUP_MAX_BLOCKED	16
+
+struct sam_cio_group_ticket {
+	void *cookie;			/* caller cookie */
+	struct sam_sa *sa;		/* session handler passed by caller */
+	u8 cio;				/* index of CIO the operation was sent to */
+	bool done;			/* result received from CIO */
+	bool consumed;			/* result returned to caller */
+	struct sam_cio_op_result result;
+};
+
+struct sam_cio_group {
+	struct sam_cio_group_params params;
+	struct sam_cio *cios[SAM_MAX_CIO_NUM];
+	u32 depth[SAM_MAX_CIO_NUM];	/* number of outstanding operations per CIO */
+	u32 sessions[SAM_MAX_CIO_NUM];	/* number of group sessions per CIO */
+	struct sam_cio_group_ticket *tickets; /* operations in enqueue order */
+	u32 num_tickets;
+	u32 head;			/* oldest operation not returned to caller */
+	u32 tail;			/* next free ticket */
+	struct sam_cio_op_result *deq_buf;
+	u32 deq_buf_size;
 };
 
 #ifdef MVCONF_SAM_STATS
@@ -159,6 +191,15 @@ static inline bool sam_cio_is_empty(struct sam_cio *cio)
 	return (cio->next_request == cio->next_result);
 }
 
+/* Number of ring entries in use: submitted to HW, or pending submission */
+static inline u32 sam_cio_occupied(struct sam_cio *cio)
+{
+	if (cio->next_request >= cio->next_result)
+		return cio->next_request - cio->next_result;
+
+	return cio->params.size - cio->next_result + cio->next_request;
+}
+
 static inline int sam_max_check(int value, int limit, const char *name)
 {
 	if ((value < 0) || (value >= limit)) {
@@ -0,0 +1,215 @@
+/******************************************************************************
+ *	Copyright (C) 2016 Marvell International Ltd.
+ *
+ *  If you received this File from Marvell, you may opt to use, redistribute
+ *  and/or modify this File under the following licensing terms.
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *	* Redistributions of source code must retain the above copyright
+ *	  notice, this list of conditions and the following disclaimer.
+ *
+ *	* Redistributions in binary form must reproduce the above copyright
+ *	  notice, this list of conditions and the following disclaimer in the
+ *	  documentation and/or other materials provided with the distribution.
+ *
+ *	* Neither the name of Marvell nor the names of its contributors may be
+ *	  used to endorse or promote products derived from this software
+ *	  without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include "std_internal.h"
+#include "drivers/mv_sam.h"
+#include "lib/mv_md5.h"
+#include "lib/mv_sha1.h"
+#include "lib/mv_sha2.h"
+#include "lib/mv_sha_mb.h"
+#include "lib/mv_aes.h"
+
+#include "sam.h"
+
+/* Number of HMAC keys collected before calling the multi-buffer hash */
+#define SAM_AUTH_KEY_MB_BATCH	16
+
+struct sam_auth_key_batch {
+	void		(*hmac_iv)(const u8 *const keys[], const int key_lens[],
+				   u8 *inner[], u8 *outer[], int num);
+	const u8	*keys[SAM_AUTH_KEY_MB_BATCH];
+	int		key_lens[SAM_AUTH_KEY_MB_BATCH];
+	u8		*inner[SAM_AUTH_KEY_MB_BATCH];
+	u8		*outer[SAM_AUTH_KEY_MB_BATCH];
+	int		num;
+};
+
+static int sam_auth_key_check(struct sam_session_params *params, u8 *key, u32 key_len)
+{
+	if (!key || !key_len) {
+		pr_err("Authentication key is not set\n");
+		return -EINVAL;
+	}
+	if (!params->auth_inner) {
+		pr_err("Authentication inner block is not set\n");
+		return -EINVAL;
+	}
+	if (!params->auth_outer &&
+	    params->auth_alg != SAM_AUTH_AES_GCM && params->auth_alg != SAM_AUTH_AES_GMAC) {
+		pr_err("Authentication outer block is not set\n");
+		return -EINVAL;
+	}
+	return 0;
+}
+
+static int sam_auth_gcm_key_set(u8 *key, u32 key_len, u8 *inner)
+{
+	struct mv_aes_ctx ctx;
+	u8 h[MV_AES_BLOCK_SIZE] = {0};
+	u32 *ptr32 = (u32 *)inner;
+	int i, err;
+
+	err = mv_aes_set_key(&ctx, key, key_len * 8);
+	if (err)
+		return err;
+
+	mv_aes_encrypt(&ctx, h, h);
+
+	/* GHASH key is passed to the engine as host order words */
+	for (i = 0; i < MV_AES_BLOCK_SIZE / 4; i++)
+		ptr32[i] = ((u32)h[4 * i] << 24) | ((u32)h[4 * i + 1] << 16) |
+			   ((u32)h[4 * i + 2] << 8) | h[4 * i + 3];
+
+	return 0;
+}
+
+int sam_session_auth_key_set(struct sam_session_params *params, u8 *key, u32 key_len)
+{
+	u8 hkey[SHA512_DIGEST_LENGTH];
+	SHA256_CTX sha256;
+	SHA512_CTX sha512;
+	int err;
+
+	err = sam_auth_key_check(params, key, key_len);
+	if (err)
+		return err;
+
+	switch (params->auth_alg) {
+	case SAM_AUTH_HMAC_MD5:
+		if (key_len > 64) {
+			mv_md5(key, key_len, hkey);
+			key = hkey;
+			key_len = MV_MD5_MAC_LEN;
+		}
+		mv_md5_hmac_iv(key, key_len, params->auth_inner, params->auth_outer);
+		break;
+	case SAM_AUTH_HMAC_SHA1:
+		if (key_len > 64) {
+			mv_sha1(key, key_len, hkey);
+			key = hkey;
+			key_len = MV_SHA1_DIGEST_SIZE;
+		}
+		mv_sha1_hmac_iv(key, key_len, params->auth_inner, params->auth_outer);
+		break;
+	case SAM_AUTH_HMAC_SHA2_256:
+		if (key_len > SHA256_BLOCK_LENGTH) {
+			mv_sha256_init(&sha256);
+			mv_sha256_update(&sha256, key, key_len);
+			mv_sha256_final(hkey, &sha256);
+			key = hkey;
+			key_len = SHA256_DIGEST_LENGTH;
+		}
+		mv_sha256_hmac_iv(key, key_len, params->auth_inner, params->auth_outer);
+		break;
+	case SAM_AUTH_HMAC_SHA2_384:
+		if (key_len > SHA384_BLOCK_LENGTH) {
+			mv_sha384_init(&sha512);
+			mv_sha384_update(&sha512, key, key_len);
+			mv_sha384_final(hkey, &sha512);
+			key = hkey;
+			/* SHA384_DIGEST_LENGTH is the intermediate state size */
+			key_len = 48;
+		}
+		mv_sha384_hmac_iv(key, key_len, params->auth_inner, params->auth_outer);
+		break;
+	case SAM_AUTH_HMAC_SHA2_512:
+		if (key_len > SHA512_BLOCK_LENGTH) {
+			mv_sha512_init(&sha512);
+			mv_sha512_update(&sha512, key, key_len);
+			mv_sha512_final(hkey, &sha512);
+			key = hkey;
+			key_len = SHA512_DIGEST_LENGTH;
+		}
+		mv_sha512_hmac_iv(key, key_len, params->auth_inner, params->auth_outer);
+		break;
+	case SAM_AUTH_AES_GCM:
+	case SAM_AUTH_AES_GMAC:
+		return sam_auth_gcm_key_set(key, key_len, params->auth_inner);
+	default:
+		pr_err("Authentication algorithm %d doesn't use key\n", params->auth_alg);
+		return -ENOTSUP;
+	}
+
+	return 0;
+}
+
+static void sam_auth_key_batch_flush(struct sam_auth_key_batch *batch)
+{
+	if (!batch->num)
+		return;
+
+	batch->hmac_iv(batch->keys, batch->key_lens, batch->inner, batch->outer, batch->num);
+	batch->num = 0;
+}
+
+int sam_session_auth_keys_set(struct sam_session_params params[], u8 *keys[], u32 key_lens[], u32 num)
+{
+	struct sam_auth_key_batch sha1_batch, sha256_batch, *batch;
+	int i, err;
+
+	sha1_batch.hmac_iv = mv_sha1_mb_hmac_iv;
+	sha1_batch.num = 0;
+	sha256_batch.hmac_iv = mv_sha256_mb_hmac_iv;
+	sha256_batch.num = 0;
+
+	for (i = 0; i < num; i++) {
+		if (params[i].auth_alg == SAM_AUTH_HMAC_SHA1)
+			batch = &sha1_batch;
+		else if (params[i].auth_alg == SAM_AUTH_HMAC_SHA2_256)
+			batch = &sha256_batch;
+		else
+			batch = NULL;
+
+		if (!batch) {
+			err = sam_session_auth_key_set(&params[i], keys[i], key_lens[i]);
+			if (err)
+				return err;
+			continue;
+		}
+
+		err = sam_auth_key_check(&params[i], keys[i], key_lens[i]);
+		if (err)
+			return err;
+
+		batch->keys[batch->num] = keys[i];
+		batch->key_lens[batch->num] = key_lens[i];
+		batch->inner[batch->num] = params[i].auth_inner;
+		batch->outer[batch->num] = params[i].auth_outer;
+		if (++batch->num == SAM_AUTH_KEY_MB_BATCH)
+			sam_auth_key_batch_flush(batch);
+	}
+
+	sam_auth_key_batch_flush(&sha1_batch);
+	sam_auth_key_batch_flush(&sha256_batch);
+
+	return 0;
+}
@@ -0,0 +1,414 @@
+/******************************************************************************
+ *	Copyright (C) 2016 Marvell International Ltd.
+ *
+ *  If you received this File from Marvell, you may opt to use, redistribute
+ *  and/or modify this File under the following licensing terms.
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *	* Redistributions of source code must retain the above copyright
+ *	  notice, this list of conditions and the following disclaimer.
+ *
+ *	* Redistributions in binary form must reproduce the above copyright
+ *	  notice, this list of conditions and the following disclaimer in the
+ *	  documentation and/or other materials provided with the distribution.
+ *
+ *	* Neither the name of Marvell nor the names of its contributors may be
+ *	  used to endorse or promote products derived from this software
+ *	  without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include "std_internal.h"
+#include "drivers/mv_sam.h"
+
+#include "sam.h"
+
+static inline u32 sam_cio_group_next_ticket(struct sam_cio_group *grp, u32 idx)
+{
+	idx++;
+	if (idx == grp->num_tickets)
+		idx = 0;
+
+	return idx;
+}
+
+/* Maximum number of outstanding operations for CIO (one descriptor is reserved by driver) */
+static inline u32 sam_cio_group_cio_capacity(struct sam_cio *cio)
+{
+	return cio->params.size - 1;
+}
+
+static int sam_cio_group_cio_idx(struct sam_cio_group *grp, struct sam_cio *cio)
+{
+	int i;
+
+	for (i = 0; i < grp->params.num_cios; i++) {
+		if (grp->cios[i] == cio)
+			return i;
+	}
+	return -1;
+}
+
+static int sam_cio_group_cio_select(struct sam_cio_group *grp, struct sam_sa *sa)
+{
+	int i, idx;
+	u32 min_depth;
+
+	if (grp->params.policy == SAM_CIO_GROUP_SA_AFFINITY) {
+		idx = sam_cio_group_cio_idx(grp, sa->cio);
+		if (idx < 0) {
+			pr_err("%s: session doesn't belong to the group\n", __func__);
+			return -EINVAL;
+		}
+		if (grp->depth[idx] >= sam_cio_group_cio_capacity(grp->cios[idx]))
+			return -EBUSY;
+
+		return idx;
+	}
+
+	if (!sa->grp_sas) {
+		pr_err("%s: session is not created for the group\n", __func__);
+		return -EINVAL;
+	}
+
+	idx = -EBUSY;
+	min_depth = ~0;
+	for (i = 0; i < grp->params.num_cios; i++) {
+		if (grp->depth[i] >= sam_cio_group_cio_capacity(grp->cios[i]))
+			continue;
+
+		if (grp->depth[i] < min_depth) {
+			min_depth = grp->depth[i];
+			idx = i;
+		}
+	}
+	return idx;
+}
+
+int sam_cio_group_init(struct sam_cio_group_params *params, struct sam_cio_group **grp)
+{
+	struct sam_cio_group *local_grp;
+	u32 i, num_tickets, max_size;
+
+	if ((params->num_cios == 0) || (params->num_cios > SAM_MAX_CIO_NUM)) {
+		pr_err("Invalid number of CIOs %d. Valid range is [1..%d]\n",
+			params->num_cios, SAM_MAX_CIO_NUM);
+		return -EINVAL;
+	}
+
+	if (sam_max_check((int)params->policy, SAM_CIO_GROUP_POLICY_LAST, "policy"))
+		return -EINVAL;
+
+	for (i = 0; i < params->num_cios; i++) {
+		if (!params->cios[i]) {
+			pr_err("CIO #%d of the group is not initialized\n", i);
+			return -EINVAL;
+		}
+	}
+
+	local_grp = kcalloc(1, sizeof(struct sam_cio_group), GFP_KERNEL);
+	if (!local_grp) {
+		pr_err("Can't allocate %lu bytes for sam_cio_group structure\n",
+			sizeof(struct sam_cio_group));
+		return -ENOMEM;
+	}
+
+	num_tickets = 0;
+	max_size = 0;
+	for (i = 0; i < params->num_cios; i++) {
+		local_grp->cios[i] = params->cios[i];
+		num_tickets += sam_cio_group_cio_capacity(params->cios[i]);
+		if (params->cios[i]->params.size > max_size)
+			max_size = params->cios[i]->params.size;
+	}
+	local_grp->params = *params;
+	local_grp->params.cios = local_grp->cios;
+
+	/* Add 1 to number of tickets for lockless ring management */
+	local_grp->num_tickets = num_tickets + 1;
+	local_grp->tickets = kcalloc(local_grp->num_tickets, sizeof(struct sam_cio_group_ticket),
+				     GFP_KERNEL);
+	if (!local_grp->tickets) {
+		pr_err("Can't allocate %u * %lu bytes for sam_cio_group_ticket structures\n",
+			local_grp->num_tickets, sizeof(struct sam_cio_group_ticket));
+		goto err;
+	}
+
+	local_grp->deq_buf_size = max_size;
+	local_grp->deq_buf = kcalloc(max_size, sizeof(struct sam_cio_op_result), GFP_KERNEL);
+	if (!local_grp->deq_buf) {
+		pr_err("Can't allocate %u * %lu bytes for sam_cio_op_result structures\n",
+			max_size, sizeof(struct sam_cio_op_result));
+		goto err;
+	}
+
+	*grp = local_grp;
+
+	return 0;
+err:
+	sam_cio_group_deinit(local_grp);
+
+	return -ENOMEM;
+}
+
+int sam_cio_group_deinit(struct sam_cio_group *grp)
+{
+	if (!grp)
+		return 0;
+
+	if (grp->head != grp->tail)
+		pr_warn("%s: %d operations are not dequeued\n", __func__,
+			(grp->tail + grp->num_tickets - grp->head) % grp->num_tickets);
+
+	kfree(grp->deq_buf);
+	kfree(grp->tickets);
+	kfree(grp);
+
+	return 0;
+}
+
+int sam_cio_group_session_create(struct sam_cio_group *grp, struct sam_session_params *params,
+				 struct sam_sa **sa)
+{
+	struct sam_sa **grp_sas;
+	int i, idx, rc;
+
+	if (grp->params.policy == SAM_CIO_GROUP_SA_AFFINITY) {
+		/* Spread sessions evenly over CIOs of the group */
+		idx = 0;
+		for (i = 1; i < grp->params.num_cios; i++) {
+			if (grp->sessions[i] < grp->sessions[idx])
+				idx = i;
+		}
+		rc = sam_session_create(grp->cios[idx], params, sa);
+		if (rc)
+			return rc;
+
+		grp->sessions[idx]++;
+		return 0;
+	}
+
+	/* Session is created on each CIO, the first one is used as handler */
+	grp_sas = kcalloc(grp->params.num_cios, sizeof(struct sam_sa *), GFP_KERNEL);
+	if (!grp_sas) {
+		pr_err("Can't allocate %u * %lu bytes for group sessions\n",
+			grp->params.num_cios, sizeof(struct sam_sa *));
+		return -ENOMEM;
+	}
+
+	for (i = 0; i < grp->params.num_cios; i++) {
+		rc = sam_session_create(grp->cios[i], params, &grp_sas[i]);
+		if (rc) {
+			pr_err("%s: Can't create session on CIO #%d\n", __func__, i);
+			goto err;
+		}
+		grp->sessions[i]++;
+	}
+	grp_sas[0]->grp_sas = grp_sas;
+	*sa = grp_sas[0];
+
+	return 0;
+err:
+	while (i--) {
+		sam_session_destroy(grp_sas[i]);
+		grp->sessions[i]--;
+	}
+	kfree(grp_sas);
+
+	return rc;
+}
+
+int sam_cio_group_session_destroy(struct sam_cio_group *grp, struct sam_sa *sa)
+{
+	struct sam_sa **grp_sas = sa->grp_sas;
+	int i, idx, rc;
+
+	if (!grp_sas) {
+		idx = sam_cio_group_cio_idx(grp, sa->cio);
+		if (idx < 0) {
+			pr_err("%s: session doesn't belong to the group\n", __func__);
+			return -EINVAL;
+		}
+		rc = sam_session_destroy(sa);
+		if (!rc)
+			grp->sessions[idx]--;
+
+		return rc;
+	}
+
+	sa->grp_sas = NULL;
+	for (i = 0; i < grp->params.num_cios; i++) {
+		/* Already destroyed by a previous call that failed on a later CIO */
+		if (!grp_sas[i])
+			continue;
+
+		rc = sam_session_destroy(grp_sas[i]);
+		if (rc) {
+			pr_err("%s: Can't destroy session on CIO #%d\n", __func__, i);
+			/* Keep sessions that are not destroyed yet reachable, for a retry */
+			sa->grp_sas = grp_sas;
+			return rc;
+		}
+		grp_sas[i] = NULL;
+		grp->sessions[i]--;
+	}
+	kfree(grp_sas);
+
+	return 0;
+}
+
+int sam_cio_group_enq(struct sam_cio_group *grp, struct sam_cio_op_params *requests, u16 *num)
+{
+	struct sam_cio_op_params request;
+	struct sam_cio_group_ticket *ticket;
+	u32 kick_mask = 0;
+	int i, idx, err = 0;
+	u16 cnt;
+
+	for (i = 0; i < *num; i++) {
+		if (sam_cio_group_next_ticket(grp, grp->tail) == grp->head)
+			break;
+
+		idx = sam_cio_group_cio_select(grp, requests[i].sa);
+		if (idx < 0) {
+			if (idx != -EBUSY)
+				err = idx;
+			break;
+		}
+
+		ticket = &grp->tickets[grp->tail];
+
+		/* Ticket is used as cookie to match result with the request */
+		request = requests[i];
+		request.cookie = ticket;
+		if (request.sa->grp_sas)
+			request.sa = request.sa->grp_sas[idx];
+
+		cnt = 1;
+		err = sam_cio_enq(grp->cios[idx], &request, &cnt);
+		if (err || !cnt)
+			break;
+
+		ticket->cookie = requests[i].cookie;
+		ticket->sa = requests[i].sa;
+		ticket->cio = idx;
+		ticket->done = false;
+		ticket->consumed = false;
+
+		grp->depth[idx]++;
+		kick_mask |= BIT(idx);
+		grp->tail = sam_cio_group_next_ticket(grp, grp->tail);
+	}
+
+	/* Ring doorbell once per CIO for CIOs with deferred submit */
+	for (idx = 0; kick_mask; idx++, kick_mask >>= 1) {
+		if (kick_mask & 1)
+			sam_cio_kick(grp->cios[idx]);
+	}
+	*num = (u16)i;
+
+	return err;
+}
+
+/* Collect results from all CIOs of the group into tickets */
+static int sam_cio_group_harvest(struct sam_cio_group *grp)
+{
+	struct sam_cio_group_ticket *ticket;
+	int i, j, rc;
+	u16 num;
+
+	for (i = 0; i < grp->params.num_cios; i++) {
+		/* Skip CIOs without outstanding operations - no HW access */
+		if (!grp->depth[i])
+			continue;
+
+		num = min(grp->depth[i], grp->deq_buf_size);
+		rc = sam_cio_deq(grp->cios[i], grp->deq_buf, &num);
+		if (rc)
+			return rc;
+
+		for (j = 0; j < num; j++) {
+			ticket = grp->deq_buf[j].cookie;
+			ticket->result = grp->deq_buf[j];
+			ticket->result.cookie = ticket->cookie;
+			ticket->done = true;
+		}
+		grp->depth[i] -= num;
+	}
+	return 0;
+}
+
+static inline bool sam_cio_group_sa_is_blocked(struct sam_sa **blocked, int num, struct sam_sa *sa)
+{
+	int i;
+
+	for (i = 0; i < num; i++) {
+		if (blocked[i] == sa)
+			return true;
+	}
+	return false;
+}
+
+int sam_cio_group_deq(struct sam_cio_group *grp, struct sam_cio_op_result *results, u16 *num)
+{
+	struct sam_sa *blocked[SAM_CIO_GROUP_MAX_BLOCKED];
+	struct sam_cio_group_ticket *ticket;
+	int rc, num_blocked = 0;
+	u32 idx, count = 0;
+
+	rc = sam_cio_group_harvest(grp);
+	if (rc) {
+		*num = 0;
+		return rc;
+	}
+
+	/* Walk operations in enqueue order. Result is returned only if all previous
+	 * operations of the same session are already returned.
+	 */
+	for (idx = grp->head; (idx != grp->tail) && (count < *num);
+	     idx = sam_cio_group_next_ticket(grp, idx)) {
+		ticket = &grp->tickets[idx];
+		if (ticket->consumed)
+			continue;
+
+		if (sam_cio_group_sa_is_blocked(blocked, num_blocked, ticket->sa))
+			continue;
+
+		if (!ticket->done) {
+			if (num_blocked == SAM_CIO_GROUP_MAX_BLOCKED)
+				break;
+			blocked[num_blocked++] = ticket->sa;
+			continue;
+		}
+		results[count++] = ticket->result;
+		ticket->consumed = true;
+	}
+
+	/* Release returned tickets */
+	while ((grp->head != grp->tail) && grp->tickets[grp->head].consumed)
+		grp->head = sam_cio_group_next_ticket(grp, grp->head);
+
+	*num = (u16)count;
+
+	return 0;
+}
+
+u32 sam_cio_group_depth_get(struct sam_cio_group *grp, u32 idx)
+{
+	if (idx >= grp->params.num_cios)
+		return 0;
+
+	return grp->depth[idx];
+}
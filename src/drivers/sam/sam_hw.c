@@ -30,8 +30,11 @@
  *  POSSIBILITY OF SUCH DAMAGE.
  *****************************************************************************/
 
+#include <poll.h>
+
 #include "std_internal.h"
 #include "env/sys_iomem.h"
+#include "lib/uio_helper.h"
 
 #include "drivers/mv_sam.h"
 #include "sam.h"
@@ -198,7 +201,7 @@ int sam_hw_rdr_regs_reset(struct sam_hw_ring *hw_ring)
 
 int sam_hw_rdr_regs_init(struct sam_hw_ring *hw_ring)
 {
-	u32 val32;
+	u32 val32, desc_words;
 
 	val32 = lower_32_bits(hw_ring->rdr_buf.paddr);
 	sam_hw_reg_write(hw_ring->regs_vbase, HIA_RDR_RING_BASE_ADDR_LO_REG, val32);
@@ -211,16 +214,24 @@ int sam_hw_rdr_regs_init(struct sam_hw_ring *hw_ring)
 	sam_hw_reg_write(hw_ring->regs_vbase, HIA_RDR_RING_SIZE_REG, val32);
 
 	if (hw_ring->type == HW_EIP197)
-		val32 = SAM_RING_DESC_SIZE_VAL(SAM_RDR_DSCR_EXT_WORD_COUNT); /* Extended Command descriptor */
+		desc_words = SAM_RDR_DSCR_EXT_WORD_COUNT; /* Extended Command descriptor */
 	else
-		val32 = SAM_RING_DESC_SIZE_VAL(SAM_RDR_DSCR_WORD_COUNT); /* Basic Command descriptor */
+		desc_words = SAM_RDR_DSCR_WORD_COUNT; /* Basic Command descriptor */
+
+	/* Ownership word is placed right after result descriptor */
+	hw_ring->own_word = desc_words;
+	if (hw_ring->own_mode)
+		desc_words++;
 
+	val32 = SAM_RING_DESC_SIZE_VAL(desc_words);
 	val32 |= SAM_RING_DESC_OFFSET_VAL(SAM_RDR_ENTRY_WORDS); /* distance between descriptors */
 	val32 |= SAM_RING_64B_MODE_MASK; /* 64 bits mode */
 	sam_hw_reg_write(hw_ring->regs_vbase, HIA_RDR_DESC_SIZE_REG, val32);
 
 	val32 = SAM_RING_FETCH_SIZE_VAL(0x50);		/* Number of words to fetch */
 	val32 |= SAM_RING_FETCH_THRESH_VAL(0x14);	/* Threshold in words to start fetch */
+	if (hw_ring->own_mode)
+		val32 |= SAM_RING_OWN_MODE_EN_MASK;	/* Write ownership word after result descriptor */
 	sam_hw_reg_write(hw_ring->regs_vbase, HIA_RDR_CFG_REG, val32);
 
 	val32 = SAM_RING_DESC_SWAP_VAL(CONF_DESC_SWAP_VALUE);      /* rd_swap */
@@ -271,13 +282,17 @@ int sam_hw_ring_init(u32 engine, u32 ring, struct sam_cio_params *params,
 	hw_ring->type = engine_info->type;
 	hw_ring->ring = ring;
 	hw_ring->ring_size = params->size; /* number of descriptors in the ring */
+	hw_ring->own_mode = (params->compl_mode == SAM_CIO_COMPL_DESC);
+	hw_ring->irq_fd = -1;
 
 	if (engine_info->type == HW_EIP197) {
 		hw_ring->regs_vbase = (((char *)engine_info->vaddr) + SAM_EIP197_RING_REGS_OFFS(ring));
 		hw_ring->paddr = engine_info->paddr + SAM_EIP197_RING_REGS_OFFS(ring);
+		hw_ring->aic_vbase = (((char *)engine_info->vaddr) + SAM_EIP197_AIC_REGS_OFFS);
 	} else if (engine_info->type == HW_EIP97) {
 		hw_ring->regs_vbase = (((char *)engine_info->vaddr) + SAM_EIP97_RING_REGS_OFFS(ring));
 		hw_ring->paddr = engine_info->paddr + SAM_EIP97_RING_REGS_OFFS(ring);
+		hw_ring->aic_vbase = (((char *)engine_info->vaddr) + SAM_EIP97_AIC_REGS_OFFS);
 	} else {
 		pr_err("%s: Unexpected HW type = %d\n", __func__, engine_info->type);
 		rc = -EINVAL;
@@ -337,6 +352,8 @@ int sam_hw_ring_deinit(struct sam_hw_ring *hw_ring)
 {
 	struct sam_hw_engine_info *engine_info = &sam_hw_engine_info[hw_ring->engine];
 
+	sam_hw_ring_irq_deinit(hw_ring);
+
 	if (hw_ring->regs_vbase) {
 		sam_hw_cdr_regs_reset(hw_ring);
 		sam_hw_rdr_regs_reset(hw_ring);
@@ -354,6 +371,97 @@ int sam_hw_ring_deinit(struct sam_hw_ring *hw_ring)
 	return 0;
 }
 
+int sam_hw_ring_irq_init(struct sam_hw_ring *hw_ring)
+{
+	struct uio_info_t *info;
+	char name[UIO_MAX_NAME_SIZE];
+	char dev_name[16];
+	u32 val32;
+	int fd;
+
+	if (hw_ring->irq_fd >= 0)
+		return 0;
+
+	/* Ring interrupt is exposed by SAM UIO module as separate UIO device */
+	snprintf(name, sizeof(name), "uio_%s_%d_ring%d",
+		 sam_supported_name[hw_ring->type], hw_ring->engine, hw_ring->ring);
+	info = uio_find_devices_byname(name);
+	if (!info) {
+		pr_err("UIO device (%s) for ring interrupt not found\n", name);
+		return -ENODEV;
+	}
+	snprintf(dev_name, sizeof(dev_name), "/dev/uio%d", info->uio_num);
+	uio_free_info(info);
+
+	fd = open(dev_name, O_RDWR);
+	if (fd < 0) {
+		pr_err("Can't open %s for ring interrupt\n", dev_name);
+		return -ENODEV;
+	}
+	hw_ring->irq_fd = fd;
+
+	/* Raise RDR interrupt when at least one result is ready */
+	val32 = SAM_RDR_THRESH_PKT_MODE_MASK | SAM_RDR_THRESH_PROC_PKT_VAL(1);
+	sam_hw_reg_write(hw_ring->regs_vbase, HIA_RDR_THRESH_REG, val32);
+
+	return 0;
+}
+
+void sam_hw_ring_irq_deinit(struct sam_hw_ring *hw_ring)
+{
+	if (hw_ring->irq_fd < 0)
+		return;
+
+	sam_hw_reg_write(hw_ring->aic_vbase, SAM_AIC_R_ENABLE_CLR_REG(hw_ring->ring),
+			 SAM_AIC_RDR_IRQ(hw_ring->ring));
+	sam_hw_reg_write(hw_ring->regs_vbase, HIA_RDR_THRESH_REG, 0);
+
+	close(hw_ring->irq_fd);
+	hw_ring->irq_fd = -1;
+}
+
+int sam_hw_ring_irq_arm(struct sam_hw_ring *hw_ring)
+{
+	u32 irq_on = 1;
+
+	/* Clear RDR threshold status and acknowledge ring interrupt */
+	sam_hw_reg_write(hw_ring->regs_vbase, HIA_RDR_STAT_REG, SAM_RDR_STAT_IRQ_MASK);
+	sam_hw_reg_write(hw_ring->aic_vbase, SAM_AIC_R_ACK_REG(hw_ring->ring),
+			 SAM_AIC_RDR_IRQ(hw_ring->ring));
+	sam_hw_reg_write(hw_ring->aic_vbase, SAM_AIC_R_ENABLE_CTRL_REG(hw_ring->ring),
+			 SAM_AIC_RDR_IRQ(hw_ring->ring));
+
+	/* Unmask IRQ line masked by UIO interrupt handler */
+	if (write(hw_ring->irq_fd, &irq_on, sizeof(irq_on)) != sizeof(irq_on)) {
+		pr_err("%d:%d: Can't enable ring interrupt\n", hw_ring->engine, hw_ring->ring);
+		return -EIO;
+	}
+	return 0;
+}
+
+int sam_hw_ring_irq_wait(struct sam_hw_ring *hw_ring, int timeout_ms)
+{
+	struct pollfd pfd;
+	u32 irq_count;
+	int rc;
+
+	pfd.fd = hw_ring->irq_fd;
+	pfd.events = POLLIN;
+	pfd.revents = 0;
+
+	rc = poll(&pfd, 1, timeout_ms);
+	if (rc < 0)
+		return -errno;
+	if (rc == 0)
+		return -ETIMEDOUT;
+
+	/* Consume UIO event counter */
+	if (read(hw_ring->irq_fd, &irq_count, sizeof(irq_count)) != sizeof(irq_count))
+		return -EIO;
+
+	return 0;
+}
+
 int sam_hw_session_invalidate(struct sam_hw_ring *hw_ring, struct sam_buf_info *sa_buf,
 				u32 next_request)
 {
@@ -52,6 +52,18 @@
 #define SAM_EIP197_RING_REGS_OFFS(ring) (0x80000 + (ring) * 0x1000)
 #define SAM_EIP97_RING_REGS_OFFS(ring)  (0x0 + (ring) * 0x1000)
 
+/* Ring Advanced Interrupt Controller (AIC) registers */
+#define SAM_EIP197_AIC_REGS_OFFS	0x90000
+#define SAM_EIP97_AIC_REGS_OFFS		0x0
+
+#define SAM_AIC_R_OFFS(ring)		((ring) * 0x1000)
+#define SAM_AIC_R_ENABLE_CTRL_REG(ring)	(0xE008 - SAM_AIC_R_OFFS(ring))
+#define SAM_AIC_R_ACK_REG(ring)		(0xE010 - SAM_AIC_R_OFFS(ring))
+#define SAM_AIC_R_ENABLE_CLR_REG(ring)	(0xE014 - SAM_AIC_R_OFFS(ring))
+
+#define SAM_AIC_CDR_IRQ(ring)		BIT((ring) * 2)
+#define SAM_AIC_RDR_IRQ(ring)		BIT((ring) * 2 + 1)
+
 /* CDR and RDR Registers addresses and fields */
 #define HIA_RDR_REGS_OFFSET		0x800
 
@@ -150,6 +162,9 @@
 #define SAM_RING_OFLO_IRQ_EN_MASK		BIT(25)
 #define SAM_RING_OWN_MODE_EN_MASK		BIT(31)
 
+/* Pattern written by HW to ownership word of result descriptor when own_mode is enabled */
+#define SAM_RDR_OWN_WORD_PATTERN		0xAAAAAAAA
+
 /* HIA_RDR_y_DMA_CFG and HIA_CDR_y_DMA_CFG registers */
 /* ACD relevant fields are valid only for CDR_DMA_CFG register */
 #define SAM_RING_DESC_SWAP_OFFS			0
@@ -192,6 +207,12 @@
 #define SAM_RING_WRITE_CACHE_VAL(val)		(((val) & SAM_RING_CACHE_CTRL_MASK) << SAM_RING_WRITE_CACHE_OFFS)
 #define SAM_RING_READ_CACHE_VAL(val)		(((val) & SAM_RING_CACHE_CTRL_MASK) << SAM_RING_READ_CACHE_OFFS)
 
+/* HIA_RDR_y_THRESH register */
+#define SAM_RDR_THRESH_PROC_PKT_BITS		22
+#define SAM_RDR_THRESH_PROC_PKT_MASK		BIT_MASK(SAM_RDR_THRESH_PROC_PKT_BITS)
+#define SAM_RDR_THRESH_PROC_PKT_VAL(pkts)	((pkts) & SAM_RDR_THRESH_PROC_PKT_MASK)
+#define SAM_RDR_THRESH_PKT_MODE_MASK		BIT(23)
+
 /* HIA_CDR_y_STAT register */
 #define SAM_CDR_STAT_IRQ_OFFS			0
 #define SAM_CDR_STAT_IRQ_BITS			6
@@ -343,6 +364,10 @@ struct sam_hw_ring {
 	struct sam_buf_info rdr_buf;            /* DMA memory buffer allocated for result descriptors */
 	struct sam_hw_cmd_desc *cmd_desc_first;	/* Pointer to first command descriptors in DMA memory */
 	struct sam_hw_res_desc *res_desc_first;	/* Pointer to first command descriptors in DMA memory */
+	bool own_mode;				/* RDR ownership word mode is enabled */
+	u32 own_word;				/* Index of ownership word in result descriptor */
+	void *aic_vbase;			/* virtual address for engine AIC registers */
+	int irq_fd;				/* UIO device file for ring interrupt, -1 - not opened */
 };
 
 static inline void sam_hw_reg_write_relaxed(void *base, u32 offset, u32 data)
@@ -423,6 +448,25 @@ static inline void sam_hw_rdr_prep_desc_write(struct sam_hw_res_desc *res_desc,
 	writel_relaxed(upper_32_bits(dst_paddr), &res_desc->words[3]);
 }
 
+/* Clear ownership word, so completion can be detected when HW writes it back */
+static inline void sam_hw_rdr_own_word_clear(struct sam_hw_ring *hw_ring,
+					     struct sam_hw_res_desc *res_desc)
+{
+	if (hw_ring->own_mode)
+		writel_relaxed(0, &res_desc->words[hw_ring->own_word]);
+}
+
+static inline bool sam_hw_rdr_own_word_is_set(struct sam_hw_ring *hw_ring,
+					      struct sam_hw_res_desc *res_desc)
+{
+	if (readl_relaxed(&res_desc->words[hw_ring->own_word]) != SAM_RDR_OWN_WORD_PATTERN)
+		return false;
+
+	/* Read rest of result descriptor only after ownership word */
+	rmb();
+	return true;
+}
+
 static inline void sam_hw_cdr_cmd_desc_write(struct sam_hw_cmd_desc *cmd_desc,
 					     dma_addr_t src_paddr, u32 data_bytes,
 					     dma_addr_t token_paddr, u32 token_words)
@@ -456,6 +500,7 @@ static inline void sam_hw_ring_basic_desc_write(struct sam_hw_ring *hw_ring, int
 
 	/* Write prepared RDR descriptor first */
 	sam_hw_rdr_prep_desc_write(res_desc, dst_buf->paddr, dst_buf->len);
+	sam_hw_rdr_own_word_clear(hw_ring, res_desc);
 
 	/* Write CDR descriptor */
 	sam_hw_cdr_cmd_desc_write(cmd_desc, src_buf->paddr, copy_len,
@@ -487,6 +532,7 @@ static inline void sam_hw_ring_desc_write(struct sam_hw_ring *hw_ring, int next_
 
 	/* Write prepared RDR descriptor first */
 	sam_hw_rdr_prep_desc_write(res_desc, dst_buf->paddr, dst_buf->len);
+	sam_hw_rdr_own_word_clear(hw_ring, res_desc);
 
 	/* Write CDR descriptor */
 	sam_hw_cdr_cmd_desc_write(cmd_desc, src_buf->paddr, copy_len,
@@ -526,6 +572,7 @@ static inline void sam_hw_ring_sa_inv_desc_write(struct sam_hw_ring *hw_ring, in
 	/* Write NULL to Destination Packet Data address */
 	writel_relaxed(0, &res_desc->words[2]);
 	writel_relaxed(0, &res_desc->words[3]);
+	sam_hw_rdr_own_word_clear(hw_ring, res_desc);
 
 	writel_relaxed(ctrl_word, &cmd_desc->words[0]);
 	writel_relaxed(0, &cmd_desc->words[1]); /* skip this write */
@@ -631,6 +678,10 @@ int sam_hw_ring_init(u32 engine, u32 ring, struct sam_cio_params *params,
 int sam_hw_ring_deinit(struct sam_hw_ring *hw_ring);
 int sam_hw_engine_load(void);
 int sam_hw_engine_unload(void);
+int sam_hw_ring_irq_init(struct sam_hw_ring *hw_ring);
+void sam_hw_ring_irq_deinit(struct sam_hw_ring *hw_ring);
+int sam_hw_ring_irq_arm(struct sam_hw_ring *hw_ring);
+int sam_hw_ring_irq_wait(struct sam_hw_ring *hw_ring, int timeout_ms);
 int sam_hw_session_invalidate(struct sam_hw_ring *hw_ring, struct sam_buf_info *sa_buf,
 				u32 next_request);
 void print_cmd_desc(struct sam_hw_cmd_desc *cmd_desc);
@@ -75,17 +75,29 @@ enum pp2_cls_qos_tbl_type {
 };
 
 /**
- * TODO: Future
- * enum pp2_cls_tbl_statistics_mode {
- *	PP2_CLS_TBL_STATS_M_NONE = 0,
- *	PP2_CLS_TBL_STATS_M_FRM,
- *	PP2_CLS_TBL_STATS_M_BYTES
- * };
+ * classifier table statistics mode
+ *
+ * The HW counts lookup hits only, so per-rule byte counters are not supported.
+ */
+enum pp2_cls_tbl_statistics_mode {
+	PP2_CLS_TBL_STATS_M_NONE = 0,	/**< No per-rule statistics */
+	PP2_CLS_TBL_STATS_M_FRM		/**< Per-rule frame (hit) counters */
+};
+
+/**
+ * classifier table aging mode
  */
+enum pp2_cls_tbl_aging_mode {
+	PP2_CLS_TBL_AGING_M_NONE = 0,	/**< Rules are never aged */
+	/** Rules with no hit for 'aging_timeout_ms' are removed by pp2_cls_tbl_stats_poll() */
+	PP2_CLS_TBL_AGING_M_IDLE
+};
+
 enum pp2_cls_tbl_action_type {
 	PP2_CLS_TBL_ACT_DROP = 0,
 	PP2_CLS_TBL_ACT_DONE,
-	/* TODO: PP2_CLS_TBL_ACT_LU */
+	/** Continue the lookup in 'next_tbl'; valid only in a maskable table chained to it */
+	PP2_CLS_TBL_ACT_LU
 };
 
 struct pp2_cls_cos_desc {
@@ -93,18 +105,23 @@ struct pp2_cls_cos_desc {
 	u8		 tc;
 };
 
+/**
+ * classifier rule mark type
+ */
+enum pp2_cls_tbl_mark_type {
+	PP2_CLS_TBL_MARK_TYPE_NONE = 0,	/**< No mark */
+	/** Write 'u.flow_id' to the RX descriptor, see pp2_ppio_inq_desc_get_flow_id() */
+	PP2_CLS_TBL_MARK_TYPE_FLOW_ID
+};
+
 struct pp2_cls_tbl_action {
 	enum pp2_cls_tbl_action_type		type;
-	/* TODO: struct pp2_cls_tbl			*next_tbl; */
-	/**< valid only in case of next-action is LU */
-	/* TODO: enum pp2_cls_tbl_mark_type	 mark_type; */
-	/*
-	* TODO :
-	* union {
-	*	u16			 flow_id;
-	*	u16			 qos;
-	* } u;
-	*/
+	struct pp2_cls_tbl			*next_tbl;	/**< valid only in case of next-action is LU */
+	enum pp2_cls_tbl_mark_type		mark_type;
+	union {
+		u16				flow_id;	/**< valid only with PP2_CLS_TBL_MARK_TYPE_FLOW_ID */
+		/* TODO: u16			qos; */
+	} u;
 	/** 'NULL' value means no-cos change; i.e. keep original cos */
 	struct pp2_cls_cos_desc		*cos;
 };
@@ -119,10 +136,22 @@ struct pp2_cls_tbl_params {
 	enum pp2_cls_tbl_type			 type;
 	u16					 max_num_rules;
 	struct pp2_cls_tbl_key			 key;
-	/* TODO: enum pp2_cls_tbl_statistics_mode	 stats_mode; */
-	/* TODO: enum pp2_cls_tbl_aging_mode	 aging_mode; */
+	enum pp2_cls_tbl_statistics_mode	 stats_mode;
+	/** Minimal interval between two HW counter harvests, in msec; 0 means every poll */
+	u32					 stats_interval_ms;
+	enum pp2_cls_tbl_aging_mode		 aging_mode;
+	/** Idle time after which a rule is aged, in msec; valid only with PP2_CLS_TBL_AGING_M_IDLE */
+	u32					 aging_timeout_ms;
 	/* TODO: enum pp2_cls_tbl_priority_mode	 prio_mode; */
 	struct pp2_cls_tbl_action		 default_act;
+	/**
+	 * Exact match table looked up after this table, 'NULL' if none.
+	 * Valid only for a maskable table; rules with PP2_CLS_TBL_ACT_LU continue
+	 * into it, other rules end the lookup. The exact match table must be on the
+	 * same ppio, must have no rules when first chained and can be chained to a
+	 * single table at a time.
+	 */
+	struct pp2_cls_tbl			*next_tbl;
 };
 
 /**
@@ -186,6 +215,9 @@ struct pp2_cls_tbl_rule {
 /**
  * Add a classifier rule
  *
+ * If a batch update is open on the table (see pp2_cls_tbl_begin()), the rule
+ * is only staged and is written to HW by pp2_cls_tbl_commit().
+ *
  * @param[in]	tbl		A pointer to a classifier table object
  * @param[in]	rule		A pointer to a classifier rule
  * @param[in]	action		A pointer to a classifier action
@@ -201,7 +233,7 @@ int pp2_cls_tbl_add_rule(struct pp2_cls_tbl		*tbl,
 /**
  * Modify the action of an existing classifier rule
  *
- * The rule must be already in place
+ * The rule must be already in place (or staged for add in an open batch update)
  *
  * @param[in]	tbl		A pointer to a classifier table object
  * @param[in]	rule		A pointer to a classifier rule
@@ -217,6 +249,8 @@ int pp2_cls_tbl_modify_rule(struct pp2_cls_tbl		*tbl,
 /**
  * Remove a classifier rule
  *
+ * If a batch update is open on the table, the removal is only staged.
+ *
  * @param[in]	tbl		A pointer to a classifier table object
  * @param[in]	rule		A pointer to a classifier rule
  *
@@ -226,6 +260,129 @@ int pp2_cls_tbl_modify_rule(struct pp2_cls_tbl		*tbl,
 int pp2_cls_tbl_remove_rule(struct pp2_cls_tbl		*tbl,
 			    struct pp2_cls_tbl_rule	*rule);
 
+/**
+ * classifier batch update statistics
+ */
+struct pp2_cls_tbl_commit_stats {
+	u32	num_add;	/**< Number of rules added */
+	u32	num_modify;	/**< Number of rules whose action was modified */
+	u32	num_remove;	/**< Number of rules removed */
+	u32	num_hw_writes;	/**< Number of HW entries written or invalidated, entry moves included */
+	u64	usecs;		/**< Time spent writing the batch to HW, in usec */
+};
+
+/**
+ * Open a batch update on a classifier table
+ *
+ * Until pp2_cls_tbl_commit() or pp2_cls_tbl_abort() is called, rules added,
+ * modified or removed on the table are staged in SW only. Staged operations
+ * on the same rule are merged, e.g. a remove followed by an add becomes a
+ * modify of the rule action.
+ *
+ * @param[in]	tbl		A pointer to a classifier table object
+ *
+ * @retval	0 on success
+ * @retval	-EBUSY if a batch update is already open on the table
+ * @retval	error-code otherwise
+ */
+int pp2_cls_tbl_begin(struct pp2_cls_tbl *tbl);
+
+/**
+ * Write a batch update to HW and close it
+ *
+ * All staged rules are validated and converted to HW entries before the
+ * first HW access. New rules are then added, modified rules get their new
+ * action in place and finally removed rules are deleted, so a packet is always
+ * classified by either the previous or the new version of each rule.
+ * If a HW write fails, the operations already applied are rolled back and an
+ * error is returned; rules removed by the batch may then miss until they are
+ * added back.
+ * The batch is closed whether the commit succeeds or not.
+ *
+ * @param[in]	tbl		A pointer to a classifier table object
+ * @param[out]	stats		Batch statistics, may be NULL
+ *
+ * @retval	0 on success
+ * @retval	error-code otherwise
+ */
+int pp2_cls_tbl_commit(struct pp2_cls_tbl *tbl, struct pp2_cls_tbl_commit_stats *stats);
+
+/**
+ * Discard a batch update without writing it to HW
+ *
+ * @param[in]	tbl		A pointer to a classifier table object
+ */
+void pp2_cls_tbl_abort(struct pp2_cls_tbl *tbl);
+
+/**
+ * classifier rule statistics
+ */
+struct pp2_cls_tbl_rule_stats {
+	struct pp2_cls_tbl_rule	*rule;		/**< The table copy of the rule, valid until the rule is removed */
+	u64			 pkts;		/**< Number of hits since the rule was added */
+	u64			 idle_ms;	/**< Time since the last harvested hit, in msec */
+};
+
+/**
+ * Harvest the HW hit counters of a classifier table and age idle rules
+ *
+ * The HW hit counters are narrow and wrap, so this function should be called
+ * periodically, e.g. from the application control loop. Counters are read at
+ * most once per 'stats_interval_ms'; a call made before the interval expires
+ * returns immediately. Harvested hits are accumulated into 64-bit counters.
+ * If the table aging mode is PP2_CLS_TBL_AGING_M_IDLE, rules idle for more than
+ * 'aging_timeout_ms' are removed. Aging is skipped while a batch update is open.
+ *
+ * @param[in]	tbl		A pointer to a classifier table object
+ * @param[out]	num_aged	Number of rules removed by aging, may be NULL
+ *
+ * @retval	0 on success
+ * @retval	-EOPNOTSUPP if statistics are not enabled on the table
+ * @retval	error-code otherwise
+ */
+int pp2_cls_tbl_stats_poll(struct pp2_cls_tbl *tbl, u32 *num_aged);
+
+/**
+ * Get the statistics of a classifier rule
+ *
+ * The returned values are as of the last pp2_cls_tbl_stats_poll().
+ *
+ * @param[in]	tbl		A pointer to a classifier table object
+ * @param[in]	rule		A pointer to a classifier rule
+ * @param[out]	stats		A pointer to the rule statistics
+ *
+ * @retval	0 on success
+ * @retval	-ENOENT if the rule is not in the table
+ * @retval	error-code otherwise
+ */
+int pp2_cls_tbl_rule_stats_get(struct pp2_cls_tbl *tbl, struct pp2_cls_tbl_rule *rule,
+			       struct pp2_cls_tbl_rule_stats *stats);
+
+/**
+ * Get the most hit rules of a classifier table
+ *
+ * @param[in]		tbl	A pointer to a classifier table object
+ * @param[out]		stats	An array of rule statistics, sorted by descending hit count
+ * @param[in,out]	num	input: size of 'stats'; output: number of entries returned
+ *
+ * @retval	0 on success
+ * @retval	error-code otherwise
+ */
+int pp2_cls_tbl_top_n_get(struct pp2_cls_tbl *tbl, struct pp2_cls_tbl_rule_stats stats[], u32 *num);
+
+/**
+ * Get the rules of a classifier table that were not hit for a given time
+ *
+ * @param[in]		tbl	A pointer to a classifier table object
+ * @param[in]		idle_ms	Minimal idle time, in msec
+ * @param[out]		stats	An array of rule statistics
+ * @param[in,out]	num	input: size of 'stats'; output: number of entries returned
+ *
+ * @retval	0 on success
+ * @retval	error-code otherwise
+ */
+int pp2_cls_tbl_idle_get(struct pp2_cls_tbl *tbl, u64 idle_ms, struct pp2_cls_tbl_rule_stats stats[], u32 *num);
+
 /** @} */ /* end of grp_pp2_cls */
 
 #endif /* __MV_PP2_CLS_H__ */
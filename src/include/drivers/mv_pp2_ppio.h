@@ -172,6 +172,13 @@ struct pp2_ppio_inqs_params {
 struct pp2_ppio_outq_params {
 	u32	size;	/**< q_size in number of descriptors */
 	u8	weight; /**< The weight is relative among the PP-IO out-Qs */
+	u16	rsrv_chunk;	/**< Descriptors a thread reserves from the HW at once when its reserve
+				 * cannot take a send; 0: 64
+				 */
+	u16	rsrv_chunk_max;	/**< Upper bound for the reservation chunk, which grows with the observed
+				 * send burst sizes so that a reservation lasts several sends;
+				 * 0: rsrv_chunk, no growth. Up to size / 2.
+				 */
 
 /* TODO: add rate-limit (burst, throughput) */
 };
@@ -185,6 +192,8 @@ struct pp2_ppio_outq_statistics {
 	u64	enq_dec_to_ddr;	/**< ppio outq enqueue descriptors to DRAM counter */
 	u64	enq_buf_to_ddr;	/**< ppio outq enqueue buffers to DRAM counter */
 	u64	deq_desc;	/**< ppio outq packets dequeue counter */
+	u64	rsrv_req;	/**< descriptor reservation requests to HW, of all threads */
+	u64	rsrv_partial;	/**< reservation requests granted fewer descriptors than requested */
 };
 
 /**
@@ -276,6 +285,18 @@ struct pp2_ppio_nic_params {
 	u16	override_mru;
 };
 
+/**
+ * The enum below defines the tunnel encapsulations the parser can look into
+ */
+enum pp2_ppio_tunnel {
+	/** IPv4 in IPv4 (IP protocol 4), inner header without options */
+	PP2_PPIO_TUNNEL_IPIP = 0x1,
+	/** GRE (IP protocol 47) without optional fields, carrying IPv4 */
+	PP2_PPIO_TUNNEL_GRE = 0x2,
+	/** VXLAN (UDP destination port 4789), inner Ethernet/IPv4 */
+	PP2_PPIO_TUNNEL_VXLAN = 0x4
+};
+
 /**
  * ppio parameters
  *
@@ -290,9 +311,9 @@ struct pp2_ppio_params {
 	struct pp2_ppio_inqs_params	 inqs_params; /**<  ppio inq parameters structure */
 	struct pp2_ppio_outqs_params	 outqs_params; /**<  ppio outq parameters structure */
 	int				 maintain_stats; /**< ppio statistics maintaining flag.
-							  * If set, the statistics will be updated
-							  * automatically when number of rx/tx packets
-							  * reach defined threshold.
+							  * If set, the HW counters are harvested
+							  * by the statistics collector, see
+							  * pp2_stats_poll().
 							  */
 	union {
 		/** relevant only if PPIO type is 'PP2_PPIO_T_LOG' */
@@ -302,6 +323,11 @@ struct pp2_ppio_params {
 	} specific_type_params;
 
 	enum pp2_ppio_eth_start_hdr		eth_start_hdr;
+	/** Bit-mask of enum pp2_ppio_tunnel. Parser looks into the selected
+	 * encapsulations (outer IPv4 unicast), so that L3/L4 info, offsets and RSS
+	 * hash refer to the inner headers. Not supported on 'PP2_PPIO_T_LOG'.
+	 */
+	u32					tunnels;
 
 /* TODO: do we need extra pools per port?
  *	struct pp2_bpool		*pools[PP2_PPIO_TC_MAX_POOLS];
@@ -324,6 +350,57 @@ struct pp2_ppio_statistics {
 	u64	tx_packets;		/**< TX Packets Counter */
 };
 
+/**
+ * ppio MAC (MIB) statistics
+ *
+ * The HW counters are cleared on read; they are accumulated in these
+ * 64-bit counters on each read.
+ */
+struct pp2_ppio_mac_statistics {
+	/* Rx */
+	u64	rx_good_octets;		/**< RX good octets */
+	u64	rx_bad_octets;		/**< RX bad octets */
+	u64	rx_unicast;		/**< RX unicast frames */
+	u64	rx_broadcast;		/**< RX broadcast frames */
+	u64	rx_multicast;		/**< RX multicast frames */
+	u64	rx_fc;			/**< RX flow control (pause) frames */
+	u64	rx_fifo_overrun;	/**< RX frames dropped on FIFO overrun */
+	u64	rx_undersize;		/**< RX frames shorter than 64 bytes, with a good CRC */
+	u64	rx_fragments;		/**< RX frames shorter than 64 bytes, with a bad CRC */
+	u64	rx_oversize;		/**< RX frames longer than the MRU, with a good CRC */
+	u64	rx_jabber;		/**< RX frames longer than the MRU, with a bad CRC */
+	u64	rx_mac_errors;		/**< RX frames with a MAC receive error */
+	u64	rx_crc_errors;		/**< RX frames with a bad CRC */
+	/* RMON frame size histogram, Rx and/or Tx frames according to the MAC setting */
+	u64	frames_64;		/**< 64 bytes frames */
+	u64	frames_65_127;		/**< 65 to 127 bytes frames */
+	u64	frames_128_255;		/**< 128 to 255 bytes frames */
+	u64	frames_256_511;		/**< 256 to 511 bytes frames */
+	u64	frames_512_1023;	/**< 512 to 1023 bytes frames */
+	u64	frames_1024_max;	/**< 1024 bytes and longer frames */
+	/* Tx */
+	u64	tx_good_octets;		/**< TX good octets */
+	u64	tx_unicast;		/**< TX unicast frames */
+	u64	tx_multicast;		/**< TX multicast frames */
+	u64	tx_broadcast;		/**< TX broadcast frames */
+	u64	tx_fc;			/**< TX flow control (pause) frames */
+	u64	tx_crc_errors;		/**< TX frames sent with a bad CRC */
+	u64	collisions;		/**< collisions (half duplex) */
+	u64	late_collisions;	/**< late collisions (half duplex) */
+};
+
+/**
+ * ppio MAC rates, per second, over the last sampling period
+ */
+struct pp2_ppio_mac_rates {
+	u32	period_ms;		/**< actual sampling period, 0: no sample yet */
+	u64	rx_frames;		/**< RX good frames per second */
+	u64	rx_bits;		/**< RX good bits per second */
+	u64	rx_errors;		/**< RX error frames per second */
+	u64	tx_frames;		/**< TX frames per second */
+	u64	tx_bits;		/**< TX bits per second */
+};
+
 /**
  * Initialize a ppio
  *
@@ -468,6 +545,8 @@ enum pp2_inq_desc_status {
 /* cmd 5 */
 #define RXD_BUF_PHYS_HI_MASK       (0x000000FF)
 #define RXD_KEY_HASH_MASK          (0xFFFFFF00)
+#define RXD_FLOW_ID_HI_MASK        (0x0001FE00)
+#define RXD_FLOW_ID_LO_MASK        (0xFF000000)
 /* cmd 6 */
 #define RXD_BUF_VIRT_LO_MASK       (0xFFFFFFFF)
 /* cmd 7 */
@@ -637,6 +716,22 @@ static inline u64 pp2_ppio_inq_desc_get_cookie(struct pp2_ppio_desc *desc)
 
 struct pp2_ppio *pp2_ppio_inq_desc_get_pp_io(struct pp2_ppio_desc *desc); /*Note: under _DEBUG_*/
 
+/**
+ * Get the classifier flow ID from an inq packet descriptor.
+ *
+ * The flow ID is written by a classifier rule whose action mark_type is
+ * PP2_CLS_TBL_MARK_TYPE_FLOW_ID (see mv_pp2_cls.h). For packets that did not
+ * match such a rule, the returned value is not meaningful.
+ *
+ * @param[in]	desc	A pointer to a packet descriptor structure.
+ *
+ * @retval	flow ID
+ */
+static inline u16 pp2_ppio_inq_desc_get_flow_id(struct pp2_ppio_desc *desc)
+{
+	return ((desc->cmds[5] & RXD_FLOW_ID_HI_MASK) >> 1) | ((desc->cmds[5] & RXD_FLOW_ID_LO_MASK) >> 24);
+}
+
 /**
  * Get the packet length from an inq packet descriptor.
  *
@@ -725,6 +820,57 @@ static inline enum pp2_inq_desc_status pp2_ppio_inq_desc_get_pkt_error(struct pp
 	return PP2_DESC_ERR_L4_CHECKSUM;
 }
 
+#define PP2_PPIO_INQ_BURST_MAX	256	/**< max descriptors parsed at once by pp2_ppio_inq_descs_parse() */
+
+/**
+ * ppio inq burst metadata
+ *
+ * The fields of a burst of inq packet descriptors, one array per field. Entry i holds
+ * the value the corresponding pp2_ppio_inq_desc_get_*() getter returns for descriptor i.
+ */
+struct pp2_ppio_inq_burst {
+	u64		cookie[PP2_PPIO_INQ_BURST_MAX];		/**< pp2_ppio_inq_desc_get_cookie() */
+	dma_addr_t	phys_addr[PP2_PPIO_INQ_BURST_MAX];	/**< pp2_ppio_inq_desc_get_phys_addr() */
+	u16		len[PP2_PPIO_INQ_BURST_MAX];		/**< pp2_ppio_inq_desc_get_pkt_len() */
+	u8		l3_type[PP2_PPIO_INQ_BURST_MAX];	/**< enum pp2_inq_l3_type */
+	u8		l3_offset[PP2_PPIO_INQ_BURST_MAX];	/**< not including MH */
+	u8		l4_type[PP2_PPIO_INQ_BURST_MAX];	/**< enum pp2_inq_l4_type */
+	u8		l4_offset[PP2_PPIO_INQ_BURST_MAX];	/**< not including MH */
+	u8		status[PP2_PPIO_INQ_BURST_MAX];		/**< enum pp2_inq_desc_status */
+	u8		pool_id[PP2_PPIO_INQ_BURST_MAX];	/**< see pp2_ppio_inq_burst_get_bpool() */
+};
+
+/**
+ * Parse a burst of inq packet descriptors.
+ *
+ * Extracts the fields of all descriptors into per field arrays, reading each descriptor
+ * word once. This is equivalent to, and cheaper than, calling the pp2_ppio_inq_desc_get_*()
+ * getters on every descriptor. On ARMv8 the descriptors are parsed four at a time with NEON.
+ *
+ * @param[in]	descs	A pointer to an array of descriptors, as returned by pp2_ppio_recv().
+ * @param[in]	num	Number of descriptors, up to PP2_PPIO_INQ_BURST_MAX.
+ * @param[out]	burst	A pointer to the parsed burst; entries from num on are not written.
+ *
+ * @retval	0 on success
+ * @retval	error-code otherwise
+ */
+int pp2_ppio_inq_descs_parse(struct pp2_ppio_desc *descs, u16 num, struct pp2_ppio_inq_burst *burst);
+
+/**
+ * Get the bpool of a parsed inq packet descriptor.
+ *
+ * @param[in]	burst	A pointer to a burst parsed by pp2_ppio_inq_descs_parse().
+ * @param[in]	i	Index of the descriptor in the burst.
+ * @param[in]	ppio	A pointer to the PP-IO object the burst was received on.
+ *
+ * @retval	pointer to bpool
+ */
+static inline struct pp2_bpool *pp2_ppio_inq_burst_get_bpool(struct pp2_ppio_inq_burst *burst, u16 i,
+							     struct pp2_ppio *ppio)
+{
+	return &pp2_bpools[ppio->pp2_id][burst->pool_id[i]];
+}
+
 /**
  * Send a batch of frames (single dscriptor) on an OutQ of PP-IO.
  *
@@ -747,6 +893,49 @@ int pp2_ppio_send(struct pp2_ppio	*ppio,
 		  struct pp2_ppio_desc	*descs,
 		  u16			*num);
 
+#define PP2_PPIO_FWD_F_HW_RELEASE	BIT(0)	/* HW returns the buffers to their BM-Pool after TX */
+#define PP2_PPIO_FWD_F_L3_CSUM		BIT(1)	/* generate the IPv4 header checksum */
+#define PP2_PPIO_FWD_F_L4_CSUM		BIT(2)	/* generate the TCP/UDP checksum */
+
+/**
+ * Forward a batch of received frames (single descriptor) on an OutQ of PP-IO.
+ *
+ * Each in-Q descriptor, as returned by pp2_ppio_recv(), is converted in place to an out-Q
+ * descriptor and the whole batch is then sent as by pp2_ppio_send(). The conversion keeps
+ * the buffer address, cookie and BM-Pool of the frame, strips the Marvell header from the
+ * length and L3 offset, and carries the parsed L3/L4 types and IP header length over so the
+ * checksums can be generated by HW.
+ *
+ * Checksum generation is only requested for frames the parser identified: IPv4 for the L3
+ * checksum, non-fragmented TCP/UDP for the L4 checksum; it is disabled for all others.
+ *
+ * The payload must not have been moved within the buffer (use pkt_offset for the offset the
+ * frame starts at) and the frames must not be modified in a way that changes their length.
+ *
+ * Descriptors beyond the returned number were converted but not sent; their buffer
+ * address, cookie and BM-Pool remain readable through the in-Q getters
+ * (pp2_ppio_inq_desc_get_phys_addr(), pp2_ppio_inq_desc_get_cookie() and
+ * pp2_ppio_inq_desc_get_bpool()) so the caller can release them.
+ *
+ * @param[in]		ppio		A pointer to the PP-IO object to send on.
+ * @param[in]		hif		A hif handle.
+ * @param[in]		qid		out-Q id on which to send the frames.
+ * @param[in,out]	descs		A pointer to an array of received descriptors.
+ * @param[in,out]	num		input: number of frames to forward; output: number of frames sent.
+ * @param[in]		pkt_offset	offset of the frame (past the Marvell header) within its buffer.
+ * @param[in]		flags		PP2_PPIO_FWD_F_* flags.
+ *
+ * @retval	0 on success
+ * @retval	error-code otherwise
+ */
+int pp2_ppio_forward(struct pp2_ppio		*ppio,
+		     struct pp2_hif		*hif,
+		     u8				 qid,
+		     struct pp2_ppio_desc	*descs,
+		     u16			*num,
+		     u8				 pkt_offset,
+		     u32			 flags);
+
 /**
  * TODO - Send a batch of S/G frames (single or multiple dscriptors) on an OutQ of PP-IO.
  *
@@ -797,6 +986,123 @@ int pp2_ppio_get_num_outq_done(struct pp2_ppio	*ppio,
 int pp2_ppio_outq_get_statistics(struct pp2_ppio *ppio, u8 qid,
 				 struct pp2_ppio_outq_statistics *stats, int reset);
 
+/****************************************************************************
+ *	TX buffer API
+ *
+ * A TX buffer collects the frames a thread sends on one out-Q through one hif
+ * and sends them in bursts: each pp2_ppio_send() call checks the aggregated
+ * queue space, may reserve out-Q descriptors from HW, and rings the TX doorbell,
+ * whatever the number of frames sent. A TX buffer is used by a single thread,
+ * without locking.
+ ****************************************************************************/
+#define PP2_PPIO_TX_BUFFER_DEF_SIZE	64	/**< default TX buffer size */
+#define PP2_PPIO_TX_BUFFER_MAX_SIZE	512	/**< max TX buffer size */
+
+struct pp2_ppio_tx_buffer;
+
+/**
+ * TX buffer parameters
+ *
+ */
+struct pp2_ppio_tx_buffer_params {
+	struct pp2_ppio	*ppio;		/**< PP-IO to send on */
+	struct pp2_hif	*hif;		/**< hif of the thread using the TX buffer */
+	u8		 qid;		/**< out-Q id */
+	u16		 size;		/**< descriptors buffered before a flush, 0: PP2_PPIO_TX_BUFFER_DEF_SIZE */
+	u32		 drain_timeout_us; /**< age of the oldest buffered descriptor at which
+					    * pp2_ppio_tx_buffer_drain() flushes, 0: flush whatever is buffered
+					    */
+};
+
+/**
+ * TX buffer statistics
+ *
+ */
+struct pp2_ppio_tx_buffer_statistics {
+	u64	added;		/**< descriptors added */
+	u64	sent;		/**< descriptors sent */
+	u64	doorbells;	/**< pp2_ppio_send() calls that sent descriptors */
+	u64	flush_full;	/**< flushes of a full buffer */
+	u64	flush_timeout;	/**< flushes by pp2_ppio_tx_buffer_drain() */
+	u64	flush_explicit;	/**< flushes by pp2_ppio_tx_buffer_flush() */
+	u16	pending;	/**< descriptors buffered, not sent yet */
+};
+
+/**
+ * Create a TX buffer.
+ *
+ * @param[in]	params	A pointer to the TX buffer parameters.
+ * @param[out]	txb	A pointer to the opaque TX buffer object.
+ *
+ * @retval	0 on success
+ * @retval	error-code otherwise
+ */
+int pp2_ppio_tx_buffer_init(struct pp2_ppio_tx_buffer_params *params, struct pp2_ppio_tx_buffer **txb);
+
+/**
+ * Destroy a TX buffer.
+ *
+ * Buffered descriptors are flushed first; the ones the out-Q cannot take are discarded,
+ * and their buffers must be released by the caller.
+ *
+ * @param[in]	txb	A pointer to a TX buffer object.
+ */
+void pp2_ppio_tx_buffer_deinit(struct pp2_ppio_tx_buffer *txb);
+
+/**
+ * Add a batch of frames (single descriptor) to a TX buffer.
+ *
+ * The descriptors are copied into the buffer, which is flushed each time it fills up.
+ * Frames the buffer cannot take, because it remains full after a flush, are not added.
+ * Added frames are sent in order; the ones a flush could not send remain buffered.
+ *
+ * @param[in]		txb	A pointer to a TX buffer object.
+ * @param[in]		descs	A pointer to an array of descriptors, as for pp2_ppio_send().
+ * @param[in,out]	num	input: number of frames to add; output: number of frames added.
+ *
+ * @retval	0 on success
+ * @retval	error-code otherwise
+ */
+int pp2_ppio_tx_buffer_add(struct pp2_ppio_tx_buffer *txb, struct pp2_ppio_desc *descs, u16 *num);
+
+/**
+ * Send the frames buffered in a TX buffer.
+ *
+ * @param[in]	txb	A pointer to a TX buffer object.
+ * @param[out]	num	Number of frames sent; may be NULL.
+ *
+ * @retval	0 on success
+ * @retval	error-code otherwise
+ */
+int pp2_ppio_tx_buffer_flush(struct pp2_ppio_tx_buffer *txb, u16 *num);
+
+/**
+ * Send the frames buffered in a TX buffer once the oldest one waited drain_timeout_us.
+ *
+ * To be called periodically, e.g. once per polling round, so that frames do not
+ * stay buffered when traffic is too sparse to fill the buffer.
+ *
+ * @param[in]	txb	A pointer to a TX buffer object.
+ * @param[out]	num	Number of frames sent; may be NULL.
+ *
+ * @retval	0 on success
+ * @retval	error-code otherwise
+ */
+int pp2_ppio_tx_buffer_drain(struct pp2_ppio_tx_buffer *txb, u16 *num);
+
+/**
+ * Get TX buffer statistics
+ *
+ * @param[in]	txb	A pointer to a TX buffer object.
+ * @param[out]	stats	TX buffer statistics.
+ * @param[in]	reset	A flag indicates if counters should be reset.
+ *
+ * @retval	0 on success
+ * @retval	error-code otherwise
+ */
+int pp2_ppio_tx_buffer_get_statistics(struct pp2_ppio_tx_buffer *txb,
+				      struct pp2_ppio_tx_buffer_statistics *stats, int reset);
+
 
 /**
  * Receive packets on a ppio.
@@ -1002,6 +1308,9 @@ int pp2_ppio_flush_vlan(struct pp2_ppio *ppio);
 /**
  * Get ppio statistics
  *
+ * The HW counters of the ppio are harvested, and the port counters are summed
+ * from a consistent snapshot of all its queues.
+ *
  * @param[in]		ppio	A pointer to a PP-IO object.
  * @param[out]		stats	Port statistics.
  * @param[in]		reset	A flag indicates if counters should be reset.
@@ -1009,7 +1318,148 @@ int pp2_ppio_flush_vlan(struct pp2_ppio *ppio);
  */
 int pp2_ppio_get_statistics(struct pp2_ppio *ppio, struct pp2_ppio_statistics *stats, int reset);
 
-/*TODO: link state ???*/
+/**
+ * Get ppio MAC (MIB) statistics
+ *
+ * The HW counters are read and accumulated in 64-bit SW counters. The 32-bit
+ * frame counters must be read before they wrap, i.e. at least every few minutes
+ * at 10G line rate. For a ppio opened with maintain_stats, the statistics
+ * collector (or pp2_stats_poll()) harvests them; without maintain_stats nothing
+ * does, and this function must be called often enough, or counts are lost.
+ * When rates is not NULL, per second rates are returned. A new sample is taken
+ * when rate_period_ms elapsed since the previous one (on each call if 0);
+ * in between, the rates of the previous sample are returned.
+ *
+ * Not supported on 'PP2_PPIO_T_LOG', where the MAC is owned by the kernel.
+ *
+ * @param[in]		ppio		A pointer to a PP-IO object.
+ * @param[out]		stats		MAC statistics, may be NULL.
+ * @param[out]		rates		MAC rates, may be NULL.
+ * @param[in]		rate_period_ms	Rate sampling period in msec.
+ * @param[in]		reset		A flag indicates if counters should be reset.
+ *
+ * @retval	0 on success
+ * @retval	error-code otherwise
+ */
+int pp2_ppio_get_mac_statistics(struct pp2_ppio *ppio, struct pp2_ppio_mac_statistics *stats,
+				struct pp2_ppio_mac_rates *rates, u32 rate_period_ms, int reset);
+
+/**
+ * Harvest the HW counters of the ppios opened with maintain_stats
+ *
+ * The queue, port and MAC HW counters are 32-bit and cleared on read; they are
+ * accumulated in 64-bit SW counters, read by the pp2_ppio_*get_statistics()
+ * functions. The data path does no statistics work; the counters must be
+ * harvested before they wrap, i.e. at least every few minutes at 10G line rate.
+ * This is done by the collector thread, or by calling this function from a
+ * control core when the collector thread is disabled.
+ *
+ * @retval	0 on success
+ * @retval	error-code otherwise
+ */
+int pp2_stats_poll(void);
+
+/**
+ * Set the statistics collector interval
+ *
+ * The collector thread runs while at least one ppio opened with maintain_stats
+ * exists, and harvests their HW counters every interval (1 sec by default).
+ *
+ * @param[in]		interval_us	Collection interval in usec; 0 stops the
+ *					collector thread, pp2_stats_poll() must then
+ *					be called periodically.
+ *
+ * @retval	0 on success
+ * @retval	error-code otherwise
+ */
+int pp2_stats_collector_set_interval(u32 interval_us);
+
+/**
+ * ppio link state
+ */
+struct pp2_ppio_link_state {
+	int	up;		/**< 1: link is up */
+	u32	speed;		/**< speed in Mbps, 0: unknown */
+	int	full_duplex;	/**< 1: full duplex */
+};
+
+/**
+ * Link change callback, called from the link monitor thread
+ *
+ * @param[in]	ppio	A pointer to a PP-IO object.
+ * @param[in]	state	The new link state.
+ * @param[in]	arg	The argument given at registration.
+ */
+typedef void (*pp2_ppio_link_cb)(struct pp2_ppio *ppio, struct pp2_ppio_link_state *state, void *arg);
+
+/**
+ * ppio link monitor parameters
+ */
+struct pp2_ppio_link_mon_params {
+	pp2_ppio_link_cb	cb;		/**< link change callback, may be NULL */
+	void			*arg;		/**< callback argument */
+	u32			interval_us;	/**< poll interval, 0: 1 msec. The monitor uses the
+						  * smallest interval of the registered ppios
+						  */
+};
+
+/**
+ * Get ppio link state, read from HW
+ *
+ * @param[in]	ppio	A pointer to a PP-IO object.
+ * @param[out]	state	Link state.
+ *
+ * @retval	0 on success
+ * @retval	error-code otherwise
+ */
+int pp2_ppio_get_link_state(struct pp2_ppio *ppio, struct pp2_ppio_link_state *state);
+
+/**
+ * Register a ppio to the link monitor
+ *
+ * The link monitor is a thread, started with the first registered ppio, that
+ * polls the MAC link events of the registered ppios and reads the link state
+ * when it changed. On a change of link, speed or duplex, the callback is called
+ * from the monitor thread; it must not call the link monitor API.
+ * The link up flag (see pp2_ppio_get_link_flag()) is updated before the
+ * callback is called.
+ *
+ * Not supported on 'PP2_PPIO_T_LOG', where the link is owned by the kernel.
+ *
+ * @param[in]	ppio	A pointer to a PP-IO object.
+ * @param[in]	params	Link monitor parameters.
+ *
+ * @retval	0 on success
+ * @retval	error-code otherwise
+ */
+int pp2_ppio_link_monitor_register(struct pp2_ppio *ppio, struct pp2_ppio_link_mon_params *params);
+
+/**
+ * Unregister a ppio from the link monitor
+ *
+ * The monitor thread is stopped with the last registered ppio. When the function
+ * returns, the callback of the ppio is not called anymore.
+ *
+ * @param[in]	ppio	A pointer to a PP-IO object.
+ *
+ * @retval	0 on success
+ * @retval	error-code otherwise
+ */
+int pp2_ppio_link_monitor_unregister(struct pp2_ppio *ppio);
+
+/**
+ * Get the link up flag of a ppio
+ *
+ * The flag is in its own cache line and is updated by the link monitor, so the
+ * data path can test it on every burst at no register access cost. It is valid
+ * for the lifetime of the application; while the ppio is not registered to the
+ * link monitor it holds the last published state.
+ *
+ * @param[in]	ppio	A pointer to a PP-IO object.
+ *
+ * @retval	pointer to the flag, 1: link is up
+ */
+const volatile int *pp2_ppio_get_link_flag(struct pp2_ppio *ppio);
 
 /** @} */ /* end of grp_pp2_io */
 
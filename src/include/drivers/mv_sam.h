@@ -36,6 +36,7 @@
 #include "mv_std.h"
 #include "mv_sam_session.h"
 #include "mv_sam_cio.h"
+#include "mv_sam_cio_group.h"
 
 /** Maximum number of supported crypto engines */
 #define SAM_HW_ENGINE_NUM	2
@@ -46,18 +46,33 @@
 /** Maximum number of input/output buffers for one crypto operation */
 #define SAM_CIO_MAX_FRAGS	20
 
+/** Method used by sam_cio_deq() to detect completed crypto operations */
+enum sam_cio_compl_mode {
+	SAM_CIO_COMPL_REG = 0, /**< read RDR processed counter register on every poll */
+	SAM_CIO_COMPL_DESC,    /**< check ownership word of result descriptor in memory */
+	SAM_CIO_COMPL_LAST
+};
+
 /** parameters for CIO instance */
 struct sam_cio_params {
 	const char *match; /**< SAM HW string in DTS file. e.g. "cio-0:0" */
 	u32 size;          /**< ring size in number of descriptors */
 	u32 num_sessions;  /**< number of supported sessions */
 	u32 max_buf_size;  /**< maximum buffer size [in bytes] */
+	u32 submit_thresh; /**< number of pending requests to trigger doorbell.
+			    *   0 or 1 - doorbell on every sam_cio_enq() call
+			    */
+	u32 submit_timeout_us; /**< max time [in usec] requests stay pending, checked on
+				*   sam_cio_deq(). 0 - no timeout
+				*/
+	enum sam_cio_compl_mode compl_mode; /**< completion detection mode */
 };
 
 struct sam_cio_stats {
 	u64 enq_pkts;   /**< Number of enqueued packet */
 	u64 enq_bytes;  /**< Number of enqueued bytes */
 	u64 enq_full;   /**< Number of times when ring was full on enqueue */
+	u64 doorbells;  /**< Number of CDR/RDR prepared counter register writes */
 	u64 deq_pkts;   /**< Number of dequeued packet */
 	u64 deq_bytes;  /**< Number of dequeued bytes */
 	u64 deq_empty;  /**< Number of times ring was empty on dequeue */
@@ -81,6 +96,20 @@ enum sam_cio_op_status {
 	SAM_CIO_ERR_LAST
 };
 
+/** Crypto operation result */
+struct sam_cio_op_result {
+	void			*cookie; /**< caller cookie passed from request */
+	u32			out_len; /**< output data length */
+	enum sam_cio_op_status	status;  /**< status of crypto operation. */
+};
+
+/**
+ * Crypto operation completion callback
+ *
+ * @param[in]	result	  - result of completed crypto operation.
+ */
+typedef void (*sam_cio_compl_cb)(struct sam_cio_op_result *result);
+
 /**
  * Crypto operation parameters
  *
@@ -113,13 +142,7 @@ struct sam_cio_op_params {
 	u32  auth_offset;     /**< start of data for authentication (in bytes) */
 	u32  auth_len;        /**< size of data for authentication (in bytes) */
 	u32  auth_icv_offset; /**< offset of ICV in the buffer (in bytes) */
-};
-
-/** Crypto operation result */
-struct sam_cio_op_result {
-	void			*cookie; /**< caller cookie passed from request */
-	u32			out_len; /**< output data length */
-	enum sam_cio_op_status	status;  /**< status of crypto operation. */
+	sam_cio_compl_cb compl_cb; /**< optional completion callback called by sam_cio_deq_cb() */
 };
 
 /**
@@ -157,7 +180,22 @@ int sam_cio_deinit(struct sam_cio *cio);
 int sam_cio_enq(struct sam_cio *cio, struct sam_cio_op_params *requests, u16 *num);
 
 /**
- * Enqueue single or multiple crypto operations to crypto IO instance
+ * Submit to HW all requests enqueued to crypto IO instance and not submitted yet
+ *
+ * When "submit_thresh" is configured, sam_cio_enq() defers the doorbell until
+ * the number of pending requests reaches the threshold. sam_cio_deq() submits
+ * pending requests when no other submitted request is in process, or when the
+ * oldest one is pending for "submit_timeout_us".
+ *
+ * @param[in]	  cio      - crypto IO instance handler.
+ *
+ * @retval	0          - success
+ * @retval	Negative   - failure
+ */
+int sam_cio_kick(struct sam_cio *cio);
+
+/**
+ * Dequeue single or multiple crypto operations from crypto IO instance
  *
  * @param[in]	  cio      - crypto IO instance handler.
  * @param[in]	  results  - pointer to results of one or more crypto operations
@@ -169,6 +207,56 @@ int sam_cio_enq(struct sam_cio *cio, struct sam_cio_op_params *requests, u16 *nu
  */
 int sam_cio_deq(struct sam_cio *cio, struct sam_cio_op_result *results, u16 *num);
 
+/**
+ * Dequeue completed crypto operations and call their completion callbacks
+ *
+ * Results of requests enqueued without "compl_cb" are discarded.
+ *
+ * @param[in]	  cio      - crypto IO instance handler.
+ * @param[in,out] num      - input:  maximum number of results to process
+ *                           output: number of results processed
+ *
+ * @retval	0          - success
+ * @retval	Negative   - dequeue of one or more results failed.
+ */
+int sam_cio_deq_cb(struct sam_cio *cio, u16 *num);
+
+/**
+ * Get file descriptor signaled when crypto IO instance has results to dequeue
+ *
+ * The file descriptor can be used with poll()/epoll(). Notification must be
+ * re-armed by sam_cio_event_arm() before each wait.
+ *
+ * @param[in]	cio       - crypto IO instance handler.
+ * @param[out]	fd        - address of place to save file descriptor.
+ *
+ * @retval	0         - success
+ * @retval	Negative  - failure (e.g. ring interrupt is not supported)
+ */
+int sam_cio_event_fd_get(struct sam_cio *cio, int *fd);
+
+/**
+ * Acknowledge previous notification and enable notification on next result
+ *
+ * @param[in]	cio       - crypto IO instance handler.
+ *
+ * @retval	0         - success
+ * @retval	Negative  - failure
+ */
+int sam_cio_event_arm(struct sam_cio *cio);
+
+/**
+ * Block until crypto IO instance has results to dequeue
+ *
+ * @param[in]	cio        - crypto IO instance handler.
+ * @param[in]	timeout_ms - maximum time to wait in milliseconds. Negative - infinite.
+ *
+ * @retval	0          - results are ready
+ * @retval	-ETIMEDOUT - no results during "timeout_ms"
+ * @retval	Negative   - failure
+ */
+int sam_cio_event_wait(struct sam_cio *cio, int timeout_ms);
+
 /**
  * Flush crypto IO instance. All pending requests/results will be discarded.
  *
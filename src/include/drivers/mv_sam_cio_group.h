@@ -0,0 +1,162 @@
+/******************************************************************************
+ *	Copyright (C) 2016 Marvell International Ltd.
+ *
+ *  If you received this File from Marvell, you may opt to use, redistribute
+ *  and/or modify this File under the following licensing terms.
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *	* Redistributions of source code must retain the above copyright
+ *	  notice, this list of conditions and the following disclaimer.
+ *
+ *	* Redistributions in binary form must reproduce the above copyright
+ *	  notice, this list of conditions and the following disclaimer in the
+ *	  documentation and/or other materials provided with the distribution.
+ *
+ *	* Neither the name of Marvell nor the names of its contributors may be
+ *	  used to endorse or promote products derived from this software
+ *	  without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#ifndef __MV_SAM_CIO_GROUP_H__
+#define __MV_SAM_CIO_GROUP_H__
+
+#include "mv_std.h"
+#include "mv_sam_session.h"
+#include "mv_sam_cio.h"
+
+/** @addtogroup grp_sam_cio_group Security Acceleration Module: Crypto I/O Group
+ *
+ *  Security Acceleration Module Crypto I/O Group API documentation
+ *
+ *  CIO group spreads crypto operations over number of CIO instances
+ *  (rings) of one or more crypto engines and returns results merged
+ *  from all of them. Results of the same session are always returned
+ *  in the order the operations were enqueued.
+ *
+ *  Notes:
+ *	- CIO instances added to a group must be used only via group API.
+ *	- Sessions used with a group must be created by sam_cio_group_session_create().
+ *
+ *  @{
+ */
+
+struct sam_cio_group;
+
+/** Policy used to choose CIO instance for a crypto operation */
+enum sam_cio_group_policy {
+	SAM_CIO_GROUP_SA_AFFINITY = 0, /**< all operations of a session use the same CIO */
+	SAM_CIO_GROUP_LEAST_BUSY,      /**< operation is sent to CIO with least outstanding operations */
+	SAM_CIO_GROUP_POLICY_LAST
+};
+
+/** parameters for CIO group instance */
+struct sam_cio_group_params {
+	struct sam_cio **cios;		  /**< array of initialized CIO instances */
+	u32 num_cios;			  /**< number of CIO instances in "cios" array */
+	enum sam_cio_group_policy policy; /**< CIO selection policy */
+};
+
+/**
+ * Create CIO group instance
+ *
+ * @param[in]	params    - pointer to structure with CIO group parameters.
+ * @param[out]	grp       - address of place to save handler of new created CIO group.
+ *
+ * @retval	0         - success
+ * @retval	Negative  - failure
+ */
+int sam_cio_group_init(struct sam_cio_group_params *params, struct sam_cio_group **grp);
+
+/**
+ * Delete CIO group instance. CIO instances of the group are not deleted.
+ *
+ * @param[in]	grp       - CIO group handler.
+ *
+ * @retval	0         - success
+ * @retval	Negative  - failure
+ */
+int sam_cio_group_deinit(struct sam_cio_group *grp);
+
+/**
+ * Create new crypto session for CIO group
+ *
+ * With SAM_CIO_GROUP_SA_AFFINITY policy session is created on CIO with
+ * least number of group sessions. With SAM_CIO_GROUP_LEAST_BUSY policy session
+ * is created on all CIO instances of the group.
+ *
+ * @param[in]	grp       - CIO group handler.
+ * @param[in]	params    - pointer to structure with crypto session parameters.
+ * @param[out]	sa        - address of place to save handler of new created crypto session.
+ *
+ * @retval	0         - success
+ * @retval	Negative  - failure
+ */
+int sam_cio_group_session_create(struct sam_cio_group *grp, struct sam_session_params *params,
+				 struct sam_sa **sa);
+
+/**
+ * Delete crypto session created by sam_cio_group_session_create()
+ *
+ * @param[in]	grp       - CIO group handler.
+ * @param[in]	sa	  - crypto session handler.
+ *
+ * @retval	0         - success
+ * @retval	Negative  - failure
+ */
+int sam_cio_group_session_destroy(struct sam_cio_group *grp, struct sam_sa *sa);
+
+/**
+ * Enqueue single or multiple crypto operations to CIO group
+ *
+ * @param[in]	  grp      - CIO group handler.
+ * @param[in]	  requests - pointer to parameters of one or more crypto operations
+ * @param[in,out] num      - input:  number of requests to enqueue
+ *                           output: number of requests successfully enqueued
+ *
+ * @retval	0          - all requests are successfully enqueued.
+ * @retval	Negative   - enqueue of one or more requests failed.
+ */
+int sam_cio_group_enq(struct sam_cio_group *grp, struct sam_cio_op_params *requests, u16 *num);
+
+/**
+ * Dequeue single or multiple crypto operation results from all CIO instances of the group
+ *
+ * Results of the same session are returned in enqueue order. Results of different
+ * sessions may be reordered.
+ *
+ * @param[in]	  grp      - CIO group handler.
+ * @param[in]	  results  - pointer to results of one or more crypto operations
+ * @param[in,out] num      - input:  number of results to dequeue
+ *                           output: number of results successfully dequeued
+ *
+ * @retval	0          - all results are successfully dequeued.
+ * @retval	Negative   - dequeue of one or more results failed.
+ */
+int sam_cio_group_deq(struct sam_cio_group *grp, struct sam_cio_op_result *results, u16 *num);
+
+/**
+ * Get number of outstanding crypto operations of CIO instance in the group
+ *
+ * @param[in]	grp       - CIO group handler.
+ * @param[in]	idx       - index of CIO instance in "cios" array passed on group init.
+ *
+ * @retval	number of operations enqueued to the CIO and not dequeued yet.
+ */
+u32 sam_cio_group_depth_get(struct sam_cio_group *grp, u32 idx);
+
+/** @} */ /* end of grp_sam_cio_group */
+
+#endif /* __MV_SAM_CIO_GROUP_H__ */
@@ -156,6 +156,48 @@ int sam_session_create(struct sam_cio *cio, struct sam_session_params *params,
  */
 int sam_session_destroy(struct sam_sa *sa);
 
+/** Size of the "auth_inner" / "auth_outer" buffers required by sam_session_auth_key_set() */
+#define SAM_AUTH_IV_MAX_SIZE	64
+
+/**
+ * Calculate session authentication inner and outer blocks from a raw key
+ *
+ * Supported authentication algorithms:
+ *	- HMAC MD5, SHA1, SHA2-256, SHA2-384 and SHA2-512: inner and outer
+ *	intermediate digests of the key. Keys longer than the hash block size
+ *	are hashed first.
+ *	- AES GCM and GMAC: the GHASH key is derived from "key", which must be
+ *	the cipher key. "auth_outer" is not used.
+ *
+ * "params->auth_alg" must be set and "params->auth_inner" / "params->auth_outer"
+ * must point to buffers of at least SAM_AUTH_IV_MAX_SIZE bytes.
+ *
+ * @param[in,out]	params    - pointer to crypto session parameters.
+ * @param[in]		key       - pointer to raw authentication key.
+ * @param[in]		key_len   - key size (in bytes).
+ *
+ * @retval	0         - success
+ * @retval	Negative  - failure
+ */
+int sam_session_auth_key_set(struct sam_session_params *params, u8 *key, u32 key_len);
+
+/**
+ * Calculate authentication inner and outer blocks for multiple sessions
+ *
+ * Same as sam_session_auth_key_set() for an array of sessions. HMAC SHA1 and
+ * HMAC SHA2-256 keys are hashed several at a time using the multi-buffer
+ * SHA implementation; use this function when installing many sessions.
+ *
+ * @param[in,out]	params    - array of "num" crypto session parameters.
+ * @param[in]		keys      - array of "num" pointers to raw authentication keys.
+ * @param[in]		key_lens  - array of "num" key sizes (in bytes).
+ * @param[in]		num       - number of sessions.
+ *
+ * @retval	0         - success
+ * @retval	Negative  - failure; sessions may be partially filled.
+ */
+int sam_session_auth_keys_set(struct sam_session_params params[], u8 *keys[], u32 key_lens[], u32 num);
+
 /** @} */ /* end of grp_sam_se */
 
 #endif /* __MV_SAM_SESSION_H__ */
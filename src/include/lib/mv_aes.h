@@ -1,21 +1,21 @@
 /******************************************************************************
- *      Copyright (C) 2016 Marvell International Ltd.
+ *	Copyright (C) 2016 Marvell International Ltd.
  *
  *  If you received this File from Marvell, you may opt to use, redistribute
  *  and/or modify this File under the following licensing terms.
  *  Redistribution and use in source and binary forms, with or without
  *  modification, are permitted provided that the following conditions are met:
  *
- *      * Redistributions of source code must retain the above copyright
- *        notice, this list of conditions and the following disclaimer.
+ *	* Redistributions of source code must retain the above copyright
+ *	  notice, this list of conditions and the following disclaimer.
  *
- *      * Redistributions in binary form must reproduce the above copyright
- *        notice, this list of conditions and the following disclaimer in the
- *        documentation and/or other materials provided with the distribution.
+ *	* Redistributions in binary form must reproduce the above copyright
+ *	  notice, this list of conditions and the following disclaimer in the
+ *	  documentation and/or other materials provided with the distribution.
  *
- *      * Neither the name of Marvell nor the names of its contributors may be
- *        used to endorse or promote products derived from this software
- *        without specific prior written permission.
+ *	* Neither the name of Marvell nor the names of its contributors may be
+ *	  used to endorse or promote products derived from this software
+ *	  without specific prior written permission.
  *
  *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
  *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
@@ -33,9 +33,160 @@
 #ifndef __MV_AES_H__
 #define __MV_AES_H__
 
+#include <stddef.h>
 #include <stdint.h>
 
+#define MV_AES_BLOCK_SIZE	16
+#define MV_AES_MAX_ROUNDS	14
+#define MV_AES_GCM_TAG_SIZE	16
 
-void mv_aes_ecb_encrypt(uint8_t* input, const uint8_t* key, uint8_t *output, int key_size);
+/**
+ * AES key context
+ *
+ * Holds the expanded encryption and decryption key schedules. A context is
+ * read-only once initialized by mv_aes_set_key(), so it may be shared by
+ * several threads without locking.
+ */
+struct mv_aes_ctx {
+	uint32_t	ek[4 * (MV_AES_MAX_ROUNDS + 1)];	/**< encryption round keys */
+	uint32_t	dk[4 * (MV_AES_MAX_ROUNDS + 1)];	/**< decryption round keys */
+	int		rounds;					/**< 10, 12 or 14 */
+};
+
+/**
+ * AES-GCM key context
+ */
+struct mv_aes_gcm_ctx {
+	struct mv_aes_ctx	aes;
+	uint8_t			h[MV_AES_BLOCK_SIZE];	/**< hash subkey H = E(K, 0^128) */
+	uint64_t		hl[16];			/**< GHASH 4-bit table (low halves) */
+	uint64_t		hh[16];			/**< GHASH 4-bit table (high halves) */
+};
+
+/**
+ * Expand an AES key into a context
+ *
+ * When the library is compiled for ARMv8 with the crypto extensions
+ * (__ARM_FEATURE_CRYPTO), the block functions use the AESE/AESD
+ * instructions; otherwise a portable table-driven implementation is used.
+ *
+ * @param[out]	ctx		A pointer to the context to initialize.
+ * @param[in]	key		A pointer to the key.
+ * @param[in]	key_size	Key size in bits (128, 192 or 256).
+ *
+ * @retval	0 on success
+ * @retval	-EINVAL on unsupported key size
+ */
+int mv_aes_set_key(struct mv_aes_ctx *ctx, const uint8_t *key, int key_size);
+
+/**
+ * Encrypt a single block
+ *
+ * @param[in]	ctx	A pointer to an initialized context.
+ * @param[in]	in	A pointer to the 16 bytes plain text block.
+ * @param[out]	out	A pointer to the output block (may be equal to 'in').
+ */
+void mv_aes_encrypt(const struct mv_aes_ctx *ctx, const uint8_t *in, uint8_t *out);
+
+/**
+ * Decrypt a single block
+ *
+ * @param[in]	ctx	A pointer to an initialized context.
+ * @param[in]	in	A pointer to the 16 bytes cipher text block.
+ * @param[out]	out	A pointer to the output block (may be equal to 'in').
+ */
+void mv_aes_decrypt(const struct mv_aes_ctx *ctx, const uint8_t *in, uint8_t *out);
+
+/**
+ * CBC mode encryption / decryption
+ *
+ * @param[in]		ctx	A pointer to an initialized context.
+ * @param[in,out]	iv	A pointer to the 16 bytes IV. Updated with the
+ *				last cipher text block so that consecutive calls
+ *				chain.
+ * @param[in]		in	A pointer to the input buffer.
+ * @param[out]		out	A pointer to the output buffer (may be equal to 'in').
+ * @param[in]		len	Buffer length; must be a multiple of the block size.
+ *
+ * @retval	0 on success
+ * @retval	-EINVAL if 'len' is not a multiple of the block size
+ */
+int mv_aes_cbc_encrypt(const struct mv_aes_ctx *ctx, uint8_t *iv,
+		       const uint8_t *in, uint8_t *out, size_t len);
+int mv_aes_cbc_decrypt(const struct mv_aes_ctx *ctx, uint8_t *iv,
+		       const uint8_t *in, uint8_t *out, size_t len);
+
+/**
+ * CTR mode encryption / decryption
+ *
+ * The counter block is treated as a 128 bits big-endian integer. A trailing
+ * partial block consumes a whole counter value.
+ *
+ * @param[in]		ctx	A pointer to an initialized context.
+ * @param[in,out]	ctr	A pointer to the 16 bytes counter block. Updated
+ *				to the next unused counter value.
+ * @param[in]		in	A pointer to the input buffer.
+ * @param[out]		out	A pointer to the output buffer (may be equal to 'in').
+ * @param[in]		len	Buffer length in bytes.
+ */
+void mv_aes_ctr_crypt(const struct mv_aes_ctx *ctx, uint8_t *ctr,
+		      const uint8_t *in, uint8_t *out, size_t len);
+
+/**
+ * Initialize an AES-GCM context
+ *
+ * Expands the key and precomputes the hash subkey and the GHASH tables.
+ *
+ * @param[out]	ctx		A pointer to the context to initialize.
+ * @param[in]	key		A pointer to the key.
+ * @param[in]	key_size	Key size in bits (128, 192 or 256).
+ *
+ * @retval	0 on success
+ * @retval	-EINVAL on unsupported key size
+ */
+int mv_aes_gcm_init(struct mv_aes_gcm_ctx *ctx, const uint8_t *key, int key_size);
+
+/**
+ * AES-GCM authenticated encryption
+ *
+ * @param[in]	ctx	A pointer to an initialized GCM context.
+ * @param[in]	iv	A pointer to the IV (96 bits IV is the fast path).
+ * @param[in]	iv_len	IV length in bytes.
+ * @param[in]	aad	A pointer to the additional authenticated data.
+ * @param[in]	aad_len	AAD length in bytes.
+ * @param[in]	in	A pointer to the plain text.
+ * @param[out]	out	A pointer to the cipher text (may be equal to 'in').
+ * @param[in]	len	Text length in bytes.
+ * @param[out]	tag	A pointer to the output tag.
+ * @param[in]	tag_len	Tag length in bytes (up to MV_AES_GCM_TAG_SIZE).
+ *
+ * @retval	0 on success
+ * @retval	-EINVAL on invalid parameters
+ */
+int mv_aes_gcm_encrypt(const struct mv_aes_gcm_ctx *ctx, const uint8_t *iv, size_t iv_len,
+		       const uint8_t *aad, size_t aad_len, const uint8_t *in, uint8_t *out,
+		       size_t len, uint8_t *tag, size_t tag_len);
+
+/**
+ * AES-GCM authenticated decryption
+ *
+ * Parameters are as in mv_aes_gcm_encrypt(), except that 'tag' is the
+ * expected tag. The output buffer is written even when the tag does not match.
+ *
+ * @retval	0 on success
+ * @retval	-EINVAL on invalid parameters
+ * @retval	-EBADMSG if the tag does not match
+ */
+int mv_aes_gcm_decrypt(const struct mv_aes_gcm_ctx *ctx, const uint8_t *iv, size_t iv_len,
+		       const uint8_t *aad, size_t aad_len, const uint8_t *in, uint8_t *out,
+		       size_t len, const uint8_t *tag, size_t tag_len);
+
+/**
+ * Single block ECB encryption with an on-the-fly key expansion
+ *
+ * Kept for backward compatibility; callers that use the same key more than
+ * once should keep a struct mv_aes_ctx instead.
+ */
+void mv_aes_ecb_encrypt(uint8_t *input, const uint8_t *key, uint8_t *output, int key_size);
 
 #endif /* __MV_AES_H__ */
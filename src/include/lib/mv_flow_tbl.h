@@ -0,0 +1,243 @@
+/******************************************************************************
+ *	Copyright (C) 2016 Marvell International Ltd.
+ *
+ *  If you received this File from Marvell, you may opt to use, redistribute
+ *  and/or modify this File under the following licensing terms.
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *	* Redistributions of source code must retain the above copyright
+ *	  notice, this list of conditions and the following disclaimer.
+ *
+ *	* Redistributions in binary form must reproduce the above copyright
+ *	  notice, this list of conditions and the following disclaimer in the
+ *	  documentation and/or other materials provided with the distribution.
+ *
+ *	* Neither the name of Marvell nor the names of its contributors may be
+ *	  used to endorse or promote products derived from this software
+ *	  without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#ifndef __MV_FLOW_TBL_H__
+#define __MV_FLOW_TBL_H__
+
+#include "env/mv_types.h"
+
+/*
+ * Exact match flow table
+ *
+ * A cuckoo hash table of fixed size keys. Every key has two candidate buckets
+ * of MV_FLOW_TBL_BUCKET_ENTRIES entries; a bucket holds a 16-bit signature
+ * per entry, compared for all entries at once (NEON on ARMv8, SSE2 on x86,
+ * scalar otherwise), and the index of the entry key in a separate key store.
+ * When both buckets are full, entries are moved to their other bucket to make
+ * room.
+ *
+ * One writer (add/delete) may run concurrently with any number of readers
+ * (lookups) without locks. A lookup that races with entries moving between
+ * buckets is retried. Deleted entries are reused only after
+ * mv_flow_tbl_reclaim(), see there.
+ */
+
+#define MV_FLOW_TBL_BUCKET_ENTRIES	8
+#define MV_FLOW_TBL_MAX_KEY_LEN		64
+#define MV_FLOW_TBL_MAX_BURST		64	/**< max keys per bulk lookup */
+
+struct mv_flow_tbl;
+
+/**
+ * Memory backing the table
+ */
+enum mv_flow_tbl_mem {
+	MV_FLOW_TBL_MEM_HEAP = 0,	/**< process heap */
+	MV_FLOW_TBL_MEM_DMA,		/**< mv_sys_dma_mem_alloc(); must be initialized first */
+	MV_FLOW_TBL_MEM_HUGEPAGE	/**< anonymous huge pages (MAP_HUGETLB) */
+};
+
+/**
+ * IPv4 5-tuple key; unused bytes must be zero
+ */
+struct mv_flow_tbl_ipv4_5tuple {
+	u32	src_ip;
+	u32	dst_ip;
+	u16	src_port;
+	u16	dst_port;
+	u8	proto;
+	u8	pad[3];
+};
+
+/**
+ * IPv6 5-tuple key; unused bytes must be zero
+ */
+struct mv_flow_tbl_ipv6_5tuple {
+	u8	src_ip[16];
+	u8	dst_ip[16];
+	u16	src_port;
+	u16	dst_port;
+	u8	proto;
+	u8	pad[3];
+};
+
+/**
+ * Flow table parameters
+ */
+struct mv_flow_tbl_params {
+	u32			num_entries;	/**< max number of flows */
+	u32			key_len;	/**< key length in bytes, up to MV_FLOW_TBL_MAX_KEY_LEN;
+						 * e.g. sizeof(struct mv_flow_tbl_ipv4_5tuple)
+						 */
+	enum mv_flow_tbl_mem	mem;		/**< memory backing the buckets and the keys */
+	u32			seed;		/**< hash seed */
+	/** Optional hash function; a built-in CRC32C based hash is used when NULL */
+	u32			(*hash)(const void *key, u32 key_len, u32 seed);
+};
+
+/**
+ * Flow table statistics
+ */
+struct mv_flow_tbl_stats {
+	u32	num_entries;	/**< flows in the table */
+	u32	max_entries;	/**< flows the key store can hold */
+	u32	num_buckets;
+	u32	pending_free;	/**< deleted entries waiting for mv_flow_tbl_reclaim() */
+	u64	mem_size;	/**< bytes of buckets and key store */
+	u64	adds;
+	u64	add_moves;	/**< entries moved to their other bucket by adds */
+	u64	add_fails;	/**< adds that found no room */
+};
+
+/**
+ * Create a flow table
+ *
+ * @param[in]	params	A pointer to the table parameters.
+ * @param[out]	tbl	A pointer to the created table.
+ *
+ * @retval	0 on success
+ * @retval	<0 on failure
+ */
+int mv_flow_tbl_create(struct mv_flow_tbl_params *params, struct mv_flow_tbl **tbl);
+
+/**
+ * Destroy a flow table
+ *
+ * @param[in]	tbl	A pointer to the table.
+ */
+void mv_flow_tbl_destroy(struct mv_flow_tbl *tbl);
+
+/**
+ * Hash a key with the table hash function
+ *
+ * The result may be passed to the *_with_hash() calls, e.g. when the hash is
+ * computed once for the lookup and the add of a new flow.
+ *
+ * @param[in]	tbl	A pointer to the table.
+ * @param[in]	key	A pointer to the key.
+ *
+ * @retval	The key hash
+ */
+u32 mv_flow_tbl_hash(struct mv_flow_tbl *tbl, const void *key);
+
+/**
+ * Add a flow, or update the data of an existing one (writer only)
+ *
+ * @param[in]	tbl	A pointer to the table.
+ * @param[in]	key	A pointer to the key.
+ * @param[in]	data	Data returned by the lookups of the flow.
+ *
+ * @retval	>=0 the flow position, a unique index below the table
+ *		'num_entries', for arrays of per flow state.
+ * @retval	-ENOSPC when the table is full
+ */
+int mv_flow_tbl_add(struct mv_flow_tbl *tbl, const void *key, u64 data);
+int mv_flow_tbl_add_with_hash(struct mv_flow_tbl *tbl, const void *key, u32 hash, u64 data);
+
+/**
+ * Delete a flow (writer only)
+ *
+ * @param[in]	tbl	A pointer to the table.
+ * @param[in]	key	A pointer to the key.
+ *
+ * @retval	>=0 the position the flow had
+ * @retval	-ENOENT when the flow is not in the table
+ */
+int mv_flow_tbl_del(struct mv_flow_tbl *tbl, const void *key);
+
+/**
+ * Make deleted entries available to adds (writer only)
+ *
+ * A reader may still be reading the key and data of an entry that was just
+ * deleted. Deleted entries are therefore kept aside until this call, which
+ * the application makes once all readers have passed a point where they hold
+ * no result of a lookup done before the deletes (e.g. once every data path
+ * thread completed a polling round). Without concurrent readers it may be
+ * called right after mv_flow_tbl_del().
+ *
+ * @param[in]	tbl	A pointer to the table.
+ *
+ * @retval	The number of entries made available
+ */
+u32 mv_flow_tbl_reclaim(struct mv_flow_tbl *tbl);
+
+/**
+ * Lookup a flow
+ *
+ * @param[in]	tbl	A pointer to the table.
+ * @param[in]	key	A pointer to the key.
+ * @param[out]	data	The flow data; may be NULL.
+ *
+ * @retval	>=0 the flow position
+ * @retval	-ENOENT when the flow is not in the table
+ */
+int mv_flow_tbl_lookup(struct mv_flow_tbl *tbl, const void *key, u64 *data);
+int mv_flow_tbl_lookup_with_hash(struct mv_flow_tbl *tbl, const void *key, u32 hash, u64 *data);
+
+/**
+ * Lookup a burst of flows
+ *
+ * The buckets of all keys are prefetched before any is read, then the keys of
+ * all signature matches, so that the cache misses of the burst overlap.
+ *
+ * @param[in]	tbl	A pointer to the table.
+ * @param[in]	keys	Array of 'num' key pointers.
+ * @param[in]	num	Number of keys, up to MV_FLOW_TBL_MAX_BURST.
+ * @param[out]	pos	Array of 'num' positions, -ENOENT for a miss; may be NULL.
+ * @param[out]	data	Array of 'num' flow data, set for hits only; may be NULL.
+ *
+ * @retval	A bit mask of the keys found, bit i for keys[i]
+ */
+u64 mv_flow_tbl_lookup_bulk(struct mv_flow_tbl *tbl, const void *keys[], int num, int pos[], u64 data[]);
+
+/**
+ * Get the key and data of a flow by position (writer only)
+ *
+ * @param[in]	tbl	A pointer to the table.
+ * @param[in]	pos	The flow position.
+ * @param[out]	key	A pointer to the flow key in the table.
+ * @param[out]	data	The flow data; may be NULL.
+ *
+ * @retval	0 on success
+ * @retval	-ENOENT when no flow is at this position
+ */
+int mv_flow_tbl_get_key(struct mv_flow_tbl *tbl, int pos, const void **key, u64 *data);
+
+/**
+ * Get the flow table statistics
+ *
+ * @param[in]	tbl	A pointer to the table.
+ * @param[out]	stats	A pointer to the statistics.
+ */
+void mv_flow_tbl_get_stats(struct mv_flow_tbl *tbl, struct mv_flow_tbl_stats *stats);
+
+#endif /* __MV_FLOW_TBL_H__ */
@@ -0,0 +1,89 @@
+/******************************************************************************
+ *	Copyright (C) 2016 Marvell International Ltd.
+ *
+ *  If you received this File from Marvell, you may opt to use, redistribute
+ *  and/or modify this File under the following licensing terms.
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *	* Redistributions of source code must retain the above copyright
+ *	  notice, this list of conditions and the following disclaimer.
+ *
+ *	* Redistributions in binary form must reproduce the above copyright
+ *	  notice, this list of conditions and the following disclaimer in the
+ *	  documentation and/or other materials provided with the distribution.
+ *
+ *	* Neither the name of Marvell nor the names of its contributors may be
+ *	  used to endorse or promote products derived from this software
+ *	  without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#ifndef __MV_SHA_MB_H__
+#define __MV_SHA_MB_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Multi-buffer SHA-1 / SHA-256
+ *
+ * Several independent messages of the same length are hashed in parallel,
+ * one message per 32-bit SIMD lane (NEON on ARMv8, SSE2 on x86). When no
+ * SIMD unit is available the same code runs with a single scalar lane.
+ *
+ * The functions accept any number of messages; they are consumed in groups
+ * of mv_sha_mb_lanes().
+ */
+
+#define MV_SHA_MB_MAX_LANES	4
+
+/**
+ * Get the number of messages hashed in parallel
+ *
+ * @retval	4 when built with NEON or SSE2, 1 otherwise
+ */
+int mv_sha_mb_lanes(void);
+
+/**
+ * Hash several messages of the same length
+ *
+ * @param[in]	data	Array of 'num' pointers to the messages.
+ * @param[in]	len	Length in bytes of each message.
+ * @param[out]	digest	Array of 'num' pointers to the output digests
+ *			(MV_SHA1_DIGEST_SIZE / SHA256_DIGEST_LENGTH bytes each).
+ * @param[in]	num	Number of messages.
+ */
+void mv_sha1_mb(const uint8_t *const data[], size_t len, uint8_t *digest[], int num);
+void mv_sha256_mb(const uint8_t *const data[], size_t len, uint8_t *digest[], int num);
+
+/**
+ * Calculate HMAC inner and outer intermediate digests for several keys
+ *
+ * The output has the same format as mv_sha1_hmac_iv() / mv_sha256_hmac_iv().
+ * Keys longer than the hash block size (64 bytes) are hashed first as
+ * required by RFC 2104.
+ *
+ * @param[in]	keys		Array of 'num' pointers to the keys.
+ * @param[in]	key_lens	Array of 'num' key lengths in bytes.
+ * @param[out]	inner		Array of 'num' pointers to the inner digests.
+ * @param[out]	outer		Array of 'num' pointers to the outer digests.
+ * @param[in]	num		Number of keys.
+ */
+void mv_sha1_mb_hmac_iv(const uint8_t *const keys[], const int key_lens[],
+			uint8_t *inner[], uint8_t *outer[], int num);
+void mv_sha256_mb_hmac_iv(const uint8_t *const keys[], const int key_lens[],
+			  uint8_t *inner[], uint8_t *outer[], int num);
+
+#endif /* __MV_SHA_MB_H__ */
@@ -60,6 +60,7 @@
 #include "env/cma.h"
 #include "env/io.h"
 #include "env/netdev.h"
+#include "env/mv_time.h"
 
 #endif /* __STD_INTERNAL_H__ */
 
@@ -0,0 +1,354 @@
+/******************************************************************************
+ *	Copyright (C) 2016 Marvell International Ltd.
+ *
+ *  If you received this File from Marvell, you may opt to use, redistribute
+ *  and/or modify this File under the following licensing terms.
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *	* Redistributions of source code must retain the above copyright
+ *	  notice, this list of conditions and the following disclaimer.
+ *
+ *	* Redistributions in binary form must reproduce the above copyright
+ *	  notice, this list of conditions and the following disclaimer in the
+ *	  documentation and/or other materials provided with the distribution.
+ *
+ *	* Neither the name of Marvell nor the names of its contributors may be
+ *	  used to endorse or promote products derived from this software
+ *	  without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include <std_internal.h>
+
+#include "lib/mv_sha1.h"
+#include "lib/mv_sha2.h"
+#include "lib/mv_sha_mb.h"
+
+
+#define SHA_MB_BLOCK_SIZE	64
+
+#define GETU32(p)	(((uint32_t)(p)[0] << 24) | ((uint32_t)(p)[1] << 16) | \
+			 ((uint32_t)(p)[2] << 8) | ((uint32_t)(p)[3]))
+#define PUTU32(p, v)	do { (p)[0] = (uint8_t)((v) >> 24); (p)[1] = (uint8_t)((v) >> 16); \
+			     (p)[2] = (uint8_t)((v) >> 8); (p)[3] = (uint8_t)(v); } while (0)
+
+/*
+ * One 32-bit word per lane. GCC vector extensions map mb_word to a NEON /
+ * SSE2 register; without SIMD support a single scalar lane is used and the
+ * same round code compiles to the plain scalar transform.
+ */
+#if defined(__ARM_NEON) || defined(__SSE2__)
+#define SHA_MB_LANES		4
+typedef uint32_t mb_word __attribute__((vector_size(16)));
+#define MB_SET1(x)		((mb_word){(x), (x), (x), (x)})
+#define MB_LANE(v, l)		((v)[l])
+#define MB_LOAD_BE(p, off)	((mb_word){GETU32((p)[0] + (off)), GETU32((p)[1] + (off)), \
+					   GETU32((p)[2] + (off)), GETU32((p)[3] + (off))})
+#else
+#define SHA_MB_LANES		1
+typedef uint32_t mb_word;
+#define MB_SET1(x)		((mb_word)(x))
+#define MB_LANE(v, l)		(v)
+#define MB_LOAD_BE(p, off)	GETU32((p)[0] + (off))
+#endif
+
+#define MB_ROL(x, n)	(((x) << (n)) | ((x) >> (32 - (n))))
+#define MB_ROR(x, n)	(((x) >> (n)) | ((x) << (32 - (n))))
+
+
+static const uint32_t sha1_iv[5] = {
+	0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0
+};
+
+static const uint32_t sha256_iv[8] = {
+	0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+	0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+static const uint32_t sha256_k[64] = {
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+	0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+	0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+	0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+	0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+	0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+/* Hash algorithm descriptor shared by the generic multi-buffer driver below */
+struct sha_mb_alg {
+	const uint32_t	*iv;
+	int		state_words;
+	int		digest_size;
+	void		(*compress)(mb_word *st, const uint8_t **p, size_t nblocks);
+	void		(*hash)(const uint8_t *data, size_t len, uint8_t *digest);
+};
+
+int mv_sha_mb_lanes(void)
+{
+	return SHA_MB_LANES;
+}
+
+static void sha1_mb_compress(mb_word *st, const uint8_t **p, size_t nblocks)
+{
+	mb_word w[16], a, b, c, d, e, f, k, t;
+	int i, l;
+
+	while (nblocks--) {
+		for (i = 0; i < 16; i++)
+			w[i] = MB_LOAD_BE(p, 4 * i);
+
+		a = st[0];
+		b = st[1];
+		c = st[2];
+		d = st[3];
+		e = st[4];
+
+		for (i = 0; i < 80; i++) {
+			if (i >= 16) {
+				t = w[(i + 13) & 15] ^ w[(i + 8) & 15] ^ w[(i + 2) & 15] ^ w[i & 15];
+				w[i & 15] = MB_ROL(t, 1);
+			}
+			if (i < 20) {
+				f = (b & c) | (~b & d);
+				k = MB_SET1(0x5a827999);
+			} else if (i < 40) {
+				f = b ^ c ^ d;
+				k = MB_SET1(0x6ed9eba1);
+			} else if (i < 60) {
+				f = (b & c) | (b & d) | (c & d);
+				k = MB_SET1(0x8f1bbcdc);
+			} else {
+				f = b ^ c ^ d;
+				k = MB_SET1(0xca62c1d6);
+			}
+			t = MB_ROL(a, 5) + f + e + k + w[i & 15];
+			e = d;
+			d = c;
+			c = MB_ROL(b, 30);
+			b = a;
+			a = t;
+		}
+
+		st[0] += a;
+		st[1] += b;
+		st[2] += c;
+		st[3] += d;
+		st[4] += e;
+
+		for (l = 0; l < SHA_MB_LANES; l++)
+			p[l] += SHA_MB_BLOCK_SIZE;
+	}
+}
+
+static void sha256_mb_compress(mb_word *st, const uint8_t **p, size_t nblocks)
+{
+	mb_word w[64], a, b, c, d, e, f, g, h, t1, t2, s0, s1;
+	int i, l;
+
+	while (nblocks--) {
+		for (i = 0; i < 16; i++)
+			w[i] = MB_LOAD_BE(p, 4 * i);
+		for (i = 16; i < 64; i++) {
+			s0 = MB_ROR(w[i - 15], 7) ^ MB_ROR(w[i - 15], 18) ^ (w[i - 15] >> 3);
+			s1 = MB_ROR(w[i - 2], 17) ^ MB_ROR(w[i - 2], 19) ^ (w[i - 2] >> 10);
+			w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+		}
+
+		a = st[0];
+		b = st[1];
+		c = st[2];
+		d = st[3];
+		e = st[4];
+		f = st[5];
+		g = st[6];
+		h = st[7];
+
+		for (i = 0; i < 64; i++) {
+			s1 = MB_ROR(e, 6) ^ MB_ROR(e, 11) ^ MB_ROR(e, 25);
+			t1 = h + s1 + ((e & f) ^ (~e & g)) + MB_SET1(sha256_k[i]) + w[i];
+			s0 = MB_ROR(a, 2) ^ MB_ROR(a, 13) ^ MB_ROR(a, 22);
+			t2 = s0 + ((a & b) ^ (a & c) ^ (b & c));
+			h = g;
+			g = f;
+			f = e;
+			e = d + t1;
+			d = c;
+			c = b;
+			b = a;
+			a = t1 + t2;
+		}
+
+		st[0] += a;
+		st[1] += b;
+		st[2] += c;
+		st[3] += d;
+		st[4] += e;
+		st[5] += f;
+		st[6] += g;
+		st[7] += h;
+
+		for (l = 0; l < SHA_MB_LANES; l++)
+			p[l] += SHA_MB_BLOCK_SIZE;
+	}
+}
+
+static void sha1_hash(const uint8_t *data, size_t len, uint8_t *digest)
+{
+	mv_sha1(data, len, digest);
+}
+
+static void sha256_hash(const uint8_t *data, size_t len, uint8_t *digest)
+{
+	SHA256_CTX ctx;
+
+	mv_sha256_init(&ctx);
+	mv_sha256_update(&ctx, data, len);
+	mv_sha256_final(digest, &ctx);
+}
+
+static const struct sha_mb_alg sha1_mb_alg = {
+	.iv = sha1_iv,
+	.state_words = 5,
+	.digest_size = MV_SHA1_DIGEST_SIZE,
+	.compress = sha1_mb_compress,
+	.hash = sha1_hash,
+};
+
+static const struct sha_mb_alg sha256_mb_alg = {
+	.iv = sha256_iv,
+	.state_words = 8,
+	.digest_size = SHA256_DIGEST_LENGTH,
+	.compress = sha256_mb_compress,
+	.hash = sha256_hash,
+};
+
+static inline void sha_mb_state_init(const struct sha_mb_alg *alg, mb_word *st)
+{
+	int i;
+
+	for (i = 0; i < alg->state_words; i++)
+		st[i] = MB_SET1(alg->iv[i]);
+}
+
+static inline void sha_mb_state_store(const struct sha_mb_alg *alg, mb_word *st, int lane, uint8_t *out)
+{
+	int i;
+
+	for (i = 0; i < alg->state_words; i++)
+		PUTU32(out + 4 * i, MB_LANE(st[i], lane));
+}
+
+static void sha_mb(const struct sha_mb_alg *alg, const uint8_t *const data[], size_t len,
+		   uint8_t *digest[], int num)
+{
+	uint8_t tail[SHA_MB_LANES][2 * SHA_MB_BLOCK_SIZE];
+	const uint8_t *p[SHA_MB_LANES];
+	mb_word st[8];
+	size_t full = len / SHA_MB_BLOCK_SIZE;
+	size_t rem = len % SHA_MB_BLOCK_SIZE;
+	size_t tail_len = (rem + 9 > SHA_MB_BLOCK_SIZE) ? 2 * SHA_MB_BLOCK_SIZE : SHA_MB_BLOCK_SIZE;
+	uint64_t bits = (uint64_t)len * 8;
+	int g, l, n;
+
+	for (g = 0; g < num; g += SHA_MB_LANES) {
+		n = min(num - g, SHA_MB_LANES);
+
+		/* Idle lanes re-hash the first message of the group */
+		for (l = 0; l < SHA_MB_LANES; l++)
+			p[l] = data[g + (l < n ? l : 0)];
+
+		sha_mb_state_init(alg, st);
+		alg->compress(st, p, full);
+
+		for (l = 0; l < SHA_MB_LANES; l++) {
+			memset(tail[l], 0, tail_len);
+			memcpy(tail[l], p[l], rem);
+			tail[l][rem] = 0x80;
+			PUTU32(tail[l] + tail_len - 8, (uint32_t)(bits >> 32));
+			PUTU32(tail[l] + tail_len - 4, (uint32_t)bits);
+			p[l] = tail[l];
+		}
+		alg->compress(st, p, tail_len / SHA_MB_BLOCK_SIZE);
+
+		for (l = 0; l < n; l++)
+			sha_mb_state_store(alg, st, l, digest[g + l]);
+	}
+}
+
+static void sha_mb_hmac_iv(const struct sha_mb_alg *alg, const uint8_t *const keys[],
+			   const int key_lens[], uint8_t *inner[], uint8_t *outer[], int num)
+{
+	uint8_t pad[SHA_MB_LANES][SHA_MB_BLOCK_SIZE];
+	uint8_t hkey[SHA256_DIGEST_LENGTH];
+	const uint8_t *p[SHA_MB_LANES], *key;
+	mb_word st[8];
+	int j, l, i, n, key_len;
+
+	/* Every key yields two independent one block hashes: ipad and opad */
+	for (j = 0; j < 2 * num; j += SHA_MB_LANES) {
+		n = min(2 * num - j, SHA_MB_LANES);
+
+		for (l = 0; l < SHA_MB_LANES; l++) {
+			int idx = j + (l < n ? l : 0);
+			uint8_t xor = (idx & 1) ? 0x5c : 0x36;
+
+			key = keys[idx / 2];
+			key_len = key_lens[idx / 2];
+			if (key_len > SHA_MB_BLOCK_SIZE) {
+				alg->hash(key, key_len, hkey);
+				key = hkey;
+				key_len = alg->digest_size;
+			}
+			for (i = 0; i < key_len; i++)
+				pad[l][i] = key[i] ^ xor;
+			for (; i < SHA_MB_BLOCK_SIZE; i++)
+				pad[l][i] = xor;
+			p[l] = pad[l];
+		}
+
+		sha_mb_state_init(alg, st);
+		alg->compress(st, p, 1);
+
+		for (l = 0; l < n; l++) {
+			int idx = j + l;
+
+			sha_mb_state_store(alg, st, l, (idx & 1) ? outer[idx / 2] : inner[idx / 2]);
+		}
+	}
+}
+
+void mv_sha1_mb(const uint8_t *const data[], size_t len, uint8_t *digest[], int num)
+{
+	sha_mb(&sha1_mb_alg, data, len, digest, num);
+}
+
+void mv_sha256_mb(const uint8_t *const data[], size_t len, uint8_t *digest[], int num)
+{
+	sha_mb(&sha256_mb_alg, data, len, digest, num);
+}
+
+void mv_sha1_mb_hmac_iv(const uint8_t *const keys[], const int key_lens[],
+			uint8_t *inner[], uint8_t *outer[], int num)
+{
+	sha_mb_hmac_iv(&sha1_mb_alg, keys, key_lens, inner, outer, num);
+}
+
+void mv_sha256_mb_hmac_iv(const uint8_t *const keys[], const int key_lens[],
+			  uint8_t *inner[], uint8_t *outer[], int num)
+{
+	sha_mb_hmac_iv(&sha256_mb_alg, keys, key_lens, inner, outer, num);
+}
@@ -0,0 +1,632 @@
+/******************************************************************************
+ *	Copyright (C) 2016 Marvell International Ltd.
+ *
+ *  If you received this File from Marvell, you may opt to use, redistribute
+ *  and/or modify this File under the following licensing terms.
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *	* Redistributions of source code must retain the above copyright
+ *	  notice, this list of conditions and the following disclaimer.
+ *
+ *	* Redistributions in binary form must reproduce the above copyright
+ *	  notice, this list of conditions and the following disclaimer in the
+ *	  documentation and/or other materials provided with the distribution.
+ *
+ *	* Neither the name of Marvell nor the names of its contributors may be
+ *	  used to endorse or promote products derived from this software
+ *	  without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include "std_internal.h"
+#include "env/mv_sys_dma.h"
+#include "lib/mv_flow_tbl.h"
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#elif defined(__SSE4_2__)
+#include <nmmintrin.h>
+#endif
+
+#define FLOW_TBL_BFS_NODES	256	/* buckets searched for room by an add */
+#define FLOW_TBL_HUGEPAGE_SIZE	(2 * 1024 * 1024)
+#define FLOW_TBL_CACHE_LINE	64
+
+/* A bucket is one cache line. key_idx is the key store position + 1, 0 for
+ * an empty entry.
+ */
+struct flow_tbl_bucket {
+	u16	sig[MV_FLOW_TBL_BUCKET_ENTRIES];
+	u32	key_idx[MV_FLOW_TBL_BUCKET_ENTRIES];
+	u8	pad[16];
+} __attribute__((aligned(FLOW_TBL_CACHE_LINE)));
+
+struct flow_tbl_key {
+	u64	data;
+	u32	in_use;
+	u32	hash;
+	u8	key[0];
+};
+
+struct mv_flow_tbl {
+	/* Read by the lookups */
+	struct flow_tbl_bucket	*buckets;
+	u8			*keys;
+	u32			 bkt_mask;
+	u32			 key_len;
+	u32			 key_slot_size;
+	u32			 seed;
+	u32			 (*hash)(const void *key, u32 key_len, u32 seed);
+	/* Incremented before and after entries move between buckets, so it is
+	 * odd while they move. A lookup that misses retries when it changed.
+	 */
+	u32			 chng_cnt __attribute__((aligned(FLOW_TBL_CACHE_LINE)));
+
+	/* Writer only */
+	u32			*free_pos __attribute__((aligned(FLOW_TBL_CACHE_LINE)));
+	u32			 num_free;
+	u32			*pending;
+	u32			 num_pending;
+	u32			 num_used;
+	u32			 max_entries;
+	u32			 num_buckets;
+	enum mv_flow_tbl_mem	 mem;
+	u64			 buckets_size;
+	u64			 keys_size;
+	u64			 adds;
+	u64			 add_moves;
+	u64			 add_fails;
+};
+
+/* A bucket visited by the search for room, and the entry of the previous
+ * bucket that would move into it
+ */
+struct flow_tbl_node {
+	u32	bkt;
+	s16	prev;
+	u8	prev_slot;
+};
+
+static u32 flow_tbl_dflt_hash(const void *key, u32 key_len, u32 seed)
+{
+	const u8	*p = (const u8 *)key;
+	u32		 h = seed, w;
+
+	for (; key_len >= sizeof(u32); key_len -= sizeof(u32), p += sizeof(u32)) {
+		memcpy(&w, p, sizeof(u32));
+#if defined(__ARM_FEATURE_CRC32)
+		h = __crc32cw(h, w);
+#elif defined(__SSE4_2__)
+		h = _mm_crc32_u32(h, w);
+#else
+		h ^= w;
+		h *= 0xcc9e2d51;
+		h = (h << 15) | (h >> 17);
+		h *= 0x1b873593;
+#endif
+	}
+	if (key_len) {
+		w = 0;
+		memcpy(&w, p, key_len);
+		h ^= w * 0x1b873593;
+	}
+
+	/* Mix all bits into both the bucket index (low bits) and the signature */
+	h ^= h >> 16;
+	h *= 0x85ebca6b;
+	h ^= h >> 13;
+	h *= 0xc2b2ae35;
+	h ^= h >> 16;
+	return h;
+}
+
+static inline u16 flow_tbl_sig(u32 hash)
+{
+	return hash >> 16;
+}
+
+/* The other bucket of an entry. It depends on the current bucket and the
+ * signature only, so that entries can move without their key being rehashed.
+ */
+static inline u32 flow_tbl_alt_bkt(struct mv_flow_tbl *tbl, u32 bkt, u16 sig)
+{
+	u32 x = ((u32)sig + 1) * 0x9e3779b1;
+
+	x = (x ^ (x >> 16)) & tbl->bkt_mask;
+	return bkt ^ (x ? x : (1 & tbl->bkt_mask));
+}
+
+static inline struct flow_tbl_key *flow_tbl_key_slot(struct mv_flow_tbl *tbl, u32 pos)
+{
+	return (struct flow_tbl_key *)(tbl->keys + (u64)pos * tbl->key_slot_size);
+}
+
+/* Bit mask of the bucket entries with the given signature */
+static inline u32 flow_tbl_sig_match(const struct flow_tbl_bucket *b, u16 sig)
+{
+#if defined(__ARM_NEON) && defined(__aarch64__)
+	static const u8	weights[8] = {1, 2, 4, 8, 16, 32, 64, 128};
+	uint16x8_t	cmp = vceqq_u16(vld1q_u16(b->sig), vdupq_n_u16(sig));
+
+	return vaddv_u8(vand_u8(vmovn_u16(cmp), vld1_u8(weights)));
+#elif defined(__SSE2__)
+	__m128i	cmp = _mm_cmpeq_epi16(_mm_load_si128((const __m128i *)b->sig), _mm_set1_epi16(sig));
+	u32	m = _mm_movemask_epi8(cmp) & 0x5555;	/* one bit per 16-bit lane */
+
+	m = (m | (m >> 1)) & 0x3333;
+	m = (m | (m >> 2)) & 0x0f0f;
+	m = (m | (m >> 4)) & 0x00ff;
+	return m;
+#else
+	u32 m = 0;
+	int i;
+
+	for (i = 0; i < MV_FLOW_TBL_BUCKET_ENTRIES; i++)
+		m |= (u32)(b->sig[i] == sig) << i;
+	return m;
+#endif
+}
+
+static inline int flow_tbl_bkt_find(struct mv_flow_tbl *tbl, struct flow_tbl_bucket *b, u32 match,
+				    const void *key, u64 *data)
+{
+	struct flow_tbl_key	*k;
+	u32			 idx;
+	int			 i;
+
+	while (match) {
+		i = __builtin_ctz(match);
+		match &= match - 1;
+		idx = __atomic_load_n(&b->key_idx[i], __ATOMIC_ACQUIRE);
+		if (!idx)
+			continue;
+		k = flow_tbl_key_slot(tbl, idx - 1);
+		if (!memcmp(k->key, key, tbl->key_len)) {
+			if (data)
+				*data = k->data;
+			return idx - 1;
+		}
+	}
+	return -ENOENT;
+}
+
+u32 mv_flow_tbl_hash(struct mv_flow_tbl *tbl, const void *key)
+{
+	return tbl->hash(key, tbl->key_len, tbl->seed);
+}
+
+int mv_flow_tbl_lookup_with_hash(struct mv_flow_tbl *tbl, const void *key, u32 hash, u64 *data)
+{
+	u16	sig = flow_tbl_sig(hash);
+	u32	prim = hash & tbl->bkt_mask, alt = flow_tbl_alt_bkt(tbl, prim, sig);
+	u32	cnt;
+	int	pos;
+
+	do {
+		cnt = __atomic_load_n(&tbl->chng_cnt, __ATOMIC_ACQUIRE);
+		pos = flow_tbl_bkt_find(tbl, &tbl->buckets[prim],
+					flow_tbl_sig_match(&tbl->buckets[prim], sig), key, data);
+		if (pos >= 0)
+			return pos;
+		pos = flow_tbl_bkt_find(tbl, &tbl->buckets[alt],
+					flow_tbl_sig_match(&tbl->buckets[alt], sig), key, data);
+		if (pos >= 0)
+			return pos;
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+	} while ((cnt & 1) || cnt != __atomic_load_n(&tbl->chng_cnt, __ATOMIC_RELAXED));
+
+	return -ENOENT;
+}
+
+int mv_flow_tbl_lookup(struct mv_flow_tbl *tbl, const void *key, u64 *data)
+{
+	return mv_flow_tbl_lookup_with_hash(tbl, key, mv_flow_tbl_hash(tbl, key), data);
+}
+
+u64 mv_flow_tbl_lookup_bulk(struct mv_flow_tbl *tbl, const void *keys[], int num, int pos[], u64 data[])
+{
+	u32			 hashes[MV_FLOW_TBL_MAX_BURST];
+	u32			 prim[MV_FLOW_TBL_MAX_BURST], alt[MV_FLOW_TBL_MAX_BURST];
+	u32			 prim_match[MV_FLOW_TBL_MAX_BURST], alt_match[MV_FLOW_TBL_MAX_BURST];
+	struct flow_tbl_bucket	*b;
+	u64			 hits = 0, tmp;
+	u32			 cnt, m, idx;
+	int			 i, p;
+
+	if (unlikely(num > MV_FLOW_TBL_MAX_BURST))
+		num = MV_FLOW_TBL_MAX_BURST;
+
+	cnt = __atomic_load_n(&tbl->chng_cnt, __ATOMIC_ACQUIRE);
+
+	/* Hash all keys and prefetch both buckets of each */
+	for (i = 0; i < num; i++) {
+		hashes[i] = tbl->hash(keys[i], tbl->key_len, tbl->seed);
+		prim[i] = hashes[i] & tbl->bkt_mask;
+		alt[i] = flow_tbl_alt_bkt(tbl, prim[i], flow_tbl_sig(hashes[i]));
+		__builtin_prefetch(&tbl->buckets[prim[i]]);
+		__builtin_prefetch(&tbl->buckets[alt[i]]);
+	}
+
+	/* Compare the signatures and prefetch the keys of the matches */
+	for (i = 0; i < num; i++) {
+		b = &tbl->buckets[prim[i]];
+		prim_match[i] = flow_tbl_sig_match(b, flow_tbl_sig(hashes[i]));
+		for (m = prim_match[i]; m; m &= m - 1) {
+			idx = b->key_idx[__builtin_ctz(m)];
+			if (idx)
+				__builtin_prefetch(flow_tbl_key_slot(tbl, idx - 1));
+		}
+		b = &tbl->buckets[alt[i]];
+		alt_match[i] = flow_tbl_sig_match(b, flow_tbl_sig(hashes[i]));
+		for (m = alt_match[i]; m; m &= m - 1) {
+			idx = b->key_idx[__builtin_ctz(m)];
+			if (idx)
+				__builtin_prefetch(flow_tbl_key_slot(tbl, idx - 1));
+		}
+	}
+
+	/* Compare the keys */
+	for (i = 0; i < num; i++) {
+		p = flow_tbl_bkt_find(tbl, &tbl->buckets[prim[i]], prim_match[i], keys[i], data ? &data[i] : NULL);
+		if (p < 0)
+			p = flow_tbl_bkt_find(tbl, &tbl->buckets[alt[i]], alt_match[i], keys[i],
+					      data ? &data[i] : NULL);
+		if (p >= 0)
+			hits |= 1ULL << i;
+		if (pos)
+			pos[i] = p;
+	}
+
+	/* Misses that raced with entries moving are looked up again */
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+	if (unlikely(((cnt & 1) || cnt != __atomic_load_n(&tbl->chng_cnt, __ATOMIC_RELAXED)) &&
+		     hits != (num == 64 ? ~0ULL : (1ULL << num) - 1))) {
+		for (i = 0; i < num; i++) {
+			if (hits & (1ULL << i))
+				continue;
+			p = mv_flow_tbl_lookup_with_hash(tbl, keys[i], hashes[i], data ? &tmp : NULL);
+			if (p >= 0) {
+				hits |= 1ULL << i;
+				if (data)
+					data[i] = tmp;
+			}
+			if (pos)
+				pos[i] = p;
+		}
+	}
+
+	return hits;
+}
+
+static inline int flow_tbl_bkt_free_slot(struct flow_tbl_bucket *b)
+{
+	int i;
+
+	for (i = 0; i < MV_FLOW_TBL_BUCKET_ENTRIES; i++)
+		if (!b->key_idx[i])
+			return i;
+	return -1;
+}
+
+static int flow_tbl_in_path(struct flow_tbl_node *q, int node, u32 bkt)
+{
+	for (; node >= 0; node = q[node].prev)
+		if (q[node].bkt == bkt)
+			return 1;
+	return 0;
+}
+
+/* Entry moves are made in the order that keeps every entry findable in one
+ * of its buckets: an entry is first copied to its free destination, then
+ * cleared from its source, which becomes the destination of the next move.
+ */
+static void flow_tbl_move(struct flow_tbl_bucket *src, int src_slot, struct flow_tbl_bucket *dst, int dst_slot)
+{
+	dst->sig[dst_slot] = src->sig[src_slot];
+	__atomic_store_n(&dst->key_idx[dst_slot], src->key_idx[src_slot], __ATOMIC_RELEASE);
+	__atomic_store_n(&src->key_idx[src_slot], 0, __ATOMIC_RELEASE);
+	src->sig[src_slot] = 0;
+}
+
+/* Make room in one of the two full buckets of a new key: search the buckets
+ * reachable by moving entries to their other bucket, breadth first, for a
+ * free entry, then move the entries along the path found.
+ */
+static int flow_tbl_make_room(struct mv_flow_tbl *tbl, u32 prim, u32 alt, u32 *bkt)
+{
+	struct flow_tbl_node	 q[FLOW_TBL_BFS_NODES];
+	struct flow_tbl_bucket	*b;
+	u32			 nb, dst_bkt;
+	int			 head, tail = 0, s, f, cur, cur_slot, dst_slot;
+
+	q[tail].bkt = prim;
+	q[tail++].prev = -1;
+	if (alt != prim) {
+		q[tail].bkt = alt;
+		q[tail++].prev = -1;
+	}
+
+	for (head = 0; head < tail; head++) {
+		b = &tbl->buckets[q[head].bkt];
+		for (s = 0; s < MV_FLOW_TBL_BUCKET_ENTRIES; s++) {
+			nb = flow_tbl_alt_bkt(tbl, q[head].bkt, b->sig[s]);
+			if (flow_tbl_in_path(q, head, nb))
+				continue;
+			f = flow_tbl_bkt_free_slot(&tbl->buckets[nb]);
+			if (f < 0) {
+				if (tail < FLOW_TBL_BFS_NODES) {
+					q[tail].bkt = nb;
+					q[tail].prev = head;
+					q[tail++].prev_slot = s;
+				}
+				continue;
+			}
+
+			__atomic_store_n(&tbl->chng_cnt, tbl->chng_cnt + 1, __ATOMIC_RELAXED);
+			__atomic_thread_fence(__ATOMIC_RELEASE);
+			dst_bkt = nb;
+			dst_slot = f;
+			cur = head;
+			cur_slot = s;
+			while (cur >= 0) {
+				flow_tbl_move(&tbl->buckets[q[cur].bkt], cur_slot, &tbl->buckets[dst_bkt], dst_slot);
+				tbl->add_moves++;
+				dst_bkt = q[cur].bkt;
+				dst_slot = cur_slot;
+				cur_slot = q[cur].prev_slot;
+				cur = q[cur].prev;
+			}
+			__atomic_store_n(&tbl->chng_cnt, tbl->chng_cnt + 1, __ATOMIC_RELEASE);
+
+			*bkt = dst_bkt;
+			return dst_slot;
+		}
+	}
+
+	return -ENOSPC;
+}
+
+int mv_flow_tbl_add_with_hash(struct mv_flow_tbl *tbl, const void *key, u32 hash, u64 data)
+{
+	struct flow_tbl_bucket	*b;
+	struct flow_tbl_key	*k;
+	u16			 sig = flow_tbl_sig(hash);
+	u32			 prim = hash & tbl->bkt_mask, alt = flow_tbl_alt_bkt(tbl, prim, sig), bkt;
+	int			 pos, slot;
+
+	/* An existing flow gets the new data */
+	pos = flow_tbl_bkt_find(tbl, &tbl->buckets[prim], flow_tbl_sig_match(&tbl->buckets[prim], sig), key, NULL);
+	if (pos < 0)
+		pos = flow_tbl_bkt_find(tbl, &tbl->buckets[alt], flow_tbl_sig_match(&tbl->buckets[alt], sig),
+					key, NULL);
+	if (pos >= 0) {
+		__atomic_store_n(&flow_tbl_key_slot(tbl, pos)->data, data, __ATOMIC_RELAXED);
+		return pos;
+	}
+
+	if (!tbl->num_free) {
+		tbl->add_fails++;
+		return -ENOSPC;
+	}
+
+	bkt = prim;
+	slot = flow_tbl_bkt_free_slot(&tbl->buckets[prim]);
+	if (slot < 0) {
+		bkt = alt;
+		slot = flow_tbl_bkt_free_slot(&tbl->buckets[alt]);
+	}
+	if (slot < 0) {
+		slot = flow_tbl_make_room(tbl, prim, alt, &bkt);
+		if (slot < 0) {
+			tbl->add_fails++;
+			return -ENOSPC;
+		}
+	}
+
+	/* The key is complete before the entry is published */
+	pos = tbl->free_pos[--tbl->num_free];
+	k = flow_tbl_key_slot(tbl, pos);
+	memcpy(k->key, key, tbl->key_len);
+	k->data = data;
+	k->hash = hash;
+	k->in_use = 1;
+
+	b = &tbl->buckets[bkt];
+	b->sig[slot] = sig;
+	__atomic_store_n(&b->key_idx[slot], pos + 1, __ATOMIC_RELEASE);
+
+	tbl->num_used++;
+	tbl->adds++;
+	return pos;
+}
+
+int mv_flow_tbl_add(struct mv_flow_tbl *tbl, const void *key, u64 data)
+{
+	return mv_flow_tbl_add_with_hash(tbl, key, mv_flow_tbl_hash(tbl, key), data);
+}
+
+int mv_flow_tbl_del(struct mv_flow_tbl *tbl, const void *key)
+{
+	struct flow_tbl_bucket	*b;
+	u32			 hash = mv_flow_tbl_hash(tbl, key);
+	u16			 sig = flow_tbl_sig(hash);
+	u32			 bkt[2], m, idx;
+	int			 i, j;
+
+	bkt[0] = hash & tbl->bkt_mask;
+	bkt[1] = flow_tbl_alt_bkt(tbl, bkt[0], sig);
+	for (j = 0; j < 2; j++) {
+		b = &tbl->buckets[bkt[j]];
+		for (m = flow_tbl_sig_match(b, sig); m; m &= m - 1) {
+			i = __builtin_ctz(m);
+			idx = b->key_idx[i];
+			if (!idx || memcmp(flow_tbl_key_slot(tbl, idx - 1)->key, key, tbl->key_len))
+				continue;
+
+			__atomic_store_n(&b->key_idx[i], 0, __ATOMIC_RELEASE);
+			b->sig[i] = 0;
+			flow_tbl_key_slot(tbl, idx - 1)->in_use = 0;
+			/* Readers may still use the key; reused after mv_flow_tbl_reclaim() */
+			tbl->pending[tbl->num_pending++] = idx - 1;
+			tbl->num_used--;
+			return idx - 1;
+		}
+	}
+
+	return -ENOENT;
+}
+
+u32 mv_flow_tbl_reclaim(struct mv_flow_tbl *tbl)
+{
+	u32 num = tbl->num_pending;
+
+	while (tbl->num_pending)
+		tbl->free_pos[tbl->num_free++] = tbl->pending[--tbl->num_pending];
+	return num;
+}
+
+int mv_flow_tbl_get_key(struct mv_flow_tbl *tbl, int pos, const void **key, u64 *data)
+{
+	struct flow_tbl_key *k;
+
+	if (pos < 0 || (u32)pos >= tbl->max_entries)
+		return -ENOENT;
+	k = flow_tbl_key_slot(tbl, pos);
+	if (!k->in_use)
+		return -ENOENT;
+	*key = k->key;
+	if (data)
+		*data = k->data;
+	return 0;
+}
+
+void mv_flow_tbl_get_stats(struct mv_flow_tbl *tbl, struct mv_flow_tbl_stats *stats)
+{
+	stats->num_entries = tbl->num_used;
+	stats->max_entries = tbl->max_entries;
+	stats->num_buckets = tbl->num_buckets;
+	stats->pending_free = tbl->num_pending;
+	stats->mem_size = tbl->buckets_size + tbl->keys_size;
+	stats->adds = tbl->adds;
+	stats->add_moves = tbl->add_moves;
+	stats->add_fails = tbl->add_fails;
+}
+
+static void *flow_tbl_mem_alloc(enum mv_flow_tbl_mem mem, u64 size)
+{
+	void *p = NULL;
+
+	switch (mem) {
+	case MV_FLOW_TBL_MEM_HEAP:
+		if (posix_memalign(&p, FLOW_TBL_CACHE_LINE, size))
+			return NULL;
+		break;
+	case MV_FLOW_TBL_MEM_DMA:
+		p = mv_sys_dma_mem_alloc(size, FLOW_TBL_CACHE_LINE);
+		break;
+	case MV_FLOW_TBL_MEM_HUGEPAGE:
+		p = mmap(NULL, ALIGN(size, FLOW_TBL_HUGEPAGE_SIZE), PROT_READ | PROT_WRITE,
+			 MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+		/* Huge pages are zeroed by the kernel */
+		return (p == MAP_FAILED) ? NULL : p;
+	}
+	if (p)
+		memset(p, 0, size);
+	return p;
+}
+
+static void flow_tbl_mem_free(enum mv_flow_tbl_mem mem, void *p, u64 size)
+{
+	if (!p)
+		return;
+
+	switch (mem) {
+	case MV_FLOW_TBL_MEM_HEAP:
+		free(p);
+		break;
+	case MV_FLOW_TBL_MEM_DMA:
+		mv_sys_dma_mem_free(p);
+		break;
+	case MV_FLOW_TBL_MEM_HUGEPAGE:
+		munmap(p, ALIGN(size, FLOW_TBL_HUGEPAGE_SIZE));
+		break;
+	}
+}
+
+int mv_flow_tbl_create(struct mv_flow_tbl_params *params, struct mv_flow_tbl **tbl)
+{
+	struct mv_flow_tbl	*t;
+	u32			 i;
+
+	if (!params || !tbl || !params->num_entries || params->num_entries > (1 << 30) ||
+	    !params->key_len || params->key_len > MV_FLOW_TBL_MAX_KEY_LEN ||
+	    params->mem > MV_FLOW_TBL_MEM_HUGEPAGE) {
+		pr_err("invalid flow table parameters!\n");
+		return -EINVAL;
+	}
+
+	t = kcalloc(1, sizeof(struct mv_flow_tbl), GFP_KERNEL);
+	if (!t) {
+		pr_err("no mem for flow table obj!\n");
+		return -ENOMEM;
+	}
+
+	t->key_len = params->key_len;
+	t->key_slot_size = ALIGN(sizeof(struct flow_tbl_key) + params->key_len, sizeof(u64));
+	t->seed = params->seed;
+	t->hash = params->hash ? params->hash : flow_tbl_dflt_hash;
+	t->mem = params->mem;
+	t->max_entries = params->num_entries;
+	t->num_buckets = roundup_pow_of_two((params->num_entries + MV_FLOW_TBL_BUCKET_ENTRIES - 1) /
+						 MV_FLOW_TBL_BUCKET_ENTRIES);
+	t->bkt_mask = t->num_buckets - 1;
+	t->buckets_size = (u64)t->num_buckets * sizeof(struct flow_tbl_bucket);
+	t->keys_size = (u64)t->max_entries * t->key_slot_size;
+
+	t->buckets = flow_tbl_mem_alloc(t->mem, t->buckets_size);
+	t->keys = flow_tbl_mem_alloc(t->mem, t->keys_size);
+	t->free_pos = kcalloc(t->max_entries, sizeof(u32), GFP_KERNEL);
+	t->pending = kcalloc(t->max_entries, sizeof(u32), GFP_KERNEL);
+	if (!t->buckets || !t->keys || !t->free_pos || !t->pending) {
+		pr_err("no mem for flow table of %u entries!\n", t->max_entries);
+		mv_flow_tbl_destroy(t);
+		return -ENOMEM;
+	}
+
+	/* Lowest positions are used first */
+	for (i = 0; i < t->max_entries; i++)
+		t->free_pos[i] = t->max_entries - 1 - i;
+	t->num_free = t->max_entries;
+
+	*tbl = t;
+	return 0;
+}
+
+void mv_flow_tbl_destroy(struct mv_flow_tbl *tbl)
+{
+	if (!tbl)
+		return;
+
+	flow_tbl_mem_free(tbl->mem, tbl->buckets, tbl->buckets_size);
+	flow_tbl_mem_free(tbl->mem, tbl->keys, tbl->keys_size);
+	kfree(tbl->free_pos);
+	kfree(tbl->pending);
+	kfree(tbl);
+}